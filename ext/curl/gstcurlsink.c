@@ -36,6 +36,41 @@
  *     use-content-length=false
  * ]|
  * </refsect2>
+ *
+ * The buffers are sent from a separate thread, the streaming thread only
+ * waits when more than #GstCurlSink:max-queue-size bytes have not been sent
+ * yet.
+ *
+ * When #GstCurlSink:use-content-length is set every buffer is uploaded as a
+ * request of its own and up to #GstCurlSink:parallel-uploads of them are sent
+ * at the same time over separate connections. Those requests can complete
+ * in any order, so a request is only started after the previous one for the
+ * same file name is done: buffers uploaded under the same file name are
+ * still sent one after the other and only the uploads of different files
+ * overlap.
+ *
+ * When #GstCurlSink:segment-duration is set the stream is uploaded as a
+ * series of files named after #GstCurlSink:segment-location, for live HTTP
+ * streaming. A new segment is started at the first keyframe after the
+ * duration and the list of the last segments is uploaded to
+ * #GstCurlSink:playlist-location as a M3U8 playlist after every segment.
+ * The segments are streamed to the server while they are recorded, or
+ * uploaded at once after they are complete when
+ * #GstCurlSink:use-content-length is set. The connection is kept open
+ * between the uploads.
+ *
+ * <refsect2>
+ * <title>Example launch line (live HTTP streaming)</title>
+ * |[
+ * gst-launch v4l2src ! ffmpegcolorspace ! x264enc key-int-max=50 \
+ *     ! mpegtsmux ! curlsink  \
+ *     location=http://192.168.0.1:8080/live/  \
+ *     content-type=video/mp2t  \
+ *     segment-duration=10000000000  \
+ *     segment-location=segment%05u.ts  \
+ *     playlist-location=live.m3u8
+ * ]|
+ * </refsect2>
  */
 
 #ifdef HAVE_CONFIG_H
@@ -65,6 +100,17 @@
 #define DEFAULT_QOS_DSCP               0
 #define DEFAULT_ACCEPT_SELF_SIGNED     FALSE
 #define DEFAULT_USE_CONTENT_LENGTH     FALSE
+#define DEFAULT_MAX_QUEUE_SIZE         (2 * 1024 * 1024)
+#define DEFAULT_PARALLEL_UPLOADS       1
+
+#define DEFAULT_SEGMENT_DURATION       0
+#define DEFAULT_SEGMENT_LOCATION       "segment%05u.ts"
+#define DEFAULT_PLAYLIST_LOCATION      "playlist.m3u8"
+#define DEFAULT_PLAYLIST_LENGTH        5
+
+#define MAX_PARALLEL_UPLOADS           16
+
+#define PLAYLIST_CONTENT_TYPE          "application/vnd.apple.mpegurl"
 
 #define DSCP_MIN                       0
 #define DSCP_MAX                       63
@@ -94,8 +140,23 @@ enum
   PROP_QOS_DSCP,
   PROP_ACCEPT_SELF_SIGNED,
   PROP_USE_CONTENT_LENGTH,
-  PROP_CONTENT_TYPE
+  PROP_CONTENT_TYPE,
+  PROP_MAX_QUEUE_SIZE,
+  PROP_PARALLEL_UPLOADS,
+  PROP_SEGMENT_DURATION,
+  PROP_SEGMENT_LOCATION,
+  PROP_PLAYLIST_LOCATION,
+  PROP_PLAYLIST_LENGTH
 };
+
+/* a segment listed in the playlist */
+typedef struct
+{
+  gchar *name;
+  guint index;
+  GstClockTime duration;
+} SegmentEntry;
+
 static gboolean proxy_auth = FALSE;
 static gboolean proxy_conn_established = FALSE;
 
@@ -118,22 +179,43 @@ static gboolean gst_curl_sink_unlock_stop (GstBaseSink * bsink);
 /* private functions */
 static gboolean gst_curl_sink_transfer_setup_unlocked (GstCurlSink * sink);
 static gboolean gst_curl_sink_transfer_set_options_unlocked (GstCurlSink
-    * sink);
+    * sink, CURL * curl);
 static gboolean gst_curl_sink_transfer_start_unlocked (GstCurlSink * sink);
 static void gst_curl_sink_transfer_cleanup (GstCurlSink * sink);
 static size_t gst_curl_sink_transfer_read_cb (void *ptr, size_t size,
     size_t nmemb, void *stream);
 static size_t gst_curl_sink_transfer_write_cb (void *ptr, size_t size,
     size_t nmemb, void *stream);
-static GstFlowReturn gst_curl_sink_handle_transfer (GstCurlSink * sink);
+static size_t gst_curl_sink_part_read_cb (void *ptr, size_t size,
+    size_t nmemb, void *stream);
+static int gst_curl_sink_part_seek_cb (void *stream, curl_off_t offset,
+    int origin);
+static GstFlowReturn gst_curl_sink_handle_transfer (GstCurlSink * sink,
+    gsize size);
+static GstFlowReturn gst_curl_sink_handle_parallel_transfers (GstCurlSink *
+    sink);
+static GstFlowReturn gst_curl_sink_wait_for_sockets (GstCurlSink * sink,
+    gint timeout);
 static int gst_curl_sink_transfer_socket_cb (void *clientp,
     curl_socket_t curlfd, curlsocktype purpose);
 static gpointer gst_curl_sink_transfer_thread_func (gpointer data);
 static CURLcode gst_curl_sink_transfer_check (GstCurlSink * sink);
 static gint gst_curl_sink_setup_dscp_unlocked (GstCurlSink * sink);
 
-static gboolean gst_curl_sink_wait_for_data_unlocked (GstCurlSink * sink);
-static void gst_curl_sink_new_file_notify_unlocked (GstCurlSink * sink);
+static GstBuffer *gst_curl_sink_next_buffer_unlocked (GstCurlSink * sink,
+    gboolean in_file, gboolean * end_of_file);
+static gboolean gst_curl_sink_wait_for_data_unlocked (GstCurlSink * sink,
+    gboolean in_file);
+static void gst_curl_sink_flush_queue_unlocked (GstCurlSink * sink);
+static void gst_curl_sink_new_file_notify_unlocked (GstCurlSink * sink,
+    const gchar * file_name, const gchar * content_type, gboolean sequential);
+static void gst_curl_sink_queue_buffer_unlocked (GstCurlSink * sink,
+    GstBuffer * buf);
+static void gst_curl_sink_segment_unlocked (GstCurlSink * sink,
+    GstBuffer * buf);
+static void gst_curl_sink_end_segment_unlocked (GstCurlSink * sink,
+    gboolean last);
+static void gst_curl_sink_reset_segments_unlocked (GstCurlSink * sink);
 static void gst_curl_sink_transfer_thread_notify_unlocked (GstCurlSink * sink);
 static void gst_curl_sink_transfer_thread_close_unlocked (GstCurlSink * sink);
 static void gst_curl_sink_wait_for_transfer_thread_to_send_unlocked (GstCurlSink
@@ -242,16 +324,96 @@ gst_curl_sink_class_init (GstCurlSinkClass * klass)
       g_param_spec_string ("content-type", "Content type",
           "The mime type of the body of the request", NULL,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstCurlSink:max-queue-size
+   *
+   * The number of bytes that can wait to be sent before the streaming thread
+   * blocks, 0 waits for every buffer to be sent before the next one is
+   * accepted.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_QUEUE_SIZE,
+      g_param_spec_uint ("max-queue-size", "Max queue size",
+          "Maximum number of bytes waiting to be sent (0 = unqueued)",
+          0, G_MAXUINT, DEFAULT_MAX_QUEUE_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstCurlSink:parallel-uploads
+   *
+   * The number of requests sent at the same time over separate connections
+   * when #GstCurlSink:use-content-length is set. Every buffer is uploaded as
+   * a request of its own then, the requests for the same file name are sent
+   * one after the other so that the server gets them in order.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PARALLEL_UPLOADS,
+      g_param_spec_int ("parallel-uploads", "Parallel uploads",
+          "Number of buffers uploaded at the same time when using the "
+          "content length header", 1, MAX_PARALLEL_UPLOADS,
+          DEFAULT_PARALLEL_UPLOADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstCurlSink:segment-duration
+   *
+   * Upload the stream in segments of at least this duration, cut at the
+   * first keyframe after it. 0 uploads the stream as one file named
+   * #GstCurlSink:file-name.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_SEGMENT_DURATION,
+      g_param_spec_uint64 ("segment-duration", "Segment duration",
+          "Minimum duration of the uploaded segments in nanoseconds "
+          "(0 = don't segment)", 0, G_MAXUINT64, DEFAULT_SEGMENT_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstCurlSink:segment-location
+   *
+   * The file name of the segments, a printf pattern with the segment index.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_SEGMENT_LOCATION,
+      g_param_spec_string ("segment-location", "Segment location",
+          "File name pattern of the segments, e.g. segment%05u.ts",
+          DEFAULT_SEGMENT_LOCATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstCurlSink:playlist-location
+   *
+   * The file name of the playlist uploaded after every segment, NULL to
+   * upload the segments only.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PLAYLIST_LOCATION,
+      g_param_spec_string ("playlist-location", "Playlist location",
+          "File name of the playlist listing the segments",
+          DEFAULT_PLAYLIST_LOCATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstCurlSink:playlist-length
+   *
+   * The number of the last segments listed in the playlist, 0 lists all
+   * of them.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PLAYLIST_LENGTH,
+      g_param_spec_uint ("playlist-length", "Playlist length",
+          "Number of segments in the playlist (0 = all)", 0, G_MAXUINT,
+          DEFAULT_PLAYLIST_LENGTH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
 gst_curl_sink_init (GstCurlSink * sink, GstCurlSinkClass * klass)
 {
-  sink->transfer_buf = g_malloc (sizeof (TransferBuffer));
+  sink->transfer_buf = g_malloc0 (sizeof (TransferBuffer));
   sink->transfer_cond = g_malloc (sizeof (TransferCondition));
   sink->transfer_cond->cond = g_cond_new ();
-  sink->transfer_cond->data_sent = FALSE;
-  sink->transfer_cond->data_available = FALSE;
   sink->timeout = DEFAULT_TIMEOUT;
   sink->proxy_port = DEFAULT_PROXY_PORT;
   sink->qos_dscp = DEFAULT_QOS_DSCP;
@@ -263,6 +425,16 @@ gst_curl_sink_init (GstCurlSink * sink, GstCurlSinkClass * klass)
   sink->new_file = TRUE;
   sink->proxy_headers_set = FALSE;
   sink->content_type = NULL;
+  sink->queue = g_queue_new ();
+  sink->max_queue_size = DEFAULT_MAX_QUEUE_SIZE;
+  sink->poll_fds = g_array_new (FALSE, FALSE, sizeof (GstPollFD));
+  sink->parallel_uploads = DEFAULT_PARALLEL_UPLOADS;
+  sink->segment_duration = DEFAULT_SEGMENT_DURATION;
+  sink->segment_location = g_strdup (DEFAULT_SEGMENT_LOCATION);
+  sink->playlist_location = g_strdup (DEFAULT_PLAYLIST_LOCATION);
+  sink->playlist_length = DEFAULT_PLAYLIST_LENGTH;
+  sink->playlist = g_queue_new ();
+  sink->adapter = gst_adapter_new ();
 }
 
 static void
@@ -276,9 +448,19 @@ gst_curl_sink_finalize (GObject * gobject)
   }
 
   gst_curl_sink_transfer_cleanup (this);
+  gst_curl_sink_flush_queue_unlocked (this);
   g_cond_free (this->transfer_cond->cond);
   g_free (this->transfer_cond);
 
+  g_queue_free (this->queue);
+  g_array_free (this->poll_fds, TRUE);
+
+  gst_curl_sink_reset_segments_unlocked (this);
+  g_queue_free (this->playlist);
+  g_object_unref (this->adapter);
+  g_free (this->segment_location);
+  g_free (this->playlist_location);
+
   g_free (this->transfer_buf);
 
   g_free (this->url);
@@ -289,6 +471,8 @@ gst_curl_sink_finalize (GObject * gobject)
   g_free (this->proxy_passwd);
   g_free (this->file_name);
   g_free (this->content_type);
+  g_free (this->transfer_file_name);
+  g_free (this->transfer_content_type);
 
   if (this->header_list) {
     curl_slist_free_all (this->header_list);
@@ -306,15 +490,11 @@ static GstFlowReturn
 gst_curl_sink_render (GstBaseSink * bsink, GstBuffer * buf)
 {
   GstCurlSink *sink = GST_CURL_SINK (bsink);
-  guint8 *data;
-  size_t size;
   GstFlowReturn ret;
 
   GST_LOG ("enter render");
 
   sink = GST_CURL_SINK (bsink);
-  data = GST_BUFFER_DATA (buf);
-  size = GST_BUFFER_SIZE (buf);
 
   if (sink->content_type == NULL) {
     GstCaps *caps;
@@ -335,8 +515,6 @@ gst_curl_sink_render (GstBaseSink * bsink, GstBuffer * buf)
     goto done;
   }
 
-  g_assert (sink->transfer_cond->data_available == FALSE);
-
   /* if there is no transfer thread created, lets create one */
   if (sink->transfer_thread == NULL) {
     if (!gst_curl_sink_transfer_start_unlocked (sink)) {
@@ -345,17 +523,29 @@ gst_curl_sink_render (GstBaseSink * bsink, GstBuffer * buf)
     }
   }
 
-  /* make data available for the transfer thread and notify */
-  sink->transfer_buf->ptr = data;
-  sink->transfer_buf->len = size;
-  sink->transfer_buf->offset = 0;
-  gst_curl_sink_transfer_thread_notify_unlocked (sink);
+  /* queue the data for the transfer thread and notify, complete segments
+   * are queued at once when the content length is used */
+  if (sink->segment_duration > 0) {
+    gst_curl_sink_segment_unlocked (sink, buf);
+    if (sink->use_content_length)
+      gst_adapter_push (sink->adapter, gst_buffer_ref (buf));
+    else
+      gst_curl_sink_queue_buffer_unlocked (sink, gst_buffer_ref (buf));
+  } else {
+    gst_curl_sink_queue_buffer_unlocked (sink, gst_buffer_ref (buf));
+  }
 
-  /* wait for the transfer thread to send the data. This will be notified
-   * either when transfer is completed by the curl read callback or by
-   * the thread function if an error has occured. */
+  /* wait until no more than max-queue-size bytes are left to send. This will
+   * be notified by the transfer thread every time a buffer was sent, when an
+   * error has occured or when unlocking. */
   gst_curl_sink_wait_for_transfer_thread_to_send_unlocked (sink);
 
+  if (sink->flushing) {
+    GST_OBJECT_UNLOCK (sink);
+    GST_LOG ("flushing");
+    return GST_FLOW_WRONG_STATE;
+  }
+
 done:
   ret = sink->flow_ret;
   GST_OBJECT_UNLOCK (sink);
@@ -374,6 +564,9 @@ gst_curl_sink_event (GstBaseSink * bsink, GstEvent * event)
     case GST_EVENT_EOS:
       GST_DEBUG_OBJECT (sink, "received EOS");
       GST_OBJECT_LOCK (sink);
+      /* the last segment ends the playlist */
+      if (sink->in_segment)
+        gst_curl_sink_end_segment_unlocked (sink, TRUE);
       gst_curl_sink_transfer_thread_close_unlocked (sink);
       GST_OBJECT_UNLOCK (sink);
       if (sink->transfer_thread != NULL) {
@@ -400,6 +593,13 @@ gst_curl_sink_start (GstBaseSink * bsink)
     return FALSE;
   }
 
+  GST_OBJECT_LOCK (sink);
+  sink->flow_ret = GST_FLOW_OK;
+  sink->wakeup_pending = FALSE;
+  gst_curl_sink_reset_segments_unlocked (sink);
+  sink->segment_index = 0;
+  GST_OBJECT_UNLOCK (sink);
+
   return TRUE;
 }
 
@@ -408,13 +608,24 @@ gst_curl_sink_stop (GstBaseSink * bsink)
 {
   GstCurlSink *sink = GST_CURL_SINK (bsink);
 
+  /* drop what was not sent yet and wait for the transfer thread to exit, it
+   * uses the poll */
+  if (sink->fdset != NULL)
+    gst_poll_set_flushing (sink->fdset, TRUE);
   GST_OBJECT_LOCK (sink);
+  gst_curl_sink_flush_queue_unlocked (sink);
+  gst_curl_sink_reset_segments_unlocked (sink);
   gst_curl_sink_transfer_thread_close_unlocked (sink);
   GST_OBJECT_UNLOCK (sink);
+  if (sink->transfer_thread != NULL) {
+    g_thread_join (sink->transfer_thread);
+    sink->transfer_thread = NULL;
+  }
   if (sink->fdset != NULL) {
     gst_poll_free (sink->fdset);
     sink->fdset = NULL;
   }
+  g_array_set_size (sink->poll_fds, 0);
 
   return TRUE;
 }
@@ -429,6 +640,11 @@ gst_curl_sink_unlock (GstBaseSink * bsink)
   GST_LOG_OBJECT (sink, "Flushing");
   gst_poll_set_flushing (sink->fdset, TRUE);
 
+  GST_OBJECT_LOCK (sink);
+  sink->flushing = TRUE;
+  g_cond_broadcast (sink->transfer_cond->cond);
+  GST_OBJECT_UNLOCK (sink);
+
   return TRUE;
 }
 
@@ -442,6 +658,30 @@ gst_curl_sink_unlock_stop (GstBaseSink * bsink)
   GST_LOG_OBJECT (sink, "No longer flushing");
   gst_poll_set_flushing (sink->fdset, FALSE);
 
+  GST_OBJECT_LOCK (sink);
+  sink->flushing = FALSE;
+  /* the flush aborted the upload, a new transfer thread is started with the
+   * next buffer */
+  if (sink->flow_ret == GST_FLOW_WRONG_STATE) {
+    GThread *thread = sink->transfer_thread;
+
+    sink->transfer_thread = NULL;
+    GST_OBJECT_UNLOCK (sink);
+    if (thread)
+      g_thread_join (thread);
+    GST_OBJECT_LOCK (sink);
+    gst_curl_sink_flush_queue_unlocked (sink);
+    /* the data after the flush starts a new segment */
+    gst_adapter_clear (sink->adapter);
+    if (sink->in_segment) {
+      g_free (sink->segment_name);
+      sink->segment_name = NULL;
+      sink->in_segment = FALSE;
+    }
+    sink->flow_ret = GST_FLOW_OK;
+  }
+  GST_OBJECT_UNLOCK (sink);
+
   return TRUE;
 }
 
@@ -523,6 +763,38 @@ gst_curl_sink_set_property (GObject * object, guint prop_id,
         sink->content_type = g_value_dup_string (value);
         GST_DEBUG_OBJECT (sink, "content type set to %s", sink->content_type);
         break;
+      case PROP_MAX_QUEUE_SIZE:
+        sink->max_queue_size = g_value_get_uint (value);
+        GST_DEBUG_OBJECT (sink, "max queue size set to %u",
+            sink->max_queue_size);
+        break;
+      case PROP_PARALLEL_UPLOADS:
+        sink->parallel_uploads = g_value_get_int (value);
+        GST_DEBUG_OBJECT (sink, "parallel uploads set to %d",
+            sink->parallel_uploads);
+        break;
+      case PROP_SEGMENT_DURATION:
+        sink->segment_duration = g_value_get_uint64 (value);
+        GST_DEBUG_OBJECT (sink, "segment duration set to %" GST_TIME_FORMAT,
+            GST_TIME_ARGS (sink->segment_duration));
+        break;
+      case PROP_SEGMENT_LOCATION:
+        g_free (sink->segment_location);
+        sink->segment_location = g_value_dup_string (value);
+        GST_DEBUG_OBJECT (sink, "segment location set to %s",
+            sink->segment_location);
+        break;
+      case PROP_PLAYLIST_LOCATION:
+        g_free (sink->playlist_location);
+        sink->playlist_location = g_value_dup_string (value);
+        GST_DEBUG_OBJECT (sink, "playlist location set to %s",
+            sink->playlist_location);
+        break;
+      case PROP_PLAYLIST_LENGTH:
+        sink->playlist_length = g_value_get_uint (value);
+        GST_DEBUG_OBJECT (sink, "playlist length set to %u",
+            sink->playlist_length);
+        break;
       default:
         GST_DEBUG_OBJECT (sink, "invalid property id %d", prop_id);
         break;
@@ -541,7 +813,8 @@ gst_curl_sink_set_property (GObject * object, guint prop_id,
       g_free (sink->file_name);
       sink->file_name = g_value_dup_string (value);
       GST_DEBUG_OBJECT (sink, "file_name set to %s", sink->file_name);
-      gst_curl_sink_new_file_notify_unlocked (sink);
+      gst_curl_sink_new_file_notify_unlocked (sink, sink->file_name, NULL,
+          FALSE);
       break;
     case PROP_TIMEOUT:
       sink->timeout = g_value_get_int (value);
@@ -557,6 +830,12 @@ gst_curl_sink_set_property (GObject * object, guint prop_id,
       sink->content_type = g_value_dup_string (value);
       GST_DEBUG_OBJECT (sink, "content type set to %s", sink->content_type);
       break;
+    case PROP_MAX_QUEUE_SIZE:
+      sink->max_queue_size = g_value_get_uint (value);
+      GST_DEBUG_OBJECT (sink, "max queue size set to %u", sink->max_queue_size);
+      /* the streaming thread might be able to continue now */
+      g_cond_broadcast (sink->transfer_cond->cond);
+      break;
     default:
       GST_WARNING_OBJECT (sink, "cannot set property when PLAYING");
       break;
@@ -614,6 +893,24 @@ gst_curl_sink_get_property (GObject * object, guint prop_id,
     case PROP_CONTENT_TYPE:
       g_value_set_string (value, sink->content_type);
       break;
+    case PROP_MAX_QUEUE_SIZE:
+      g_value_set_uint (value, sink->max_queue_size);
+      break;
+    case PROP_PARALLEL_UPLOADS:
+      g_value_set_int (value, sink->parallel_uploads);
+      break;
+    case PROP_SEGMENT_DURATION:
+      g_value_set_uint64 (value, sink->segment_duration);
+      break;
+    case PROP_SEGMENT_LOCATION:
+      g_value_set_string (value, sink->segment_location);
+      break;
+    case PROP_PLAYLIST_LOCATION:
+      g_value_set_string (value, sink->playlist_location);
+      break;
+    case PROP_PLAYLIST_LENGTH:
+      g_value_set_uint (value, sink->playlist_length);
+      break;
     default:
       GST_DEBUG_OBJECT (sink, "invalid property id");
       break;
@@ -621,107 +918,114 @@ gst_curl_sink_get_property (GObject * object, guint prop_id,
 }
 
 static void
-gst_curl_sink_set_http_header_unlocked (GstCurlSink * sink)
+gst_curl_sink_set_http_header_unlocked (GstCurlSink * sink, CURL * curl,
+    struct curl_slist **header_list, const gchar * file_name, gsize size)
 {
   gchar *tmp;
 
-  if (sink->header_list) {
-    curl_slist_free_all (sink->header_list);
-    sink->header_list = NULL;
+  if (*header_list) {
+    curl_slist_free_all (*header_list);
+    *header_list = NULL;
   }
 
   if (proxy_auth && !sink->proxy_headers_set && !proxy_conn_established) {
-    sink->header_list =
-        curl_slist_append (sink->header_list, "Content-Length: 0");
+    *header_list = curl_slist_append (*header_list, "Content-Length: 0");
     sink->proxy_headers_set = TRUE;
     goto set_headers;
   }
   if (sink->use_content_length) {
     /* if content length is used we assume that every buffer is one
      * entire file, which is the case when uploading several jpegs */
-    tmp = g_strdup_printf ("Content-Length: %d", (int) sink->transfer_buf->len);
-    sink->header_list = curl_slist_append (sink->header_list, tmp);
+    tmp = g_strdup_printf ("Content-Length: %" G_GSIZE_FORMAT, size);
+    *header_list = curl_slist_append (*header_list, tmp);
     g_free (tmp);
+    /* and curl stops reading after it */
+    curl_easy_setopt (curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t) size);
   } else {
     /* when sending a POST request to a HTTP 1.1 server, you can send data
      * without knowing the size before starting the POST if you use chunked
      * encoding */
-    sink->header_list = curl_slist_append (sink->header_list,
+    *header_list = curl_slist_append (*header_list,
         "Transfer-Encoding: chunked");
   }
 
-  tmp = g_strdup_printf ("Content-Type: %s", sink->content_type);
-  sink->header_list = curl_slist_append (sink->header_list, tmp);
+  /* the transfer only succeeds when the server answers with 100 Continue,
+   * which curl would not ask for when the body is small */
+  *header_list = curl_slist_append (*header_list, "Expect: 100-continue");
+
+  tmp = g_strdup_printf ("Content-Type: %s", sink->transfer_content_type ?
+      sink->transfer_content_type : sink->content_type);
+  *header_list = curl_slist_append (*header_list, tmp);
   g_free (tmp);
 
 set_headers:
 
   tmp = g_strdup_printf ("Content-Disposition: attachment; filename="
-      "\"%s\"", sink->file_name);
-  sink->header_list = curl_slist_append (sink->header_list, tmp);
+      "\"%s\"", file_name);
+  *header_list = curl_slist_append (*header_list, tmp);
   g_free (tmp);
-  curl_easy_setopt (sink->curl, CURLOPT_HTTPHEADER, sink->header_list);
+  curl_easy_setopt (curl, CURLOPT_HTTPHEADER, *header_list);
 }
 
 static gboolean
-gst_curl_sink_transfer_set_options_unlocked (GstCurlSink * sink)
+gst_curl_sink_transfer_set_options_unlocked (GstCurlSink * sink, CURL * curl)
 {
 #ifdef DEBUG
-  curl_easy_setopt (sink->curl, CURLOPT_VERBOSE, 1);
+  curl_easy_setopt (curl, CURLOPT_VERBOSE, 1);
 #endif
 
-  curl_easy_setopt (sink->curl, CURLOPT_URL, sink->url);
-  curl_easy_setopt (sink->curl, CURLOPT_CONNECTTIMEOUT, sink->timeout);
+  curl_easy_setopt (curl, CURLOPT_URL, sink->url);
+  curl_easy_setopt (curl, CURLOPT_CONNECTTIMEOUT, sink->timeout);
 
-  curl_easy_setopt (sink->curl, CURLOPT_SOCKOPTDATA, sink);
-  curl_easy_setopt (sink->curl, CURLOPT_SOCKOPTFUNCTION,
+  curl_easy_setopt (curl, CURLOPT_SOCKOPTDATA, sink);
+  curl_easy_setopt (curl, CURLOPT_SOCKOPTFUNCTION,
       gst_curl_sink_transfer_socket_cb);
 
   if (sink->user != NULL && strlen (sink->user)) {
-    curl_easy_setopt (sink->curl, CURLOPT_USERNAME, sink->user);
-    curl_easy_setopt (sink->curl, CURLOPT_PASSWORD, sink->passwd);
-    curl_easy_setopt (sink->curl, CURLOPT_HTTPAUTH, CURLAUTH_ANY);
+    curl_easy_setopt (curl, CURLOPT_USERNAME, sink->user);
+    curl_easy_setopt (curl, CURLOPT_PASSWORD, sink->passwd);
+    curl_easy_setopt (curl, CURLOPT_HTTPAUTH, CURLAUTH_ANY);
   }
 
   if (sink->accept_self_signed && g_str_has_prefix (sink->url, "https")) {
     /* TODO verify the authenticity of the peer's certificate */
-    curl_easy_setopt (sink->curl, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt (curl, CURLOPT_SSL_VERIFYPEER, 0L);
     /* TODO check the servers's claimed identity */
-    curl_easy_setopt (sink->curl, CURLOPT_SSL_VERIFYHOST, 0L);
+    curl_easy_setopt (curl, CURLOPT_SSL_VERIFYHOST, 0L);
   }
 
   /* proxy settings */
   if (sink->proxy != NULL && strlen (sink->proxy)) {
-    if (curl_easy_setopt (sink->curl, CURLOPT_PROXY, sink->proxy)
+    if (curl_easy_setopt (curl, CURLOPT_PROXY, sink->proxy)
         != CURLE_OK) {
       return FALSE;
     }
-    if (curl_easy_setopt (sink->curl, CURLOPT_PROXYPORT, sink->proxy_port)
+    if (curl_easy_setopt (curl, CURLOPT_PROXYPORT, sink->proxy_port)
         != CURLE_OK) {
       return FALSE;
     }
     if (sink->proxy_user != NULL &&
         strlen (sink->proxy_user) &&
         sink->proxy_passwd != NULL && strlen (sink->proxy_passwd)) {
-      curl_easy_setopt (sink->curl, CURLOPT_PROXYUSERNAME, sink->proxy_user);
-      curl_easy_setopt (sink->curl, CURLOPT_PROXYPASSWORD, sink->proxy_passwd);
-      curl_easy_setopt (sink->curl, CURLOPT_PROXYAUTH, CURLAUTH_ANY);
+      curl_easy_setopt (curl, CURLOPT_PROXYUSERNAME, sink->proxy_user);
+      curl_easy_setopt (curl, CURLOPT_PROXYPASSWORD, sink->proxy_passwd);
+      curl_easy_setopt (curl, CURLOPT_PROXYAUTH, CURLAUTH_ANY);
       proxy_auth = TRUE;
     }
     /* tunnel all operations through a given HTTP proxy */
-    if (curl_easy_setopt (sink->curl, CURLOPT_HTTPPROXYTUNNEL, 1L)
+    if (curl_easy_setopt (curl, CURLOPT_HTTPPROXYTUNNEL, 1L)
         != CURLE_OK) {
       return FALSE;
     }
   }
 
   /* POST options */
-  curl_easy_setopt (sink->curl, CURLOPT_POST, 1L);
+  curl_easy_setopt (curl, CURLOPT_POST, 1L);
 
-  curl_easy_setopt (sink->curl, CURLOPT_READFUNCTION,
+  curl_easy_setopt (curl, CURLOPT_READFUNCTION,
       gst_curl_sink_transfer_read_cb);
-  curl_easy_setopt (sink->curl, CURLOPT_READDATA, sink);
-  curl_easy_setopt (sink->curl, CURLOPT_WRITEFUNCTION,
+  curl_easy_setopt (curl, CURLOPT_READDATA, sink);
+  curl_easy_setopt (curl, CURLOPT_WRITEFUNCTION,
       gst_curl_sink_transfer_write_cb);
 
   return TRUE;
@@ -734,54 +1038,86 @@ gst_curl_sink_transfer_read_cb (void *curl_ptr, size_t size, size_t nmemb,
   GstCurlSink *sink;
   TransferBuffer *buffer;
   size_t max_bytes_to_send;
-  guint buf_len;
+  size_t bytes_to_send;
 
   sink = (GstCurlSink *) stream;
+  buffer = sink->transfer_buf;
 
-  /* wait for data to come available, if new file or thread close is set
-   * then zero will be returned to indicate end of current transfer */
-  GST_OBJECT_LOCK (sink);
-  if (gst_curl_sink_wait_for_data_unlocked (sink) == FALSE) {
-    GST_LOG ("returning 0, no more data to send in this file");
+  /* take the next queued buffer when the previous one was sent, if a new
+   * file name or thread close comes first then zero will be returned to
+   * indicate end of current transfer */
+  if (buffer->buffer == NULL) {
+    GST_OBJECT_LOCK (sink);
+    if (gst_curl_sink_wait_for_data_unlocked (sink, TRUE) == FALSE) {
+      GST_LOG ("returning 0, no more data to send in this file");
+      GST_OBJECT_UNLOCK (sink);
+      return 0;
+    }
+    buffer->buffer = g_queue_pop_head (sink->queue);
     GST_OBJECT_UNLOCK (sink);
-    return 0;
-  }
-  GST_OBJECT_UNLOCK (sink);
 
+    buffer->ptr = GST_BUFFER_DATA (buffer->buffer);
+    buffer->len = GST_BUFFER_SIZE (buffer->buffer);
+    buffer->offset = 0;
+  }
 
   max_bytes_to_send = size * nmemb;
-  buffer = sink->transfer_buf;
 
-  buf_len = buffer->len;
   GST_LOG ("write buf len=%" G_GSIZE_FORMAT ", offset=%" G_GSIZE_FORMAT,
       buffer->len, buffer->offset);
 
-  /* more data in buffer */
-  if (buffer->len > 0) {
-    size_t bytes_to_send = MIN (max_bytes_to_send, buf_len);
+  bytes_to_send = MIN (max_bytes_to_send, buffer->len);
 
-    memcpy ((guint8 *) curl_ptr, buffer->ptr + buffer->offset, bytes_to_send);
+  memcpy ((guint8 *) curl_ptr, buffer->ptr + buffer->offset, bytes_to_send);
 
-    buffer->offset = buffer->offset + bytes_to_send;
-    buffer->len = buffer->len - bytes_to_send;
+  buffer->offset = buffer->offset + bytes_to_send;
+  buffer->len = buffer->len - bytes_to_send;
 
-    /* the last data chunk */
-    if (bytes_to_send == buf_len) {
-      buffer->ptr = NULL;
-      buffer->offset = 0;
-      buffer->len = 0;
-      GST_OBJECT_LOCK (sink);
-      gst_curl_sink_data_sent_notify_unlocked (sink);
-      GST_OBJECT_UNLOCK (sink);
-    }
+  /* the last data chunk */
+  if (buffer->len == 0) {
+    GST_OBJECT_LOCK (sink);
+    sink->queue_bytes -= GST_BUFFER_SIZE (buffer->buffer);
+    gst_buffer_unref (buffer->buffer);
+    buffer->buffer = NULL;
+    buffer->ptr = NULL;
+    buffer->offset = 0;
+    gst_curl_sink_data_sent_notify_unlocked (sink);
+    GST_OBJECT_UNLOCK (sink);
+  }
 
-    GST_LOG ("sent : %" G_GSIZE_FORMAT, bytes_to_send);
+  GST_LOG ("sent : %" G_GSIZE_FORMAT, bytes_to_send);
 
-    return bytes_to_send;
-  } else {
-    GST_WARNING ("got zero-length buffer");
-    return 0;
-  }
+  return bytes_to_send;
+}
+
+static size_t
+gst_curl_sink_part_read_cb (void *curl_ptr, size_t size, size_t nmemb,
+    void *stream)
+{
+  TransferPart *part = (TransferPart *) stream;
+  size_t bytes_to_send;
+
+  bytes_to_send = MIN (size * nmemb, part->len - part->sent);
+  memcpy ((guint8 *) curl_ptr,
+      GST_BUFFER_DATA (part->buffer) + part->sent, bytes_to_send);
+  part->sent += bytes_to_send;
+
+  return bytes_to_send;
+}
+
+/* curl rewinds when the request has to be sent again, e.g. after the
+ * authentication was negotiated */
+static int
+gst_curl_sink_part_seek_cb (void *stream, curl_off_t offset, int origin)
+{
+  TransferPart *part = (TransferPart *) stream;
+
+  if (origin != SEEK_SET || offset < 0 || offset > part->len)
+    return CURL_SEEKFUNC_CANTSEEK;
+
+  part->sent = offset;
+
+  return CURL_SEEKFUNC_OK;
 }
 
 static size_t
@@ -822,10 +1158,110 @@ gst_curl_sink_transfer_check (GstCurlSink * sink)
   return code;
 }
 
+/* Waits until one of the sockets of the running transfers can be read or
+ * written, or until curl has a timeout to handle. The sockets curl needs
+ * are different during the transfers, with several connections they are
+ * opened and closed, so they are added to the poll every time. */
 static GstFlowReturn
-gst_curl_sink_handle_transfer (GstCurlSink * sink)
+gst_curl_sink_wait_for_sockets (GstCurlSink * sink, gint timeout)
 {
+  fd_set read_fds, write_fds, exc_fds;
+  gint max_fd = -1;
+  glong curl_timeout = -1;
+  GstClockTime wait;
+  gboolean full_wait;
   gint retval;
+  gint fd;
+  guint i;
+
+  for (i = 0; i < sink->poll_fds->len; i++) {
+    gst_poll_remove_fd (sink->fdset, &g_array_index (sink->poll_fds,
+            GstPollFD, i));
+  }
+  g_array_set_size (sink->poll_fds, 0);
+
+  FD_ZERO (&read_fds);
+  FD_ZERO (&write_fds);
+  FD_ZERO (&exc_fds);
+  curl_multi_fdset (sink->multi_handle, &read_fds, &write_fds, &exc_fds,
+      &max_fd);
+
+  for (fd = 0; fd <= max_fd; fd++) {
+    gboolean readable = FD_ISSET (fd, &read_fds);
+    gboolean writable = FD_ISSET (fd, &write_fds);
+    GstPollFD pfd;
+
+    if (!readable && !writable)
+      continue;
+
+    gst_poll_fd_init (&pfd);
+    pfd.fd = fd;
+    gst_poll_add_fd (sink->fdset, &pfd);
+    gst_poll_fd_ctl_read (sink->fdset, &pfd, readable);
+    gst_poll_fd_ctl_write (sink->fdset, &pfd, writable);
+    g_array_append_val (sink->poll_fds, pfd);
+  }
+
+  /* curl might have something to do before any of the sockets is ready,
+   * e.g. stop waiting for a 100 Continue response */
+  curl_multi_timeout (sink->multi_handle, &curl_timeout);
+  if (curl_timeout >= 0 && curl_timeout < timeout * 1000) {
+    wait = curl_timeout * GST_MSECOND;
+    full_wait = FALSE;
+  } else {
+    wait = timeout * GST_SECOND;
+    full_wait = TRUE;
+  }
+
+  retval = gst_poll_wait (sink->fdset, wait);
+  if (G_UNLIKELY (retval == -1)) {
+    if (errno == EAGAIN || errno == EINTR) {
+      GST_DEBUG_OBJECT (sink, "interrupted by signal");
+    } else if (errno == EBUSY) {
+      goto poll_stopped;
+    } else {
+      goto poll_error;
+    }
+  } else if (G_UNLIKELY (retval == 0 && full_wait)) {
+    GST_DEBUG ("timeout");
+    goto poll_timeout;
+  }
+
+  /* woken up because there is more data to send */
+  GST_OBJECT_LOCK (sink);
+  if (sink->wakeup_pending) {
+    gst_poll_read_control (sink->fdset);
+    sink->wakeup_pending = FALSE;
+  }
+  GST_OBJECT_UNLOCK (sink);
+
+  return GST_FLOW_OK;
+
+poll_error:
+  {
+    GST_DEBUG_OBJECT (sink, "poll failed: %s", g_strerror (errno));
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, ("poll failed"), (NULL));
+    return GST_FLOW_ERROR;
+  }
+
+poll_stopped:
+  {
+    GST_DEBUG_OBJECT (sink, "poll stopped");
+    return GST_FLOW_WRONG_STATE;
+  }
+
+poll_timeout:
+  {
+    GST_DEBUG_OBJECT (sink, "poll timed out");
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, ("poll timed out"), (NULL));
+    return GST_FLOW_ERROR;
+  }
+}
+
+static GstFlowReturn
+gst_curl_sink_handle_transfer (GstCurlSink * sink, gsize size)
+{
+  GstFlowReturn ret;
   gint running_handles;
   gint timeout;
   CURLMcode m_code;
@@ -854,25 +1290,16 @@ gst_curl_sink_handle_transfer (GstCurlSink * sink)
          * When talking to proxy, the Content-Length: 0 is send with the request.
          */
         curl_multi_remove_handle (sink->multi_handle, sink->curl);
-        gst_curl_sink_set_http_header_unlocked (sink);
+        gst_curl_sink_set_http_header_unlocked (sink, sink->curl,
+            &sink->header_list, sink->transfer_file_name, size);
         curl_multi_add_handle (sink->multi_handle, sink->curl);
         proxy_conn_established = TRUE;
       }
     }
 
-    retval = gst_poll_wait (sink->fdset, timeout * GST_SECOND);
-    if (G_UNLIKELY (retval == -1)) {
-      if (errno == EAGAIN || errno == EINTR) {
-        GST_DEBUG_OBJECT (sink, "interrupted by signal");
-      } else if (errno == EBUSY) {
-        goto poll_stopped;
-      } else {
-        goto poll_error;
-      }
-    } else if (G_UNLIKELY (retval == 0)) {
-      GST_DEBUG ("timeout");
-      goto poll_timeout;
-    }
+    ret = gst_curl_sink_wait_for_sockets (sink, timeout);
+    if (ret != GST_FLOW_OK)
+      return ret;
 
     /* readable/writable sockets */
     do {
@@ -912,27 +1339,6 @@ gst_curl_sink_handle_transfer (GstCurlSink * sink)
 
   return GST_FLOW_OK;
 
-poll_error:
-  {
-    GST_DEBUG_OBJECT (sink, "poll failed: %s", g_strerror (errno));
-    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, ("poll failed"), (NULL));
-    return GST_FLOW_ERROR;
-  }
-
-poll_stopped:
-  {
-    GST_DEBUG_OBJECT (sink, "poll stopped");
-    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, ("poll stopped"), (NULL));
-    return GST_FLOW_ERROR;
-  }
-
-poll_timeout:
-  {
-    GST_DEBUG_OBJECT (sink, "poll timed out");
-    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, ("poll timed out"), (NULL));
-    return GST_FLOW_ERROR;
-  }
-
 curl_multi_error:
   {
     GST_DEBUG_OBJECT (sink, "curl multi error");
@@ -966,6 +1372,209 @@ response_error:
   }
 }
 
+static void
+gst_curl_sink_free_part (GstCurlSink * sink, TransferPart * part)
+{
+  if (part->curl != NULL) {
+    curl_multi_remove_handle (sink->multi_handle, part->curl);
+    curl_easy_cleanup (part->curl);
+  }
+  if (part->header_list)
+    curl_slist_free_all (part->header_list);
+  gst_buffer_unref (part->buffer);
+  g_free (part->file_name);
+  g_slice_free (TransferPart, part);
+}
+
+/* Tells if a request for file_name is being sent. Those are not started in
+ * parallel: they could complete in any order and leave the server with an
+ * older buffer than the last one. */
+static gboolean
+gst_curl_sink_file_busy_unlocked (GstCurlSink * sink, const gchar * file_name)
+{
+  GList *walk;
+
+  for (walk = sink->parts; walk; walk = walk->next) {
+    TransferPart *part = walk->data;
+
+    if (g_strcmp0 (part->file_name, file_name) == 0)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* starts a request for the next queued buffer, returns FALSE when there is
+ * nothing to send yet or on errors, which set flow_ret */
+static gboolean
+gst_curl_sink_start_part_unlocked (GstCurlSink * sink)
+{
+  GstMiniObject *head = g_queue_peek_head (sink->queue);
+  TransferPart *part;
+  gboolean end_of_file;
+
+  /* a playlist is only uploaded after the segments it lists */
+  if (sink->parts && head && GST_IS_EVENT (head) &&
+      gst_structure_has_field (gst_event_get_structure (GST_EVENT_CAST
+              (head)), "sequential"))
+    return FALSE;
+
+  /* the next buffer, without waiting for one */
+  if (!gst_curl_sink_next_buffer_unlocked (sink, FALSE, &end_of_file))
+    return FALSE;
+
+  if (gst_curl_sink_file_busy_unlocked (sink, sink->transfer_file_name)) {
+    GST_LOG ("waiting for the previous upload of %s",
+        sink->transfer_file_name);
+    return FALSE;
+  }
+
+  part = g_slice_new0 (TransferPart);
+  part->sink = sink;
+  part->buffer = g_queue_pop_head (sink->queue);
+  part->file_name = g_strdup (sink->transfer_file_name);
+  part->len = GST_BUFFER_SIZE (part->buffer);
+
+  if ((part->curl = curl_easy_init ()) == NULL) {
+    g_warning ("Failed to init easy handle");
+    goto error;
+  }
+  if (!gst_curl_sink_transfer_set_options_unlocked (sink, part->curl)) {
+    g_warning ("Failed to setup easy handle");
+    goto error;
+  }
+  curl_easy_setopt (part->curl, CURLOPT_READFUNCTION,
+      gst_curl_sink_part_read_cb);
+  curl_easy_setopt (part->curl, CURLOPT_READDATA, part);
+  curl_easy_setopt (part->curl, CURLOPT_SEEKFUNCTION,
+      gst_curl_sink_part_seek_cb);
+  curl_easy_setopt (part->curl, CURLOPT_SEEKDATA, part);
+  curl_easy_setopt (part->curl, CURLOPT_PRIVATE, part);
+
+  gst_curl_sink_set_http_header_unlocked (sink, part->curl,
+      &part->header_list, part->file_name, part->len);
+
+  GST_LOG ("starting upload of %s, %" G_GSIZE_FORMAT " bytes",
+      part->file_name, part->len);
+
+  curl_multi_add_handle (sink->multi_handle, part->curl);
+  sink->parts = g_list_prepend (sink->parts, part);
+
+  return TRUE;
+
+error:
+  {
+    sink->queue_bytes -= part->len;
+    gst_curl_sink_free_part (sink, part);
+    sink->flow_ret = GST_FLOW_ERROR;
+    return FALSE;
+  }
+}
+
+static GstFlowReturn
+gst_curl_sink_part_done (GstCurlSink * sink, TransferPart * part,
+    CURLcode code)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  glong resp = -1;
+
+  curl_easy_getinfo (part->curl, CURLINFO_RESPONSE_CODE, &resp);
+  GST_DEBUG_OBJECT (sink, "%s, %" G_GSIZE_FORMAT " bytes done (%s), "
+      "response code %ld", part->file_name, part->len,
+      curl_easy_strerror (code), resp);
+
+  if (code != CURLE_OK) {
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, ("%s",
+            curl_easy_strerror (code)), (NULL));
+    ret = GST_FLOW_ERROR;
+  } else if (resp < 200 || resp >= 300) {
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, ("response error: %ld", resp),
+        (NULL));
+    ret = GST_FLOW_ERROR;
+  }
+
+  GST_OBJECT_LOCK (sink);
+  sink->parts = g_list_remove (sink->parts, part);
+  sink->queue_bytes -= part->len;
+  gst_curl_sink_data_sent_notify_unlocked (sink);
+  GST_OBJECT_UNLOCK (sink);
+
+  gst_curl_sink_free_part (sink, part);
+
+  return ret;
+}
+
+/* Uploads the queued buffers with up to parallel_uploads requests at a time,
+ * until the end of the stream or an error. The connections are kept in the
+ * cache of the multi handle and reused by the following requests. */
+static GstFlowReturn
+gst_curl_sink_handle_parallel_transfers (GstCurlSink * sink)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  gint running_handles;
+  gint timeout;
+  CURLMcode m_code;
+  CURLMsg *msg;
+  gint msgs_left;
+
+  GST_OBJECT_LOCK (sink);
+  while (ret == GST_FLOW_OK && sink->flow_ret == GST_FLOW_OK) {
+    while (g_list_length (sink->parts) < sink->parallel_uploads &&
+        gst_curl_sink_start_part_unlocked (sink));
+
+    if (sink->parts == NULL) {
+      /* nothing is being sent, wait for more data or the end */
+      if (sink->flow_ret != GST_FLOW_OK ||
+          !gst_curl_sink_wait_for_data_unlocked (sink, FALSE))
+        break;
+      continue;
+    }
+    timeout = sink->timeout;
+    GST_OBJECT_UNLOCK (sink);
+
+    do {
+      m_code = curl_multi_perform (sink->multi_handle, &running_handles);
+    } while (m_code == CURLM_CALL_MULTI_PERFORM);
+
+    if (m_code != CURLM_OK) {
+      GST_DEBUG_OBJECT (sink, "curl multi error");
+      GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, ("%s",
+              curl_multi_strerror (m_code)), (NULL));
+      ret = GST_FLOW_ERROR;
+    }
+
+    while (ret == GST_FLOW_OK &&
+        (msg = curl_multi_info_read (sink->multi_handle, &msgs_left))) {
+      TransferPart *part = NULL;
+
+      if (msg->msg != CURLMSG_DONE)
+        continue;
+
+      curl_easy_getinfo (msg->easy_handle, CURLINFO_PRIVATE, (char **) &part);
+      ret = gst_curl_sink_part_done (sink, part, msg->data.result);
+    }
+
+    if (ret == GST_FLOW_OK && running_handles > 0)
+      ret = gst_curl_sink_wait_for_sockets (sink, timeout);
+
+    GST_OBJECT_LOCK (sink);
+  }
+
+  /* abort what is still being sent */
+  while (sink->parts) {
+    TransferPart *part = sink->parts->data;
+
+    sink->parts = g_list_delete_link (sink->parts, sink->parts);
+    sink->queue_bytes -= part->len;
+    gst_curl_sink_free_part (sink, part);
+  }
+  if (ret == GST_FLOW_OK)
+    ret = sink->flow_ret;
+  GST_OBJECT_UNLOCK (sink);
+
+  return ret;
+}
+
 /* This function gets called by libcurl after the socket() call but before
  * the connect() call. */
 static int
@@ -973,7 +1582,6 @@ gst_curl_sink_transfer_socket_cb (void *clientp, curl_socket_t curlfd,
     curlsocktype G_GNUC_UNUSED purpose)
 {
   GstCurlSink *sink;
-  gboolean ret = TRUE;
 
   sink = (GstCurlSink *) clientp;
 
@@ -986,23 +1594,16 @@ gst_curl_sink_transfer_socket_cb (void *clientp, curl_socket_t curlfd,
     return 1;
   }
 
-  gst_poll_fd_init (&sink->fd);
-  sink->fd.fd = curlfd;
-
-  ret = ret && gst_poll_add_fd (sink->fdset, &sink->fd);
-  ret = ret && gst_poll_fd_ctl_write (sink->fdset, &sink->fd, TRUE);
-  ret = ret && gst_poll_fd_ctl_read (sink->fdset, &sink->fd, TRUE);
-  GST_DEBUG ("fd: %d", sink->fd.fd);
+  /* the sockets are added to the poll while waiting for them, only the
+   * DSCP has to be set up here */
+  GST_DEBUG ("fd: %d", curlfd);
   GST_OBJECT_LOCK (sink);
+  sink->fd.fd = curlfd;
   gst_curl_sink_setup_dscp_unlocked (sink);
   GST_OBJECT_UNLOCK (sink);
 
   /* success */
-  if (ret) {
-    return 0;
-  } else {
-    return 1;
-  }
+  return 0;
 }
 
 static gboolean
@@ -1014,6 +1615,8 @@ gst_curl_sink_transfer_start_unlocked (GstCurlSink * sink)
   GST_LOG ("creating transfer thread");
   sink->transfer_thread_close = FALSE;
   sink->new_file = TRUE;
+  g_free (sink->transfer_file_name);
+  sink->transfer_file_name = g_strdup (sink->file_name);
   sink->transfer_thread =
       g_thread_create ((GThreadFunc) gst_curl_sink_transfer_thread_func, sink,
       TRUE, &error);
@@ -1036,54 +1639,73 @@ gst_curl_sink_transfer_thread_func (gpointer data)
 {
   GstCurlSink *sink = (GstCurlSink *) data;
   GstFlowReturn ret = GST_FLOW_OK;
-  gboolean data_available;
+  GstBuffer *next;
 
   GST_LOG ("transfer thread started");
   GST_OBJECT_LOCK (sink);
   if (!gst_curl_sink_transfer_setup_unlocked (sink)) {
+    sink->flow_ret = GST_FLOW_ERROR;
+    GST_OBJECT_UNLOCK (sink);
     GST_DEBUG_OBJECT (sink, "curl setup error");
     GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, ("curl setup error"), (NULL));
-    sink->flow_ret = GST_FLOW_ERROR;
+    GST_OBJECT_LOCK (sink);
     goto done;
   }
 
-  while (!sink->transfer_thread_close && sink->flow_ret == GST_FLOW_OK) {
+  /* every buffer is a request of its own when the content length is used,
+   * those can be sent over several connections at the same time */
+  if (sink->use_content_length && sink->parallel_uploads > 1) {
+    GST_OBJECT_UNLOCK (sink);
+    ret = gst_curl_sink_handle_parallel_transfers (sink);
+    GST_OBJECT_LOCK (sink);
+    sink->flow_ret = ret;
+    goto done;
+  }
+
+  while (sink->flow_ret == GST_FLOW_OK) {
     /* we are working on a new file, clearing flag and setting file
      * name in http header */
     sink->new_file = FALSE;
 
     /* wait for data to arrive for this new file, if we get a new file name
      * again before getting data we will simply skip transfering anything
-     * for this file and go directly to the new file */
-    data_available = gst_curl_sink_wait_for_data_unlocked (sink);
-    if (data_available) {
-      gst_curl_sink_set_http_header_unlocked (sink);
-    }
+     * for this file and go directly to the new file. Only the end of the
+     * stream with nothing left to send makes us stop. */
+    if (!gst_curl_sink_wait_for_data_unlocked (sink, FALSE))
+      break;
+
+    next = g_queue_peek_head (sink->queue);
+    gst_curl_sink_set_http_header_unlocked (sink, sink->curl,
+        &sink->header_list, sink->transfer_file_name,
+        GST_BUFFER_SIZE (next));
 
     /* stay unlocked while handling the actual transfer */
     GST_OBJECT_UNLOCK (sink);
 
-    if (data_available) {
-      curl_multi_add_handle (sink->multi_handle, sink->curl);
+    curl_multi_add_handle (sink->multi_handle, sink->curl);
 
-      /* Start driving the transfer. */
-      ret = gst_curl_sink_handle_transfer (sink);
+    /* Start driving the transfer. */
+    ret = gst_curl_sink_handle_transfer (sink, GST_BUFFER_SIZE (next));
 
-      /* easy handle will be possibly re-used for next transfer, thus it needs to
-       * be removed from the multi stack and re-added again */
-      curl_multi_remove_handle (sink->multi_handle, sink->curl);
-    }
+    /* easy handle will be possibly re-used for next transfer, thus it needs to
+     * be removed from the multi stack and re-added again */
+    curl_multi_remove_handle (sink->multi_handle, sink->curl);
 
-    /* lock again before looping to check the thread closed flag */
+    /* lock again before looping to check the flow return */
     GST_OBJECT_LOCK (sink);
 
-    /* if we have transfered data, then set the return code */
-    if (data_available) {
-      sink->flow_ret = ret;
-    }
+    sink->flow_ret = ret;
   }
 
 done:
+  /* a buffer that was not completely sent because of an error */
+  if (sink->transfer_buf->buffer) {
+    sink->queue_bytes -= GST_BUFFER_SIZE (sink->transfer_buf->buffer);
+    gst_buffer_unref (sink->transfer_buf->buffer);
+    sink->transfer_buf->buffer = NULL;
+    sink->transfer_buf->len = 0;
+  }
+
   /* if there is a flow error, always notify the render function so it
    * can return the flow error up along the pipeline */
   if (sink->flow_ret != GST_FLOW_OK) {
@@ -1110,9 +1732,8 @@ gst_curl_sink_transfer_setup_unlocked (GstCurlSink * sink)
     }
   }
 
-  if (!gst_curl_sink_transfer_set_options_unlocked (sink)) {
+  if (!gst_curl_sink_transfer_set_options_unlocked (sink, sink->curl)) {
     g_warning ("Failed to setup easy handle");
-    GST_OBJECT_UNLOCK (sink);
     return FALSE;
   }
 
@@ -1143,44 +1764,276 @@ gst_curl_sink_transfer_cleanup (GstCurlSink * sink)
   }
 }
 
+/* Applies the new file names and drops the empty buffers in front of the
+ * queue, returns the next buffer to send or NULL. If @in_file is set a new
+ * file name is not applied because it ends the current file. */
+static GstBuffer *
+gst_curl_sink_next_buffer_unlocked (GstCurlSink * sink, gboolean in_file,
+    gboolean * end_of_file)
+{
+  GstMiniObject *item;
+
+  *end_of_file = FALSE;
+  while ((item = g_queue_peek_head (sink->queue))) {
+    if (GST_IS_EVENT (item)) {
+      const GstStructure *s;
+
+      if (in_file) {
+        *end_of_file = TRUE;
+        return NULL;
+      }
+      s = gst_event_get_structure (GST_EVENT_CAST (item));
+      g_free (sink->transfer_file_name);
+      sink->transfer_file_name =
+          g_strdup (gst_structure_get_string (s, "file-name"));
+      g_free (sink->transfer_content_type);
+      sink->transfer_content_type =
+          g_strdup (gst_structure_get_string (s, "content-type"));
+      GST_LOG ("new file name %s", sink->transfer_file_name);
+    } else if (GST_BUFFER_SIZE (item) > 0) {
+      return GST_BUFFER_CAST (item);
+    } else {
+      GST_LOG ("dropping empty buffer");
+    }
+    gst_mini_object_unref (g_queue_pop_head (sink->queue));
+  }
+
+  return NULL;
+}
+
+/* Waits until the next queued item is a buffer, returns FALSE when the
+ * thread is closed with nothing left to send or, with @in_file set, when
+ * the current file is complete. */
 static gboolean
-gst_curl_sink_wait_for_data_unlocked (GstCurlSink * sink)
+gst_curl_sink_wait_for_data_unlocked (GstCurlSink * sink, gboolean in_file)
 {
-  gboolean data_available = FALSE;
+  gboolean end_of_file;
 
   GST_LOG ("waiting for data");
-  while (!sink->transfer_cond->data_available &&
-      !sink->transfer_thread_close && !sink->new_file) {
+  while (!gst_curl_sink_next_buffer_unlocked (sink, in_file, &end_of_file)) {
+    if (end_of_file) {
+      GST_LOG ("wait for data aborted due to new file name");
+      return FALSE;
+    }
+    if (sink->transfer_thread_close) {
+      GST_LOG ("wait for data aborted due to thread close");
+      return FALSE;
+    }
     g_cond_wait (sink->transfer_cond->cond, GST_OBJECT_GET_LOCK (sink));
   }
+  GST_LOG ("wait for data completed");
 
-  if (sink->transfer_thread_close) {
-    GST_LOG ("wait for data aborted due to thread close");
-  } else if (sink->new_file) {
-    GST_LOG ("wait for data aborted due to new file name");
-  } else {
-    GST_LOG ("wait for data completed");
-    data_available = TRUE;
-  }
+  return TRUE;
+}
+
+static void
+gst_curl_sink_flush_queue_unlocked (GstCurlSink * sink)
+{
+  GstMiniObject *item;
+
+  while ((item = g_queue_pop_head (sink->queue)))
+    gst_mini_object_unref (item);
 
-  return data_available;
+  /* what the transfer thread is sending is counted until it is done */
+  sink->queue_bytes = 0;
+  if (sink->transfer_buf->buffer)
+    sink->queue_bytes += GST_BUFFER_SIZE (sink->transfer_buf->buffer);
+  if (sink->parts) {
+    GList *walk;
+
+    for (walk = sink->parts; walk; walk = walk->next)
+      sink->queue_bytes += ((TransferPart *) walk->data)->len;
+  }
+  g_cond_broadcast (sink->transfer_cond->cond);
 }
 
 static void
 gst_curl_sink_transfer_thread_notify_unlocked (GstCurlSink * sink)
 {
   GST_LOG ("more data to send");
-  sink->transfer_cond->data_available = TRUE;
-  sink->transfer_cond->data_sent = FALSE;
-  g_cond_signal (sink->transfer_cond->cond);
+  g_cond_broadcast (sink->transfer_cond->cond);
+
+  /* the parallel transfers might be waiting for their sockets with a free
+   * connection */
+  if (!sink->wakeup_pending && sink->fdset) {
+    sink->wakeup_pending = TRUE;
+    gst_poll_write_control (sink->fdset);
+  }
 }
 
+/* the file name change is queued after the data of the previous file, a
+ * @sequential file is only sent after the previous files are complete */
 static void
-gst_curl_sink_new_file_notify_unlocked (GstCurlSink * sink)
+gst_curl_sink_new_file_notify_unlocked (GstCurlSink * sink,
+    const gchar * file_name, const gchar * content_type, gboolean sequential)
 {
-  GST_LOG ("new file name");
+  GstStructure *s;
+
+  GST_LOG ("new file name %s", file_name);
+  s = gst_structure_new ("curlsink-new-file",
+      "file-name", G_TYPE_STRING, file_name, NULL);
+  if (content_type)
+    gst_structure_set (s, "content-type", G_TYPE_STRING, content_type, NULL);
+  if (sequential)
+    gst_structure_set (s, "sequential", G_TYPE_BOOLEAN, TRUE, NULL);
+  g_queue_push_tail (sink->queue,
+      gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM, s));
   sink->new_file = TRUE;
-  g_cond_signal (sink->transfer_cond->cond);
+  g_cond_broadcast (sink->transfer_cond->cond);
+}
+
+/* takes ownership of @buf */
+static void
+gst_curl_sink_queue_buffer_unlocked (GstCurlSink * sink, GstBuffer * buf)
+{
+  g_queue_push_tail (sink->queue, buf);
+  sink->queue_bytes += GST_BUFFER_SIZE (buf);
+  gst_curl_sink_transfer_thread_notify_unlocked (sink);
+}
+
+static void
+gst_curl_sink_start_segment_unlocked (GstCurlSink * sink, GstClockTime start)
+{
+  g_free (sink->segment_name);
+  sink->segment_name = g_strdup_printf (sink->segment_location,
+      sink->segment_index);
+  sink->segment_start = start;
+  sink->segment_end = start;
+  sink->in_segment = TRUE;
+
+  GST_DEBUG_OBJECT (sink, "starting segment %s at %" GST_TIME_FORMAT,
+      sink->segment_name, GST_TIME_ARGS (start));
+  gst_curl_sink_new_file_notify_unlocked (sink, sink->segment_name, NULL,
+      FALSE);
+}
+
+static GstBuffer *
+gst_curl_sink_playlist_new_unlocked (GstCurlSink * sink, gboolean last)
+{
+  GstBuffer *buf;
+  GString *str;
+  GList *walk;
+  SegmentEntry *first;
+  GstClockTime target = 0;
+  gchar extinf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  for (walk = sink->playlist->head; walk; walk = walk->next)
+    target = MAX (target, ((SegmentEntry *) walk->data)->duration);
+  first = g_queue_peek_head (sink->playlist);
+
+  str = g_string_new ("#EXTM3U\n#EXT-X-VERSION:3\n");
+  g_string_append_printf (str, "#EXT-X-TARGETDURATION:%u\n",
+      (guint) ((target + GST_SECOND - 1) / GST_SECOND));
+  g_string_append_printf (str, "#EXT-X-MEDIA-SEQUENCE:%u\n", first->index);
+  for (walk = sink->playlist->head; walk; walk = walk->next) {
+    SegmentEntry *entry = walk->data;
+
+    g_ascii_formatd (extinf, sizeof (extinf), "%.3f",
+        (gdouble) entry->duration / GST_SECOND);
+    g_string_append_printf (str, "#EXTINF:%s,\n%s\n", extinf, entry->name);
+  }
+  if (last)
+    g_string_append (str, "#EXT-X-ENDLIST\n");
+
+  buf = gst_buffer_new ();
+  GST_BUFFER_SIZE (buf) = str->len;
+  GST_BUFFER_MALLOCDATA (buf) = (guint8 *) g_string_free (str, FALSE);
+  GST_BUFFER_DATA (buf) = GST_BUFFER_MALLOCDATA (buf);
+
+  return buf;
+}
+
+/* queues what is left of the current segment, adds it to the playlist and
+ * queues the playlist */
+static void
+gst_curl_sink_end_segment_unlocked (GstCurlSink * sink, gboolean last)
+{
+  SegmentEntry *entry;
+  guint avail;
+
+  avail = gst_adapter_available (sink->adapter);
+  if (avail > 0) {
+    gst_curl_sink_queue_buffer_unlocked (sink,
+        gst_adapter_take_buffer (sink->adapter, avail));
+  }
+
+  entry = g_slice_new (SegmentEntry);
+  entry->name = sink->segment_name;
+  entry->index = sink->segment_index;
+  entry->duration = 0;
+  if (GST_CLOCK_TIME_IS_VALID (sink->segment_start) &&
+      GST_CLOCK_TIME_IS_VALID (sink->segment_end) &&
+      sink->segment_end > sink->segment_start)
+    entry->duration = sink->segment_end - sink->segment_start;
+  sink->segment_name = NULL;
+  sink->segment_index++;
+  sink->in_segment = FALSE;
+
+  GST_DEBUG_OBJECT (sink, "segment %s complete, duration %" GST_TIME_FORMAT,
+      entry->name, GST_TIME_ARGS (entry->duration));
+
+  g_queue_push_tail (sink->playlist, entry);
+  while (sink->playlist_length > 0 &&
+      g_queue_get_length (sink->playlist) > sink->playlist_length) {
+    entry = g_queue_pop_head (sink->playlist);
+    g_free (entry->name);
+    g_slice_free (SegmentEntry, entry);
+  }
+
+  if (sink->playlist_location == NULL || *sink->playlist_location == '\0')
+    return;
+
+  gst_curl_sink_new_file_notify_unlocked (sink, sink->playlist_location,
+      PLAYLIST_CONTENT_TYPE, TRUE);
+  gst_curl_sink_queue_buffer_unlocked (sink,
+      gst_curl_sink_playlist_new_unlocked (sink, last));
+}
+
+/* starts a new segment at the first keyframe after the segment duration,
+ * before @buf is queued */
+static void
+gst_curl_sink_segment_unlocked (GstCurlSink * sink, GstBuffer * buf)
+{
+  GstClockTime ts = GST_BUFFER_TIMESTAMP (buf);
+
+  if (!sink->in_segment) {
+    gst_curl_sink_start_segment_unlocked (sink, ts);
+  } else if (!GST_CLOCK_TIME_IS_VALID (sink->segment_start)) {
+    /* the stream headers before the first timestamp */
+    sink->segment_start = sink->segment_end = ts;
+  } else if (GST_CLOCK_TIME_IS_VALID (ts) &&
+      !GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT) &&
+      ts >= sink->segment_start + sink->segment_duration) {
+    /* the segment ends where the next one starts */
+    sink->segment_end = ts;
+    gst_curl_sink_end_segment_unlocked (sink, FALSE);
+    gst_curl_sink_start_segment_unlocked (sink, ts);
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (ts)) {
+    GstClockTime end = ts;
+
+    if (GST_BUFFER_DURATION_IS_VALID (buf))
+      end += GST_BUFFER_DURATION (buf);
+    if (!GST_CLOCK_TIME_IS_VALID (sink->segment_end) ||
+        end > sink->segment_end)
+      sink->segment_end = end;
+  }
+}
+
+static void
+gst_curl_sink_reset_segments_unlocked (GstCurlSink * sink)
+{
+  SegmentEntry *entry;
+
+  while ((entry = g_queue_pop_head (sink->playlist))) {
+    g_free (entry->name);
+    g_slice_free (SegmentEntry, entry);
+  }
+  gst_adapter_clear (sink->adapter);
+  g_free (sink->segment_name);
+  sink->segment_name = NULL;
+  sink->in_segment = FALSE;
 }
 
 static void
@@ -1188,19 +2041,21 @@ gst_curl_sink_transfer_thread_close_unlocked (GstCurlSink * sink)
 {
   GST_LOG ("setting transfer thread close flag");
   sink->transfer_thread_close = TRUE;
-  g_cond_signal (sink->transfer_cond->cond);
+  g_cond_broadcast (sink->transfer_cond->cond);
 }
 
 static void
 gst_curl_sink_wait_for_transfer_thread_to_send_unlocked (GstCurlSink * sink)
 {
-  GST_LOG ("waiting for buffer send to complete");
+  GST_LOG ("waiting for the queue to drain below %u bytes",
+      sink->max_queue_size);
 
   /* this function should not check if the transfer thread is set to be closed
    * since that flag only can be set by the EoS event (by the pipeline thread).
    * This can therefore never happen while this function is running since this
    * function also is called by the pipeline thread (in the render function) */
-  while (!sink->transfer_cond->data_sent) {
+  while (sink->queue_bytes > sink->max_queue_size &&
+      sink->flow_ret == GST_FLOW_OK && !sink->flushing) {
     g_cond_wait (sink->transfer_cond->cond, GST_OBJECT_GET_LOCK (sink));
   }
   GST_LOG ("buffer send completed");
@@ -1210,9 +2065,7 @@ static void
 gst_curl_sink_data_sent_notify_unlocked (GstCurlSink * sink)
 {
   GST_LOG ("transfer completed");
-  sink->transfer_cond->data_available = FALSE;
-  sink->transfer_cond->data_sent = TRUE;
-  g_cond_signal (sink->transfer_cond->cond);
+  g_cond_broadcast (sink->transfer_cond->cond);
 }
 
 static gint
@@ -22,6 +22,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbasesink.h>
+#include <gst/base/gstadapter.h>
 #include <curl/curl.h>
 
 G_BEGIN_DECLS
@@ -42,17 +43,28 @@ typedef struct _GstCurlSinkClass GstCurlSinkClass;
 
 typedef struct _TransferBuffer TransferBuffer;
 typedef struct _TransferCondition TransferCondition;
+typedef struct _TransferPart TransferPart;
 
 struct _TransferBuffer {
+  GstBuffer *buffer;
   guint8 *ptr;
   size_t len;
   size_t offset;
 };
 
+/* one request of a parallel upload, sending len bytes of buffer */
+struct _TransferPart {
+  GstCurlSink *sink;
+  CURL *curl;
+  struct curl_slist *header_list;
+  GstBuffer *buffer;
+  gchar *file_name;
+  size_t len;
+  size_t sent;
+};
+
 struct _TransferCondition {
   GCond *cond;
-  gboolean data_sent;
-  gboolean data_available;
 };
 
 struct _GstCurlSink
@@ -86,6 +98,37 @@ struct _GstCurlSink
   gboolean new_file;
   gchar *content_type;
   gboolean proxy_headers_set;
+
+  /* buffers and file name changes waiting for the transfer thread, the
+   * bytes of the buffers are counted until they are sent */
+  GQueue *queue;
+  guint64 queue_bytes;
+  guint max_queue_size;
+  gboolean flushing;
+  /* the file name of the data that is being sent */
+  gchar *transfer_file_name;
+  gboolean wakeup_pending;
+  GArray *poll_fds;
+
+  /* parallel uploads */
+  gint parallel_uploads;
+  GList *parts;
+  /* the content type of the file that is being sent, NULL for the
+   * content-type property */
+  gchar *transfer_content_type;
+
+  /* segmenting */
+  GstClockTime segment_duration;
+  gchar *segment_location;
+  gchar *playlist_location;
+  guint playlist_length;
+  gboolean in_segment;
+  guint segment_index;
+  gchar *segment_name;
+  GstClockTime segment_start;
+  GstClockTime segment_end;
+  GQueue *playlist;
+  GstAdapter *adapter;
 };
 
 struct _GstCurlSinkClass
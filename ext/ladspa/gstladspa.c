@@ -37,6 +37,7 @@
 #include <gst/controller/gstcontroller.h>
 
 #include "gstladspa.h"
+#include "gstladsparack.h"
 #include <ladspa.h>             /* main ladspa sdk include file */
 #ifdef HAVE_LRDF
 #include <lrdf.h>
@@ -73,6 +74,9 @@ GST_DEBUG_CATEGORY_STATIC (ladspa_debug);
 
 static GQuark descriptor_quark = 0;
 
+/* label => LADSPA_Descriptor of all the registered plugins */
+static GHashTable *descriptors = NULL;
+
 
 static void
 gst_ladspa_base_init (gpointer g_class)
@@ -323,33 +327,24 @@ gst_ladspa_class_get_param_name (GstLADSPAClass * klass, gint portnum)
   return ret;
 }
 
-static GParamSpec *
-gst_ladspa_class_get_param_spec (GstLADSPAClass * klass, gint portnum)
+/*
+ * gst_ladspa_port_get_range:
+ * @desc: plugin descriptor
+ * @portnum: control port number
+ * @rate: sample rate the bounds of sample rate ports are relative to
+ *
+ * Computes the bounds and the default value of a control port from its hints.
+ */
+void
+gst_ladspa_port_get_range (const LADSPA_Descriptor * desc, gint portnum,
+    gint rate, gfloat * lower_out, gfloat * upper_out, gfloat * def_out)
 {
-  LADSPA_Descriptor *desc;
-  GParamSpec *ret;
-  gchar *name;
-  gint hintdesc, perms;
+  gint hintdesc;
   gfloat lower, upper, def;
 
-  desc = klass->descriptor;
-
-  name = gst_ladspa_class_get_param_name (klass, portnum);
-  perms = G_PARAM_READABLE;
-  if (LADSPA_IS_PORT_INPUT (desc->PortDescriptors[portnum]))
-    perms |= G_PARAM_WRITABLE | G_PARAM_CONSTRUCT;
-  if (LADSPA_IS_PORT_CONTROL (desc->PortDescriptors[portnum]))
-    perms |= GST_PARAM_CONTROLLABLE;
-
   /* short name for hint descriptor */
   hintdesc = desc->PortRangeHints[portnum].HintDescriptor;
 
-  if (LADSPA_IS_HINT_TOGGLED (hintdesc)) {
-    ret = g_param_spec_boolean (name, name, name, FALSE, perms);
-    g_free (name);
-    return ret;
-  }
-
   if (LADSPA_IS_HINT_BOUNDED_BELOW (hintdesc))
     lower = desc->PortRangeHints[portnum].LowerBound;
   else
@@ -361,9 +356,8 @@ gst_ladspa_class_get_param_spec (GstLADSPAClass * klass, gint portnum)
     upper = G_MAXFLOAT;
 
   if (LADSPA_IS_HINT_SAMPLE_RATE (hintdesc)) {
-    /* FIXME! */
-    lower *= 44100;
-    upper *= 44100;
+    lower *= rate;
+    upper *= rate;
   }
 
   if (LADSPA_IS_HINT_INTEGER (hintdesc)) {
@@ -415,7 +409,40 @@ gst_ladspa_class_get_param_spec (GstLADSPAClass * klass, gint portnum)
     upper = tmp;
   }
 
-  def = CLAMP (def, lower, upper);
+  *lower_out = lower;
+  *upper_out = upper;
+  *def_out = CLAMP (def, lower, upper);
+}
+
+static GParamSpec *
+gst_ladspa_class_get_param_spec (GstLADSPAClass * klass, gint portnum)
+{
+  LADSPA_Descriptor *desc;
+  GParamSpec *ret;
+  gchar *name;
+  gint hintdesc, perms;
+  gfloat lower, upper, def;
+
+  desc = klass->descriptor;
+
+  name = gst_ladspa_class_get_param_name (klass, portnum);
+  perms = G_PARAM_READABLE;
+  if (LADSPA_IS_PORT_INPUT (desc->PortDescriptors[portnum]))
+    perms |= G_PARAM_WRITABLE | G_PARAM_CONSTRUCT;
+  if (LADSPA_IS_PORT_CONTROL (desc->PortDescriptors[portnum]))
+    perms |= GST_PARAM_CONTROLLABLE;
+
+  /* short name for hint descriptor */
+  hintdesc = desc->PortRangeHints[portnum].HintDescriptor;
+
+  if (LADSPA_IS_HINT_TOGGLED (hintdesc)) {
+    ret = g_param_spec_boolean (name, name, name, FALSE, perms);
+    g_free (name);
+    return ret;
+  }
+
+  /* FIXME! the sample rate is not known when the class is created */
+  gst_ladspa_port_get_range (desc, portnum, 44100, &lower, &upper, &def);
 
   if (LADSPA_IS_HINT_INTEGER (hintdesc)) {
     ret = g_param_spec_int (name, name, name, lower, upper, def, perms);
@@ -711,11 +738,25 @@ ladspa_describe_plugin (LADSPA_Descriptor_Function descriptor_function)
     if (!gst_element_register (ladspa_plugin, type_name, GST_RANK_NONE, type))
       goto next;
 
+    g_hash_table_insert (descriptors, (gpointer) desc->Label, (gpointer) desc);
+
   next:
     g_free (type_name);
   }
 }
 
+/*
+ * gst_ladspa_find_descriptor:
+ * @label: the label of a plugin
+ *
+ * Returns: the descriptor of the registered plugin with @label, or NULL.
+ */
+const LADSPA_Descriptor *
+gst_ladspa_find_descriptor (const gchar * label)
+{
+  return g_hash_table_lookup (descriptors, label);
+}
+
 #ifdef HAVE_LRDF
 static gboolean
 ladspa_rdf_directory_search (const char *dir_name)
@@ -879,11 +920,14 @@ plugin_init (GstPlugin * plugin)
 
   ladspa_plugin = plugin;
   descriptor_quark = g_quark_from_static_string ("ladspa-descriptor");
+  descriptors = g_hash_table_new (g_str_hash, g_str_equal);
 
   if (!ladspa_plugin_path_search ()) {
     GST_WARNING ("no ladspa plugins found, check LADSPA_PATH");
   }
 
+  gst_ladspa_rack_register (plugin);
+
   /* we don't want to fail, even if there are no elements registered */
   return TRUE;
 }
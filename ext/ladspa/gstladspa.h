@@ -70,6 +70,11 @@ struct _GstLADSPAClass {
 };
 
 
+const LADSPA_Descriptor *gst_ladspa_find_descriptor (const gchar * label);
+void gst_ladspa_port_get_range (const LADSPA_Descriptor * desc, gint portnum,
+    gint rate, gfloat * lower, gfloat * upper, gfloat * def);
+
+
 G_END_DECLS
 
 
@@ -0,0 +1,606 @@
+/* GStreamer
+ *
+ * gstladsparack.c: runs a chain of LADSPA plugins in one element
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+/**
+ * SECTION:element-ladsparack
+ *
+ * The ladsparack and ladsparack-stereo elements run an ordered chain of
+ * LADSPA plugins on a mono or a stereo stream. The plugins are connected to
+ * each other on shared float buffers, so the whole chain runs in a single
+ * process call, without the buffer allocations, pushes and (de)interleaving
+ * that a chain of ladspa elements needs.
+ *
+ * The chain is described like a gst-launch line, the plugins are given by
+ * their LADSPA label, followed by the values of their control ports:
+ * |[
+ * gst-launch audiotestsrc ! audioconvert ! ladsparack-stereo
+ *     plugins="amp_stereo gain=0.5 ! delay_5s delay=0.25 dry-wet-balance=0.3"
+ *     ! audioconvert ! autoaudiosink
+ * ]|
+ * Mono plugins are instantiated once for each channel, plugins with as many
+ * audio inputs and outputs as the stream has channels once.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <string.h>
+
+#include "gstladspa.h"
+#include "gstladsparack.h"
+
+GST_DEBUG_CATEGORY_STATIC (ladspa_rack_debug);
+#define GST_CAT_DEFAULT ladspa_rack_debug
+
+enum
+{
+  PROP_0,
+  PROP_PLUGINS
+};
+
+static void gst_ladspa_rack_finalize (GObject * object);
+static void gst_ladspa_rack_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_ladspa_rack_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static gboolean gst_ladspa_rack_setup (GstSignalProcessor * gsp,
+    GstCaps * caps);
+static gboolean gst_ladspa_rack_start (GstSignalProcessor * gsp);
+static void gst_ladspa_rack_stop (GstSignalProcessor * gsp);
+static void gst_ladspa_rack_cleanup (GstSignalProcessor * gsp);
+static void gst_ladspa_rack_process (GstSignalProcessor * gsp,
+    guint nframes);
+
+static GstSignalProcessorClass *parent_class;
+
+static GQuark channels_quark = 0;
+
+static void
+gst_ladspa_rack_base_init (gpointer g_class)
+{
+  GstLADSPARackClass *klass = (GstLADSPARackClass *) g_class;
+  GstElementClass *element_class = GST_ELEMENT_CLASS (g_class);
+  GstSignalProcessorClass *gsp_class = GST_SIGNAL_PROCESSOR_CLASS (g_class);
+
+  klass->channels =
+      GPOINTER_TO_UINT (g_type_get_qdata (G_OBJECT_CLASS_TYPE (klass),
+          channels_quark));
+  g_assert (klass->channels > 0);
+
+  /* a single mono pad or a single multi-channel group in each direction */
+  gsp_class->num_audio_in = 0;
+  gsp_class->num_audio_out = 0;
+  gsp_class->num_group_in = 0;
+  gsp_class->num_group_out = 0;
+  if (klass->channels == 1) {
+    gst_signal_processor_class_add_pad_template (gsp_class, "sink",
+        GST_PAD_SINK, gsp_class->num_audio_in++, 1);
+    gst_signal_processor_class_add_pad_template (gsp_class, "src",
+        GST_PAD_SRC, gsp_class->num_audio_out++, 1);
+  } else {
+    gst_signal_processor_class_add_pad_template (gsp_class, "sink",
+        GST_PAD_SINK, gsp_class->num_group_in++, klass->channels);
+    gst_signal_processor_class_add_pad_template (gsp_class, "src",
+        GST_PAD_SRC, gsp_class->num_group_out++, klass->channels);
+  }
+
+  /* the chain reads its input before writing its output */
+  GST_SIGNAL_PROCESSOR_CLASS_SET_CAN_PROCESS_IN_PLACE (klass);
+
+  gst_element_class_set_details_simple (element_class, "LADSPA rack",
+      "Filter/Effect/Audio/LADSPA", "Runs a chain of LADSPA plugins",
+      "GStreamer maintainers <gstreamer-devel@lists.sourceforge.net>");
+}
+
+static void
+gst_ladspa_rack_class_init (GstLADSPARackClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstSignalProcessorClass *gsp_class;
+
+  parent_class = g_type_class_peek_parent (klass);
+
+  gobject_class = (GObjectClass *) klass;
+  gobject_class->finalize = gst_ladspa_rack_finalize;
+  gobject_class->set_property = gst_ladspa_rack_set_property;
+  gobject_class->get_property = gst_ladspa_rack_get_property;
+
+  gsp_class = GST_SIGNAL_PROCESSOR_CLASS (klass);
+  gsp_class->setup = gst_ladspa_rack_setup;
+  gsp_class->start = gst_ladspa_rack_start;
+  gsp_class->stop = gst_ladspa_rack_stop;
+  gsp_class->cleanup = gst_ladspa_rack_cleanup;
+  gsp_class->process = gst_ladspa_rack_process;
+
+  g_object_class_install_property (gobject_class, PROP_PLUGINS,
+      g_param_spec_string ("plugins", "Plugins",
+          "The chain of plugins, as \"label port=value ... ! label ...\", "
+          "can only be changed while the element is not running", NULL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void
+gst_ladspa_rack_init (GstLADSPARack * rack, GstLADSPARackClass * klass)
+{
+  rack->description = NULL;
+  rack->plugins = NULL;
+  rack->n_plugins = 0;
+  rack->activated = FALSE;
+}
+
+static void
+gst_ladspa_rack_finalize (GObject * object)
+{
+  GstLADSPARack *rack = (GstLADSPARack *) object;
+
+  g_free (rack->description);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_ladspa_rack_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstLADSPARack *rack = (GstLADSPARack *) object;
+
+  switch (prop_id) {
+    case PROP_PLUGINS:
+      /* the plugins are instantiated when the caps are set */
+      if (GST_SIGNAL_PROCESSOR_IS_INITIALIZED (rack)) {
+        GST_WARNING_OBJECT (rack, "can't change the plugins while running");
+        break;
+      }
+      g_free (rack->description);
+      rack->description = g_value_dup_string (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_ladspa_rack_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstLADSPARack *rack = (GstLADSPARack *) object;
+
+  switch (prop_id) {
+    case PROP_PLUGINS:
+      g_value_set_string (value, rack->description);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/* same as the property names of the ladspa elements, without the duplicate
+ * handling */
+static gboolean
+gst_ladspa_rack_port_has_name (const LADSPA_Descriptor * desc, gint portnum,
+    const gchar * name)
+{
+  gchar *port_name, *paren;
+  gboolean ret;
+
+  port_name = g_strdup (desc->PortNames[portnum]);
+  paren = g_strrstr (port_name, " (");
+  if (paren != NULL)
+    *paren = '\0';
+  g_strcanon (port_name, G_CSET_A_2_Z G_CSET_a_2_z G_CSET_DIGITS "-", '-');
+
+  ret = g_ascii_strcasecmp (port_name, name) == 0;
+  g_free (port_name);
+
+  return ret;
+}
+
+static gboolean
+gst_ladspa_rack_plugin_set_control (GstLADSPARack * rack,
+    GstLADSPARackPlugin * plugin, const gchar * assignment)
+{
+  const LADSPA_Descriptor *desc = plugin->descriptor;
+  gchar **kv;
+  gchar *end;
+  gfloat value;
+  guint j;
+  gboolean ret = FALSE;
+
+  kv = g_strsplit (assignment, "=", 2);
+  if (!kv[0] || !kv[1])
+    goto done;
+
+  if (!g_ascii_strcasecmp (kv[1], "true"))
+    value = 1.0;
+  else if (!g_ascii_strcasecmp (kv[1], "false"))
+    value = 0.0;
+  else {
+    value = g_ascii_strtod (kv[1], &end);
+    if (end == kv[1] || *end != '\0')
+      goto done;
+  }
+
+  for (j = 0; j < desc->PortCount; j++) {
+    LADSPA_PortDescriptor p = desc->PortDescriptors[j];
+
+    if (LADSPA_IS_PORT_CONTROL (p) && LADSPA_IS_PORT_INPUT (p) &&
+        gst_ladspa_rack_port_has_name (desc, j, kv[0])) {
+      GST_DEBUG_OBJECT (rack, "%s: %s = %f", desc->Label, desc->PortNames[j],
+          value);
+      plugin->controls[j] = value;
+      ret = TRUE;
+      break;
+    }
+  }
+
+done:
+  g_strfreev (kv);
+  return ret;
+}
+
+static void
+gst_ladspa_rack_plugin_free (GstLADSPARackPlugin * plugin)
+{
+  guint i;
+
+  for (i = 0; plugin->handles && i < plugin->n_handles; i++) {
+    if (plugin->handles[i] && plugin->descriptor->cleanup)
+      plugin->descriptor->cleanup (plugin->handles[i]);
+  }
+  g_free (plugin->handles);
+  g_free (plugin->audio_in_portnums);
+  g_free (plugin->audio_out_portnums);
+  g_free (plugin->controls);
+}
+
+static void
+gst_ladspa_rack_free_plugins (GstLADSPARack * rack)
+{
+  guint i;
+
+  for (i = 0; i < rack->n_plugins; i++)
+    gst_ladspa_rack_plugin_free (&rack->plugins[i]);
+  g_free (rack->plugins);
+  rack->plugins = NULL;
+  rack->n_plugins = 0;
+}
+
+/* creates the instances of the plugin described by @tokens, the label
+ * followed by the control port assignments */
+static gboolean
+gst_ladspa_rack_plugin_init (GstLADSPARack * rack,
+    GstLADSPARackPlugin * plugin, gchar ** tokens, gint rate)
+{
+  GstLADSPARackClass *klass = (GstLADSPARackClass *) G_OBJECT_GET_CLASS (rack);
+  const LADSPA_Descriptor *desc;
+  guint n_in = 0, n_out = 0, i, j;
+
+  desc = gst_ladspa_find_descriptor (tokens[0]);
+  if (!desc)
+    goto no_plugin;
+  plugin->descriptor = desc;
+
+  for (j = 0; j < desc->PortCount; j++) {
+    LADSPA_PortDescriptor p = desc->PortDescriptors[j];
+
+    if (LADSPA_IS_PORT_AUDIO (p)) {
+      if (LADSPA_IS_PORT_INPUT (p))
+        n_in++;
+      else
+        n_out++;
+    }
+  }
+  if (n_in != n_out || (n_in != 1 && n_in != klass->channels))
+    goto wrong_ports;
+
+  plugin->n_audio = n_in;
+  plugin->n_handles = n_in == 1 ? klass->channels : 1;
+  plugin->audio_in_portnums = g_new0 (gint, n_in);
+  plugin->audio_out_portnums = g_new0 (gint, n_out);
+  plugin->controls = g_new0 (gfloat, desc->PortCount);
+  plugin->inplace_broken = LADSPA_IS_INPLACE_BROKEN (desc->Properties);
+
+  n_in = n_out = 0;
+  for (j = 0; j < desc->PortCount; j++) {
+    LADSPA_PortDescriptor p = desc->PortDescriptors[j];
+
+    if (LADSPA_IS_PORT_AUDIO (p)) {
+      if (LADSPA_IS_PORT_INPUT (p))
+        plugin->audio_in_portnums[n_in++] = j;
+      else
+        plugin->audio_out_portnums[n_out++] = j;
+    } else if (LADSPA_IS_PORT_CONTROL (p) && LADSPA_IS_PORT_INPUT (p)) {
+      gfloat lower, upper;
+
+      gst_ladspa_port_get_range (desc, j, rate, &lower, &upper,
+          &plugin->controls[j]);
+    }
+  }
+
+  for (i = 1; tokens[i]; i++) {
+    if (!gst_ladspa_rack_plugin_set_control (rack, plugin, tokens[i]))
+      goto wrong_control;
+  }
+
+  plugin->handles = g_new0 (LADSPA_Handle, plugin->n_handles);
+  for (i = 0; i < plugin->n_handles; i++) {
+    if (!(plugin->handles[i] = desc->instantiate (desc, rate)))
+      goto no_instance;
+
+    /* all the instances share the controls */
+    for (j = 0; j < desc->PortCount; j++) {
+      if (LADSPA_IS_PORT_CONTROL (desc->PortDescriptors[j]))
+        desc->connect_port (plugin->handles[i], j, &plugin->controls[j]);
+    }
+  }
+
+  return TRUE;
+
+  /* ERRORS */
+no_plugin:
+  {
+    GST_ELEMENT_ERROR (rack, LIBRARY, SETTINGS, (NULL),
+        ("no LADSPA plugin with label '%s'", tokens[0]));
+    return FALSE;
+  }
+wrong_ports:
+  {
+    GST_ELEMENT_ERROR (rack, LIBRARY, SETTINGS, (NULL),
+        ("plugin '%s' has %u audio inputs and %u outputs, can't run it on "
+            "%u channels", tokens[0], n_in, n_out, klass->channels));
+    return FALSE;
+  }
+wrong_control:
+  {
+    GST_ELEMENT_ERROR (rack, LIBRARY, SETTINGS, (NULL),
+        ("invalid control '%s' for plugin '%s'", tokens[i], tokens[0]));
+    return FALSE;
+  }
+no_instance:
+  {
+    GST_ELEMENT_ERROR (rack, LIBRARY, INIT, (NULL),
+        ("could not create an instance of plugin '%s'", tokens[0]));
+    return FALSE;
+  }
+}
+
+static gboolean
+gst_ladspa_rack_setup (GstSignalProcessor * gsp, GstCaps * caps)
+{
+  GstLADSPARack *rack = (GstLADSPARack *) gsp;
+  gchar **descs;
+  guint i;
+  gboolean ret = TRUE;
+
+  g_return_val_if_fail (rack->plugins == NULL, FALSE);
+
+  if (!rack->description)
+    return TRUE;
+
+  GST_DEBUG_OBJECT (rack, "instantiating \"%s\" at %d Hz", rack->description,
+      gsp->sample_rate);
+
+  descs = g_strsplit (rack->description, "!", -1);
+  rack->plugins = g_new0 (GstLADSPARackPlugin, g_strv_length (descs));
+
+  for (i = 0; ret && descs[i]; i++) {
+    gchar **tokens, **t, **n;
+
+    /* split on white space, dropping the empty tokens */
+    tokens = g_strsplit_set (g_strstrip (descs[i]), " \t\n", -1);
+    for (t = n = tokens; *t; t++) {
+      if (**t)
+        *n++ = *t;
+      else
+        g_free (*t);
+    }
+    *n = NULL;
+
+    if (tokens[0]) {
+      ret = gst_ladspa_rack_plugin_init (rack, &rack->plugins[rack->n_plugins],
+          tokens, gsp->sample_rate);
+      /* the failed plugin is cleaned up with the others */
+      rack->n_plugins++;
+    }
+    g_strfreev (tokens);
+  }
+  g_strfreev (descs);
+
+  if (!ret)
+    gst_ladspa_rack_free_plugins (rack);
+
+  return ret;
+}
+
+static gboolean
+gst_ladspa_rack_start (GstSignalProcessor * gsp)
+{
+  GstLADSPARack *rack = (GstLADSPARack *) gsp;
+  guint i, h;
+
+  g_return_val_if_fail (rack->activated == FALSE, FALSE);
+
+  GST_DEBUG_OBJECT (rack, "activating");
+
+  for (i = 0; i < rack->n_plugins; i++) {
+    GstLADSPARackPlugin *plugin = &rack->plugins[i];
+
+    if (plugin->descriptor->activate) {
+      for (h = 0; h < plugin->n_handles; h++)
+        plugin->descriptor->activate (plugin->handles[h]);
+    }
+  }
+
+  rack->activated = TRUE;
+
+  return TRUE;
+}
+
+static void
+gst_ladspa_rack_stop (GstSignalProcessor * gsp)
+{
+  GstLADSPARack *rack = (GstLADSPARack *) gsp;
+  guint i, h;
+
+  g_return_if_fail (rack->activated == TRUE);
+
+  GST_DEBUG_OBJECT (rack, "deactivating");
+
+  for (i = 0; i < rack->n_plugins; i++) {
+    GstLADSPARackPlugin *plugin = &rack->plugins[i];
+
+    if (plugin->descriptor->deactivate) {
+      for (h = 0; h < plugin->n_handles; h++)
+        plugin->descriptor->deactivate (plugin->handles[h]);
+    }
+  }
+
+  rack->activated = FALSE;
+}
+
+static void
+gst_ladspa_rack_cleanup (GstSignalProcessor * gsp)
+{
+  GstLADSPARack *rack = (GstLADSPARack *) gsp;
+
+  g_return_if_fail (rack->activated == FALSE);
+
+  GST_DEBUG_OBJECT (rack, "cleaning up");
+
+  gst_ladspa_rack_free_plugins (rack);
+
+  g_free (rack->scratch[0]);
+  g_free (rack->scratch[1]);
+  rack->scratch[0] = rack->scratch[1] = NULL;
+  rack->scratch_frames = 0;
+}
+
+/* runs all the instances of @plugin from @in to @out, both de-interleaved
+ * with a stride of @nframes */
+static void
+gst_ladspa_rack_plugin_run (GstLADSPARackPlugin * plugin, gfloat * in,
+    gfloat * out, guint nframes)
+{
+  const LADSPA_Descriptor *desc = plugin->descriptor;
+  guint h, a;
+
+  for (h = 0; h < plugin->n_handles; h++) {
+    for (a = 0; a < plugin->n_audio; a++) {
+      guint channel = h * plugin->n_audio + a;
+
+      desc->connect_port (plugin->handles[h], plugin->audio_in_portnums[a],
+          in + channel * nframes);
+      desc->connect_port (plugin->handles[h], plugin->audio_out_portnums[a],
+          out + channel * nframes);
+    }
+    desc->run (plugin->handles[h], nframes);
+  }
+}
+
+static void
+gst_ladspa_rack_process (GstSignalProcessor * gsp, guint nframes)
+{
+  GstLADSPARack *rack = (GstLADSPARack *) gsp;
+  GstLADSPARackClass *klass = (GstLADSPARackClass *) G_OBJECT_GET_CLASS (rack);
+  gfloat *in, *out, *src, *dst;
+  guint i;
+
+  if (klass->channels == 1) {
+    in = gsp->audio_in[0];
+    out = gsp->audio_out[0];
+  } else {
+    in = gsp->group_in[0].buffer;
+    out = gsp->group_out[0].buffer;
+  }
+
+  if (rack->n_plugins == 0) {
+    if (out != in)
+      memcpy (out, in, nframes * klass->channels * sizeof (gfloat));
+    return;
+  }
+
+  /* the scratch buffers are kept across process cycles */
+  if (rack->scratch_frames < nframes) {
+    for (i = 0; i < 2; i++) {
+      g_free (rack->scratch[i]);
+      rack->scratch[i] = g_new (gfloat, nframes * klass->channels);
+    }
+    rack->scratch_frames = nframes;
+  }
+
+  /* every plugin writes to the buffer its successor reads, the plugins in
+   * the middle of the chain alternate between the two scratch buffers */
+  src = in;
+  for (i = 0; i < rack->n_plugins; i++) {
+    GstLADSPARackPlugin *plugin = &rack->plugins[i];
+
+    dst = (i == rack->n_plugins - 1) ? out : rack->scratch[i & 1];
+
+    if (dst == src && plugin->inplace_broken) {
+      gst_ladspa_rack_plugin_run (plugin, src, rack->scratch[0], nframes);
+      memcpy (dst, rack->scratch[0], nframes * klass->channels *
+          sizeof (gfloat));
+    } else {
+      gst_ladspa_rack_plugin_run (plugin, src, dst, nframes);
+    }
+
+    src = dst;
+  }
+}
+
+static GType
+gst_ladspa_rack_register_type (const gchar * type_name, guint channels)
+{
+  GTypeInfo typeinfo = {
+    sizeof (GstLADSPARackClass),
+    (GBaseInitFunc) gst_ladspa_rack_base_init,
+    NULL,
+    (GClassInitFunc) gst_ladspa_rack_class_init,
+    NULL,
+    NULL,
+    sizeof (GstLADSPARack),
+    0,
+    (GInstanceInitFunc) gst_ladspa_rack_init,
+  };
+  GType type;
+
+  type = g_type_register_static (GST_TYPE_SIGNAL_PROCESSOR, type_name,
+      &typeinfo, 0);
+  /* base_init needs it to add the pad templates */
+  g_type_set_qdata (type, channels_quark, GUINT_TO_POINTER (channels));
+
+  return type;
+}
+
+gboolean
+gst_ladspa_rack_register (GstPlugin * plugin)
+{
+  GST_DEBUG_CATEGORY_INIT (ladspa_rack_debug, "ladsparack", 0, "LADSPA rack");
+
+  channels_quark = g_quark_from_static_string ("ladspa-rack-channels");
+
+  if (!gst_element_register (plugin, "ladsparack", GST_RANK_NONE,
+          gst_ladspa_rack_register_type ("GstLADSPARack", 1)))
+    return FALSE;
+
+  return gst_element_register (plugin, "ladsparack-stereo", GST_RANK_NONE,
+      gst_ladspa_rack_register_type ("GstLADSPARackStereo", 2));
+}
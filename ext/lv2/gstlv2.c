@@ -43,6 +43,7 @@
 #include <gst/audio/multichannel.h>
 
 #include "gstlv2.h"
+#include "gstlv2rack.h"
 #include <slv2/slv2.h>
 
 #define GST_LV2_DEFAULT_PATH \
@@ -378,13 +379,31 @@ gst_lv2_base_init (gpointer g_class)
   klass->plugin = lv2plugin;
 }
 
-static gchar *
-gst_lv2_class_get_param_name (GstLV2Class * klass, SLV2Port port)
+/*
+ * gst_lv2_port_get_property_name:
+ * @lv2plugin: a plugin
+ * @port: one of its ports
+ *
+ * Returns: the name of the element property for @port, derived from the port
+ * symbol. Free with g_free().
+ */
+gchar *
+gst_lv2_port_get_property_name (SLV2Plugin lv2plugin, SLV2Port port)
 {
-  SLV2Plugin lv2plugin = klass->plugin;
+  gchar *name;
 
-  return g_strdup (slv2_value_as_string (slv2_port_get_symbol (lv2plugin,
+  name = g_strdup (slv2_value_as_string (slv2_port_get_symbol (lv2plugin,
               port)));
+  g_strcanon (name, G_CSET_A_2_Z G_CSET_a_2_z G_CSET_DIGITS "-", '-');
+  if (!((name[0] >= 'a' && name[0] <= 'z') || (name[0] >= 'A'
+              && name[0] <= 'Z'))) {
+    gchar *tempstr = name;
+
+    name = g_strconcat ("param-", name, NULL);
+    g_free (tempstr);
+  }
+
+  return name;
 }
 
 static gchar *
@@ -395,27 +414,98 @@ gst_lv2_class_get_param_nick (GstLV2Class * klass, SLV2Port port)
   return g_strdup (slv2_value_as_string (slv2_port_get_name (lv2plugin, port)));
 }
 
+/*
+ * gst_lv2_port_get_range:
+ * @lv2plugin: a plugin
+ * @port: one of its control ports
+ * @lower: the lower bound
+ * @upper: the upper bound
+ * @def: the default value
+ *
+ * Gets the bounds and the default value of a control port, widened to
+ * include the default when the plugin gets them wrong.
+ */
+void
+gst_lv2_port_get_range (SLV2Plugin lv2plugin, SLV2Port port, gfloat * lower,
+    gfloat * upper, gfloat * def)
+{
+  SLV2Value lv2def, lv2min, lv2max;
+
+  *lower = 0.0f;
+  *upper = 1.0f;
+  *def = 0.0f;
+
+  slv2_port_get_range (lv2plugin, port, &lv2def, &lv2min, &lv2max);
+
+  if (lv2def)
+    *def = slv2_value_as_float (lv2def);
+  if (lv2min)
+    *lower = slv2_value_as_float (lv2min);
+  if (lv2max)
+    *upper = slv2_value_as_float (lv2max);
+
+  slv2_value_free (lv2def);
+  slv2_value_free (lv2min);
+  slv2_value_free (lv2max);
+
+  if (*def < *lower) {
+    GST_WARNING ("%s has lower bound %f > default %f",
+        slv2_value_as_string (slv2_plugin_get_uri (lv2plugin)), *lower, *def);
+    *lower = *def;
+  }
+
+  if (*def > *upper) {
+    GST_WARNING ("%s has upper bound %f < default %f",
+        slv2_value_as_string (slv2_plugin_get_uri (lv2plugin)), *upper, *def);
+    *upper = *def;
+  }
+}
+
+/*
+ * gst_lv2_port_get_kind:
+ * @lv2plugin: a plugin
+ * @port: one of its ports
+ *
+ * Returns: whether @port is an audio or a control port, and its direction.
+ */
+GstLV2PortKind
+gst_lv2_port_get_kind (SLV2Plugin lv2plugin, SLV2Port port)
+{
+  gboolean is_input = slv2_port_is_a (lv2plugin, port, input_class);
+
+  if (slv2_port_is_a (lv2plugin, port, audio_class))
+    return is_input ? GST_LV2_PORT_AUDIO_IN : GST_LV2_PORT_AUDIO_OUT;
+  if (slv2_port_is_a (lv2plugin, port, control_class))
+    return is_input ? GST_LV2_PORT_CONTROL_IN : GST_LV2_PORT_CONTROL_OUT;
+
+  return GST_LV2_PORT_OTHER;
+}
+
+/*
+ * gst_lv2_plugin_is_inplace_broken:
+ * @lv2plugin: a plugin
+ *
+ * Returns: TRUE if the audio inputs and outputs of @lv2plugin can't share a
+ * buffer.
+ */
+gboolean
+gst_lv2_plugin_is_inplace_broken (SLV2Plugin lv2plugin)
+{
+  return slv2_plugin_has_feature (lv2plugin, in_place_broken_pred);
+}
+
 static GParamSpec *
 gst_lv2_class_get_param_spec (GstLV2Class * klass, gint portnum)
 {
   SLV2Plugin lv2plugin = klass->plugin;
   SLV2Port port = slv2_plugin_get_port_by_index (lv2plugin, portnum);
-  SLV2Value lv2def, lv2min, lv2max;
   GParamSpec *ret;
   gchar *name, *nick;
   gint perms;
-  gfloat lower = 0.0f, upper = 1.0f, def = 0.0f;
+  gfloat lower, upper, def;
 
   nick = gst_lv2_class_get_param_nick (klass, port);
-  name = gst_lv2_class_get_param_name (klass, port);
-  g_strcanon (name, G_CSET_A_2_Z G_CSET_a_2_z G_CSET_DIGITS "-", '-');
-  if (!((name[0] >= 'a' && name[0] <= 'z') || (name[0] >= 'A'
-              && name[0] <= 'Z'))) {
-    gchar *tempstr = name;
-
-    name = g_strconcat ("param-", name, NULL);
-    g_free (tempstr);
-  }
+  name = gst_lv2_port_get_property_name (lv2plugin, port);
 
   GST_DEBUG ("%s trying port %s : %s",
       slv2_value_as_string (slv2_plugin_get_uri (lv2plugin)), name, nick);
@@ -431,30 +521,7 @@ gst_lv2_class_get_param_spec (GstLV2Class * klass, gint portnum)
     goto done;
   }
 
-  slv2_port_get_range (lv2plugin, port, &lv2def, &lv2min, &lv2max);
-
-  if (lv2def)
-    def = slv2_value_as_float (lv2def);
-  if (lv2min)
-    lower = slv2_value_as_float (lv2min);
-  if (lv2max)
-    upper = slv2_value_as_float (lv2max);
-
-  slv2_value_free (lv2def);
-  slv2_value_free (lv2min);
-  slv2_value_free (lv2max);
-
-  if (def < lower) {
-    GST_WARNING ("%s has lower bound %f > default %f",
-        slv2_value_as_string (slv2_plugin_get_uri (lv2plugin)), lower, def);
-    lower = def;
-  }
-
-  if (def > upper) {
-    GST_WARNING ("%s has upper bound %f < default %f",
-        slv2_value_as_string (slv2_plugin_get_uri (lv2plugin)), upper, def);
-    upper = def;
-  }
+  gst_lv2_port_get_range (lv2plugin, port, &lower, &upper, &def);
 
   if (slv2_port_has_property (lv2plugin, port, integer_prop))
     ret = g_param_spec_int (name, nick, nick, lower, upper, def, perms);
@@ -770,6 +837,25 @@ gst_lv2_process (GstSignalProcessor * gsp, guint nframes)
   slv2_instance_run (lv2->instance, nframes);
 }
 
+/*
+ * gst_lv2_find_plugin:
+ * @uri: the URI of a plugin
+ *
+ * Returns: the installed plugin with @uri, or NULL.
+ */
+SLV2Plugin
+gst_lv2_find_plugin (const gchar * uri)
+{
+  SLV2Value val;
+  SLV2Plugin lv2plugin;
+
+  val = slv2_value_new_uri (world, uri);
+  lv2plugin = slv2_plugins_get_by_uri (slv2_world_get_all_plugins (world), val);
+  slv2_value_free (val);
+
+  return lv2plugin;
+}
+
 /* search the plugin path
  */
 static gboolean
@@ -895,6 +981,8 @@ plugin_init (GstPlugin * plugin)
     GST_WARNING ("no lv2 plugins found, check LV2_PATH");
   }
 
+  gst_lv2_rack_register (plugin);
+
   /* we don't want to fail, even if there are no elements registered */
   return TRUE;
 }
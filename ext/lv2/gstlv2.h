@@ -88,6 +88,22 @@ struct _GstLV2Class {
 
 };
 
+typedef enum {
+  GST_LV2_PORT_AUDIO_IN,
+  GST_LV2_PORT_AUDIO_OUT,
+  GST_LV2_PORT_CONTROL_IN,
+  GST_LV2_PORT_CONTROL_OUT,
+  GST_LV2_PORT_OTHER
+} GstLV2PortKind;
+
+
+SLV2Plugin gst_lv2_find_plugin (const gchar * uri);
+gboolean gst_lv2_plugin_is_inplace_broken (SLV2Plugin lv2plugin);
+GstLV2PortKind gst_lv2_port_get_kind (SLV2Plugin lv2plugin, SLV2Port port);
+gchar *gst_lv2_port_get_property_name (SLV2Plugin lv2plugin, SLV2Port port);
+void gst_lv2_port_get_range (SLV2Plugin lv2plugin, SLV2Port port,
+    gfloat * lower, gfloat * upper, gfloat * def);
+
 
 G_END_DECLS
 
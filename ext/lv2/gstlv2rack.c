@@ -0,0 +1,610 @@
+/* GStreamer
+ *
+ * gstlv2rack.c: runs a chain of LV2 plugins in one element
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+/**
+ * SECTION:element-lv2rack
+ *
+ * The lv2rack and lv2rack-stereo elements run an ordered chain of LV2
+ * plugins on a mono or a stereo stream, like ladsparack does for LADSPA
+ * plugins. The plugins are connected to each other on shared float buffers,
+ * so the whole chain runs in a single process call.
+ *
+ * The chain is described like a gst-launch line, the plugins are given by
+ * their URI, followed by the values of their control ports. The ports are
+ * named like the properties of the lv2 elements:
+ * |[
+ * gst-launch audiotestsrc ! audioconvert ! lv2rack-stereo
+ *     plugins="http://plugin.org.uk/swh-plugins/amp gain=-6
+ *         ! http://plugin.org.uk/swh-plugins/djFlanger"
+ *     ! audioconvert ! autoaudiosink
+ * ]|
+ * Mono plugins are instantiated once for each channel, plugins with as many
+ * audio inputs and outputs as the stream has channels once, their audio
+ * ports are used in index order. Plugins with ports that are neither audio
+ * nor control ports can't be used.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <string.h>
+
+#include "gstlv2.h"
+#include "gstlv2rack.h"
+
+GST_DEBUG_CATEGORY_STATIC (lv2_rack_debug);
+#define GST_CAT_DEFAULT lv2_rack_debug
+
+enum
+{
+  PROP_0,
+  PROP_PLUGINS
+};
+
+static void gst_lv2_rack_finalize (GObject * object);
+static void gst_lv2_rack_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_lv2_rack_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static gboolean gst_lv2_rack_setup (GstSignalProcessor * gsp, GstCaps * caps);
+static gboolean gst_lv2_rack_start (GstSignalProcessor * gsp);
+static void gst_lv2_rack_stop (GstSignalProcessor * gsp);
+static void gst_lv2_rack_cleanup (GstSignalProcessor * gsp);
+static void gst_lv2_rack_process (GstSignalProcessor * gsp, guint nframes);
+
+static GstSignalProcessorClass *parent_class;
+
+static GQuark channels_quark = 0;
+
+static void
+gst_lv2_rack_base_init (gpointer g_class)
+{
+  GstLV2RackClass *klass = (GstLV2RackClass *) g_class;
+  GstElementClass *element_class = GST_ELEMENT_CLASS (g_class);
+  GstSignalProcessorClass *gsp_class = GST_SIGNAL_PROCESSOR_CLASS (g_class);
+
+  klass->channels =
+      GPOINTER_TO_UINT (g_type_get_qdata (G_OBJECT_CLASS_TYPE (klass),
+          channels_quark));
+  g_assert (klass->channels > 0);
+
+  /* a single mono pad or a single multi-channel group in each direction */
+  gsp_class->num_audio_in = 0;
+  gsp_class->num_audio_out = 0;
+  gsp_class->num_group_in = 0;
+  gsp_class->num_group_out = 0;
+  if (klass->channels == 1) {
+    gst_signal_processor_class_add_pad_template (gsp_class, "sink",
+        GST_PAD_SINK, gsp_class->num_audio_in++, 1);
+    gst_signal_processor_class_add_pad_template (gsp_class, "src",
+        GST_PAD_SRC, gsp_class->num_audio_out++, 1);
+  } else {
+    gst_signal_processor_class_add_pad_template (gsp_class, "sink",
+        GST_PAD_SINK, gsp_class->num_group_in++, klass->channels);
+    gst_signal_processor_class_add_pad_template (gsp_class, "src",
+        GST_PAD_SRC, gsp_class->num_group_out++, klass->channels);
+  }
+
+  /* the chain reads its input before writing its output */
+  GST_SIGNAL_PROCESSOR_CLASS_SET_CAN_PROCESS_IN_PLACE (klass);
+
+  gst_element_class_set_details_simple (element_class, "LV2 rack",
+      "Filter/Effect/Audio/LV2", "Runs a chain of LV2 plugins",
+      "GStreamer maintainers <gstreamer-devel@lists.sourceforge.net>");
+}
+
+static void
+gst_lv2_rack_class_init (GstLV2RackClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstSignalProcessorClass *gsp_class;
+
+  parent_class = g_type_class_peek_parent (klass);
+
+  gobject_class = (GObjectClass *) klass;
+  gobject_class->finalize = gst_lv2_rack_finalize;
+  gobject_class->set_property = gst_lv2_rack_set_property;
+  gobject_class->get_property = gst_lv2_rack_get_property;
+
+  gsp_class = GST_SIGNAL_PROCESSOR_CLASS (klass);
+  gsp_class->setup = gst_lv2_rack_setup;
+  gsp_class->start = gst_lv2_rack_start;
+  gsp_class->stop = gst_lv2_rack_stop;
+  gsp_class->cleanup = gst_lv2_rack_cleanup;
+  gsp_class->process = gst_lv2_rack_process;
+
+  g_object_class_install_property (gobject_class, PROP_PLUGINS,
+      g_param_spec_string ("plugins", "Plugins",
+          "The chain of plugins, as \"uri port=value ... ! uri ...\", "
+          "can only be changed while the element is not running", NULL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void
+gst_lv2_rack_init (GstLV2Rack * rack, GstLV2RackClass * klass)
+{
+  rack->description = NULL;
+  rack->plugins = NULL;
+  rack->n_plugins = 0;
+  rack->activated = FALSE;
+}
+
+static void
+gst_lv2_rack_finalize (GObject * object)
+{
+  GstLV2Rack *rack = (GstLV2Rack *) object;
+
+  g_free (rack->description);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_lv2_rack_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstLV2Rack *rack = (GstLV2Rack *) object;
+
+  switch (prop_id) {
+    case PROP_PLUGINS:
+      /* the plugins are instantiated when the caps are set */
+      if (GST_SIGNAL_PROCESSOR_IS_INITIALIZED (rack)) {
+        GST_WARNING_OBJECT (rack, "can't change the plugins while running");
+        break;
+      }
+      g_free (rack->description);
+      rack->description = g_value_dup_string (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_lv2_rack_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstLV2Rack *rack = (GstLV2Rack *) object;
+
+  switch (prop_id) {
+    case PROP_PLUGINS:
+      g_value_set_string (value, rack->description);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static gboolean
+gst_lv2_rack_plugin_set_control (GstLV2Rack * rack, GstLV2RackPlugin * plugin,
+    const gchar * assignment)
+{
+  SLV2Plugin lv2plugin = plugin->plugin;
+  gchar **kv;
+  gchar *end;
+  gfloat value;
+  guint j;
+  gboolean ret = FALSE;
+
+  kv = g_strsplit (assignment, "=", 2);
+  if (!kv[0] || !kv[1])
+    goto done;
+
+  if (!g_ascii_strcasecmp (kv[1], "true"))
+    value = 1.0;
+  else if (!g_ascii_strcasecmp (kv[1], "false"))
+    value = 0.0;
+  else {
+    value = g_ascii_strtod (kv[1], &end);
+    if (end == kv[1] || *end != '\0')
+      goto done;
+  }
+
+  for (j = 0; j < slv2_plugin_get_num_ports (lv2plugin); j++) {
+    SLV2Port port = slv2_plugin_get_port_by_index (lv2plugin, j);
+    gchar *name;
+
+    if (gst_lv2_port_get_kind (lv2plugin, port) != GST_LV2_PORT_CONTROL_IN)
+      continue;
+
+    name = gst_lv2_port_get_property_name (lv2plugin, port);
+    ret = g_ascii_strcasecmp (name, kv[0]) == 0;
+    g_free (name);
+
+    if (ret) {
+      GST_DEBUG_OBJECT (rack, "%s: %s = %f",
+          slv2_value_as_uri (slv2_plugin_get_uri (lv2plugin)), kv[0], value);
+      plugin->controls[j] = value;
+      break;
+    }
+  }
+
+done:
+  g_strfreev (kv);
+  return ret;
+}
+
+static void
+gst_lv2_rack_plugin_free (GstLV2RackPlugin * plugin)
+{
+  guint i;
+
+  for (i = 0; plugin->instances && i < plugin->n_instances; i++) {
+    if (plugin->instances[i])
+      slv2_instance_free (plugin->instances[i]);
+  }
+  g_free (plugin->instances);
+  g_free (plugin->audio_in_portnums);
+  g_free (plugin->audio_out_portnums);
+  g_free (plugin->controls);
+}
+
+static void
+gst_lv2_rack_free_plugins (GstLV2Rack * rack)
+{
+  guint i;
+
+  for (i = 0; i < rack->n_plugins; i++)
+    gst_lv2_rack_plugin_free (&rack->plugins[i]);
+  g_free (rack->plugins);
+  rack->plugins = NULL;
+  rack->n_plugins = 0;
+}
+
+/* creates the instances of the plugin described by @tokens, the URI
+ * followed by the control port assignments */
+static gboolean
+gst_lv2_rack_plugin_init (GstLV2Rack * rack, GstLV2RackPlugin * plugin,
+    gchar ** tokens, gint rate)
+{
+  GstLV2RackClass *klass = (GstLV2RackClass *) G_OBJECT_GET_CLASS (rack);
+  SLV2Plugin lv2plugin;
+  guint n_ports, n_in = 0, n_out = 0, i, j;
+
+  lv2plugin = gst_lv2_find_plugin (tokens[0]);
+  if (!lv2plugin)
+    goto no_plugin;
+  plugin->plugin = lv2plugin;
+
+  /* every port has to be connected before the plugin runs */
+  n_ports = slv2_plugin_get_num_ports (lv2plugin);
+  for (j = 0; j < n_ports; j++) {
+    switch (gst_lv2_port_get_kind (lv2plugin,
+            slv2_plugin_get_port_by_index (lv2plugin, j))) {
+      case GST_LV2_PORT_AUDIO_IN:
+        n_in++;
+        break;
+      case GST_LV2_PORT_AUDIO_OUT:
+        n_out++;
+        break;
+      case GST_LV2_PORT_OTHER:
+        goto wrong_port;
+      default:
+        break;
+    }
+  }
+  if (n_in != n_out || (n_in != 1 && n_in != klass->channels))
+    goto wrong_ports;
+
+  plugin->n_audio = n_in;
+  plugin->n_instances = n_in == 1 ? klass->channels : 1;
+  plugin->audio_in_portnums = g_new0 (gint, n_in);
+  plugin->audio_out_portnums = g_new0 (gint, n_out);
+  plugin->controls = g_new0 (gfloat, n_ports);
+  plugin->inplace_broken = gst_lv2_plugin_is_inplace_broken (lv2plugin);
+
+  n_in = n_out = 0;
+  for (j = 0; j < n_ports; j++) {
+    SLV2Port port = slv2_plugin_get_port_by_index (lv2plugin, j);
+    gfloat lower, upper;
+
+    switch (gst_lv2_port_get_kind (lv2plugin, port)) {
+      case GST_LV2_PORT_AUDIO_IN:
+        plugin->audio_in_portnums[n_in++] = j;
+        break;
+      case GST_LV2_PORT_AUDIO_OUT:
+        plugin->audio_out_portnums[n_out++] = j;
+        break;
+      case GST_LV2_PORT_CONTROL_IN:
+        gst_lv2_port_get_range (lv2plugin, port, &lower, &upper,
+            &plugin->controls[j]);
+        break;
+      default:
+        break;
+    }
+  }
+
+  for (i = 1; tokens[i]; i++) {
+    if (!gst_lv2_rack_plugin_set_control (rack, plugin, tokens[i]))
+      goto wrong_control;
+  }
+
+  plugin->instances = g_new0 (SLV2Instance, plugin->n_instances);
+  for (i = 0; i < plugin->n_instances; i++) {
+    if (!(plugin->instances[i] =
+            slv2_plugin_instantiate (lv2plugin, rate, NULL)))
+      goto no_instance;
+
+    /* all the instances share the controls */
+    for (j = 0; j < n_ports; j++) {
+      GstLV2PortKind kind = gst_lv2_port_get_kind (lv2plugin,
+          slv2_plugin_get_port_by_index (lv2plugin, j));
+
+      if (kind == GST_LV2_PORT_CONTROL_IN || kind == GST_LV2_PORT_CONTROL_OUT)
+        slv2_instance_connect_port (plugin->instances[i], j,
+            &plugin->controls[j]);
+    }
+  }
+
+  return TRUE;
+
+  /* ERRORS */
+no_plugin:
+  {
+    GST_ELEMENT_ERROR (rack, LIBRARY, SETTINGS, (NULL),
+        ("no LV2 plugin with URI '%s'", tokens[0]));
+    return FALSE;
+  }
+wrong_port:
+  {
+    GST_ELEMENT_ERROR (rack, LIBRARY, SETTINGS, (NULL),
+        ("plugin '%s' has port %u that is neither an audio nor a control "
+            "port", tokens[0], j));
+    return FALSE;
+  }
+wrong_ports:
+  {
+    GST_ELEMENT_ERROR (rack, LIBRARY, SETTINGS, (NULL),
+        ("plugin '%s' has %u audio inputs and %u outputs, can't run it on "
+            "%u channels", tokens[0], n_in, n_out, klass->channels));
+    return FALSE;
+  }
+wrong_control:
+  {
+    GST_ELEMENT_ERROR (rack, LIBRARY, SETTINGS, (NULL),
+        ("invalid control '%s' for plugin '%s'", tokens[i], tokens[0]));
+    return FALSE;
+  }
+no_instance:
+  {
+    GST_ELEMENT_ERROR (rack, LIBRARY, INIT, (NULL),
+        ("could not create an instance of plugin '%s'", tokens[0]));
+    return FALSE;
+  }
+}
+
+static gboolean
+gst_lv2_rack_setup (GstSignalProcessor * gsp, GstCaps * caps)
+{
+  GstLV2Rack *rack = (GstLV2Rack *) gsp;
+  gchar **descs;
+  guint i;
+  gboolean ret = TRUE;
+
+  g_return_val_if_fail (rack->plugins == NULL, FALSE);
+
+  if (!rack->description)
+    return TRUE;
+
+  GST_DEBUG_OBJECT (rack, "instantiating \"%s\" at %d Hz", rack->description,
+      gsp->sample_rate);
+
+  descs = g_strsplit (rack->description, "!", -1);
+  rack->plugins = g_new0 (GstLV2RackPlugin, g_strv_length (descs));
+
+  for (i = 0; ret && descs[i]; i++) {
+    gchar **tokens, **t, **n;
+
+    /* split on white space, dropping the empty tokens */
+    tokens = g_strsplit_set (g_strstrip (descs[i]), " \t\n", -1);
+    for (t = n = tokens; *t; t++) {
+      if (**t)
+        *n++ = *t;
+      else
+        g_free (*t);
+    }
+    *n = NULL;
+
+    if (tokens[0]) {
+      ret = gst_lv2_rack_plugin_init (rack, &rack->plugins[rack->n_plugins],
+          tokens, gsp->sample_rate);
+      /* the failed plugin is cleaned up with the others */
+      rack->n_plugins++;
+    }
+    g_strfreev (tokens);
+  }
+  g_strfreev (descs);
+
+  if (!ret)
+    gst_lv2_rack_free_plugins (rack);
+
+  return ret;
+}
+
+static gboolean
+gst_lv2_rack_start (GstSignalProcessor * gsp)
+{
+  GstLV2Rack *rack = (GstLV2Rack *) gsp;
+  guint i, h;
+
+  g_return_val_if_fail (rack->activated == FALSE, FALSE);
+
+  GST_DEBUG_OBJECT (rack, "activating");
+
+  for (i = 0; i < rack->n_plugins; i++) {
+    GstLV2RackPlugin *plugin = &rack->plugins[i];
+
+    for (h = 0; h < plugin->n_instances; h++)
+      slv2_instance_activate (plugin->instances[h]);
+  }
+
+  rack->activated = TRUE;
+
+  return TRUE;
+}
+
+static void
+gst_lv2_rack_stop (GstSignalProcessor * gsp)
+{
+  GstLV2Rack *rack = (GstLV2Rack *) gsp;
+  guint i, h;
+
+  g_return_if_fail (rack->activated == TRUE);
+
+  GST_DEBUG_OBJECT (rack, "deactivating");
+
+  for (i = 0; i < rack->n_plugins; i++) {
+    GstLV2RackPlugin *plugin = &rack->plugins[i];
+
+    for (h = 0; h < plugin->n_instances; h++)
+      slv2_instance_deactivate (plugin->instances[h]);
+  }
+
+  rack->activated = FALSE;
+}
+
+static void
+gst_lv2_rack_cleanup (GstSignalProcessor * gsp)
+{
+  GstLV2Rack *rack = (GstLV2Rack *) gsp;
+
+  g_return_if_fail (rack->activated == FALSE);
+
+  GST_DEBUG_OBJECT (rack, "cleaning up");
+
+  gst_lv2_rack_free_plugins (rack);
+
+  g_free (rack->scratch[0]);
+  g_free (rack->scratch[1]);
+  rack->scratch[0] = rack->scratch[1] = NULL;
+  rack->scratch_frames = 0;
+}
+
+/* runs all the instances of @plugin from @in to @out, both de-interleaved
+ * with a stride of @nframes */
+static void
+gst_lv2_rack_plugin_run (GstLV2RackPlugin * plugin, gfloat * in,
+    gfloat * out, guint nframes)
+{
+  guint h, a;
+
+  for (h = 0; h < plugin->n_instances; h++) {
+    for (a = 0; a < plugin->n_audio; a++) {
+      guint channel = h * plugin->n_audio + a;
+
+      slv2_instance_connect_port (plugin->instances[h],
+          plugin->audio_in_portnums[a], in + channel * nframes);
+      slv2_instance_connect_port (plugin->instances[h],
+          plugin->audio_out_portnums[a], out + channel * nframes);
+    }
+    slv2_instance_run (plugin->instances[h], nframes);
+  }
+}
+
+static void
+gst_lv2_rack_process (GstSignalProcessor * gsp, guint nframes)
+{
+  GstLV2Rack *rack = (GstLV2Rack *) gsp;
+  GstLV2RackClass *klass = (GstLV2RackClass *) G_OBJECT_GET_CLASS (rack);
+  gfloat *in, *out, *src, *dst;
+  guint i;
+
+  if (klass->channels == 1) {
+    in = gsp->audio_in[0];
+    out = gsp->audio_out[0];
+  } else {
+    in = gsp->group_in[0].buffer;
+    out = gsp->group_out[0].buffer;
+  }
+
+  if (rack->n_plugins == 0) {
+    if (out != in)
+      memcpy (out, in, nframes * klass->channels * sizeof (gfloat));
+    return;
+  }
+
+  /* the scratch buffers are kept across process cycles */
+  if (rack->scratch_frames < nframes) {
+    for (i = 0; i < 2; i++) {
+      g_free (rack->scratch[i]);
+      rack->scratch[i] = g_new (gfloat, nframes * klass->channels);
+    }
+    rack->scratch_frames = nframes;
+  }
+
+  /* every plugin writes to the buffer its successor reads, the plugins in
+   * the middle of the chain alternate between the two scratch buffers */
+  src = in;
+  for (i = 0; i < rack->n_plugins; i++) {
+    GstLV2RackPlugin *plugin = &rack->plugins[i];
+
+    dst = (i == rack->n_plugins - 1) ? out : rack->scratch[i & 1];
+
+    if (dst == src && plugin->inplace_broken) {
+      gst_lv2_rack_plugin_run (plugin, src, rack->scratch[0], nframes);
+      memcpy (dst, rack->scratch[0], nframes * klass->channels *
+          sizeof (gfloat));
+    } else {
+      gst_lv2_rack_plugin_run (plugin, src, dst, nframes);
+    }
+
+    src = dst;
+  }
+}
+
+static GType
+gst_lv2_rack_register_type (const gchar * type_name, guint channels)
+{
+  GTypeInfo typeinfo = {
+    sizeof (GstLV2RackClass),
+    (GBaseInitFunc) gst_lv2_rack_base_init,
+    NULL,
+    (GClassInitFunc) gst_lv2_rack_class_init,
+    NULL,
+    NULL,
+    sizeof (GstLV2Rack),
+    0,
+    (GInstanceInitFunc) gst_lv2_rack_init,
+  };
+  GType type;
+
+  type = g_type_register_static (GST_TYPE_SIGNAL_PROCESSOR, type_name,
+      &typeinfo, 0);
+  /* base_init needs it to add the pad templates */
+  g_type_set_qdata (type, channels_quark, GUINT_TO_POINTER (channels));
+
+  return type;
+}
+
+gboolean
+gst_lv2_rack_register (GstPlugin * plugin)
+{
+  GST_DEBUG_CATEGORY_INIT (lv2_rack_debug, "lv2rack", 0, "LV2 rack");
+
+  channels_quark = g_quark_from_static_string ("lv2-rack-channels");
+
+  if (!gst_element_register (plugin, "lv2rack", GST_RANK_NONE,
+          gst_lv2_rack_register_type ("GstLV2Rack", 1)))
+    return FALSE;
+
+  return gst_element_register (plugin, "lv2rack-stereo", GST_RANK_NONE,
+      gst_lv2_rack_register_type ("GstLV2RackStereo", 2));
+}
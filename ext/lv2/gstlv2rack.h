@@ -0,0 +1,87 @@
+/* GStreamer
+ *
+ * gstlv2rack.h: Header for the LV2 rack
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+
+#ifndef __GST_LV2_RACK_H__
+#define __GST_LV2_RACK_H__
+
+
+#include <slv2/slv2.h>
+
+#include <gst/gst.h>
+
+#include <gst/signalprocessor/gstsignalprocessor.h>
+
+
+G_BEGIN_DECLS
+
+
+typedef struct _GstLV2RackPlugin GstLV2RackPlugin;
+typedef struct _GstLV2Rack GstLV2Rack;
+typedef struct _GstLV2RackClass GstLV2RackClass;
+
+
+struct _GstLV2RackPlugin {
+  SLV2Plugin plugin;
+
+  /* one instance per channel for mono plugins, a single one otherwise */
+  SLV2Instance *instances;
+  guint n_instances;
+
+  /* audio ports per instance */
+  gint *audio_in_portnums;
+  gint *audio_out_portnums;
+  guint n_audio;
+
+  /* values of all the control ports, indexed by port number */
+  gfloat *controls;
+
+  gboolean inplace_broken;
+};
+
+struct _GstLV2Rack {
+  GstSignalProcessor parent;
+
+  gchar *description;
+
+  GstLV2RackPlugin *plugins;
+  guint n_plugins;
+
+  /* the intermediate signal between the plugins, de-interleaved */
+  gfloat *scratch[2];
+  guint scratch_frames;
+
+  gboolean activated;
+};
+
+struct _GstLV2RackClass {
+  GstSignalProcessorClass parent_class;
+
+  guint channels;
+};
+
+
+gboolean gst_lv2_rack_register (GstPlugin * plugin);
+
+
+G_END_DECLS
+
+
+#endif /* __GST_LV2_RACK_H__ */
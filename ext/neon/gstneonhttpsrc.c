@@ -34,6 +34,9 @@ GST_DEBUG_CATEGORY_STATIC (neonhttpsrc_debug);
 
 #define MAX_READ_SIZE (4 * 1024)
 
+/* the cache is filled with requests for ranges of this size */
+#define CACHE_BLOCK_SIZE (64 * 1024)
+
 /* max number of HTTP redirects, when iterating over a sequence of HTTP 3xx status code */
 #define MAX_HTTP_REDIRECTS_NUMBER 5
 
@@ -61,6 +64,9 @@ static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
 #define DEFAULT_NEON_HTTP_DEBUG      FALSE
 #define DEFAULT_CONNECT_TIMEOUT      0
 #define DEFAULT_READ_TIMEOUT         0
+#define DEFAULT_CACHE_SIZE           0
+#define DEFAULT_PREFETCH_BLOCKS      4
+#define DEFAULT_MAX_CONNECTIONS      2
 
 enum
 {
@@ -77,11 +83,24 @@ enum
   PROP_ACCEPT_SELF_SIGNED,
   PROP_CONNECT_TIMEOUT,
   PROP_READ_TIMEOUT,
+  PROP_CACHE_SIZE,
+  PROP_PREFETCH_BLOCKS,
+  PROP_MAX_CONNECTIONS,
+  PROP_CACHE_HITS,
+  PROP_CACHE_MISSES,
 #ifndef GST_DISABLE_GST_DEBUG
   PROP_NEON_HTTP_DEBUG
 #endif
 };
 
+/* a range of CACHE_BLOCK_SIZE bytes starting at index * CACHE_BLOCK_SIZE,
+ * the last block of the resource is shorter */
+typedef struct
+{
+  guint index;
+  GstBuffer *buffer;
+} GstNeonhttpBlock;
+
 static void gst_neonhttp_src_uri_handler_init (gpointer g_iface,
     gpointer iface_data);
 static void gst_neonhttp_src_dispose (GObject * gobject);
@@ -98,16 +117,24 @@ static gboolean gst_neonhttp_src_get_size (GstBaseSrc * bsrc, guint64 * size);
 static gboolean gst_neonhttp_src_is_seekable (GstBaseSrc * bsrc);
 static gboolean gst_neonhttp_src_do_seek (GstBaseSrc * bsrc,
     GstSegment * segment);
+static gboolean gst_neonhttp_src_unlock (GstBaseSrc * bsrc);
+static gboolean gst_neonhttp_src_unlock_stop (GstBaseSrc * bsrc);
 
 static gboolean gst_neonhttp_src_set_proxy (GstNeonhttpSrc * src,
     const gchar * uri);
 static gboolean gst_neonhttp_src_set_location (GstNeonhttpSrc * src,
     const gchar * uri);
 static gint gst_neonhttp_src_send_request_and_redirect (GstNeonhttpSrc * src,
-    ne_session ** ses, ne_request ** req, gint64 offset, gboolean do_redir);
+    ne_session ** ses, ne_request ** req, gint64 offset, gint64 length,
+    gboolean do_redir);
 static gint gst_neonhttp_src_request_dispatch (GstNeonhttpSrc * src,
     GstBuffer * outbuf);
 static void gst_neonhttp_src_close_session (GstNeonhttpSrc * src);
+static gboolean gst_neonhttp_src_start_cache (GstNeonhttpSrc * src);
+static void gst_neonhttp_src_stop_cache (GstNeonhttpSrc * src);
+static GstFlowReturn gst_neonhttp_src_create_cached (GstNeonhttpSrc * src,
+    guint size, GstBuffer ** outbuf);
+static void gst_neonhttp_src_fetch_block (gpointer data, gpointer user_data);
 static gchar *gst_neonhttp_src_unicodify (const gchar * str);
 static void oom_callback (void);
 
@@ -254,6 +281,75 @@ gst_neonhttp_src_class_init (GstNeonhttpSrcClass * klass)
           3600, DEFAULT_READ_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstNeonhttpSrc:cache-size
+   *
+   * The size of the block cache in bytes. When it is not 0 and the server
+   * supports range requests the resource is read in blocks of 64 kB over
+   * persistent connections, the blocks following the read position are
+   * fetched in the background and seeks back to recently read data are
+   * served from the cache without a new request.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_SIZE,
+      g_param_spec_uint ("cache-size", "Cache size",
+          "Size of the block cache in bytes (0 = read without cache)", 0,
+          G_MAXUINT, DEFAULT_CACHE_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstNeonhttpSrc:prefetch-blocks
+   *
+   * The number of blocks after the read position fetched in the background
+   * when the cache is used.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PREFETCH_BLOCKS,
+      g_param_spec_uint ("prefetch-blocks", "Prefetch blocks",
+          "Number of blocks read ahead when using the cache", 0, 1024,
+          DEFAULT_PREFETCH_BLOCKS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstNeonhttpSrc:max-connections
+   *
+   * The number of connections used at the same time to fill the cache, they
+   * are kept open between the requests.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_CONNECTIONS,
+      g_param_spec_uint ("max-connections", "Max connections",
+          "Maximum number of connections filling the cache", 1, 16,
+          DEFAULT_MAX_CONNECTIONS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstNeonhttpSrc:cache-hits
+   *
+   * The number of buffers served from the cache without waiting.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_HITS,
+      g_param_spec_uint64 ("cache-hits", "Cache hits",
+          "Number of buffers read from the cache", 0, G_MAXUINT64, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstNeonhttpSrc:cache-misses
+   *
+   * The number of buffers that had to wait for their block to be fetched.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_MISSES,
+      g_param_spec_uint64 ("cache-misses", "Cache misses",
+          "Number of buffers that waited for the server", 0, G_MAXUINT64, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
 #ifndef GST_DISABLE_GST_DEBUG
   g_object_class_install_property
       (gobject_class, PROP_NEON_HTTP_DEBUG,
@@ -268,6 +364,9 @@ gst_neonhttp_src_class_init (GstNeonhttpSrcClass * klass)
   gstbasesrc_class->is_seekable =
       GST_DEBUG_FUNCPTR (gst_neonhttp_src_is_seekable);
   gstbasesrc_class->do_seek = GST_DEBUG_FUNCPTR (gst_neonhttp_src_do_seek);
+  gstbasesrc_class->unlock = GST_DEBUG_FUNCPTR (gst_neonhttp_src_unlock);
+  gstbasesrc_class->unlock_stop =
+      GST_DEBUG_FUNCPTR (gst_neonhttp_src_unlock_stop);
 
   gstpushsrc_class->create = GST_DEBUG_FUNCPTR (gst_neonhttp_src_create);
 
@@ -290,6 +389,18 @@ gst_neonhttp_src_init (GstNeonhttpSrc * src, GstNeonhttpSrcClass * g_class)
   src->accept_self_signed = DEFAULT_ACCEPT_SELF_SIGNED;
   src->connect_timeout = DEFAULT_CONNECT_TIMEOUT;
   src->read_timeout = DEFAULT_READ_TIMEOUT;
+  src->cache_size = DEFAULT_CACHE_SIZE;
+  src->prefetch_blocks = DEFAULT_PREFETCH_BLOCKS;
+  src->max_connections = DEFAULT_MAX_CONNECTIONS;
+
+  src->cache_lock = g_mutex_new ();
+  src->cache_cond = g_cond_new ();
+  src->blocks = g_hash_table_new (g_direct_hash, g_direct_equal);
+  src->pending = g_hash_table_new (g_direct_hash, g_direct_equal);
+  src->failed = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+      g_free);
+  src->lru = g_queue_new ();
+  src->idle_sessions = g_queue_new ();
 
   src->cookies = NULL;
   src->session = NULL;
@@ -352,6 +463,18 @@ gst_neonhttp_src_dispose (GObject * gobject)
     ne_free (src->query_string);
   }
 
+  if (src->cache_lock) {
+    gst_neonhttp_src_stop_cache (src);
+    g_hash_table_destroy (src->blocks);
+    g_hash_table_destroy (src->pending);
+    g_hash_table_destroy (src->failed);
+    g_queue_free (src->lru);
+    g_queue_free (src->idle_sessions);
+    g_cond_free (src->cache_cond);
+    g_mutex_free (src->cache_lock);
+    src->cache_lock = NULL;
+  }
+
   G_OBJECT_CLASS (parent_class)->dispose (gobject);
 }
 
@@ -419,6 +542,15 @@ gst_neonhttp_src_set_property (GObject * object, guint prop_id,
     case PROP_READ_TIMEOUT:
       src->read_timeout = g_value_get_uint (value);
       break;
+    case PROP_CACHE_SIZE:
+      src->cache_size = g_value_get_uint (value);
+      break;
+    case PROP_PREFETCH_BLOCKS:
+      src->prefetch_blocks = g_value_get_uint (value);
+      break;
+    case PROP_MAX_CONNECTIONS:
+      src->max_connections = g_value_get_uint (value);
+      break;
 #ifndef GST_DISABLE_GST_DEBUG
     case PROP_NEON_HTTP_DEBUG:
       src->neon_http_debug = g_value_get_boolean (value);
@@ -499,6 +631,25 @@ gst_neonhttp_src_get_property (GObject * object, guint prop_id,
     case PROP_READ_TIMEOUT:
       g_value_set_uint (value, neonhttpsrc->read_timeout);
       break;
+    case PROP_CACHE_SIZE:
+      g_value_set_uint (value, neonhttpsrc->cache_size);
+      break;
+    case PROP_PREFETCH_BLOCKS:
+      g_value_set_uint (value, neonhttpsrc->prefetch_blocks);
+      break;
+    case PROP_MAX_CONNECTIONS:
+      g_value_set_uint (value, neonhttpsrc->max_connections);
+      break;
+    case PROP_CACHE_HITS:
+      g_mutex_lock (neonhttpsrc->cache_lock);
+      g_value_set_uint64 (value, neonhttpsrc->cache_hits);
+      g_mutex_unlock (neonhttpsrc->cache_lock);
+      break;
+    case PROP_CACHE_MISSES:
+      g_mutex_lock (neonhttpsrc->cache_lock);
+      g_value_set_uint64 (value, neonhttpsrc->cache_misses);
+      g_mutex_unlock (neonhttpsrc->cache_lock);
+      break;
 #ifndef GST_DISABLE_GST_DEBUG
     case PROP_NEON_HTTP_DEBUG:
       g_value_set_boolean (value, neonhttpsrc->neon_http_debug);
@@ -532,6 +683,9 @@ gst_neonhttp_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
   if (G_UNLIKELY (src->eos))
     goto eos;
 
+  if (src->use_cache)
+    return gst_neonhttp_src_create_cached (src, basesrc->blocksize, outbuf);
+
   /* Create the buffer. */
   ret = gst_pad_alloc_buffer (GST_BASE_SRC_PAD (basesrc),
       basesrc->segment.last_stop, basesrc->blocksize,
@@ -586,8 +740,23 @@ gst_neonhttp_src_start (GstBaseSrc * bsrc)
   if (res != 0)
     goto init_failed;
 
+  /* ask for the first block when the cache is used, the server might answer
+   * with the entire resource instead */
   res = gst_neonhttp_src_send_request_and_redirect (src,
-      &src->session, &src->request, 0, src->automatic_redirect);
+      &src->session, &src->request, 0,
+      src->cache_size > 0 && !src->iradio_mode ? CACHE_BLOCK_SIZE : -1,
+      src->automatic_redirect);
+
+  if (res == NE_OK && src->session &&
+      ne_get_status (src->request)->code == 206) {
+    if (gst_neonhttp_src_start_cache (src))
+      return TRUE;
+
+    GST_WARNING_OBJECT (src, "could not use the cache, reading at once");
+    gst_neonhttp_src_close_session (src);
+    res = gst_neonhttp_src_send_request_and_redirect (src,
+        &src->session, &src->request, 0, -1, src->automatic_redirect);
+  }
 
   if (res != NE_OK || !src->session) {
     if (res == HTTP_SOCKET_ERROR) {
@@ -714,6 +883,7 @@ gst_neonhttp_src_stop (GstBaseSrc * bsrc)
   src->read_position = 0;
   src->seekable = TRUE;
 
+  gst_neonhttp_src_stop_cache (src);
   gst_neonhttp_src_close_session (src);
 
 #ifndef GST_DISABLE_GST_DEBUG
@@ -759,11 +929,24 @@ gst_neonhttp_src_do_seek (GstBaseSrc * bsrc, GstSegment * segment)
   if (!src->seekable)
     return FALSE;
 
+  /* the blocks are fetched on demand */
+  if (src->use_cache) {
+    if (segment->start > src->content_size)
+      return FALSE;
+    src->read_position = segment->start;
+    src->eos = FALSE;
+    /* give the blocks that failed another chance */
+    g_mutex_lock (src->cache_lock);
+    g_hash_table_remove_all (src->failed);
+    g_mutex_unlock (src->cache_lock);
+    return TRUE;
+  }
+
   if (src->read_position == segment->start)
     return TRUE;
 
   res = gst_neonhttp_src_send_request_and_redirect (src,
-      &session, &request, segment->start, src->automatic_redirect);
+      &session, &request, segment->start, -1, src->automatic_redirect);
 
   /* if we are able to seek, replace the session */
   if (res == NE_OK && session) {
@@ -891,12 +1074,16 @@ ssl_verify_callback (void *data, int failures, const ne_ssl_certificate * cert)
 
 /* Try to send the HTTP request to the Icecast server, and if possible deals with
  * all the probable redirections (HTTP status code == 3xx)
+ * The request is sent in the session *ses when it is set, it is replaced by a
+ * new one when redirecting. Only @length bytes are asked for when it is
+ * positive.
  */
 static gint
 gst_neonhttp_src_send_request_and_redirect (GstNeonhttpSrc * src,
-    ne_session ** ses, ne_request ** req, gint64 offset, gboolean do_redir)
+    ne_session ** ses, ne_request ** req, gint64 offset, gint64 length,
+    gboolean do_redir)
 {
-  ne_session *session = NULL;
+  ne_session *session = *ses;
   ne_request *request = NULL;
   gchar **c;
   gint res;
@@ -904,7 +1091,9 @@ gst_neonhttp_src_send_request_and_redirect (GstNeonhttpSrc * src,
   guint request_count = 0;
 
   do {
-    if (src->proxy.host && src->proxy.port) {
+    if (session) {
+      GST_LOG_OBJECT (src, "reusing the open connection");
+    } else if (src->proxy.host && src->proxy.port) {
       session =
           ne_session_create (src->uri.scheme, src->uri.host, src->uri.port);
       ne_session_proxy (session, src->proxy.host, src->proxy.port);
@@ -925,6 +1114,7 @@ gst_neonhttp_src_send_request_and_redirect (GstNeonhttpSrc * src,
     }
 
     ne_set_session_flag (session, NE_SESSFLAG_ICYPROTO, 1);
+    ne_set_session_flag (session, NE_SESSFLAG_PERSIST, 1);
     ne_ssl_set_verify (session, ssl_verify_callback, src);
 
     request = ne_request_create (session, "GET", src->query_string);
@@ -942,7 +1132,11 @@ gst_neonhttp_src_send_request_and_redirect (GstNeonhttpSrc * src,
       ne_add_request_header (request, "icy-metadata", "1");
     }
 
-    if (offset > 0) {
+    if (length > 0) {
+      ne_print_request_header (request, "Range",
+          "bytes=%" G_GINT64_FORMAT "-%" G_GINT64_FORMAT, offset,
+          offset + length - 1);
+    } else if (offset > 0) {
       ne_print_request_header (request, "Range",
           "bytes=%" G_GINT64_FORMAT "-", offset);
     }
@@ -968,7 +1162,8 @@ gst_neonhttp_src_send_request_and_redirect (GstNeonhttpSrc * src,
     }
 
     if ((res != NE_OK) ||
-        (offset == 0 && http_status != 200) ||
+        (STATUS_IS_REDIRECTION (http_status) && do_redir) ||
+        (offset == 0 && http_status != 200 && http_status != 206) ||
         (offset > 0 && http_status != 206 &&
             !STATUS_IS_REDIRECTION (http_status))) {
       ne_request_destroy (request);
@@ -999,10 +1194,8 @@ gst_neonhttp_src_send_request_and_redirect (GstNeonhttpSrc * src,
   } while (do_redir && (request_count < MAX_HTTP_REDIRECTS_NUMBER)
       && STATUS_IS_REDIRECTION (http_status));
 
-  if (session) {
-    *ses = session;
-    *req = request;
-  }
+  *ses = session;
+  *req = request;
 
   return res;
 }
@@ -1070,6 +1263,416 @@ gst_neonhttp_src_close_session (GstNeonhttpSrc * src)
   }
 }
 
+static void
+gst_neonhttp_src_destroy_session (ne_session * session)
+{
+  ne_close_connection (session);
+  ne_session_destroy (session);
+}
+
+/* reads the @len bytes of a range response, the connection can be used for
+ * the next request afterwards */
+static GstBuffer *
+gst_neonhttp_src_read_block (GstNeonhttpSrc * src, ne_request * request,
+    guint len)
+{
+  GstBuffer *buf;
+  guint read = 0;
+  ssize_t ret;
+
+  buf = gst_buffer_new_and_alloc (len);
+  while (read < len) {
+    ret = ne_read_response_block (request,
+        (gchar *) GST_BUFFER_DATA (buf) + read, len - read);
+    if (ret <= 0)
+      goto short_read;
+    read += ret;
+  }
+
+  if (ne_discard_response (request) != NE_OK ||
+      ne_end_request (request) != NE_OK)
+    goto end_failed;
+
+  return buf;
+
+  /* ERRORS */
+short_read:
+  {
+    GST_WARNING_OBJECT (src, "got %u of %u bytes", read, len);
+    gst_buffer_unref (buf);
+    return NULL;
+  }
+end_failed:
+  {
+    GST_WARNING_OBJECT (src, "could not end the request");
+    gst_buffer_unref (buf);
+    return NULL;
+  }
+}
+
+/* the number of blocks fetched after the read position, one block of the
+ * cache is left for the block that is read */
+static guint
+gst_neonhttp_src_prefetch_window (GstNeonhttpSrc * src)
+{
+  guint max_blocks = src->cache_size / CACHE_BLOCK_SIZE;
+
+  if (max_blocks <= 1)
+    return 0;
+
+  return MIN (src->prefetch_blocks, max_blocks - 1);
+}
+
+static void
+gst_neonhttp_src_free_block_unlocked (GstNeonhttpSrc * src,
+    GstNeonhttpBlock * block)
+{
+  g_hash_table_remove (src->blocks, GUINT_TO_POINTER (block->index));
+  g_queue_remove (src->lru, block);
+  src->cached_bytes -= GST_BUFFER_SIZE (block->buffer);
+  gst_buffer_unref (block->buffer);
+  g_slice_free (GstNeonhttpBlock, block);
+}
+
+/* drops the least recently used blocks matching @read until the cache fits,
+ * the blocks from the read position up to the prefetch window are kept */
+static void
+gst_neonhttp_src_evict_unlocked (GstNeonhttpSrc * src, gboolean read)
+{
+  GList *walk, *next;
+  guint last;
+
+  last = src->want_block + gst_neonhttp_src_prefetch_window (src);
+
+  for (walk = src->lru->head; walk && src->cached_bytes > src->cache_size;
+      walk = next) {
+    GstNeonhttpBlock *old = walk->data;
+
+    next = walk->next;
+    if (old->index >= src->want_block && old->index <= last)
+      continue;
+    if (read != (old->index < src->want_block))
+      continue;
+
+    GST_LOG_OBJECT (src, "dropping block %u", old->index);
+    gst_neonhttp_src_free_block_unlocked (src, old);
+  }
+}
+
+/* adds the block and drops the blocks that do not fit anymore, the blocks
+ * before the read position go first, then the ones prefetched for another
+ * read position */
+static void
+gst_neonhttp_src_insert_block_unlocked (GstNeonhttpSrc * src, guint index,
+    GstBuffer * buf)
+{
+  GstNeonhttpBlock *block;
+
+  block = g_slice_new (GstNeonhttpBlock);
+  block->index = index;
+  block->buffer = buf;
+  g_hash_table_insert (src->blocks, GUINT_TO_POINTER (index), block);
+  g_queue_push_tail (src->lru, block);
+  src->cached_bytes += GST_BUFFER_SIZE (buf);
+
+  gst_neonhttp_src_evict_unlocked (src, TRUE);
+  gst_neonhttp_src_evict_unlocked (src, FALSE);
+}
+
+/* queues the blocks from @first up to the prefetch window that are neither
+ * cached nor being fetched, and did not fail */
+static void
+gst_neonhttp_src_schedule_unlocked (GstNeonhttpSrc * src, guint first)
+{
+  guint n_blocks, last, i;
+
+  n_blocks = (src->content_size + CACHE_BLOCK_SIZE - 1) / CACHE_BLOCK_SIZE;
+  last = MIN (first + gst_neonhttp_src_prefetch_window (src), n_blocks - 1);
+
+  for (i = first; i <= last; i++) {
+    if (g_hash_table_lookup (src->blocks, GUINT_TO_POINTER (i)) ||
+        g_hash_table_lookup (src->pending, GUINT_TO_POINTER (i)) ||
+        g_hash_table_lookup (src->failed, GUINT_TO_POINTER (i)))
+      continue;
+
+    g_hash_table_insert (src->pending, GUINT_TO_POINTER (i),
+        GUINT_TO_POINTER (TRUE));
+    /* the thread pool does not take NULL */
+    g_thread_pool_push (src->fetchers, GUINT_TO_POINTER (i + 1), NULL);
+  }
+}
+
+/* runs in the thread pool, fetches one block in a connection of the pool */
+static void
+gst_neonhttp_src_fetch_block (gpointer data, gpointer user_data)
+{
+  GstNeonhttpSrc *src = GST_NEONHTTP_SRC (user_data);
+  guint index = GPOINTER_TO_UINT (data) - 1;
+  ne_session *session;
+  ne_request *request = NULL;
+  GstBuffer *buf = NULL;
+  gchar *error = NULL;
+  guint64 offset;
+  guint len, attempt;
+  gint res;
+
+  g_mutex_lock (src->cache_lock);
+  /* a seek could have moved the read position away from the block */
+  if (src->cache_flushing || index < src->want_block ||
+      index > src->want_block + gst_neonhttp_src_prefetch_window (src)) {
+    GST_LOG_OBJECT (src, "block %u not needed anymore", index);
+    g_hash_table_remove (src->pending, GUINT_TO_POINTER (index));
+    g_mutex_unlock (src->cache_lock);
+    return;
+  }
+  session = g_queue_pop_head (src->idle_sessions);
+  g_mutex_unlock (src->cache_lock);
+
+  offset = (guint64) index * CACHE_BLOCK_SIZE;
+  len = MIN (CACHE_BLOCK_SIZE, src->content_size - offset);
+
+  /* the server may have closed a kept open connection, so a failed block is
+   * tried once more on a new one */
+  for (attempt = 0; attempt < 2 && buf == NULL; attempt++) {
+    if (attempt > 0) {
+      GST_DEBUG_OBJECT (src, "retrying block %u: %s", index, error);
+      g_free (error);
+      error = NULL;
+      if (session) {
+        gst_neonhttp_src_destroy_session (session);
+        session = NULL;
+      }
+    }
+
+    GST_LOG_OBJECT (src, "fetching block %u", index);
+    res = gst_neonhttp_src_send_request_and_redirect (src, &session, &request,
+        offset, len, FALSE);
+
+    if (res == NE_OK && session) {
+      if (ne_get_status (request)->code == 206)
+        buf = gst_neonhttp_src_read_block (src, request, len);
+      if (buf == NULL)
+        error = g_strdup_printf ("%d %s", ne_get_status (request)->code,
+            ne_get_error (session));
+      ne_request_destroy (request);
+    } else {
+      error = g_strdup_printf ("Could not begin request: %d", res);
+    }
+  }
+
+  g_mutex_lock (src->cache_lock);
+  g_hash_table_remove (src->pending, GUINT_TO_POINTER (index));
+  if (buf) {
+    gst_neonhttp_src_insert_block_unlocked (src, index, buf);
+    /* keep the connection for the next request */
+    g_queue_push_tail (src->idle_sessions, session);
+    session = NULL;
+  } else {
+    /* only an error when the block is read */
+    GST_WARNING_OBJECT (src, "block %u failed: %s", index, error);
+    g_hash_table_insert (src->failed, GUINT_TO_POINTER (index), error);
+    error = NULL;
+  }
+  g_cond_broadcast (src->cache_cond);
+  g_mutex_unlock (src->cache_lock);
+
+  if (session)
+    gst_neonhttp_src_destroy_session (session);
+  g_free (error);
+}
+
+/* called when the first block was requested in src->session, the rest of the
+ * resource is read through the cache then */
+static gboolean
+gst_neonhttp_src_start_cache (GstNeonhttpSrc * src)
+{
+  const gchar *range;
+  GstBuffer *buf;
+  GError *err = NULL;
+
+  /* the total size follows the range, e.g. "bytes 0-65535/1234567" */
+  range = ne_get_response_header (src->request, "Content-Range");
+  if (range == NULL || (range = strchr (range, '/')) == NULL ||
+      range[1] == '*')
+    goto no_size;
+
+  src->content_size = g_ascii_strtoull (range + 1, NULL, 10);
+  if (src->content_size == 0)
+    goto no_size;
+
+  buf = gst_neonhttp_src_read_block (src, src->request,
+      MIN (CACHE_BLOCK_SIZE, src->content_size));
+  if (buf == NULL)
+    return FALSE;
+
+  src->fetchers = g_thread_pool_new (gst_neonhttp_src_fetch_block, src,
+      src->max_connections, FALSE, &err);
+  if (src->fetchers == NULL)
+    goto thread_failed;
+
+  ne_request_destroy (src->request);
+  src->request = NULL;
+
+  g_mutex_lock (src->cache_lock);
+  src->want_block = 0;
+  src->cache_hits = 0;
+  src->cache_misses = 0;
+  gst_neonhttp_src_insert_block_unlocked (src, 0, buf);
+  g_queue_push_tail (src->idle_sessions, src->session);
+  src->session = NULL;
+  g_mutex_unlock (src->cache_lock);
+
+  GST_DEBUG_OBJECT (src, "reading %" G_GUINT64_FORMAT " bytes through the "
+      "cache", src->content_size);
+  src->use_cache = TRUE;
+
+  return TRUE;
+
+  /* ERRORS */
+no_size:
+  {
+    GST_WARNING_OBJECT (src, "unknown size in range response");
+    src->content_size = -1;
+    return FALSE;
+  }
+thread_failed:
+  {
+    GST_WARNING_OBJECT (src, "could not create threads: %s", err->message);
+    g_error_free (err);
+    gst_buffer_unref (buf);
+    return FALSE;
+  }
+}
+
+static void
+gst_neonhttp_src_stop_cache (GstNeonhttpSrc * src)
+{
+  ne_session *session;
+
+  if (src->fetchers) {
+    /* drop the queued blocks and wait for the ones being fetched */
+    g_mutex_lock (src->cache_lock);
+    src->cache_flushing = TRUE;
+    g_mutex_unlock (src->cache_lock);
+    g_thread_pool_free (src->fetchers, TRUE, TRUE);
+    src->fetchers = NULL;
+  }
+
+  g_mutex_lock (src->cache_lock);
+  while (src->lru->head)
+    gst_neonhttp_src_free_block_unlocked (src, src->lru->head->data);
+  g_hash_table_remove_all (src->pending);
+  while ((session = g_queue_pop_head (src->idle_sessions)))
+    gst_neonhttp_src_destroy_session (session);
+  g_hash_table_remove_all (src->failed);
+  src->cache_flushing = FALSE;
+  src->use_cache = FALSE;
+  g_mutex_unlock (src->cache_lock);
+}
+
+static GstFlowReturn
+gst_neonhttp_src_create_cached (GstNeonhttpSrc * src, guint size,
+    GstBuffer ** outbuf)
+{
+  GstNeonhttpBlock *block;
+  guint64 position = src->read_position;
+  guint index, offset;
+  gchar *error;
+
+  if (position >= src->content_size)
+    goto eos;
+
+  index = position / CACHE_BLOCK_SIZE;
+
+  g_mutex_lock (src->cache_lock);
+  src->want_block = index;
+  gst_neonhttp_src_schedule_unlocked (src, index);
+
+  block = g_hash_table_lookup (src->blocks, GUINT_TO_POINTER (index));
+  if (block)
+    src->cache_hits++;
+  else
+    src->cache_misses++;
+
+  while (block == NULL) {
+    if (src->cache_flushing)
+      goto flushing;
+    if (g_hash_table_lookup (src->failed, GUINT_TO_POINTER (index)))
+      goto read_error;
+
+    GST_LOG_OBJECT (src, "waiting for block %u", index);
+    g_cond_wait (src->cache_cond, src->cache_lock);
+    block = g_hash_table_lookup (src->blocks, GUINT_TO_POINTER (index));
+  }
+
+  /* keep the block longest */
+  g_queue_remove (src->lru, block);
+  g_queue_push_tail (src->lru, block);
+
+  offset = position - (guint64) index * CACHE_BLOCK_SIZE;
+  size = MIN (size, GST_BUFFER_SIZE (block->buffer) - offset);
+  *outbuf = gst_buffer_create_sub (block->buffer, offset, size);
+  g_mutex_unlock (src->cache_lock);
+
+  GST_BUFFER_OFFSET (*outbuf) = position;
+  gst_buffer_set_caps (*outbuf, GST_PAD_CAPS (GST_BASE_SRC_PAD (src)));
+  src->read_position += size;
+
+  GST_LOG_OBJECT (src, "returning %u bytes at %" G_GUINT64_FORMAT, size,
+      position);
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+eos:
+  {
+    GST_DEBUG_OBJECT (src, "EOS reached");
+    return GST_FLOW_UNEXPECTED;
+  }
+flushing:
+  {
+    g_mutex_unlock (src->cache_lock);
+    GST_DEBUG_OBJECT (src, "flushing");
+    return GST_FLOW_WRONG_STATE;
+  }
+read_error:
+  {
+    error = g_strdup (g_hash_table_lookup (src->failed,
+            GUINT_TO_POINTER (index)));
+    g_mutex_unlock (src->cache_lock);
+    GST_ELEMENT_ERROR (src, RESOURCE, READ,
+        (NULL), ("Could not read range at %" G_GUINT64_FORMAT " (%s)",
+            position, error));
+    g_free (error);
+    return GST_FLOW_ERROR;
+  }
+}
+
+static gboolean
+gst_neonhttp_src_unlock (GstBaseSrc * bsrc)
+{
+  GstNeonhttpSrc *src = GST_NEONHTTP_SRC (bsrc);
+
+  g_mutex_lock (src->cache_lock);
+  src->cache_flushing = TRUE;
+  g_cond_broadcast (src->cache_cond);
+  g_mutex_unlock (src->cache_lock);
+
+  return TRUE;
+}
+
+static gboolean
+gst_neonhttp_src_unlock_stop (GstBaseSrc * bsrc)
+{
+  GstNeonhttpSrc *src = GST_NEONHTTP_SRC (bsrc);
+
+  g_mutex_lock (src->cache_lock);
+  src->cache_flushing = FALSE;
+  g_mutex_unlock (src->cache_lock);
+
+  return TRUE;
+}
+
 /* The following two charset mangling functions were copied from gnomevfssrc.
  * Preserve them under the unverified assumption that they do something vaguely
  * worthwhile.
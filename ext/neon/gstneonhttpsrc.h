@@ -81,6 +81,26 @@ struct _GstNeonhttpSrc {
   /* seconds before timing out when connecting or reading to/from a socket */
   guint connect_timeout;
   guint read_timeout;
+
+  /* block cache filled by the fetcher threads, the fields below are
+   * protected by cache_lock */
+  guint cache_size;
+  guint prefetch_blocks;
+  guint max_connections;
+  gboolean use_cache;
+  GMutex *cache_lock;
+  GCond *cache_cond;
+  GHashTable *blocks;
+  GQueue *lru;
+  guint cached_bytes;
+  GHashTable *pending;
+  guint want_block;
+  GQueue *idle_sessions;
+  GThreadPool *fetchers;
+  gboolean cache_flushing;
+  GHashTable *failed;
+  guint64 cache_hits;
+  guint64 cache_misses;
 };
 
 struct _GstNeonhttpSrcClass {
@@ -411,7 +411,7 @@ gst_signal_processor_cleanup (GstSignalProcessor * self)
 
   for (i = 0; i < klass->num_group_out; ++i) {
     g_free (self->group_out[i].buffer);
-    memset (&self->group_in[i], '\0', sizeof (GstSignalProcessorGroup));
+    memset (&self->group_out[i], '\0', sizeof (GstSignalProcessorGroup));
   }
 
   self->state = GST_SIGNAL_PROCESSOR_STATE_NULL;
@@ -534,19 +534,84 @@ setcaps_pull_failed:
   }
 }
 
+/* The (de)interleaving is done in blocks of frames so that the interleaved
+ * side of a block stays in the cache while the channels are written one
+ * after the other. Stereo, 5.1 and 7.1 get versions with a constant
+ * channel stride. */
+#define INTERLEAVE_BLOCK 64
+
+#define MAKE_DEINTERLEAVE_FUNC(name,n)                                  \
+static void                                                             \
+name (gfloat * planar, const gfloat * interleaved, guint nframes)       \
+{                                                                       \
+  guint b, i, j, len;                                                   \
+  for (b = 0; b < nframes; b += INTERLEAVE_BLOCK) {                     \
+    len = MIN (INTERLEAVE_BLOCK, nframes - b);                          \
+    for (j = 0; j < n; j++) {                                           \
+      gfloat *out = planar + j * nframes + b;                           \
+      const gfloat *in = interleaved + b * n + j;                       \
+      for (i = 0; i < len; i++)                                         \
+        out[i] = in[i * n];                                             \
+    }                                                                   \
+  }                                                                     \
+}
+
+#define MAKE_INTERLEAVE_FUNC(name,n)                                    \
+static void                                                             \
+name (gfloat * interleaved, const gfloat * planar, guint nframes)       \
+{                                                                       \
+  guint b, i, j, len;                                                   \
+  for (b = 0; b < nframes; b += INTERLEAVE_BLOCK) {                     \
+    len = MIN (INTERLEAVE_BLOCK, nframes - b);                          \
+    for (j = 0; j < n; j++) {                                           \
+      gfloat *out = interleaved + b * n + j;                            \
+      const gfloat *in = planar + j * nframes + b;                      \
+      for (i = 0; i < len; i++)                                         \
+        out[i * n] = in[i];                                             \
+    }                                                                   \
+  }                                                                     \
+}
+
+/* *INDENT-OFF* */
+MAKE_DEINTERLEAVE_FUNC (deinterleave_2, 2)
+MAKE_DEINTERLEAVE_FUNC (deinterleave_6, 6)
+MAKE_DEINTERLEAVE_FUNC (deinterleave_8, 8)
+MAKE_INTERLEAVE_FUNC (interleave_2, 2)
+MAKE_INTERLEAVE_FUNC (interleave_6, 6)
+MAKE_INTERLEAVE_FUNC (interleave_8, 8)
+/* *INDENT-ON* */
+
 /* De-interleave a pad (gstreamer => plugin) */
 static void
 gst_signal_processor_deinterleave_group (GstSignalProcessorGroup * group,
     guint nframes)
 {
-  guint i, j;
+  guint b, i, j, len;
   g_assert (group->nframes == nframes);
   g_assert (group->interleaved_buffer);
   g_assert (group->buffer);
-  for (i = 0; i < nframes; ++i)
+
+  switch (group->channels) {
+    case 2:
+      deinterleave_2 (group->buffer, group->interleaved_buffer, nframes);
+      return;
+    case 6:
+      deinterleave_6 (group->buffer, group->interleaved_buffer, nframes);
+      return;
+    case 8:
+      deinterleave_8 (group->buffer, group->interleaved_buffer, nframes);
+      return;
+    default:
+      break;
+  }
+
+  for (b = 0; b < nframes; b += INTERLEAVE_BLOCK) {
+    len = MIN (INTERLEAVE_BLOCK, nframes - b);
     for (j = 0; j < group->channels; ++j)
-      group->buffer[(j * nframes) + i]
-          = group->interleaved_buffer[(i * group->channels) + j];
+      for (i = b; i < b + len; ++i)
+        group->buffer[(j * nframes) + i]
+            = group->interleaved_buffer[(i * group->channels) + j];
+  }
 }
 
 /* Interleave a pad (plugin => gstreamer) */
@@ -554,14 +619,47 @@ static void
 gst_signal_processor_interleave_group (GstSignalProcessorGroup * group,
     guint nframes)
 {
-  guint i, j;
+  guint b, i, j, len;
   g_assert (group->nframes == nframes);
   g_assert (group->interleaved_buffer);
   g_assert (group->buffer);
-  for (i = 0; i < nframes; ++i)
+
+  switch (group->channels) {
+    case 2:
+      interleave_2 (group->interleaved_buffer, group->buffer, nframes);
+      return;
+    case 6:
+      interleave_6 (group->interleaved_buffer, group->buffer, nframes);
+      return;
+    case 8:
+      interleave_8 (group->interleaved_buffer, group->buffer, nframes);
+      return;
+    default:
+      break;
+  }
+
+  for (b = 0; b < nframes; b += INTERLEAVE_BLOCK) {
+    len = MIN (INTERLEAVE_BLOCK, nframes - b);
     for (j = 0; j < group->channels; ++j)
-      group->interleaved_buffer[(i * group->channels) + j]
-          = group->buffer[(j * nframes) + i];
+      for (i = b; i < b + len; ++i)
+        group->interleaved_buffer[(i * group->channels) + j]
+            = group->buffer[(j * nframes) + i];
+  }
+}
+
+/* Makes sure the de-interleaved buffer of @group can hold @nframes of
+ * @channels. The buffer is kept across process cycles and only grows. */
+static void
+gst_signal_processor_group_prepare (GstSignalProcessorGroup * group,
+    guint channels, guint nframes)
+{
+  if (!group->buffer || group->allocated < nframes * channels) {
+    g_free (group->buffer);
+    group->buffer = g_new (gfloat, nframes * channels);
+    group->allocated = nframes * channels;
+  }
+  group->channels = channels;
+  group->nframes = nframes;
 }
 
 static gboolean
@@ -615,7 +713,7 @@ gst_signal_processor_prepare (GstSignalProcessor * self, guint nframes)
   GstSignalProcessorClass *klass;
   GList *sinks, *srcs;
   guint samples_avail = nframes;
-  guint i, in_group_index = 0, out_group_index = 0;
+  guint in_group_index = 0, out_group_index = 0;
   gboolean is_gap = FALSE;
   GstClockTime ts, tss = GST_CLOCK_TIME_NONE, tse = GST_CLOCK_TIME_NONE;
 
@@ -623,28 +721,24 @@ gst_signal_processor_prepare (GstSignalProcessor * self, guint nframes)
 
   /* first, assign audio_in pointers, and determine the number of samples that
    * we can process */
-  i = 0;
-  for (sinks = elem->sinkpads; sinks; sinks = sinks->next, ++i) {
+  for (sinks = elem->sinkpads; sinks; sinks = sinks->next) {
     GstSignalProcessorPad *sinkpad;
 
     sinkpad = (GstSignalProcessorPad *) sinks->data;
     g_assert (sinkpad->samples_avail > 0);
     samples_avail = MIN (samples_avail, sinkpad->samples_avail);
+  }
+
+  /* then de-interleave the multi-channel pads, mono pads are used in place */
+  for (sinks = elem->sinkpads; sinks; sinks = sinks->next) {
+    GstSignalProcessorPad *sinkpad;
+
+    sinkpad = (GstSignalProcessorPad *) sinks->data;
     if (sinkpad->channels > 1) {
       GstSignalProcessorGroup *group = &self->group_in[in_group_index++];
       group->interleaved_buffer = sinkpad->data;
-      /* allocate buffer for de-interleaving */
-      if (!group->buffer || group->channels < sinkpad->channels
-          || group->nframes < samples_avail) {
-        group->buffer =
-            (gfloat *) g_realloc (group->buffer,
-            samples_avail * sinkpad->channels * sizeof (gfloat));
-        memset (group->buffer, '\0',
-            samples_avail * sinkpad->channels * sizeof (gfloat));
-      }
-      g_assert (group->buffer);
-      group->channels = sinkpad->channels;
-      group->nframes = samples_avail;
+      gst_signal_processor_group_prepare (group, sinkpad->channels,
+          samples_avail);
       gst_signal_processor_deinterleave_group (group, samples_avail);
     } else {
       self->audio_in[sinkpad->index] = sinkpad->data;
@@ -679,7 +773,9 @@ gst_signal_processor_prepare (GstSignalProcessor * self, guint nframes)
 
   /* now assign output buffers. we can avoid allocation by reusing input
      buffers, but only if process() can work in place, and if the input buffer
-     is the exact size of the number of samples we are processing. */
+     is writable and the exact size of the number of samples we are
+     processing. Multi-channel input buffers have been de-interleaved already,
+     so they can receive the interleaved output as well. */
   sinks = elem->sinkpads;
   srcs = elem->srcpads;
 
@@ -692,14 +788,23 @@ gst_signal_processor_prepare (GstSignalProcessor * self, guint nframes)
       sinkpad = (GstSignalProcessorPad *) sinks->data;
       srcpad = (GstSignalProcessorPad *) srcs->data;
 
-      if (sinkpad->channels == 1 && sinkpad->channels == srcpad->channels
+      if (sinkpad->channels == srcpad->channels
           && GST_BUFFER_SIZE (sinkpad->pen) ==
-          samples_avail * sizeof (gfloat)) {
+          samples_avail * sinkpad->channels * sizeof (gfloat)
+          && gst_buffer_is_writable (sinkpad->pen)) {
         /* reusable, yay */
         g_assert (sinkpad->samples_avail == samples_avail);
         srcpad->pen = sinkpad->pen;
         sinkpad->pen = NULL;
-        self->audio_out[srcpad->index] = sinkpad->data;
+        if (srcpad->channels > 1) {
+          GstSignalProcessorGroup *group = &self->group_out[out_group_index++];
+          group->interleaved_buffer = sinkpad->data;
+          gst_signal_processor_group_prepare (group, srcpad->channels,
+              samples_avail);
+        } else {
+          self->audio_out[srcpad->index] = sinkpad->data;
+        }
+        GST_BUFFER_TIMESTAMP (srcpad->pen) = ts;
         self->pending_out++;
 
         srcs = srcs->next;
@@ -732,13 +837,8 @@ gst_signal_processor_prepare (GstSignalProcessor * self, guint nframes)
     } else if (srcpad->channels > 1) {
       GstSignalProcessorGroup *group = &self->group_out[out_group_index++];
       group->interleaved_buffer = (gfloat *) GST_BUFFER_DATA (srcpad->pen);
-      if (!group->buffer || group->channels < srcpad->channels
-          || group->nframes < samples_avail)
-        group->buffer =
-            (gfloat *) g_realloc (group->buffer,
-            samples_avail * srcpad->channels * sizeof (gfloat));
-      group->channels = srcpad->channels;
-      group->nframes = samples_avail;
+      gst_signal_processor_group_prepare (group, srcpad->channels,
+          samples_avail);
       self->pending_out++;
     } else {
       self->audio_out[srcpad->index] = (gfloat *) GST_BUFFER_DATA (srcpad->pen);
@@ -891,7 +991,7 @@ gst_signal_processor_flush (GstSignalProcessor * self)
 
   /* no outputs prepared and inputs for each pad needed */
   self->pending_out = 0;
-  self->pending_in = klass->num_audio_in;
+  self->pending_in = klass->num_group_in + klass->num_audio_in;
 }
 
 static void
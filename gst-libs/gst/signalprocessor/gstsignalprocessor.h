@@ -70,9 +70,10 @@ typedef struct _GstSignalProcessorClass GstSignalProcessorClass;
 
 struct _GstSignalProcessorGroup {
   guint channels; /**< Number of channels in buffers */
-  guint nframes; /**< Number of frames currently allocated per channel */
+  guint nframes; /**< Number of frames in the buffers per channel */
   gfloat *interleaved_buffer; /**< Interleaved buffer (c1c2c1c2...)*/
   gfloat *buffer; /**< De-interleaved buffer (c1c1...c2c2...) */
+  guint allocated; /**< Number of samples the de-interleaved buffer can hold */
 };
 
 struct _GstSignalProcessor {
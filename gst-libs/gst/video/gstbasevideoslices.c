@@ -0,0 +1,218 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/**
+ * SECTION:gstbasevideoslices
+ * @short_description: Split the processing of a frame between threads
+ *
+ * Filters whose output rows can be computed independently cut every frame
+ * into horizontal slices that are processed in parallel. The element keeps
+ * an array of its own slice structures and describes the rows of each slice
+ * in them, gst_base_video_slices_run() then processes the first slice in the
+ * calling thread and the others in a thread pool, and returns once all of
+ * them are done.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstbasevideoslices.h"
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>             /* for sysconf() */
+#endif
+
+struct _GstBaseVideoSlices
+{
+  GstBaseVideoSliceFunc func;
+  gpointer user_data;
+
+  GThreadPool *pool;
+  guint pool_threads;
+
+  GMutex *lock;
+  GCond *cond;
+  guint pending;
+};
+
+static void
+gst_base_video_slices_worker (gpointer data, gpointer user_data)
+{
+  GstBaseVideoSlices *slices = user_data;
+
+  slices->func (data, slices->user_data);
+
+  g_mutex_lock (slices->lock);
+  slices->pending--;
+  if (slices->pending == 0)
+    g_cond_signal (slices->cond);
+  g_mutex_unlock (slices->lock);
+}
+
+/**
+ * gst_base_video_slices_new:
+ * @func: the function processing a slice
+ * @user_data: data passed to @func
+ *
+ * Returns: a new #GstBaseVideoSlices, free with gst_base_video_slices_free()
+ */
+GstBaseVideoSlices *
+gst_base_video_slices_new (GstBaseVideoSliceFunc func, gpointer user_data)
+{
+  GstBaseVideoSlices *slices;
+
+  g_return_val_if_fail (func != NULL, NULL);
+
+  slices = g_slice_new0 (GstBaseVideoSlices);
+  slices->func = func;
+  slices->user_data = user_data;
+  slices->lock = g_mutex_new ();
+  slices->cond = g_cond_new ();
+
+  return slices;
+}
+
+/**
+ * gst_base_video_slices_free:
+ * @slices: a #GstBaseVideoSlices
+ *
+ * Stops the worker threads and frees @slices.
+ */
+void
+gst_base_video_slices_free (GstBaseVideoSlices * slices)
+{
+  g_return_if_fail (slices != NULL);
+
+  if (slices->pool)
+    g_thread_pool_free (slices->pool, FALSE, TRUE);
+  g_mutex_free (slices->lock);
+  g_cond_free (slices->cond);
+  g_slice_free (GstBaseVideoSlices, slices);
+}
+
+/**
+ * gst_base_video_slices_param_spec_threads:
+ *
+ * Returns: the spec of a "threads" property, for the number of threads
+ * passed to gst_base_video_slices_prepare()
+ */
+GParamSpec *
+gst_base_video_slices_param_spec_threads (void)
+{
+  return g_param_spec_uint ("threads", "Threads",
+      "Number of threads the processing of a frame is split between "
+      "(0 = one per CPU)", 0, GST_BASE_VIDEO_SLICES_MAX_THREADS, 0,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+}
+
+/**
+ * gst_base_video_slices_prepare:
+ * @slices: a #GstBaseVideoSlices
+ * @threads: the number of threads to use, 0 for one per CPU
+ * @n_units: the number of rows (or rows of blocks) in the frame
+ * @min_units: the minimum number of rows in a slice
+ *
+ * Starts the worker threads when their number changed. Very small slices are
+ * not worth the synchronisation, so the frame is split into no more slices
+ * than there are @min_units rows in it.
+ *
+ * Returns: the number of slices to split the frame into, between 1 and
+ * #GST_BASE_VIDEO_SLICES_MAX_THREADS
+ */
+guint
+gst_base_video_slices_prepare (GstBaseVideoSlices * slices, guint threads,
+    gint n_units, gint min_units)
+{
+  glong n_threads = threads;
+
+  g_return_val_if_fail (slices != NULL, 1);
+  g_return_val_if_fail (min_units > 0, 1);
+
+  if (n_threads == 0) {
+#if defined (HAVE_UNISTD_H) && defined (_SC_NPROCESSORS_ONLN)
+    n_threads = sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+  }
+  n_threads = CLAMP (n_threads, 1, GST_BASE_VIDEO_SLICES_MAX_THREADS);
+
+  /* the calling thread processes the first slice */
+  if (n_threads > 1 && slices->pool_threads != n_threads) {
+    GError *err = NULL;
+
+    if (slices->pool)
+      g_thread_pool_free (slices->pool, FALSE, TRUE);
+    slices->pool_threads = 0;
+    slices->pool = g_thread_pool_new (gst_base_video_slices_worker, slices,
+        n_threads - 1, TRUE, &err);
+    if (slices->pool) {
+      slices->pool_threads = n_threads;
+    } else {
+      GST_WARNING ("Failed to create thread pool: %s",
+          err ? err->message : "unknown reason");
+      g_clear_error (&err);
+    }
+  }
+  if (slices->pool == NULL)
+    return 1;
+
+  n_threads = MIN (n_threads, slices->pool_threads);
+
+  return CLAMP (n_units / min_units, 1, n_threads);
+}
+
+/**
+ * gst_base_video_slices_run:
+ * @slices: a #GstBaseVideoSlices
+ * @data: an array of @n_slices slice structures
+ * @slice_size: the size of a slice structure
+ * @n_slices: the number of slices, as returned by
+ * gst_base_video_slices_prepare()
+ *
+ * Calls the slice function on every slice of @data, in parallel, and
+ * returns when all of them are done.
+ */
+void
+gst_base_video_slices_run (GstBaseVideoSlices * slices, gpointer data,
+    gsize slice_size, guint n_slices)
+{
+  guint i;
+
+  g_return_if_fail (slices != NULL);
+  g_return_if_fail (n_slices >= 1);
+  g_return_if_fail (n_slices <= MAX (slices->pool_threads, 1));
+
+  if (n_slices > 1) {
+    g_mutex_lock (slices->lock);
+    slices->pending = n_slices - 1;
+    g_mutex_unlock (slices->lock);
+
+    for (i = 1; i < n_slices; i++)
+      g_thread_pool_push (slices->pool, (guint8 *) data + i * slice_size,
+          NULL);
+  }
+
+  slices->func (data, slices->user_data);
+
+  if (n_slices > 1) {
+    g_mutex_lock (slices->lock);
+    while (slices->pending > 0)
+      g_cond_wait (slices->cond, slices->lock);
+    g_mutex_unlock (slices->lock);
+  }
+}
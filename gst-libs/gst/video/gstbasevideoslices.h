@@ -0,0 +1,62 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _GST_BASE_VIDEO_SLICES_H_
+#define _GST_BASE_VIDEO_SLICES_H_
+
+#ifndef GST_USE_UNSTABLE_API
+#warning "GstBaseVideoSlices is unstable API and may change in future."
+#warning "You can define GST_USE_UNSTABLE_API to avoid this warning."
+#endif
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GST_BASE_VIDEO_SLICES_MAX_THREADS:
+ *
+ * The upper limit on the number of slices a frame is split into.
+ */
+#define GST_BASE_VIDEO_SLICES_MAX_THREADS 16
+
+typedef struct _GstBaseVideoSlices GstBaseVideoSlices;
+
+/**
+ * GstBaseVideoSliceFunc:
+ * @slice: the slice to process
+ * @user_data: the data passed to gst_base_video_slices_new()
+ *
+ * Processes one slice of a frame.
+ */
+typedef void (*GstBaseVideoSliceFunc) (gpointer slice, gpointer user_data);
+
+GstBaseVideoSlices *gst_base_video_slices_new (GstBaseVideoSliceFunc func,
+    gpointer user_data);
+void gst_base_video_slices_free (GstBaseVideoSlices * slices);
+
+GParamSpec *gst_base_video_slices_param_spec_threads (void);
+
+guint gst_base_video_slices_prepare (GstBaseVideoSlices * slices,
+    guint threads, gint n_units, gint min_units);
+void gst_base_video_slices_run (GstBaseVideoSlices * slices, gpointer data,
+    gsize slice_size, guint n_slices);
+
+G_END_DECLS
+
+#endif
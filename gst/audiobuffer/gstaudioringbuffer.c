@@ -23,7 +23,29 @@
  * SECTION:element-audioringbuffer
  * @short_description: Asynchronous audio ringbuffer.
  *
+ * audioringbuffer decouples the thread that produces audio from the one that
+ * consumes it.  Downstream either pulls from the element, or the element
+ * pushes segments of #GstAudioRingbuffer:segment-time from its own thread.
  *
+ * The samples go through a single producer, single consumer ring: the
+ * streaming thread of the sink pad only moves the write position and the
+ * consumer only the read position, so copying audio in and out never takes
+ * a lock.  The object lock is only taken to sleep when the ring is full or
+ * empty, and to wake the other side up when it sleeps.
+ *
+ * The consumer waits for the ring to hold #GstAudioRingbuffer:low-percent
+ * of #GstAudioRingbuffer:buffer-time before it starts draining.  The fill
+ * level at that moment is the latency that the element reports.  When
+ * pushing in the PLAYING state, the element drains every segment at the
+ * latest when its running time plus that latency is reached on the clock.
+ * #GstAudioRingbuffer:underrun-policy says what happens when the data is
+ * not there at that deadline and #GstAudioRingbuffer:overrun-policy what
+ * happens when the ring goes over #GstAudioRingbuffer:high-percent.  The
+ * stretch policies resample the audio by 1% towards the watermark, which
+ * changes the pitch by as much but avoids gaps and jumps.
+ *
+ * The fill level, a histogram of it and the number of overruns and
+ * underruns are available as read-only properties.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -59,16 +81,95 @@ enum
 
 #define DEFAULT_BUFFER_TIME     ((200 * GST_MSECOND) / GST_USECOND)
 #define DEFAULT_SEGMENT_TIME    ((10 * GST_MSECOND) / GST_USECOND)
+#define DEFAULT_LOW_PERCENT     10
+#define DEFAULT_HIGH_PERCENT    90
+#define DEFAULT_OVERRUN_POLICY  GST_AUDIO_RINGBUFFER_OVERRUN_BLOCK
+#define DEFAULT_UNDERRUN_POLICY GST_AUDIO_RINGBUFFER_UNDERRUN_WAIT
 
+/* the stretch policies consume 1/STRETCH_DIV more or less than they
+ * output */
+#define STRETCH_DIV             100
+/* buckets of the fill-histogram property */
+#define FILL_HISTOGRAM_BUCKETS  10
 
 enum
 {
   PROP_0,
   PROP_BUFFER_TIME,
   PROP_SEGMENT_TIME,
+  PROP_LOW_PERCENT,
+  PROP_HIGH_PERCENT,
+  PROP_OVERRUN_POLICY,
+  PROP_UNDERRUN_POLICY,
+  PROP_CURRENT_LEVEL_TIME,
+  PROP_OVERRUNS,
+  PROP_UNDERRUNS,
+  PROP_FILL_HISTOGRAM,
   PROP_LAST
 };
 
+typedef enum
+{
+  GST_AUDIO_RINGBUFFER_OVERRUN_BLOCK,
+  GST_AUDIO_RINGBUFFER_OVERRUN_DROP,
+  GST_AUDIO_RINGBUFFER_OVERRUN_STRETCH
+} GstAudioRingbufferOverrun;
+
+typedef enum
+{
+  GST_AUDIO_RINGBUFFER_UNDERRUN_WAIT,
+  GST_AUDIO_RINGBUFFER_UNDERRUN_SILENCE,
+  GST_AUDIO_RINGBUFFER_UNDERRUN_STRETCH
+} GstAudioRingbufferUnderrun;
+
+#define GST_TYPE_AUDIO_RINGBUFFER_OVERRUN \
+  (gst_audio_ringbuffer_overrun_get_type ())
+static GType
+gst_audio_ringbuffer_overrun_get_type (void)
+{
+  static GType overrun_type = 0;
+  static const GEnumValue overrun_policies[] = {
+    {GST_AUDIO_RINGBUFFER_OVERRUN_BLOCK,
+        "Block upstream until there is space", "block"},
+    {GST_AUDIO_RINGBUFFER_OVERRUN_DROP,
+        "Drop the samples above the high watermark", "drop"},
+    {GST_AUDIO_RINGBUFFER_OVERRUN_STRETCH,
+        "Drain faster above the high watermark, drop when full", "stretch"},
+    {0, NULL, NULL},
+  };
+
+  if (!overrun_type) {
+    overrun_type =
+        g_enum_register_static ("GstAudioRingbufferOverrun", overrun_policies);
+  }
+  return overrun_type;
+}
+
+#define GST_TYPE_AUDIO_RINGBUFFER_UNDERRUN \
+  (gst_audio_ringbuffer_underrun_get_type ())
+static GType
+gst_audio_ringbuffer_underrun_get_type (void)
+{
+  static GType underrun_type = 0;
+  static const GEnumValue underrun_policies[] = {
+    {GST_AUDIO_RINGBUFFER_UNDERRUN_WAIT,
+        "Wait for the low watermark again", "wait"},
+    {GST_AUDIO_RINGBUFFER_UNDERRUN_SILENCE,
+        "Insert silence at the deadline", "silence"},
+    {GST_AUDIO_RINGBUFFER_UNDERRUN_STRETCH,
+        "Drain slower below the low watermark, silence when empty",
+        "stretch"},
+    {0, NULL, NULL},
+  };
+
+  if (!underrun_type) {
+    underrun_type =
+        g_enum_register_static ("GstAudioRingbufferUnderrun",
+        underrun_policies);
+  }
+  return underrun_type;
+}
+
 #define GST_TYPE_AUDIO_RINGBUFFER \
   (gst_audio_ringbuffer_get_type())
 #define GST_AUDIO_RINGBUFFER(obj) \
@@ -87,9 +188,6 @@ static GType gst_audio_ringbuffer_get_type (void);
 typedef struct _GstAudioRingbuffer GstAudioRingbuffer;
 typedef struct _GstAudioRingbufferClass GstAudioRingbufferClass;
 
-typedef struct _GstIntRingBuffer GstIntRingBuffer;
-typedef struct _GstIntRingBufferClass GstIntRingBufferClass;
-
 struct _GstAudioRingbuffer
 {
   GstElement element;
@@ -105,20 +203,69 @@ struct _GstAudioRingbuffer
   GstSegment sink_segment;
   GstSegment src_segment;
 
-  /* flowreturn when srcpad is paused */
+  /* set from the sink side, read atomically by the consumer */
   gboolean is_eos;
   gboolean flushing;
-  gboolean waiting;
+  GstFlowReturn srcresult;
 
+  /* the side that sleeps in the cond sets its flag first, the other side
+   * only takes the object lock to signal when the flag is set */
+  gint producer_waiting;
+  gint consumer_waiting;
   GCond *cond;
 
-  GstRingBuffer *buffer;
-
+  /* readers inside the ring and the flag that keeps new ones out while the
+   * sink side resets or replaces the ring */
+  gint readers;
+  gint blocked;
+
+  /* set while new caps wait for the ring to empty, the consumer then takes
+   * what is there without waiting for a full segment */
+  gint changing_caps;
+
+  /* the ring, written by the sink side only while readers are blocked */
+  GstRingBufferSpec spec;
+  GstCaps *caps;
+  guint8 *ring;
+  guint ring_mask;
+  guint bpf;
+  guint buffer_frames;
+  guint segment_frames;
+  guint low_frames;
+  guint high_frames;
+  guint8 *silence;
+
+  /* frame counters, they wrap around and only their difference matters */
+  gint write_pos;
+  gint read_pos;
+
+  /* properties */
   GstClockTime buffer_time;
   GstClockTime segment_time;
+  gint low_percent;
+  gint high_percent;
+  GstAudioRingbufferOverrun overrun_policy;
+  GstAudioRingbufferUnderrun underrun_policy;
 
+  /* sink side */
   guint64 next_sample;
-  guint64 last_align;
+  GstClockTime first_time;
+
+  /* consumer side */
+  gboolean draining;
+  gboolean need_newsegment;
+  gboolean discont;
+  guint64 out_offset;
+  guint8 *scratch;
+  guint scratch_size;
+
+  /* fill level at the start of the draining, protected by the object lock */
+  GstClockTime latency;
+
+  /* statistics */
+  gint overruns;
+  gint underruns;
+  guint64 fill_histogram[FILL_HISTOGRAM_BUCKETS];
 };
 
 struct _GstAudioRingbufferClass
@@ -126,103 +273,6 @@ struct _GstAudioRingbufferClass
   GstElementClass parent_class;
 };
 
-
-#define GST_TYPE_INT_RING_BUFFER             (gst_int_ring_buffer_get_type())
-#define GST_INT_RING_BUFFER(obj)             (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_INT_RING_BUFFER,GstIntRingBuffer))
-#define GST_INT_RING_BUFFER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_INT_RING_BUFFER,GstIntRingBufferClass))
-#define GST_INT_RING_BUFFER_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_INT_RING_BUFFER, GstIntRingBufferClass))
-#define GST_INT_RING_BUFFER_CAST(obj)        ((GstIntRingBuffer *)obj)
-#define GST_IS_INT_RING_BUFFER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_INT_RING_BUFFER))
-#define GST_IS_INT_RING_BUFFER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_INT_RING_BUFFER))
-
-
-struct _GstIntRingBuffer
-{
-  GstRingBuffer object;
-};
-
-struct _GstIntRingBufferClass
-{
-  GstRingBufferClass parent_class;
-};
-
-GST_BOILERPLATE (GstIntRingBuffer, gst_int_ring_buffer, GstRingBuffer,
-    GST_TYPE_RING_BUFFER);
-
-static gboolean
-gst_int_ring_buffer_acquire (GstRingBuffer * buf, GstRingBufferSpec * spec)
-{
-  spec->seglatency = spec->segtotal;
-
-  buf->data = gst_buffer_new_and_alloc (spec->segtotal * spec->segsize);
-  memset (GST_BUFFER_DATA (buf->data), 0, GST_BUFFER_SIZE (buf->data));
-
-  return TRUE;
-}
-
-static gboolean
-gst_int_ring_buffer_release (GstRingBuffer * buf)
-{
-  gst_buffer_unref (buf->data);
-  buf->data = NULL;
-
-  return TRUE;
-}
-
-static gboolean
-gst_int_ring_buffer_start (GstRingBuffer * buf)
-{
-  GstAudioRingbuffer *ringbuffer;
-
-  ringbuffer = GST_AUDIO_RINGBUFFER (GST_OBJECT_PARENT (buf));
-
-  GST_OBJECT_LOCK (ringbuffer);
-  if (G_UNLIKELY (ringbuffer->waiting)) {
-    ringbuffer->waiting = FALSE;
-    GST_DEBUG_OBJECT (ringbuffer, "start, sending signal");
-    g_cond_broadcast (ringbuffer->cond);
-  }
-  GST_OBJECT_UNLOCK (ringbuffer);
-
-  return TRUE;
-}
-
-
-static void
-gst_int_ring_buffer_base_init (gpointer klass)
-{
-}
-
-static void
-gst_int_ring_buffer_class_init (GstIntRingBufferClass * klass)
-{
-  GstRingBufferClass *gstringbuffer_class;
-
-  gstringbuffer_class = (GstRingBufferClass *) klass;
-
-  gstringbuffer_class->acquire =
-      GST_DEBUG_FUNCPTR (gst_int_ring_buffer_acquire);
-  gstringbuffer_class->release =
-      GST_DEBUG_FUNCPTR (gst_int_ring_buffer_release);
-  gstringbuffer_class->start = GST_DEBUG_FUNCPTR (gst_int_ring_buffer_start);
-}
-
-static void
-gst_int_ring_buffer_init (GstIntRingBuffer * buff,
-    GstIntRingBufferClass * g_class)
-{
-}
-
-static GstRingBuffer *
-gst_int_ring_buffer_new (void)
-{
-  GstRingBuffer *res;
-
-  res = g_object_new (GST_TYPE_INT_RING_BUFFER, NULL);
-
-  return res;
-}
-
 /* can't use boilerplate as we need to register with Queue2 to avoid conflicts
  * with ringbuffer in core elements */
 static void gst_audio_ringbuffer_class_init (GstAudioRingbufferClass * klass);
@@ -290,6 +340,8 @@ static gboolean gst_audio_ringbuffer_src_activate_push (GstPad * pad,
 static gboolean gst_audio_ringbuffer_sink_activate_push (GstPad * pad,
     gboolean active);
 
+static void gst_audio_ringbuffer_loop (GstPad * pad);
+
 static GstStateChangeReturn gst_audio_ringbuffer_change_state (GstElement *
     element, GstStateChange transition);
 
@@ -310,16 +362,64 @@ gst_audio_ringbuffer_class_init (GstAudioRingbufferClass * klass)
 
   g_object_class_install_property (gobject_class, PROP_BUFFER_TIME,
       g_param_spec_int64 ("buffer-time", "Buffer Time",
-          "Size of audio buffer in nanoseconds", 1,
+          "Size of audio buffer in microseconds", 1,
           G_MAXINT64, DEFAULT_BUFFER_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   g_object_class_install_property (gobject_class, PROP_SEGMENT_TIME,
       g_param_spec_int64 ("segment-time", "Segment Time",
-          "Audio segment duration in nanoseconds", 1,
+          "Audio segment duration in microseconds", 1,
           G_MAXINT64, DEFAULT_SEGMENT_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class, PROP_LOW_PERCENT,
+      g_param_spec_int ("low-percent", "Low percent",
+          "Fill level to reach before draining, in percent of buffer-time",
+          0, 100, DEFAULT_LOW_PERCENT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_HIGH_PERCENT,
+      g_param_spec_int ("high-percent", "High percent",
+          "Fill level above which the overrun policy applies, in percent of "
+          "buffer-time", 0, 100, DEFAULT_HIGH_PERCENT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_OVERRUN_POLICY,
+      g_param_spec_enum ("overrun-policy", "Overrun policy",
+          "What to do with the input above the high watermark",
+          GST_TYPE_AUDIO_RINGBUFFER_OVERRUN, DEFAULT_OVERRUN_POLICY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_UNDERRUN_POLICY,
+      g_param_spec_enum ("underrun-policy", "Underrun policy",
+          "What to output when the input is late",
+          GST_TYPE_AUDIO_RINGBUFFER_UNDERRUN, DEFAULT_UNDERRUN_POLICY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_CURRENT_LEVEL_TIME,
+      g_param_spec_uint64 ("current-level-time", "Current level (ns)",
+          "Current amount of data in the ring", 0, G_MAXUINT64, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_OVERRUNS,
+      g_param_spec_uint ("overruns", "Overruns",
+          "Number of times input was dropped because the ring was full",
+          0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_UNDERRUNS,
+      g_param_spec_uint ("underruns", "Underruns",
+          "Number of times the input was not there in time",
+          0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_FILL_HISTOGRAM,
+      g_param_spec_value_array ("fill-histogram", "Fill histogram",
+          "How often the consumer found the ring filled to each tenth of "
+          "buffer-time",
+          g_param_spec_uint64 ("count", "Count",
+              "Number of reads in this bucket", 0, G_MAXUINT64, 0,
+              G_PARAM_READABLE | G_PARAM_STATIC_STRINGS),
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_pad_template (gstelement_class,
       gst_static_pad_template_get (&srctemplate));
   gst_element_class_add_pad_template (gstelement_class,
@@ -383,6 +483,10 @@ gst_audio_ringbuffer_init (GstAudioRingbuffer * ringbuffer,
 
   ringbuffer->buffer_time = DEFAULT_BUFFER_TIME;
   ringbuffer->segment_time = DEFAULT_SEGMENT_TIME;
+  ringbuffer->low_percent = DEFAULT_LOW_PERCENT;
+  ringbuffer->high_percent = DEFAULT_HIGH_PERCENT;
+  ringbuffer->overrun_policy = DEFAULT_OVERRUN_POLICY;
+  ringbuffer->underrun_policy = DEFAULT_UNDERRUN_POLICY;
 
   GST_DEBUG_OBJECT (ringbuffer,
       "initialized ringbuffer's not_empty & not_full conditions");
@@ -397,10 +501,198 @@ gst_audio_ringbuffer_finalize (GObject * object)
   GST_DEBUG_OBJECT (ringbuffer, "finalizing ringbuffer");
 
   g_cond_free (ringbuffer->cond);
+  g_free (ringbuffer->ring);
+  g_free (ringbuffer->silence);
+  g_free (ringbuffer->scratch);
+  gst_caps_replace (&ringbuffer->caps, NULL);
 
   G_OBJECT_CLASS (elem_parent_class)->finalize (object);
 }
 
+/* ring helpers, the write position is only moved by the sink side and the
+ * read position only by the consumer */
+static inline guint
+gst_audio_ringbuffer_fill (GstAudioRingbuffer * ringbuffer)
+{
+  return (guint) g_atomic_int_get (&ringbuffer->write_pos) -
+      (guint) g_atomic_int_get (&ringbuffer->read_pos);
+}
+
+static void
+gst_audio_ringbuffer_wake (GstAudioRingbuffer * ringbuffer, gint * waiting)
+{
+  if (G_UNLIKELY (g_atomic_int_get (waiting))) {
+    GST_OBJECT_LOCK (ringbuffer);
+    g_cond_broadcast (ringbuffer->cond);
+    GST_OBJECT_UNLOCK (ringbuffer);
+  }
+}
+
+static void
+gst_audio_ringbuffer_wake_all (GstAudioRingbuffer * ringbuffer)
+{
+  GST_OBJECT_LOCK (ringbuffer);
+  g_cond_broadcast (ringbuffer->cond);
+  GST_OBJECT_UNLOCK (ringbuffer);
+}
+
+/* copies @frames frames of @data, or silence when @data is NULL, behind the
+ * write position, the caller made sure that they fit */
+static void
+gst_audio_ringbuffer_ring_write (GstAudioRingbuffer * ringbuffer,
+    const guint8 * data, guint frames)
+{
+  guint pos = (guint) ringbuffer->write_pos & ringbuffer->ring_mask;
+  guint part = MIN (frames, ringbuffer->ring_mask + 1 - pos);
+  guint bpf = ringbuffer->bpf;
+
+  if (data) {
+    memcpy (ringbuffer->ring + pos * bpf, data, part * bpf);
+    memcpy (ringbuffer->ring, data + part * bpf, (frames - part) * bpf);
+  } else {
+    memcpy (ringbuffer->ring + pos * bpf, ringbuffer->silence, part * bpf);
+    memcpy (ringbuffer->ring, ringbuffer->silence, (frames - part) * bpf);
+  }
+
+  /* publish the samples */
+  g_atomic_int_add (&ringbuffer->write_pos, frames);
+  gst_audio_ringbuffer_wake (ringbuffer, &ringbuffer->consumer_waiting);
+}
+
+static void
+gst_audio_ringbuffer_ring_read (GstAudioRingbuffer * ringbuffer,
+    guint8 * data, guint frames)
+{
+  guint pos = (guint) ringbuffer->read_pos & ringbuffer->ring_mask;
+  guint part = MIN (frames, ringbuffer->ring_mask + 1 - pos);
+  guint bpf = ringbuffer->bpf;
+
+  memcpy (data, ringbuffer->ring + pos * bpf, part * bpf);
+  memcpy (data + part * bpf, ringbuffer->ring, (frames - part) * bpf);
+
+  /* give the space back */
+  g_atomic_int_add (&ringbuffer->read_pos, frames);
+  gst_audio_ringbuffer_wake (ringbuffer, &ringbuffer->producer_waiting);
+}
+
+/* sink side, waits until the ring holds at most @level frames */
+static void
+gst_audio_ringbuffer_wait_space (GstAudioRingbuffer * ringbuffer, guint level)
+{
+  GST_OBJECT_LOCK (ringbuffer);
+  g_atomic_int_set (&ringbuffer->producer_waiting, 1);
+  while (gst_audio_ringbuffer_fill (ringbuffer) > level &&
+      !g_atomic_int_get (&ringbuffer->flushing) &&
+      g_atomic_int_get (&ringbuffer->srcresult) == GST_FLOW_OK) {
+    GST_LOG_OBJECT (ringbuffer, "waiting for space");
+    g_cond_wait (ringbuffer->cond, GST_OBJECT_GET_LOCK (ringbuffer));
+  }
+  g_atomic_int_set (&ringbuffer->producer_waiting, 0);
+  GST_OBJECT_UNLOCK (ringbuffer);
+}
+
+/* consumer side, waits until the ring holds @frames frames, the stream
+ * ends, the ring is flushed or replaced, or @deadline passes.  Returns FALSE
+ * in the last case only. */
+static gboolean
+gst_audio_ringbuffer_wait_fill (GstAudioRingbuffer * ringbuffer, guint frames,
+    const GTimeVal * deadline)
+{
+  gboolean res = TRUE;
+  GTimeVal end_time;
+
+  if (G_LIKELY (gst_audio_ringbuffer_fill (ringbuffer) >= frames))
+    return TRUE;
+
+  if (deadline)
+    end_time = *deadline;
+
+  GST_OBJECT_LOCK (ringbuffer);
+  g_atomic_int_set (&ringbuffer->consumer_waiting, 1);
+  while (gst_audio_ringbuffer_fill (ringbuffer) < frames &&
+      !g_atomic_int_get (&ringbuffer->is_eos) &&
+      !g_atomic_int_get (&ringbuffer->flushing) &&
+      !g_atomic_int_get (&ringbuffer->blocked) &&
+      !g_atomic_int_get (&ringbuffer->changing_caps)) {
+    GST_LOG_OBJECT (ringbuffer, "waiting for %u frames", frames);
+    if (deadline) {
+      if (!g_cond_timed_wait (ringbuffer->cond,
+              GST_OBJECT_GET_LOCK (ringbuffer), &end_time)) {
+        res = gst_audio_ringbuffer_fill (ringbuffer) >= frames;
+        break;
+      }
+    } else {
+      g_cond_wait (ringbuffer->cond, GST_OBJECT_GET_LOCK (ringbuffer));
+    }
+  }
+  g_atomic_int_set (&ringbuffer->consumer_waiting, 0);
+  GST_OBJECT_UNLOCK (ringbuffer);
+
+  return res;
+}
+
+/* the consumer enters before it looks at the ring and its format, it is
+ * turned away while the sink side resets or replaces the ring */
+static void
+gst_audio_ringbuffer_reader_leave (GstAudioRingbuffer * ringbuffer)
+{
+  if (g_atomic_int_dec_and_test (&ringbuffer->readers) &&
+      g_atomic_int_get (&ringbuffer->blocked))
+    gst_audio_ringbuffer_wake_all (ringbuffer);
+}
+
+static gboolean
+gst_audio_ringbuffer_reader_enter (GstAudioRingbuffer * ringbuffer)
+{
+  g_atomic_int_inc (&ringbuffer->readers);
+  if (G_LIKELY (!g_atomic_int_get (&ringbuffer->blocked)))
+    return TRUE;
+
+  gst_audio_ringbuffer_reader_leave (ringbuffer);
+
+  GST_OBJECT_LOCK (ringbuffer);
+  while (g_atomic_int_get (&ringbuffer->blocked) &&
+      !g_atomic_int_get (&ringbuffer->flushing))
+    g_cond_wait (ringbuffer->cond, GST_OBJECT_GET_LOCK (ringbuffer));
+  GST_OBJECT_UNLOCK (ringbuffer);
+
+  return FALSE;
+}
+
+static void
+gst_audio_ringbuffer_block_readers (GstAudioRingbuffer * ringbuffer)
+{
+  g_atomic_int_set (&ringbuffer->blocked, 1);
+
+  GST_OBJECT_LOCK (ringbuffer);
+  g_cond_broadcast (ringbuffer->cond);
+  while (g_atomic_int_get (&ringbuffer->readers) > 0)
+    g_cond_wait (ringbuffer->cond, GST_OBJECT_GET_LOCK (ringbuffer));
+  GST_OBJECT_UNLOCK (ringbuffer);
+}
+
+static void
+gst_audio_ringbuffer_unblock_readers (GstAudioRingbuffer * ringbuffer)
+{
+  g_atomic_int_set (&ringbuffer->blocked, 0);
+  gst_audio_ringbuffer_wake_all (ringbuffer);
+}
+
+/* only called with the readers blocked */
+static void
+gst_audio_ringbuffer_reset (GstAudioRingbuffer * ringbuffer)
+{
+  g_atomic_int_set (&ringbuffer->write_pos, 0);
+  g_atomic_int_set (&ringbuffer->read_pos, 0);
+  g_atomic_int_set (&ringbuffer->is_eos, FALSE);
+  ringbuffer->next_sample = -1;
+  ringbuffer->first_time = 0;
+  ringbuffer->draining = FALSE;
+  ringbuffer->need_newsegment = TRUE;
+  ringbuffer->discont = TRUE;
+  ringbuffer->out_offset = 0;
+}
+
 static GstCaps *
 gst_audio_ringbuffer_getcaps (GstPad * pad)
 {
@@ -423,47 +715,83 @@ static gboolean
 gst_audio_ringbuffer_setcaps (GstPad * pad, GstCaps * caps)
 {
   GstAudioRingbuffer *ringbuffer;
-  GstRingBufferSpec *spec;
+  GstRingBufferSpec spec;
+  guint ring_frames, bpf, i;
 
   ringbuffer = GST_AUDIO_RINGBUFFER (GST_PAD_PARENT (pad));
 
-  if (!ringbuffer->buffer)
-    return FALSE;
-
-  spec = &ringbuffer->buffer->spec;
-
-  GST_DEBUG_OBJECT (ringbuffer, "release old ringbuffer");
-
-  /* release old ringbuffer */
-  gst_ring_buffer_activate (ringbuffer->buffer, FALSE);
-  gst_ring_buffer_release (ringbuffer->buffer);
-
   GST_DEBUG_OBJECT (ringbuffer, "parse caps");
 
-  spec->buffer_time = ringbuffer->buffer_time;
-  spec->latency_time = ringbuffer->segment_time;
+  memset (&spec, 0, sizeof (spec));
+  spec.buffer_time = ringbuffer->buffer_time;
+  spec.latency_time = ringbuffer->segment_time;
 
   /* parse new caps */
-  if (!gst_ring_buffer_parse_caps (spec, caps))
+  if (!gst_ring_buffer_parse_caps (&spec, caps))
     goto parse_error;
 
-  gst_ring_buffer_debug_spec_buff (spec);
+  bpf = spec.bytes_per_sample;
+  if (bpf == 0 || spec.rate <= 0)
+    goto parse_error;
 
-  GST_DEBUG_OBJECT (ringbuffer, "acquire ringbuffer");
-  if (!gst_ring_buffer_acquire (ringbuffer->buffer, spec))
-    goto acquire_error;
+  /* let the consumer drain what was queued in the old format */
+  if (ringbuffer->ring) {
+    g_atomic_int_set (&ringbuffer->changing_caps, 1);
+    gst_audio_ringbuffer_wake (ringbuffer, &ringbuffer->consumer_waiting);
+    gst_audio_ringbuffer_wait_space (ringbuffer, 0);
+    g_atomic_int_set (&ringbuffer->changing_caps, 0);
+  }
+  if (g_atomic_int_get (&ringbuffer->flushing))
+    return FALSE;
 
-  GST_DEBUG_OBJECT (ringbuffer, "activate ringbuffer");
-  gst_ring_buffer_activate (ringbuffer->buffer, TRUE);
+  GST_DEBUG_OBJECT (ringbuffer, "replace the ring");
+
+  gst_audio_ringbuffer_block_readers (ringbuffer);
+
+  ringbuffer->spec = spec;
+  ringbuffer->bpf = bpf;
+  ringbuffer->buffer_frames = MAX (gst_util_uint64_scale_int (spec.buffer_time,
+          spec.rate, GST_SECOND / GST_USECOND), 1);
+  ringbuffer->segment_frames = MAX (gst_util_uint64_scale_int
+      (spec.latency_time, spec.rate, GST_SECOND / GST_USECOND), 1);
+  ringbuffer->segment_frames =
+      MIN (ringbuffer->segment_frames, ringbuffer->buffer_frames);
+  ringbuffer->low_frames =
+      ringbuffer->buffer_frames * ringbuffer->low_percent / 100;
+  ringbuffer->high_frames =
+      MAX (ringbuffer->buffer_frames * ringbuffer->high_percent / 100,
+      ringbuffer->low_frames);
+
+  /* a power of two, so that the positions can wrap around */
+  ring_frames = 1;
+  while (ring_frames < ringbuffer->buffer_frames)
+    ring_frames <<= 1;
+  ringbuffer->ring_mask = ring_frames - 1;
+
+  g_free (ringbuffer->ring);
+  ringbuffer->ring = g_malloc (ring_frames * bpf);
+
+  /* the silence of one segment, it is also what a short read is padded
+   * with */
+  g_free (ringbuffer->silence);
+  ringbuffer->silence = g_malloc (ring_frames * bpf);
+  for (i = 0; i < ring_frames * bpf; i++)
+    ringbuffer->silence[i] = spec.silence_sample[i % MIN (bpf, 32)];
+
+  gst_caps_replace (&ringbuffer->caps, caps);
 
-  /* calculate actual latency and buffer times. 
-   * FIXME: In 0.11, store the latency_time internally in ns */
-  spec->latency_time = gst_util_uint64_scale (spec->segsize,
-      (GST_SECOND / GST_USECOND), spec->rate * spec->bytes_per_sample);
+  GST_OBJECT_LOCK (ringbuffer);
+  ringbuffer->latency = gst_util_uint64_scale_int (ringbuffer->low_frames,
+      GST_SECOND, spec.rate);
+  GST_OBJECT_UNLOCK (ringbuffer);
 
-  spec->buffer_time = spec->segtotal * spec->latency_time;
+  gst_audio_ringbuffer_reset (ringbuffer);
+  gst_audio_ringbuffer_unblock_readers (ringbuffer);
 
-  gst_ring_buffer_debug_spec_buff (spec);
+  GST_DEBUG_OBJECT (ringbuffer, "%u frames of %u bytes, segments of %u, "
+      "watermarks %u and %u", ringbuffer->buffer_frames, bpf,
+      ringbuffer->segment_frames, ringbuffer->low_frames,
+      ringbuffer->high_frames);
 
   return TRUE;
 
@@ -475,11 +803,6 @@ parse_error:
         (NULL), ("cannot parse audio format."));
     return FALSE;
   }
-acquire_error:
-  {
-    GST_DEBUG_OBJECT (ringbuffer, "could not acquire ringbuffer");
-    return FALSE;
-  }
 }
 
 static GstFlowReturn
@@ -511,12 +834,31 @@ gst_audio_ringbuffer_handle_sink_event (GstPad * pad, GstEvent * event)
     case GST_EVENT_FLUSH_START:
     {
       GST_LOG_OBJECT (ringbuffer, "received flush start event");
+      g_atomic_int_set (&ringbuffer->flushing, TRUE);
+      gst_audio_ringbuffer_wake_all (ringbuffer);
+      if (forward) {
+        gst_pad_push_event (ringbuffer->srcpad, event);
+        event = NULL;
+      }
+      if (ringbuffer->pushing)
+        gst_pad_pause_task (ringbuffer->srcpad);
       break;
     }
     case GST_EVENT_FLUSH_STOP:
     {
-      ringbuffer->is_eos = FALSE;
       GST_LOG_OBJECT (ringbuffer, "received flush stop event");
+      gst_audio_ringbuffer_block_readers (ringbuffer);
+      gst_audio_ringbuffer_reset (ringbuffer);
+      g_atomic_int_set (&ringbuffer->srcresult, GST_FLOW_OK);
+      g_atomic_int_set (&ringbuffer->flushing, FALSE);
+      gst_audio_ringbuffer_unblock_readers (ringbuffer);
+      if (forward) {
+        gst_pad_push_event (ringbuffer->srcpad, event);
+        event = NULL;
+      }
+      if (ringbuffer->pushing && !ringbuffer->pulling)
+        gst_pad_start_task (ringbuffer->srcpad,
+            (GstTaskFunction) gst_audio_ringbuffer_loop, ringbuffer->srcpad);
       break;
     }
     case GST_EVENT_NEWSEGMENT:
@@ -531,15 +873,23 @@ gst_audio_ringbuffer_handle_sink_event (GstPad * pad, GstEvent * event)
 
       gst_segment_set_newsegment_full (&ringbuffer->sink_segment, update, rate,
           arate, format, start, stop, time);
+
+      /* the loop pushes a segment in running time */
+      if (ringbuffer->pushing && !ringbuffer->pulling)
+        forward = FALSE;
       break;
     }
     case GST_EVENT_EOS:
-      ringbuffer->is_eos = TRUE;
+      g_atomic_int_set (&ringbuffer->is_eos, TRUE);
+      gst_audio_ringbuffer_wake (ringbuffer, &ringbuffer->consumer_waiting);
+      /* the loop pushes it once the ring is drained */
+      if (ringbuffer->pushing && !ringbuffer->pulling)
+        forward = FALSE;
       break;
     default:
       break;
   }
-  if (forward) {
+  if (forward && event) {
     gst_pad_push_event (ringbuffer->srcpad, event);
   } else {
     if (event)
@@ -548,204 +898,133 @@ gst_audio_ringbuffer_handle_sink_event (GstPad * pad, GstEvent * event)
   return TRUE;
 }
 
-#define DIFF_TOLERANCE  2
-
 static GstFlowReturn
 gst_audio_ringbuffer_render (GstAudioRingbuffer * ringbuffer, GstBuffer * buf)
 {
-  GstRingBuffer *rbuf;
-  gint bps, accum;
-  guint size;
-  guint samples, written, out_samples;
-  gint64 diff, align, ctime, cstop;
+  guint bpf, size, samples;
+  gint64 diff, ctime, cstop;
   guint8 *data;
-  guint64 in_offset;
-  GstClockTime time, stop, render_start, render_stop, sample_offset;
-  gboolean align_next;
-
-  rbuf = ringbuffer->buffer;
+  GstClockTime time, stop, render_start;
+  GstFlowReturn ret;
 
-  /* can't do anything when we don't have the device */
-  if (G_UNLIKELY (!gst_ring_buffer_is_acquired (rbuf)))
+  /* can't do anything when we don't have the format */
+  if (G_UNLIKELY (ringbuffer->ring == NULL))
     goto wrong_state;
 
-  bps = rbuf->spec.bytes_per_sample;
+  ret = g_atomic_int_get (&ringbuffer->srcresult);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    goto out_flow;
+
+  bpf = ringbuffer->bpf;
 
   size = GST_BUFFER_SIZE (buf);
-  if (G_UNLIKELY (size % bps) != 0)
+  if (G_UNLIKELY (size % bpf) != 0)
     goto wrong_size;
 
-  samples = size / bps;
-  out_samples = samples;
-
-  in_offset = GST_BUFFER_OFFSET (buf);
-  time = GST_BUFFER_TIMESTAMP (buf);
-
-  GST_DEBUG_OBJECT (ringbuffer,
-      "time %" GST_TIME_FORMAT ", offset %llu, start %" GST_TIME_FORMAT
-      ", samples %u", GST_TIME_ARGS (time), in_offset,
-      GST_TIME_ARGS (ringbuffer->sink_segment.start), samples);
-
+  samples = size / bpf;
   data = GST_BUFFER_DATA (buf);
-
-  stop = time + gst_util_uint64_scale_int (samples, GST_SECOND,
-      rbuf->spec.rate);
-
-  if (!gst_segment_clip (&ringbuffer->sink_segment, GST_FORMAT_TIME, time, stop,
-          &ctime, &cstop))
-    goto out_of_segment;
-
-  /* see if some clipping happened */
-  diff = ctime - time;
-  if (diff > 0) {
-    /* bring clipped time to samples */
-    diff = gst_util_uint64_scale_int (diff, rbuf->spec.rate, GST_SECOND);
-    GST_DEBUG_OBJECT (ringbuffer, "clipping start to %" GST_TIME_FORMAT " %"
-        G_GUINT64_FORMAT " samples", GST_TIME_ARGS (ctime), diff);
-    samples -= diff;
-    data += diff * bps;
-    time = ctime;
-  }
-  diff = stop - cstop;
-  if (diff > 0) {
-    /* bring clipped time to samples */
-    diff = gst_util_uint64_scale_int (diff, rbuf->spec.rate, GST_SECOND);
-    GST_DEBUG_OBJECT (ringbuffer, "clipping stop to %" GST_TIME_FORMAT " %"
-        G_GUINT64_FORMAT " samples", GST_TIME_ARGS (cstop), diff);
-    samples -= diff;
-    stop = cstop;
-  }
-
-  /* bring buffer start and stop times to running time */
-  render_start =
-      gst_segment_to_running_time (&ringbuffer->sink_segment, GST_FORMAT_TIME,
-      time);
-  render_stop =
-      gst_segment_to_running_time (&ringbuffer->sink_segment, GST_FORMAT_TIME,
-      stop);
+  time = GST_BUFFER_TIMESTAMP (buf);
 
   GST_DEBUG_OBJECT (ringbuffer,
-      "running: start %" GST_TIME_FORMAT " - stop %" GST_TIME_FORMAT,
-      GST_TIME_ARGS (render_start), GST_TIME_ARGS (render_stop));
-
-  /* and bring the time to the rate corrected offset in the buffer */
-  render_start = gst_util_uint64_scale_int (render_start,
-      rbuf->spec.rate, GST_SECOND);
-  render_stop = gst_util_uint64_scale_int (render_stop,
-      rbuf->spec.rate, GST_SECOND);
-
-  /* positive playback rate, first sample is render_start, negative rate, first
-   * sample is render_stop. When no rate conversion is active, render exactly
-   * the amount of input samples to avoid aligning to rounding errors. */
-  if (ringbuffer->sink_segment.rate >= 0.0) {
-    sample_offset = render_start;
-    if (ringbuffer->sink_segment.rate == 1.0)
-      render_stop = sample_offset + samples;
-  } else {
-    sample_offset = render_stop;
-    if (ringbuffer->sink_segment.rate == -1.0)
-      render_start = sample_offset + samples;
-  }
-
-  /* always resync after a discont */
-  if (G_UNLIKELY (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DISCONT))) {
-    GST_DEBUG_OBJECT (ringbuffer, "resync after discont");
-    goto no_align;
-  }
+      "time %" GST_TIME_FORMAT ", start %" GST_TIME_FORMAT ", samples %u",
+      GST_TIME_ARGS (time), GST_TIME_ARGS (ringbuffer->sink_segment.start),
+      samples);
+
+  if (GST_CLOCK_TIME_IS_VALID (time)) {
+    stop = time + gst_util_uint64_scale_int (samples, GST_SECOND,
+        ringbuffer->spec.rate);
+
+    if (!gst_segment_clip (&ringbuffer->sink_segment, GST_FORMAT_TIME, time,
+            stop, &ctime, &cstop))
+      goto out_of_segment;
+
+    /* see if some clipping happened */
+    diff = ctime - time;
+    if (diff > 0) {
+      /* bring clipped time to samples */
+      diff = gst_util_uint64_scale_int (diff, ringbuffer->spec.rate,
+          GST_SECOND);
+      GST_DEBUG_OBJECT (ringbuffer, "clipping start to %" GST_TIME_FORMAT " %"
+          G_GUINT64_FORMAT " samples", GST_TIME_ARGS (ctime), diff);
+      samples -= MIN (diff, samples);
+      data += diff * bpf;
+      time = ctime;
+    }
+    diff = stop - cstop;
+    if (diff > 0) {
+      /* bring clipped time to samples */
+      diff = gst_util_uint64_scale_int (diff, ringbuffer->spec.rate,
+          GST_SECOND);
+      GST_DEBUG_OBJECT (ringbuffer, "clipping stop to %" GST_TIME_FORMAT " %"
+          G_GUINT64_FORMAT " samples", GST_TIME_ARGS (cstop), diff);
+      samples -= MIN (diff, samples);
+    }
 
-  /* resync when we don't know what to align the sample with */
-  if (G_UNLIKELY (ringbuffer->next_sample == -1)) {
-    GST_DEBUG_OBJECT (ringbuffer,
-        "no align possible: no previous sample position known");
-    goto no_align;
+    /* bring buffer start to running time and then to samples */
+    render_start =
+        gst_segment_to_running_time (&ringbuffer->sink_segment,
+        GST_FORMAT_TIME, time);
+    if (ringbuffer->next_sample == -1)
+      ringbuffer->first_time = render_start;
+    render_start = gst_util_uint64_scale_int (render_start,
+        ringbuffer->spec.rate, GST_SECOND);
+
+    /* keep the timeline across gaps in the input, the consumer timestamps
+     * the output by counting samples */
+    if (ringbuffer->next_sample != -1 &&
+        GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DISCONT) &&
+        render_start > ringbuffer->next_sample) {
+      guint gap = MIN (render_start - ringbuffer->next_sample,
+          ringbuffer->buffer_frames);
+
+      GST_DEBUG_OBJECT (ringbuffer, "filling gap of %u samples", gap);
+      while (gap > 0) {
+        guint fill, n;
+
+        fill = gst_audio_ringbuffer_fill (ringbuffer);
+        n = MIN (gap, ringbuffer->buffer_frames - MIN (fill,
+                ringbuffer->buffer_frames));
+        if (n == 0) {
+          gst_audio_ringbuffer_wait_space (ringbuffer,
+              ringbuffer->buffer_frames - 1);
+          if (g_atomic_int_get (&ringbuffer->flushing))
+            goto flushing;
+          continue;
+        }
+        gst_audio_ringbuffer_ring_write (ringbuffer, NULL, n);
+        gap -= n;
+      }
+    }
+    ringbuffer->next_sample = render_start + samples;
+  } else if (ringbuffer->next_sample == -1) {
+    ringbuffer->next_sample = 0;
   }
 
-  /* now try to align the sample to the previous one, first see how big the
-   * difference is. */
-  if (sample_offset >= ringbuffer->next_sample)
-    diff = sample_offset - ringbuffer->next_sample;
-  else
-    diff = ringbuffer->next_sample - sample_offset;
-
-  /* we tollerate half a second diff before we start resyncing. This
-   * should be enough to compensate for various rounding errors in the timestamp
-   * and sample offset position. We always resync if we got a discont anyway and
-   * non-discont should be aligned by definition. */
-  if (G_LIKELY (diff < rbuf->spec.rate / DIFF_TOLERANCE)) {
-    /* calc align with previous sample */
-    align = ringbuffer->next_sample - sample_offset;
-    GST_DEBUG_OBJECT (ringbuffer,
-        "align with prev sample, ABS (%" G_GINT64_FORMAT ") < %d", align,
-        rbuf->spec.rate / DIFF_TOLERANCE);
-  } else {
-    /* bring sample diff to seconds for error message */
-    diff = gst_util_uint64_scale_int (diff, GST_SECOND, rbuf->spec.rate);
-    /* timestamps drifted apart from previous samples too much, we need to
-     * resync. We log this as an element warning. */
-    GST_ELEMENT_WARNING (ringbuffer, CORE, CLOCK,
-        ("Compensating for audio synchronisation problems"),
-        ("Unexpected discontinuity in audio timestamps of more "
-            "than half a second (%" GST_TIME_FORMAT "), resyncing",
-            GST_TIME_ARGS (diff)));
-    align = 0;
-  }
-  ringbuffer->last_align = align;
-
-  /* apply alignment */
-  render_start += align;
-  render_stop += align;
-
-no_align:
-  /* number of target samples is difference between start and stop */
-  out_samples = render_stop - render_start;
-
-  /* we render the first or last sample first, depending on the rate */
-  if (ringbuffer->sink_segment.rate >= 0.0)
-    sample_offset = render_start;
-  else
-    sample_offset = render_stop;
-
-  GST_DEBUG_OBJECT (ringbuffer, "rendering at %" G_GUINT64_FORMAT " %d/%d",
-      sample_offset, samples, out_samples);
-
-  /* we need to accumulate over different runs for when we get interrupted */
-  accum = 0;
-  align_next = TRUE;
-  do {
-    written =
-        gst_ring_buffer_commit_full (rbuf, &sample_offset, data, samples,
-        out_samples, &accum);
-
-    GST_DEBUG_OBJECT (ringbuffer, "wrote %u of %u", written, samples);
-    /* if we wrote all, we're done */
-    if (written == samples)
-      break;
+  while (samples > 0) {
+    guint fill, limit, space, n;
 
-    GST_OBJECT_LOCK (ringbuffer);
-    if (ringbuffer->flushing)
+    if (g_atomic_int_get (&ringbuffer->flushing))
       goto flushing;
-    GST_OBJECT_UNLOCK (ringbuffer);
-
-    /* if we got interrupted, we cannot assume that the next sample should
-     * be aligned to this one */
-    align_next = FALSE;
 
-    samples -= written;
-    data += written * bps;
-  } while (TRUE);
+    if (ringbuffer->overrun_policy == GST_AUDIO_RINGBUFFER_OVERRUN_DROP)
+      limit = ringbuffer->high_frames;
+    else
+      limit = ringbuffer->buffer_frames;
 
-  if (align_next)
-    ringbuffer->next_sample = sample_offset;
-  else
-    ringbuffer->next_sample = -1;
+    fill = gst_audio_ringbuffer_fill (ringbuffer);
+    space = fill < limit ? limit - fill : 0;
 
-  GST_DEBUG_OBJECT (ringbuffer, "next sample expected at %" G_GUINT64_FORMAT,
-      ringbuffer->next_sample);
+    if (space == 0) {
+      if (ringbuffer->overrun_policy != GST_AUDIO_RINGBUFFER_OVERRUN_BLOCK)
+        goto overrun;
+      gst_audio_ringbuffer_wait_space (ringbuffer, limit - 1);
+      continue;
+    }
 
-  if (GST_CLOCK_TIME_IS_VALID (stop) && stop >= ringbuffer->sink_segment.stop) {
-    GST_DEBUG_OBJECT (ringbuffer,
-        "start playback because we are at the end of segment");
-    gst_ring_buffer_start (rbuf);
+    n = MIN (space, samples);
+    gst_audio_ringbuffer_ring_write (ringbuffer, data, n);
+    data += n * bpf;
+    samples -= n;
   }
 
   return GST_FLOW_OK;
@@ -759,6 +1038,18 @@ out_of_segment:
         GST_TIME_ARGS (ringbuffer->sink_segment.start));
     return GST_FLOW_OK;
   }
+overrun:
+  {
+    GST_DEBUG_OBJECT (ringbuffer, "overrun, dropping %u samples", samples);
+    g_atomic_int_inc (&ringbuffer->overruns);
+    return GST_FLOW_OK;
+  }
+out_flow:
+  {
+    GST_DEBUG_OBJECT (ringbuffer, "consumer stopped with %s",
+        gst_flow_get_name (ret));
+    return ret;
+  }
   /* ERRORS */
 wrong_state:
   {
@@ -777,7 +1068,6 @@ wrong_size:
 flushing:
   {
     GST_DEBUG_OBJECT (ringbuffer, "ringbuffer is flushing");
-    GST_OBJECT_UNLOCK (ringbuffer);
     return GST_FLOW_WRONG_STATE;
   }
 }
@@ -790,15 +1080,336 @@ gst_audio_ringbuffer_chain (GstPad * pad, GstBuffer * buffer)
 
   ringbuffer = GST_AUDIO_RINGBUFFER (GST_OBJECT_PARENT (pad));
 
-  if (ringbuffer->pushing) {
-    GST_DEBUG_OBJECT (ringbuffer, "proxy pushing buffer");
-    res = gst_pad_push (ringbuffer->srcpad, buffer);
+  GST_DEBUG_OBJECT (ringbuffer, "render buffer in ringbuffer");
+  res = gst_audio_ringbuffer_render (ringbuffer, buffer);
+  gst_buffer_unref (buffer);
+
+  return res;
+}
+
+/* resamples @in_frames frames to @out_frames with the first and the last
+ * frames lined up, linearly for native 16 bit and float samples, by picking
+ * the nearest frame otherwise */
+static void
+gst_audio_ringbuffer_stretch (GstAudioRingbuffer * ringbuffer,
+    const guint8 * in, guint in_frames, guint8 * out, guint out_frames)
+{
+  GstBufferFormat s16, f32;
+  gint channels = ringbuffer->spec.channels;
+  guint bpf = ringbuffer->bpf;
+  guint i, idx;
+  gint c;
+
+  if (G_BYTE_ORDER == G_LITTLE_ENDIAN) {
+    s16 = GST_S16_LE;
+    f32 = GST_FLOAT32_LE;
   } else {
-    GST_DEBUG_OBJECT (ringbuffer, "render buffer in ringbuffer");
-    res = gst_audio_ringbuffer_render (ringbuffer, buffer);
+    s16 = GST_S16_BE;
+    f32 = GST_FLOAT32_BE;
   }
 
-  return res;
+  for (i = 0; i < out_frames; i++) {
+    gdouble pos, frac;
+
+    pos = out_frames > 1 ?
+        (gdouble) i * (in_frames - 1) / (out_frames - 1) : 0.0;
+    idx = (guint) pos;
+    frac = pos - idx;
+    if (idx + 1 >= in_frames) {
+      idx = in_frames - 1;
+      frac = 0.0;
+    }
+
+    if (ringbuffer->spec.format == s16) {
+      const gint16 *a = (const gint16 *) (in + idx * bpf);
+      const gint16 *b = frac > 0.0 ? a + channels : a;
+      gint16 *o = (gint16 *) (out + i * bpf);
+
+      for (c = 0; c < channels; c++) {
+        gdouble v = a[c] + frac * (b[c] - a[c]);
+
+        /* round to nearest, a plain cast truncates towards zero */
+        o[c] = (gint16) (v < 0.0 ? v - 0.5 : v + 0.5);
+      }
+    } else if (ringbuffer->spec.format == f32) {
+      const gfloat *a = (const gfloat *) (in + idx * bpf);
+      const gfloat *b = frac > 0.0 ? a + channels : a;
+      gfloat *o = (gfloat *) (out + i * bpf);
+
+      for (c = 0; c < channels; c++)
+        o[c] = a[c] + frac * (b[c] - a[c]);
+    } else {
+      memcpy (out + i * bpf, in + (frac < 0.5 ? idx : idx + 1) * bpf, bpf);
+    }
+  }
+}
+
+static void
+gst_audio_ringbuffer_update_latency (GstAudioRingbuffer * ringbuffer,
+    guint fill)
+{
+  GstClockTime latency, segment;
+  gboolean changed;
+
+  latency = gst_util_uint64_scale_int (fill, GST_SECOND,
+      ringbuffer->spec.rate);
+  segment = gst_util_uint64_scale_int (ringbuffer->segment_frames,
+      GST_SECOND, ringbuffer->spec.rate);
+
+  GST_OBJECT_LOCK (ringbuffer);
+  changed = latency > ringbuffer->latency + segment ||
+      latency + segment < ringbuffer->latency;
+  if (changed)
+    ringbuffer->latency = latency;
+  GST_OBJECT_UNLOCK (ringbuffer);
+
+  if (changed) {
+    GST_DEBUG_OBJECT (ringbuffer, "latency now %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (latency));
+    gst_element_post_message (GST_ELEMENT_CAST (ringbuffer),
+        gst_message_new_latency (GST_OBJECT_CAST (ringbuffer)));
+  }
+}
+
+/* consumer side, fills @dest with @frames frames.  @deadline is when the
+ * data must be there, or NULL to wait as long as it takes.  Returns the
+ * number of frames, which is only less than @frames at the end of the
+ * stream or before new caps, or -1 when the ring is flushed or replaced and
+ * the caller has to try again. */
+static gint
+gst_audio_ringbuffer_drain (GstAudioRingbuffer * ringbuffer, guint8 * dest,
+    guint frames, const GTimeVal * deadline)
+{
+  guint fill, in_frames, got, bucket, delta;
+  gboolean in_time;
+
+  for (;;) {
+    if (!ringbuffer->draining) {
+      gst_audio_ringbuffer_wait_fill (ringbuffer,
+          MAX (ringbuffer->low_frames, 1), NULL);
+      if (g_atomic_int_get (&ringbuffer->flushing) ||
+          g_atomic_int_get (&ringbuffer->blocked))
+        return -1;
+
+      ringbuffer->draining = TRUE;
+      gst_audio_ringbuffer_update_latency (ringbuffer,
+          gst_audio_ringbuffer_fill (ringbuffer));
+    }
+
+    fill = gst_audio_ringbuffer_fill (ringbuffer);
+
+    bucket = MIN (fill, ringbuffer->buffer_frames - 1) *
+        FILL_HISTOGRAM_BUCKETS / ringbuffer->buffer_frames;
+    ringbuffer->fill_histogram[bucket]++;
+
+    /* drain a little faster or slower to get back between the watermarks */
+    in_frames = frames;
+    delta = (frames + STRETCH_DIV - 1) / STRETCH_DIV;
+    if (ringbuffer->overrun_policy == GST_AUDIO_RINGBUFFER_OVERRUN_STRETCH &&
+        fill > ringbuffer->high_frames)
+      in_frames = frames + delta;
+    else if (ringbuffer->underrun_policy ==
+        GST_AUDIO_RINGBUFFER_UNDERRUN_STRETCH &&
+        fill < ringbuffer->low_frames && frames > delta)
+      in_frames = frames - delta;
+
+    in_time = gst_audio_ringbuffer_wait_fill (ringbuffer, in_frames, deadline);
+    if (g_atomic_int_get (&ringbuffer->flushing) ||
+        g_atomic_int_get (&ringbuffer->blocked))
+      return -1;
+
+    fill = gst_audio_ringbuffer_fill (ringbuffer);
+    got = MIN (fill, in_frames);
+    if (got == in_frames || in_time)
+      break;
+
+    g_atomic_int_inc (&ringbuffer->underruns);
+    GST_DEBUG_OBJECT (ringbuffer, "underrun, %u of %u frames", got, in_frames);
+
+    if (ringbuffer->underrun_policy != GST_AUDIO_RINGBUFFER_UNDERRUN_WAIT) {
+      /* pad with silence, the late samples are played after it.  When
+       * stretching we may have more than @frames but less than @in_frames */
+      got = MIN (got, frames);
+      gst_audio_ringbuffer_ring_read (ringbuffer, dest, got);
+      memcpy (dest + got * ringbuffer->bpf, ringbuffer->silence,
+          (frames - got) * ringbuffer->bpf);
+      return frames;
+    }
+
+    /* build up the low watermark again, the deadline is gone with it */
+    ringbuffer->draining = FALSE;
+    deadline = NULL;
+  }
+
+  if (got < in_frames) {
+    /* end of stream or new caps, drain what is left as it is */
+    got = MIN (got, frames);
+    if (got == 0 && g_atomic_int_get (&ringbuffer->changing_caps))
+      return -1;
+    gst_audio_ringbuffer_ring_read (ringbuffer, dest, got);
+    return got;
+  }
+
+  if (in_frames == frames) {
+    gst_audio_ringbuffer_ring_read (ringbuffer, dest, frames);
+  } else {
+    if (ringbuffer->scratch_size < in_frames * ringbuffer->bpf) {
+      ringbuffer->scratch_size = in_frames * ringbuffer->bpf;
+      ringbuffer->scratch = g_realloc (ringbuffer->scratch,
+          ringbuffer->scratch_size);
+    }
+    gst_audio_ringbuffer_ring_read (ringbuffer, ringbuffer->scratch,
+        in_frames);
+    gst_audio_ringbuffer_stretch (ringbuffer, ringbuffer->scratch, in_frames,
+        dest, frames);
+  }
+
+  return frames;
+}
+
+/* the clock time at which the sample at running time @running_time has to
+ * leave, converted to the system time that GCond waits on */
+static gboolean
+gst_audio_ringbuffer_get_deadline (GstAudioRingbuffer * ringbuffer,
+    GstClockTime running_time, GTimeVal * deadline)
+{
+  GstClock *clock;
+  GstClockTime base_time, latency, now, target;
+
+  GST_OBJECT_LOCK (ringbuffer);
+  if (GST_STATE (ringbuffer) != GST_STATE_PLAYING ||
+      (clock = GST_ELEMENT_CLOCK (ringbuffer)) == NULL) {
+    GST_OBJECT_UNLOCK (ringbuffer);
+    return FALSE;
+  }
+  gst_object_ref (clock);
+  base_time = GST_ELEMENT_CAST (ringbuffer)->base_time;
+  latency = ringbuffer->latency;
+  GST_OBJECT_UNLOCK (ringbuffer);
+
+  now = gst_clock_get_time (clock);
+  gst_object_unref (clock);
+
+  target = base_time + running_time + latency;
+  g_get_current_time (deadline);
+  if (target > now)
+    g_time_val_add (deadline, (target - now) / GST_USECOND);
+
+  return TRUE;
+}
+
+/* pushes the ring out a segment at a time when downstream does not pull */
+static void
+gst_audio_ringbuffer_loop (GstPad * pad)
+{
+  GstAudioRingbuffer *ringbuffer;
+  GstBuffer *buf;
+  GstClockTime timestamp;
+  GTimeVal deadline;
+  gboolean have_deadline;
+  GstFlowReturn ret;
+  gint frames;
+
+  ringbuffer = GST_AUDIO_RINGBUFFER (GST_PAD_PARENT (pad));
+
+  if (g_atomic_int_get (&ringbuffer->flushing))
+    goto flushing;
+
+  if (!gst_audio_ringbuffer_reader_enter (ringbuffer))
+    return;
+
+  if (G_UNLIKELY (ringbuffer->ring == NULL)) {
+    /* not negotiated yet, wake up for the first data or the end */
+    gst_audio_ringbuffer_wait_fill (ringbuffer, 1, NULL);
+    gst_audio_ringbuffer_reader_leave (ringbuffer);
+    if (g_atomic_int_get (&ringbuffer->is_eos) && ringbuffer->ring == NULL)
+      goto eos;
+    return;
+  }
+
+  if (ringbuffer->need_newsegment) {
+    GST_DEBUG_OBJECT (ringbuffer, "pushing newsegment");
+    gst_pad_push_event (pad, gst_event_new_new_segment (FALSE, 1.0,
+            GST_FORMAT_TIME, 0, -1, 0));
+    ringbuffer->need_newsegment = FALSE;
+  }
+
+  timestamp = ringbuffer->first_time +
+      gst_util_uint64_scale_int (ringbuffer->out_offset, GST_SECOND,
+      ringbuffer->spec.rate);
+  have_deadline =
+      gst_audio_ringbuffer_get_deadline (ringbuffer, timestamp, &deadline);
+
+  buf = gst_buffer_new_and_alloc (ringbuffer->segment_frames *
+      ringbuffer->bpf);
+  frames = gst_audio_ringbuffer_drain (ringbuffer, GST_BUFFER_DATA (buf),
+      ringbuffer->segment_frames, have_deadline ? &deadline : NULL);
+
+  if (frames <= 0) {
+    gst_buffer_unref (buf);
+    gst_audio_ringbuffer_reader_leave (ringbuffer);
+    if (frames == 0)
+      goto eos;
+    return;
+  }
+
+  /* the ring timestamps first_time and the first sample after a flush */
+  timestamp = ringbuffer->first_time +
+      gst_util_uint64_scale_int (ringbuffer->out_offset, GST_SECOND,
+      ringbuffer->spec.rate);
+  GST_BUFFER_SIZE (buf) = frames * ringbuffer->bpf;
+  GST_BUFFER_TIMESTAMP (buf) = timestamp;
+  GST_BUFFER_OFFSET (buf) = ringbuffer->out_offset;
+  ringbuffer->out_offset += frames;
+  GST_BUFFER_OFFSET_END (buf) = ringbuffer->out_offset;
+  GST_BUFFER_DURATION (buf) = ringbuffer->first_time +
+      gst_util_uint64_scale_int (ringbuffer->out_offset, GST_SECOND,
+      ringbuffer->spec.rate) - timestamp;
+  gst_buffer_set_caps (buf, ringbuffer->caps);
+  if (ringbuffer->discont) {
+    GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DISCONT);
+    ringbuffer->discont = FALSE;
+  }
+
+  gst_audio_ringbuffer_reader_leave (ringbuffer);
+
+  ret = gst_pad_push (pad, buf);
+  if (ret != GST_FLOW_OK)
+    goto pause;
+
+  return;
+
+flushing:
+  {
+    GST_DEBUG_OBJECT (ringbuffer, "we are flushing");
+    gst_pad_pause_task (pad);
+    return;
+  }
+eos:
+  {
+    GST_DEBUG_OBJECT (ringbuffer, "drained, pushing EOS downstream");
+    g_atomic_int_set (&ringbuffer->srcresult, GST_FLOW_UNEXPECTED);
+    gst_pad_pause_task (pad);
+    gst_pad_push_event (pad, gst_event_new_eos ());
+    return;
+  }
+pause:
+  {
+    GST_DEBUG_OBJECT (ringbuffer, "pausing task, reason %s",
+        gst_flow_get_name (ret));
+    g_atomic_int_set (&ringbuffer->srcresult, ret);
+    gst_pad_pause_task (pad);
+    /* wake up the sink side so that it returns the flow upstream */
+    gst_audio_ringbuffer_wake_all (ringbuffer);
+    if (GST_FLOW_IS_FATAL (ret) || ret == GST_FLOW_NOT_LINKED) {
+      GST_ELEMENT_ERROR (ringbuffer, STREAM, FAILED,
+          ("Internal data flow error."),
+          ("streaming task paused, reason %s (%d)", gst_flow_get_name (ret),
+              ret));
+      gst_pad_push_event (pad, gst_event_new_eos ());
+    }
+    return;
+  }
 }
 
 static gboolean
@@ -817,21 +1428,42 @@ static gboolean
 gst_audio_ringbuffer_handle_src_query (GstPad * pad, GstQuery * query)
 {
   GstAudioRingbuffer *ringbuffer;
+  gboolean res;
 
   ringbuffer = GST_AUDIO_RINGBUFFER (GST_PAD_PARENT (pad));
 
   switch (GST_QUERY_TYPE (query)) {
-    case GST_QUERY_POSITION:
-      break;
-    case GST_QUERY_DURATION:
-      break;
-    case GST_QUERY_BUFFERING:
+    case GST_QUERY_LATENCY:
+    {
+      GstClockTime min, max, latency;
+      gboolean live;
+
+      if (!(res = gst_pad_peer_query (ringbuffer->sinkpad, query)))
+        break;
+
+      gst_query_parse_latency (query, &live, &min, &max);
+
+      /* what sits in the ring, and at most all of it */
+      GST_OBJECT_LOCK (ringbuffer);
+      latency = ringbuffer->latency;
+      GST_OBJECT_UNLOCK (ringbuffer);
+
+      GST_DEBUG_OBJECT (ringbuffer, "our latency %" GST_TIME_FORMAT,
+          GST_TIME_ARGS (latency));
+
+      min += latency;
+      if (max != GST_CLOCK_TIME_NONE)
+        max += ringbuffer->buffer_time * GST_USECOND;
+
+      gst_query_set_latency (query, live, min, max);
       break;
+    }
     default:
+      res = gst_pad_peer_query (ringbuffer->sinkpad, query);
       break;
   }
 
-  return TRUE;
+  return res;
 }
 
 static GstFlowReturn
@@ -839,24 +1471,16 @@ gst_audio_ringbuffer_get_range (GstPad * pad, guint64 offset, guint length,
     GstBuffer ** buffer)
 {
   GstAudioRingbuffer *ringbuffer;
-  GstRingBuffer *rbuf;
   GstFlowReturn ret;
 
   ringbuffer = GST_AUDIO_RINGBUFFER_CAST (gst_pad_get_parent (pad));
 
-  rbuf = ringbuffer->buffer;
-
   if (ringbuffer->pulling) {
     GST_DEBUG_OBJECT (ringbuffer, "proxy pulling range");
     ret = gst_pad_pull_range (ringbuffer->sinkpad, offset, length, buffer);
   } else {
-    guint8 *data;
-    guint len;
-    guint64 sample;
-    gint bps, segsize, segtotal, sps;
-    gint sampleslen, segdone;
-    gint readseg, sampleoff;
-    guint8 *dest;
+    GTimeVal now;
+    gint frames = -1;
 
     GST_DEBUG_OBJECT (ringbuffer,
         "pulling data at %" G_GUINT64_FORMAT ", length %u", offset, length);
@@ -866,70 +1490,46 @@ gst_audio_ringbuffer_get_range (GstPad * pad, guint64 offset, guint length,
           ringbuffer->src_segment.last_stop);
     }
 
-    /* first wait till we have something in the ringbuffer and it 
-     * is running */
-    GST_OBJECT_LOCK (ringbuffer);
-    if (ringbuffer->flushing)
-      goto flushing;
-
-    while (ringbuffer->waiting) {
-      GST_DEBUG_OBJECT (ringbuffer, "waiting for unlock");
-      g_cond_wait (ringbuffer->cond, GST_OBJECT_GET_LOCK (ringbuffer));
-      GST_DEBUG_OBJECT (ringbuffer, "unlocked");
-
-      if (ringbuffer->flushing)
+    do {
+      if (g_atomic_int_get (&ringbuffer->flushing))
         goto flushing;
-    }
-    GST_OBJECT_UNLOCK (ringbuffer);
-
-    bps = rbuf->spec.bytes_per_sample;
 
-    if (G_UNLIKELY (length % bps) != 0)
-      goto wrong_size;
+      if (!gst_audio_ringbuffer_reader_enter (ringbuffer))
+        continue;
 
-    segsize = rbuf->spec.segsize;
-    segtotal = rbuf->spec.segtotal;
-    sps = rbuf->samples_per_seg;
-    dest = GST_BUFFER_DATA (rbuf->data);
-
-    sample = offset / bps;
-    len = length / bps;
-
-    *buffer = gst_buffer_new_and_alloc (length);
-    data = GST_BUFFER_DATA (*buffer);
-
-    while (len) {
-      gint diff;
-
-      /* figure out the segment and the offset inside the segment where
-       * the sample should be read from. */
-      readseg = sample / sps;
-      sampleoff = (sample % sps);
-
-      segdone = g_atomic_int_get (&rbuf->segdone) - rbuf->segbase;
-
-      diff = readseg - segdone;
-
-      /* we can read now */
-      readseg = readseg % segtotal;
-      sampleslen = MIN (sps - sampleoff, len);
-
-      GST_DEBUG_OBJECT (ringbuffer,
-          "read @%p seg %d, off %d, sampleslen %d, diff %d",
-          dest + readseg * segsize, readseg, sampleoff, sampleslen, diff);
+      if (G_UNLIKELY (ringbuffer->ring == NULL)) {
+        gst_audio_ringbuffer_wait_fill (ringbuffer, 1, NULL);
+        gst_audio_ringbuffer_reader_leave (ringbuffer);
+        if (g_atomic_int_get (&ringbuffer->is_eos) && ringbuffer->ring == NULL)
+          goto eos;
+        continue;
+      }
 
-      memcpy (data, dest + (readseg * segsize) + (sampleoff * bps),
-          (sampleslen * bps));
+      if (G_UNLIKELY (length % ringbuffer->bpf) != 0) {
+        gst_audio_ringbuffer_reader_leave (ringbuffer);
+        goto wrong_size;
+      }
 
-      if (diff > 0)
-        gst_ring_buffer_advance (rbuf, diff);
+      /* downstream pulls when it needs the data */
+      *buffer = gst_buffer_new_and_alloc (length);
+      g_get_current_time (&now);
+      frames = gst_audio_ringbuffer_drain (ringbuffer,
+          GST_BUFFER_DATA (*buffer), length / ringbuffer->bpf, &now);
+      if (frames > 0) {
+        GST_BUFFER_SIZE (*buffer) = frames * ringbuffer->bpf;
+        gst_buffer_set_caps (*buffer, ringbuffer->caps);
+      } else {
+        gst_buffer_unref (*buffer);
+        *buffer = NULL;
+      }
+      gst_audio_ringbuffer_reader_leave (ringbuffer);
 
-      len -= sampleslen;
-      sample += sampleslen;
-      data += sampleslen * bps;
-    }
+      if (frames == 0)
+        goto eos;
+    } while (frames < 0);
 
-    ringbuffer->src_segment.last_stop += length;
+    GST_BUFFER_OFFSET (*buffer) = ringbuffer->src_segment.last_stop;
+    ringbuffer->src_segment.last_stop += GST_BUFFER_SIZE (*buffer);
 
     ret = GST_FLOW_OK;
   }
@@ -942,15 +1542,21 @@ gst_audio_ringbuffer_get_range (GstPad * pad, guint64 offset, guint length,
 flushing:
   {
     GST_DEBUG_OBJECT (ringbuffer, "we are flushing");
-    GST_OBJECT_UNLOCK (ringbuffer);
     gst_object_unref (ringbuffer);
     return GST_FLOW_WRONG_STATE;
   }
+eos:
+  {
+    GST_DEBUG_OBJECT (ringbuffer, "drained");
+    gst_object_unref (ringbuffer);
+    return GST_FLOW_UNEXPECTED;
+  }
 wrong_size:
   {
     GST_DEBUG_OBJECT (ringbuffer, "wrong size");
     GST_ELEMENT_ERROR (ringbuffer, STREAM, WRONG_TYPE,
         (NULL), ("asked to pull buffer of wrong size."));
+    gst_object_unref (ringbuffer);
     return GST_FLOW_ERROR;
   }
 }
@@ -977,11 +1583,13 @@ gst_audio_ringbuffer_sink_activate_push (GstPad * pad, gboolean active)
 
   if (active) {
     GST_DEBUG_OBJECT (ringbuffer, "activating push mode");
-    ringbuffer->is_eos = FALSE;
+    g_atomic_int_set (&ringbuffer->is_eos, FALSE);
     ringbuffer->pulling = FALSE;
   } else {
     /* unblock chain function */
     GST_DEBUG_OBJECT (ringbuffer, "deactivating push mode");
+    g_atomic_int_set (&ringbuffer->flushing, TRUE);
+    gst_audio_ringbuffer_wake_all (ringbuffer);
     ringbuffer->pulling = FALSE;
   }
 
@@ -990,8 +1598,7 @@ gst_audio_ringbuffer_sink_activate_push (GstPad * pad, gboolean active)
   return result;
 }
 
-/* src operating in push mode, we will proxy the push from upstream, basically
- * acting as a passthrough element. */
+/* src operating in push mode, a task pushes the ring out */
 static gboolean
 gst_audio_ringbuffer_src_activate_push (GstPad * pad, gboolean active)
 {
@@ -1002,15 +1609,23 @@ gst_audio_ringbuffer_src_activate_push (GstPad * pad, gboolean active)
 
   if (active) {
     GST_DEBUG_OBJECT (ringbuffer, "activating push mode");
-    ringbuffer->is_eos = FALSE;
+    g_atomic_int_set (&ringbuffer->is_eos, FALSE);
+    g_atomic_int_set (&ringbuffer->flushing, FALSE);
+    g_atomic_int_set (&ringbuffer->srcresult, GST_FLOW_OK);
     ringbuffer->pushing = TRUE;
     ringbuffer->pulling = FALSE;
-    result = TRUE;
+    ringbuffer->draining = FALSE;
+    ringbuffer->need_newsegment = TRUE;
+    result = gst_pad_start_task (pad,
+        (GstTaskFunction) gst_audio_ringbuffer_loop, pad);
   } else {
     GST_DEBUG_OBJECT (ringbuffer, "deactivating push mode");
+    g_atomic_int_set (&ringbuffer->flushing, TRUE);
+    g_atomic_int_set (&ringbuffer->srcresult, GST_FLOW_WRONG_STATE);
+    gst_audio_ringbuffer_wake_all (ringbuffer);
+    result = gst_pad_stop_task (pad);
     ringbuffer->pushing = FALSE;
     ringbuffer->pulling = FALSE;
-    result = TRUE;
   }
 
   gst_object_unref (ringbuffer);
@@ -1030,13 +1645,18 @@ gst_audio_ringbuffer_src_activate_pull (GstPad * pad, gboolean active)
   if (active) {
     GST_DEBUG_OBJECT (ringbuffer, "activating pull mode");
 
-    /* try to activate upstream in pull mode as well. If it fails, no problems,
-     * we'll be activated in push mode. Remember that we are pulling-through */
-    ringbuffer->pulling = gst_pad_activate_pull (ringbuffer->sinkpad, active);
-
-    ringbuffer->is_eos = FALSE;
-    ringbuffer->waiting = TRUE;
-    ringbuffer->flushing = FALSE;
+    /* try to activate upstream in pull mode as well. Only ask when upstream
+     * can do it, a failed attempt deactivates our sink pad in push mode as
+     * well. Remember that we are pulling-through */
+    if (gst_pad_check_pull_range (ringbuffer->sinkpad))
+      ringbuffer->pulling = gst_pad_activate_pull (ringbuffer->sinkpad, active);
+    else
+      ringbuffer->pulling = FALSE;
+
+    g_atomic_int_set (&ringbuffer->is_eos, FALSE);
+    g_atomic_int_set (&ringbuffer->flushing, FALSE);
+    g_atomic_int_set (&ringbuffer->srcresult, GST_FLOW_OK);
+    ringbuffer->draining = FALSE;
     gst_segment_init (&ringbuffer->src_segment, GST_FORMAT_BYTES);
     result = TRUE;
   } else {
@@ -1046,8 +1666,8 @@ gst_audio_ringbuffer_src_activate_pull (GstPad * pad, gboolean active)
       gst_pad_activate_pull (ringbuffer->sinkpad, active);
 
     ringbuffer->pulling = FALSE;
-    ringbuffer->waiting = FALSE;
-    ringbuffer->flushing = TRUE;
+    g_atomic_int_set (&ringbuffer->flushing, TRUE);
+    gst_audio_ringbuffer_wake_all (ringbuffer);
     result = TRUE;
   }
   gst_object_unref (ringbuffer);
@@ -1065,29 +1685,16 @@ gst_audio_ringbuffer_change_state (GstElement * element,
   ringbuffer = GST_AUDIO_RINGBUFFER (element);
 
   switch (transition) {
-    case GST_STATE_CHANGE_NULL_TO_READY:
-      if (ringbuffer->buffer == NULL) {
-        ringbuffer->buffer = gst_int_ring_buffer_new ();
-        gst_object_set_parent (GST_OBJECT (ringbuffer->buffer),
-            GST_OBJECT (ringbuffer));
-        gst_ring_buffer_open_device (ringbuffer->buffer);
-      }
-      break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       ringbuffer->next_sample = -1;
-      ringbuffer->last_align = -1;
-      gst_ring_buffer_set_flushing (ringbuffer->buffer, FALSE);
-      gst_ring_buffer_may_start (ringbuffer->buffer, TRUE);
+      g_atomic_int_set (&ringbuffer->overruns, 0);
+      g_atomic_int_set (&ringbuffer->underruns, 0);
+      memset (ringbuffer->fill_histogram, 0,
+          sizeof (ringbuffer->fill_histogram));
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
-      GST_OBJECT_LOCK (ringbuffer);
-      ringbuffer->flushing = TRUE;
-      ringbuffer->waiting = FALSE;
-      g_cond_broadcast (ringbuffer->cond);
-      GST_OBJECT_UNLOCK (ringbuffer);
-
-      gst_ring_buffer_set_flushing (ringbuffer->buffer, TRUE);
-      gst_ring_buffer_may_start (ringbuffer->buffer, FALSE);
+      g_atomic_int_set (&ringbuffer->flushing, TRUE);
+      gst_audio_ringbuffer_wake_all (ringbuffer);
       break;
     default:
       break;
@@ -1098,15 +1705,12 @@ gst_audio_ringbuffer_change_state (GstElement * element,
 
   switch (transition) {
     case GST_STATE_CHANGE_PAUSED_TO_READY:
-      gst_ring_buffer_activate (ringbuffer->buffer, FALSE);
-      gst_ring_buffer_release (ringbuffer->buffer);
-      break;
-    case GST_STATE_CHANGE_READY_TO_NULL:
-      if (ringbuffer->buffer != NULL) {
-        gst_ring_buffer_close_device (ringbuffer->buffer);
-        gst_object_unparent (GST_OBJECT (ringbuffer->buffer));
-        ringbuffer->buffer = NULL;
-      }
+      /* both pads are deactivated, nothing uses the ring anymore */
+      g_free (ringbuffer->ring);
+      ringbuffer->ring = NULL;
+      g_atomic_int_set (&ringbuffer->write_pos, 0);
+      g_atomic_int_set (&ringbuffer->read_pos, 0);
+      gst_caps_replace (&ringbuffer->caps, NULL);
       break;
     default:
       break;
@@ -1123,6 +1727,8 @@ gst_audio_ringbuffer_set_property (GObject * object,
 
   ringbuffer = GST_AUDIO_RINGBUFFER (object);
 
+  /* the sizes and watermarks are used from the next caps on, the policies
+   * right away */
   switch (prop_id) {
     case PROP_BUFFER_TIME:
       ringbuffer->buffer_time = g_value_get_int64 (value);
@@ -1130,6 +1736,18 @@ gst_audio_ringbuffer_set_property (GObject * object,
     case PROP_SEGMENT_TIME:
       ringbuffer->segment_time = g_value_get_int64 (value);
       break;
+    case PROP_LOW_PERCENT:
+      ringbuffer->low_percent = g_value_get_int (value);
+      break;
+    case PROP_HIGH_PERCENT:
+      ringbuffer->high_percent = g_value_get_int (value);
+      break;
+    case PROP_OVERRUN_POLICY:
+      ringbuffer->overrun_policy = g_value_get_enum (value);
+      break;
+    case PROP_UNDERRUN_POLICY:
+      ringbuffer->underrun_policy = g_value_get_enum (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1151,6 +1769,52 @@ gst_audio_ringbuffer_get_property (GObject * object,
     case PROP_SEGMENT_TIME:
       g_value_set_int64 (value, ringbuffer->segment_time);
       break;
+    case PROP_LOW_PERCENT:
+      g_value_set_int (value, ringbuffer->low_percent);
+      break;
+    case PROP_HIGH_PERCENT:
+      g_value_set_int (value, ringbuffer->high_percent);
+      break;
+    case PROP_OVERRUN_POLICY:
+      g_value_set_enum (value, ringbuffer->overrun_policy);
+      break;
+    case PROP_UNDERRUN_POLICY:
+      g_value_set_enum (value, ringbuffer->underrun_policy);
+      break;
+    case PROP_CURRENT_LEVEL_TIME:
+    {
+      guint64 level = 0;
+
+      GST_OBJECT_LOCK (ringbuffer);
+      if (ringbuffer->ring)
+        level = gst_util_uint64_scale_int (gst_audio_ringbuffer_fill
+            (ringbuffer), GST_SECOND, ringbuffer->spec.rate);
+      GST_OBJECT_UNLOCK (ringbuffer);
+      g_value_set_uint64 (value, level);
+      break;
+    }
+    case PROP_OVERRUNS:
+      g_value_set_uint (value, g_atomic_int_get (&ringbuffer->overruns));
+      break;
+    case PROP_UNDERRUNS:
+      g_value_set_uint (value, g_atomic_int_get (&ringbuffer->underruns));
+      break;
+    case PROP_FILL_HISTOGRAM:
+    {
+      GValueArray *array;
+      GValue v = { 0, };
+      gint i;
+
+      array = g_value_array_new (FILL_HISTOGRAM_BUCKETS);
+      g_value_init (&v, G_TYPE_UINT64);
+      for (i = 0; i < FILL_HISTOGRAM_BUCKETS; i++) {
+        g_value_set_uint64 (&v, ringbuffer->fill_histogram[i]);
+        g_value_array_append (array, &v);
+      }
+      g_value_unset (&v);
+      g_value_take_boxed (value, array);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -23,6 +23,7 @@
 
 #include <gst/gst.h>
 
+#include "gstbayerorc.h"
 
 GType gst_bayer2rgb_get_type (void);
 GType gst_rgb2bayer_get_type (void);
@@ -30,6 +31,8 @@ GType gst_rgb2bayer_get_type (void);
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
+  gst_bayer_orc_init ();
+
   gst_element_register (plugin, "bayer2rgb", GST_RANK_NONE,
       gst_bayer2rgb_get_type ());
   gst_element_register (plugin, "rgb2bayer", GST_RANK_NONE,
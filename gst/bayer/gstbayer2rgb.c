@@ -24,19 +24,17 @@
 /**
  * SECTION:element-bayer2rgb
  *
- * Decodes raw camera bayer (fourcc BA81) to RGB.
+ * Decodes raw camera bayer (fourcc BA81) to RGB, or directly to I420 or NV12
+ * to avoid a separate colorspace conversion.
+ *
+ * Besides 8 bit bayer, 16 bit bayer with 9 to 16 significant bits (as
+ * produced by 10 and 12 bit sensors) in native endianness is accepted.
+ * #GstBayer2RGB:method selects between a fast bilinear and a slower, edge-aware
+ * interpolation and #GstBayer2RGB:threads splits every frame into horizontal
+ * slices that are converted in parallel.
  */
 
 /*
- * In order to guard against my advancing maturity, some extra detailed
- * information about the logic of the decode is included here.  Much of
- * this was inspired by a technical paper from siliconimaging.com, which
- * in turn was based upon an article from IEEE,
- * T. Sakamoto, C. Nakanishi and T. Hase,
- * “Software pixel interpolation for digital still cameras suitable for
- *  a 32-bit MCU,”
- * IEEE Trans. Consumer Electronics, vol. 44, no. 4, November 1998.
- *
  * The code assumes a Bayer matrix of the type produced by the fourcc
  * BA81 (v4l2 format SBGGR8) of width w and height h which looks like:
  *       0 1 2 3  w-2 w-1
@@ -48,27 +46,39 @@
  * h-2   B G B G ....B G
  * h-1   G R G R ....G R
  *
+ * The other orders (GBRG, GRBG and RGGB) are the same matrix shifted by one
+ * column and/or one row.
+ *
  * We expand this matrix, producing a separate {r, g, b} triple for each
- * of the individual elements.  The algorithm for doing this expansion is
- * as follows.
+ * of the individual elements.  Every row of the matrix only contains green
+ * and one of red or blue, and rows with red and rows with blue alternate.
+ * Rows and columns outside of the matrix are mirrored from the inside, so
+ * the edges and corners need no special treatment.
  *
- * We are designing for speed of transformation, at a slight expense of code.
- * First, we calculate the appropriate triples for the four corners, the
- * remainder of the top and bottom rows, and the left and right columns.
- * The reason for this is that those elements are transformed slightly
- * differently than all of the remainder of the matrix. Finally, we transform
- * all of the remainder.
+ * The bilinear method first splits every input row into two lines of full
+ * width, one for each colour of the row, by taking the known elements and
+ * averaging the left and right neighbours for the missing ones.  An output
+ * row is then merged from the split lines of the row itself and of the rows
+ * above and below it:
+ *   - the colour of the row itself (red or blue) comes from its own line
+ *   - the other one of red and blue is the average of the rows above and
+ *     below
+ *   - green is the element itself on green elements, and the average of
+ *     the horizontal and the vertical neighbours elsewhere
+ * Both steps work on pairs of columns independently of the type of the
+ * elements, and are implemented as Orc functions.
  *
- * The transformation into the "appropriate triples" is based upon the
- * "nearest neighbor" principal, with some additional complexity for the
- * calculation of the "green" element, where an "adaptive" pairing is used.
+ * The edge-aware method first interpolates the green missing on red and
+ * blue elements along the direction (horizontal or vertical) with the
+ * smaller gradient, corrected by the second derivative of the red or blue
+ * element (J. F. Hamilton and J. E. Adams, "Adaptive color plane
+ * interpolation in single sensor color electronic camera", US patent
+ * 5,629,734).  Red and blue are then interpolated as differences to the
+ * green plane, which avoids most of the colour fringes at edges.
  *
- * For purposes of documentation and indentification, each element of the
- * original array can be put into one of four classes:
- *   R   A red element
- *   B   A blue element
- *   GR  A green element which is followed by a red one
- *   GB  A green element which is followed by a blue one
+ * For I420 and NV12, every pair of rows is converted to Y'CbCr (ITU-R
+ * BT.601) right after it has been interpolated, while it is still in the
+ * cache.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -78,9 +88,10 @@
 #include <gst/gst.h>
 #include <gst/base/gstbasetransform.h>
 #include <gst/video/video.h>
+#include <gst/video/gstbasevideoslices.h>
 #include <string.h>
-#include <stdlib.h>
-#include "_stdint.h"
+
+#include "gstbayerorc.h"
 
 #define GST_CAT_DEFAULT gst_bayer2rgb_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
@@ -93,6 +104,11 @@ enum
   GST_BAYER_2_RGB_FORMAT_RGGB
 };
 
+typedef enum
+{
+  GST_BAYER_2_RGB_METHOD_BILINEAR,
+  GST_BAYER_2_RGB_METHOD_EDGE_AWARE
+} GstBayer2RGBMethod;
 
 #define GST_TYPE_BAYER2RGB            (gst_bayer2rgb_get_type())
 #define GST_BAYER2RGB(obj)            (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_BAYER2RGB,GstBayer2RGB))
@@ -102,8 +118,35 @@ enum
 #define GST_BAYER2RGB_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS((obj) ,GST_TYPE_BAYER2RGB,GstBayer2RGBClass))
 typedef struct _GstBayer2RGB GstBayer2RGB;
 typedef struct _GstBayer2RGBClass GstBayer2RGBClass;
+typedef struct _GstBayer2RGBSlice GstBayer2RGBSlice;
 
-typedef void (*GstBayer2RGBProcessFunc) (GstBayer2RGB *, guint8 *, guint);
+/* a horizontal band of the output frame that is converted by one thread,
+ * together with the lines it caches while doing so */
+struct _GstBayer2RGBSlice
+{
+  GstBayer2RGB *filter;
+  const guint8 *input;
+  guint8 *output;
+  /* range of output rows covered by this slice */
+  gint start, end;
+
+  guint8 *scratch;
+  gint line_size;
+
+  /* input rows converted to 8 bit, split into their two colours and the
+   * interpolated green rows; slot i holds the row in *_row[i] */
+  guint8 *raw[8];
+  gint raw_row[8];
+  guint8 *split[4][2];
+  gint split_row[4];
+  guint8 *green[4];
+  gint green_row[4];
+
+  /* red, green and blue of the last two output rows */
+  const guint8 *rgb[2][3];
+  guint8 *tmp[2][2];
+  guint8 *alpha;
+};
 
 struct _GstBayer2RGB
 {
@@ -113,11 +156,21 @@ struct _GstBayer2RGB
   int width;
   int height;
   int stride;
+  int depth;                    /* significant bits per bayer element */
   int pixsize;                  /* bytes per pixel */
   int r_off;                    /* offset for red */
   int g_off;                    /* offset for green */
   int b_off;                    /* offset for blue */
+  int a_off;                    /* offset for alpha or padding */
   int format;
+  GstVideoFormat yuv_format;    /* I420 or NV12, UNKNOWN for RGB output */
+
+  GstBayer2RGBMethod method;
+  guint threads;                /* 0 is one per CPU */
+
+  /* slice threading, one slice per thread at most */
+  GstBayer2RGBSlice *slices;
+  GstBaseVideoSlices *slice_pool;
 };
 
 struct _GstBayer2RGBClass
@@ -136,16 +189,50 @@ struct _GstBayer2RGBClass
   GST_VIDEO_CAPS_BGRA ";"                        \
   GST_VIDEO_CAPS_ABGR ";"                        \
   GST_VIDEO_CAPS_RGB ";"                         \
-  GST_VIDEO_CAPS_BGR
+  GST_VIDEO_CAPS_BGR ";"                         \
+  GST_VIDEO_CAPS_YUV ("{ I420, NV12 }")
 
 #define SINK_CAPS "video/x-raw-bayer,format=(string){bggr,grbg,gbrg,rggb}," \
+  "width=(int)[1,MAX],height=(int)[1,MAX],framerate=(fraction)[0/1,MAX]; " \
+  "video/x-raw-bayer,format=(string){bggr,grbg,gbrg,rggb}," \
+  "bpp=(int)16,depth=(int)[9,16],endianness=(int)BYTE_ORDER," \
   "width=(int)[1,MAX],height=(int)[1,MAX],framerate=(fraction)[0/1,MAX]"
 
+#define DEFAULT_METHOD GST_BAYER_2_RGB_METHOD_BILINEAR
+#define DEFAULT_THREADS 0
+
+/* minimum number of rows per slice */
+#define MIN_SLICE_ROWS 16
+
+/* raw, split, green, tmp and alpha lines of a slice */
+#define N_SCRATCH_LINES (8 + 4 * 2 + 4 + 2 * 2 + 1)
+
 enum
 {
-  PROP_0
+  PROP_0,
+  PROP_METHOD,
+  PROP_THREADS
 };
 
+#define GST_TYPE_BAYER2RGB_METHOD (gst_bayer2rgb_method_get_type ())
+static GType
+gst_bayer2rgb_method_get_type (void)
+{
+  static GType method_type = 0;
+  static const GEnumValue methods[] = {
+    {GST_BAYER_2_RGB_METHOD_BILINEAR, "Bilinear interpolation", "bilinear"},
+    {GST_BAYER_2_RGB_METHOD_EDGE_AWARE,
+          "Edge-aware interpolation (slower, fewer colour fringes)",
+        "edge-aware"},
+    {0, NULL, NULL},
+  };
+
+  if (!method_type) {
+    method_type = g_enum_register_static ("GstBayer2RGBMethod", methods);
+  }
+  return method_type;
+}
+
 #define DEBUG_INIT(bla) \
   GST_DEBUG_CATEGORY_INIT (gst_bayer2rgb_debug, "bayer2rgb", 0, "bayer2rgb element");
 
@@ -157,6 +244,7 @@ static void gst_bayer2rgb_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static void gst_bayer2rgb_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec);
+static void gst_bayer2rgb_finalize (GObject * object);
 
 static gboolean gst_bayer2rgb_set_caps (GstBaseTransform * filter,
     GstCaps * incaps, GstCaps * outcaps);
@@ -167,6 +255,7 @@ static GstCaps *gst_bayer2rgb_transform_caps (GstBaseTransform * base,
     GstPadDirection direction, GstCaps * caps);
 static gboolean gst_bayer2rgb_get_unit_size (GstBaseTransform * base,
     GstCaps * caps, guint * size);
+static void gst_bayer2rgb_slice_func (gpointer data, gpointer user_data);
 
 
 static void
@@ -176,7 +265,7 @@ gst_bayer2rgb_base_init (gpointer klass)
 
   gst_element_class_set_details_simple (element_class,
       "Bayer to RGB decoder for cameras", "Filter/Converter/Video",
-      "Converts video/x-raw-bayer to video/x-raw-rgb",
+      "Converts video/x-raw-bayer to video/x-raw-rgb or video/x-raw-yuv",
       "William Brack <wbrack@mmm.com.hk>");
 
   gst_element_class_add_pad_template (element_class,
@@ -195,6 +284,14 @@ gst_bayer2rgb_class_init (GstBayer2RGBClass * klass)
   gobject_class = (GObjectClass *) klass;
   gobject_class->set_property = gst_bayer2rgb_set_property;
   gobject_class->get_property = gst_bayer2rgb_get_property;
+  gobject_class->finalize = gst_bayer2rgb_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_METHOD,
+      g_param_spec_enum ("method", "Method",
+          "Interpolation method", GST_TYPE_BAYER2RGB_METHOD, DEFAULT_METHOD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_THREADS,
+      gst_base_video_slices_param_spec_threads ());
 
   GST_BASE_TRANSFORM_CLASS (klass)->transform_caps =
       GST_DEBUG_FUNCPTR (gst_bayer2rgb_transform_caps);
@@ -211,15 +308,46 @@ gst_bayer2rgb_init (GstBayer2RGB * filter, GstBayer2RGBClass * klass)
 {
   gst_bayer2rgb_reset (filter);
   gst_base_transform_set_in_place (GST_BASE_TRANSFORM (filter), TRUE);
+
+  filter->method = DEFAULT_METHOD;
+  filter->threads = DEFAULT_THREADS;
+  filter->slices = g_new0 (GstBayer2RGBSlice,
+      GST_BASE_VIDEO_SLICES_MAX_THREADS);
+  filter->slice_pool =
+      gst_base_video_slices_new (gst_bayer2rgb_slice_func, filter);
+}
+
+static void
+gst_bayer2rgb_finalize (GObject * object)
+{
+  GstBayer2RGB *filter = GST_BAYER2RGB (object);
+  guint i;
+
+  gst_base_video_slices_free (filter->slice_pool);
+  for (i = 0; i < GST_BASE_VIDEO_SLICES_MAX_THREADS; i++)
+    g_free (filter->slices[i].scratch);
+  g_free (filter->slices);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
-/* No properties are implemented, so only a warning is produced */
 static void
 gst_bayer2rgb_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
 {
+  GstBayer2RGB *filter = GST_BAYER2RGB (object);
 
   switch (prop_id) {
+    case PROP_METHOD:
+      GST_OBJECT_LOCK (filter);
+      filter->method = g_value_get_enum (value);
+      GST_OBJECT_UNLOCK (filter);
+      break;
+    case PROP_THREADS:
+      GST_OBJECT_LOCK (filter);
+      filter->threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (filter);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -230,8 +358,19 @@ static void
 gst_bayer2rgb_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec)
 {
+  GstBayer2RGB *filter = GST_BAYER2RGB (object);
 
   switch (prop_id) {
+    case PROP_METHOD:
+      GST_OBJECT_LOCK (filter);
+      g_value_set_enum (value, filter->method);
+      GST_OBJECT_UNLOCK (filter);
+      break;
+    case PROP_THREADS:
+      GST_OBJECT_LOCK (filter);
+      g_value_set_uint (value, filter->threads);
+      GST_OBJECT_UNLOCK (filter);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -275,7 +414,16 @@ gst_bayer2rgb_set_caps (GstBaseTransform * base, GstCaps * incaps,
 
   gst_structure_get_int (structure, "width", &bayer2rgb->width);
   gst_structure_get_int (structure, "height", &bayer2rgb->height);
-  bayer2rgb->stride = GST_ROUND_UP_4 (bayer2rgb->width);
+
+  /* 16 bit bayer carries the number of significant bits in depth */
+  if (!gst_structure_get_int (structure, "bpp", &bpp))
+    bpp = 8;
+  if (!gst_structure_get_int (structure, "depth", &bayer2rgb->depth))
+    bayer2rgb->depth = bpp;
+  if ((bpp != 8 && bpp != 16) || bayer2rgb->depth < 8 ||
+      bayer2rgb->depth > bpp)
+    return FALSE;
+  bayer2rgb->stride = GST_ROUND_UP_4 (bayer2rgb->width * (bpp / 8));
 
   format = gst_structure_get_string (structure, "format");
   if (g_str_equal (format, "bggr")) {
@@ -290,8 +438,14 @@ gst_bayer2rgb_set_caps (GstBaseTransform * base, GstCaps * incaps,
     return FALSE;
   }
 
-  /* To cater for different RGB formats, we need to set params for later */
   structure = gst_caps_get_structure (outcaps, 0);
+  if (gst_structure_has_name (structure, "video/x-raw-yuv")) {
+    return gst_video_format_parse_caps (outcaps, &bayer2rgb->yuv_format, NULL,
+        NULL);
+  }
+
+  /* To cater for different RGB formats, we need to set params for later */
+  bayer2rgb->yuv_format = GST_VIDEO_FORMAT_UNKNOWN;
   gst_structure_get_int (structure, "bpp", &bpp);
   bayer2rgb->pixsize = bpp / 8;
   gst_structure_get_int (structure, "red_mask", &val);
@@ -300,6 +454,9 @@ gst_bayer2rgb_set_caps (GstBaseTransform * base, GstCaps * incaps,
   bayer2rgb->g_off = get_pix_offset (val, bpp);
   gst_structure_get_int (structure, "blue_mask", &val);
   bayer2rgb->b_off = get_pix_offset (val, bpp);
+  /* the remaining byte of 32 bit formats */
+  bayer2rgb->a_off = 0 + 1 + 2 + 3 - bayer2rgb->r_off - bayer2rgb->g_off -
+      bayer2rgb->b_off;
 
   return TRUE;
 }
@@ -310,10 +467,13 @@ gst_bayer2rgb_reset (GstBayer2RGB * filter)
   filter->width = 0;
   filter->height = 0;
   filter->stride = 0;
+  filter->depth = 8;
   filter->pixsize = 0;
   filter->r_off = 0;
   filter->g_off = 0;
   filter->b_off = 0;
+  filter->a_off = 0;
+  filter->yuv_format = GST_VIDEO_FORMAT_UNKNOWN;
 }
 
 static GstCaps *
@@ -323,6 +483,7 @@ gst_bayer2rgb_transform_caps (GstBaseTransform * base,
   GstStructure *structure;
   GstCaps *newcaps;
   GstStructure *newstruct;
+  guint i;
 
   GST_DEBUG_OBJECT (caps, "transforming caps (from)");
 
@@ -332,16 +493,20 @@ gst_bayer2rgb_transform_caps (GstBaseTransform * base,
     newcaps = gst_caps_from_string ("video/x-raw-bayer,"
         "format=(string){bggr,grbg,gbrg,rggb}");
   } else {
-    newcaps = gst_caps_new_simple ("video/x-raw-rgb", NULL);
+    newcaps = gst_caps_from_string ("video/x-raw-rgb; "
+        "video/x-raw-yuv,format=(fourcc){I420,NV12}");
   }
-  newstruct = gst_caps_get_structure (newcaps, 0);
 
-  gst_structure_set_value (newstruct, "width",
-      gst_structure_get_value (structure, "width"));
-  gst_structure_set_value (newstruct, "height",
-      gst_structure_get_value (structure, "height"));
-  gst_structure_set_value (newstruct, "framerate",
-      gst_structure_get_value (structure, "framerate"));
+  for (i = 0; i < gst_caps_get_size (newcaps); i++) {
+    newstruct = gst_caps_get_structure (newcaps, i);
+
+    gst_structure_set_value (newstruct, "width",
+        gst_structure_get_value (structure, "width"));
+    gst_structure_set_value (newstruct, "height",
+        gst_structure_get_value (structure, "height"));
+    gst_structure_set_value (newstruct, "framerate",
+        gst_structure_get_value (structure, "framerate"));
+  }
 
   GST_DEBUG_OBJECT (newcaps, "transforming caps (into)");
 
@@ -357,17 +522,26 @@ gst_bayer2rgb_get_unit_size (GstBaseTransform * base, GstCaps * caps,
   int height;
   int pixsize;
   const char *name;
+  GstVideoFormat format;
 
   structure = gst_caps_get_structure (caps, 0);
 
   if (gst_structure_get_int (structure, "width", &width) &&
       gst_structure_get_int (structure, "height", &height)) {
     name = gst_structure_get_name (structure);
-    /* Our name must be either video/x-raw-bayer video/x-raw-rgb */
-    if (strcmp (name, "video/x-raw-rgb")) {
-      /* For bayer, we handle only BA81 (BGGR), which is BPP=24 */
-      *size = GST_ROUND_UP_4 (width) * height;
+    /* Our name must be either video/x-raw-bayer, video/x-raw-rgb or
+     * video/x-raw-yuv */
+    if (g_str_equal (name, "video/x-raw-bayer")) {
+      /* Rows are 4 byte aligned, bpp is 8 unless specified */
+      if (!gst_structure_get_int (structure, "bpp", &pixsize))
+        pixsize = 8;
+      *size = GST_ROUND_UP_4 (width * (pixsize / 8)) * height;
       return TRUE;
+    } else if (g_str_equal (name, "video/x-raw-yuv")) {
+      if (gst_video_format_parse_caps (caps, &format, &width, &height)) {
+        *size = gst_video_format_get_size (format, width, height);
+        return TRUE;
+      }
     } else {
       /* For output, calculate according to format */
       if (gst_structure_get_int (structure, "bpp", &pixsize)) {
@@ -382,282 +556,399 @@ gst_bayer2rgb_get_unit_size (GstBaseTransform * base, GstCaps * caps,
   return FALSE;
 }
 
-/*
- * We define values for the colors, just to make the code more readable.
- */
-#define	RED	0               /* Pure red element */
-#define	GREENB	1               /* Green element which is on a blue line */
-#define	BLUE	2               /* Pure blue element */
-#define	GREENR	3               /* Green element which is on a red line */
+/* rows and columns outside of the frame are mirrored from the inside, which
+ * keeps the colour of the elements */
+static inline gint
+mirror (gint i, gint n)
+{
+  if (G_LIKELY (i >= 0 && i < n))
+    return i;
+  if (n == 1)
+    return 0;
+
+  /* tiny frames may need more than one reflection */
+  while (i < 0 || i >= n)
+    i = (i < 0) ? -i : 2 * n - 2 - i;
+  return i;
+}
 
-static int
-get_pixel_type (GstBayer2RGB * filter, int x, int y)
+/* whether row y holds red (rather than blue) elements */
+static inline gboolean
+is_red_row (GstBayer2RGB * filter, gint y)
 {
-  int type;
+  return ((y ^ (filter->format >> 1)) & 1);
+}
 
-  if (((x ^ filter->format) & 1)) {
-    if ((y ^ (filter->format >> 1)) & 1)
-      type = RED;
+/* column parity of the green elements of row y */
+static inline gint
+green_parity (GstBayer2RGB * filter, gint y)
+{
+  return (filter->format & 1) ^ !is_red_row (filter, y);
+}
+
+/* returns row y of the input with 8 bit elements */
+static const guint8 *
+get_raw (GstBayer2RGBSlice * slice, gint y)
+{
+  GstBayer2RGB *filter = slice->filter;
+  const guint8 *line;
+  gint slot;
+
+  y = mirror (y, filter->height);
+  line = slice->input + y * filter->stride;
+  if (filter->depth == 8)
+    return line;
+
+  slot = y & 7;
+  if (slice->raw_row[slot] != y) {
+    bayer_orc_convert_16_to_8 (slice->raw[slot], (const guint16 *) line,
+        filter->depth - 8, filter->width);
+    slice->raw_row[slot] = y;
+  }
+  return slice->raw[slot];
+}
+
+static inline void
+split_element (const guint8 * src, guint8 ** split, gint i, gint width)
+{
+  split[i & 1][i] = src[i];
+  split[!(i & 1)][i] =
+      (src[mirror (i - 1, width)] + src[mirror (i + 1, width)] + 1) >> 1;
+}
+
+/* returns row y split into full lines of the colour of the even (line 0)
+ * and of the odd (line 1) columns */
+static guint8 **
+get_split (GstBayer2RGBSlice * slice, gint y)
+{
+  GstBayer2RGB *filter = slice->filter;
+  gint width = filter->width;
+  const guint8 *src;
+  guint8 **split;
+  gint slot, n, i;
+
+  y = mirror (y, filter->height);
+  slot = y & 3;
+  split = slice->split[slot];
+  if (slice->split_row[slot] == y)
+    return split;
+
+  src = get_raw (slice, y);
+
+  /* the Orc function reads the previous and the next pair of elements, so
+   * the first and the last ones are done here */
+  n = width >= 4 ? (width - 4) / 2 : 0;
+  if (n > 0)
+    bayer_orc_horiz_upsample (split[0] + 2, split[1] + 2, src + 2, src,
+        src + 4, n);
+  for (i = 0; i < MIN (2, width); i++)
+    split_element (src, split, i, width);
+  for (i = 2 + 2 * n; i < width; i++)
+    split_element (src, split, i, width);
+
+  slice->split_row[slot] = y;
+  return split;
+}
+
+static void
+interpolate_bilinear (GstBayer2RGBSlice * slice, gint y)
+{
+  GstBayer2RGB *filter = slice->filter;
+  gint width = filter->width;
+  gint gp = green_parity (filter, y);
+  guint8 **above = get_split (slice, y - 1);
+  guint8 **cur = get_split (slice, y);
+  guint8 **below = get_split (slice, y + 1);
+  guint8 *g = slice->tmp[y & 1][0];
+  guint8 *o = slice->tmp[y & 1][1];
+  const guint8 **rgb = slice->rgb[y & 1];
+
+  /* the green elements of the rows above and below are in the other
+   * columns */
+  bayer_orc_merge_row (g, o, cur[gp], above[!gp], below[!gp], above[gp],
+      below[gp], gp ? 0xff00 : 0x00ff, width / 2);
+  if (width & 1) {
+    gint i = width - 1;
+
+    if ((i & 1) == gp)
+      g[i] = cur[gp][i];
     else
-      type = GREENB;
+      g[i] = (cur[gp][i] + ((above[!gp][i] + below[!gp][i] + 1) >> 1) +
+          1) >> 1;
+    o[i] = (above[gp][i] + below[gp][i] + 1) >> 1;
+  }
+
+  rgb[1] = g;
+  if (is_red_row (filter, y)) {
+    rgb[0] = cur[!gp];
+    rgb[2] = o;
   } else {
-    if ((y ^ (filter->format >> 1)) & 1)
-      type = GREENR;
+    rgb[0] = o;
+    rgb[2] = cur[!gp];
+  }
+}
+
+/* Hamilton-Adams interpolation of green on a red or blue element i of row c,
+ * with u1/d1 and u2/d2 the rows one and two above/below and l2..r2 the
+ * columns around i */
+static inline guint8
+edge_aware_green (const guint8 * c, const guint8 * u1, const guint8 * d1,
+    const guint8 * u2, const guint8 * d2, gint i, gint l2, gint l1, gint r1,
+    gint r2)
+{
+  gint lh = 2 * c[i] - c[l2] - c[r2];
+  gint lv = 2 * c[i] - u2[i] - d2[i];
+  gint dh = ABS (c[l1] - c[r1]) + ABS (lh);
+  gint dv = ABS (u1[i] - d1[i]) + ABS (lv);
+  /* four times the horizontal and the vertical estimate */
+  gint gh = 2 * (c[l1] + c[r1]) + lh;
+  gint gv = 2 * (u1[i] + d1[i]) + lv;
+  gint g;
+
+  if (dh < dv)
+    g = (gh + 2) >> 2;
+  else if (dv < dh)
+    g = (gv + 2) >> 2;
+  else
+    g = (gh + gv + 4) >> 3;
+
+  return CLAMP (g, 0, 255);
+}
+
+/* returns the full green row y */
+static const guint8 *
+get_green (GstBayer2RGBSlice * slice, gint y)
+{
+  GstBayer2RGB *filter = slice->filter;
+  gint width = filter->width;
+  const guint8 *c, *u1, *d1, *u2, *d2;
+  guint8 *g;
+  gint slot, gp, i;
+
+  y = mirror (y, filter->height);
+  slot = y & 3;
+  g = slice->green[slot];
+  if (slice->green_row[slot] == y)
+    return g;
+
+  c = get_raw (slice, y);
+  u1 = get_raw (slice, y - 1);
+  d1 = get_raw (slice, y + 1);
+  u2 = get_raw (slice, y - 2);
+  d2 = get_raw (slice, y + 2);
+  gp = green_parity (filter, y);
+
+  for (i = 0; i < width; i++) {
+    if ((i & 1) == gp)
+      g[i] = c[i];
+    else if (i >= 2 && i < width - 2)
+      g[i] = edge_aware_green (c, u1, d1, u2, d2, i, i - 2, i - 1, i + 1,
+          i + 2);
     else
-      type = BLUE;
+      g[i] = edge_aware_green (c, u1, d1, u2, d2, i, mirror (i - 2, width),
+          mirror (i - 1, width), mirror (i + 1, width), mirror (i + 2,
+              width));
   }
-  return type;
+
+  slice->green_row[slot] = y;
+  return g;
 }
 
-/* Routine to generate the top and bottom edges (not including corners) */
 static void
-hborder (uint8_t * input, uint8_t * output, int bot_top,
-    int typ, GstBayer2RGB * filter)
-{
-  uint8_t *op;                  /* output pointer */
-  uint8_t *ip;                  /* input pointer */
-  uint8_t *nx;                  /* next line pointer */
-  int ix;                       /* loop index */
-
-  op = output + (bot_top * filter->width * (filter->height - 1) + 1) *
-      filter->pixsize;
-  ip = input + bot_top * filter->stride * (filter->height - 1);
-  /* calculate minus or plus one line, depending upon bot_top flag */
-  nx = ip + (1 - 2 * bot_top) * filter->stride;
-  /* Stepping horizontally */
-  for (ix = 1; ix < filter->width - 1; ix++, op += filter->pixsize) {
-    switch (typ) {
-      case RED:
-        op[filter->r_off] = ip[ix];
-        op[filter->g_off] = (ip[ix + 1] + ip[ix - 1] + nx[ix] + 1) / 3;
-        op[filter->b_off] = (nx[ix + 1] + nx[ix - 1] + 1) / 2;
-        typ = GREENR;
-        break;
-      case GREENR:
-        op[filter->r_off] = (ip[ix + 1] + ip[ix - 1] + 1) / 2;
-        op[filter->g_off] = ip[ix];
-        op[filter->b_off] = nx[ix];
-        typ = RED;
-        break;
-      case GREENB:
-        op[filter->r_off] = nx[ix];
-        op[filter->g_off] = ip[ix];
-        op[filter->b_off] = (ip[ix + 1] + ip[ix - 1] + 1) / 2;
-        typ = BLUE;
-        break;
-      case BLUE:
-        op[filter->r_off] = (nx[ix + 1] + nx[ix - 1] + 1) / 2;
-        op[filter->g_off] = (ip[ix + 1] + ip[ix - 1] + nx[ix] + 1) / 3;
-        op[filter->b_off] = ip[ix];
-        typ = GREENB;
-        break;
+interpolate_edge_aware (GstBayer2RGBSlice * slice, gint y)
+{
+  GstBayer2RGB *filter = slice->filter;
+  gint width = filter->width;
+  gint gp = green_parity (filter, y);
+  const guint8 *ga = get_green (slice, y - 1);
+  const guint8 *gc = get_green (slice, y);
+  const guint8 *gb = get_green (slice, y + 1);
+  const guint8 *ca = get_raw (slice, y - 1);
+  const guint8 *cc = get_raw (slice, y);
+  const guint8 *cb = get_raw (slice, y + 1);
+  guint8 *own = slice->tmp[y & 1][0];
+  guint8 *other = slice->tmp[y & 1][1];
+  const guint8 **rgb = slice->rgb[y & 1];
+  gint i, l, r, v;
+
+  /* the colour of the row is left and right of green elements, the other
+   * one above and below them and diagonal to the red and blue elements */
+  for (i = 0; i < width; i++) {
+    l = mirror (i - 1, width);
+    r = mirror (i + 1, width);
+    if ((i & 1) == gp) {
+      v = gc[i] + ((cc[l] - gc[l] + cc[r] - gc[r] + 1) >> 1);
+      own[i] = CLAMP (v, 0, 255);
+      v = gc[i] + ((ca[i] - ga[i] + cb[i] - gb[i] + 1) >> 1);
+      other[i] = CLAMP (v, 0, 255);
+    } else {
+      own[i] = cc[i];
+      v = gc[i] + ((ca[l] - ga[l] + ca[r] - ga[r] + cb[l] - gb[l] + cb[r] -
+              gb[r] + 2) >> 2);
+      other[i] = CLAMP (v, 0, 255);
     }
   }
+
+  rgb[1] = gc;
+  if (is_red_row (filter, y)) {
+    rgb[0] = own;
+    rgb[2] = other;
+  } else {
+    rgb[0] = other;
+    rgb[2] = own;
+  }
 }
 
-/* Routine to generate the left and right edges, not including corners */
 static void
-vborder (uint8_t * input, uint8_t * output, int right_left,
-    int typ, GstBayer2RGB * filter)
-{
-  uint8_t *op;                  /* output pointer */
-  uint8_t *ip;                  /* input pointer */
-  uint8_t *la;                  /* line above pointer */
-  uint8_t *lb;                  /* line below pointer */
-  int ix;                       /* loop index */
-  int lr;                       /* 'left-right' flag - +1 is right, -1 is left */
-
-  lr = (1 - 2 * right_left);
-  /* stepping vertically */
-  for (ix = 1; ix < filter->height - 1; ix++) {
-    ip = input + right_left * (filter->width - 1) + ix * filter->stride;
-    op = output + (right_left * (filter->width - 1) + ix * filter->width) *
-        filter->pixsize;
-    la = ip + filter->stride;
-    lb = ip - filter->stride;
-    switch (typ) {
-      case RED:
-        op[filter->r_off] = ip[0];
-        op[filter->g_off] = (la[0] + ip[lr] + lb[0] + 1) / 3;
-        op[filter->b_off] = (la[lr] + lb[lr] + 1) / 2;
-        typ = GREENB;
-        break;
-      case GREENR:
-        op[filter->r_off] = ip[lr];
-        op[filter->g_off] = ip[0];
-        op[filter->b_off] = (la[lr] + lb[lr] + 1) / 2;
-        typ = BLUE;
-        break;
-      case GREENB:
-        op[filter->r_off] = (la[lr] + lb[lr] + 1) / 2;
-        op[filter->g_off] = ip[0];
-        op[filter->b_off] = ip[lr];
-        typ = RED;
-        break;
-      case BLUE:
-        op[filter->r_off] = (la[lr] + lb[lr] + 1) / 2;
-        op[filter->g_off] = (la[0] + ip[lr] + lb[0] + 1) / 3;
-        op[filter->b_off] = ip[0];
-        typ = GREENR;
-        break;
+output_rgb_row (GstBayer2RGBSlice * slice, gint y)
+{
+  GstBayer2RGB *filter = slice->filter;
+  const guint8 **rgb = slice->rgb[y & 1];
+  guint8 *dest = slice->output + y * filter->width * filter->pixsize;
+  gint i;
+
+  if (filter->pixsize == 4) {
+    const guint8 *lines[4];
+
+    lines[filter->r_off] = rgb[0];
+    lines[filter->g_off] = rgb[1];
+    lines[filter->b_off] = rgb[2];
+    lines[filter->a_off] = slice->alpha;
+    bayer_orc_pack_4 (dest, lines[0], lines[1], lines[2], lines[3],
+        filter->width);
+  } else {
+    for (i = 0; i < filter->width; i++) {
+      dest[filter->r_off] = rgb[0][i];
+      dest[filter->g_off] = rgb[1][i];
+      dest[filter->b_off] = rgb[2][i];
+      dest += filter->pixsize;
     }
   }
 }
 
-/* Produce the four (top, bottom, left, right) edges */
 static void
-do_row0_col0 (uint8_t * input, uint8_t * output, GstBayer2RGB * filter)
+output_yuv_row (GstBayer2RGBSlice * slice, gint y)
 {
-  /* Horizontal edges */
-  hborder (input, output, 0, get_pixel_type (filter, 1, 0), filter);
-  hborder (input, output, 1, get_pixel_type (filter, 1, filter->height - 1),
-      filter);
-
-  /* Vertical edges */
-  vborder (input, output, 0, get_pixel_type (filter, 0, 1), filter);
-  vborder (input, output, 1, get_pixel_type (filter, filter->width - 1, 1),
-      filter);
+  GstBayer2RGB *filter = slice->filter;
+  GstVideoFormat format = filter->yuv_format;
+  gint width = filter->width;
+  gint height = filter->height;
+  const guint8 **rgb0, **rgb1;
+  guint8 *y_line, *u_line, *v_line;
+  gint i;
+
+  y_line = slice->output +
+      gst_video_format_get_component_offset (format, 0, width, height) +
+      y * gst_video_format_get_row_stride (format, 0, width);
+  rgb1 = slice->rgb[y & 1];
+  bayer_orc_rgb_to_y (y_line, rgb1[0], rgb1[1], rgb1[2], width);
+
+  /* chroma of a pair of rows, or of the last row of odd heights */
+  if (!(y & 1) && y < height - 1)
+    return;
+  rgb0 = slice->rgb[0];
+
+  u_line = slice->output +
+      gst_video_format_get_component_offset (format, 1, width, height) +
+      (y / 2) * gst_video_format_get_row_stride (format, 1, width);
+  v_line = slice->output +
+      gst_video_format_get_component_offset (format, 2, width, height) +
+      (y / 2) * gst_video_format_get_row_stride (format, 2, width);
+
+  if (format == GST_VIDEO_FORMAT_NV12)
+    bayer_orc_rgb_to_uv_interleaved (u_line, rgb0[0], rgb1[0], rgb0[1],
+        rgb1[1], rgb0[2], rgb1[2], width / 2);
+  else
+    bayer_orc_rgb_to_uv (u_line, v_line, rgb0[0], rgb1[0], rgb0[1], rgb1[1],
+        rgb0[2], rgb1[2], width / 2);
+
+  if (width & 1) {
+    gint r, g, b, u, v;
+
+    i = width - 1;
+    r = (rgb0[0][i] + rgb1[0][i] + 1) >> 1;
+    g = (rgb0[1][i] + rgb1[1][i] + 1) >> 1;
+    b = (rgb0[2][i] + rgb1[2][i] + 1) >> 1;
+    u = ((112 * b - 74 * g - 38 * r + 128) >> 8) + 128;
+    v = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+
+    if (format == GST_VIDEO_FORMAT_NV12) {
+      u_line[i] = CLAMP (u, 0, 255);
+      u_line[i + 1] = CLAMP (v, 0, 255);
+    } else {
+      u_line[i / 2] = CLAMP (u, 0, 255);
+      v_line[i / 2] = CLAMP (v, 0, 255);
+    }
+  }
 }
 
+/* converts the output rows of a slice; the caches are emptied first as the
+ * slice may have converted another frame before */
 static void
-corner (uint8_t * input, uint8_t * output, int x, int y,
-    int xd, int yd, int typ, GstBayer2RGB * filter)
-{
-  uint8_t *ip;                  /* input pointer */
-  uint8_t *op;                  /* output pointer */
-  uint8_t *nx;                  /* adjacent line */
-
-  op = output + y * filter->width * filter->pixsize + x * filter->pixsize;
-  ip = input + y * filter->stride + x;
-  nx = ip + yd * filter->stride;
-  switch (typ) {
-    case RED:
-      op[filter->r_off] = ip[0];
-      op[filter->g_off] = (nx[0] + ip[xd] + 1) / 2;
-      op[filter->b_off] = nx[xd];
-      break;
-    case GREENR:
-      op[filter->r_off] = ip[xd];
-      op[filter->g_off] = ip[0];
-      op[filter->b_off] = nx[0];
-      break;
-    case GREENB:
-      op[filter->r_off] = nx[0];
-      op[filter->g_off] = ip[0];
-      op[filter->b_off] = ip[xd];
-      break;
-    case BLUE:
-      op[filter->r_off] = nx[xd];
-      op[filter->g_off] = (nx[0] + ip[xd] + 1) / 2;
-      op[filter->b_off] = ip[0];
-      break;
+gst_bayer2rgb_process_slice (GstBayer2RGB * filter, GstBayer2RGBSlice * slice)
+{
+  gint i, y;
+
+  for (i = 0; i < 8; i++)
+    slice->raw_row[i] = -1;
+  for (i = 0; i < 4; i++)
+    slice->split_row[i] = slice->green_row[i] = -1;
+
+  for (y = slice->start; y < slice->end; y++) {
+    if (filter->method == GST_BAYER_2_RGB_METHOD_EDGE_AWARE)
+      interpolate_edge_aware (slice, y);
+    else
+      interpolate_bilinear (slice, y);
+
+    if (filter->yuv_format != GST_VIDEO_FORMAT_UNKNOWN)
+      output_yuv_row (slice, y);
+    else
+      output_rgb_row (slice, y);
   }
 }
 
+/* slice threading
+ *
+ * every output row only depends on the input, so the frame is cut into
+ * horizontal slices of whole row pairs (for the chroma of I420 and NV12)
+ * that are converted in parallel. */
 static void
-do_corners (uint8_t * input, uint8_t * output, GstBayer2RGB * filter)
-{
-  /* Top left */
-  corner (input, output, 0, 0, 1, 1, get_pixel_type (filter, 0, 0), filter);
-  /* Bottom left */
-  corner (input, output, 0, filter->height - 1, 1, -1,
-      get_pixel_type (filter, 0, filter->height - 1), filter);
-  /* Top right */
-  corner (input, output, filter->width - 1, 0, -1, 0,
-      get_pixel_type (filter, filter->width - 1, 0), filter);
-  /* Bottom right */
-  corner (input, output, filter->width - 1, filter->height - 1, -1, -1,
-      get_pixel_type (filter, filter->width - 1, filter->height - 1), filter);
+gst_bayer2rgb_slice_func (gpointer data, gpointer user_data)
+{
+  gst_bayer2rgb_process_slice (user_data, data);
 }
 
+/* makes sure the slice has scratch lines for the current width */
 static void
-do_body (uint8_t * input, uint8_t * output, GstBayer2RGB * filter)
+gst_bayer2rgb_slice_ensure_scratch (GstBayer2RGB * filter,
+    GstBayer2RGBSlice * slice)
 {
-  int ip, op;                   /* input and output pointers */
-  int w, h;                     /* loop indices */
-  int type;                     /* calculated colour of current element */
-  int a1, a2;
-  int v1, v2, h1, h2;
-
-  /*
-   * We are processing row (line) by row, starting with the second
-   * row and continuing through the next to last.  Each row is processed
-   * column by column, starting with the second and continuing through
-   * to the next to last.
-   */
-  for (h = 1; h < filter->height - 1; h++) {
-    /*
-     * Remember we are processing "row by row". For each row, we need
-     * to set the type of the first element to be processed.  Since we
-     * have already processed the edges, the "first element" will be
-     * the pixel at position (1,1).  Assuming BG format, this should
-     * be RED for odd-numbered rows and GREENB for even rows.
-     */
-    type = get_pixel_type (filter, 1, h);
-    /* Calculate the starting position for the row */
-    op = h * filter->width * filter->pixsize;   /* output (converted) pos */
-    ip = h * filter->stride;    /* input (bayer data) pos */
-    for (w = 1; w < filter->width - 1; w++) {
-      op += filter->pixsize;    /* we are processing "horizontally" */
-      ip++;
-      switch (type) {
-        case RED:
-          output[op + filter->r_off] = input[ip];
-          output[op + filter->b_off] = (input[ip - filter->stride - 1] +
-              input[ip - filter->stride + 1] +
-              input[ip + filter->stride - 1] +
-              input[ip + filter->stride + 1] + 2) / 4;
-          v1 = input[ip + filter->stride];
-          v2 = input[ip - filter->stride];
-          h1 = input[ip + 1];
-          h2 = input[ip - 1];
-          a1 = abs (v1 - v2);
-          a2 = abs (h1 - h2);
-          if (a1 < a2)
-            output[op + filter->g_off] = (v1 + v2 + 1) / 2;
-          else if (a1 > a2)
-            output[op + filter->g_off] = (h1 + h2 + 1) / 2;
-          else
-            output[op + filter->g_off] = (v1 + h1 + v2 + h2 + 2) / 4;
-          type = GREENR;
-          break;
-        case GREENR:
-          output[op + filter->r_off] = (input[ip + 1] + input[ip - 1] + 1) / 2;
-          output[op + filter->g_off] = input[ip];
-          output[op + filter->b_off] = (input[ip - filter->stride] +
-              input[ip + filter->stride] + 1) / 2;
-          type = RED;
-          break;
-        case GREENB:
-          output[op + filter->r_off] = (input[ip - filter->stride] +
-              input[ip + filter->stride] + 1) / 2;
-          output[op + filter->g_off] = input[ip];
-          output[op + filter->b_off] = (input[ip + 1] + input[ip - 1] + 1) / 2;
-          type = BLUE;
-          break;
-        case BLUE:
-          output[op + filter->r_off] = (input[ip - filter->stride - 1] +
-              input[ip - filter->stride + 1] +
-              input[ip + filter->stride - 1] +
-              input[ip + filter->stride + 1] + 2) / 4;
-          output[op + filter->b_off] = input[ip];
-          v1 = input[ip + filter->stride];
-          v2 = input[ip - filter->stride];
-          h1 = input[ip + 1];
-          h2 = input[ip - 1];
-          a1 = abs (v1 - v2);
-          a2 = abs (h1 - h2);
-          if (a1 < a2)
-            output[op + filter->g_off] = (v1 + v2 + 1) / 2;
-          else if (a1 > a2)
-            output[op + filter->g_off] = (h1 + h2 + 1) / 2;
-          else
-            output[op + filter->g_off] = (v1 + h1 + v2 + h2 + 2) / 4;
-          type = GREENB;
-          break;
-      }
-    }
+  gint line_size = GST_ROUND_UP_8 (filter->width);
+  guint8 *line;
+  gint i;
+
+  if (slice->line_size == line_size)
+    return;
+
+  g_free (slice->scratch);
+  slice->scratch = g_malloc (N_SCRATCH_LINES * line_size);
+  slice->line_size = line_size;
+
+  line = slice->scratch;
+  for (i = 0; i < 8; i++, line += line_size)
+    slice->raw[i] = line;
+  for (i = 0; i < 4; i++, line += 2 * line_size) {
+    slice->split[i][0] = line;
+    slice->split[i][1] = line + line_size;
   }
+  for (i = 0; i < 4; i++, line += line_size)
+    slice->green[i] = line;
+  for (i = 0; i < 2; i++, line += 2 * line_size) {
+    slice->tmp[i][0] = line;
+    slice->tmp[i][1] = line + line_size;
+  }
+  slice->alpha = line;
+  memset (slice->alpha, 0xff, line_size);
 }
 
 static GstFlowReturn
@@ -665,7 +956,7 @@ gst_bayer2rgb_transform (GstBaseTransform * base, GstBuffer * inbuf,
     GstBuffer * outbuf)
 {
   GstBayer2RGB *filter = GST_BAYER2RGB (base);
-  uint8_t *input, *output;
+  guint i, n_slices, n_pairs;
 
   /*
    * We need to lock our filter params to prevent changing
@@ -675,11 +966,24 @@ gst_bayer2rgb_transform (GstBaseTransform * base, GstBuffer * inbuf,
   GST_OBJECT_LOCK (filter);
 
   GST_DEBUG ("transforming buffer");
-  input = (uint8_t *) GST_BUFFER_DATA (inbuf);
-  output = (uint8_t *) GST_BUFFER_DATA (outbuf);
-  do_corners (input, output, filter);
-  do_row0_col0 (input, output, filter);
-  do_body (input, output, filter);
+
+  n_pairs = (filter->height + 1) / 2;
+  n_slices = gst_base_video_slices_prepare (filter->slice_pool,
+      filter->threads, 2 * n_pairs, MIN_SLICE_ROWS);
+
+  for (i = 0; i < n_slices; i++) {
+    GstBayer2RGBSlice *slice = &filter->slices[i];
+
+    gst_bayer2rgb_slice_ensure_scratch (filter, slice);
+    slice->filter = filter;
+    slice->input = GST_BUFFER_DATA (inbuf);
+    slice->output = GST_BUFFER_DATA (outbuf);
+    slice->start = 2 * ((n_pairs * i) / n_slices);
+    slice->end = MIN (2 * ((n_pairs * (i + 1)) / n_slices), filter->height);
+  }
+
+  gst_base_video_slices_run (filter->slice_pool, filter->slices,
+      sizeof (GstBayer2RGBSlice), n_slices);
 
   GST_OBJECT_UNLOCK (filter);
   return GST_FLOW_OK;
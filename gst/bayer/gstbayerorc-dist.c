@@ -0,0 +1,1958 @@
+
+/* autogenerated from gstbayerorc.orc */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#ifndef DISABLE_ORC
+#include <orc/orc.h>
+#endif
+#include <glib.h>
+
+#ifndef _ORC_INTEGER_TYPEDEFS_
+#define _ORC_INTEGER_TYPEDEFS_
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#include <stdint.h>
+typedef int8_t orc_int8;
+typedef int16_t orc_int16;
+typedef int32_t orc_int32;
+typedef int64_t orc_int64;
+typedef uint8_t orc_uint8;
+typedef uint16_t orc_uint16;
+typedef uint32_t orc_uint32;
+typedef uint64_t orc_uint64;
+#define ORC_UINT64_C(x) UINT64_C(x)
+#elif defined(_MSC_VER)
+typedef signed __int8 orc_int8;
+typedef signed __int16 orc_int16;
+typedef signed __int32 orc_int32;
+typedef signed __int64 orc_int64;
+typedef unsigned __int8 orc_uint8;
+typedef unsigned __int16 orc_uint16;
+typedef unsigned __int32 orc_uint32;
+typedef unsigned __int64 orc_uint64;
+#define ORC_UINT64_C(x) (x##Ui64)
+#else
+#include <limits.h>
+typedef signed char orc_int8;
+typedef short orc_int16;
+typedef int orc_int32;
+typedef unsigned char orc_uint8;
+typedef unsigned short orc_uint16;
+typedef unsigned int orc_uint32;
+#if INT_MAX == LONG_MAX
+typedef long long orc_int64;
+typedef unsigned long long orc_uint64;
+#define ORC_UINT64_C(x) (x##ULL)
+#else
+typedef long orc_int64;
+typedef unsigned long orc_uint64;
+#define ORC_UINT64_C(x) (x##UL)
+#endif
+#endif
+typedef union
+{
+  orc_int16 i;
+  orc_int8 x2[2];
+} orc_union16;
+typedef union
+{
+  orc_int32 i;
+  float f;
+  orc_int16 x2[2];
+  orc_int8 x4[4];
+} orc_union32;
+typedef union
+{
+  orc_int64 i;
+  double f;
+  orc_int32 x2[2];
+  float x2f[2];
+  orc_int16 x4[4];
+} orc_union64;
+#endif
+
+void bayer_orc_horiz_upsample (guint8 * d1, guint8 * d2, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, int n);
+void bayer_orc_merge_row (guint8 * d1, guint8 * d2, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
+    int p1, int n);
+void bayer_orc_pack_4 (guint8 * d1, const guint8 * s1, const guint8 * s2,
+    const guint8 * s3, const guint8 * s4, int n);
+void bayer_orc_convert_16_to_8 (guint8 * d1, const guint16 * s1, int p1, int n);
+void bayer_orc_rgb_to_y (guint8 * d1, const guint8 * s1, const guint8 * s2,
+    const guint8 * s3, int n);
+void bayer_orc_rgb_to_uv (guint8 * d1, guint8 * d2, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
+    const guint8 * s6, int n);
+void bayer_orc_rgb_to_uv_interleaved (guint8 * d1, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
+    const guint8 * s6, int n);
+
+void gst_bayer_orc_init (void);
+
+
+/* begin Orc C target preamble */
+#define ORC_CLAMP(x,a,b) ((x)<(a) ? (a) : ((x)>(b) ? (b) : (x)))
+#define ORC_ABS(a) ((a)<0 ? -(a) : (a))
+#define ORC_MIN(a,b) ((a)<(b) ? (a) : (b))
+#define ORC_MAX(a,b) ((a)>(b) ? (a) : (b))
+#define ORC_SB_MAX 127
+#define ORC_SB_MIN (-1-ORC_SB_MAX)
+#define ORC_UB_MAX 255
+#define ORC_UB_MIN 0
+#define ORC_SW_MAX 32767
+#define ORC_SW_MIN (-1-ORC_SW_MAX)
+#define ORC_UW_MAX 65535
+#define ORC_UW_MIN 0
+#define ORC_SL_MAX 2147483647
+#define ORC_SL_MIN (-1-ORC_SL_MAX)
+#define ORC_UL_MAX 4294967295U
+#define ORC_UL_MIN 0
+#define ORC_CLAMP_SB(x) ORC_CLAMP(x,ORC_SB_MIN,ORC_SB_MAX)
+#define ORC_CLAMP_UB(x) ORC_CLAMP(x,ORC_UB_MIN,ORC_UB_MAX)
+#define ORC_CLAMP_SW(x) ORC_CLAMP(x,ORC_SW_MIN,ORC_SW_MAX)
+#define ORC_CLAMP_UW(x) ORC_CLAMP(x,ORC_UW_MIN,ORC_UW_MAX)
+#define ORC_CLAMP_SL(x) ORC_CLAMP(x,ORC_SL_MIN,ORC_SL_MAX)
+#define ORC_CLAMP_UL(x) ORC_CLAMP(x,ORC_UL_MIN,ORC_UL_MAX)
+#define ORC_SWAP_W(x) ((((x)&0xff)<<8) | (((x)&0xff00)>>8))
+#define ORC_SWAP_L(x) ((((x)&0xff)<<24) | (((x)&0xff00)<<8) | (((x)&0xff0000)>>8) | (((x)&0xff000000)>>24))
+#define ORC_SWAP_Q(x) ((((x)&ORC_UINT64_C(0xff))<<56) | (((x)&ORC_UINT64_C(0xff00))<<40) | (((x)&ORC_UINT64_C(0xff0000))<<24) | (((x)&ORC_UINT64_C(0xff000000))<<8) | (((x)&ORC_UINT64_C(0xff00000000))>>8) | (((x)&ORC_UINT64_C(0xff0000000000))>>24) | (((x)&ORC_UINT64_C(0xff000000000000))>>40) | (((x)&ORC_UINT64_C(0xff00000000000000))>>56))
+#define ORC_PTR_OFFSET(ptr,offset) ((void *)(((unsigned char *)(ptr)) + (offset)))
+#define ORC_DENORMAL(x) ((x) & ((((x)&0x7f800000) == 0) ? 0xff800000 : 0xffffffff))
+#define ORC_ISNAN(x) ((((x)&0x7f800000) == 0x7f800000) && (((x)&0x007fffff) != 0))
+#define ORC_DENORMAL_DOUBLE(x) ((x) & ((((x)&ORC_UINT64_C(0x7ff0000000000000)) == 0) ? ORC_UINT64_C(0xfff0000000000000) : ORC_UINT64_C(0xffffffffffffffff)))
+#define ORC_ISNAN_DOUBLE(x) ((((x)&ORC_UINT64_C(0x7ff0000000000000)) == ORC_UINT64_C(0x7ff0000000000000)) && (((x)&ORC_UINT64_C(0x000fffffffffffff)) != 0))
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define ORC_RESTRICT restrict
+#elif defined(__GNUC__) && __GNUC__ >= 4
+#define ORC_RESTRICT __restrict__
+#else
+#define ORC_RESTRICT
+#endif
+/* end Orc C target preamble */
+
+
+
+/* bayer_orc_horiz_upsample */
+#ifdef DISABLE_ORC
+void
+bayer_orc_horiz_upsample (guint8 * d1, guint8 * d2, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, int n)
+{
+  int i;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union16 *ORC_RESTRICT ptr1;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  orc_union16 var36;
+  orc_int8 var37;
+  orc_int8 var38;
+  orc_union16 var39;
+  orc_int8 var40;
+  orc_int8 var41;
+  orc_union16 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_int8 var45;
+  orc_union16 var46;
+
+  ptr0 = (orc_union16 *) d1;
+  ptr1 = (orc_union16 *) d2;
+  ptr4 = (orc_union16 *) s1;
+  ptr5 = (orc_union16 *) s2;
+  ptr6 = (orc_union16 *) s3;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var36 = ptr4[i];
+    /* 1: select0wb */
+    var37 = (orc_uint16) var36.i & 0xff;
+    /* 2: select1wb */
+    var38 = ((orc_uint16) var36.i >> 8) & 0xff;
+    /* 3: loadw */
+    var39 = ptr6[i];
+    /* 4: select0wb */
+    var40 = (orc_uint16) var39.i & 0xff;
+    /* 5: avgub */
+    var41 = ((orc_uint8) var37 + (orc_uint8) var40 + 1) >> 1;
+    /* 6: mergebw */
+    var42.i = ((orc_uint8) var37) | ((orc_uint8) var41 << 8);
+    /* 7: storew */
+    ptr0[i] = var42;
+    /* 8: loadw */
+    var43 = ptr5[i];
+    /* 9: select1wb */
+    var44 = ((orc_uint16) var43.i >> 8) & 0xff;
+    /* 10: avgub */
+    var45 = ((orc_uint8) var44 + (orc_uint8) var38 + 1) >> 1;
+    /* 11: mergebw */
+    var46.i = ((orc_uint8) var45) | ((orc_uint8) var38 << 8);
+    /* 12: storew */
+    ptr1[i] = var46;
+  }
+
+}
+
+#else
+static void
+_backup_bayer_orc_horiz_upsample (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union16 *ORC_RESTRICT ptr1;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  orc_union16 var36;
+  orc_int8 var37;
+  orc_int8 var38;
+  orc_union16 var39;
+  orc_int8 var40;
+  orc_int8 var41;
+  orc_union16 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_int8 var45;
+  orc_union16 var46;
+
+  ptr0 = (orc_union16 *) ex->arrays[0];
+  ptr1 = (orc_union16 *) ex->arrays[1];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+  ptr5 = (orc_union16 *) ex->arrays[5];
+  ptr6 = (orc_union16 *) ex->arrays[6];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var36 = ptr4[i];
+    /* 1: select0wb */
+    var37 = (orc_uint16) var36.i & 0xff;
+    /* 2: select1wb */
+    var38 = ((orc_uint16) var36.i >> 8) & 0xff;
+    /* 3: loadw */
+    var39 = ptr6[i];
+    /* 4: select0wb */
+    var40 = (orc_uint16) var39.i & 0xff;
+    /* 5: avgub */
+    var41 = ((orc_uint8) var37 + (orc_uint8) var40 + 1) >> 1;
+    /* 6: mergebw */
+    var42.i = ((orc_uint8) var37) | ((orc_uint8) var41 << 8);
+    /* 7: storew */
+    ptr0[i] = var42;
+    /* 8: loadw */
+    var43 = ptr5[i];
+    /* 9: select1wb */
+    var44 = ((orc_uint16) var43.i >> 8) & 0xff;
+    /* 10: avgub */
+    var45 = ((orc_uint8) var44 + (orc_uint8) var38 + 1) >> 1;
+    /* 11: mergebw */
+    var46.i = ((orc_uint8) var45) | ((orc_uint8) var38 << 8);
+    /* 12: storew */
+    ptr1[i] = var46;
+  }
+
+}
+
+static OrcProgram *_orc_program_bayer_orc_horiz_upsample;
+void
+bayer_orc_horiz_upsample (guint8 * d1, guint8 * d2, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_bayer_orc_horiz_upsample;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_D2] = d2;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* bayer_orc_merge_row */
+#ifdef DISABLE_ORC
+void
+bayer_orc_merge_row (guint8 * d1, guint8 * d2, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
+    int p1, int n)
+{
+  int i;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union16 *ORC_RESTRICT ptr1;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union16 var41;
+  orc_union16 var42;
+  orc_union16 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+
+  ptr0 = (orc_union16 *) d1;
+  ptr1 = (orc_union16 *) d2;
+  ptr4 = (orc_union16 *) s1;
+  ptr5 = (orc_union16 *) s2;
+  ptr6 = (orc_union16 *) s3;
+  ptr7 = (orc_union16 *) s4;
+  ptr8 = (orc_union16 *) s5;
+
+  /* 5: loadpw */
+  var39.i = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var34 = ptr5[i];
+    /* 1: loadw */
+    var35 = ptr6[i];
+    /* 2: avgub */
+    var36.x2[0] = ((orc_uint8) var34.x2[0] + (orc_uint8) var35.x2[0] + 1) >> 1;
+    var36.x2[1] = ((orc_uint8) var34.x2[1] + (orc_uint8) var35.x2[1] + 1) >> 1;
+    /* 3: loadw */
+    var37 = ptr4[i];
+    /* 4: avgub */
+    var38.x2[0] = ((orc_uint8) var37.x2[0] + (orc_uint8) var36.x2[0] + 1) >> 1;
+    var38.x2[1] = ((orc_uint8) var37.x2[1] + (orc_uint8) var36.x2[1] + 1) >> 1;
+    /* 6: andnw */
+    var40.i = (~var39.i) & var38.i;
+    /* 7: andw */
+    var41.i = var37.i & var39.i;
+    /* 8: orw */
+    var42.i = var41.i | var40.i;
+    /* 9: storew */
+    ptr0[i] = var42;
+    /* 10: loadw */
+    var43 = ptr7[i];
+    /* 11: loadw */
+    var44 = ptr8[i];
+    /* 12: avgub */
+    var45.x2[0] = ((orc_uint8) var43.x2[0] + (orc_uint8) var44.x2[0] + 1) >> 1;
+    var45.x2[1] = ((orc_uint8) var43.x2[1] + (orc_uint8) var44.x2[1] + 1) >> 1;
+    /* 13: storew */
+    ptr1[i] = var45;
+  }
+
+}
+
+#else
+static void
+_backup_bayer_orc_merge_row (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union16 *ORC_RESTRICT ptr1;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union16 var41;
+  orc_union16 var42;
+  orc_union16 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+
+  ptr0 = (orc_union16 *) ex->arrays[0];
+  ptr1 = (orc_union16 *) ex->arrays[1];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+  ptr5 = (orc_union16 *) ex->arrays[5];
+  ptr6 = (orc_union16 *) ex->arrays[6];
+  ptr7 = (orc_union16 *) ex->arrays[7];
+  ptr8 = (orc_union16 *) ex->arrays[8];
+
+  /* 5: loadpw */
+  var39.i = ex->params[24];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var34 = ptr5[i];
+    /* 1: loadw */
+    var35 = ptr6[i];
+    /* 2: avgub */
+    var36.x2[0] = ((orc_uint8) var34.x2[0] + (orc_uint8) var35.x2[0] + 1) >> 1;
+    var36.x2[1] = ((orc_uint8) var34.x2[1] + (orc_uint8) var35.x2[1] + 1) >> 1;
+    /* 3: loadw */
+    var37 = ptr4[i];
+    /* 4: avgub */
+    var38.x2[0] = ((orc_uint8) var37.x2[0] + (orc_uint8) var36.x2[0] + 1) >> 1;
+    var38.x2[1] = ((orc_uint8) var37.x2[1] + (orc_uint8) var36.x2[1] + 1) >> 1;
+    /* 6: andnw */
+    var40.i = (~var39.i) & var38.i;
+    /* 7: andw */
+    var41.i = var37.i & var39.i;
+    /* 8: orw */
+    var42.i = var41.i | var40.i;
+    /* 9: storew */
+    ptr0[i] = var42;
+    /* 10: loadw */
+    var43 = ptr7[i];
+    /* 11: loadw */
+    var44 = ptr8[i];
+    /* 12: avgub */
+    var45.x2[0] = ((orc_uint8) var43.x2[0] + (orc_uint8) var44.x2[0] + 1) >> 1;
+    var45.x2[1] = ((orc_uint8) var43.x2[1] + (orc_uint8) var44.x2[1] + 1) >> 1;
+    /* 13: storew */
+    ptr1[i] = var45;
+  }
+
+}
+
+static OrcProgram *_orc_program_bayer_orc_merge_row;
+void
+bayer_orc_merge_row (guint8 * d1, guint8 * d2, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
+    int p1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_bayer_orc_merge_row;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_D2] = d2;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->arrays[ORC_VAR_S5] = (void *) s5;
+  ex->params[ORC_VAR_P1] = p1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* bayer_orc_pack_4 */
+#ifdef DISABLE_ORC
+void
+bayer_orc_pack_4 (guint8 * d1, const guint8 * s1, const guint8 * s2,
+    const guint8 * s3, const guint8 * s4, int n)
+{
+  int i;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  orc_int8 var34;
+  orc_int8 var35;
+  orc_union16 var36;
+  orc_int8 var37;
+  orc_int8 var38;
+  orc_union16 var39;
+  orc_union32 var40;
+
+  ptr0 = (orc_union32 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+  ptr7 = (orc_int8 *) s4;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var34 = ptr4[i];
+    /* 1: loadb */
+    var35 = ptr5[i];
+    /* 2: mergebw */
+    var36.i = ((orc_uint8) var34) | ((orc_uint8) var35 << 8);
+    /* 3: loadb */
+    var37 = ptr6[i];
+    /* 4: loadb */
+    var38 = ptr7[i];
+    /* 5: mergebw */
+    var39.i = ((orc_uint8) var37) | ((orc_uint8) var38 << 8);
+    /* 6: mergewl */
+    var40.i = ((orc_uint16) var36.i) | ((orc_uint16) var39.i << 16);
+    /* 7: storel */
+    ptr0[i] = var40;
+  }
+
+}
+
+#else
+static void
+_backup_bayer_orc_pack_4 (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  orc_int8 var34;
+  orc_int8 var35;
+  orc_union16 var36;
+  orc_int8 var37;
+  orc_int8 var38;
+  orc_union16 var39;
+  orc_union32 var40;
+
+  ptr0 = (orc_union32 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+  ptr7 = (orc_int8 *) ex->arrays[7];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var34 = ptr4[i];
+    /* 1: loadb */
+    var35 = ptr5[i];
+    /* 2: mergebw */
+    var36.i = ((orc_uint8) var34) | ((orc_uint8) var35 << 8);
+    /* 3: loadb */
+    var37 = ptr6[i];
+    /* 4: loadb */
+    var38 = ptr7[i];
+    /* 5: mergebw */
+    var39.i = ((orc_uint8) var37) | ((orc_uint8) var38 << 8);
+    /* 6: mergewl */
+    var40.i = ((orc_uint16) var36.i) | ((orc_uint16) var39.i << 16);
+    /* 7: storel */
+    ptr0[i] = var40;
+  }
+
+}
+
+static OrcProgram *_orc_program_bayer_orc_pack_4;
+void
+bayer_orc_pack_4 (guint8 * d1, const guint8 * s1, const guint8 * s2,
+    const guint8 * s3, const guint8 * s4, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_bayer_orc_pack_4;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* bayer_orc_convert_16_to_8 */
+#ifdef DISABLE_ORC
+void
+bayer_orc_convert_16_to_8 (guint8 * d1, const guint16 * s1, int p1, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var33;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_int8 var36;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_union16 *) s1;
+
+  /* 1: loadpw */
+  var34.i = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var33 = ptr4[i];
+    /* 2: shruw */
+    var35.i = ((orc_uint16) var33.i) >> var34.i;
+    /* 3: convuuswb */
+    var36 = ORC_CLAMP_UB ((orc_uint16) var35.i);
+    /* 4: storeb */
+    ptr0[i] = var36;
+  }
+
+}
+
+#else
+static void
+_backup_bayer_orc_convert_16_to_8 (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var33;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_int8 var36;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+
+  /* 1: loadpw */
+  var34.i = ex->params[24];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var33 = ptr4[i];
+    /* 2: shruw */
+    var35.i = ((orc_uint16) var33.i) >> var34.i;
+    /* 3: convuuswb */
+    var36 = ORC_CLAMP_UB ((orc_uint16) var35.i);
+    /* 4: storeb */
+    ptr0[i] = var36;
+  }
+
+}
+
+static OrcProgram *_orc_program_bayer_orc_convert_16_to_8;
+void
+bayer_orc_convert_16_to_8 (guint8 * d1, const guint16 * s1, int p1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_bayer_orc_convert_16_to_8;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->params[ORC_VAR_P1] = p1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* bayer_orc_rgb_to_y */
+#ifdef DISABLE_ORC
+void
+bayer_orc_rgb_to_y (guint8 * d1, const guint8 * s1, const guint8 * s2,
+    const guint8 * s3, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_int8 var34;
+  orc_int8 var35;
+  orc_union16 var36;
+  orc_int8 var37;
+  orc_int8 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_int8 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_int8 var49;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+
+  /* 1: loadpb */
+  var35 = 0x00000042;              /* 66 */
+  /* 4: loadpb */
+  var38 = 0x00000081;              /* 129 */
+  /* 8: loadpb */
+  var42 = 0x00000019;              /* 25 */
+  /* 11: loadpw */
+  var45.i = 0x00001080;         /* 4224 */
+  /* 13: loadpw */
+  var47.i = 0x00000008;         /* 8 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var34 = ptr4[i];
+    /* 2: mulubw */
+    var36.i = (orc_uint8) var34 * (orc_uint8) var35;
+    /* 3: loadb */
+    var37 = ptr5[i];
+    /* 5: mulubw */
+    var39.i = (orc_uint8) var37 * (orc_uint8) var38;
+    /* 6: addw */
+    var40.i = var36.i + var39.i;
+    /* 7: loadb */
+    var41 = ptr6[i];
+    /* 9: mulubw */
+    var43.i = (orc_uint8) var41 * (orc_uint8) var42;
+    /* 10: addw */
+    var44.i = var40.i + var43.i;
+    /* 12: addw */
+    var46.i = var44.i + var45.i;
+    /* 14: shruw */
+    var48.i = ((orc_uint16) var46.i) >> var47.i;
+    /* 15: convwb */
+    var49 = var48.i;
+    /* 16: storeb */
+    ptr0[i] = var49;
+  }
+
+}
+
+#else
+static void
+_backup_bayer_orc_rgb_to_y (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_int8 var34;
+  orc_int8 var35;
+  orc_union16 var36;
+  orc_int8 var37;
+  orc_int8 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_int8 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_int8 var49;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+
+  /* 1: loadpb */
+  var35 = 0x00000042;              /* 66 */
+  /* 4: loadpb */
+  var38 = 0x00000081;              /* 129 */
+  /* 8: loadpb */
+  var42 = 0x00000019;              /* 25 */
+  /* 11: loadpw */
+  var45.i = 0x00001080;         /* 4224 */
+  /* 13: loadpw */
+  var47.i = 0x00000008;         /* 8 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var34 = ptr4[i];
+    /* 2: mulubw */
+    var36.i = (orc_uint8) var34 * (orc_uint8) var35;
+    /* 3: loadb */
+    var37 = ptr5[i];
+    /* 5: mulubw */
+    var39.i = (orc_uint8) var37 * (orc_uint8) var38;
+    /* 6: addw */
+    var40.i = var36.i + var39.i;
+    /* 7: loadb */
+    var41 = ptr6[i];
+    /* 9: mulubw */
+    var43.i = (orc_uint8) var41 * (orc_uint8) var42;
+    /* 10: addw */
+    var44.i = var40.i + var43.i;
+    /* 12: addw */
+    var46.i = var44.i + var45.i;
+    /* 14: shruw */
+    var48.i = ((orc_uint16) var46.i) >> var47.i;
+    /* 15: convwb */
+    var49 = var48.i;
+    /* 16: storeb */
+    ptr0[i] = var49;
+  }
+
+}
+
+static OrcProgram *_orc_program_bayer_orc_rgb_to_y;
+void
+bayer_orc_rgb_to_y (guint8 * d1, const guint8 * s1, const guint8 * s2,
+    const guint8 * s3, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_bayer_orc_rgb_to_y;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* bayer_orc_rgb_to_uv */
+#ifdef DISABLE_ORC
+void
+bayer_orc_rgb_to_uv (guint8 * d1, guint8 * d2, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
+    const guint8 * s6, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  orc_int8 *ORC_RESTRICT ptr1;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  const orc_union16 *ORC_RESTRICT ptr9;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union16 var41;
+  orc_int8 var42;
+  orc_int8 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_int8 var49;
+  orc_int8 var50;
+  orc_int8 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_int8 var56;
+  orc_int8 var57;
+  orc_int8 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_int8 var73;
+  orc_union16 var74;
+  orc_union16 var75;
+  orc_union16 var76;
+  orc_union16 var77;
+  orc_union16 var78;
+  orc_union16 var79;
+  orc_union16 var80;
+  orc_union16 var81;
+  orc_union16 var82;
+  orc_union16 var83;
+  orc_int8 var84;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr1 = (orc_int8 *) d2;
+  ptr4 = (orc_union16 *) s1;
+  ptr5 = (orc_union16 *) s2;
+  ptr6 = (orc_union16 *) s3;
+  ptr7 = (orc_union16 *) s4;
+  ptr8 = (orc_union16 *) s5;
+  ptr9 = (orc_union16 *) s6;
+
+  /* 21: loadpw */
+  var60.i = 0x00000070;         /* 112 */
+  /* 23: loadpw */
+  var62.i = 0x0000004a;         /* 74 */
+  /* 26: loadpw */
+  var65.i = 0x00000026;         /* 38 */
+  /* 29: loadpw */
+  var68.i = 0x00000080;         /* 128 */
+  /* 31: loadpw */
+  var70.i = 0x00000008;         /* 8 */
+  /* 37: loadpw */
+  var75.i = 0x0000005e;         /* 94 */
+  /* 40: loadpw */
+  var78.i = 0x00000012;         /* 18 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var39 = ptr4[i];
+    /* 1: loadw */
+    var40 = ptr5[i];
+    /* 2: avgub */
+    var41.x2[0] = ((orc_uint8) var39.x2[0] + (orc_uint8) var40.x2[0] + 1) >> 1;
+    var41.x2[1] = ((orc_uint8) var39.x2[1] + (orc_uint8) var40.x2[1] + 1) >> 1;
+    /* 3: select0wb */
+    var42 = (orc_uint16) var41.i & 0xff;
+    /* 4: select1wb */
+    var43 = ((orc_uint16) var41.i >> 8) & 0xff;
+    /* 5: avgub */
+    var44 = ((orc_uint8) var42 + (orc_uint8) var43 + 1) >> 1;
+    /* 6: convubw */
+    var45.i = (orc_uint8) var44;
+    /* 7: loadw */
+    var46 = ptr6[i];
+    /* 8: loadw */
+    var47 = ptr7[i];
+    /* 9: avgub */
+    var48.x2[0] = ((orc_uint8) var46.x2[0] + (orc_uint8) var47.x2[0] + 1) >> 1;
+    var48.x2[1] = ((orc_uint8) var46.x2[1] + (orc_uint8) var47.x2[1] + 1) >> 1;
+    /* 10: select0wb */
+    var49 = (orc_uint16) var48.i & 0xff;
+    /* 11: select1wb */
+    var50 = ((orc_uint16) var48.i >> 8) & 0xff;
+    /* 12: avgub */
+    var51 = ((orc_uint8) var49 + (orc_uint8) var50 + 1) >> 1;
+    /* 13: convubw */
+    var52.i = (orc_uint8) var51;
+    /* 14: loadw */
+    var53 = ptr8[i];
+    /* 15: loadw */
+    var54 = ptr9[i];
+    /* 16: avgub */
+    var55.x2[0] = ((orc_uint8) var53.x2[0] + (orc_uint8) var54.x2[0] + 1) >> 1;
+    var55.x2[1] = ((orc_uint8) var53.x2[1] + (orc_uint8) var54.x2[1] + 1) >> 1;
+    /* 17: select0wb */
+    var56 = (orc_uint16) var55.i & 0xff;
+    /* 18: select1wb */
+    var57 = ((orc_uint16) var55.i >> 8) & 0xff;
+    /* 19: avgub */
+    var58 = ((orc_uint8) var56 + (orc_uint8) var57 + 1) >> 1;
+    /* 20: convubw */
+    var59.i = (orc_uint8) var58;
+    /* 22: mullw */
+    var61.i = (var59.i * var60.i) & 0xffff;
+    /* 24: mullw */
+    var63.i = (var52.i * var62.i) & 0xffff;
+    /* 25: subw */
+    var64.i = var61.i - var63.i;
+    /* 27: mullw */
+    var66.i = (var45.i * var65.i) & 0xffff;
+    /* 28: subw */
+    var67.i = var64.i - var66.i;
+    /* 30: addw */
+    var69.i = var67.i + var68.i;
+    /* 32: shrsw */
+    var71.i = var69.i >> var70.i;
+    /* 33: addw */
+    var72.i = var71.i + var68.i;
+    /* 34: convsuswb */
+    var73 = ORC_CLAMP_UB (var72.i);
+    /* 35: storeb */
+    ptr0[i] = var73;
+    /* 36: mullw */
+    var74.i = (var45.i * var60.i) & 0xffff;
+    /* 38: mullw */
+    var76.i = (var52.i * var75.i) & 0xffff;
+    /* 39: subw */
+    var77.i = var74.i - var76.i;
+    /* 41: mullw */
+    var79.i = (var59.i * var78.i) & 0xffff;
+    /* 42: subw */
+    var80.i = var77.i - var79.i;
+    /* 43: addw */
+    var81.i = var80.i + var68.i;
+    /* 44: shrsw */
+    var82.i = var81.i >> var70.i;
+    /* 45: addw */
+    var83.i = var82.i + var68.i;
+    /* 46: convsuswb */
+    var84 = ORC_CLAMP_UB (var83.i);
+    /* 47: storeb */
+    ptr1[i] = var84;
+  }
+
+}
+
+#else
+static void
+_backup_bayer_orc_rgb_to_uv (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  orc_int8 *ORC_RESTRICT ptr1;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  const orc_union16 *ORC_RESTRICT ptr9;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union16 var41;
+  orc_int8 var42;
+  orc_int8 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_int8 var49;
+  orc_int8 var50;
+  orc_int8 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_int8 var56;
+  orc_int8 var57;
+  orc_int8 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_int8 var73;
+  orc_union16 var74;
+  orc_union16 var75;
+  orc_union16 var76;
+  orc_union16 var77;
+  orc_union16 var78;
+  orc_union16 var79;
+  orc_union16 var80;
+  orc_union16 var81;
+  orc_union16 var82;
+  orc_union16 var83;
+  orc_int8 var84;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr1 = (orc_int8 *) ex->arrays[1];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+  ptr5 = (orc_union16 *) ex->arrays[5];
+  ptr6 = (orc_union16 *) ex->arrays[6];
+  ptr7 = (orc_union16 *) ex->arrays[7];
+  ptr8 = (orc_union16 *) ex->arrays[8];
+  ptr9 = (orc_union16 *) ex->arrays[9];
+
+  /* 21: loadpw */
+  var60.i = 0x00000070;         /* 112 */
+  /* 23: loadpw */
+  var62.i = 0x0000004a;         /* 74 */
+  /* 26: loadpw */
+  var65.i = 0x00000026;         /* 38 */
+  /* 29: loadpw */
+  var68.i = 0x00000080;         /* 128 */
+  /* 31: loadpw */
+  var70.i = 0x00000008;         /* 8 */
+  /* 37: loadpw */
+  var75.i = 0x0000005e;         /* 94 */
+  /* 40: loadpw */
+  var78.i = 0x00000012;         /* 18 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var39 = ptr4[i];
+    /* 1: loadw */
+    var40 = ptr5[i];
+    /* 2: avgub */
+    var41.x2[0] = ((orc_uint8) var39.x2[0] + (orc_uint8) var40.x2[0] + 1) >> 1;
+    var41.x2[1] = ((orc_uint8) var39.x2[1] + (orc_uint8) var40.x2[1] + 1) >> 1;
+    /* 3: select0wb */
+    var42 = (orc_uint16) var41.i & 0xff;
+    /* 4: select1wb */
+    var43 = ((orc_uint16) var41.i >> 8) & 0xff;
+    /* 5: avgub */
+    var44 = ((orc_uint8) var42 + (orc_uint8) var43 + 1) >> 1;
+    /* 6: convubw */
+    var45.i = (orc_uint8) var44;
+    /* 7: loadw */
+    var46 = ptr6[i];
+    /* 8: loadw */
+    var47 = ptr7[i];
+    /* 9: avgub */
+    var48.x2[0] = ((orc_uint8) var46.x2[0] + (orc_uint8) var47.x2[0] + 1) >> 1;
+    var48.x2[1] = ((orc_uint8) var46.x2[1] + (orc_uint8) var47.x2[1] + 1) >> 1;
+    /* 10: select0wb */
+    var49 = (orc_uint16) var48.i & 0xff;
+    /* 11: select1wb */
+    var50 = ((orc_uint16) var48.i >> 8) & 0xff;
+    /* 12: avgub */
+    var51 = ((orc_uint8) var49 + (orc_uint8) var50 + 1) >> 1;
+    /* 13: convubw */
+    var52.i = (orc_uint8) var51;
+    /* 14: loadw */
+    var53 = ptr8[i];
+    /* 15: loadw */
+    var54 = ptr9[i];
+    /* 16: avgub */
+    var55.x2[0] = ((orc_uint8) var53.x2[0] + (orc_uint8) var54.x2[0] + 1) >> 1;
+    var55.x2[1] = ((orc_uint8) var53.x2[1] + (orc_uint8) var54.x2[1] + 1) >> 1;
+    /* 17: select0wb */
+    var56 = (orc_uint16) var55.i & 0xff;
+    /* 18: select1wb */
+    var57 = ((orc_uint16) var55.i >> 8) & 0xff;
+    /* 19: avgub */
+    var58 = ((orc_uint8) var56 + (orc_uint8) var57 + 1) >> 1;
+    /* 20: convubw */
+    var59.i = (orc_uint8) var58;
+    /* 22: mullw */
+    var61.i = (var59.i * var60.i) & 0xffff;
+    /* 24: mullw */
+    var63.i = (var52.i * var62.i) & 0xffff;
+    /* 25: subw */
+    var64.i = var61.i - var63.i;
+    /* 27: mullw */
+    var66.i = (var45.i * var65.i) & 0xffff;
+    /* 28: subw */
+    var67.i = var64.i - var66.i;
+    /* 30: addw */
+    var69.i = var67.i + var68.i;
+    /* 32: shrsw */
+    var71.i = var69.i >> var70.i;
+    /* 33: addw */
+    var72.i = var71.i + var68.i;
+    /* 34: convsuswb */
+    var73 = ORC_CLAMP_UB (var72.i);
+    /* 35: storeb */
+    ptr0[i] = var73;
+    /* 36: mullw */
+    var74.i = (var45.i * var60.i) & 0xffff;
+    /* 38: mullw */
+    var76.i = (var52.i * var75.i) & 0xffff;
+    /* 39: subw */
+    var77.i = var74.i - var76.i;
+    /* 41: mullw */
+    var79.i = (var59.i * var78.i) & 0xffff;
+    /* 42: subw */
+    var80.i = var77.i - var79.i;
+    /* 43: addw */
+    var81.i = var80.i + var68.i;
+    /* 44: shrsw */
+    var82.i = var81.i >> var70.i;
+    /* 45: addw */
+    var83.i = var82.i + var68.i;
+    /* 46: convsuswb */
+    var84 = ORC_CLAMP_UB (var83.i);
+    /* 47: storeb */
+    ptr1[i] = var84;
+  }
+
+}
+
+static OrcProgram *_orc_program_bayer_orc_rgb_to_uv;
+void
+bayer_orc_rgb_to_uv (guint8 * d1, guint8 * d2, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
+    const guint8 * s6, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_bayer_orc_rgb_to_uv;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_D2] = d2;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->arrays[ORC_VAR_S5] = (void *) s5;
+  ex->arrays[ORC_VAR_S6] = (void *) s6;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* bayer_orc_rgb_to_uv_interleaved */
+#ifdef DISABLE_ORC
+void
+bayer_orc_rgb_to_uv_interleaved (guint8 * d1, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
+    const guint8 * s6, int n)
+{
+  int i;
+  orc_union16 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  const orc_union16 *ORC_RESTRICT ptr9;
+  orc_union16 var41;
+  orc_union16 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_int8 var45;
+  orc_int8 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_int8 var51;
+  orc_int8 var52;
+  orc_int8 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_int8 var58;
+  orc_int8 var59;
+  orc_int8 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_union16 var73;
+  orc_union16 var74;
+  orc_int8 var75;
+  orc_union16 var76;
+  orc_union16 var77;
+  orc_union16 var78;
+  orc_union16 var79;
+  orc_union16 var80;
+  orc_union16 var81;
+  orc_union16 var82;
+  orc_union16 var83;
+  orc_union16 var84;
+  orc_union16 var85;
+  orc_int8 var86;
+  orc_union16 var87;
+
+  ptr0 = (orc_union16 *) d1;
+  ptr4 = (orc_union16 *) s1;
+  ptr5 = (orc_union16 *) s2;
+  ptr6 = (orc_union16 *) s3;
+  ptr7 = (orc_union16 *) s4;
+  ptr8 = (orc_union16 *) s5;
+  ptr9 = (orc_union16 *) s6;
+
+  /* 21: loadpw */
+  var62.i = 0x00000070;         /* 112 */
+  /* 23: loadpw */
+  var64.i = 0x0000004a;         /* 74 */
+  /* 26: loadpw */
+  var67.i = 0x00000026;         /* 38 */
+  /* 29: loadpw */
+  var70.i = 0x00000080;         /* 128 */
+  /* 31: loadpw */
+  var72.i = 0x00000008;         /* 8 */
+  /* 36: loadpw */
+  var77.i = 0x0000005e;         /* 94 */
+  /* 39: loadpw */
+  var80.i = 0x00000012;         /* 18 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var41 = ptr4[i];
+    /* 1: loadw */
+    var42 = ptr5[i];
+    /* 2: avgub */
+    var43.x2[0] = ((orc_uint8) var41.x2[0] + (orc_uint8) var42.x2[0] + 1) >> 1;
+    var43.x2[1] = ((orc_uint8) var41.x2[1] + (orc_uint8) var42.x2[1] + 1) >> 1;
+    /* 3: select0wb */
+    var44 = (orc_uint16) var43.i & 0xff;
+    /* 4: select1wb */
+    var45 = ((orc_uint16) var43.i >> 8) & 0xff;
+    /* 5: avgub */
+    var46 = ((orc_uint8) var44 + (orc_uint8) var45 + 1) >> 1;
+    /* 6: convubw */
+    var47.i = (orc_uint8) var46;
+    /* 7: loadw */
+    var48 = ptr6[i];
+    /* 8: loadw */
+    var49 = ptr7[i];
+    /* 9: avgub */
+    var50.x2[0] = ((orc_uint8) var48.x2[0] + (orc_uint8) var49.x2[0] + 1) >> 1;
+    var50.x2[1] = ((orc_uint8) var48.x2[1] + (orc_uint8) var49.x2[1] + 1) >> 1;
+    /* 10: select0wb */
+    var51 = (orc_uint16) var50.i & 0xff;
+    /* 11: select1wb */
+    var52 = ((orc_uint16) var50.i >> 8) & 0xff;
+    /* 12: avgub */
+    var53 = ((orc_uint8) var51 + (orc_uint8) var52 + 1) >> 1;
+    /* 13: convubw */
+    var54.i = (orc_uint8) var53;
+    /* 14: loadw */
+    var55 = ptr8[i];
+    /* 15: loadw */
+    var56 = ptr9[i];
+    /* 16: avgub */
+    var57.x2[0] = ((orc_uint8) var55.x2[0] + (orc_uint8) var56.x2[0] + 1) >> 1;
+    var57.x2[1] = ((orc_uint8) var55.x2[1] + (orc_uint8) var56.x2[1] + 1) >> 1;
+    /* 17: select0wb */
+    var58 = (orc_uint16) var57.i & 0xff;
+    /* 18: select1wb */
+    var59 = ((orc_uint16) var57.i >> 8) & 0xff;
+    /* 19: avgub */
+    var60 = ((orc_uint8) var58 + (orc_uint8) var59 + 1) >> 1;
+    /* 20: convubw */
+    var61.i = (orc_uint8) var60;
+    /* 22: mullw */
+    var63.i = (var61.i * var62.i) & 0xffff;
+    /* 24: mullw */
+    var65.i = (var54.i * var64.i) & 0xffff;
+    /* 25: subw */
+    var66.i = var63.i - var65.i;
+    /* 27: mullw */
+    var68.i = (var47.i * var67.i) & 0xffff;
+    /* 28: subw */
+    var69.i = var66.i - var68.i;
+    /* 30: addw */
+    var71.i = var69.i + var70.i;
+    /* 32: shrsw */
+    var73.i = var71.i >> var72.i;
+    /* 33: addw */
+    var74.i = var73.i + var70.i;
+    /* 34: convsuswb */
+    var75 = ORC_CLAMP_UB (var74.i);
+    /* 35: mullw */
+    var76.i = (var47.i * var62.i) & 0xffff;
+    /* 37: mullw */
+    var78.i = (var54.i * var77.i) & 0xffff;
+    /* 38: subw */
+    var79.i = var76.i - var78.i;
+    /* 40: mullw */
+    var81.i = (var61.i * var80.i) & 0xffff;
+    /* 41: subw */
+    var82.i = var79.i - var81.i;
+    /* 42: addw */
+    var83.i = var82.i + var70.i;
+    /* 43: shrsw */
+    var84.i = var83.i >> var72.i;
+    /* 44: addw */
+    var85.i = var84.i + var70.i;
+    /* 45: convsuswb */
+    var86 = ORC_CLAMP_UB (var85.i);
+    /* 46: mergebw */
+    var87.i = ((orc_uint8) var75) | ((orc_uint8) var86 << 8);
+    /* 47: storew */
+    ptr0[i] = var87;
+  }
+
+}
+
+#else
+static void
+_backup_bayer_orc_rgb_to_uv_interleaved (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  const orc_union16 *ORC_RESTRICT ptr7;
+  const orc_union16 *ORC_RESTRICT ptr8;
+  const orc_union16 *ORC_RESTRICT ptr9;
+  orc_union16 var41;
+  orc_union16 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_int8 var45;
+  orc_int8 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_int8 var51;
+  orc_int8 var52;
+  orc_int8 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_int8 var58;
+  orc_int8 var59;
+  orc_int8 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_union16 var73;
+  orc_union16 var74;
+  orc_int8 var75;
+  orc_union16 var76;
+  orc_union16 var77;
+  orc_union16 var78;
+  orc_union16 var79;
+  orc_union16 var80;
+  orc_union16 var81;
+  orc_union16 var82;
+  orc_union16 var83;
+  orc_union16 var84;
+  orc_union16 var85;
+  orc_int8 var86;
+  orc_union16 var87;
+
+  ptr0 = (orc_union16 *) ex->arrays[0];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+  ptr5 = (orc_union16 *) ex->arrays[5];
+  ptr6 = (orc_union16 *) ex->arrays[6];
+  ptr7 = (orc_union16 *) ex->arrays[7];
+  ptr8 = (orc_union16 *) ex->arrays[8];
+  ptr9 = (orc_union16 *) ex->arrays[9];
+
+  /* 21: loadpw */
+  var62.i = 0x00000070;         /* 112 */
+  /* 23: loadpw */
+  var64.i = 0x0000004a;         /* 74 */
+  /* 26: loadpw */
+  var67.i = 0x00000026;         /* 38 */
+  /* 29: loadpw */
+  var70.i = 0x00000080;         /* 128 */
+  /* 31: loadpw */
+  var72.i = 0x00000008;         /* 8 */
+  /* 36: loadpw */
+  var77.i = 0x0000005e;         /* 94 */
+  /* 39: loadpw */
+  var80.i = 0x00000012;         /* 18 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var41 = ptr4[i];
+    /* 1: loadw */
+    var42 = ptr5[i];
+    /* 2: avgub */
+    var43.x2[0] = ((orc_uint8) var41.x2[0] + (orc_uint8) var42.x2[0] + 1) >> 1;
+    var43.x2[1] = ((orc_uint8) var41.x2[1] + (orc_uint8) var42.x2[1] + 1) >> 1;
+    /* 3: select0wb */
+    var44 = (orc_uint16) var43.i & 0xff;
+    /* 4: select1wb */
+    var45 = ((orc_uint16) var43.i >> 8) & 0xff;
+    /* 5: avgub */
+    var46 = ((orc_uint8) var44 + (orc_uint8) var45 + 1) >> 1;
+    /* 6: convubw */
+    var47.i = (orc_uint8) var46;
+    /* 7: loadw */
+    var48 = ptr6[i];
+    /* 8: loadw */
+    var49 = ptr7[i];
+    /* 9: avgub */
+    var50.x2[0] = ((orc_uint8) var48.x2[0] + (orc_uint8) var49.x2[0] + 1) >> 1;
+    var50.x2[1] = ((orc_uint8) var48.x2[1] + (orc_uint8) var49.x2[1] + 1) >> 1;
+    /* 10: select0wb */
+    var51 = (orc_uint16) var50.i & 0xff;
+    /* 11: select1wb */
+    var52 = ((orc_uint16) var50.i >> 8) & 0xff;
+    /* 12: avgub */
+    var53 = ((orc_uint8) var51 + (orc_uint8) var52 + 1) >> 1;
+    /* 13: convubw */
+    var54.i = (orc_uint8) var53;
+    /* 14: loadw */
+    var55 = ptr8[i];
+    /* 15: loadw */
+    var56 = ptr9[i];
+    /* 16: avgub */
+    var57.x2[0] = ((orc_uint8) var55.x2[0] + (orc_uint8) var56.x2[0] + 1) >> 1;
+    var57.x2[1] = ((orc_uint8) var55.x2[1] + (orc_uint8) var56.x2[1] + 1) >> 1;
+    /* 17: select0wb */
+    var58 = (orc_uint16) var57.i & 0xff;
+    /* 18: select1wb */
+    var59 = ((orc_uint16) var57.i >> 8) & 0xff;
+    /* 19: avgub */
+    var60 = ((orc_uint8) var58 + (orc_uint8) var59 + 1) >> 1;
+    /* 20: convubw */
+    var61.i = (orc_uint8) var60;
+    /* 22: mullw */
+    var63.i = (var61.i * var62.i) & 0xffff;
+    /* 24: mullw */
+    var65.i = (var54.i * var64.i) & 0xffff;
+    /* 25: subw */
+    var66.i = var63.i - var65.i;
+    /* 27: mullw */
+    var68.i = (var47.i * var67.i) & 0xffff;
+    /* 28: subw */
+    var69.i = var66.i - var68.i;
+    /* 30: addw */
+    var71.i = var69.i + var70.i;
+    /* 32: shrsw */
+    var73.i = var71.i >> var72.i;
+    /* 33: addw */
+    var74.i = var73.i + var70.i;
+    /* 34: convsuswb */
+    var75 = ORC_CLAMP_UB (var74.i);
+    /* 35: mullw */
+    var76.i = (var47.i * var62.i) & 0xffff;
+    /* 37: mullw */
+    var78.i = (var54.i * var77.i) & 0xffff;
+    /* 38: subw */
+    var79.i = var76.i - var78.i;
+    /* 40: mullw */
+    var81.i = (var61.i * var80.i) & 0xffff;
+    /* 41: subw */
+    var82.i = var79.i - var81.i;
+    /* 42: addw */
+    var83.i = var82.i + var70.i;
+    /* 43: shrsw */
+    var84.i = var83.i >> var72.i;
+    /* 44: addw */
+    var85.i = var84.i + var70.i;
+    /* 45: convsuswb */
+    var86 = ORC_CLAMP_UB (var85.i);
+    /* 46: mergebw */
+    var87.i = ((orc_uint8) var75) | ((orc_uint8) var86 << 8);
+    /* 47: storew */
+    ptr0[i] = var87;
+  }
+
+}
+
+static OrcProgram *_orc_program_bayer_orc_rgb_to_uv_interleaved;
+void
+bayer_orc_rgb_to_uv_interleaved (guint8 * d1, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, const guint8 * s5,
+    const guint8 * s6, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_bayer_orc_rgb_to_uv_interleaved;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->arrays[ORC_VAR_S5] = (void *) s5;
+  ex->arrays[ORC_VAR_S6] = (void *) s6;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+void
+gst_bayer_orc_init (void)
+{
+#ifndef DISABLE_ORC
+  {
+    /* bayer_orc_horiz_upsample */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "bayer_orc_horiz_upsample");
+    orc_program_set_backup_function (p, _backup_bayer_orc_horiz_upsample);
+    orc_program_add_destination (p, 2, "d1");
+    orc_program_add_destination (p, 2, "d2");
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_source (p, 2, "s2");
+    orc_program_add_source (p, 2, "s3");
+    orc_program_add_temporary (p, 1, "t1");
+    orc_program_add_temporary (p, 1, "t2");
+    orc_program_add_temporary (p, 1, "t3");
+    orc_program_add_temporary (p, 1, "t4");
+
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select1wb", 0, ORC_VAR_T2, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 0, ORC_VAR_T4, ORC_VAR_T1, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mergebw", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select1wb", 0, ORC_VAR_T3, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 0, ORC_VAR_T4, ORC_VAR_T3, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mergebw", 0, ORC_VAR_D2, ORC_VAR_T4, ORC_VAR_T2,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_bayer_orc_horiz_upsample = p;
+  }
+  {
+    /* bayer_orc_merge_row */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "bayer_orc_merge_row");
+    orc_program_set_backup_function (p, _backup_bayer_orc_merge_row);
+    orc_program_add_destination (p, 2, "d1");
+    orc_program_add_destination (p, 2, "d2");
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_source (p, 2, "s2");
+    orc_program_add_source (p, 2, "s3");
+    orc_program_add_source (p, 2, "s4");
+    orc_program_add_source (p, 2, "s5");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+
+    orc_program_append_2 (p, "avgub", 1, ORC_VAR_T1, ORC_VAR_S2, ORC_VAR_S3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 1, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andnw", 0, ORC_VAR_T1, ORC_VAR_P1, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T2, ORC_VAR_S1, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "orw", 0, ORC_VAR_D1, ORC_VAR_T2, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 1, ORC_VAR_D2, ORC_VAR_S4, ORC_VAR_S5,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_bayer_orc_merge_row = p;
+  }
+  {
+    /* bayer_orc_pack_4 */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "bayer_orc_pack_4");
+    orc_program_set_backup_function (p, _backup_bayer_orc_pack_4);
+    orc_program_add_destination (p, 4, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_source (p, 1, "s4");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+
+    orc_program_append_2 (p, "mergebw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_S2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mergebw", 0, ORC_VAR_T2, ORC_VAR_S3, ORC_VAR_S4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mergewl", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_bayer_orc_pack_4 = p;
+  }
+  {
+    /* bayer_orc_convert_16_to_8 */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "bayer_orc_convert_16_to_8");
+    orc_program_set_backup_function (p, _backup_bayer_orc_convert_16_to_8);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_temporary (p, 2, "t1");
+
+    orc_program_append_2 (p, "shruw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convuuswb", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_bayer_orc_convert_16_to_8 = p;
+  }
+  {
+    /* bayer_orc_rgb_to_y */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "bayer_orc_rgb_to_y");
+    orc_program_set_backup_function (p, _backup_bayer_orc_rgb_to_y);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_constant (p, 4, 0x00000042, "c1");
+    orc_program_add_constant (p, 4, 0x00000081, "c2");
+    orc_program_add_constant (p, 4, 0x00000019, "c3");
+    orc_program_add_constant (p, 4, 0x00001080, "c4");
+    orc_program_add_constant (p, 4, 0x00000008, "c5");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+
+    orc_program_append_2 (p, "mulubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulubw", 0, ORC_VAR_T2, ORC_VAR_S3, ORC_VAR_C3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_C4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shruw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_C5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convwb", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_bayer_orc_rgb_to_y = p;
+  }
+  {
+    /* bayer_orc_rgb_to_uv */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "bayer_orc_rgb_to_uv");
+    orc_program_set_backup_function (p, _backup_bayer_orc_rgb_to_uv);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_destination (p, 1, "d2");
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_source (p, 2, "s2");
+    orc_program_add_source (p, 2, "s3");
+    orc_program_add_source (p, 2, "s4");
+    orc_program_add_source (p, 2, "s5");
+    orc_program_add_source (p, 2, "s6");
+    orc_program_add_constant (p, 4, 0x00000070, "c1");
+    orc_program_add_constant (p, 4, 0x0000004a, "c2");
+    orc_program_add_constant (p, 4, 0x00000026, "c3");
+    orc_program_add_constant (p, 4, 0x00000080, "c4");
+    orc_program_add_constant (p, 4, 0x00000008, "c5");
+    orc_program_add_constant (p, 4, 0x0000005e, "c6");
+    orc_program_add_constant (p, 4, 0x00000012, "c7");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 1, "t2");
+    orc_program_add_temporary (p, 1, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 2, "t6");
+    orc_program_add_temporary (p, 2, "t7");
+
+    orc_program_append_2 (p, "avgub", 1, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_S2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select1wb", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_T2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 1, ORC_VAR_T1, ORC_VAR_S3, ORC_VAR_S4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select1wb", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T5, ORC_VAR_T2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 1, ORC_VAR_T1, ORC_VAR_S5, ORC_VAR_S6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select1wb", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T6, ORC_VAR_T2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T7, ORC_VAR_T6, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T1, ORC_VAR_T5, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T1, ORC_VAR_T4, ORC_VAR_C3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shrsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convsuswb", 0, ORC_VAR_D1, ORC_VAR_T7, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T1, ORC_VAR_T5, ORC_VAR_C6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T1, ORC_VAR_T6, ORC_VAR_C7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shrsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convsuswb", 0, ORC_VAR_D2, ORC_VAR_T7, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_bayer_orc_rgb_to_uv = p;
+  }
+  {
+    /* bayer_orc_rgb_to_uv_interleaved */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "bayer_orc_rgb_to_uv_interleaved");
+    orc_program_set_backup_function (p,
+        _backup_bayer_orc_rgb_to_uv_interleaved);
+    orc_program_add_destination (p, 2, "d1");
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_source (p, 2, "s2");
+    orc_program_add_source (p, 2, "s3");
+    orc_program_add_source (p, 2, "s4");
+    orc_program_add_source (p, 2, "s5");
+    orc_program_add_source (p, 2, "s6");
+    orc_program_add_constant (p, 4, 0x00000070, "c1");
+    orc_program_add_constant (p, 4, 0x0000004a, "c2");
+    orc_program_add_constant (p, 4, 0x00000026, "c3");
+    orc_program_add_constant (p, 4, 0x00000080, "c4");
+    orc_program_add_constant (p, 4, 0x00000008, "c5");
+    orc_program_add_constant (p, 4, 0x0000005e, "c6");
+    orc_program_add_constant (p, 4, 0x00000012, "c7");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 1, "t2");
+    orc_program_add_temporary (p, 1, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 2, "t6");
+    orc_program_add_temporary (p, 2, "t7");
+    orc_program_add_temporary (p, 1, "t8");
+    orc_program_add_temporary (p, 1, "t9");
+
+    orc_program_append_2 (p, "avgub", 1, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_S2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select1wb", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_T2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 1, ORC_VAR_T1, ORC_VAR_S3, ORC_VAR_S4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select1wb", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T5, ORC_VAR_T2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 1, ORC_VAR_T1, ORC_VAR_S5, ORC_VAR_S6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select0wb", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "select1wb", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "avgub", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T6, ORC_VAR_T2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T7, ORC_VAR_T6, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T1, ORC_VAR_T5, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T1, ORC_VAR_T4, ORC_VAR_C3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shrsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convsuswb", 0, ORC_VAR_T8, ORC_VAR_T7, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T1, ORC_VAR_T5, ORC_VAR_C6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T1, ORC_VAR_T6, ORC_VAR_C7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shrsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convsuswb", 0, ORC_VAR_T9, ORC_VAR_T7, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mergebw", 0, ORC_VAR_D1, ORC_VAR_T8, ORC_VAR_T9,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_bayer_orc_rgb_to_uv_interleaved = p;
+  }
+#endif
+}
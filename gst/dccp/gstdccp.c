@@ -21,6 +21,11 @@
 #include "config.h"
 #endif
 
+/* for recvmmsg() and sendmmsg() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include "gstdccp.h"
 
 #ifdef HAVE_FIONREAD_IN_SYS_FILIO
@@ -159,6 +164,214 @@ gst_dccp_read_buffer (GstElement * this, int socket, GstBuffer ** buf)
   return GST_FLOW_OK;
 }
 
+/*
+ * Account one socket call that moved packets and bytes.
+ *
+ * @param element - the element owning the socket
+ * @param stats - the counters to update, may be NULL
+ */
+static void
+gst_dccp_stats_add (GstElement * element, GstDCCPStats * stats,
+    guint packets, gsize bytes, guint dropped)
+{
+  GstClockTime now;
+
+  if (stats == NULL)
+    return;
+
+  now = gst_util_get_timestamp ();
+
+  GST_OBJECT_LOCK (element);
+  if (packets > 0) {
+    if (!GST_CLOCK_TIME_IS_VALID (stats->first))
+      stats->first = now;
+    stats->last = now;
+  }
+  stats->packets += packets;
+  stats->bytes += bytes;
+  stats->dropped += dropped;
+  stats->syscalls++;
+  GST_OBJECT_UNLOCK (element);
+}
+
+/*
+ * Create a receive pool for packets of at most packet_size bytes.
+ *
+ * @param packet_size - the MTU
+ * @return the new pool
+ */
+GstDCCPBufferPool *
+gst_dccp_buffer_pool_new (gint packet_size)
+{
+  GstDCCPBufferPool *pool;
+
+  g_return_val_if_fail (packet_size > 0, NULL);
+
+  pool = g_new0 (GstDCCPBufferPool, 1);
+  pool->packet_size = packet_size;
+  g_queue_init (&pool->packets);
+
+  return pool;
+}
+
+void
+gst_dccp_buffer_pool_free (GstDCCPBufferPool * pool)
+{
+  GstBuffer *buf;
+  guint i;
+
+  if (pool == NULL)
+    return;
+
+  while ((buf = g_queue_pop_head (&pool->packets)))
+    gst_buffer_unref (buf);
+
+  for (i = 0; i < DCCP_POOL_SLABS; i++) {
+    if (pool->slabs[i])
+      gst_buffer_unref (pool->slabs[i]);
+  }
+
+  g_free (pool);
+}
+
+#ifdef HAVE_RECVMMSG
+/*
+ * Get a slab to read the next batch of packets into. A slab is free again
+ * when we hold the only reference, i.e. downstream released all the packets
+ * that were read into it. If all slabs are still in use, the oldest one is
+ * left to downstream and replaced by a new one.
+ */
+static GstBuffer *
+gst_dccp_buffer_pool_get_slab (GstDCCPBufferPool * pool)
+{
+  GstBuffer *slab;
+  guint i, idx;
+
+  for (i = 0; i < DCCP_POOL_SLABS; i++) {
+    idx = (pool->next_slab + i) % DCCP_POOL_SLABS;
+    slab = pool->slabs[idx];
+
+    if (slab == NULL ||
+        g_atomic_int_get (&GST_MINI_OBJECT_CAST (slab)->refcount) == 1)
+      break;
+  }
+  if (i == DCCP_POOL_SLABS)
+    idx = pool->next_slab;
+
+  slab = pool->slabs[idx];
+  if (slab == NULL || i == DCCP_POOL_SLABS) {
+    if (slab)
+      gst_buffer_unref (slab);
+    slab = gst_buffer_new_and_alloc (pool->packet_size * DCCP_BATCH_SIZE);
+    pool->slabs[idx] = slab;
+  }
+  pool->next_slab = (idx + 1) % DCCP_POOL_SLABS;
+
+  return slab;
+}
+#endif
+
+/*
+ * Read a buffer from the given socket, going through the pool. Where
+ * recvmmsg() is available, all packets that are pending on the socket, up to
+ * DCCP_BATCH_SIZE, are read at once into a slab of the pool and returned one
+ * by one on the next calls, without copying them.
+ *
+ * @param this - the element that has the socket that will be read
+ * @param socket - the socket fd that will be read
+ * @param pool - the receive pool of the socket
+ * @param stats - the counters of the socket, may be NULL
+ * @param buf - the buffer with the data read from the socket
+ * @return GST_FLOW_OK if the read operation was successful
+ * or GST_FLOW_ERROR indicating a connection close or an error.
+ * Handle it with EOS.
+ */
+GstFlowReturn
+gst_dccp_read_batch (GstElement * this, int socket, GstDCCPBufferPool * pool,
+    GstDCCPStats * stats, GstBuffer ** buf)
+{
+#ifdef HAVE_RECVMMSG
+  struct mmsghdr msgs[DCCP_BATCH_SIZE];
+  struct iovec iov[DCCP_BATCH_SIZE];
+  GstBuffer *slab;
+  guint8 *data;
+  gsize bytes;
+  guint truncated, packets;
+  int i, n;
+
+  while (g_queue_is_empty (&pool->packets) && !pool->eos) {
+    slab = gst_dccp_buffer_pool_get_slab (pool);
+    data = GST_BUFFER_DATA (slab);
+
+    memset (msgs, 0, sizeof (msgs));
+    for (i = 0; i < DCCP_BATCH_SIZE; i++) {
+      iov[i].iov_base = data + i * pool->packet_size;
+      iov[i].iov_len = pool->packet_size;
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    /* block for the first packet only, then take what is already there */
+    do {
+      n = recvmmsg (socket, msgs, DCCP_BATCH_SIZE, MSG_WAITFORONE, NULL);
+    } while (n < 0 && errno == EINTR);
+
+    if (n < 0) {
+      GST_ELEMENT_ERROR (this, RESOURCE, READ, (NULL),
+          ("recvmmsg failed: %s", g_strerror (errno)));
+      return GST_FLOW_ERROR;
+    }
+
+    bytes = 0;
+    truncated = packets = 0;
+    for (i = 0; i < n; i++) {
+      guint len = msgs[i].msg_len;
+
+      if (len == 0) {
+        /* orderly shutdown of the connection */
+        pool->eos = TRUE;
+        break;
+      }
+      if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+        truncated++;
+        continue;
+      }
+
+      g_queue_push_tail (&pool->packets,
+          gst_buffer_create_sub (slab, i * pool->packet_size, len));
+      bytes += len;
+      packets++;
+    }
+
+    GST_LOG_OBJECT (this, "read %u packets, %" G_GSIZE_FORMAT " bytes",
+        packets, bytes);
+
+    gst_dccp_stats_add (this, stats, packets, bytes, truncated);
+
+    if (truncated > 0) {
+      GST_ELEMENT_WARNING (this, RESOURCE, READ, (NULL),
+          ("Dropped %u packets larger than %d bytes", truncated,
+              pool->packet_size));
+    }
+  }
+
+  if ((*buf = g_queue_pop_head (&pool->packets)) == NULL) {
+    GST_DEBUG_OBJECT (this, "Got EOS on socket stream");
+    return GST_FLOW_UNEXPECTED;
+  }
+
+  return GST_FLOW_OK;
+#else
+  GstFlowReturn ret;
+
+  ret = gst_dccp_read_buffer (this, socket, buf);
+  if (ret == GST_FLOW_OK)
+    gst_dccp_stats_add (this, stats, 1, GST_BUFFER_SIZE (*buf), 0);
+
+  return ret;
+#endif
+}
+
 /* Create a new DCCP socket
  *
  * @param element - the element
@@ -319,6 +532,7 @@ gst_dccp_listen_server_socket (GstElement * element, int server_sock_fd)
   return TRUE;
 }
 
+#ifndef HAVE_SENDMMSG
 /* Write buffer to given socket incrementally.
  *
  * @param element - the element
@@ -326,11 +540,12 @@ gst_dccp_listen_server_socket (GstElement * element, int server_sock_fd)
  * @param buf - the buffer that will be written
  * @param size - the number of bytes of the buffer
  * @param packet_size - the MTU
+ * @param stats - the counters of the socket, may be NULL
  * @return the number of bytes written.
  */
 static GstFlowReturn
 gst_dccp_socket_write (GstElement * element, int socket, const void *buf,
-    size_t size, int packet_size)
+    size_t size, int packet_size, GstDCCPStats * stats)
 {
   size_t bytes_written = 0;
   ssize_t wrote;
@@ -363,6 +578,8 @@ gst_dccp_socket_write (GstElement * element, int socket, const void *buf,
 #endif
 
     /* TODO print the send error */
+    if (wrote > 0)
+      gst_dccp_stats_add (element, stats, 1, wrote, 0);
     bytes_written += wrote;
   }
 
@@ -373,6 +590,7 @@ gst_dccp_socket_write (GstElement * element, int socket, const void *buf,
         bytes_written);
 
   if (bytes_written != size) {
+    gst_dccp_stats_add (element, stats, 0, 0, 1);
     GST_ELEMENT_ERROR (element, RESOURCE, WRITE,
         ("Error while sending data to socket %d.", socket),
         ("Only %" G_GSIZE_FORMAT " of %" G_GSIZE_FORMAT " bytes written: %s",
@@ -382,6 +600,185 @@ gst_dccp_socket_write (GstElement * element, int socket, const void *buf,
 
   return GST_FLOW_OK;
 }
+#else
+#define DCCP_MAX_IOV (DCCP_BATCH_SIZE * 4)
+
+/*
+ * Packets collected for a single sendmmsg() call. Each message gathers the
+ * memory of one or more buffers without copying it.
+ */
+typedef struct
+{
+  GstElement *element;
+  int socket;
+  gsize packet_size;
+  GstDCCPStats *stats;
+
+  struct mmsghdr msgs[DCCP_BATCH_SIZE];
+  struct iovec iov[DCCP_MAX_IOV];
+  guint n_msgs;
+  guint n_iov;
+  guint first_iov;              /* first iovec of the message being filled */
+  gsize msg_size;               /* bytes in the message being filled */
+} GstDCCPSendBatch;
+
+static void
+gst_dccp_send_batch_init (GstDCCPSendBatch * batch, GstElement * element,
+    int socket, int packet_size, GstDCCPStats * stats)
+{
+  batch->element = element;
+  batch->socket = socket;
+  batch->packet_size = packet_size;
+  batch->stats = stats;
+  batch->n_msgs = batch->n_iov = batch->first_iov = 0;
+  batch->msg_size = 0;
+}
+
+/* finish the message being filled, if any */
+static void
+gst_dccp_send_batch_end_message (GstDCCPSendBatch * batch)
+{
+  struct msghdr *mh;
+
+  if (batch->msg_size == 0)
+    return;
+
+  mh = &batch->msgs[batch->n_msgs].msg_hdr;
+  memset (mh, 0, sizeof (*mh));
+  mh->msg_iov = &batch->iov[batch->first_iov];
+  mh->msg_iovlen = batch->n_iov - batch->first_iov;
+
+  batch->first_iov = batch->n_iov;
+  batch->msg_size = 0;
+  batch->n_msgs++;
+}
+
+static GstFlowReturn
+gst_dccp_send_batch_flush (GstDCCPSendBatch * batch)
+{
+  guint sent = 0;
+  gsize bytes;
+  int i, ret;
+
+  gst_dccp_send_batch_end_message (batch);
+
+  while (sent < batch->n_msgs) {
+    ret = sendmmsg (batch->socket, batch->msgs + sent, batch->n_msgs - sent, 0);
+
+    if (ret < 0) {
+      /* EAGAIN when the TX queue is full */
+      if (errno == EAGAIN || errno == EINTR)
+        continue;
+      goto write_error;
+    }
+
+    bytes = 0;
+    for (i = 0; i < ret; i++)
+      bytes += batch->msgs[sent + i].msg_len;
+    gst_dccp_stats_add (batch->element, batch->stats, ret, bytes, 0);
+
+    sent += ret;
+  }
+
+  GST_LOG_OBJECT (batch->element, "Wrote %u packets succesfully.", sent);
+
+  batch->n_msgs = batch->n_iov = batch->first_iov = 0;
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+write_error:
+  {
+    gst_dccp_stats_add (batch->element, batch->stats, 0, 0,
+        batch->n_msgs - sent);
+    GST_ELEMENT_ERROR (batch->element, RESOURCE, WRITE,
+        ("Error while sending data to socket %d.", batch->socket),
+        ("Only %u of %u packets written: %s", sent, batch->n_msgs,
+            g_strerror (errno)));
+    batch->n_msgs = batch->n_iov = batch->first_iov = 0;
+    return GST_FLOW_ERROR;
+  }
+}
+
+/* end the current message, sending the batch once it is full */
+static GstFlowReturn
+gst_dccp_send_batch_close (GstDCCPSendBatch * batch)
+{
+  gst_dccp_send_batch_end_message (batch);
+
+  if (batch->n_msgs == DCCP_BATCH_SIZE)
+    return gst_dccp_send_batch_flush (batch);
+
+  return GST_FLOW_OK;
+}
+
+/* The iovec array is full: send the finished messages and move the iovecs
+ * of the message being filled to the front, so that it still goes out as
+ * one packet. */
+static GstFlowReturn
+gst_dccp_send_batch_make_room (GstDCCPSendBatch * batch)
+{
+  GstFlowReturn ret;
+  guint first_iov, n_partial;
+  gsize msg_size;
+
+  first_iov = batch->first_iov;
+  n_partial = batch->n_iov - first_iov;
+  msg_size = batch->msg_size;
+
+  if (first_iov == 0) {
+    /* a single message uses all iovecs, nothing we can do but split it */
+    GST_WARNING_OBJECT (batch->element, "packet needs more than %d iovecs, "
+        "splitting it", DCCP_MAX_IOV);
+    return gst_dccp_send_batch_flush (batch);
+  }
+
+  /* only send the finished messages */
+  batch->n_iov = first_iov;
+  batch->msg_size = 0;
+  if ((ret = gst_dccp_send_batch_flush (batch)) != GST_FLOW_OK)
+    return ret;
+
+  memmove (batch->iov, batch->iov + first_iov,
+      n_partial * sizeof (struct iovec));
+  batch->n_iov = n_partial;
+  batch->msg_size = msg_size;
+
+  return GST_FLOW_OK;
+}
+
+/* append data, split in messages of at most packet_size bytes */
+static GstFlowReturn
+gst_dccp_send_batch_add (GstDCCPSendBatch * batch, guint8 * data, gsize size)
+{
+  GstFlowReturn ret;
+  gsize len;
+
+  while (size > 0) {
+    if (batch->n_iov == DCCP_MAX_IOV) {
+      if ((ret = gst_dccp_send_batch_make_room (batch)) != GST_FLOW_OK)
+        return ret;
+    }
+
+    len = MIN (size, batch->packet_size - batch->msg_size);
+
+    batch->iov[batch->n_iov].iov_base = data;
+    batch->iov[batch->n_iov].iov_len = len;
+    batch->n_iov++;
+    batch->msg_size += len;
+
+    data += len;
+    size -= len;
+
+    if (batch->msg_size == batch->packet_size) {
+      if ((ret = gst_dccp_send_batch_close (batch)) != GST_FLOW_OK)
+        return ret;
+    }
+  }
+
+  return GST_FLOW_OK;
+}
+#endif
 
 /* Write buffer to given socket.
  *
@@ -389,13 +786,17 @@ gst_dccp_socket_write (GstElement * element, int socket, const void *buf,
  * @param buf - the buffer that will be written
  * @param client_sock_fd - the client socket
  * @param packet_size - the MTU
+ * @param stats - the counters of the socket, may be NULL
  * @return GST_FLOW_OK if the send operation was successful, GST_FLOW_ERROR otherwise.
  */
 GstFlowReturn
 gst_dccp_send_buffer (GstElement * this, GstBuffer * buffer, int client_sock_fd,
-    int packet_size)
+    int packet_size, GstDCCPStats * stats)
 {
-//  size_t wrote;
+#ifdef HAVE_SENDMMSG
+  GstDCCPSendBatch batch;
+  GstFlowReturn ret;
+#endif
   gint size = 0;
   guint8 *data;
 
@@ -404,11 +805,88 @@ gst_dccp_send_buffer (GstElement * this, GstBuffer * buffer, int client_sock_fd,
 
   GST_LOG_OBJECT (this, "writing %d bytes", size);
 
-  if (packet_size < 0) {
+  if (packet_size <= 0) {
     return GST_FLOW_ERROR;
   }
+#ifdef HAVE_SENDMMSG
+  gst_dccp_send_batch_init (&batch, this, client_sock_fd, packet_size, stats);
 
-  return gst_dccp_socket_write (this, client_sock_fd, data, size, packet_size);
+  if ((ret = gst_dccp_send_batch_add (&batch, data, size)) != GST_FLOW_OK)
+    return ret;
+
+  return gst_dccp_send_batch_flush (&batch);
+#else
+  return gst_dccp_socket_write (this, client_sock_fd, data, size, packet_size,
+      stats);
+#endif
+}
+
+/* Write a buffer list to given socket. Every group of the list is sent as
+ * one packet, split in more packets if it is larger than the MTU.
+ *
+ * @param this - the element
+ * @param list - the buffer list that will be written
+ * @param client_sock_fd - the client socket
+ * @param packet_size - the MTU
+ * @param stats - the counters of the socket, may be NULL
+ * @return GST_FLOW_OK if the send operation was successful, GST_FLOW_ERROR otherwise.
+ */
+GstFlowReturn
+gst_dccp_send_buffer_list (GstElement * this, GstBufferList * list,
+    int client_sock_fd, int packet_size, GstDCCPStats * stats)
+{
+#ifdef HAVE_SENDMMSG
+  GstDCCPSendBatch batch;
+#endif
+  GstBufferListIterator *it;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstBuffer *buf;
+
+  if (packet_size <= 0) {
+    return GST_FLOW_ERROR;
+  }
+
+  it = gst_buffer_list_iterate (list);
+
+#ifdef HAVE_SENDMMSG
+  gst_dccp_send_batch_init (&batch, this, client_sock_fd, packet_size, stats);
+
+  while (ret == GST_FLOW_OK && gst_buffer_list_iterator_next_group (it)) {
+    if (gst_buffer_list_iterator_n_buffers (it) >= DCCP_MAX_IOV) {
+      /* too many pieces to gather, copy them in one buffer */
+      buf = gst_buffer_list_iterator_merge_group (it);
+      ret = gst_dccp_send_batch_add (&batch, GST_BUFFER_DATA (buf),
+          GST_BUFFER_SIZE (buf));
+      /* the batch points into the merged copy, send it before freeing it */
+      if (ret == GST_FLOW_OK)
+        ret = gst_dccp_send_batch_flush (&batch);
+      gst_buffer_unref (buf);
+    } else {
+      while (ret == GST_FLOW_OK && (buf = gst_buffer_list_iterator_next (it))) {
+        ret = gst_dccp_send_batch_add (&batch, GST_BUFFER_DATA (buf),
+            GST_BUFFER_SIZE (buf));
+      }
+    }
+    if (ret == GST_FLOW_OK)
+      ret = gst_dccp_send_batch_close (&batch);
+  }
+  if (ret == GST_FLOW_OK)
+    ret = gst_dccp_send_batch_flush (&batch);
+#else
+  while (ret == GST_FLOW_OK && gst_buffer_list_iterator_next_group (it)) {
+    if (gst_buffer_list_iterator_n_buffers (it) == 0)
+      continue;
+
+    buf = gst_buffer_list_iterator_merge_group (it);
+    ret = gst_dccp_socket_write (this, client_sock_fd, GST_BUFFER_DATA (buf),
+        GST_BUFFER_SIZE (buf), packet_size, stats);
+    gst_buffer_unref (buf);
+  }
+#endif
+
+  gst_buffer_list_iterator_free (it);
+
+  return ret;
 }
 
 /*
@@ -485,6 +963,38 @@ gst_dccp_set_ccid (GstElement * element, int sock_fd, uint8_t ccid)
   return TRUE;
 }
 
+/*
+ * Limit the number of packets the kernel queues for sending. When the queue
+ * is full, sending blocks until the CCID lets packets out, so a short queue
+ * trades throughput for latency.
+ * @param element - the element
+ * @param sock_fd - the socket
+ * @param qlen - the queue length in packets, 0 keeps the kernel default
+ * @return TRUE if the operation was successful, FALSE otherwise.
+ */
+gboolean
+gst_dccp_set_tx_qlen (GstElement * element, int sock_fd, guint qlen)
+{
+  int val = qlen;
+
+  if (qlen == 0)
+    return TRUE;
+
+#ifndef G_OS_WIN32
+  if (setsockopt (sock_fd, SOL_DCCP, DCCP_SOCKOPT_QPOLICY_TXQLEN, &val,
+#else
+  if (setsockopt (sock_fd, SOL_DCCP, DCCP_SOCKOPT_QPOLICY_TXQLEN, (char *) &val,
+#endif
+          sizeof (val)) < 0) {
+    GST_ERROR_OBJECT (element, "Can not set TX queue length: %s",
+        g_strerror (errno));
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (element, "TX queue length: %u", qlen);
+  return TRUE;
+}
+
 #if 0
 /*
  * Get the current ccid of TX or RX half-connection. tx_or_rx parameter must be
@@ -555,3 +1065,79 @@ gst_dccp_socket_close (GstElement * element, int *socket)
     *socket = -1;
   }
 }
+
+void
+gst_dccp_stats_reset (GstDCCPStats * stats)
+{
+  memset (stats, 0, sizeof (GstDCCPStats));
+  stats->first = GST_CLOCK_TIME_NONE;
+  stats->last = GST_CLOCK_TIME_NONE;
+}
+
+/* same layout as struct tfrc_tx_info and tfrc_rx_info in linux/tfrc.h */
+struct gst_dccp_tfrc_tx_info
+{
+  guint64 tfrc_x;
+  guint64 tfrc_x_recv;
+  guint32 tfrc_x_calc;
+  guint32 tfrc_rtt;
+  guint32 tfrc_p;
+  guint32 tfrc_rto;
+  guint32 tfrc_ipi;
+};
+
+struct gst_dccp_tfrc_rx_info
+{
+  guint32 tfrc_x_recv;
+  guint32 tfrc_rtt;
+  guint32 tfrc_p;
+};
+
+/*
+ * Describe the counters of a socket. The loss event rate is only known for
+ * CCID 3 (TFRC) half-connections, it is -1 otherwise.
+ * @param sock_fd - the socket, or -1 if not connected
+ * @param stats - a copy of the counters of the socket
+ * @param tx - TRUE for the sending half-connection, FALSE for receiving
+ * @return a new "application/x-dccp-stats" structure
+ */
+GstStructure *
+gst_dccp_stats_to_structure (int sock_fd, const GstDCCPStats * stats,
+    gboolean tx)
+{
+  gdouble bitrate = 0.0;
+  gdouble loss_rate = -1.0;
+
+  if (GST_CLOCK_TIME_IS_VALID (stats->first) && stats->last > stats->first) {
+    bitrate = (gdouble) stats->bytes * 8 * GST_SECOND /
+        (stats->last - stats->first);
+  }
+#ifndef G_OS_WIN32
+  if (sock_fd >= 0) {
+    struct gst_dccp_tfrc_tx_info tx_info;
+    struct gst_dccp_tfrc_rx_info rx_info;
+    socklen_t len;
+
+    /* the loss event rate is scaled by 10^6 */
+    if (tx) {
+      len = sizeof (tx_info);
+      if (getsockopt (sock_fd, SOL_DCCP, DCCP_SOCKOPT_CCID_TX_INFO, &tx_info,
+              &len) == 0 && len == sizeof (tx_info))
+        loss_rate = tx_info.tfrc_p / 1000000.0;
+    } else {
+      len = sizeof (rx_info);
+      if (getsockopt (sock_fd, SOL_DCCP, DCCP_SOCKOPT_CCID_RX_INFO, &rx_info,
+              &len) == 0 && len == sizeof (rx_info))
+        loss_rate = rx_info.tfrc_p / 1000000.0;
+    }
+  }
+#endif
+
+  return gst_structure_new ("application/x-dccp-stats",
+      "packets", G_TYPE_UINT64, stats->packets,
+      "bytes", G_TYPE_UINT64, stats->bytes,
+      "syscalls", G_TYPE_UINT64, stats->syscalls,
+      "dropped", G_TYPE_UINT64, stats->dropped,
+      "bitrate", G_TYPE_DOUBLE, bitrate,
+      "loss-rate", G_TYPE_DOUBLE, loss_rate, NULL);
+}
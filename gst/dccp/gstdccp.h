@@ -51,6 +51,8 @@
 #define DCCP_SOCKOPT_CCID               13
 #define DCCP_SOCKOPT_TX_CCID            14
 #define DCCP_SOCKOPT_RX_CCID            15
+#define DCCP_SOCKOPT_QPOLICY_ID         16
+#define DCCP_SOCKOPT_QPOLICY_TXQLEN     17
 #define DCCP_SOCKOPT_CCID_RX_INFO       128
 #define DCCP_SOCKOPT_CCID_TX_INFO       192
 
@@ -62,14 +64,57 @@
 #define DCCP_DEFAULT_WAIT_CONNECTIONS	 FALSE
 #define DCCP_DEFAULT_HOST		 "127.0.0.1"
 #define DCCP_DEFAULT_CCID		 2
+#define DCCP_DEFAULT_TX_QLEN		 0
+
+/* packets moved per recvmmsg()/sendmmsg() call */
+#define DCCP_BATCH_SIZE			 32
+/* slabs of DCCP_BATCH_SIZE packets kept around by the receive pool */
+#define DCCP_POOL_SLABS			 4
 
 #define DCCP_DELTA			 100
 
+typedef struct _GstDCCPStats GstDCCPStats;
+typedef struct _GstDCCPBufferPool GstDCCPBufferPool;
+
+/*
+ * Per-socket traffic counters, updated with the object lock of the element
+ * owning the socket.
+ */
+struct _GstDCCPStats
+{
+  guint64 packets;
+  guint64 bytes;
+  guint64 syscalls;
+  guint64 dropped;              /* truncated on receive, failed on send */
+  GstClockTime first;           /* time of the first packet */
+  GstClockTime last;            /* time of the last packet */
+};
+
+/*
+ * Receive side buffer pool. Packets are read in batches into slabs of
+ * DCCP_BATCH_SIZE packet-sized slots and handed out as subbuffers, so a slab
+ * is reused once downstream has released all of its packets.
+ */
+struct _GstDCCPBufferPool
+{
+  GstBuffer *slabs[DCCP_POOL_SLABS];
+  guint next_slab;
+  gint packet_size;
+  GQueue packets;               /* read from the socket, not yet pushed */
+  gboolean eos;
+};
+
 gchar *gst_dccp_host_to_ip (GstElement * element, const gchar * host);
 
 GstFlowReturn gst_dccp_read_buffer (GstElement * this, int socket,
 				GstBuffer ** buf);
 
+GstDCCPBufferPool *gst_dccp_buffer_pool_new (gint packet_size);
+void gst_dccp_buffer_pool_free (GstDCCPBufferPool * pool);
+GstFlowReturn gst_dccp_read_batch (GstElement * this, int socket,
+				GstDCCPBufferPool * pool, GstDCCPStats * stats,
+				GstBuffer ** buf);
+
 gint gst_dccp_create_new_socket (GstElement * element);
 gboolean gst_dccp_connect_to_server (GstElement * element,
 				 struct sockaddr_in server_sin,
@@ -82,11 +127,20 @@ gboolean gst_dccp_bind_server_socket (GstElement * element, int server_sock_fd,
 
 gboolean gst_dccp_listen_server_socket (GstElement * element, int server_sock_fd);
 gboolean gst_dccp_set_ccid (GstElement * element, int sock_fd, uint8_t ccid);
+gboolean gst_dccp_set_tx_qlen (GstElement * element, int sock_fd, guint qlen);
 
 gint gst_dccp_get_max_packet_size(GstElement * element, int sock);
 
 GstFlowReturn gst_dccp_send_buffer (GstElement * element, GstBuffer * buffer,
-					int client_sock_fd, int packet_size);
+					int client_sock_fd, int packet_size,
+					GstDCCPStats * stats);
+GstFlowReturn gst_dccp_send_buffer_list (GstElement * element,
+					GstBufferList * list, int client_sock_fd,
+					int packet_size, GstDCCPStats * stats);
+
+void gst_dccp_stats_reset (GstDCCPStats * stats);
+GstStructure *gst_dccp_stats_to_structure (int sock_fd,
+					const GstDCCPStats * stats, gboolean tx);
 
 gboolean gst_dccp_make_address_reusable (GstElement * element, int sock_fd);
 void gst_dccp_socket_close (GstElement * element, int * socket);
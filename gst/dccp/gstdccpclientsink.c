@@ -66,13 +66,17 @@ enum
   PROP_HOST,
   PROP_SOCK_FD,
   PROP_CCID,
-  PROP_CLOSE_FD
+  PROP_CLOSE_FD,
+  PROP_TX_QLEN,
+  PROP_STATS
 };
 
 static gboolean gst_dccp_client_sink_stop (GstBaseSink * bsink);
 static gboolean gst_dccp_client_sink_start (GstBaseSink * bsink);
 static GstFlowReturn gst_dccp_client_sink_render (GstBaseSink * bsink,
     GstBuffer * buf);
+static GstFlowReturn gst_dccp_client_sink_render_list (GstBaseSink * bsink,
+    GstBufferList * list);
 
 GST_DEBUG_CATEGORY_STATIC (dccpclientsink_debug);
 
@@ -97,7 +101,21 @@ gst_dccp_client_sink_render (GstBaseSink * bsink, GstBuffer * buf)
   GstDCCPClientSink *sink = GST_DCCP_CLIENT_SINK (bsink);
 
   return gst_dccp_send_buffer (GST_ELEMENT (sink), buf, sink->sock_fd,
-      sink->pksize);
+      sink->pksize, &sink->stats);
+}
+
+/*
+ * Write a buffer list to client socket, batching the packets of its groups.
+ *
+ * @return GST_FLOW_OK if the send operation was successful, GST_FLOW_ERROR otherwise.
+ */
+static GstFlowReturn
+gst_dccp_client_sink_render_list (GstBaseSink * bsink, GstBufferList * list)
+{
+  GstDCCPClientSink *sink = GST_DCCP_CLIENT_SINK (bsink);
+
+  return gst_dccp_send_buffer_list (GST_ELEMENT (sink), list, sink->sock_fd,
+      sink->pksize, &sink->stats);
 }
 
 /*
@@ -130,6 +148,9 @@ gst_dccp_client_sink_set_property (GObject * object, guint prop_id,
     case PROP_CCID:
       sink->ccid = g_value_get_int (value);
       break;
+    case PROP_TX_QLEN:
+      sink->tx_qlen = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -161,6 +182,21 @@ gst_dccp_client_sink_get_property (GObject * object, guint prop_id,
     case PROP_CCID:
       g_value_set_int (value, sink->ccid);
       break;
+    case PROP_TX_QLEN:
+      g_value_set_uint (value, sink->tx_qlen);
+      break;
+    case PROP_STATS:
+    {
+      GstDCCPStats stats;
+
+      GST_OBJECT_LOCK (sink);
+      stats = sink->stats;
+      GST_OBJECT_UNLOCK (sink);
+
+      g_value_take_boxed (value,
+          gst_dccp_stats_to_structure (sink->sock_fd, &stats, TRUE));
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -217,9 +253,19 @@ gst_dccp_client_sink_start (GstBaseSink * bsink)
         sink->sock_fd);
   }
 
+  if (!gst_dccp_set_tx_qlen (GST_ELEMENT (sink), sink->sock_fd,
+          sink->tx_qlen)) {
+    gst_dccp_client_sink_stop (GST_BASE_SINK (sink));
+    return FALSE;
+  }
+
   sink->pksize =
       gst_dccp_get_max_packet_size (GST_ELEMENT (sink), sink->sock_fd);
 
+  GST_OBJECT_LOCK (sink);
+  gst_dccp_stats_reset (&sink->stats);
+  GST_OBJECT_UNLOCK (sink);
+
   return TRUE;
 }
 
@@ -246,6 +292,8 @@ gst_dccp_client_sink_init (GstDCCPClientSink * this,
   this->sock_fd = DCCP_DEFAULT_SOCK_FD;
   this->closed = DCCP_DEFAULT_CLOSED;
   this->ccid = DCCP_DEFAULT_CCID;
+  this->tx_qlen = DCCP_DEFAULT_TX_QLEN;
+  gst_dccp_stats_reset (&this->stats);
 }
 
 static gboolean
@@ -302,6 +350,33 @@ gst_dccp_client_sink_class_init (GstDCCPClientSinkClass * klass)
           "The Congestion Control IDentified to be used", 2, G_MAXINT,
           DCCP_DEFAULT_CCID, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDCCPClientSink:tx-queue-length
+   *
+   * The number of packets the kernel queues for sending, 0 keeps the system
+   * default. A short queue lowers the latency under congestion.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_TX_QLEN,
+      g_param_spec_uint ("tx-queue-length", "TX queue length",
+          "Packets queued for sending (0 = system default)", 0, G_MAXINT,
+          DCCP_DEFAULT_TX_QLEN, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDCCPClientSink:stats
+   *
+   * Counters of the socket: packets, bytes and syscalls used to send them,
+   * dropped packets, the average bitrate and, with CCID 3, the loss event
+   * rate.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Statistics of the socket", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /* signals */
   /**
    * GstDccpClientSink::connected:
@@ -318,6 +393,7 @@ gst_dccp_client_sink_class_init (GstDCCPClientSinkClass * klass)
   gstbasesink_class->start = gst_dccp_client_sink_start;
   gstbasesink_class->stop = gst_dccp_client_sink_stop;
   gstbasesink_class->render = gst_dccp_client_sink_render;
+  gstbasesink_class->render_list = gst_dccp_client_sink_render_list;
 
   GST_DEBUG_CATEGORY_INIT (dccpclientsink_debug, "dccpclientsink", 0,
       "DCCP Client Sink");
@@ -26,7 +26,7 @@
 
 G_BEGIN_DECLS
 
-#include "gstdccp_common.h"
+#include "gstdccp.h"
 
 #define GST_TYPE_DCCP_CLIENT_SINK \
   (gst_dccp_client_sink_get_type())
@@ -65,6 +65,9 @@ struct _GstDCCPClientSink
 
   GstCaps *caps;
   uint8_t ccid;
+  guint tx_qlen;
+
+  GstDCCPStats stats;
 };
 
 struct _GstDCCPClientSinkClass
@@ -74,7 +74,8 @@ enum
   PROP_SOCK_FD,
   PROP_CLOSED,
   PROP_CCID,
-  PROP_CAPS
+  PROP_CAPS,
+  PROP_STATS
 };
 
 static gboolean gst_dccp_client_src_stop (GstBaseSrc * bsrc);
@@ -105,7 +106,8 @@ gst_dccp_client_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
   src = GST_DCCP_CLIENT_SRC (psrc);
 
   GST_LOG_OBJECT (src, "reading a buffer");
-  ret = gst_dccp_read_buffer (GST_ELEMENT (src), src->sock_fd, outbuf);
+  ret = gst_dccp_read_batch (GST_ELEMENT (src), src->sock_fd, src->pool,
+      &src->stats, outbuf);
 
   if (ret == GST_FLOW_OK) {
     GST_LOG_OBJECT (src,
@@ -208,12 +210,46 @@ gst_dccp_client_src_get_property (GObject * object, guint prop_id,
     case PROP_CAPS:
       gst_value_set_caps (value, src->caps);
       break;
+    case PROP_STATS:
+    {
+      GstDCCPStats stats;
+
+      GST_OBJECT_LOCK (src);
+      stats = src->stats;
+      GST_OBJECT_UNLOCK (src);
+
+      g_value_take_boxed (value,
+          gst_dccp_stats_to_structure (src->sock_fd, &stats, FALSE));
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+/*
+ * Set up the receive pool for the packet size of the connected socket.
+ */
+static gboolean
+gst_dccp_client_src_start_pool (GstDCCPClientSrc * src)
+{
+  gint pksize;
+
+  pksize = gst_dccp_get_max_packet_size (GST_ELEMENT (src), src->sock_fd);
+  if (pksize <= 0) {
+    return FALSE;
+  }
+
+  src->pool = gst_dccp_buffer_pool_new (pksize);
+
+  GST_OBJECT_LOCK (src);
+  gst_dccp_stats_reset (&src->stats);
+  GST_OBJECT_UNLOCK (src);
+
+  return TRUE;
+}
+
 /*
  * Starts the element. If the sockfd property was not the default, this method
  * will create a new socket and connect to the server.
@@ -264,6 +300,11 @@ gst_dccp_client_src_start (GstBaseSrc * bsrc)
         src->sock_fd);
   }
 
+  if (!gst_dccp_client_src_start_pool (src)) {
+    gst_dccp_client_src_stop (GST_BASE_SRC (src));
+    return FALSE;
+  }
+
   return TRUE;
 }
 
@@ -290,6 +331,8 @@ gst_dccp_client_src_init (GstDCCPClientSrc * this,
   this->sock_fd = DCCP_DEFAULT_SOCK_FD;
   this->closed = DCCP_DEFAULT_CLOSED;
   this->ccid = DCCP_DEFAULT_CCID;
+  this->pool = NULL;
+  gst_dccp_stats_reset (&this->stats);
   this->caps = NULL;
 
   gst_base_src_set_format (GST_BASE_SRC (this), GST_FORMAT_TIME);
@@ -327,6 +370,9 @@ gst_dccp_client_src_stop (GstBaseSrc * bsrc)
 
   src = GST_DCCP_CLIENT_SRC (bsrc);
 
+  gst_dccp_buffer_pool_free (src->pool);
+  src->pool = NULL;
+
   if (src->sock_fd != DCCP_DEFAULT_SOCK_FD && src->closed) {
     gst_dccp_socket_close (GST_ELEMENT (src), &(src->sock_fd));
   }
@@ -383,6 +429,20 @@ gst_dccp_client_src_class_init (GstDCCPClientSrcClass * klass)
           "The Congestion Control IDentified to be used", 2, G_MAXINT,
           DCCP_DEFAULT_CCID, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDCCPClientSrc:stats
+   *
+   * Counters of the socket: packets, bytes and syscalls used to read them,
+   * packets dropped for being larger than the MTU, the average bitrate and,
+   * with CCID 3, the loss event rate.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Statistics of the socket", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /* signals */
   /**
    * GstDccpClientSrc::connected:
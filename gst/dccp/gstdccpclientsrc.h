@@ -26,7 +26,7 @@
 
 G_BEGIN_DECLS
 
-#include "gstdccp_common.h"
+#include "gstdccp.h"
 
 #define GST_TYPE_DCCP_CLIENT_SRC \
   (gst_dccp_client_src_get_type())
@@ -56,6 +56,9 @@ struct _GstDCCPClientSrc {
 
   GstCaps *caps;
   uint8_t ccid;
+
+  GstDCCPBufferPool *pool;
+  GstDCCPStats stats;
 };
 
 struct _GstDCCPClientSrcClass {
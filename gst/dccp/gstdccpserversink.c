@@ -68,7 +68,9 @@ enum
   PROP_CLIENT_SOCK_FD,
   PROP_CCID,
   PROP_CLOSED,
-  PROP_WAIT_CONNECTIONS
+  PROP_WAIT_CONNECTIONS,
+  PROP_TX_QLEN,
+  PROP_STATS
 };
 
 static pthread_t accept_thread_id;
@@ -98,10 +100,16 @@ static guint gst_dccp_server_sink_signals[LAST_SIGNAL] = { 0 };
 static Client *
 gst_dccp_server_create_client (GstElement * element, int socket)
 {
+  GstDCCPServerSink *sink = GST_DCCP_SERVER_SINK (element);
   Client *client = (Client *) g_malloc (sizeof (Client));
   client->socket = socket;
   client->pksize = gst_dccp_get_max_packet_size (element, client->socket);
   client->flow_status = GST_FLOW_OK;
+  gst_dccp_stats_reset (&client->stats);
+
+  if (!gst_dccp_set_tx_qlen (element, client->socket, sink->tx_qlen)) {
+    GST_WARNING_OBJECT (element, "Keeping the default TX queue length");
+  }
 
   GST_DEBUG_OBJECT (element, "Creating a new client with fd %d and MTU %d.",
       client->socket, client->pksize);
@@ -154,7 +162,7 @@ gst_dccp_server_send_buffer (void *arg)
   int pksize = client->pksize;
 
   if (gst_dccp_send_buffer (GST_ELEMENT (sink), buf, client_sock_fd,
-          pksize) == GST_FLOW_ERROR) {
+          pksize, &client->stats) == GST_FLOW_ERROR) {
     client->flow_status = GST_FLOW_ERROR;
   }
   return NULL;
@@ -197,6 +205,7 @@ gst_dccp_server_sink_init (GstDCCPServerSink * this,
   this->client_sock_fd = DCCP_DEFAULT_CLIENT_SOCK_FD;
   this->closed = DCCP_DEFAULT_CLOSED;
   this->ccid = DCCP_DEFAULT_CCID;
+  this->tx_qlen = DCCP_DEFAULT_TX_QLEN;
   this->wait_connections = DCCP_DEFAULT_WAIT_CONNECTIONS;
   this->clients = NULL;
 }
@@ -303,6 +312,95 @@ gst_dccp_server_sink_render (GstBaseSink * bsink, GstBuffer * buf)
   return GST_FLOW_OK;
 }
 
+/*
+ * Send a buffer list to all clients. The packets of the list are batched so
+ * the clients are served one after the other from the streaming thread.
+ */
+static GstFlowReturn
+gst_dccp_server_sink_render_list (GstBaseSink * bsink, GstBufferList * list)
+{
+  GstDCCPServerSink *sink = GST_DCCP_SERVER_SINK (bsink);
+  gboolean dead_clients = FALSE;
+  GList *l;
+
+  pthread_mutex_lock (&lock);
+
+  for (l = sink->clients; l != NULL; l = l->next) {
+    Client *client = (Client *) l->data;
+
+    if (client->flow_status == GST_FLOW_OK) {
+      client->flow_status = gst_dccp_send_buffer_list (GST_ELEMENT (sink),
+          list, client->socket, client->pksize, &client->stats);
+    }
+    if (client->flow_status != GST_FLOW_OK) {
+      dead_clients = TRUE;
+    }
+  }
+
+  pthread_mutex_unlock (&lock);
+
+  if (dead_clients) {
+    gst_dccp_server_delete_dead_clients (sink);
+  }
+
+  return GST_FLOW_OK;
+}
+
+/*
+ * Describe the traffic of all the clients, with the counters of every client
+ * socket in the "clients" list.
+ */
+static GstStructure *
+gst_dccp_server_sink_get_stats (GstDCCPServerSink * sink)
+{
+  GstStructure *s;
+  GstDCCPStats total;
+  GValue clients = { 0, };
+  GValue item = { 0, };
+  GList *l;
+
+  gst_dccp_stats_reset (&total);
+  g_value_init (&clients, GST_TYPE_LIST);
+
+  pthread_mutex_lock (&lock);
+  for (l = sink->clients; l != NULL; l = l->next) {
+    Client *client = (Client *) l->data;
+    GstDCCPStats stats;
+    GstStructure *cs;
+
+    GST_OBJECT_LOCK (sink);
+    stats = client->stats;
+    GST_OBJECT_UNLOCK (sink);
+
+    total.packets += stats.packets;
+    total.bytes += stats.bytes;
+    total.syscalls += stats.syscalls;
+    total.dropped += stats.dropped;
+    if (GST_CLOCK_TIME_IS_VALID (stats.first)) {
+      if (!GST_CLOCK_TIME_IS_VALID (total.first) || stats.first < total.first)
+        total.first = stats.first;
+      if (!GST_CLOCK_TIME_IS_VALID (total.last) || stats.last > total.last)
+        total.last = stats.last;
+    }
+
+    cs = gst_dccp_stats_to_structure (client->socket, &stats, TRUE);
+    gst_structure_set (cs, "fd", G_TYPE_INT, client->socket, NULL);
+
+    g_value_init (&item, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&item, cs);
+    gst_value_list_append_value (&clients, &item);
+    g_value_unset (&item);
+  }
+  pthread_mutex_unlock (&lock);
+
+  s = gst_dccp_stats_to_structure (-1, &total, TRUE);
+  gst_structure_remove_field (s, "loss-rate");
+  gst_structure_set_value (s, "clients", &clients);
+  g_value_unset (&clients);
+
+  return s;
+}
+
 static gboolean
 gst_dccp_server_sink_stop (GstBaseSink * bsink)
 {
@@ -370,6 +468,9 @@ gst_dccp_server_sink_set_property (GObject * object, guint prop_id,
     case PROP_CCID:
       sink->ccid = g_value_get_int (value);
       break;
+    case PROP_TX_QLEN:
+      sink->tx_qlen = g_value_get_uint (value);
+      break;
     default:
       break;
   }
@@ -397,6 +498,12 @@ gst_dccp_server_sink_get_property (GObject * object, guint prop_id,
     case PROP_CCID:
       g_value_set_int (value, sink->ccid);
       break;
+    case PROP_TX_QLEN:
+      g_value_set_uint (value, sink->tx_qlen);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_dccp_server_sink_get_stats (sink));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -443,6 +550,35 @@ gst_dccp_server_sink_class_init (GstDCCPServerSinkClass * klass)
           DCCP_DEFAULT_WAIT_CONNECTIONS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDCCPServerSink:tx-queue-length
+   *
+   * The number of packets the kernel queues for sending to each client, 0
+   * keeps the system default. A short queue lowers the latency under
+   * congestion.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_TX_QLEN,
+      g_param_spec_uint ("tx-queue-length", "TX queue length",
+          "Packets queued for sending to each client (0 = system default)",
+          0, G_MAXINT, DCCP_DEFAULT_TX_QLEN,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDCCPServerSink:stats
+   *
+   * The packets, bytes, syscalls and dropped packets sent to all clients and
+   * their average bitrate. The "clients" field lists the same counters for
+   * every client socket, with its "fd" and, with CCID 3, its loss event rate.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Statistics of the client sockets", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
 
   /* signals */
   /**
@@ -460,6 +596,7 @@ gst_dccp_server_sink_class_init (GstDCCPServerSinkClass * klass)
   gstbasesink_class->start = gst_dccp_server_sink_start;
   gstbasesink_class->stop = gst_dccp_server_sink_stop;
   gstbasesink_class->render = gst_dccp_server_sink_render;
+  gstbasesink_class->render_list = gst_dccp_server_sink_render_list;
 
   GST_DEBUG_CATEGORY_INIT (dccpserversink_debug, "dccpserversink", 0,
       "DCCP Server Sink");
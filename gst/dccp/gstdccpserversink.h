@@ -27,7 +27,7 @@
 G_BEGIN_DECLS
 
 
-#include "gstdccp_common.h"
+#include "gstdccp.h"
 #include <pthread.h>
 
 #define GST_TYPE_DCCP_SERVER_SINK \
@@ -53,6 +53,7 @@ struct _Client
   int socket;
   int pksize;
   GstFlowReturn flow_status;
+  GstDCCPStats stats;
 };
 
 struct _GstDCCPServerSink
@@ -72,6 +73,7 @@ struct _GstDCCPServerSink
   /* properties */
   int client_sock_fd;
   uint8_t ccid;
+  guint tx_qlen;
   gboolean wait_connections;
   gboolean closed;
 };
@@ -69,7 +69,8 @@ enum
   PROP_CLIENT_SOCK_FD,
   PROP_CLOSED,
   PROP_CCID,
-  PROP_CAPS
+  PROP_CAPS,
+  PROP_STATS
 };
 
 static gboolean gst_dccp_server_src_stop (GstBaseSrc * bsrc);
@@ -101,7 +102,8 @@ gst_dccp_server_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
 
   GST_LOG_OBJECT (src, "reading a buffer");
 
-  ret = gst_dccp_read_buffer (GST_ELEMENT (src), src->client_sock_fd, outbuf);
+  ret = gst_dccp_read_batch (GST_ELEMENT (src), src->client_sock_fd, src->pool,
+      &src->stats, outbuf);
 
   if (ret == GST_FLOW_OK) {
     GST_LOG_OBJECT (src,
@@ -191,6 +193,18 @@ gst_dccp_server_src_get_property (GObject * object, guint prop_id,
     case PROP_CAPS:
       gst_value_set_caps (value, src->caps);
       break;
+    case PROP_STATS:
+    {
+      GstDCCPStats stats;
+
+      GST_OBJECT_LOCK (src);
+      stats = src->stats;
+      GST_OBJECT_UNLOCK (src);
+
+      g_value_take_boxed (value,
+          gst_dccp_stats_to_structure (src->client_sock_fd, &stats, FALSE));
+      break;
+    }
     case PROP_CCID:
       g_value_set_int (value, src->ccid);
       break;
@@ -200,6 +214,29 @@ gst_dccp_server_src_get_property (GObject * object, guint prop_id,
   }
 }
 
+/*
+ * Set up the receive pool for the packet size of the client socket.
+ */
+static gboolean
+gst_dccp_server_src_start_pool (GstDCCPServerSrc * src)
+{
+  gint pksize;
+
+  pksize =
+      gst_dccp_get_max_packet_size (GST_ELEMENT (src), src->client_sock_fd);
+  if (pksize <= 0) {
+    return FALSE;
+  }
+
+  src->pool = gst_dccp_buffer_pool_new (pksize);
+
+  GST_OBJECT_LOCK (src);
+  gst_dccp_stats_reset (&src->stats);
+  GST_OBJECT_UNLOCK (src);
+
+  return TRUE;
+}
+
 /*
  * Starts the element. If the sockfd property was not the default, this method
  * will create a new server socket and wait for a client connection.
@@ -253,6 +290,10 @@ gst_dccp_server_src_start (GstBaseSrc * bsrc)
         src->client_sock_fd);
   }
 
+  if (!gst_dccp_server_src_start_pool (src)) {
+    return FALSE;
+  }
+
   return TRUE;
 }
 
@@ -281,6 +322,8 @@ gst_dccp_server_src_init (GstDCCPServerSrc * this,
   this->client_sock_fd = DCCP_DEFAULT_CLIENT_SOCK_FD;
   this->closed = DCCP_DEFAULT_CLOSED;
   this->ccid = DCCP_DEFAULT_CCID;
+  this->pool = NULL;
+  gst_dccp_stats_reset (&this->stats);
   this->caps = DCCP_DEFAULT_CAPS;
 
   gst_base_src_set_format (GST_BASE_SRC (this), GST_FORMAT_TIME);
@@ -318,6 +361,9 @@ gst_dccp_server_src_stop (GstBaseSrc * bsrc)
 
   src = GST_DCCP_SERVER_SRC (bsrc);
 
+  gst_dccp_buffer_pool_free (src->pool);
+  src->pool = NULL;
+
   gst_dccp_socket_close (GST_ELEMENT (src), &(src->sock_fd));
   if (src->client_sock_fd != DCCP_DEFAULT_CLIENT_SOCK_FD && src->closed == TRUE) {
     gst_dccp_socket_close (GST_ELEMENT (src), &(src->client_sock_fd));
@@ -368,6 +414,20 @@ gst_dccp_server_src_class_init (GstDCCPServerSrcClass * klass)
           "The caps of the source pad", GST_TYPE_CAPS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDCCPServerSrc:stats
+   *
+   * Counters of the socket: packets, bytes and syscalls used to read them,
+   * packets dropped for being larger than the MTU, the average bitrate and,
+   * with CCID 3, the loss event rate.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Statistics of the socket", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /* signals */
   /**
    * GstDccpServerSrc::connected:
@@ -26,7 +26,7 @@
 
 G_BEGIN_DECLS
 
-#include "gstdccp_common.h"
+#include "gstdccp.h"
 
 #define GST_TYPE_DCCP_SERVER_SRC \
   (gst_dccp_server_src_get_type())
@@ -59,6 +59,9 @@ struct _GstDCCPServerSrc
 
   /* single client */
   int client_sock_fd;
+
+  GstDCCPBufferPool *pool;
+  GstDCCPStats stats;
 };
 
 struct _GstDCCPServerSrcClass
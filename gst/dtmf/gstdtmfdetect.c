@@ -53,7 +53,31 @@
  *   This field will always been 2 (ie sound) from this element.
  *   </para>
  * </listitem>
+ * <listitem>
+ *   <para>
+ *   gint <classname>channel</classname>:
+ *   The channel the tone was detected on. Every channel of the input is
+ *   treated as a separate mono stream with its own detector.
+ *   </para>
+ * </listitem>
+ * <listitem>
+ *   <para>
+ *   guint64 <classname>timestamp</classname>:
+ *   The time of the end of the detection, in the same base as the buffer
+ *   timestamps, or GST_CLOCK_TIME_NONE when the input is not timestamped.
+ *   </para>
+ * </listitem>
  * </itemizedlist>
+ *
+ * For offline processing, posting a message per digit can cost more than the
+ * detection itself. When #GstDtmfDetect:batch-size is not 0, the detections
+ * are collected and posted as a single
+ * <classname>&quot;dtmf-event-list&quot;</classname> message once that many
+ * are pending, and at EOS. That message has the same
+ * <classname>type</classname> and <classname>method</classname> fields as
+ * above, and the <classname>number</classname>,
+ * <classname>channel</classname> and <classname>timestamp</classname> fields
+ * are #GST_TYPE_ARRAY values with one entry per detection.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -74,7 +98,8 @@ static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
         "width = (int) 16, "
         "depth = (int) 16, "
         "endianness = (int) " G_STRINGIFY (G_BYTE_ORDER) ", "
-        "signed = (bool) true, rate = (int) 8000, channels = (int) 1"));
+        "signed = (bool) true, rate = (int) 8000, "
+        "channels = (int) [ 1, MAX ]"));
 
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
@@ -83,7 +108,8 @@ static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
         "width = (int) 16, "
         "depth = (int) 16, "
         "endianness = (int) " G_STRINGIFY (G_BYTE_ORDER) ", "
-        "signed = (bool) true, rate = (int) 8000, channels = (int) 1"));
+        "signed = (bool) true, rate = (int) 8000, "
+        "channels = (int) [ 1, MAX ]"));
 
 /* signals and args */
 enum
@@ -92,11 +118,27 @@ enum
   LAST_SIGNAL
 };
 
+#define DEFAULT_BATCH_SIZE 0
+
 enum
 {
   PROP_0,
+  PROP_BATCH_SIZE
 };
 
+typedef struct
+{
+  gint number;
+  gint channel;
+  GstClockTime timestamp;
+} GstDtmfDetection;
+
+static void gst_dtmf_detect_finalize (GObject * object);
+static void gst_dtmf_detect_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_dtmf_detect_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
 static gboolean gst_dtmf_detect_set_caps (GstBaseTransform * trans,
     GstCaps * incaps, GstCaps * outcaps);
 static GstFlowReturn gst_dtmf_detect_transform_ip (GstBaseTransform * trans,
@@ -132,10 +174,23 @@ gst_dtmf_detect_base_init (gpointer klass)
 static void
 gst_dtmf_detect_class_init (GstDtmfDetectClass * klass)
 {
+  GObjectClass *gobject_class;
   GstBaseTransformClass *gstbasetransform_class;
 
+  gobject_class = (GObjectClass *) klass;
   gstbasetransform_class = (GstBaseTransformClass *) klass;
 
+  gobject_class->finalize = gst_dtmf_detect_finalize;
+  gobject_class->set_property = gst_dtmf_detect_set_property;
+  gobject_class->get_property = gst_dtmf_detect_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch size",
+          "Number of detections to collect in one dtmf-event-list message "
+          "(0 = one dtmf-event message per detection)",
+          0, MAX_DTMF_DIGITS * 64, DEFAULT_BATCH_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstbasetransform_class->set_caps =
       GST_DEBUG_FUNCPTR (gst_dtmf_detect_set_caps);
   gstbasetransform_class->transform_ip =
@@ -148,6 +203,65 @@ gst_dtmf_detect_init (GstDtmfDetect * dtmfdetect, GstDtmfDetectClass * klass)
 {
   gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (dtmfdetect), TRUE);
   gst_base_transform_set_gap_aware (GST_BASE_TRANSFORM (dtmfdetect), TRUE);
+
+  dtmfdetect->batch_size = DEFAULT_BATCH_SIZE;
+  dtmfdetect->batch = g_array_new (FALSE, FALSE, sizeof (GstDtmfDetection));
+}
+
+static void
+gst_dtmf_detect_finalize (GObject * object)
+{
+  GstDtmfDetect *self = GST_DTMF_DETECT (object);
+
+  g_free (self->dtmf_state);
+  g_array_free (self->batch, TRUE);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_dtmf_detect_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstDtmfDetect *self = GST_DTMF_DETECT (object);
+
+  switch (prop_id) {
+    case PROP_BATCH_SIZE:
+      GST_OBJECT_LOCK (self);
+      self->batch_size = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_dtmf_detect_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstDtmfDetect *self = GST_DTMF_DETECT (object);
+
+  switch (prop_id) {
+    case PROP_BATCH_SIZE:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, self->batch_size);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_dtmf_detect_reset (GstDtmfDetect * self)
+{
+  gint i;
+
+  for (i = 0; i < self->channels; i++)
+    zap_dtmf_detect_init (&self->dtmf_state[i]);
 }
 
 static gboolean
@@ -155,104 +269,185 @@ gst_dtmf_detect_set_caps (GstBaseTransform * trans, GstCaps * incaps,
     GstCaps * outcaps)
 {
   GstDtmfDetect *self = GST_DTMF_DETECT (trans);
+  GstStructure *s = gst_caps_get_structure (incaps, 0);
+  gint channels;
 
-  zap_dtmf_detect_init (&self->dtmf_state);
+  if (!gst_structure_get_int (s, "channels", &channels))
+    return FALSE;
+
+  if (channels != self->channels) {
+    g_free (self->dtmf_state);
+    self->dtmf_state = g_new0 (dtmf_detect_state_t, channels);
+    self->channels = channels;
+  }
+  gst_dtmf_detect_reset (self);
 
   return TRUE;
 }
 
+static gint
+gst_dtmf_detect_digit_to_event (gchar digit)
+{
+  switch (digit) {
+    case '0':
+      return 0;
+    case '1':
+      return 1;
+    case '2':
+      return 2;
+    case '3':
+      return 3;
+    case '4':
+      return 4;
+    case '5':
+      return 5;
+    case '6':
+      return 6;
+    case '7':
+      return 7;
+    case '8':
+      return 8;
+    case '9':
+      return 9;
+    case '*':
+      return 10;
+    case '#':
+      return 11;
+    case 'A':
+      return 12;
+    case 'B':
+      return 13;
+    case 'C':
+      return 14;
+    case 'D':
+      return 15;
+    default:
+      return -1;
+  }
+}
+
+static void
+gst_dtmf_detect_post_batch (GstDtmfDetect * self)
+{
+  GstStructure *structure;
+  GValue numbers = { 0, };
+  GValue channels = { 0, };
+  GValue timestamps = { 0, };
+  GValue v = { 0, };
+  guint i;
+
+  if (self->batch->len == 0)
+    return;
+
+  g_value_init (&numbers, GST_TYPE_ARRAY);
+  g_value_init (&channels, GST_TYPE_ARRAY);
+  g_value_init (&timestamps, GST_TYPE_ARRAY);
+
+  for (i = 0; i < self->batch->len; i++) {
+    GstDtmfDetection *d = &g_array_index (self->batch, GstDtmfDetection, i);
+
+    g_value_init (&v, G_TYPE_INT);
+    g_value_set_int (&v, d->number);
+    gst_value_array_append_value (&numbers, &v);
+    g_value_set_int (&v, d->channel);
+    gst_value_array_append_value (&channels, &v);
+    g_value_unset (&v);
+
+    g_value_init (&v, G_TYPE_UINT64);
+    g_value_set_uint64 (&v, d->timestamp);
+    gst_value_array_append_value (&timestamps, &v);
+    g_value_unset (&v);
+  }
+
+  GST_DEBUG_OBJECT (self, "Posting %u DTMF events", self->batch->len);
+  g_array_set_size (self->batch, 0);
+
+  structure = gst_structure_new ("dtmf-event-list",
+      "type", G_TYPE_INT, 1, "method", G_TYPE_INT, 2, NULL);
+  gst_structure_take_value (structure, "number", &numbers);
+  gst_structure_take_value (structure, "channel", &channels);
+  gst_structure_take_value (structure, "timestamp", &timestamps);
+
+  gst_element_post_message (GST_ELEMENT (self),
+      gst_message_new_element (GST_OBJECT (self), structure));
+}
+
 
 static GstFlowReturn
 gst_dtmf_detect_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
 {
   GstDtmfDetect *self = GST_DTMF_DETECT (trans);
+  GstClockTime timestamp;
   gint dtmf_count;
-  gchar dtmfbuf[MAX_DTMF_DIGITS] = "";
-  gint i;
+  gchar dtmfbuf[MAX_DTMF_DIGITS + 1] = "";
+  gint positions[MAX_DTMF_DIGITS];
+  guint batch_size;
+  gint frames;
+  gint c, i;
 
   if (GST_BUFFER_IS_DISCONT (buf))
-    zap_dtmf_detect_init (&self->dtmf_state);
+    gst_dtmf_detect_reset (self);
   if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_GAP))
     return GST_FLOW_OK;
 
-  zap_dtmf_detect (&self->dtmf_state, (gint16 *) GST_BUFFER_DATA (buf),
-      GST_BUFFER_SIZE (buf) / 2, FALSE);
-
-  dtmf_count = zap_dtmf_get (&self->dtmf_state, dtmfbuf, MAX_DTMF_DIGITS);
-
-  if (dtmf_count)
-    GST_DEBUG_OBJECT (self, "Got %d DTMF events: %s", dtmf_count, dtmfbuf);
-  else
-    GST_LOG_OBJECT (self, "Got no DTMF events");
-
-  for (i = 0; i < dtmf_count; i++) {
-    GstMessage *dtmf_message = NULL;
-    GstStructure *structure;
-    gint dtmf_payload_event;
-
-    GST_DEBUG_OBJECT (self, "Got DTMF event %c", dtmfbuf[i]);
-
-    switch (dtmfbuf[i]) {
-      case '0':
-        dtmf_payload_event = 0;
-        break;
-      case '1':
-        dtmf_payload_event = 1;
-        break;
-      case '2':
-        dtmf_payload_event = 2;
-        break;
-      case '3':
-        dtmf_payload_event = 3;
-        break;
-      case '4':
-        dtmf_payload_event = 4;
-        break;
-      case '5':
-        dtmf_payload_event = 5;
-        break;
-      case '6':
-        dtmf_payload_event = 6;
-        break;
-      case '7':
-        dtmf_payload_event = 7;
-        break;
-      case '8':
-        dtmf_payload_event = 8;
-        break;
-      case '9':
-        dtmf_payload_event = 9;
-        break;
-      case '*':
-        dtmf_payload_event = 10;
-        break;
-      case '#':
-        dtmf_payload_event = 11;
-        break;
-      case 'A':
-        dtmf_payload_event = 12;
-        break;
-      case 'B':
-        dtmf_payload_event = 13;
-        break;
-      case 'C':
-        dtmf_payload_event = 14;
-        break;
-      case 'D':
-        dtmf_payload_event = 15;
-        break;
-      default:
+  GST_OBJECT_LOCK (self);
+  batch_size = self->batch_size;
+  GST_OBJECT_UNLOCK (self);
+
+  if (G_UNLIKELY (self->channels == 0))
+    return GST_FLOW_NOT_NEGOTIATED;
+
+  timestamp = GST_BUFFER_TIMESTAMP (buf);
+
+  frames = GST_BUFFER_SIZE (buf) / (2 * self->channels);
+
+  for (c = 0; c < self->channels; c++) {
+    zap_dtmf_detect (&self->dtmf_state[c],
+        (gint16 *) GST_BUFFER_DATA (buf) + c, frames, self->channels, FALSE);
+
+    dtmf_count = zap_dtmf_get (&self->dtmf_state[c], dtmfbuf, positions,
+        MAX_DTMF_DIGITS);
+
+    if (dtmf_count)
+      GST_DEBUG_OBJECT (self, "Got %d DTMF events on channel %d: %s",
+          dtmf_count, c, dtmfbuf);
+    else
+      GST_LOG_OBJECT (self, "Got no DTMF events on channel %d", c);
+
+    for (i = 0; i < dtmf_count; i++) {
+      GstDtmfDetection d;
+
+      GST_DEBUG_OBJECT (self, "Got DTMF event %c", dtmfbuf[i]);
+
+      d.number = gst_dtmf_detect_digit_to_event (dtmfbuf[i]);
+      if (d.number < 0)
         continue;
+      d.channel = c;
+      d.timestamp = GST_CLOCK_TIME_NONE;
+      if (GST_CLOCK_TIME_IS_VALID (timestamp))
+        d.timestamp = timestamp +
+            gst_util_uint64_scale_int (positions[i], GST_SECOND, 8000);
+
+      if (batch_size == 0) {
+        GstStructure *structure;
+
+        structure = gst_structure_new ("dtmf-event",
+            "type", G_TYPE_INT, 1,
+            "number", G_TYPE_INT, d.number,
+            "method", G_TYPE_INT, 2,
+            "channel", G_TYPE_INT, d.channel,
+            "timestamp", G_TYPE_UINT64, d.timestamp, NULL);
+        gst_element_post_message (GST_ELEMENT (self),
+            gst_message_new_element (GST_OBJECT (self), structure));
+      } else {
+        g_array_append_val (self->batch, d);
+      }
     }
-
-    structure = gst_structure_new ("dtmf-event",
-        "type", G_TYPE_INT, 1,
-        "number", G_TYPE_INT, dtmf_payload_event,
-        "method", G_TYPE_INT, 2, NULL);
-    dtmf_message = gst_message_new_element (GST_OBJECT (self), structure);
-    gst_element_post_message (GST_ELEMENT (self), dtmf_message);
   }
 
+  if (self->batch->len > 0 && self->batch->len >= batch_size)
+    gst_dtmf_detect_post_batch (self);
+
   return GST_FLOW_OK;
 }
 
@@ -264,7 +459,11 @@ gst_dtmf_detect_event (GstBaseTransform * trans, GstEvent * event)
 
   switch (GST_EVENT_TYPE (event)) {
     case GST_EVENT_FLUSH_STOP:
-      zap_dtmf_detect_init (&self->dtmf_state);
+      gst_dtmf_detect_post_batch (self);
+      gst_dtmf_detect_reset (self);
+      break;
+    case GST_EVENT_EOS:
+      gst_dtmf_detect_post_batch (self);
       break;
     default:
       break;
@@ -54,7 +54,15 @@ struct _GstDtmfDetect
 {
   GstBaseTransform parent;
 
-  dtmf_detect_state_t dtmf_state;
+  /* one detector per channel */
+  dtmf_detect_state_t *dtmf_state;
+  gint channels;
+
+  /* properties */
+  guint batch_size;
+
+  /* detections not posted yet in batch mode */
+  GArray *batch;
 };
 
 struct _GstDtmfDetectClass
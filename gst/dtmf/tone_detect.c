@@ -45,8 +45,6 @@
 #define TRUE    (!FALSE)
 #endif
 
-//#define USE_3DNOW
-
 /* Basic DTMF specs:
  *
  * Minimum tone on = 40ms
@@ -71,12 +69,7 @@
 #define DTMF_2ND_HARMONIC_ROW       ((isradio) ? 1.7 : 2.5)     /* 4dB normal */
 #define DTMF_2ND_HARMONIC_COL       63.1        /* 18dB */
 
-static tone_detection_descriptor_t dtmf_detect_row[4];
-static tone_detection_descriptor_t dtmf_detect_col[4];
-static tone_detection_descriptor_t dtmf_detect_row_2nd[4];
-static tone_detection_descriptor_t dtmf_detect_col_2nd[4];
-static tone_detection_descriptor_t fax_detect;
-static tone_detection_descriptor_t fax_detect_2nd;
+static float bank_fac[DTMF_BANK_SIZE];
 
 static float dtmf_row[] = {
   697.0, 770.0, 852.0, 941.0
@@ -91,84 +84,22 @@ static float fax_freq = 1100.0;
 static char dtmf_positions[] = "123A" "456B" "789C" "*0#D";
 
 static void
-goertzel_init (goertzel_state_t * s, tone_detection_descriptor_t * t)
+goertzel_bank_init (goertzel_bank_t * b)
 {
-  s->v2 = s->v3 = 0.0;
-  s->fac = t->fac;
+  memset (b->v2, 0, sizeof (b->v2));
+  memset (b->v3, 0, sizeof (b->v3));
+  memcpy (b->fac, bank_fac, sizeof (b->fac));
 }
 
 /*- End of function --------------------------------------------------------*/
 
-#if defined(USE_3DNOW)
-static inline void
-_dtmf_goertzel_update (goertzel_state_t * s, float x[], int samples)
+static inline float
+goertzel_bank_result (goertzel_bank_t * b, int i)
 {
-  int n;
-  float v;
-  int i;
-  float vv[16];
-
-  vv[4] = s[0].v2;
-  vv[5] = s[1].v2;
-  vv[6] = s[2].v2;
-  vv[7] = s[3].v2;
-  vv[8] = s[0].v3;
-  vv[9] = s[1].v3;
-  vv[10] = s[2].v3;
-  vv[11] = s[3].v3;
-  vv[12] = s[0].fac;
-  vv[13] = s[1].fac;
-  vv[14] = s[2].fac;
-  vv[15] = s[3].fac;
-
-  //v1 = s->v2;
-  //s->v2 = s->v3;
-  //s->v3 = s->fac*s->v2 - v1 + x[0];
-
-  __asm__ __volatile__ (" femms;\n"
-      " movq        16(%%edx),%%mm2;\n"
-      " movq        24(%%edx),%%mm3;\n"
-      " movq        32(%%edx),%%mm4;\n"
-      " movq        40(%%edx),%%mm5;\n"
-      " movq        48(%%edx),%%mm6;\n"
-      " movq        56(%%edx),%%mm7;\n"
-      " jmp         1f;\n"
-      " .align 32;\n"
-      " 1: ;\n"
-      " prefetch    (%%eax);\n"
-      " movq        %%mm3,%%mm1;\n"
-      " movq        %%mm2,%%mm0;\n"
-      " movq        %%mm5,%%mm3;\n"
-      " movq        %%mm4,%%mm2;\n"
-      " pfmul       %%mm7,%%mm5;\n"
-      " pfmul       %%mm6,%%mm4;\n"
-      " pfsub       %%mm1,%%mm5;\n"
-      " pfsub       %%mm0,%%mm4;\n"
-      " movq        (%%eax),%%mm0;\n"
-      " movq        %%mm0,%%mm1;\n"
-      " punpckldq   %%mm0,%%mm1;\n"
-      " add         $4,%%eax;\n"
-      " pfadd       %%mm1,%%mm5;\n"
-      " pfadd       %%mm1,%%mm4;\n"
-      " dec         %%ecx;\n"
-      " jnz         1b;\n"
-      " movq        %%mm2,16(%%edx);\n"
-      " movq        %%mm3,24(%%edx);\n"
-      " movq        %%mm4,32(%%edx);\n"
-      " movq        %%mm5,40(%%edx);\n"
-      " femms;\n"::"c" (samples), "a" (x), "d" (vv)
-      :"memory", "eax", "ecx");
-
-  s[0].v2 = vv[4];
-  s[1].v2 = vv[5];
-  s[2].v2 = vv[6];
-  s[3].v2 = vv[7];
-  s[0].v3 = vv[8];
-  s[1].v3 = vv[9];
-  s[2].v3 = vv[10];
-  s[3].v3 = vv[11];
+  return b->v3[i] * b->v3[i] + b->v2[i] * b->v2[i] -
+      b->v2[i] * b->v3[i] * b->fac[i];
 }
-#endif
+
 /*- End of function --------------------------------------------------------*/
 
 void
@@ -204,38 +135,33 @@ zap_dtmf_detect_init (dtmf_detect_state_t * s)
 
   for (i = 0; i < 4; i++) {
     theta = 2.0 * G_PI * (dtmf_row[i] / SAMPLE_RATE);
-    dtmf_detect_row[i].fac = 2.0 * cos (theta);
+    bank_fac[DTMF_BANK_ROW + i] = 2.0 * cos (theta);
 
     theta = 2.0 * G_PI * (dtmf_col[i] / SAMPLE_RATE);
-    dtmf_detect_col[i].fac = 2.0 * cos (theta);
+    bank_fac[DTMF_BANK_COL + i] = 2.0 * cos (theta);
 
     theta = 2.0 * G_PI * (dtmf_row[i] * 2.0 / SAMPLE_RATE);
-    dtmf_detect_row_2nd[i].fac = 2.0 * cos (theta);
+    bank_fac[DTMF_BANK_ROW_2ND + i] = 2.0 * cos (theta);
 
     theta = 2.0 * G_PI * (dtmf_col[i] * 2.0 / SAMPLE_RATE);
-    dtmf_detect_col_2nd[i].fac = 2.0 * cos (theta);
-
-    goertzel_init (&s->row_out[i], &dtmf_detect_row[i]);
-    goertzel_init (&s->col_out[i], &dtmf_detect_col[i]);
-    goertzel_init (&s->row_out2nd[i], &dtmf_detect_row_2nd[i]);
-    goertzel_init (&s->col_out2nd[i], &dtmf_detect_col_2nd[i]);
-
-    s->energy = 0.0;
+    bank_fac[DTMF_BANK_COL_2ND + i] = 2.0 * cos (theta);
   }
 
   /* Same for the fax dector */
   theta = 2.0 * G_PI * (fax_freq / SAMPLE_RATE);
-  fax_detect.fac = 2.0 * cos (theta);
-  goertzel_init (&s->fax_tone, &fax_detect);
+  bank_fac[DTMF_BANK_FAX] = 2.0 * cos (theta);
 
   /* Same for the fax dector 2nd harmonic */
   theta = 2.0 * G_PI * (fax_freq * 2.0 / SAMPLE_RATE);
-  fax_detect_2nd.fac = 2.0 * cos (theta);
-  goertzel_init (&s->fax_tone2nd, &fax_detect_2nd);
+  bank_fac[DTMF_BANK_FAX_2ND] = 2.0 * cos (theta);
+
+  goertzel_bank_init (&s->bank);
+  s->energy = 0.0;
 
   s->current_sample = 0;
   s->detected_digits = 0;
   s->lost_digits = 0;
+  s->current_digits = 0;
   s->digits[0] = '\0';
   s->mhit = 0;
 }
@@ -244,17 +170,19 @@ zap_dtmf_detect_init (dtmf_detect_state_t * s)
 
 int
 zap_dtmf_detect (dtmf_detect_state_t * s,
-    int16_t amp[], int samples, int isradio)
+    int16_t amp[], int samples, int stride, int isradio)
 {
-
+  goertzel_bank_t *b = &s->bank;
   float row_energy[4];
   float col_energy[4];
   float fax_energy;
   float fax_energy_2nd;
+  float energy;
   float famp;
   float v1;
   int i;
   int j;
+  int k;
   int sample;
   int best_row;
   int best_col;
@@ -268,122 +196,41 @@ zap_dtmf_detect (dtmf_detect_state_t * s,
       limit = sample + (102 - s->current_sample);
     else
       limit = samples;
-#if defined(USE_3DNOW)
-    _dtmf_goertzel_update (s->row_out, amp + sample, limit - sample);
-    _dtmf_goertzel_update (s->col_out, amp + sample, limit - sample);
-    _dtmf_goertzel_update (s->row_out2nd, amp + sample, limit2 - sample);
-    _dtmf_goertzel_update (s->col_out2nd, amp + sample, limit2 - sample);
-    /* XXX Need to fax detect for 3dnow too XXX */
-#warning "Fax Support Broken"
-#else
-    /* The following unrolled loop takes only 35% (rough estimate) of the 
-       time of a rolled loop on the machine on which it was developed */
+
+    /* Every filter of the bank sees the same sample, the inner loop has a
+       fixed trip count and no dependency between filters so the compiler
+       runs it 4 filters at a time */
+    energy = s->energy;
     for (j = sample; j < limit; j++) {
-      famp = amp[j];
-
-      s->energy += famp * famp;
-
-      /* With GCC 2.95, the following unrolled code seems to take about 35%
-         (rough estimate) as long as a neat little 0-3 loop */
-      v1 = s->row_out[0].v2;
-      s->row_out[0].v2 = s->row_out[0].v3;
-      s->row_out[0].v3 = s->row_out[0].fac * s->row_out[0].v2 - v1 + famp;
-
-      v1 = s->col_out[0].v2;
-      s->col_out[0].v2 = s->col_out[0].v3;
-      s->col_out[0].v3 = s->col_out[0].fac * s->col_out[0].v2 - v1 + famp;
-
-      v1 = s->row_out[1].v2;
-      s->row_out[1].v2 = s->row_out[1].v3;
-      s->row_out[1].v3 = s->row_out[1].fac * s->row_out[1].v2 - v1 + famp;
-
-      v1 = s->col_out[1].v2;
-      s->col_out[1].v2 = s->col_out[1].v3;
-      s->col_out[1].v3 = s->col_out[1].fac * s->col_out[1].v2 - v1 + famp;
-
-      v1 = s->row_out[2].v2;
-      s->row_out[2].v2 = s->row_out[2].v3;
-      s->row_out[2].v3 = s->row_out[2].fac * s->row_out[2].v2 - v1 + famp;
-
-      v1 = s->col_out[2].v2;
-      s->col_out[2].v2 = s->col_out[2].v3;
-      s->col_out[2].v3 = s->col_out[2].fac * s->col_out[2].v2 - v1 + famp;
-
-      v1 = s->row_out[3].v2;
-      s->row_out[3].v2 = s->row_out[3].v3;
-      s->row_out[3].v3 = s->row_out[3].fac * s->row_out[3].v2 - v1 + famp;
-
-      v1 = s->col_out[3].v2;
-      s->col_out[3].v2 = s->col_out[3].v3;
-      s->col_out[3].v3 = s->col_out[3].fac * s->col_out[3].v2 - v1 + famp;
-
-      v1 = s->col_out2nd[0].v2;
-      s->col_out2nd[0].v2 = s->col_out2nd[0].v3;
-      s->col_out2nd[0].v3 =
-          s->col_out2nd[0].fac * s->col_out2nd[0].v2 - v1 + famp;
-
-      v1 = s->row_out2nd[0].v2;
-      s->row_out2nd[0].v2 = s->row_out2nd[0].v3;
-      s->row_out2nd[0].v3 =
-          s->row_out2nd[0].fac * s->row_out2nd[0].v2 - v1 + famp;
-
-      v1 = s->col_out2nd[1].v2;
-      s->col_out2nd[1].v2 = s->col_out2nd[1].v3;
-      s->col_out2nd[1].v3 =
-          s->col_out2nd[1].fac * s->col_out2nd[1].v2 - v1 + famp;
-
-      v1 = s->row_out2nd[1].v2;
-      s->row_out2nd[1].v2 = s->row_out2nd[1].v3;
-      s->row_out2nd[1].v3 =
-          s->row_out2nd[1].fac * s->row_out2nd[1].v2 - v1 + famp;
-
-      v1 = s->col_out2nd[2].v2;
-      s->col_out2nd[2].v2 = s->col_out2nd[2].v3;
-      s->col_out2nd[2].v3 =
-          s->col_out2nd[2].fac * s->col_out2nd[2].v2 - v1 + famp;
-
-      v1 = s->row_out2nd[2].v2;
-      s->row_out2nd[2].v2 = s->row_out2nd[2].v3;
-      s->row_out2nd[2].v3 =
-          s->row_out2nd[2].fac * s->row_out2nd[2].v2 - v1 + famp;
-
-      v1 = s->col_out2nd[3].v2;
-      s->col_out2nd[3].v2 = s->col_out2nd[3].v3;
-      s->col_out2nd[3].v3 =
-          s->col_out2nd[3].fac * s->col_out2nd[3].v2 - v1 + famp;
-
-      v1 = s->row_out2nd[3].v2;
-      s->row_out2nd[3].v2 = s->row_out2nd[3].v3;
-      s->row_out2nd[3].v3 =
-          s->row_out2nd[3].fac * s->row_out2nd[3].v2 - v1 + famp;
-
-      /* Update fax tone */
-      v1 = s->fax_tone.v2;
-      s->fax_tone.v2 = s->fax_tone.v3;
-      s->fax_tone.v3 = s->fax_tone.fac * s->fax_tone.v2 - v1 + famp;
-
-      v1 = s->fax_tone.v2;
-      s->fax_tone2nd.v2 = s->fax_tone2nd.v3;
-      s->fax_tone2nd.v3 = s->fax_tone2nd.fac * s->fax_tone2nd.v2 - v1 + famp;
+      famp = amp[j * stride];
+
+      energy += famp * famp;
+
+      for (k = 0; k < DTMF_BANK_SIZE; k++) {
+        v1 = b->v2[k];
+        b->v2[k] = b->v3[k];
+        b->v3[k] = b->fac[k] * b->v2[k] - v1 + famp;
+      }
     }
-#endif
+    s->energy = energy;
+
     s->current_sample += (limit - sample);
     if (s->current_sample < 102)
       continue;
 
     /* Detect the fax energy, too */
-    fax_energy = zap_goertzel_result (&s->fax_tone);
+    fax_energy = goertzel_bank_result (b, DTMF_BANK_FAX);
 
     /* We are at the end of a DTMF detection block */
     /* Find the peak row and the peak column */
-    row_energy[0] = zap_goertzel_result (&s->row_out[0]);
-    col_energy[0] = zap_goertzel_result (&s->col_out[0]);
+    row_energy[0] = goertzel_bank_result (b, DTMF_BANK_ROW);
+    col_energy[0] = goertzel_bank_result (b, DTMF_BANK_COL);
 
     for (best_row = best_col = 0, i = 1; i < 4; i++) {
-      row_energy[i] = zap_goertzel_result (&s->row_out[i]);
+      row_energy[i] = goertzel_bank_result (b, DTMF_BANK_ROW + i);
       if (row_energy[i] > row_energy[best_row])
         best_row = i;
-      col_energy[i] = zap_goertzel_result (&s->col_out[i]);
+      col_energy[i] = goertzel_bank_result (b, DTMF_BANK_COL + i);
       if (col_energy[i] > col_energy[best_col])
         best_col = i;
     }
@@ -411,9 +258,9 @@ zap_dtmf_detect (dtmf_detect_state_t * s,
           &&
           (row_energy[best_row] + col_energy[best_col]) > 42.0 * s->energy
           &&
-          zap_goertzel_result (&s->col_out2nd[best_col]) *
+          goertzel_bank_result (b, DTMF_BANK_COL_2ND + best_col) *
           DTMF_2ND_HARMONIC_COL < col_energy[best_col]
-          && zap_goertzel_result (&s->row_out2nd[best_row]) *
+          && goertzel_bank_result (b, DTMF_BANK_ROW_2ND + best_row) *
           DTMF_2ND_HARMONIC_ROW < row_energy[best_row]) {
         hit = dtmf_positions[(best_row << 2) + best_col];
         /* Look for two successive similar results */
@@ -428,6 +275,7 @@ zap_dtmf_detect (dtmf_detect_state_t * s,
           s->digit_hits[(best_row << 2) + best_col]++;
           s->detected_digits++;
           if (s->current_digits < MAX_DTMF_DIGITS) {
+            s->positions[s->current_digits] = limit;
             s->digits[s->current_digits++] = hit;
             s->digits[s->current_digits] = '\0';
           } else {
@@ -438,7 +286,7 @@ zap_dtmf_detect (dtmf_detect_state_t * s,
     }
     if (!hit && (fax_energy >= FAX_THRESHOLD)
         && (fax_energy > s->energy * 21.0)) {
-      fax_energy_2nd = zap_goertzel_result (&s->fax_tone2nd);
+      fax_energy_2nd = goertzel_bank_result (b, DTMF_BANK_FAX_2ND);
       if (fax_energy_2nd * FAX_2ND_HARMONIC < fax_energy) {
 #if 0
         printf ("Fax energy/Second Harmonic: %f/%f\n", fax_energy,
@@ -453,6 +301,7 @@ zap_dtmf_detect (dtmf_detect_state_t * s,
         s->mhit = 'f';
         s->detected_digits++;
         if (s->current_digits < MAX_DTMF_DIGITS) {
+          s->positions[s->current_digits] = limit;
           s->digits[s->current_digits++] = hit;
           s->digits[s->current_digits] = '\0';
         } else {
@@ -465,14 +314,7 @@ zap_dtmf_detect (dtmf_detect_state_t * s,
     s->hit2 = s->hit3;
     s->hit3 = hit;
     /* Reinitialise the detector for the next block */
-    for (i = 0; i < 4; i++) {
-      goertzel_init (&s->row_out[i], &dtmf_detect_row[i]);
-      goertzel_init (&s->col_out[i], &dtmf_detect_col[i]);
-      goertzel_init (&s->row_out2nd[i], &dtmf_detect_row_2nd[i]);
-      goertzel_init (&s->col_out2nd[i], &dtmf_detect_col_2nd[i]);
-    }
-    goertzel_init (&s->fax_tone, &fax_detect);
-    goertzel_init (&s->fax_tone2nd, &fax_detect_2nd);
+    goertzel_bank_init (b);
     s->energy = 0.0;
     s->current_sample = 0;
   }
@@ -486,13 +328,17 @@ zap_dtmf_detect (dtmf_detect_state_t * s,
 /*- End of function --------------------------------------------------------*/
 
 int
-zap_dtmf_get (dtmf_detect_state_t * s, char *buf, int max)
+zap_dtmf_get (dtmf_detect_state_t * s, char *buf, int *positions, int max)
 {
   if (max > s->current_digits)
     max = s->current_digits;
   if (max > 0) {
     memcpy (buf, s->digits, max);
     memmove (s->digits, s->digits + max, s->current_digits - max);
+    if (positions)
+      memcpy (positions, s->positions, max * sizeof (int));
+    memmove (s->positions, s->positions + max,
+        (s->current_digits - max) * sizeof (int));
     s->current_digits -= max;
   }
   buf[max] = '\0';
@@ -46,6 +46,24 @@ typedef struct
 
 #define	MAX_DTMF_DIGITS 128
 
+/* All the filters of the detector run as one bank, so that a single loop
+   over the bank updates every frequency for a sample. The size is padded to
+   a multiple of 4, the unused filters stay at zero. */
+#define DTMF_BANK_ROW               0
+#define DTMF_BANK_COL               4
+#define DTMF_BANK_ROW_2ND           8
+#define DTMF_BANK_COL_2ND           12
+#define DTMF_BANK_FAX               16
+#define DTMF_BANK_FAX_2ND           17
+#define DTMF_BANK_SIZE              20
+
+typedef struct
+{
+    float v2[DTMF_BANK_SIZE];
+    float v3[DTMF_BANK_SIZE];
+    float fac[DTMF_BANK_SIZE];
+} goertzel_bank_t;
+
 typedef struct
 {
     int hit1;
@@ -54,16 +72,13 @@ typedef struct
     int hit4;
     int mhit;
 
-    goertzel_state_t row_out[4];
-    goertzel_state_t col_out[4];
-    goertzel_state_t row_out2nd[4];
-    goertzel_state_t col_out2nd[4];
-	goertzel_state_t fax_tone;
-	goertzel_state_t fax_tone2nd;
+    goertzel_bank_t bank;
     float energy;
     
     int current_sample;
     char digits[MAX_DTMF_DIGITS + 1];
+    /* sample offset in the last zap_dtmf_detect() call of each digit */
+    int positions[MAX_DTMF_DIGITS];
     int current_digits;
     int detected_digits;
     int lost_digits;
@@ -85,9 +100,11 @@ void zap_dtmf_detect_init (dtmf_detect_state_t *s);
 int zap_dtmf_detect (dtmf_detect_state_t *s,
                  gint16 amp[],
                  int samples,
+                 int stride,
 		 int isradio);
 int zap_dtmf_get (dtmf_detect_state_t *s,
               char *buf,
+              int *positions,
               int max);
 
 #endif /* __TONE_DETECT_H__ */
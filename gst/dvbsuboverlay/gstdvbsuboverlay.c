@@ -38,6 +38,7 @@
 #endif
 
 #include "gstdvbsuboverlay.h"
+#include "gstdvbsuboverlayorc.h"
 
 #include <string.h>
 
@@ -60,17 +61,19 @@ enum
 #define DEFAULT_ENABLE (TRUE)
 #define DEFAULT_MAX_PAGE_TIMEOUT (0)
 
+#define DVBSUB_OVERLAY_CAPS GST_VIDEO_CAPS_YUV ("{ I420, YV12, NV12, UYVY, AYUV }")
+
 static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
-    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("I420"))
+    GST_STATIC_CAPS (DVBSUB_OVERLAY_CAPS)
     );
 
 static GstStaticPadTemplate video_sink_factory =
 GST_STATIC_PAD_TEMPLATE ("video_sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
-    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("I420"))
+    GST_STATIC_CAPS (DVBSUB_OVERLAY_CAPS)
     );
 
 static GstStaticPadTemplate text_sink_factory =
@@ -114,6 +117,10 @@ static GstFlowReturn gst_dvbsub_overlay_bufferalloc_video (GstPad * pad,
 
 static gboolean gst_dvbsub_overlay_query_src (GstPad * pad, GstQuery * query);
 
+static void gst_dvbsub_overlay_set_current_subtitle (GstDVBSubOverlay *
+    overlay, DVBSubtitles * subs);
+static void gst_dvbsub_overlay_clear_rendered (GstDVBSubOverlay * overlay);
+
 static void
 gst_dvbsub_overlay_base_init (gpointer gclass)
 {
@@ -167,9 +174,7 @@ gst_dvbsub_overlay_flush_subtitles (GstDVBSubOverlay * render)
     dvb_subtitles_free (subs);
   }
 
-  if (render->current_subtitle)
-    dvb_subtitles_free (render->current_subtitle);
-  render->current_subtitle = NULL;
+  gst_dvbsub_overlay_set_current_subtitle (render, NULL);
 
   if (render->dvb_sub)
     dvb_sub_free (render->dvb_sub);
@@ -231,6 +236,8 @@ gst_dvbsub_overlay_init (GstDVBSubOverlay * render,
 
   render->current_subtitle = NULL;
   render->pending_subtitles = g_queue_new ();
+  render->rendered_areas =
+      g_array_new (FALSE, FALSE, sizeof (GstDVBSubOverlayArea));
 
   render->enable = DEFAULT_ENABLE;
   render->max_page_timeout = DEFAULT_MAX_PAGE_TIMEOUT;
@@ -255,9 +262,8 @@ gst_dvbsub_overlay_finalize (GObject * object)
   }
   g_queue_free (overlay->pending_subtitles);
 
-  if (overlay->current_subtitle)
-    dvb_subtitles_free (overlay->current_subtitle);
-  overlay->current_subtitle = NULL;
+  gst_dvbsub_overlay_set_current_subtitle (overlay, NULL);
+  g_array_free (overlay->rendered_areas, TRUE);
 
   if (overlay->dvb_sub)
     dvb_sub_free (overlay->dvb_sub);
@@ -432,45 +438,322 @@ gst_dvbsub_overlay_getcaps (GstPad * pad)
 }
 
 static void
-blit_i420 (GstDVBSubOverlay * overlay, DVBSubtitles * subs, GstBuffer * buffer)
+gst_dvbsub_overlay_clear_rendered (GstDVBSubOverlay * overlay)
 {
-  guint counter;
-  DVBSubtitleRect *sub_region;
-  gint a1, a2, a3, a4;
-  gint y1, y2, y3, y4;
-  gint u1, u2, u3, u4;
-  gint v1, v2, v3, v4;
-  guint32 color;
-  const guint8 *src;
-  guint8 *dst_y, *dst_y2, *dst_u, *dst_v;
+  guint i;
+
+  for (i = 0; i < overlay->rendered_areas->len; i++) {
+    GstDVBSubOverlayArea *area =
+        &g_array_index (overlay->rendered_areas, GstDVBSubOverlayArea, i);
+
+    g_free (area->data);
+    g_free (area->alpha);
+  }
+  g_array_set_size (overlay->rendered_areas, 0);
+  overlay->rendered = FALSE;
+}
+
+/* takes ownership of subs, must be called with the dvbsub_mutex held */
+static void
+gst_dvbsub_overlay_set_current_subtitle (GstDVBSubOverlay * overlay,
+    DVBSubtitles * subs)
+{
+  if (overlay->current_subtitle)
+    dvb_subtitles_free (overlay->current_subtitle);
+  overlay->current_subtitle = subs;
+
+  gst_dvbsub_overlay_clear_rendered (overlay);
+}
+
+static GstDVBSubOverlayArea *
+gst_dvbsub_overlay_add_area (GstDVBSubOverlay * overlay, guint plane_offset,
+    gint stride, gint x, gint y, gint width, gint height)
+{
+  GstDVBSubOverlayArea area;
+
+  area.offset = plane_offset + y * stride + x;
+  area.stride = stride;
+  area.width = width;
+  area.height = height;
+  area.data = g_malloc0 (width * height);
+  area.alpha = g_malloc0 (width * height);
+
+  g_array_append_val (overlay->rendered_areas, area);
+
+  return &g_array_index (overlay->rendered_areas, GstDVBSubOverlayArea,
+      overlay->rendered_areas->len - 1);
+}
+
+/* A subtitle region converted to premultiplied AYUV at the video resolution
+ * and cropped to its visible pixels */
+typedef struct
+{
+  guint8 *mem;
+  guint8 *data;                 /* top left visible pixel in mem */
+  gint stride;
+  gint x, y, width, height;     /* position in the video frame */
+} GstDVBSubOverlayPixels;
+
+static const guint8 transparent_pixel[4] = { 0, 0, 0, 0 };
+
+static inline const guint8 *
+pixel_at (const GstDVBSubOverlayPixels * pixels, gint x, gint y)
+{
+  if (x < pixels->x || x >= pixels->x + pixels->width ||
+      y < pixels->y || y >= pixels->y + pixels->height)
+    return transparent_pixel;
+
+  return pixels->data + (y - pixels->y) * pixels->stride + (x - pixels->x) * 4;
+}
+
+static gboolean
+gst_dvbsub_overlay_convert_rect (GstDVBSubOverlay * overlay,
+    DVBSubtitles * subs, DVBSubtitleRect * sub_region, gint scale_x,
+    gint scale_y, GstDVBSubOverlayPixels * pixels)
+{
+  gint width = overlay->width;
+  gint height = overlay->height;
+  gint dw, dh, dx, dy;
+  gint32 sx, sy;                /* 16.16 fixed point */
+  gint32 xstep, ystep;          /* 16.16 fixed point */
   gint x, y;
-  gint w2;
+  gint min_x, min_y, max_x, max_y;
+  guint8 *dst;
+
+  dx = sub_region->x;
+  dy = sub_region->y;
+  dw = sub_region->w;
+  dh = sub_region->h;
+
+  if (scale_x) {
+    dx = (dx * scale_x) >> 16;
+    dy = (dy * scale_y) >> 16;
+    dw = (dw * scale_x) >> 16;
+    dh = (dh * scale_y) >> 16;
+    /* apply subtitle window offsets after scaling */
+    if (subs->display_def.window_flag) {
+      dx += subs->display_def.window_x;
+      dy += subs->display_def.window_y;
+    }
+  }
+
+  if (dx < 0 || dy < 0 || dx >= width || dy >= height || dw <= 0 || dh <= 0)
+    return FALSE;
+
+  dw = MIN (dw, width - dx);
+  dh = MIN (dh, height - dy);
+
+  xstep = (sub_region->w << 16) / dw;
+  ystep = (sub_region->h << 16) / dh;
+
+  pixels->stride = dw * 4;
+  pixels->mem = g_malloc (dh * pixels->stride);
+
+  min_x = dw;
+  min_y = dh;
+  max_x = max_y = -1;
+
+  sy = 0;
+  for (y = 0; y < dh; y++) {
+    const guint8 *src =
+        sub_region->pict.data + (sy >> 16) * sub_region->pict.rowstride;
+
+    dst = pixels->mem + y * pixels->stride;
+    sx = 0;
+    for (x = 0; x < dw; x++) {
+      guint32 color = sub_region->pict.palette[src[sx >> 16]];
+      gint a = (color >> 24) & 0xff;
+
+      dst[0] = a;
+      dst[1] = (((color >> 16) & 0xff) * a + 127) / 255;
+      dst[2] = (((color >> 8) & 0xff) * a + 127) / 255;
+      dst[3] = ((color & 0xff) * a + 127) / 255;
+
+      if (a) {
+        min_x = MIN (min_x, x);
+        max_x = MAX (max_x, x);
+        min_y = MIN (min_y, y);
+        max_y = MAX (max_y, y);
+      }
+
+      dst += 4;
+      sx += xstep;
+    }
+    sy += ystep;
+  }
+
+  if (max_x < 0) {
+    /* fully transparent */
+    g_free (pixels->mem);
+    return FALSE;
+  }
+
+  /* crop to the visible pixels */
+  pixels->data = pixels->mem + min_y * pixels->stride + min_x * 4;
+  pixels->x = dx + min_x;
+  pixels->y = dy + min_y;
+  pixels->width = max_x - min_x + 1;
+  pixels->height = max_y - min_y + 1;
+
+  return TRUE;
+}
+
+static void
+gst_dvbsub_overlay_add_planar_chroma (GstDVBSubOverlay * overlay,
+    const GstDVBSubOverlayPixels * pixels, gboolean interleaved)
+{
+  GstVideoFormat format = overlay->format;
+  GstDVBSubOverlayArea *u_area, *v_area = NULL;
+  gint cx0, cy0, cw, ch;
+  gint cx, cy;
+
+  cx0 = pixels->x / 2;
+  cy0 = pixels->y / 2;
+  cw = (pixels->x + pixels->width + 1) / 2 - cx0;
+  ch = (pixels->y + pixels->height + 1) / 2 - cy0;
+
+  if (interleaved) {
+    u_area = gst_dvbsub_overlay_add_area (overlay,
+        gst_video_format_get_component_offset (format, 1, overlay->width,
+            overlay->height),
+        gst_video_format_get_row_stride (format, 1, overlay->width),
+        cx0 * 2, cy0, cw * 2, ch);
+  } else {
+    u_area = gst_dvbsub_overlay_add_area (overlay,
+        gst_video_format_get_component_offset (format, 1, overlay->width,
+            overlay->height),
+        gst_video_format_get_row_stride (format, 1, overlay->width),
+        cx0, cy0, cw, ch);
+    v_area = gst_dvbsub_overlay_add_area (overlay,
+        gst_video_format_get_component_offset (format, 2, overlay->width,
+            overlay->height),
+        gst_video_format_get_row_stride (format, 2, overlay->width),
+        cx0, cy0, cw, ch);
+    /* adding the second area may have moved the first one */
+    u_area = v_area - 1;
+  }
+
+  for (cy = 0; cy < ch; cy++) {
+    for (cx = 0; cx < cw; cx++) {
+      gint x = (cx0 + cx) * 2, y = (cy0 + cy) * 2;
+      const guint8 *p00 = pixel_at (pixels, x, y);
+      const guint8 *p01 = pixel_at (pixels, x + 1, y);
+      const guint8 *p10 = pixel_at (pixels, x, y + 1);
+      const guint8 *p11 = pixel_at (pixels, x + 1, y + 1);
+      guint8 a = (p00[0] + p01[0] + p10[0] + p11[0] + 2) / 4;
+      guint8 u = (p00[2] + p01[2] + p10[2] + p11[2] + 2) / 4;
+      guint8 v = (p00[3] + p01[3] + p10[3] + p11[3] + 2) / 4;
+
+      if (interleaved) {
+        gint i = cy * u_area->width + cx * 2;
+
+        u_area->data[i] = u;
+        u_area->data[i + 1] = v;
+        u_area->alpha[i] = u_area->alpha[i + 1] = a;
+      } else {
+        gint i = cy * cw + cx;
+
+        u_area->data[i] = u;
+        v_area->data[i] = v;
+        u_area->alpha[i] = v_area->alpha[i] = a;
+      }
+    }
+  }
+}
+
+static void
+gst_dvbsub_overlay_add_pixels (GstDVBSubOverlay * overlay,
+    const GstDVBSubOverlayPixels * pixels)
+{
+  GstVideoFormat format = overlay->format;
+  GstDVBSubOverlayArea *area;
+  gint stride = gst_video_format_get_row_stride (format, 0, overlay->width);
+  gint x, y;
+
+  switch (format) {
+    case GST_VIDEO_FORMAT_I420:
+    case GST_VIDEO_FORMAT_YV12:
+    case GST_VIDEO_FORMAT_NV12:
+      area = gst_dvbsub_overlay_add_area (overlay,
+          gst_video_format_get_component_offset (format, 0, overlay->width,
+              overlay->height), stride, pixels->x, pixels->y, pixels->width,
+          pixels->height);
+      for (y = 0; y < pixels->height; y++) {
+        for (x = 0; x < pixels->width; x++) {
+          const guint8 *p = pixel_at (pixels, pixels->x + x, pixels->y + y);
+
+          area->data[y * area->width + x] = p[1];
+          area->alpha[y * area->width + x] = p[0];
+        }
+      }
+      gst_dvbsub_overlay_add_planar_chroma (overlay, pixels,
+          format == GST_VIDEO_FORMAT_NV12);
+      break;
+    case GST_VIDEO_FORMAT_UYVY:{
+      gint x0 = pixels->x & ~1;
+      gint pairs = (pixels->x + pixels->width + 1) / 2 - x0 / 2;
+
+      area = gst_dvbsub_overlay_add_area (overlay, 0, stride, x0 * 2,
+          pixels->y, pairs * 4, pixels->height);
+      for (y = 0; y < pixels->height; y++) {
+        guint8 *data = area->data + y * area->width;
+        guint8 *alpha = area->alpha + y * area->width;
+
+        for (x = 0; x < pairs; x++) {
+          const guint8 *p0 = pixel_at (pixels, x0 + 2 * x, pixels->y + y);
+          const guint8 *p1 = pixel_at (pixels, x0 + 2 * x + 1, pixels->y + y);
+          guint8 a = (p0[0] + p1[0] + 1) / 2;
+
+          data[0] = (p0[2] + p1[2] + 1) / 2;
+          data[1] = p0[1];
+          data[2] = (p0[3] + p1[3] + 1) / 2;
+          data[3] = p1[1];
+          alpha[0] = alpha[2] = a;
+          alpha[1] = p0[0];
+          alpha[3] = p1[0];
+          data += 4;
+          alpha += 4;
+        }
+      }
+      break;
+    }
+    case GST_VIDEO_FORMAT_AYUV:
+      /* blending premultiplied alpha onto the alpha channel with the same
+       * equation gives the alpha of the composition */
+      area = gst_dvbsub_overlay_add_area (overlay, 0, stride, pixels->x * 4,
+          pixels->y, pixels->width * 4, pixels->height);
+      for (y = 0; y < pixels->height; y++) {
+        const guint8 *p = pixel_at (pixels, pixels->x, pixels->y + y);
+        guint8 *data = area->data + y * area->width;
+        guint8 *alpha = area->alpha + y * area->width;
+
+        memcpy (data, p, area->width);
+        for (x = 0; x < area->width; x++)
+          alpha[x] = p[x & ~3];
+      }
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+/* converts the palette based regions of a page once into premultiplied
+ * samples in the layout of the video frame, so that each video frame only
+ * needs a blend of the covered areas */
+static void
+gst_dvbsub_overlay_render (GstDVBSubOverlay * overlay, DVBSubtitles * subs)
+{
   gint width = overlay->width;
   gint height = overlay->height;
-  gint src_stride;
-  gint y_offset, y_stride;
-  gint u_offset, u_stride;
-  gint v_offset, v_stride;
-  gint scale = 0;
   gint scale_x = 0, scale_y = 0;        /* 16.16 fixed point */
+  gint x1 = width, y1 = height, x2 = 0, y2 = 0;
+  guint counter;
 
-  y_offset =
-      gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, 0, width,
-      height);
-  u_offset =
-      gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, 1, width,
-      height);
-  v_offset =
-      gst_video_format_get_component_offset (GST_VIDEO_FORMAT_I420, 2, width,
-      height);
-
-  y_stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 0, width);
-  u_stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 1, width);
-  v_stride = gst_video_format_get_row_stride (GST_VIDEO_FORMAT_I420, 2, width);
+  gst_dvbsub_overlay_clear_rendered (overlay);
 
   if (width != subs->display_def.display_width &&
       height != subs->display_def.display_height) {
-    scale = 1;
     if (subs->display_def.window_flag) {
       scale_x = (width << 16) / subs->display_def.window_width;
       scale_y = (height << 16) / subs->display_def.window_height;
@@ -481,194 +764,58 @@ blit_i420 (GstDVBSubOverlay * overlay, DVBSubtitles * subs, GstBuffer * buffer)
   }
 
   for (counter = 0; counter < subs->num_rects; counter++) {
-    gint dw, dh, dx, dy;
-    gint32 sx = 0, sy;          /* 16.16 fixed point */
-    gint32 xstep, ystep;        /* 16.16 fixed point */
+    GstDVBSubOverlayPixels pixels;
 
-    sub_region = &subs->rects[counter];
-    if (sub_region->y > height || sub_region->x > width)
+    if (!gst_dvbsub_overlay_convert_rect (overlay, subs,
+            &subs->rects[counter], scale_x, scale_y, &pixels))
       continue;
 
-    /* blend subtitles onto the video frame */
-    dx = sub_region->x;
-    dy = sub_region->y;
-    dw = sub_region->w;
-    dh = sub_region->h;
-
-    if (scale) {
-      dx = (dx * scale_x) >> 16;
-      dy = (dy * scale_y) >> 16;
-      dw = (dw * scale_x) >> 16;
-      dh = (dh * scale_y) >> 16;
-      /* apply subtitle window offsets after scaling */
-      if (subs->display_def.window_flag) {
-        dx += subs->display_def.window_x;
-        dy += subs->display_def.window_y;
-      }
-    }
-
-    dw = MIN (dw, width - dx);
-    dh = MIN (dh, height - dx);
-
-    xstep = (sub_region->w << 16) / dw;
-    ystep = (sub_region->h << 16) / dh;
-
-    w2 = (dw + 1) / 2;
-
-    src_stride = sub_region->pict.rowstride;
-
-    src = sub_region->pict.data;
-    dst_y = buffer->data + y_offset + dy * y_stride + dx;
-    dst_y2 = buffer->data + y_offset + (dy + 1) * y_stride + dx;
-    dst_u = buffer->data + u_offset + ((dy + 1) / 2) * u_stride + (dx + 1) / 2;
-    dst_v = buffer->data + v_offset + ((dy + 1) / 2) * v_stride + (dx + 1) / 2;
-
-    sy = 0;
-    for (y = 0; y < dh - 1; y += 2) {
-      sx = 0;
-      for (x = 0; x < dw - 1; x += 2) {
-
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + (sx >> 16)]];
-        a1 = (color >> 24) & 0xff;
-        y1 = (color >> 16) & 0xff;
-        u1 = ((color >> 8) & 0xff) * a1;
-        v1 = (color & 0xff) * a1;
-
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + ((sx +
-                        xstep) >> 16)]];
-        a2 = (color >> 24) & 0xff;
-        y2 = (color >> 16) & 0xff;
-        u2 = ((color >> 8) & 0xff) * a2;
-        v2 = (color & 0xff) * a2;
-
-        color =
-            sub_region->pict.palette[src[((sy + ystep) >> 16) * src_stride +
-                (sx >> 16)]];
-        a3 = (color >> 24) & 0xff;
-        y3 = (color >> 16) & 0xff;
-        u3 = ((color >> 8) & 0xff) * a3;
-        v3 = (color & 0xff) * a3;
-
-        color =
-            sub_region->pict.palette[src[((sy + ystep) >> 16) * src_stride +
-                ((sx + xstep) >> 16)]];
-        a4 = (color >> 24) & 0xff;
-        y4 = (color >> 16) & 0xff;
-        u4 = ((color >> 8) & 0xff) * a4;
-        v4 = (color & 0xff) * a4;
-
-        dst_y[0] = (a1 * y1 + (255 - a1) * dst_y[0]) / 255;
-        dst_y[1] = (a2 * y2 + (255 - a2) * dst_y[1]) / 255;
-        dst_y2[0] = (a3 * y3 + (255 - a3) * dst_y2[0]) / 255;
-        dst_y2[1] = (a4 * y4 + (255 - a4) * dst_y2[1]) / 255;
-
-        a1 = (a1 + a2 + a3 + a4) / 4;
-        dst_u[0] = ((u1 + u2 + u3 + u4) / 4 + (255 - a1) * dst_u[0]) / 255;
-        dst_v[0] = ((v1 + v2 + v3 + v4) / 4 + (255 - a1) * dst_v[0]) / 255;
-
-        dst_y += 2;
-        dst_y2 += 2;
-        dst_u += 1;
-        dst_v += 1;
-        sx += 2 * xstep;
-      }
-
-      /* Odd width */
-      if (x < dw) {
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + (sx >> 16)]];
-        a1 = (color >> 24) & 0xff;
-        y1 = (color >> 16) & 0xff;
-        u1 = ((color >> 8) & 0xff) * a1;
-        v1 = (color & 0xff) * a1;
-
-        color =
-            sub_region->pict.palette[src[((sy + ystep) >> 16) * src_stride +
-                (sx >> 16)]];
-        a3 = (color >> 24) & 0xff;
-        y3 = (color >> 16) & 0xff;
-        u3 = ((color >> 8) & 0xff) * a3;
-        v3 = (color & 0xff) * a3;
-
-        dst_y[0] = (a1 * y1 + (255 - a1) * dst_y[0]) / 255;
-        dst_y2[0] = (a3 * y3 + (255 - a3) * dst_y2[0]) / 255;
-
-        a1 = (a1 + a3) / 2;
-        dst_u[0] = ((u1 + u3) / 2 + (255 - a1) * dst_u[0]) / 255;
-        dst_v[0] = ((v1 + v3) / 2 + (255 - a1) * dst_v[0]) / 255;
-
-        dst_y += 1;
-        dst_y2 += 1;
-        dst_u += 1;
-        dst_v += 1;
-        sx += xstep;
-      }
+    gst_dvbsub_overlay_add_pixels (overlay, &pixels);
+    g_free (pixels.mem);
 
-      sy += 2 * ystep;
+    x1 = MIN (x1, pixels.x);
+    y1 = MIN (y1, pixels.y);
+    x2 = MAX (x2, pixels.x + pixels.width);
+    y2 = MAX (y2, pixels.y + pixels.height);
+  }
 
-      dst_y += y_stride + (y_stride - dw);
-      dst_y2 += y_stride + (y_stride - dw);
-      dst_u += u_stride - w2;
-      dst_v += v_stride - w2;
-    }
+  if (overlay->rendered_areas->len > 0) {
+    overlay->bbox_x = x1;
+    overlay->bbox_y = y1;
+    overlay->bbox_w = x2 - x1;
+    overlay->bbox_h = y2 - y1;
+  } else {
+    overlay->bbox_x = overlay->bbox_y = overlay->bbox_w = overlay->bbox_h = 0;
+  }
+  overlay->rendered = TRUE;
 
-    /* Odd height */
-    if (y < dh) {
-      sx = 0;
-      for (x = 0; x < dw - 1; x += 2) {
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + (sx >> 16)]];
-        a1 = (color >> 24) & 0xff;
-        y1 = (color >> 16) & 0xff;
-        u1 = ((color >> 8) & 0xff) * a1;
-        v1 = (color & 0xff) * a1;
-
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + ((sx +
-                        xstep) >> 16)]];
-        a2 = (color >> 24) & 0xff;
-        y2 = (color >> 16) & 0xff;
-        u2 = ((color >> 8) & 0xff) * a2;
-        v2 = (color & 0xff) * a2;
-
-        dst_y[0] = (a1 * y1 + (255 - a1) * dst_y[0]) / 255;
-        dst_y[1] = (a2 * y2 + (255 - a2) * dst_y[1]) / 255;
-
-        a1 = (a1 + a2) / 2;
-        dst_u[0] = ((u1 + u2) / 2 + (255 - a1) * dst_u[0]) / 255;
-        dst_v[0] = ((v1 + v2) / 2 + (255 - a1) * dst_v[0]) / 255;
-
-        dst_y += 2;
-        dst_u += 1;
-        dst_v += 1;
-        sx += 2 * xstep;
-      }
+  GST_DEBUG_OBJECT (overlay, "rendered %u regions into %u areas, bounding "
+      "box %dx%d at %d,%d", subs->num_rects, overlay->rendered_areas->len,
+      overlay->bbox_w, overlay->bbox_h, overlay->bbox_x, overlay->bbox_y);
+}
 
-      /* Odd height and width */
-      if (x < dw) {
-        color =
-            sub_region->pict.palette[src[(sy >> 16) * src_stride + (sx >> 16)]];
-        a1 = (color >> 24) & 0xff;
-        y1 = (color >> 16) & 0xff;
-        u1 = ((color >> 8) & 0xff) * a1;
-        v1 = (color & 0xff) * a1;
+static void
+gst_dvbsub_overlay_blend (GstDVBSubOverlay * overlay, GstBuffer * buffer)
+{
+  guint i;
 
-        dst_y[0] = (a1 * y1 + (255 - a1) * dst_y[0]) / 255;
+  if (GST_BUFFER_SIZE (buffer) < gst_video_format_get_size (overlay->format,
+          overlay->width, overlay->height)) {
+    GST_WARNING_OBJECT (overlay, "video buffer too small (%u bytes), not "
+        "rendering subtitles", GST_BUFFER_SIZE (buffer));
+    return;
+  }
 
-        dst_u[0] = (u1 + (255 - a1) * dst_u[0]) / 255;
-        dst_v[0] = (v1 + (255 - a1) * dst_v[0]) / 255;
+  for (i = 0; i < overlay->rendered_areas->len; i++) {
+    GstDVBSubOverlayArea *area =
+        &g_array_index (overlay->rendered_areas, GstDVBSubOverlayArea, i);
 
-        dst_y += 1;
-        dst_u += 1;
-        dst_v += 1;
-        sx += xstep;
-      }
-    }
+    orc_dvbsub_blend_premultiplied (GST_BUFFER_DATA (buffer) + area->offset,
+        area->stride, area->data, area->width, area->alpha, area->width,
+        area->width, area->height);
   }
 
-  GST_LOG_OBJECT (overlay, "amount of rendered DVBSubtitleRect: %u", counter);
+  GST_LOG_OBJECT (overlay, "blended %u areas", i);
 }
 
 static gboolean
@@ -691,6 +838,11 @@ gst_dvbsub_overlay_setcaps_video (GstPad * pad, GstCaps * caps)
   gst_video_parse_caps_pixel_aspect_ratio (caps, &render->par_n,
       &render->par_d);
 
+  /* the pre-rendered page is specific to the format and frame size */
+  g_mutex_lock (render->dvbsub_mutex);
+  gst_dvbsub_overlay_clear_rendered (render);
+  g_mutex_unlock (render->dvbsub_mutex);
+
   ret = gst_pad_set_caps (render->srcpad, caps);
   if (!ret)
     goto out;
@@ -881,9 +1033,7 @@ gst_dvbsub_overlay_chain_video (GstPad * pad, GstBuffer * buffer)
         break;
       } else if (tmp->num_rects == 0) {
         /* Clear screen */
-        if (overlay->current_subtitle)
-          dvb_subtitles_free (overlay->current_subtitle);
-        overlay->current_subtitle = NULL;
+        gst_dvbsub_overlay_set_current_subtitle (overlay, NULL);
         if (candidate)
           dvb_subtitles_free (candidate);
         candidate = NULL;
@@ -910,9 +1060,7 @@ gst_dvbsub_overlay_chain_video (GstPad * pad, GstBuffer * buffer)
           GST_TIME_FORMAT ") - it has %u regions",
           GST_TIME_ARGS (vid_running_time), GST_TIME_ARGS (candidate->pts),
           candidate->num_rects);
-      dvb_subtitles_free (overlay->current_subtitle);
-      overlay->current_subtitle = candidate;
-      /* FIXME: Pre-convert current_subtitle to a quick-blend format, num_rects=0 means that there are no regions, e.g, a subtitle "clear" happened */
+      gst_dvbsub_overlay_set_current_subtitle (overlay, candidate);
     }
   }
 
@@ -925,14 +1073,18 @@ gst_dvbsub_overlay_chain_video (GstPad * pad, GstBuffer * buffer)
     GST_INFO_OBJECT (overlay,
         "Subtitle page not redefined before fallback page_time_out of %u seconds (missed data?) - deleting current page",
         overlay->current_subtitle->page_time_out);
-    dvb_subtitles_free (overlay->current_subtitle);
-    overlay->current_subtitle = NULL;
+    gst_dvbsub_overlay_set_current_subtitle (overlay, NULL);
   }
 
   /* Now render it */
   if (g_atomic_int_get (&overlay->enable) && overlay->current_subtitle) {
-    buffer = gst_buffer_make_writable (buffer);
-    blit_i420 (overlay, overlay->current_subtitle, buffer);
+    if (!overlay->rendered)
+      gst_dvbsub_overlay_render (overlay, overlay->current_subtitle);
+
+    if (overlay->rendered_areas->len > 0) {
+      buffer = gst_buffer_make_writable (buffer);
+      gst_dvbsub_overlay_blend (overlay, buffer);
+    }
   }
   g_mutex_unlock (overlay->dvbsub_mutex);
 
@@ -1074,6 +1226,8 @@ plugin_init (GstPlugin * plugin)
   GST_DEBUG_CATEGORY_INIT (gst_dvbsub_overlay_debug, "dvbsuboverlay",
       0, "DVB subtitle overlay");
 
+  gst_dvbsuboverlay_orc_init ();
+
   return gst_element_register (plugin, "dvbsuboverlay",
       GST_RANK_PRIMARY, GST_TYPE_DVBSUB_OVERLAY);
 }
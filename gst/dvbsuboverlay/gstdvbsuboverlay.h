@@ -34,6 +34,20 @@ G_BEGIN_DECLS
 
 typedef struct _GstDVBSubOverlay GstDVBSubOverlay;
 typedef struct _GstDVBSubOverlayClass GstDVBSubOverlayClass;
+typedef struct _GstDVBSubOverlayArea GstDVBSubOverlayArea;
+
+/* A part of the current subtitle page, pre-rendered as premultiplied samples
+ * in the layout of one plane of the video frame. @alpha holds the alpha value
+ * to blend with for each sample in @data */
+struct _GstDVBSubOverlayArea
+{
+  guint offset;                 /* of the top left sample in the video frame */
+  gint stride;                  /* of the plane in the video frame */
+  gint width, height;           /* in bytes and lines */
+
+  guint8 *data;
+  guint8 *alpha;
+};
 
 struct _GstDVBSubOverlay
 {
@@ -58,7 +72,13 @@ struct _GstDVBSubOverlay
   GQueue *pending_subtitles; /* A queue of raw subtitle region sets with
 			      * metadata that are waiting their running time */
 
-  GMutex *dvbsub_mutex; /* protects the queue and the DvbSub instance */
+  /* current_subtitle, pre-rendered for the negotiated video format */
+  gboolean rendered;
+  GArray *rendered_areas; /* of GstDVBSubOverlayArea */
+  gint bbox_x, bbox_y, bbox_w, bbox_h; /* bounding box of all areas */
+
+  GMutex *dvbsub_mutex; /* protects the queue, the DvbSub instance and the
+			 * current and pre-rendered subtitle page */
   DvbSub *dvb_sub;
 };
 
@@ -82,6 +82,10 @@ GST_DEBUG_CATEGORY_STATIC (gst_field_analysis_debug);
 #define DEFAULT_BLOCK_HEIGHT 16
 #define DEFAULT_BLOCK_THRESH 80
 #define DEFAULT_IGNORED_LINES 2
+#define DEFAULT_THREADS 0
+
+/* minimum number of lines (or rows of blocks) per slice */
+#define MIN_SLICE_UNITS 8
 
 enum
 {
@@ -96,7 +100,8 @@ enum
   PROP_BLOCK_WIDTH,
   PROP_BLOCK_HEIGHT,
   PROP_BLOCK_THRESH,
-  PROP_IGNORED_LINES
+  PROP_IGNORED_LINES,
+  PROP_THREADS
 };
 
 static GstStaticPadTemplate sink_factory =
@@ -291,6 +296,8 @@ gst_field_analysis_class_init (GstFieldAnalysisClass * klass)
           "Ignore this many lines from the top and bottom for windowed comb detection",
           2, G_MAXUINT64, DEFAULT_IGNORED_LINES,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_THREADS,
+      gst_base_video_slices_param_spec_threads ());
 
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_field_analysis_change_state);
@@ -305,13 +312,14 @@ static gfloat same_parity_3_tap (GstFieldAnalysis * filter,
 static gfloat opposite_parity_5_tap (GstFieldAnalysis * filter,
     FieldAnalysisFields * fields);
 static guint64 block_score_for_row_32detect (GstFieldAnalysis * filter,
-    guint8 * base_fj, guint8 * base_fjp1);
+    FieldAnalysisSlice * slice, guint8 * base_fj, guint8 * base_fjp1);
 static guint64 block_score_for_row_iscombed (GstFieldAnalysis * filter,
-    guint8 * base_fj, guint8 * base_fjp1);
+    FieldAnalysisSlice * slice, guint8 * base_fj, guint8 * base_fjp1);
 static guint64 block_score_for_row_5_tap (GstFieldAnalysis * filter,
-    guint8 * base_fj, guint8 * base_fjp1);
+    FieldAnalysisSlice * slice, guint8 * base_fj, guint8 * base_fjp1);
 static gfloat opposite_parity_windowed_comb (GstFieldAnalysis * filter,
     FieldAnalysisFields * fields);
+static void gst_field_analysis_slice_func (gpointer data, gpointer user_data);
 
 
 static void
@@ -332,10 +340,6 @@ gst_field_analysis_reset (GstFieldAnalysis * filter)
   filter->is_telecine = FALSE;
   filter->first_buffer = TRUE;
   filter->width = 0;
-  g_free (filter->comb_mask);
-  filter->comb_mask = NULL;
-  g_free (filter->block_scores);
-  filter->block_scores = NULL;
 }
 
 static void
@@ -360,6 +364,10 @@ gst_field_analysis_init (GstFieldAnalysis * filter,
   gst_element_add_pad (GST_ELEMENT (filter), filter->srcpad);
 
   filter->frames = g_queue_new ();
+  filter->slices = g_new0 (FieldAnalysisSlice,
+      GST_BASE_VIDEO_SLICES_MAX_THREADS);
+  filter->slice_pool =
+      gst_base_video_slices_new (gst_field_analysis_slice_func, filter);
   gst_field_analysis_reset (filter);
   filter->same_field = &same_parity_ssd;
   filter->field_thresh = DEFAULT_FIELD_THRESH;
@@ -372,6 +380,7 @@ gst_field_analysis_init (GstFieldAnalysis * filter,
   filter->block_height = DEFAULT_BLOCK_HEIGHT;
   filter->block_thresh = DEFAULT_BLOCK_THRESH;
   filter->ignored_lines = DEFAULT_IGNORED_LINES;
+  filter->threads = DEFAULT_THREADS;
 }
 
 static void
@@ -437,17 +446,6 @@ gst_field_analysis_set_property (GObject * object, guint prop_id,
       break;
     case PROP_BLOCK_WIDTH:
       filter->block_width = g_value_get_uint64 (value);
-      if (filter->width) {
-        if (filter->block_scores) {
-          gsize nbytes = (filter->width / filter->block_width) * sizeof (guint);
-          filter->block_scores = g_realloc (filter->block_scores, nbytes);
-          memset (filter->block_scores, 0, nbytes);
-        } else {
-          filter->block_scores =
-              g_malloc0 ((filter->width / filter->block_width) *
-              sizeof (guint));
-        }
-      }
       break;
     case PROP_BLOCK_HEIGHT:
       filter->block_height = g_value_get_uint64 (value);
@@ -458,6 +456,11 @@ gst_field_analysis_set_property (GObject * object, guint prop_id,
     case PROP_IGNORED_LINES:
       filter->ignored_lines = g_value_get_uint64 (value);
       break;
+    case PROP_THREADS:
+      GST_OBJECT_LOCK (filter);
+      filter->threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (filter);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -532,6 +535,9 @@ gst_field_analysis_get_property (GObject * object, guint prop_id,
     case PROP_IGNORED_LINES:
       g_value_set_uint64 (value, filter->ignored_lines);
       break;
+    case PROP_THREADS:
+      g_value_set_uint (value, filter->threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -587,21 +593,6 @@ gst_field_analysis_update_format (GstFieldAnalysis * filter, GstCaps * caps)
   filter->sample_incr = sample_incr;
   filter->line_stride = line_stride;
 
-  /* update allocations for metric scores */
-  if (filter->comb_mask) {
-    filter->comb_mask = g_realloc (filter->comb_mask, width);
-  } else {
-    filter->comb_mask = g_malloc (width);
-  }
-  if (filter->block_scores) {
-    gsize nbytes = (width / filter->block_width) * sizeof (guint);
-    filter->block_scores = g_realloc (filter->block_scores, nbytes);
-    memset (filter->block_scores, 0, nbytes);
-  } else {
-    filter->block_scores =
-        g_malloc0 ((width / filter->block_width) * sizeof (guint));
-  }
-
   GST_OBJECT_UNLOCK (filter);
   return;
 }
@@ -822,23 +813,100 @@ gst_field_analysis_sink_event (GstPad * pad, GstEvent * event)
 }
 
 
-static gfloat
-same_parity_sad (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+/* slice threading
+ *
+ * all metrics are either sums over independent lines or maxima over
+ * independent rows of blocks, so the frame is cut into horizontal slices that
+ * are analysed in parallel and the partial results are reduced once every
+ * slice has completed. */
+static void
+gst_field_analysis_slice_func (gpointer data, gpointer user_data)
+{
+  FieldAnalysisSlice *slice = data;
+
+  slice->func (user_data, slice);
+}
+
+/* makes sure the slice has scratch space for the comb mask of one line and
+ * the scores of one row of blocks */
+static void
+gst_field_analysis_slice_ensure_scratch (GstFieldAnalysis * filter,
+    FieldAnalysisSlice * slice)
+{
+  gint n_blocks = filter->width / filter->block_width;
+
+  if (slice->comb_mask_size < filter->width) {
+    slice->comb_mask = g_realloc (slice->comb_mask, filter->width);
+    slice->comb_mask_size = filter->width;
+  }
+  if (slice->block_scores_size < n_blocks) {
+    slice->block_scores =
+        g_realloc (slice->block_scores, n_blocks * sizeof (guint));
+    slice->block_scores_size = n_blocks;
+  }
+}
+
+/* splits n_units lines (or rows of blocks) between the available threads,
+ * runs func on each slice and reduces the partial results into sum and max */
+static void
+gst_field_analysis_run_slices (GstFieldAnalysis * filter,
+    FieldAnalysisFields * fields,
+    void (*func) (GstFieldAnalysis *, FieldAnalysisSlice *), gint n_units,
+    guint64 * sum, guint64 * max)
+{
+  guint i, n_slices;
+
+  n_slices = gst_base_video_slices_prepare (filter->slice_pool,
+      filter->threads, n_units, MIN_SLICE_UNITS);
+
+  for (i = 0; i < n_slices; i++) {
+    FieldAnalysisSlice *slice = &filter->slices[i];
+
+    slice->filter = filter;
+    slice->fields = fields;
+    slice->func = func;
+    slice->start = ((gint64) n_units * i) / n_slices;
+    slice->end = ((gint64) n_units * (i + 1)) / n_slices;
+    slice->sum = 0;
+    slice->max = 0;
+  }
+
+  gst_base_video_slices_run (filter->slice_pool, filter->slices,
+      sizeof (FieldAnalysisSlice), n_slices);
+
+  /* reduction */
+  if (sum)
+    *sum = 0;
+  if (max)
+    *max = 0;
+  for (i = 0; i < n_slices; i++) {
+    if (sum)
+      *sum += filter->slices[i].sum;
+    if (max && filter->slices[i].max > *max)
+      *max = filter->slices[i].max;
+  }
+}
+
+static void
+same_parity_sad_slice (GstFieldAnalysis * filter, FieldAnalysisSlice * slice)
 {
   gint j;
-  gfloat sum;
+  guint64 sum;
   guint8 *f1j, *f2j;
+  FieldAnalysisFields *fields = slice->fields;
 
   const gint y_offset = filter->data_offset;
   const gint stride = filter->line_stride;
   const gint stridex2 = stride << 1;
   const guint32 noise_floor = filter->noise_floor;
 
-  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride;
-  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride;
+  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride
+      + slice->start * stridex2;
+  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride
+      + slice->start * stridex2;
 
-  sum = 0.0f;
-  for (j = 0; j < (filter->height >> 1); j++) {
+  sum = 0;
+  for (j = slice->start; j < slice->end; j++) {
     guint32 tempsum = 0;
     orc_same_parity_sad_planar_yuv (&tempsum, f1j, f2j, noise_floor,
         filter->width);
@@ -847,15 +915,27 @@ same_parity_sad (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
     f2j += stridex2;
   }
 
-  return sum / (0.5f * filter->width * filter->height);
+  slice->sum = sum;
 }
 
 static gfloat
-same_parity_ssd (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+same_parity_sad (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+{
+  guint64 sum;
+
+  gst_field_analysis_run_slices (filter, fields, same_parity_sad_slice,
+      filter->height >> 1, &sum, NULL);
+
+  return sum / (0.5f * filter->width * filter->height);
+}
+
+static void
+same_parity_ssd_slice (GstFieldAnalysis * filter, FieldAnalysisSlice * slice)
 {
   gint j;
-  gfloat sum;
+  guint64 sum;
   guint8 *f1j, *f2j;
+  FieldAnalysisFields *fields = slice->fields;
 
   const gint y_offset = filter->data_offset;
   const gint stride = filter->line_stride;
@@ -863,11 +943,13 @@ same_parity_ssd (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
   /* noise floor needs to be squared for SSD */
   const guint32 noise_floor = filter->noise_floor * filter->noise_floor;
 
-  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride;
-  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride;
+  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride
+      + slice->start * stridex2;
+  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride
+      + slice->start * stridex2;
 
-  sum = 0.0f;
-  for (j = 0; j < (filter->height >> 1); j++) {
+  sum = 0;
+  for (j = slice->start; j < slice->end; j++) {
     guint32 tempsum = 0;
     orc_same_parity_ssd_planar_yuv (&tempsum, f1j, f2j, noise_floor,
         filter->width);
@@ -876,17 +958,29 @@ same_parity_ssd (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
     f2j += stridex2;
   }
 
+  slice->sum = sum;
+}
+
+static gfloat
+same_parity_ssd (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+{
+  guint64 sum;
+
+  gst_field_analysis_run_slices (filter, fields, same_parity_ssd_slice,
+      filter->height >> 1, &sum, NULL);
+
   return sum / (0.5f * filter->width * filter->height); /* field is half height */
 }
 
 /* horizontal [1,4,1] diff between fields - is this a good idea or should the
  * current sample be emphasised more or less? */
-static gfloat
-same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+static void
+same_parity_3_tap_slice (GstFieldAnalysis * filter, FieldAnalysisSlice * slice)
 {
   gint i, j;
-  gfloat sum;
+  guint64 sum;
   guint8 *f1j, *f2j;
+  FieldAnalysisFields *fields = slice->fields;
 
   const gint y_offset = filter->data_offset;
   const gint stride = filter->line_stride;
@@ -895,11 +989,13 @@ same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
   /* noise floor needs to be squared for [1,4,1] */
   const guint32 noise_floor = filter->noise_floor * 6;
 
-  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride;
-  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride;
+  f1j = GST_BUFFER_DATA (fields[0].buf) + y_offset + fields[0].parity * stride
+      + slice->start * stridex2;
+  f2j = GST_BUFFER_DATA (fields[1].buf) + y_offset + fields[1].parity * stride
+      + slice->start * stridex2;
 
-  sum = 0.0f;
-  for (j = 0; j < (filter->height >> 1); j++) {
+  sum = 0;
+  for (j = slice->start; j < slice->end; j++) {
     guint32 tempsum = 0;
     guint32 diff;
 
@@ -925,89 +1021,249 @@ same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
     f2j += stridex2;
   }
 
+  slice->sum = sum;
+}
+
+static gfloat
+same_parity_3_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+{
+  guint64 sum;
+
+  gst_field_analysis_run_slices (filter, fields, same_parity_3_tap_slice,
+      filter->height >> 1, &sum, NULL);
+
   return sum / ((6.0f / 2.0f) * filter->width * filter->height);        /* 1 + 4 + 1 = 6; field is half height */
 }
 
 /* vertical [1,-3,4,-3,1] - same as is used in FieldDiff from TIVTC,
  * tritical's AVISynth IVTC filter */
 /* 0th field's parity defines operation */
-static gfloat
-opposite_parity_5_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+static void
+opposite_parity_5_tap_slice (GstFieldAnalysis * filter,
+    FieldAnalysisSlice * slice)
 {
   gint j;
-  gfloat sum;
-  guint8 *fjm2, *fjm1, *fj, *fjp1, *fjp2;
-  guint32 tempsum;
+  guint64 sum;
+  guint8 *top, *bottom;
+  FieldAnalysisFields *fields = slice->fields;
 
   const gint y_offset = filter->data_offset;
   const gint stride = filter->line_stride;
   const gint stridex2 = stride << 1;
+  const gint last = (filter->height >> 1) - 1;
   /* noise floor needs to be *6 for [1,-3,4,-3,1] */
   const guint32 noise_floor = filter->noise_floor * 6;
 
-  sum = 0.0f;
-
-  /* fj is line j of the combined frame made from the top field even lines of
-   *   field 0 and the bottom field odd lines from field 1
-   * fjp1 is one line down from fj
-   * fjm2 is two lines up from fj
-   * fj with j == 0 is the 0th line of the top field
-   * fj with j == 1 is the 0th line of the bottom field or the 1st field of
-   *   the frame*/
-
-  /* unroll first line as it is a special case */
+  /* line j of the combined frame made from the top field even lines of
+   *   field 0 and the bottom field odd lines from field 1 is found at
+   *   top + j * stridex2 and the line after it at bottom + j * stridex2
+   * the first and last lines of the field mirror the missing lines */
   if (fields[0].parity == TOP_FIELD) {
-    fj = GST_BUFFER_DATA (fields[0].buf) + y_offset;
-    fjp1 = GST_BUFFER_DATA (fields[1].buf) + y_offset + stride;
+    top = GST_BUFFER_DATA (fields[0].buf) + y_offset;
+    bottom = GST_BUFFER_DATA (fields[1].buf) + y_offset + stride;
   } else {
-    fj = GST_BUFFER_DATA (fields[1].buf) + y_offset;
-    fjp1 = GST_BUFFER_DATA (fields[0].buf) + y_offset + stride;
+    top = GST_BUFFER_DATA (fields[1].buf) + y_offset;
+    bottom = GST_BUFFER_DATA (fields[0].buf) + y_offset + stride;
   }
-  fjp2 = fj + stridex2;
 
-  tempsum = 0;
-  orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjp2, fjp1, fj, fjp1, fjp2,
-      noise_floor, filter->width);
-  sum += tempsum;
-
-  for (j = 1; j < (filter->height >> 1) - 1; j++) {
-    /* shift everything down a line in the field of interest (means += stridex2) */
-    fjm2 = fj;
-    fjm1 = fjp1;
-    fj = fjp2;
-    fjp1 += stridex2;
-    fjp2 += stridex2;
-
-    tempsum = 0;
-    orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjm2, fjm1, fj, fjp1, fjp2,
-        noise_floor, filter->width);
+  sum = 0;
+  for (j = slice->start; j < slice->end; j++) {
+    guint8 *fjm2, *fjm1, *fj, *fjp1, *fjp2;
+    guint32 tempsum = 0;
+
+    fj = top + j * stridex2;
+    if (j == 0) {
+      fjp1 = bottom;
+      fjp2 = fj + stridex2;
+      fjm1 = fjp1;
+      fjm2 = fjp2;
+    } else if (j == last) {
+      fjm2 = fj - stridex2;
+      fjm1 = bottom + (j - 1) * stridex2;
+      fjp1 = fjm1;
+      fjp2 = fjm2;
+    } else {
+      fjm2 = fj - stridex2;
+      fjm1 = bottom + (j - 1) * stridex2;
+      fjp1 = bottom + j * stridex2;
+      fjp2 = fj + stridex2;
+    }
+
+    orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjm2, fjm1, fj, fjp1,
+        fjp2, noise_floor, filter->width);
     sum += tempsum;
   }
 
-  /* unroll the last line as it is a special case */
-  /* shift everything down a line in the field of interest (means += stridex2) */
-  fjm2 = fj;
-  fjm1 = fjp1;
-  fj = fjp2;
+  slice->sum = sum;
+}
+
+static gfloat
+opposite_parity_5_tap (GstFieldAnalysis * filter, FieldAnalysisFields * fields)
+{
+  guint64 sum;
 
-  tempsum = 0;
-  orc_opposite_parity_5_tap_planar_yuv (&tempsum, fjm2, fjm1, fj, fjm1, fjm2,
-      noise_floor, filter->width);
-  sum += tempsum;
+  gst_field_analysis_run_slices (filter, fields, opposite_parity_5_tap_slice,
+      filter->height >> 1, &sum, NULL);
 
   return sum / ((6.0f / 2.0f) * filter->width * filter->height);        /* 1 + 4 + 1 == 3 + 3 == 6; field is half height */
 }
 
+/* the orc comb mask kernels compare 16-bit values so the thresholds are
+ * clamped, which makes no difference as the filter results are far smaller */
+#define SPATIAL_THRESH_16(t) ((gint) MIN ((t), G_MAXINT16))
+
+/* the comb mask functions below are the C versions of the orc_comb_mask_*
+ * kernels for formats where samples are not contiguous */
+static void
+comb_mask_32detect (guint8 * comb_mask, const guint8 * fjm2,
+    const guint8 * fjm1, const guint8 * fj, const guint8 * fjp1, gint incr,
+    gint width, gint64 spatial_thresh)
+{
+  gint i;
+
+  for (i = 0; i < width; i++) {
+    const gint idx = i * incr;
+    gint diff1, diff2;
+
+    diff1 = fj[idx] - fjm1[idx];
+    diff2 = fj[idx] - fjp1[idx];
+    /* change in the same direction */
+    if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
+        || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
+      comb_mask[i] = abs (fj[idx] - fjm2[idx]) < 10
+          && abs (fj[idx] - fjm1[idx]) > 15;
+    } else {
+      comb_mask[i] = FALSE;
+    }
+  }
+}
+
+static void
+comb_mask_iscombed (guint8 * comb_mask, const guint8 * fjm1,
+    const guint8 * fj, const guint8 * fjp1, gint incr, gint width,
+    gint64 spatial_thresh)
+{
+  gint i;
+  const gint64 spatial_thresh_squared = spatial_thresh * spatial_thresh;
+
+  for (i = 0; i < width; i++) {
+    const gint idx = i * incr;
+    gint diff1, diff2;
+
+    diff1 = fj[idx] - fjm1[idx];
+    diff2 = fj[idx] - fjp1[idx];
+    /* change in the same direction */
+    if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
+        || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
+      comb_mask[i] =
+          (fjm1[idx] - fj[idx]) * (fjp1[idx] - fj[idx]) >
+          spatial_thresh_squared;
+    } else {
+      comb_mask[i] = FALSE;
+    }
+  }
+}
+
+static void
+comb_mask_5_tap (guint8 * comb_mask, const guint8 * fjm2, const guint8 * fjm1,
+    const guint8 * fj, const guint8 * fjp1, const guint8 * fjp2, gint incr,
+    gint width, gint64 spatial_thresh)
+{
+  gint i;
+  const gint64 spatial_threshx6 = 6 * spatial_thresh;
+
+  for (i = 0; i < width; i++) {
+    const gint idx = i * incr;
+    gint diff1, diff2;
+
+    diff1 = fj[idx] - fjm1[idx];
+    diff2 = fj[idx] - fjp1[idx];
+    /* change in the same direction */
+    if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
+        || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
+      comb_mask[i] =
+          abs (fjm2[idx] + (fj[idx] << 2) + fjp2[idx] - 3 * (fjm1[idx] +
+              fjp1[idx])) > spatial_threshx6;
+
+      /* motion detection that needs previous and next frames
+         this isn't really necessary, but acts as an optimisation if the
+         additional delay isn't a problem
+         if (motion_detection) {
+         if (abs(fpj[idx] - fj[idx]               ) > motion_thresh &&
+         abs(           fjm1[idx] - fnjm1[idx]) > motion_thresh &&
+         abs(           fjp1[idx] - fnjp1[idx]) > motion_thresh)
+         motion++;
+         if (abs(             fj[idx]   - fnj[idx]) > motion_thresh &&
+         abs(fpjm1[idx] - fjm1[idx]           ) > motion_thresh &&
+         abs(fpjp1[idx] - fjp1[idx]           ) > motion_thresh)
+         motion++;
+         } else {
+         motion = 1;
+         }
+       */
+    } else {
+      comb_mask[i] = FALSE;
+    }
+  }
+}
+
+/* a sample adds to the score of its block if it and the samples to its left
+ * and right are combed. at the edges of the line only the one neighbour is
+ * considered */
+static void
+block_scores_add_line (guint * block_scores, const guint8 * comb_mask,
+    gint width, guint64 block_width)
+{
+  guint64 b;
+
+  if (width < 2)
+    return;
+
+  /* left edge */
+  if (comb_mask[0] && comb_mask[1])
+    block_scores[0]++;
+
+  for (b = 0; b < width / block_width; b++) {
+    gint start = MAX (b * block_width, 1);
+    gint end = MIN ((b + 1) * block_width, width - 1);
+    gint score = 0;
+
+    if (end <= start)
+      continue;
+
+    orc_comb_block_score_planar_yuv (&score, comb_mask + start - 1,
+        comb_mask + start, comb_mask + start + 1, end - start);
+    block_scores[b] += score;
+  }
+
+  /* right edge */
+  if (comb_mask[width - 2] && comb_mask[width - 1])
+    block_scores[(width - 1) / block_width]++;
+}
+
+static guint64
+block_scores_max (const guint * block_scores, gint n_blocks)
+{
+  gint i;
+  guint64 block_score = 0;
+
+  for (i = 0; i < n_blocks; i++) {
+    if (block_scores[i] > block_score)
+      block_score = block_scores[i];
+  }
+
+  return block_score;
+}
+
 /* this metric was sourced from HandBrake but originally from transcode
  * the return value is the highest block score for the row of blocks */
-static inline guint64
-block_score_for_row_32detect (GstFieldAnalysis * filter, guint8 * base_fj,
-    guint8 * base_fjp1)
+static guint64
+block_score_for_row_32detect (GstFieldAnalysis * filter,
+    FieldAnalysisSlice * slice, guint8 * base_fj, guint8 * base_fjp1)
 {
-  guint64 i, j;
-  guint8 *comb_mask = filter->comb_mask;
-  guint *block_scores = filter->block_scores;
-  guint64 block_score;
+  guint64 j;
+  guint8 *comb_mask = slice->comb_mask;
+  guint *block_scores = slice->block_scores;
   guint8 *fjm2, *fjm1, *fj, *fjp1;
   const gint incr = filter->sample_incr;
   const gint stridex2 = filter->line_stride << 1;
@@ -1021,48 +1277,18 @@ block_score_for_row_32detect (GstFieldAnalysis * filter, guint8 * base_fj,
   fj = base_fj;
   fjp1 = base_fjp1;
 
-  for (j = 0; j < block_height; j++) {
-    /* we have to work one result ahead of ourselves which results in some small
-     * peculiarities below */
-    gint diff1, diff2;
+  memset (block_scores, 0, (width / block_width) * sizeof (guint));
 
-    diff1 = fj[0] - fjm1[0];
-    diff2 = fj[0] - fjp1[0];
-    /* change in the same direction */
-    if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-        || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-      comb_mask[0] = abs (fj[0] - fjm2[0]) < 10 && abs (fj[0] - fjm1[0]) > 15;
+  for (j = 0; j < block_height; j++) {
+    if (incr == 1) {
+      orc_comb_mask_32detect_planar_yuv (comb_mask, fjm2, fjm1, fj, fjp1,
+          SPATIAL_THRESH_16 (spatial_thresh), width);
     } else {
-      comb_mask[0] = FALSE;
+      comb_mask_32detect (comb_mask, fjm2, fjm1, fj, fjp1, incr, width,
+          spatial_thresh);
     }
+    block_scores_add_line (block_scores, comb_mask, width, block_width);
 
-    for (i = 1; i < width; i++) {
-      const guint64 idx = i * incr;
-      const guint64 res_idx = (i - 1) / block_width;
-
-      diff1 = fj[idx] - fjm1[idx];
-      diff2 = fj[idx] - fjp1[idx];
-      if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-          || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-        comb_mask[i] = abs (fj[idx] - fjm2[idx]) < 10
-            && abs (fj[idx] - fjm1[idx]) > 15;
-      } else {
-        comb_mask[i] = FALSE;
-      }
-
-      if (i == 1 && comb_mask[i - 1] && comb_mask[i]) {
-        /* left edge */
-        block_scores[res_idx]++;
-      } else if (i == width - 1) {
-        /* right edge */
-        if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i])
-          block_scores[res_idx]++;
-        if (comb_mask[i - 1] && comb_mask[i])
-          block_scores[i / block_width]++;
-      } else if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i]) {
-        block_scores[res_idx]++;
-      }
-    }
     /* advance down a line */
     fjm2 = fjm1;
     fjm1 = fj;
@@ -1070,120 +1296,70 @@ block_score_for_row_32detect (GstFieldAnalysis * filter, guint8 * base_fj,
     fjp1 = fjm1 + stridex2;
   }
 
-  block_score = 0;
-  for (i = 0; i < width / block_width; i++) {
-    if (block_scores[i] > block_score)
-      block_score = block_scores[i];
-  }
-
-  g_free (block_scores);
-  g_free (comb_mask);
-  return block_score;
+  return block_scores_max (block_scores, width / block_width);
 }
 
 /* this metric was sourced from HandBrake but originally from
  * tritical's isCombedT Avisynth function
  * the return value is the highest block score for the row of blocks */
-static inline guint64
-block_score_for_row_iscombed (GstFieldAnalysis * filter, guint8 * base_fj,
-    guint8 * base_fjp1)
+static guint64
+block_score_for_row_iscombed (GstFieldAnalysis * filter,
+    FieldAnalysisSlice * slice, guint8 * base_fj, guint8 * base_fjp1)
 {
-  guint64 i, j;
-  guint8 *comb_mask = filter->comb_mask;
-  guint *block_scores = filter->block_scores;
-  guint64 block_score;
+  guint64 j;
+  guint8 *comb_mask = slice->comb_mask;
+  guint *block_scores = slice->block_scores;
   guint8 *fjm1, *fj, *fjp1;
   const gint incr = filter->sample_incr;
   const gint stridex2 = filter->line_stride << 1;
   const guint64 block_width = filter->block_width;
   const guint64 block_height = filter->block_height;
   const gint64 spatial_thresh = filter->spatial_thresh;
-  const gint64 spatial_thresh_squared = spatial_thresh * spatial_thresh;
   const gint width = filter->width - (filter->width % block_width);
 
   fjm1 = base_fjp1 - stridex2;
   fj = base_fj;
   fjp1 = base_fjp1;
 
+  memset (block_scores, 0, (width / block_width) * sizeof (guint));
+
   for (j = 0; j < block_height; j++) {
-    /* we have to work one result ahead of ourselves which results in some small
-     * peculiarities below */
-    gint diff1, diff2;
+    if (incr == 1) {
+      const gint st = SPATIAL_THRESH_16 (spatial_thresh);
 
-    diff1 = fj[0] - fjm1[0];
-    diff2 = fj[0] - fjp1[0];
-    /* change in the same direction */
-    if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-        || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-      comb_mask[0] =
-          (fjm1[0] - fj[0]) * (fjp1[0] - fj[0]) > spatial_thresh_squared;
+      orc_comb_mask_iscombed_planar_yuv (comb_mask, fjm1, fj, fjp1, st,
+          st * st, width);
     } else {
-      comb_mask[0] = FALSE;
+      comb_mask_iscombed (comb_mask, fjm1, fj, fjp1, incr, width,
+          spatial_thresh);
     }
+    block_scores_add_line (block_scores, comb_mask, width, block_width);
 
-    for (i = 1; i < width; i++) {
-      const guint64 idx = i * incr;
-      const guint64 res_idx = (i - 1) / block_width;
-
-      diff1 = fj[idx] - fjm1[idx];
-      diff2 = fj[idx] - fjp1[idx];
-      if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-          || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-        comb_mask[i] =
-            (fjm1[idx] - fj[idx]) * (fjp1[idx] - fj[idx]) >
-            spatial_thresh_squared;
-      } else {
-        comb_mask[i] = FALSE;
-      }
-
-      if (i == 1 && comb_mask[i - 1] && comb_mask[i]) {
-        /* left edge */
-        block_scores[res_idx]++;
-      } else if (i == width - 1) {
-        /* right edge */
-        if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i])
-          block_scores[res_idx]++;
-        if (comb_mask[i - 1] && comb_mask[i])
-          block_scores[i / block_width]++;
-      } else if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i]) {
-        block_scores[res_idx]++;
-      }
-    }
     /* advance down a line */
     fjm1 = fj;
     fj = fjp1;
     fjp1 = fjm1 + stridex2;
   }
 
-  block_score = 0;
-  for (i = 0; i < width / block_width; i++) {
-    if (block_scores[i] > block_score)
-      block_score = block_scores[i];
-  }
-
-  g_free (block_scores);
-  g_free (comb_mask);
-  return block_score;
+  return block_scores_max (block_scores, width / block_width);
 }
 
 /* this metric was sourced from HandBrake but originally from
  * tritical's isCombedT Avisynth function
  * the return value is the highest block score for the row of blocks */
-static inline guint64
-block_score_for_row_5_tap (GstFieldAnalysis * filter, guint8 * base_fj,
-    guint8 * base_fjp1)
+static guint64
+block_score_for_row_5_tap (GstFieldAnalysis * filter,
+    FieldAnalysisSlice * slice, guint8 * base_fj, guint8 * base_fjp1)
 {
-  guint64 i, j;
-  guint8 *comb_mask = filter->comb_mask;
-  guint *block_scores = filter->block_scores;
-  guint64 block_score;
+  guint64 j;
+  guint8 *comb_mask = slice->comb_mask;
+  guint *block_scores = slice->block_scores;
   guint8 *fjm2, *fjm1, *fj, *fjp1, *fjp2;
   const gint incr = filter->sample_incr;
   const gint stridex2 = filter->line_stride << 1;
   const guint64 block_width = filter->block_width;
   const guint64 block_height = filter->block_height;
   const gint64 spatial_thresh = filter->spatial_thresh;
-  const gint64 spatial_threshx6 = 6 * spatial_thresh;
   const gint width = filter->width - (filter->width % block_width);
 
   fjm2 = base_fj - stridex2;
@@ -1192,68 +1368,20 @@ block_score_for_row_5_tap (GstFieldAnalysis * filter, guint8 * base_fj,
   fjp1 = base_fjp1;
   fjp2 = fj + stridex2;
 
-  for (j = 0; j < block_height; j++) {
-    /* we have to work one result ahead of ourselves which results in some small
-     * peculiarities below */
-    gint diff1, diff2;
+  memset (block_scores, 0, (width / block_width) * sizeof (guint));
 
-    diff1 = fj[0] - fjm1[0];
-    diff2 = fj[0] - fjp1[0];
-    /* change in the same direction */
-    if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-        || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-      comb_mask[0] =
-          abs (fjm2[0] + (fj[0] << 2) + fjp2[0] - 3 * (fjm1[0] + fjp1[0])) >
-          spatial_threshx6;
+  for (j = 0; j < block_height; j++) {
+    if (incr == 1) {
+      const gint st = SPATIAL_THRESH_16 (spatial_thresh);
 
-      /* motion detection that needs previous and next frames
-         this isn't really necessary, but acts as an optimisation if the
-         additional delay isn't a problem
-         if (motion_detection) {
-         if (abs(fpj[idx] - fj[idx]               ) > motion_thresh &&
-         abs(           fjm1[idx] - fnjm1[idx]) > motion_thresh &&
-         abs(           fjp1[idx] - fnjp1[idx]) > motion_thresh)
-         motion++;
-         if (abs(             fj[idx]   - fnj[idx]) > motion_thresh &&
-         abs(fpjm1[idx] - fjm1[idx]           ) > motion_thresh &&
-         abs(fpjp1[idx] - fjp1[idx]           ) > motion_thresh)
-         motion++;
-         } else {
-         motion = 1;
-         }
-       */
+      orc_comb_mask_5_tap_planar_yuv (comb_mask, fjm2, fjm1, fj, fjp1, fjp2,
+          st, MIN (6 * st, G_MAXINT16), width);
     } else {
-      comb_mask[0] = FALSE;
+      comb_mask_5_tap (comb_mask, fjm2, fjm1, fj, fjp1, fjp2, incr, width,
+          spatial_thresh);
     }
+    block_scores_add_line (block_scores, comb_mask, width, block_width);
 
-    for (i = 1; i < width; i++) {
-      const guint64 idx = i * incr;
-      const guint64 res_idx = (i - 1) / block_width;
-
-      diff1 = fj[idx] - fjm1[idx];
-      diff2 = fj[idx] - fjp1[idx];
-      if ((diff1 > spatial_thresh && diff2 > spatial_thresh)
-          || (diff1 < -spatial_thresh && diff2 < -spatial_thresh)) {
-        comb_mask[i] =
-            abs (fjm2[idx] + (fj[idx] << 2) + fjp2[idx] - 3 * (fjm1[idx] +
-                fjp1[idx])) > spatial_threshx6;
-      } else {
-        comb_mask[i] = FALSE;
-      }
-
-      if (i == 1 && comb_mask[i - 1] && comb_mask[i]) {
-        /* left edge */
-        block_scores[res_idx]++;
-      } else if (i == width - 1) {
-        /* right edge */
-        if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i])
-          block_scores[res_idx]++;
-        if (comb_mask[i - 1] && comb_mask[i])
-          block_scores[i / block_width]++;
-      } else if (comb_mask[i - 2] && comb_mask[i - 1] && comb_mask[i]) {
-        block_scores[res_idx]++;
-      }
-    }
     /* advance down a line */
     fjm2 = fjm1;
     fjm1 = fj;
@@ -1262,15 +1390,50 @@ block_score_for_row_5_tap (GstFieldAnalysis * filter, guint8 * base_fj,
     fjp2 = fj + stridex2;
   }
 
-  block_score = 0;
-  for (i = 0; i < width / block_width; i++) {
-    if (block_scores[i] > block_score)
-      block_score = block_scores[i];
+  return block_scores_max (block_scores, width / block_width);
+}
+
+static void
+opposite_parity_windowed_comb_slice (GstFieldAnalysis * filter,
+    FieldAnalysisSlice * slice)
+{
+  gint j;
+  guint64 max;
+  guint8 *base_fj, *base_fjp1;
+  FieldAnalysisFields *fields = slice->fields;
+
+  const gint y_offset = filter->data_offset;
+  const gint stride = filter->line_stride;
+  const guint64 block_thresh = filter->block_thresh;
+  const guint64 block_height = filter->block_height;
+
+  if (fields[0].parity == TOP_FIELD) {
+    base_fj = GST_BUFFER_DATA (fields[0].buf) + y_offset;
+    base_fjp1 = GST_BUFFER_DATA (fields[1].buf) + y_offset + stride;
+  } else {
+    base_fj = GST_BUFFER_DATA (fields[1].buf) + y_offset;
+    base_fjp1 = GST_BUFFER_DATA (fields[0].buf) + y_offset + stride;
   }
 
-  g_free (block_scores);
-  g_free (comb_mask);
-  return block_score;
+  gst_field_analysis_slice_ensure_scratch (filter, slice);
+
+  /* we operate on a row of blocks of height block_height through each
+   * iteration */
+  max = 0;
+  for (j = slice->start; j < slice->end; j++) {
+    guint64 line_offset = (filter->ignored_lines + j * block_height) * stride;
+    guint64 block_score =
+        filter->block_score_for_row (filter, slice, base_fj + line_offset,
+        base_fjp1 + line_offset);
+
+    if (block_score > max)
+      max = block_score;
+    /* a combed block decides the outcome for the whole frame */
+    if (block_score > block_thresh)
+      break;
+  }
+
+  slice->max = max;
 }
 
 /* a pass is made over the field using one of three comb-detection metrics
@@ -1280,56 +1443,41 @@ block_score_for_row_5_tap (GstFieldAnalysis * filter, guint8 * base_fj,
    score is between half the threshold and the threshold, the block is
    slightly combed. if when analysis is complete, slight combing is detected
    that is returned. if any results are observed that are above the threshold,
-   the function returns immediately */
+   the analysis of the slice stops immediately */
 /* 0th field's parity defines operation */
 static gfloat
 opposite_parity_windowed_comb (GstFieldAnalysis * filter,
     FieldAnalysisFields * fields)
 {
-  gint j;
-  gboolean slightly_combed;
+  gint n_rows;
+  guint64 block_score;
 
-  const gint y_offset = filter->data_offset;
-  const gint stride = filter->line_stride;
   const guint64 block_thresh = filter->block_thresh;
   const guint64 block_height = filter->block_height;
-  guint8 *base_fj, *base_fjp1;
 
-  if (fields[0].parity == TOP_FIELD) {
-    base_fj = GST_BUFFER_DATA (fields[0].buf) + y_offset;
-    base_fjp1 = GST_BUFFER_DATA (fields[1].buf) + y_offset + stride;
-  } else {
-    base_fj = GST_BUFFER_DATA (fields[1].buf) + y_offset;
-    base_fjp1 = GST_BUFFER_DATA (fields[0].buf) + y_offset + stride;
-  }
+  if (filter->height < filter->ignored_lines + block_height)
+    return 0.0f;
 
-  /* we operate on a row of blocks of height block_height through each iteration */
-  slightly_combed = FALSE;
-  for (j = 0; j <= filter->height - filter->ignored_lines - block_height;
-      j += block_height) {
-    guint64 line_offset = (filter->ignored_lines + j) * stride;
-    guint block_score =
-        filter->block_score_for_row (filter, base_fj + line_offset,
-        base_fjp1 + line_offset);
+  n_rows = (filter->height - filter->ignored_lines - block_height)
+      / block_height + 1;
 
-    if (block_score > (block_thresh >> 1)
-        && block_score <= block_thresh) {
-      /* blend if nothing more combed comes along */
-      slightly_combed = TRUE;
-    } else if (block_score > block_thresh) {
-      GstCaps *caps = GST_BUFFER_CAPS (fields[0].buf);
-      GstStructure *struc = gst_caps_get_structure (caps, 0);
-      gboolean interlaced;
-      if (gst_structure_get_boolean (struc, "interlaced", &interlaced)
-          && interlaced == TRUE) {
-        return 1.0f;            /* blend */
-      } else {
-        return 2.0f;            /* deinterlace */
-      }
+  gst_field_analysis_run_slices (filter, fields,
+      opposite_parity_windowed_comb_slice, n_rows, NULL, &block_score);
+
+  if (block_score > block_thresh) {
+    GstCaps *caps = GST_BUFFER_CAPS (fields[0].buf);
+    GstStructure *struc = gst_caps_get_structure (caps, 0);
+    gboolean interlaced;
+    if (gst_structure_get_boolean (struc, "interlaced", &interlaced)
+        && interlaced == TRUE) {
+      return 1.0f;              /* blend */
+    } else {
+      return 2.0f;              /* deinterlace */
     }
   }
 
-  return (gfloat) slightly_combed;      /* TRUE means blend, else don't */
+  /* slightly combed means blend if nothing more combed comes along */
+  return (gfloat) (block_score > (block_thresh >> 1));
 }
 
 /* this is where the magic happens
@@ -1781,9 +1929,16 @@ static void
 gst_field_analysis_finalize (GObject * object)
 {
   GstFieldAnalysis *filter = GST_FIELDANALYSIS (object);
+  guint i;
 
   gst_field_analysis_reset (filter);
   g_queue_free (filter->frames);
+  gst_base_video_slices_free (filter->slice_pool);
+  for (i = 0; i < GST_BASE_VIDEO_SLICES_MAX_THREADS; i++) {
+    g_free (filter->slices[i].comb_mask);
+    g_free (filter->slices[i].block_scores);
+  }
+  g_free (filter->slices);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
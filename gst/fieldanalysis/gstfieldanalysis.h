@@ -45,6 +45,7 @@
 #define __GST_FIELDANALYSIS_H__
 
 #include <gst/gst.h>
+#include <gst/video/gstbasevideoslices.h>
 
 G_BEGIN_DECLS
 #define GST_TYPE_FIELDANALYSIS \
@@ -62,6 +63,7 @@ typedef struct _GstFieldAnalysis GstFieldAnalysis;
 typedef struct _GstFieldAnalysisClass GstFieldAnalysisClass;
 typedef struct _FieldAnalysisFields FieldAnalysisFields;
 typedef struct _FieldAnalysis FieldAnalysis;
+typedef struct _FieldAnalysisSlice FieldAnalysisSlice;
 
 typedef enum
 {
@@ -94,6 +96,26 @@ struct _FieldAnalysis
   gboolean gap;
 };
 
+/* a horizontal band of the frame that is analysed by one thread; the partial
+ * results of all slices are reduced once every slice has completed */
+struct _FieldAnalysisSlice
+{
+  GstFieldAnalysis *filter;
+  FieldAnalysisFields *fields;
+  void (*func) (GstFieldAnalysis *, FieldAnalysisSlice *);
+  /* range of lines (or rows of blocks) covered by this slice */
+  gint start, end;
+
+  /* per-slice scratch space for the windowed comb detection */
+  guint8 *comb_mask;
+  guint *block_scores;
+  gint comb_mask_size, block_scores_size;
+
+  /* partial results */
+  guint64 sum;
+  guint64 max;
+};
+
 typedef enum
 {
   METHOD_32DETECT,
@@ -115,14 +137,17 @@ struct _GstFieldAnalysis
   FieldAnalysis results[2];
   gfloat (*same_field) (GstFieldAnalysis *, FieldAnalysisFields *);
   gfloat (*same_frame) (GstFieldAnalysis *, FieldAnalysisFields *);
-  guint64 (*block_score_for_row) (GstFieldAnalysis *, guint8 *, guint8 *);
+  guint64 (*block_score_for_row) (GstFieldAnalysis *, FieldAnalysisSlice *,
+      guint8 *, guint8 *);
   gboolean is_telecine;
   gboolean first_buffer; /* indicates the first buffer for which a buffer will be output
                           * after a discont or flushing seek */
-  guint8 *comb_mask;
-  guint *block_scores;
   gboolean flushing;     /* indicates whether we are flushing or not */
 
+  /* slice threading, one slice per thread at most */
+  FieldAnalysisSlice *slices;
+  GstBaseVideoSlices *slice_pool;
+
   /* properties */
   guint32 noise_floor; /* threshold for the result of a metric to be valid */
   gfloat field_thresh; /* threshold used for the same parity field metric */
@@ -131,6 +156,7 @@ struct _GstFieldAnalysis
   guint64 block_width, block_height; /* width/height of window used for comb clusted detection */
   guint64 block_thresh;
   guint64 ignored_lines;
+  guint threads; /* number of threads used for analysis, 0 is automatic */
 };
 
 struct _GstFieldAnalysisClass
@@ -82,6 +82,16 @@ void orc_same_parity_3_tap_planar_yuv (guint32 * a1, const orc_uint8 * s1,
 void orc_opposite_parity_5_tap_planar_yuv (guint32 * a1, const orc_uint8 * s1,
     const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4,
     const orc_uint8 * s5, int p2, int n);
+void orc_comb_mask_32detect_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4, int p1,
+    int n);
+void orc_comb_mask_iscombed_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, int p1, int p2, int n);
+void orc_comb_mask_5_tap_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4,
+    const orc_uint8 * s5, int p1, int p2, int n);
+void orc_comb_block_score_planar_yuv (int * a1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, int n);
 
 void gst_fieldanalysis_orc_init (void);
 
@@ -841,175 +851,1060 @@ orc_opposite_parity_5_tap_planar_yuv (guint32 * a1, const orc_uint8 * s1,
 #endif
 
 
+/* orc_comb_mask_32detect_planar_yuv */
+#ifdef DISABLE_ORC
 void
-gst_fieldanalysis_orc_init (void)
+orc_comb_mask_32detect_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4, int p1,
+    int n)
 {
-#ifndef DISABLE_ORC
-  {
-    /* orc_same_parity_sad_planar_yuv */
-    OrcProgram *p;
-    OrcCompileResult result;
-
-    p = orc_program_new ();
-    orc_program_set_name (p, "orc_same_parity_sad_planar_yuv");
-    orc_program_set_backup_function (p, _backup_orc_same_parity_sad_planar_yuv);
-    orc_program_add_source (p, 1, "s1");
-    orc_program_add_source (p, 1, "s2");
-    orc_program_add_accumulator (p, 4, "a1");
-    orc_program_add_parameter (p, 4, "p2");
-    orc_program_add_temporary (p, 2, "t1");
-    orc_program_add_temporary (p, 2, "t2");
-    orc_program_add_temporary (p, 4, "t3");
-    orc_program_add_temporary (p, 4, "t4");
-
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T4, ORC_VAR_T3, ORC_VAR_P2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "andl", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_T4,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T3, ORC_VAR_D1,
-        ORC_VAR_D1);
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  orc_int8 var39;
+  orc_union16 var40;
+  orc_int8 var41;
+  orc_union16 var42;
+  orc_int8 var43;
+  orc_union16 var44;
+  orc_int8 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_int8 var68;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+  ptr7 = (orc_int8 *) s4;
 
-    result = orc_program_compile (p);
+  /* 11: loadpw */
+  var50.i = p1;
+  /* 19: loadpw */
+  var58.i = 0x0000000f;         /* 15 */
+  /* 24: loadpw */
+  var63.i = 0x00000009;         /* 9 */
+  /* 27: loadpw */
+  var66.i = 0x00000001;         /* 1 */
 
-    _orc_program_orc_same_parity_sad_planar_yuv = p;
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var39 = ptr4[i];
+    /* 1: convubw */
+    var40.i = (orc_uint8) var39;
+    /* 2: loadb */
+    var41 = ptr5[i];
+    /* 3: convubw */
+    var42.i = (orc_uint8) var41;
+    /* 4: loadb */
+    var43 = ptr6[i];
+    /* 5: convubw */
+    var44.i = (orc_uint8) var43;
+    /* 6: loadb */
+    var45 = ptr7[i];
+    /* 7: convubw */
+    var46.i = (orc_uint8) var45;
+    /* 8: subw */
+    var47.i = var44.i - var42.i;
+    /* 9: subw */
+    var48.i = var44.i - var46.i;
+    /* 10: minsw */
+    var49.i = ORC_MIN (var47.i, var48.i);
+    /* 12: cmpgtsw */
+    var51.i = (var49.i > var50.i) ? (~0) : 0;
+    /* 13: subw */
+    var52.i = var42.i - var44.i;
+    /* 14: subw */
+    var53.i = var46.i - var44.i;
+    /* 15: minsw */
+    var54.i = ORC_MIN (var52.i, var53.i);
+    /* 16: cmpgtsw */
+    var55.i = (var54.i > var50.i) ? (~0) : 0;
+    /* 17: orw */
+    var56.i = var51.i | var55.i;
+    /* 18: absw */
+    var57.i = ORC_ABS (var47.i);
+    /* 20: cmpgtsw */
+    var59.i = (var57.i > var58.i) ? (~0) : 0;
+    /* 21: andw */
+    var60.i = var56.i & var59.i;
+    /* 22: subw */
+    var61.i = var44.i - var40.i;
+    /* 23: absw */
+    var62.i = ORC_ABS (var61.i);
+    /* 25: cmpgtsw */
+    var64.i = (var62.i > var63.i) ? (~0) : 0;
+    /* 26: andnw */
+    var65.i = (~var64.i) & var60.i;
+    /* 28: andw */
+    var67.i = var65.i & var66.i;
+    /* 29: convwb */
+    var68 = var67.i;
+    /* 30: storeb */
+    ptr0[i] = var68;
   }
-  {
-    /* orc_same_parity_ssd_planar_yuv */
-    OrcProgram *p;
-    OrcCompileResult result;
 
-    p = orc_program_new ();
-    orc_program_set_name (p, "orc_same_parity_ssd_planar_yuv");
-    orc_program_set_backup_function (p, _backup_orc_same_parity_ssd_planar_yuv);
-    orc_program_add_source (p, 1, "s1");
-    orc_program_add_source (p, 1, "s2");
-    orc_program_add_accumulator (p, 4, "a1");
-    orc_program_add_parameter (p, 4, "p2");
-    orc_program_add_temporary (p, 2, "t1");
-    orc_program_add_temporary (p, 2, "t2");
-    orc_program_add_temporary (p, 4, "t3");
-    orc_program_add_temporary (p, 4, "t4");
+}
 
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "mulswl", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_T1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T4, ORC_VAR_T3, ORC_VAR_P2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "andl", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_T4,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T3, ORC_VAR_D1,
-        ORC_VAR_D1);
+#else
+static void
+_backup_orc_comb_mask_32detect_planar_yuv (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  orc_int8 var39;
+  orc_union16 var40;
+  orc_int8 var41;
+  orc_union16 var42;
+  orc_int8 var43;
+  orc_union16 var44;
+  orc_int8 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_int8 var68;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+  ptr7 = (orc_int8 *) ex->arrays[7];
 
-    result = orc_program_compile (p);
+  /* 11: loadpw */
+  var50.i = ex->params[24];
+  /* 19: loadpw */
+  var58.i = 0x0000000f;         /* 15 */
+  /* 24: loadpw */
+  var63.i = 0x00000009;         /* 9 */
+  /* 27: loadpw */
+  var66.i = 0x00000001;         /* 1 */
 
-    _orc_program_orc_same_parity_ssd_planar_yuv = p;
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var39 = ptr4[i];
+    /* 1: convubw */
+    var40.i = (orc_uint8) var39;
+    /* 2: loadb */
+    var41 = ptr5[i];
+    /* 3: convubw */
+    var42.i = (orc_uint8) var41;
+    /* 4: loadb */
+    var43 = ptr6[i];
+    /* 5: convubw */
+    var44.i = (orc_uint8) var43;
+    /* 6: loadb */
+    var45 = ptr7[i];
+    /* 7: convubw */
+    var46.i = (orc_uint8) var45;
+    /* 8: subw */
+    var47.i = var44.i - var42.i;
+    /* 9: subw */
+    var48.i = var44.i - var46.i;
+    /* 10: minsw */
+    var49.i = ORC_MIN (var47.i, var48.i);
+    /* 12: cmpgtsw */
+    var51.i = (var49.i > var50.i) ? (~0) : 0;
+    /* 13: subw */
+    var52.i = var42.i - var44.i;
+    /* 14: subw */
+    var53.i = var46.i - var44.i;
+    /* 15: minsw */
+    var54.i = ORC_MIN (var52.i, var53.i);
+    /* 16: cmpgtsw */
+    var55.i = (var54.i > var50.i) ? (~0) : 0;
+    /* 17: orw */
+    var56.i = var51.i | var55.i;
+    /* 18: absw */
+    var57.i = ORC_ABS (var47.i);
+    /* 20: cmpgtsw */
+    var59.i = (var57.i > var58.i) ? (~0) : 0;
+    /* 21: andw */
+    var60.i = var56.i & var59.i;
+    /* 22: subw */
+    var61.i = var44.i - var40.i;
+    /* 23: absw */
+    var62.i = ORC_ABS (var61.i);
+    /* 25: cmpgtsw */
+    var64.i = (var62.i > var63.i) ? (~0) : 0;
+    /* 26: andnw */
+    var65.i = (~var64.i) & var60.i;
+    /* 28: andw */
+    var67.i = var65.i & var66.i;
+    /* 29: convwb */
+    var68 = var67.i;
+    /* 30: storeb */
+    ptr0[i] = var68;
   }
-  {
-    /* orc_same_parity_3_tap_planar_yuv */
-    OrcProgram *p;
-    OrcCompileResult result;
 
-    p = orc_program_new ();
-    orc_program_set_name (p, "orc_same_parity_3_tap_planar_yuv");
-    orc_program_set_backup_function (p,
-        _backup_orc_same_parity_3_tap_planar_yuv);
-    orc_program_add_source (p, 1, "s1");
-    orc_program_add_source (p, 1, "s2");
-    orc_program_add_source (p, 1, "s3");
-    orc_program_add_source (p, 1, "s4");
-    orc_program_add_source (p, 1, "s5");
-    orc_program_add_source (p, 1, "s6");
-    orc_program_add_accumulator (p, 4, "a1");
-    orc_program_add_constant (p, 4, 0x00000002, "c1");
-    orc_program_add_parameter (p, 4, "p2");
-    orc_program_add_temporary (p, 2, "t1");
-    orc_program_add_temporary (p, 2, "t2");
-    orc_program_add_temporary (p, 2, "t3");
-    orc_program_add_temporary (p, 2, "t4");
-    orc_program_add_temporary (p, 2, "t5");
-    orc_program_add_temporary (p, 2, "t6");
-    orc_program_add_temporary (p, 4, "t7");
-    orc_program_add_temporary (p, 4, "t8");
+}
 
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_S4, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T5, ORC_VAR_S5, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T6, ORC_VAR_S6, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_C1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_C1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T3,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "addw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T5,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "addw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T6,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T4,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T7, ORC_VAR_T1, ORC_VAR_D1,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T8, ORC_VAR_T7, ORC_VAR_P2,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "andl", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
-        ORC_VAR_D1);
-    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T7, ORC_VAR_D1,
-        ORC_VAR_D1);
+static OrcProgram *_orc_program_orc_comb_mask_32detect_planar_yuv;
+void
+orc_comb_mask_32detect_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4, int p1,
+    int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_orc_comb_mask_32detect_planar_yuv;
+  void (*func) (OrcExecutor *);
 
-    result = orc_program_compile (p);
+  ex->program = p;
 
-    _orc_program_orc_same_parity_3_tap_planar_yuv = p;
-  }
-  {
-    /* orc_opposite_parity_5_tap_planar_yuv */
-    OrcProgram *p;
-    OrcCompileResult result;
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->params[ORC_VAR_P1] = p1;
 
-    p = orc_program_new ();
-    orc_program_set_name (p, "orc_opposite_parity_5_tap_planar_yuv");
-    orc_program_set_backup_function (p,
-        _backup_orc_opposite_parity_5_tap_planar_yuv);
-    orc_program_add_source (p, 1, "s1");
-    orc_program_add_source (p, 1, "s2");
-    orc_program_add_source (p, 1, "s3");
-    orc_program_add_source (p, 1, "s4");
-    orc_program_add_source (p, 1, "s5");
-    orc_program_add_accumulator (p, 4, "a1");
-    orc_program_add_constant (p, 4, 0x00000002, "c1");
-    orc_program_add_constant (p, 4, 0x00000003, "c2");
-    orc_program_add_parameter (p, 4, "p2");
-    orc_program_add_temporary (p, 2, "t1");
-    orc_program_add_temporary (p, 2, "t2");
-    orc_program_add_temporary (p, 2, "t3");
-    orc_program_add_temporary (p, 2, "t4");
-    orc_program_add_temporary (p, 2, "t5");
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* orc_comb_mask_iscombed_planar_yuv */
+#ifdef DISABLE_ORC
+void
+orc_comb_mask_iscombed_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, int p1, int p2, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_int8 var39;
+  orc_union16 var40;
+  orc_int8 var41;
+  orc_union16 var42;
+  orc_int8 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union32 var55;
+  orc_union32 var56;
+  orc_union32 var57;
+  orc_union32 var58;
+  orc_union32 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_int8 var63;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+
+  /* 9: loadpw */
+  var48.i = p1;
+  /* 17: loadpl */
+  var56.i = p2;
+  /* 22: loadpw */
+  var61.i = 0x00000001;         /* 1 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var39 = ptr4[i];
+    /* 1: convubw */
+    var40.i = (orc_uint8) var39;
+    /* 2: loadb */
+    var41 = ptr5[i];
+    /* 3: convubw */
+    var42.i = (orc_uint8) var41;
+    /* 4: loadb */
+    var43 = ptr6[i];
+    /* 5: convubw */
+    var44.i = (orc_uint8) var43;
+    /* 6: subw */
+    var45.i = var42.i - var40.i;
+    /* 7: subw */
+    var46.i = var42.i - var44.i;
+    /* 8: minsw */
+    var47.i = ORC_MIN (var45.i, var46.i);
+    /* 10: cmpgtsw */
+    var49.i = (var47.i > var48.i) ? (~0) : 0;
+    /* 11: subw */
+    var50.i = var40.i - var42.i;
+    /* 12: subw */
+    var51.i = var44.i - var42.i;
+    /* 13: minsw */
+    var52.i = ORC_MIN (var50.i, var51.i);
+    /* 14: cmpgtsw */
+    var53.i = (var52.i > var48.i) ? (~0) : 0;
+    /* 15: orw */
+    var54.i = var49.i | var53.i;
+    /* 16: mulswl */
+    var55.i = var50.i * var51.i;
+    /* 18: cmpgtsl */
+    var57.i = (var55.i > var56.i) ? (~0) : 0;
+    /* 19: convswl */
+    var58.i = var54.i;
+    /* 20: andl */
+    var59.i = var57.i & var58.i;
+    /* 21: convlw */
+    var60.i = var59.i;
+    /* 23: andw */
+    var62.i = var60.i & var61.i;
+    /* 24: convwb */
+    var63 = var62.i;
+    /* 25: storeb */
+    ptr0[i] = var63;
+  }
+
+}
+
+#else
+static void
+_backup_orc_comb_mask_iscombed_planar_yuv (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_int8 var39;
+  orc_union16 var40;
+  orc_int8 var41;
+  orc_union16 var42;
+  orc_int8 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union32 var55;
+  orc_union32 var56;
+  orc_union32 var57;
+  orc_union32 var58;
+  orc_union32 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_int8 var63;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+
+  /* 9: loadpw */
+  var48.i = ex->params[24];
+  /* 17: loadpl */
+  var56.i = ex->params[25];
+  /* 22: loadpw */
+  var61.i = 0x00000001;         /* 1 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var39 = ptr4[i];
+    /* 1: convubw */
+    var40.i = (orc_uint8) var39;
+    /* 2: loadb */
+    var41 = ptr5[i];
+    /* 3: convubw */
+    var42.i = (orc_uint8) var41;
+    /* 4: loadb */
+    var43 = ptr6[i];
+    /* 5: convubw */
+    var44.i = (orc_uint8) var43;
+    /* 6: subw */
+    var45.i = var42.i - var40.i;
+    /* 7: subw */
+    var46.i = var42.i - var44.i;
+    /* 8: minsw */
+    var47.i = ORC_MIN (var45.i, var46.i);
+    /* 10: cmpgtsw */
+    var49.i = (var47.i > var48.i) ? (~0) : 0;
+    /* 11: subw */
+    var50.i = var40.i - var42.i;
+    /* 12: subw */
+    var51.i = var44.i - var42.i;
+    /* 13: minsw */
+    var52.i = ORC_MIN (var50.i, var51.i);
+    /* 14: cmpgtsw */
+    var53.i = (var52.i > var48.i) ? (~0) : 0;
+    /* 15: orw */
+    var54.i = var49.i | var53.i;
+    /* 16: mulswl */
+    var55.i = var50.i * var51.i;
+    /* 18: cmpgtsl */
+    var57.i = (var55.i > var56.i) ? (~0) : 0;
+    /* 19: convswl */
+    var58.i = var54.i;
+    /* 20: andl */
+    var59.i = var57.i & var58.i;
+    /* 21: convlw */
+    var60.i = var59.i;
+    /* 23: andw */
+    var62.i = var60.i & var61.i;
+    /* 24: convwb */
+    var63 = var62.i;
+    /* 25: storeb */
+    ptr0[i] = var63;
+  }
+
+}
+
+static OrcProgram *_orc_program_orc_comb_mask_iscombed_planar_yuv;
+void
+orc_comb_mask_iscombed_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, int p1, int p2, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_orc_comb_mask_iscombed_planar_yuv;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->params[ORC_VAR_P1] = p1;
+  ex->params[ORC_VAR_P2] = p2;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* orc_comb_mask_5_tap_planar_yuv */
+#ifdef DISABLE_ORC
+void
+orc_comb_mask_5_tap_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4,
+    const orc_uint8 * s5, int p1, int p2, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  const orc_int8 *ORC_RESTRICT ptr8;
+  orc_int8 var40;
+  orc_union16 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_int8 var46;
+  orc_union16 var47;
+  orc_int8 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_union16 var73;
+  orc_int8 var74;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+  ptr7 = (orc_int8 *) s4;
+  ptr8 = (orc_int8 *) s5;
+
+  /* 13: loadpw */
+  var53.i = p1;
+  /* 21: loadpw */
+  var61.i = 0x00000002;         /* 2 */
+  /* 25: loadpw */
+  var65.i = 0x00000003;         /* 3 */
+  /* 29: loadpw */
+  var69.i = p2;
+  /* 32: loadpw */
+  var72.i = 0x00000001;         /* 1 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var40 = ptr4[i];
+    /* 1: convubw */
+    var41.i = (orc_uint8) var40;
+    /* 2: loadb */
+    var42 = ptr5[i];
+    /* 3: convubw */
+    var43.i = (orc_uint8) var42;
+    /* 4: loadb */
+    var44 = ptr6[i];
+    /* 5: convubw */
+    var45.i = (orc_uint8) var44;
+    /* 6: loadb */
+    var46 = ptr7[i];
+    /* 7: convubw */
+    var47.i = (orc_uint8) var46;
+    /* 8: loadb */
+    var48 = ptr8[i];
+    /* 9: convubw */
+    var49.i = (orc_uint8) var48;
+    /* 10: subw */
+    var50.i = var45.i - var43.i;
+    /* 11: subw */
+    var51.i = var45.i - var47.i;
+    /* 12: minsw */
+    var52.i = ORC_MIN (var50.i, var51.i);
+    /* 14: cmpgtsw */
+    var54.i = (var52.i > var53.i) ? (~0) : 0;
+    /* 15: subw */
+    var55.i = var43.i - var45.i;
+    /* 16: subw */
+    var56.i = var47.i - var45.i;
+    /* 17: minsw */
+    var57.i = ORC_MIN (var55.i, var56.i);
+    /* 18: cmpgtsw */
+    var58.i = (var57.i > var53.i) ? (~0) : 0;
+    /* 19: orw */
+    var59.i = var54.i | var58.i;
+    /* 20: addw */
+    var60.i = var41.i + var49.i;
+    /* 22: shlw */
+    var62.i = var45.i << var61.i;
+    /* 23: addw */
+    var63.i = var60.i + var62.i;
+    /* 24: addw */
+    var64.i = var43.i + var47.i;
+    /* 26: mullw */
+    var66.i = (var64.i * var65.i) & 0xffff;
+    /* 27: subw */
+    var67.i = var63.i - var66.i;
+    /* 28: absw */
+    var68.i = ORC_ABS (var67.i);
+    /* 30: cmpgtsw */
+    var70.i = (var68.i > var69.i) ? (~0) : 0;
+    /* 31: andw */
+    var71.i = var59.i & var70.i;
+    /* 33: andw */
+    var73.i = var71.i & var72.i;
+    /* 34: convwb */
+    var74 = var73.i;
+    /* 35: storeb */
+    ptr0[i] = var74;
+  }
+
+}
+
+#else
+static void
+_backup_orc_comb_mask_5_tap_planar_yuv (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  const orc_int8 *ORC_RESTRICT ptr7;
+  const orc_int8 *ORC_RESTRICT ptr8;
+  orc_int8 var40;
+  orc_union16 var41;
+  orc_int8 var42;
+  orc_union16 var43;
+  orc_int8 var44;
+  orc_union16 var45;
+  orc_int8 var46;
+  orc_union16 var47;
+  orc_int8 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union16 var51;
+  orc_union16 var52;
+  orc_union16 var53;
+  orc_union16 var54;
+  orc_union16 var55;
+  orc_union16 var56;
+  orc_union16 var57;
+  orc_union16 var58;
+  orc_union16 var59;
+  orc_union16 var60;
+  orc_union16 var61;
+  orc_union16 var62;
+  orc_union16 var63;
+  orc_union16 var64;
+  orc_union16 var65;
+  orc_union16 var66;
+  orc_union16 var67;
+  orc_union16 var68;
+  orc_union16 var69;
+  orc_union16 var70;
+  orc_union16 var71;
+  orc_union16 var72;
+  orc_union16 var73;
+  orc_int8 var74;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+  ptr7 = (orc_int8 *) ex->arrays[7];
+  ptr8 = (orc_int8 *) ex->arrays[8];
+
+  /* 13: loadpw */
+  var53.i = ex->params[24];
+  /* 21: loadpw */
+  var61.i = 0x00000002;         /* 2 */
+  /* 25: loadpw */
+  var65.i = 0x00000003;         /* 3 */
+  /* 29: loadpw */
+  var69.i = ex->params[25];
+  /* 32: loadpw */
+  var72.i = 0x00000001;         /* 1 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var40 = ptr4[i];
+    /* 1: convubw */
+    var41.i = (orc_uint8) var40;
+    /* 2: loadb */
+    var42 = ptr5[i];
+    /* 3: convubw */
+    var43.i = (orc_uint8) var42;
+    /* 4: loadb */
+    var44 = ptr6[i];
+    /* 5: convubw */
+    var45.i = (orc_uint8) var44;
+    /* 6: loadb */
+    var46 = ptr7[i];
+    /* 7: convubw */
+    var47.i = (orc_uint8) var46;
+    /* 8: loadb */
+    var48 = ptr8[i];
+    /* 9: convubw */
+    var49.i = (orc_uint8) var48;
+    /* 10: subw */
+    var50.i = var45.i - var43.i;
+    /* 11: subw */
+    var51.i = var45.i - var47.i;
+    /* 12: minsw */
+    var52.i = ORC_MIN (var50.i, var51.i);
+    /* 14: cmpgtsw */
+    var54.i = (var52.i > var53.i) ? (~0) : 0;
+    /* 15: subw */
+    var55.i = var43.i - var45.i;
+    /* 16: subw */
+    var56.i = var47.i - var45.i;
+    /* 17: minsw */
+    var57.i = ORC_MIN (var55.i, var56.i);
+    /* 18: cmpgtsw */
+    var58.i = (var57.i > var53.i) ? (~0) : 0;
+    /* 19: orw */
+    var59.i = var54.i | var58.i;
+    /* 20: addw */
+    var60.i = var41.i + var49.i;
+    /* 22: shlw */
+    var62.i = var45.i << var61.i;
+    /* 23: addw */
+    var63.i = var60.i + var62.i;
+    /* 24: addw */
+    var64.i = var43.i + var47.i;
+    /* 26: mullw */
+    var66.i = (var64.i * var65.i) & 0xffff;
+    /* 27: subw */
+    var67.i = var63.i - var66.i;
+    /* 28: absw */
+    var68.i = ORC_ABS (var67.i);
+    /* 30: cmpgtsw */
+    var70.i = (var68.i > var69.i) ? (~0) : 0;
+    /* 31: andw */
+    var71.i = var59.i & var70.i;
+    /* 33: andw */
+    var73.i = var71.i & var72.i;
+    /* 34: convwb */
+    var74 = var73.i;
+    /* 35: storeb */
+    ptr0[i] = var74;
+  }
+
+}
+
+static OrcProgram *_orc_program_orc_comb_mask_5_tap_planar_yuv;
+void
+orc_comb_mask_5_tap_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4,
+    const orc_uint8 * s5, int p1, int p2, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_orc_comb_mask_5_tap_planar_yuv;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->arrays[ORC_VAR_S4] = (void *) s4;
+  ex->arrays[ORC_VAR_S5] = (void *) s5;
+  ex->params[ORC_VAR_P1] = p1;
+  ex->params[ORC_VAR_P2] = p2;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* orc_comb_block_score_planar_yuv */
+#ifdef DISABLE_ORC
+void
+orc_comb_block_score_planar_yuv (int * a1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, int n)
+{
+  int i;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_union16 var12 = { 0 };
+  orc_int8 var34;
+  orc_int8 var35;
+  orc_int8 var36;
+  orc_int8 var37;
+  orc_int8 var38;
+  orc_union16 var39;
+
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+  ptr6 = (orc_int8 *) s3;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var34 = ptr4[i];
+    /* 1: loadb */
+    var35 = ptr5[i];
+    /* 2: andb */
+    var36 = var34 & var35;
+    /* 3: loadb */
+    var37 = ptr6[i];
+    /* 4: andb */
+    var38 = var36 & var37;
+    /* 5: convubw */
+    var39.i = (orc_uint8) var38;
+    /* 6: accw */
+    var12.i = var12.i + var39.i;
+  }
+  *a1 = (var12.i & 0xffff);
+
+}
+
+#else
+static void
+_backup_orc_comb_block_score_planar_yuv (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  const orc_int8 *ORC_RESTRICT ptr6;
+  orc_union16 var12 = { 0 };
+  orc_int8 var34;
+  orc_int8 var35;
+  orc_int8 var36;
+  orc_int8 var37;
+  orc_int8 var38;
+  orc_union16 var39;
+
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+  ptr6 = (orc_int8 *) ex->arrays[6];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var34 = ptr4[i];
+    /* 1: loadb */
+    var35 = ptr5[i];
+    /* 2: andb */
+    var36 = var34 & var35;
+    /* 3: loadb */
+    var37 = ptr6[i];
+    /* 4: andb */
+    var38 = var36 & var37;
+    /* 5: convubw */
+    var39.i = (orc_uint8) var38;
+    /* 6: accw */
+    var12.i = var12.i + var39.i;
+  }
+  ex->accumulators[0] = (var12.i & 0xffff);
+
+}
+
+static OrcProgram *_orc_program_orc_comb_block_score_planar_yuv;
+void
+orc_comb_block_score_planar_yuv (int * a1, const orc_uint8 * s1,
+    const orc_uint8 * s2, const orc_uint8 * s3, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_orc_comb_block_score_planar_yuv;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+
+  func = p->code_exec;
+  func (ex);
+  *a1 = orc_executor_get_accumulator (ex, ORC_VAR_A1);
+}
+#endif
+
+void
+gst_fieldanalysis_orc_init (void)
+{
+#ifndef DISABLE_ORC
+  {
+    /* orc_same_parity_sad_planar_yuv */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_same_parity_sad_planar_yuv");
+    orc_program_set_backup_function (p, _backup_orc_same_parity_sad_planar_yuv);
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_accumulator (p, 4, "a1");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 4, "t3");
+    orc_program_add_temporary (p, 4, "t4");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T4, ORC_VAR_T3, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andl", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T3, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_orc_same_parity_sad_planar_yuv = p;
+  }
+  {
+    /* orc_same_parity_ssd_planar_yuv */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_same_parity_ssd_planar_yuv");
+    orc_program_set_backup_function (p, _backup_orc_same_parity_ssd_planar_yuv);
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_accumulator (p, 4, "a1");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 4, "t3");
+    orc_program_add_temporary (p, 4, "t4");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulswl", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T4, ORC_VAR_T3, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andl", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T3, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_orc_same_parity_ssd_planar_yuv = p;
+  }
+  {
+    /* orc_same_parity_3_tap_planar_yuv */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_same_parity_3_tap_planar_yuv");
+    orc_program_set_backup_function (p,
+        _backup_orc_same_parity_3_tap_planar_yuv);
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_source (p, 1, "s4");
+    orc_program_add_source (p, 1, "s5");
+    orc_program_add_source (p, 1, "s6");
+    orc_program_add_accumulator (p, 4, "a1");
+    orc_program_add_constant (p, 4, 0x00000002, "c1");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 2, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 2, "t6");
+    orc_program_add_temporary (p, 4, "t7");
+    orc_program_add_temporary (p, 4, "t8");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_S4, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T5, ORC_VAR_S5, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T6, ORC_VAR_S6, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T7, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T8, ORC_VAR_T7, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andl", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "accl", 0, ORC_VAR_A1, ORC_VAR_T7, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_orc_same_parity_3_tap_planar_yuv = p;
+  }
+  {
+    /* orc_opposite_parity_5_tap_planar_yuv */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_opposite_parity_5_tap_planar_yuv");
+    orc_program_set_backup_function (p,
+        _backup_orc_opposite_parity_5_tap_planar_yuv);
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_source (p, 1, "s4");
+    orc_program_add_source (p, 1, "s5");
+    orc_program_add_accumulator (p, 4, "a1");
+    orc_program_add_constant (p, 4, 0x00000002, "c1");
+    orc_program_add_constant (p, 4, 0x00000003, "c2");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 2, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
     orc_program_add_temporary (p, 4, "t6");
     orc_program_add_temporary (p, 4, "t7");
 
@@ -1052,5 +1947,259 @@ gst_fieldanalysis_orc_init (void)
 
     _orc_program_orc_opposite_parity_5_tap_planar_yuv = p;
   }
+  {
+    /* orc_comb_mask_32detect_planar_yuv */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_comb_mask_32detect_planar_yuv");
+    orc_program_set_backup_function (p,
+        _backup_orc_comb_mask_32detect_planar_yuv);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_source (p, 1, "s4");
+    orc_program_add_constant (p, 4, 0x0000000f, "c1");
+    orc_program_add_constant (p, 4, 0x00000009, "c2");
+    orc_program_add_constant (p, 4, 0x00000001, "c3");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 2, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 2, "t6");
+    orc_program_add_temporary (p, 2, "t7");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_S4, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T3, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T3, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "minsw", 0, ORC_VAR_T7, ORC_VAR_T5, ORC_VAR_T6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "minsw", 0, ORC_VAR_T6, ORC_VAR_T2, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "orw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T6,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T3, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andnw", 0, ORC_VAR_T7, ORC_VAR_T1, ORC_VAR_T7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convwb", 0, ORC_VAR_D1, ORC_VAR_T7, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_orc_comb_mask_32detect_planar_yuv = p;
+  }
+  {
+    /* orc_comb_mask_iscombed_planar_yuv */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_comb_mask_iscombed_planar_yuv");
+    orc_program_set_backup_function (p,
+        _backup_orc_comb_mask_iscombed_planar_yuv);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_constant (p, 4, 0x00000001, "c1");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 2, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 4, "t6");
+    orc_program_add_temporary (p, 4, "t7");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T4, ORC_VAR_T2, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T5, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "minsw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "minsw", 0, ORC_VAR_T5, ORC_VAR_T1, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T5, ORC_VAR_T5, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "orw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulswl", 0, ORC_VAR_T6, ORC_VAR_T1, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsl", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convswl", 0, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andl", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convlw", 0, ORC_VAR_T4, ORC_VAR_T6, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T4, ORC_VAR_T4, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convwb", 0, ORC_VAR_D1, ORC_VAR_T4, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_orc_comb_mask_iscombed_planar_yuv = p;
+  }
+  {
+    /* orc_comb_mask_5_tap_planar_yuv */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_comb_mask_5_tap_planar_yuv");
+    orc_program_set_backup_function (p, _backup_orc_comb_mask_5_tap_planar_yuv);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_source (p, 1, "s4");
+    orc_program_add_source (p, 1, "s5");
+    orc_program_add_constant (p, 4, 0x00000002, "c1");
+    orc_program_add_constant (p, 4, 0x00000003, "c2");
+    orc_program_add_constant (p, 4, 0x00000001, "c3");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_parameter (p, 2, "p2");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 2, "t3");
+    orc_program_add_temporary (p, 2, "t4");
+    orc_program_add_temporary (p, 2, "t5");
+    orc_program_add_temporary (p, 2, "t6");
+    orc_program_add_temporary (p, 2, "t7");
+    orc_program_add_temporary (p, 2, "t8");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T3, ORC_VAR_S3, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T4, ORC_VAR_S4, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T5, ORC_VAR_S5, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T6, ORC_VAR_T3, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T3, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "minsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T7, ORC_VAR_T2, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T8, ORC_VAR_T4, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "minsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T8,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "orw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T7,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T5,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shlw", 0, ORC_VAR_T3, ORC_VAR_T3, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T4,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mullw", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "absw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "cmpgtsw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andw", 0, ORC_VAR_T6, ORC_VAR_T6, ORC_VAR_C3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convwb", 0, ORC_VAR_D1, ORC_VAR_T6, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_orc_comb_mask_5_tap_planar_yuv = p;
+  }
+  {
+    /* orc_comb_block_score_planar_yuv */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "orc_comb_block_score_planar_yuv");
+    orc_program_set_backup_function (p,
+        _backup_orc_comb_block_score_planar_yuv);
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_source (p, 1, "s3");
+    orc_program_add_accumulator (p, 2, "a1");
+    orc_program_add_temporary (p, 1, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+
+    orc_program_append_2 (p, "andb", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_S2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "andb", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_S3,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "accw", 0, ORC_VAR_A1, ORC_VAR_T2, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_orc_comb_block_score_planar_yuv = p;
+  }
 #endif
 }
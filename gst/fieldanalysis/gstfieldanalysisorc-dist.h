@@ -63,6 +63,10 @@ void orc_same_parity_sad_planar_yuv (guint32 * a1, const orc_uint8 * s1, const o
 void orc_same_parity_ssd_planar_yuv (guint32 * a1, const orc_uint8 * s1, const orc_uint8 * s2, int p2, int n);
 void orc_same_parity_3_tap_planar_yuv (guint32 * a1, const orc_uint8 * s1, const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4, const orc_uint8 * s5, const orc_uint8 * s6, int p2, int n);
 void orc_opposite_parity_5_tap_planar_yuv (guint32 * a1, const orc_uint8 * s1, const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4, const orc_uint8 * s5, int p2, int n);
+void orc_comb_mask_32detect_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1, const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4, int p1, int n);
+void orc_comb_mask_iscombed_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1, const orc_uint8 * s2, const orc_uint8 * s3, int p1, int p2, int n);
+void orc_comb_mask_5_tap_planar_yuv (orc_uint8 * d1, const orc_uint8 * s1, const orc_uint8 * s2, const orc_uint8 * s3, const orc_uint8 * s4, const orc_uint8 * s5, int p1, int p2, int n);
+void orc_comb_block_score_planar_yuv (int * a1, const orc_uint8 * s1, const orc_uint8 * s2, const orc_uint8 * s3, int n);
 
 #ifdef __cplusplus
 }
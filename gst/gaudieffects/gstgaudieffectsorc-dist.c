@@ -0,0 +1,1622 @@
+
+/* autogenerated from gstgaudieffectsorc.orc */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#ifndef DISABLE_ORC
+#include <orc/orc.h>
+#endif
+#include <glib.h>
+
+#ifndef _ORC_INTEGER_TYPEDEFS_
+#define _ORC_INTEGER_TYPEDEFS_
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#include <stdint.h>
+typedef int8_t orc_int8;
+typedef int16_t orc_int16;
+typedef int32_t orc_int32;
+typedef int64_t orc_int64;
+typedef uint8_t orc_uint8;
+typedef uint16_t orc_uint16;
+typedef uint32_t orc_uint32;
+typedef uint64_t orc_uint64;
+#define ORC_UINT64_C(x) UINT64_C(x)
+#elif defined(_MSC_VER)
+typedef signed __int8 orc_int8;
+typedef signed __int16 orc_int16;
+typedef signed __int32 orc_int32;
+typedef signed __int64 orc_int64;
+typedef unsigned __int8 orc_uint8;
+typedef unsigned __int16 orc_uint16;
+typedef unsigned __int32 orc_uint32;
+typedef unsigned __int64 orc_uint64;
+#define ORC_UINT64_C(x) (x##Ui64)
+#else
+#include <limits.h>
+typedef signed char orc_int8;
+typedef short orc_int16;
+typedef int orc_int32;
+typedef unsigned char orc_uint8;
+typedef unsigned short orc_uint16;
+typedef unsigned int orc_uint32;
+#if INT_MAX == LONG_MAX
+typedef long long orc_int64;
+typedef unsigned long long orc_uint64;
+#define ORC_UINT64_C(x) (x##ULL)
+#else
+typedef long orc_int64;
+typedef unsigned long orc_uint64;
+#define ORC_UINT64_C(x) (x##UL)
+#endif
+#endif
+typedef union
+{
+  orc_int16 i;
+  orc_int8 x2[2];
+} orc_union16;
+typedef union
+{
+  orc_int32 i;
+  float f;
+  orc_int16 x2[2];
+  orc_int8 x4[4];
+} orc_union32;
+typedef union
+{
+  orc_int64 i;
+  double f;
+  orc_int32 x2[2];
+  float x2f[2];
+  orc_int16 x4[4];
+} orc_union64;
+#endif
+void gaussblur_orc_h_init (gint32 * d1, const guint8 * s1, int p1, int n);
+void gaussblur_orc_h_mac2 (gint32 * d1, const guint8 * s1, const guint8 * s2,
+    int p1, int n);
+void gaussblur_orc_h_finish (gint16 * d1, const gint32 * s1, int n);
+void gaussblur_orc_v_init (gint32 * d1, const gint16 * s1, int p1, int n);
+void gaussblur_orc_v_mac2 (gint32 * d1, const gint16 * s1, const gint16 * s2,
+    int p1, int n);
+void gaussblur_orc_v_finish (guint8 * d1, const gint32 * s1, int n);
+void gaussblur_orc_box_load (guint16 * d1, const guint8 * s1, int n);
+void gaussblur_orc_box_store (guint8 * d1, const guint16 * s1, int n);
+void gaussblur_orc_box_sum_init (guint32 * d1, const guint16 * s1, int n);
+void gaussblur_orc_box_sum_add (guint32 * d1, const guint16 * s1, int n);
+void gaussblur_orc_box_normalize (guint16 * d1, const guint32 * s1, int p1,
+    int p2, int n);
+void gaussblur_orc_box_step (guint16 * d1, guint32 * d2, const guint16 * s1,
+    const guint16 * s2, int p1, int p2, int n);
+
+void gst_gaudieffects_orc_init (void);
+
+
+/* begin Orc C target preamble */
+#define ORC_CLAMP(x,a,b) ((x)<(a) ? (a) : ((x)>(b) ? (b) : (x)))
+#define ORC_ABS(a) ((a)<0 ? -(a) : (a))
+#define ORC_MIN(a,b) ((a)<(b) ? (a) : (b))
+#define ORC_MAX(a,b) ((a)>(b) ? (a) : (b))
+#define ORC_SB_MAX 127
+#define ORC_SB_MIN (-1-ORC_SB_MAX)
+#define ORC_UB_MAX 255
+#define ORC_UB_MIN 0
+#define ORC_SW_MAX 32767
+#define ORC_SW_MIN (-1-ORC_SW_MAX)
+#define ORC_UW_MAX 65535
+#define ORC_UW_MIN 0
+#define ORC_SL_MAX 2147483647
+#define ORC_SL_MIN (-1-ORC_SL_MAX)
+#define ORC_UL_MAX 4294967295U
+#define ORC_UL_MIN 0
+#define ORC_CLAMP_SB(x) ORC_CLAMP(x,ORC_SB_MIN,ORC_SB_MAX)
+#define ORC_CLAMP_UB(x) ORC_CLAMP(x,ORC_UB_MIN,ORC_UB_MAX)
+#define ORC_CLAMP_SW(x) ORC_CLAMP(x,ORC_SW_MIN,ORC_SW_MAX)
+#define ORC_CLAMP_UW(x) ORC_CLAMP(x,ORC_UW_MIN,ORC_UW_MAX)
+#define ORC_CLAMP_SL(x) ORC_CLAMP(x,ORC_SL_MIN,ORC_SL_MAX)
+#define ORC_CLAMP_UL(x) ORC_CLAMP(x,ORC_UL_MIN,ORC_UL_MAX)
+#define ORC_SWAP_W(x) ((((x)&0xff)<<8) | (((x)&0xff00)>>8))
+#define ORC_SWAP_L(x) ((((x)&0xff)<<24) | (((x)&0xff00)<<8) | (((x)&0xff0000)>>8) | (((x)&0xff000000)>>24))
+#define ORC_SWAP_Q(x) ((((x)&ORC_UINT64_C(0xff))<<56) | (((x)&ORC_UINT64_C(0xff00))<<40) | (((x)&ORC_UINT64_C(0xff0000))<<24) | (((x)&ORC_UINT64_C(0xff000000))<<8) | (((x)&ORC_UINT64_C(0xff00000000))>>8) | (((x)&ORC_UINT64_C(0xff0000000000))>>24) | (((x)&ORC_UINT64_C(0xff000000000000))>>40) | (((x)&ORC_UINT64_C(0xff00000000000000))>>56))
+#define ORC_PTR_OFFSET(ptr,offset) ((void *)(((unsigned char *)(ptr)) + (offset)))
+#define ORC_DENORMAL(x) ((x) & ((((x)&0x7f800000) == 0) ? 0xff800000 : 0xffffffff))
+#define ORC_ISNAN(x) ((((x)&0x7f800000) == 0x7f800000) && (((x)&0x007fffff) != 0))
+#define ORC_DENORMAL_DOUBLE(x) ((x) & ((((x)&ORC_UINT64_C(0x7ff0000000000000)) == 0) ? ORC_UINT64_C(0xfff0000000000000) : ORC_UINT64_C(0xffffffffffffffff)))
+#define ORC_ISNAN_DOUBLE(x) ((((x)&ORC_UINT64_C(0x7ff0000000000000)) == ORC_UINT64_C(0x7ff0000000000000)) && (((x)&ORC_UINT64_C(0x000fffffffffffff)) != 0))
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define ORC_RESTRICT restrict
+#elif defined(__GNUC__) && __GNUC__ >= 4
+#define ORC_RESTRICT __restrict__
+#else
+#define ORC_RESTRICT
+#endif
+/* end Orc C target preamble */
+
+
+
+/* gaussblur_orc_h_init */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_h_init (gint32 * d1, const guint8 * s1, int p1, int n)
+{
+  int i;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  orc_int8 var33;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_union32 var36;
+
+  ptr0 = (orc_union32 *) d1;
+  ptr4 = (orc_int8 *) s1;
+
+  /* 2: loadpw */
+  var35.i = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var33 = ptr4[i];
+    /* 1: convubw */
+    var34.i = (orc_uint8) var33;
+    /* 3: mulswl */
+    var36.i = var34.i * var35.i;
+    /* 4: storel */
+    ptr0[i] = var36;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_h_init (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  orc_int8 var33;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_union32 var36;
+
+  ptr0 = (orc_union32 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+
+  /* 2: loadpw */
+  var35.i = ex->params[24];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var33 = ptr4[i];
+    /* 1: convubw */
+    var34.i = (orc_uint8) var33;
+    /* 3: mulswl */
+    var36.i = var34.i * var35.i;
+    /* 4: storel */
+    ptr0[i] = var36;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_h_init;
+void
+gaussblur_orc_h_init (gint32 * d1, const guint8 * s1, int p1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_h_init;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->params[ORC_VAR_P1] = p1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_h_mac2 */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_h_mac2 (gint32 * d1, const guint8 * s1, const guint8 * s2, int p1,
+    int n)
+{
+  int i;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  orc_int8 var35;
+  orc_union16 var36;
+  orc_int8 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union32 var41;
+  orc_union32 var42;
+  orc_union32 var43;
+
+  ptr0 = (orc_union32 *) d1;
+  ptr4 = (orc_int8 *) s1;
+  ptr5 = (orc_int8 *) s2;
+
+  /* 5: loadpw */
+  var40.i = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var35 = ptr4[i];
+    /* 1: convubw */
+    var36.i = (orc_uint8) var35;
+    /* 2: loadb */
+    var37 = ptr5[i];
+    /* 3: convubw */
+    var38.i = (orc_uint8) var37;
+    /* 4: addw */
+    var39.i = var36.i + var38.i;
+    /* 6: mulswl */
+    var41.i = var39.i * var40.i;
+    /* 7: loadl */
+    var42 = ptr0[i];
+    /* 8: addl */
+    var43.i = var42.i + var41.i;
+    /* 9: storel */
+    ptr0[i] = var43;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_h_mac2 (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  const orc_int8 *ORC_RESTRICT ptr5;
+  orc_int8 var35;
+  orc_union16 var36;
+  orc_int8 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union32 var41;
+  orc_union32 var42;
+  orc_union32 var43;
+
+  ptr0 = (orc_union32 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr5 = (orc_int8 *) ex->arrays[5];
+
+  /* 5: loadpw */
+  var40.i = ex->params[24];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var35 = ptr4[i];
+    /* 1: convubw */
+    var36.i = (orc_uint8) var35;
+    /* 2: loadb */
+    var37 = ptr5[i];
+    /* 3: convubw */
+    var38.i = (orc_uint8) var37;
+    /* 4: addw */
+    var39.i = var36.i + var38.i;
+    /* 6: mulswl */
+    var41.i = var39.i * var40.i;
+    /* 7: loadl */
+    var42 = ptr0[i];
+    /* 8: addl */
+    var43.i = var42.i + var41.i;
+    /* 9: storel */
+    ptr0[i] = var43;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_h_mac2;
+void
+gaussblur_orc_h_mac2 (gint32 * d1, const guint8 * s1, const guint8 * s2, int p1,
+    int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_h_mac2;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->params[ORC_VAR_P1] = p1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_h_finish */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_h_finish (gint16 * d1, const gint32 * s1, int n)
+{
+  int i;
+  orc_union16 *ORC_RESTRICT ptr0;
+  const orc_union32 *ORC_RESTRICT ptr4;
+  orc_union32 var33;
+  orc_union32 var34;
+  orc_union32 var35;
+  orc_union32 var36;
+  orc_union32 var37;
+  orc_union16 var38;
+
+  ptr0 = (orc_union16 *) d1;
+  ptr4 = (orc_union32 *) s1;
+
+  /* 1: loadpl */
+  var34.i = 0x00000080;         /* 128 */
+  /* 3: loadpl */
+  var36.i = 0x00000008;         /* 8 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var33 = ptr4[i];
+    /* 2: addl */
+    var35.i = var33.i + var34.i;
+    /* 4: shrsl */
+    var37.i = var35.i >> var36.i;
+    /* 5: convssslw */
+    var38.i = ORC_CLAMP_SW (var37.i);
+    /* 6: storew */
+    ptr0[i] = var38;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_h_finish (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0;
+  const orc_union32 *ORC_RESTRICT ptr4;
+  orc_union32 var33;
+  orc_union32 var34;
+  orc_union32 var35;
+  orc_union32 var36;
+  orc_union32 var37;
+  orc_union16 var38;
+
+  ptr0 = (orc_union16 *) ex->arrays[0];
+  ptr4 = (orc_union32 *) ex->arrays[4];
+
+  /* 1: loadpl */
+  var34.i = 0x00000080;         /* 128 */
+  /* 3: loadpl */
+  var36.i = 0x00000008;         /* 8 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var33 = ptr4[i];
+    /* 2: addl */
+    var35.i = var33.i + var34.i;
+    /* 4: shrsl */
+    var37.i = var35.i >> var36.i;
+    /* 5: convssslw */
+    var38.i = ORC_CLAMP_SW (var37.i);
+    /* 6: storew */
+    ptr0[i] = var38;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_h_finish;
+void
+gaussblur_orc_h_finish (gint16 * d1, const gint32 * s1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_h_finish;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_v_init */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_v_init (gint32 * d1, const gint16 * s1, int p1, int n)
+{
+  int i;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var32;
+  orc_union16 var33;
+  orc_union32 var34;
+
+  ptr0 = (orc_union32 *) d1;
+  ptr4 = (orc_union16 *) s1;
+
+  /* 1: loadpw */
+  var33.i = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var32 = ptr4[i];
+    /* 2: mulswl */
+    var34.i = var32.i * var33.i;
+    /* 3: storel */
+    ptr0[i] = var34;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_v_init (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var32;
+  orc_union16 var33;
+  orc_union32 var34;
+
+  ptr0 = (orc_union32 *) ex->arrays[0];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+
+  /* 1: loadpw */
+  var33.i = ex->params[24];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var32 = ptr4[i];
+    /* 2: mulswl */
+    var34.i = var32.i * var33.i;
+    /* 3: storel */
+    ptr0[i] = var34;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_v_init;
+void
+gaussblur_orc_v_init (gint32 * d1, const gint16 * s1, int p1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_v_init;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->params[ORC_VAR_P1] = p1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_v_mac2 */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_v_mac2 (gint32 * d1, const gint16 * s1, const gint16 * s2, int p1,
+    int n)
+{
+  int i;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_union32 var38;
+  orc_union32 var39;
+  orc_union32 var40;
+
+  ptr0 = (orc_union32 *) d1;
+  ptr4 = (orc_union16 *) s1;
+  ptr5 = (orc_union16 *) s2;
+
+  /* 3: loadpw */
+  var37.i = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var34 = ptr4[i];
+    /* 1: loadw */
+    var35 = ptr5[i];
+    /* 2: addw */
+    var36.i = var34.i + var35.i;
+    /* 4: mulswl */
+    var38.i = var36.i * var37.i;
+    /* 5: loadl */
+    var39 = ptr0[i];
+    /* 6: addl */
+    var40.i = var39.i + var38.i;
+    /* 7: storel */
+    ptr0[i] = var40;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_v_mac2 (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_union32 var38;
+  orc_union32 var39;
+  orc_union32 var40;
+
+  ptr0 = (orc_union32 *) ex->arrays[0];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+  ptr5 = (orc_union16 *) ex->arrays[5];
+
+  /* 3: loadpw */
+  var37.i = ex->params[24];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var34 = ptr4[i];
+    /* 1: loadw */
+    var35 = ptr5[i];
+    /* 2: addw */
+    var36.i = var34.i + var35.i;
+    /* 4: mulswl */
+    var38.i = var36.i * var37.i;
+    /* 5: loadl */
+    var39 = ptr0[i];
+    /* 6: addl */
+    var40.i = var39.i + var38.i;
+    /* 7: storel */
+    ptr0[i] = var40;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_v_mac2;
+void
+gaussblur_orc_v_mac2 (gint32 * d1, const gint16 * s1, const gint16 * s2, int p1,
+    int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_v_mac2;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->params[ORC_VAR_P1] = p1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_v_finish */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_v_finish (guint8 * d1, const gint32 * s1, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_union32 *ORC_RESTRICT ptr4;
+  orc_union32 var34;
+  orc_union32 var35;
+  orc_union32 var36;
+  orc_union32 var37;
+  orc_union32 var38;
+  orc_union16 var39;
+  orc_int8 var40;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_union32 *) s1;
+
+  /* 1: loadpl */
+  var35.i = 0x00008000;         /* 32768 */
+  /* 3: loadpl */
+  var37.i = 0x00000010;         /* 16 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var34 = ptr4[i];
+    /* 2: addl */
+    var36.i = var34.i + var35.i;
+    /* 4: shrsl */
+    var38.i = var36.i >> var37.i;
+    /* 5: convssslw */
+    var39.i = ORC_CLAMP_SW (var38.i);
+    /* 6: convsuswb */
+    var40 = ORC_CLAMP_UB (var39.i);
+    /* 7: storeb */
+    ptr0[i] = var40;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_v_finish (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_union32 *ORC_RESTRICT ptr4;
+  orc_union32 var34;
+  orc_union32 var35;
+  orc_union32 var36;
+  orc_union32 var37;
+  orc_union32 var38;
+  orc_union16 var39;
+  orc_int8 var40;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_union32 *) ex->arrays[4];
+
+  /* 1: loadpl */
+  var35.i = 0x00008000;         /* 32768 */
+  /* 3: loadpl */
+  var37.i = 0x00000010;         /* 16 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var34 = ptr4[i];
+    /* 2: addl */
+    var36.i = var34.i + var35.i;
+    /* 4: shrsl */
+    var38.i = var36.i >> var37.i;
+    /* 5: convssslw */
+    var39.i = ORC_CLAMP_SW (var38.i);
+    /* 6: convsuswb */
+    var40 = ORC_CLAMP_UB (var39.i);
+    /* 7: storeb */
+    ptr0[i] = var40;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_v_finish;
+void
+gaussblur_orc_v_finish (guint8 * d1, const gint32 * s1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_v_finish;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_box_load */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_box_load (guint16 * d1, const guint8 * s1, int n)
+{
+  int i;
+  orc_union16 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  orc_int8 var33;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_union16 var36;
+
+  ptr0 = (orc_union16 *) d1;
+  ptr4 = (orc_int8 *) s1;
+
+  /* 2: loadpw */
+  var35.i = 0x00000004;         /* 4 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var33 = ptr4[i];
+    /* 1: convubw */
+    var34.i = (orc_uint8) var33;
+    /* 3: shlw */
+    var36.i = var34.i << var35.i;
+    /* 4: storew */
+    ptr0[i] = var36;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_box_load (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0;
+  const orc_int8 *ORC_RESTRICT ptr4;
+  orc_int8 var33;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_union16 var36;
+
+  ptr0 = (orc_union16 *) ex->arrays[0];
+  ptr4 = (orc_int8 *) ex->arrays[4];
+
+  /* 2: loadpw */
+  var35.i = 0x00000004;         /* 4 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var33 = ptr4[i];
+    /* 1: convubw */
+    var34.i = (orc_uint8) var33;
+    /* 3: shlw */
+    var36.i = var34.i << var35.i;
+    /* 4: storew */
+    ptr0[i] = var36;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_box_load;
+void
+gaussblur_orc_box_load (guint16 * d1, const guint8 * s1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_box_load;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_box_store */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_box_store (guint8 * d1, const guint16 * s1, int n)
+{
+  int i;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var33;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_int8 var38;
+
+  ptr0 = (orc_int8 *) d1;
+  ptr4 = (orc_union16 *) s1;
+
+  /* 1: loadpw */
+  var34.i = 0x00000008;         /* 8 */
+  /* 3: loadpw */
+  var36.i = 0x00000004;         /* 4 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var33 = ptr4[i];
+    /* 2: addw */
+    var35.i = var33.i + var34.i;
+    /* 4: shruw */
+    var37.i = ((orc_uint16) var35.i) >> var36.i;
+    /* 5: convuuswb */
+    var38 = ORC_CLAMP_UB ((orc_uint16) var37.i);
+    /* 6: storeb */
+    ptr0[i] = var38;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_box_store (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var33;
+  orc_union16 var34;
+  orc_union16 var35;
+  orc_union16 var36;
+  orc_union16 var37;
+  orc_int8 var38;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+
+  /* 1: loadpw */
+  var34.i = 0x00000008;         /* 8 */
+  /* 3: loadpw */
+  var36.i = 0x00000004;         /* 4 */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var33 = ptr4[i];
+    /* 2: addw */
+    var35.i = var33.i + var34.i;
+    /* 4: shruw */
+    var37.i = ((orc_uint16) var35.i) >> var36.i;
+    /* 5: convuuswb */
+    var38 = ORC_CLAMP_UB ((orc_uint16) var37.i);
+    /* 6: storeb */
+    ptr0[i] = var38;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_box_store;
+void
+gaussblur_orc_box_store (guint8 * d1, const guint16 * s1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_box_store;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_box_sum_init */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_box_sum_init (guint32 * d1, const guint16 * s1, int n)
+{
+  int i;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *) d1;
+  ptr4 = (orc_union16 *) s1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var32 = ptr4[i];
+    /* 1: convuwl */
+    var33.i = (orc_uint16) var32.i;
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_box_sum_init (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *) ex->arrays[0];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var32 = ptr4[i];
+    /* 1: convuwl */
+    var33.i = (orc_uint16) var32.i;
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_box_sum_init;
+void
+gaussblur_orc_box_sum_init (guint32 * d1, const guint16 * s1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_box_sum_init;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_box_sum_add */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_box_sum_add (guint32 * d1, const guint16 * s1, int n)
+{
+  int i;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var33;
+  orc_union32 var34;
+  orc_union32 var35;
+  orc_union32 var36;
+
+  ptr0 = (orc_union32 *) d1;
+  ptr4 = (orc_union16 *) s1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var33 = ptr4[i];
+    /* 1: convuwl */
+    var34.i = (orc_uint16) var33.i;
+    /* 2: loadl */
+    var35 = ptr0[i];
+    /* 3: addl */
+    var36.i = var35.i + var34.i;
+    /* 4: storel */
+    ptr0[i] = var36;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_box_sum_add (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  orc_union16 var33;
+  orc_union32 var34;
+  orc_union32 var35;
+  orc_union32 var36;
+
+  ptr0 = (orc_union32 *) ex->arrays[0];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var33 = ptr4[i];
+    /* 1: convuwl */
+    var34.i = (orc_uint16) var33.i;
+    /* 2: loadl */
+    var35 = ptr0[i];
+    /* 3: addl */
+    var36.i = var35.i + var34.i;
+    /* 4: storel */
+    ptr0[i] = var36;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_box_sum_add;
+void
+gaussblur_orc_box_sum_add (guint32 * d1, const guint16 * s1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_box_sum_add;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_box_normalize */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_box_normalize (guint16 * d1, const guint32 * s1, int p1, int p2,
+    int n)
+{
+  int i;
+  orc_union16 *ORC_RESTRICT ptr0;
+  const orc_union32 *ORC_RESTRICT ptr4;
+  orc_union32 var33;
+  orc_union32 var34;
+  orc_union32 var35;
+  orc_union32 var36;
+  orc_union32 var37;
+  orc_union16 var38;
+
+  ptr0 = (orc_union16 *) d1;
+  ptr4 = (orc_union32 *) s1;
+
+  /* 1: loadpl */
+  var34.i = p2;
+  /* 3: loadpl */
+  var36.i = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var33 = ptr4[i];
+    /* 2: addl */
+    var35.i = var33.i + var34.i;
+    /* 4: mulhul */
+    var37.i = ((orc_uint64) (orc_uint32) var35.i * (orc_uint64) (orc_uint32) var36.i) >> 32;
+    /* 5: convlw */
+    var38.i = var37.i;
+    /* 6: storew */
+    ptr0[i] = var38;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_box_normalize (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0;
+  const orc_union32 *ORC_RESTRICT ptr4;
+  orc_union32 var33;
+  orc_union32 var34;
+  orc_union32 var35;
+  orc_union32 var36;
+  orc_union32 var37;
+  orc_union16 var38;
+
+  ptr0 = (orc_union16 *) ex->arrays[0];
+  ptr4 = (orc_union32 *) ex->arrays[4];
+
+  /* 1: loadpl */
+  var34.i = ex->params[25];
+  /* 3: loadpl */
+  var36.i = ex->params[24];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var33 = ptr4[i];
+    /* 2: addl */
+    var35.i = var33.i + var34.i;
+    /* 4: mulhul */
+    var37.i = ((orc_uint64) (orc_uint32) var35.i * (orc_uint64) (orc_uint32) var36.i) >> 32;
+    /* 5: convlw */
+    var38.i = var37.i;
+    /* 6: storew */
+    ptr0[i] = var38;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_box_normalize;
+void
+gaussblur_orc_box_normalize (guint16 * d1, const guint32 * s1, int p1, int p2,
+    int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_box_normalize;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->params[ORC_VAR_P1] = p1;
+  ex->params[ORC_VAR_P2] = p2;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+
+/* gaussblur_orc_box_step */
+#ifdef DISABLE_ORC
+void
+gaussblur_orc_box_step (guint16 * d1, guint32 * d2, const guint16 * s1,
+    const guint16 * s2, int p1, int p2, int n)
+{
+  int i;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union32 *ORC_RESTRICT ptr1;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  orc_union16 var34;
+  orc_union32 var35;
+  orc_union32 var36;
+  orc_union32 var37;
+  orc_union16 var38;
+  orc_union32 var39;
+  orc_union32 var40;
+  orc_union32 var41;
+  orc_union32 var42;
+  orc_union32 var43;
+  orc_union32 var44;
+  orc_union32 var45;
+  orc_union16 var46;
+
+  ptr0 = (orc_union16 *) d1;
+  ptr1 = (orc_union32 *) d2;
+  ptr4 = (orc_union16 *) s1;
+  ptr5 = (orc_union16 *) s2;
+
+  /* 9: loadpl */
+  var42.i = p2;
+  /* 11: loadpl */
+  var44.i = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var34 = ptr4[i];
+    /* 1: convuwl */
+    var35.i = (orc_uint16) var34.i;
+    /* 2: loadl */
+    var36 = ptr1[i];
+    /* 3: addl */
+    var37.i = var36.i + var35.i;
+    /* 4: loadw */
+    var38 = ptr5[i];
+    /* 5: convuwl */
+    var39.i = (orc_uint16) var38.i;
+    /* 6: subl */
+    var40.i = var37.i - var39.i;
+    /* 7: copyl */
+    var41.i = var40.i;
+    /* 8: storel */
+    ptr1[i] = var41;
+    /* 10: addl */
+    var43.i = var40.i + var42.i;
+    /* 12: mulhul */
+    var45.i = ((orc_uint64) (orc_uint32) var43.i * (orc_uint64) (orc_uint32) var44.i) >> 32;
+    /* 13: convlw */
+    var46.i = var45.i;
+    /* 14: storew */
+    ptr0[i] = var46;
+  }
+
+}
+
+#else
+static void
+_backup_gaussblur_orc_box_step (OrcExecutor * ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union32 *ORC_RESTRICT ptr1;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  orc_union16 var34;
+  orc_union32 var35;
+  orc_union32 var36;
+  orc_union32 var37;
+  orc_union16 var38;
+  orc_union32 var39;
+  orc_union32 var40;
+  orc_union32 var41;
+  orc_union32 var42;
+  orc_union32 var43;
+  orc_union32 var44;
+  orc_union32 var45;
+  orc_union16 var46;
+
+  ptr0 = (orc_union16 *) ex->arrays[0];
+  ptr1 = (orc_union32 *) ex->arrays[1];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+  ptr5 = (orc_union16 *) ex->arrays[5];
+
+  /* 9: loadpl */
+  var42.i = ex->params[25];
+  /* 11: loadpl */
+  var44.i = ex->params[24];
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var34 = ptr4[i];
+    /* 1: convuwl */
+    var35.i = (orc_uint16) var34.i;
+    /* 2: loadl */
+    var36 = ptr1[i];
+    /* 3: addl */
+    var37.i = var36.i + var35.i;
+    /* 4: loadw */
+    var38 = ptr5[i];
+    /* 5: convuwl */
+    var39.i = (orc_uint16) var38.i;
+    /* 6: subl */
+    var40.i = var37.i - var39.i;
+    /* 7: copyl */
+    var41.i = var40.i;
+    /* 8: storel */
+    ptr1[i] = var41;
+    /* 10: addl */
+    var43.i = var40.i + var42.i;
+    /* 12: mulhul */
+    var45.i = ((orc_uint64) (orc_uint32) var43.i * (orc_uint64) (orc_uint32) var44.i) >> 32;
+    /* 13: convlw */
+    var46.i = var45.i;
+    /* 14: storew */
+    ptr0[i] = var46;
+  }
+
+}
+
+static OrcProgram *_orc_program_gaussblur_orc_box_step;
+void
+gaussblur_orc_box_step (guint16 * d1, guint32 * d2, const guint16 * s1,
+    const guint16 * s2, int p1, int p2, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  OrcProgram *p = _orc_program_gaussblur_orc_box_step;
+  void (*func) (OrcExecutor *);
+
+  ex->program = p;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_D2] = d2;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->params[ORC_VAR_P1] = p1;
+  ex->params[ORC_VAR_P2] = p2;
+
+  func = p->code_exec;
+  func (ex);
+}
+#endif
+
+void
+gst_gaudieffects_orc_init (void)
+{
+#ifndef DISABLE_ORC
+  {
+    /* gaussblur_orc_h_init */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_h_init");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_h_init);
+    orc_program_add_destination (p, 4, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_temporary (p, 2, "t1");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulswl", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_P1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_h_init = p;
+  }
+  {
+    /* gaussblur_orc_h_mac2 */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_h_mac2");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_h_mac2);
+    orc_program_add_destination (p, 4, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_source (p, 1, "s2");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+    orc_program_add_temporary (p, 4, "t3");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_T2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulswl", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addl", 0, ORC_VAR_D1, ORC_VAR_D1, ORC_VAR_T3,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_h_mac2 = p;
+  }
+  {
+    /* gaussblur_orc_h_finish */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_h_finish");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_h_finish);
+    orc_program_add_destination (p, 2, "d1");
+    orc_program_add_source (p, 4, "s1");
+    orc_program_add_constant (p, 4, 0x00000080, "c1");
+    orc_program_add_constant (p, 4, 0x00000008, "c2");
+    orc_program_add_temporary (p, 4, "t1");
+
+    orc_program_append_2 (p, "addl", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shrsl", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convssslw", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_h_finish = p;
+  }
+  {
+    /* gaussblur_orc_v_init */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_v_init");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_v_init);
+    orc_program_add_destination (p, 4, "d1");
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_parameter (p, 2, "p1");
+
+    orc_program_append_2 (p, "mulswl", 0, ORC_VAR_D1, ORC_VAR_S1, ORC_VAR_P1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_v_init = p;
+  }
+  {
+    /* gaussblur_orc_v_mac2 */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_v_mac2");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_v_mac2);
+    orc_program_add_destination (p, 4, "d1");
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_source (p, 2, "s2");
+    orc_program_add_parameter (p, 2, "p1");
+    orc_program_add_temporary (p, 2, "t1");
+    orc_program_add_temporary (p, 4, "t2");
+
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_S2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulswl", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addl", 0, ORC_VAR_D1, ORC_VAR_D1, ORC_VAR_T2,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_v_mac2 = p;
+  }
+  {
+    /* gaussblur_orc_v_finish */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_v_finish");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_v_finish);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_source (p, 4, "s1");
+    orc_program_add_constant (p, 4, 0x00008000, "c1");
+    orc_program_add_constant (p, 4, 0x00000010, "c2");
+    orc_program_add_temporary (p, 4, "t1");
+    orc_program_add_temporary (p, 2, "t2");
+
+    orc_program_append_2 (p, "addl", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shrsl", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convssslw", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convsuswb", 0, ORC_VAR_D1, ORC_VAR_T2, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_v_finish = p;
+  }
+  {
+    /* gaussblur_orc_box_load */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_box_load");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_box_load);
+    orc_program_add_destination (p, 2, "d1");
+    orc_program_add_source (p, 1, "s1");
+    orc_program_add_constant (p, 4, 0x00000004, "c1");
+    orc_program_add_temporary (p, 2, "t1");
+
+    orc_program_append_2 (p, "convubw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shlw", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_C1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_box_load = p;
+  }
+  {
+    /* gaussblur_orc_box_store */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_box_store");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_box_store);
+    orc_program_add_destination (p, 1, "d1");
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_constant (p, 4, 0x00000008, "c1");
+    orc_program_add_constant (p, 4, 0x00000004, "c2");
+    orc_program_add_temporary (p, 2, "t1");
+
+    orc_program_append_2 (p, "addw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_C1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "shruw", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_C2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convuuswb", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_box_store = p;
+  }
+  {
+    /* gaussblur_orc_box_sum_init */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_box_sum_init");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_box_sum_init);
+    orc_program_add_destination (p, 4, "d1");
+    orc_program_add_source (p, 2, "s1");
+
+    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_D1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_box_sum_init = p;
+  }
+  {
+    /* gaussblur_orc_box_sum_add */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_box_sum_add");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_box_sum_add);
+    orc_program_add_destination (p, 4, "d1");
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_temporary (p, 4, "t1");
+
+    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addl", 0, ORC_VAR_D1, ORC_VAR_D1, ORC_VAR_T1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_box_sum_add = p;
+  }
+  {
+    /* gaussblur_orc_box_normalize */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_box_normalize");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_box_normalize);
+    orc_program_add_destination (p, 2, "d1");
+    orc_program_add_source (p, 4, "s1");
+    orc_program_add_parameter (p, 4, "p1");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 4, "t1");
+
+    orc_program_append_2 (p, "addl", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulhul", 0, ORC_VAR_T1, ORC_VAR_T1, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convlw", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_box_normalize = p;
+  }
+  {
+    /* gaussblur_orc_box_step */
+    OrcProgram *p;
+    OrcCompileResult result;
+
+    p = orc_program_new ();
+    orc_program_set_name (p, "gaussblur_orc_box_step");
+    orc_program_set_backup_function (p, _backup_gaussblur_orc_box_step);
+    orc_program_add_destination (p, 2, "d1");
+    orc_program_add_destination (p, 4, "d2");
+    orc_program_add_source (p, 2, "s1");
+    orc_program_add_source (p, 2, "s2");
+    orc_program_add_parameter (p, 4, "p1");
+    orc_program_add_parameter (p, 4, "p2");
+    orc_program_add_temporary (p, 4, "t1");
+    orc_program_add_temporary (p, 4, "t2");
+
+    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addl", 0, ORC_VAR_T2, ORC_VAR_D2, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convuwl", 0, ORC_VAR_T1, ORC_VAR_S2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "subl", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_T1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "copyl", 0, ORC_VAR_D2, ORC_VAR_T2, ORC_VAR_D1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "addl", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_P2,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "mulhul", 0, ORC_VAR_T2, ORC_VAR_T2, ORC_VAR_P1,
+        ORC_VAR_D1);
+    orc_program_append_2 (p, "convlw", 0, ORC_VAR_D1, ORC_VAR_T2, ORC_VAR_D1,
+        ORC_VAR_D1);
+
+    result = orc_program_compile (p);
+
+    _orc_program_gaussblur_orc_box_step = p;
+  }
+#endif
+}
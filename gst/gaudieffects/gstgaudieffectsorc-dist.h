@@ -0,0 +1,80 @@
+
+/* autogenerated from gstgaudieffectsorc.orc */
+
+#ifndef _GSTGAUDIEFFECTSORC_H_
+#define _GSTGAUDIEFFECTSORC_H_
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void gst_gaudieffects_orc_init (void);
+
+
+
+#ifndef _ORC_INTEGER_TYPEDEFS_
+#define _ORC_INTEGER_TYPEDEFS_
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#include <stdint.h>
+typedef int8_t orc_int8;
+typedef int16_t orc_int16;
+typedef int32_t orc_int32;
+typedef int64_t orc_int64;
+typedef uint8_t orc_uint8;
+typedef uint16_t orc_uint16;
+typedef uint32_t orc_uint32;
+typedef uint64_t orc_uint64;
+#define ORC_UINT64_C(x) UINT64_C(x)
+#elif defined(_MSC_VER)
+typedef signed __int8 orc_int8;
+typedef signed __int16 orc_int16;
+typedef signed __int32 orc_int32;
+typedef signed __int64 orc_int64;
+typedef unsigned __int8 orc_uint8;
+typedef unsigned __int16 orc_uint16;
+typedef unsigned __int32 orc_uint32;
+typedef unsigned __int64 orc_uint64;
+#define ORC_UINT64_C(x) (x##Ui64)
+#else
+#include <limits.h>
+typedef signed char orc_int8;
+typedef short orc_int16;
+typedef int orc_int32;
+typedef unsigned char orc_uint8;
+typedef unsigned short orc_uint16;
+typedef unsigned int orc_uint32;
+#if INT_MAX == LONG_MAX
+typedef long long orc_int64;
+typedef unsigned long long orc_uint64;
+#define ORC_UINT64_C(x) (x##ULL)
+#else
+typedef long orc_int64;
+typedef unsigned long orc_uint64;
+#define ORC_UINT64_C(x) (x##UL)
+#endif
+#endif
+typedef union { orc_int16 i; orc_int8 x2[2]; } orc_union16;
+typedef union { orc_int32 i; float f; orc_int16 x2[2]; orc_int8 x4[4]; } orc_union32;
+typedef union { orc_int64 i; double f; orc_int32 x2[2]; float x2f[2]; orc_int16 x4[4]; } orc_union64;
+#endif
+void gaussblur_orc_h_init (gint32 * d1, const guint8 * s1, int p1, int n);
+void gaussblur_orc_h_mac2 (gint32 * d1, const guint8 * s1, const guint8 * s2, int p1, int n);
+void gaussblur_orc_h_finish (gint16 * d1, const gint32 * s1, int n);
+void gaussblur_orc_v_init (gint32 * d1, const gint16 * s1, int p1, int n);
+void gaussblur_orc_v_mac2 (gint32 * d1, const gint16 * s1, const gint16 * s2, int p1, int n);
+void gaussblur_orc_v_finish (guint8 * d1, const gint32 * s1, int n);
+void gaussblur_orc_box_load (guint16 * d1, const guint8 * s1, int n);
+void gaussblur_orc_box_store (guint8 * d1, const guint16 * s1, int n);
+void gaussblur_orc_box_sum_init (guint32 * d1, const guint16 * s1, int n);
+void gaussblur_orc_box_sum_add (guint32 * d1, const guint16 * s1, int n);
+void gaussblur_orc_box_normalize (guint16 * d1, const guint32 * s1, int p1, int p2, int n);
+void gaussblur_orc_box_step (guint16 * d1, guint32 * d2, const guint16 * s1, const guint16 * s2, int p1, int p2, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -3,11 +3,13 @@
 #endif
 
 #include <math.h>
+#include <string.h>
 #include <gst/gst.h>
 #include <gst/controller/gstcontroller.h>
 
 #include "gstplugin.h"
 #include "gstgaussblur.h"
+#include "gstgaudieffectsorc.h"
 
 static gboolean gauss_blur_stop (GstBaseTransform * btrans);
 static gboolean gauss_blur_set_caps (GstBaseTransform * btrans,
@@ -19,6 +21,7 @@ static void gauss_blur_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec);
 static void gauss_blur_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec);
+static void gauss_blur_finalize (GObject * object);
 
 GST_DEBUG_CATEGORY_STATIC (gst_gauss_blur_debug);
 #define GST_CAT_DEFAULT gst_gauss_blur_debug
@@ -29,7 +32,7 @@ GST_DEBUG_CATEGORY_STATIC (gst_gauss_blur_debug);
 #define CAPS_STR_RGB GST_VIDEO_CAPS_xRGB ";" GST_VIDEO_CAPS_xBGR
 #endif
 
-#define CAPS_STR GST_VIDEO_CAPS_YUV("AYUV")
+#define CAPS_STR GST_VIDEO_CAPS_YUV("{ AYUV, I420, YV12, NV12 }")
 
 /* The capabilities of the inputs and outputs. */
 static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE ("sink",
@@ -48,17 +51,71 @@ enum
 {
   PROP_0,
   PROP_SIGMA,
+  PROP_RADIUS,
+  PROP_THREADS,
   PROP_LAST
 };
 
+/*
+ * The blur is separable: every row is first blurred horizontally into a
+ * ring of 16 bit lines, and the output rows are then blurred vertically from
+ * the lines in the ring. Each pass works along whole rows, so the vertical
+ * pass never walks down columns of the frame.
+ *
+ * Small sigmas use the exact gaussian with 4.12 fixed point weights, one
+ * multiply-accumulate pass over the row per pair of symmetric taps. Larger
+ * blurs are approximated by three successive box blurs, which are computed
+ * with running sums so that their cost does not depend on the radius.
+ */
+
+/* 1.0 in the fixed point weights */
+#define WEIGHT_SHIFT 12
+/* blurs with a sigma from here on use the box approximation */
+#define BOX_BLUR_MIN_SIGMA 3.0
+
+/* rows in a ring: rows are stored at lines[row % n_lines] */
+typedef struct
+{
+  gpointer *lines;
+  gint n_lines;
+  /* last row in the ring, -1 if empty */
+  gint last;
+} GaussBlurRing;
+
+struct GaussBlurSlice
+{
+  guint index, n_slices;
+  const guint8 *input;
+  guint8 *output;
+
+  guint8 *scratch;
+  gsize scratch_size;
+
+  /* exact gaussian: input row with replicated edges, and accumulators */
+  guint8 *padded;
+  gint32 *acc;
+
+  /* box blur: horizontal pass lines and vertical running sums */
+  guint16 *hlines[2];
+  guint32 *sums[3];
+
+  /* horizontally blurred rows, then the output of the vertical box passes */
+  GaussBlurRing rings[4];
+};
+
 static void cleanup (GaussBlur * gb);
-static gboolean make_gaussian_kernel (GaussBlur * gb, float sigma);
-static void gaussian_smooth (GaussBlur * gb, guint8 * image,
-    guint8 * out_image);
+static gboolean make_gaussian_kernel (GaussBlurKernel * kernel, float sigma,
+    guint radius);
+static void gauss_blur_slice_func (gpointer data, gpointer user_data);
 
 GST_BOILERPLATE (GaussBlur, gauss_blur, GstVideoFilter, GST_TYPE_VIDEO_FILTER);
 
 #define DEFAULT_SIGMA 1.2
+#define DEFAULT_RADIUS 0
+#define DEFAULT_THREADS 0
+
+/* minimum number of rows per slice */
+#define MIN_SLICE_ROWS 16
 
 static void
 gauss_blur_base_init (gpointer gclass)
@@ -85,6 +142,7 @@ gauss_blur_class_init (GaussBlurClass * klass)
 
   object_class->set_property = gauss_blur_set_property;
   object_class->get_property = gauss_blur_get_property;
+  object_class->finalize = gauss_blur_finalize;
 
   trans_class->stop = gauss_blur_stop;
   trans_class->set_caps = gauss_blur_set_caps;
@@ -93,8 +151,16 @@ gauss_blur_class_init (GaussBlurClass * klass)
   g_object_class_install_property (object_class, PROP_SIGMA,
       g_param_spec_double ("sigma", "Sigma",
           "Sigma value for gaussian blur (negative for sharpen)",
-          -20.0, 20.0, DEFAULT_SIGMA,
+          -20.0, 100.0, DEFAULT_SIGMA,
+          G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (object_class, PROP_RADIUS,
+      g_param_spec_uint ("radius", "Radius",
+          "Radius of the gaussian kernel in pixels (0 = 2.5 times sigma, "
+          "approximating large blurs with box blurs)",
+          0, 250, DEFAULT_RADIUS,
           G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (object_class, PROP_THREADS,
+      gst_base_video_slices_param_spec_threads ());
 }
 
 static void
@@ -102,21 +168,46 @@ gauss_blur_init (GaussBlur * gb, GaussBlurClass * gclass)
 {
   gb->sigma = DEFAULT_SIGMA;
   gb->cur_sigma = -1.0;
+  gb->radius = DEFAULT_RADIUS;
+  gb->threads = DEFAULT_THREADS;
+  gb->slices = g_new0 (GaussBlurSlice, GST_BASE_VIDEO_SLICES_MAX_THREADS);
+}
+
+static void
+gauss_blur_finalize (GObject * object)
+{
+  GaussBlur *gb = GAUSS_BLUR (object);
+
+  cleanup (gb);
+  g_free (gb->slices);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+free_kernel (GaussBlurKernel * kernel)
+{
+  g_free (kernel->weights);
+  memset (kernel, 0, sizeof (GaussBlurKernel));
 }
 
 static void
 cleanup (GaussBlur * gb)
 {
-  g_free (gb->tempim);
-  gb->tempim = NULL;
+  guint i;
 
-  g_free (gb->smoothedim);
-  gb->smoothedim = NULL;
+  if (gb->slice_pool) {
+    gst_base_video_slices_free (gb->slice_pool);
+    gb->slice_pool = NULL;
+  }
+  for (i = 0; i < GST_BASE_VIDEO_SLICES_MAX_THREADS; i++) {
+    g_free (gb->slices[i].scratch);
+    gb->slices[i].scratch = NULL;
+    gb->slices[i].scratch_size = 0;
+  }
 
-  g_free (gb->kernel);
-  gb->kernel = NULL;
-  g_free (gb->kernel_sum);
-  gb->kernel_sum = NULL;
+  free_kernel (&gb->kernels[0]);
+  free_kernel (&gb->kernels[1]);
 }
 
 static gboolean
@@ -136,7 +227,7 @@ gauss_blur_set_caps (GstBaseTransform * btrans,
   GaussBlur *gb = GAUSS_BLUR (btrans);
   GstStructure *structure;
   GstVideoFormat format;
-  guint32 n_elems;
+  gint i;
 
   structure = gst_caps_get_structure (incaps, 0);
   g_return_val_if_fail (structure != NULL, FALSE);
@@ -146,15 +237,372 @@ gauss_blur_set_caps (GstBaseTransform * btrans,
 
   /* get stride */
   gb->stride = gst_video_format_get_row_stride (format, 0, gb->width);
+  gb->format = format;
 
-  n_elems = gb->stride * gb->height;
+  /* the components of AYUV are blurred together, the chroma planes of the
+   * subsampled formats with a kernel of half the size */
+  switch (format) {
+    case GST_VIDEO_FORMAT_AYUV:
+      gb->n_planes = 1;
+      break;
+    case GST_VIDEO_FORMAT_NV12:
+      gb->n_planes = 2;
+      break;
+    default:
+      gb->n_planes = 3;
+      break;
+  }
 
-  gb->tempim = g_malloc (sizeof (gfloat) * n_elems);
-  //gb->smoothedim = g_malloc (sizeof (guint16) * n_elems);
+  for (i = 0; i < gb->n_planes; i++) {
+    GaussBlurPlane *plane = &gb->planes[i];
+
+    plane->offset = gst_video_format_get_component_offset (format, i,
+        gb->width, gb->height);
+    plane->stride = gst_video_format_get_row_stride (format, i, gb->width);
+    plane->width = gst_video_format_get_component_width (format, i, gb->width);
+    plane->height = gst_video_format_get_component_height (format, i,
+        gb->height);
+    plane->channels = 1;
+    plane->kernel = i > 0 ? 1 : 0;
+  }
+  if (format == GST_VIDEO_FORMAT_AYUV) {
+    gb->planes[0].offset = 0;
+    gb->planes[0].channels = 4;
+  } else if (format == GST_VIDEO_FORMAT_NV12) {
+    gb->planes[1].channels = 2;
+  }
 
   return TRUE;
 }
 
+/* 2^32 / n rounded up, for dividing running sums of up to 20 bits by n */
+static guint32
+box_inverse (gint radius)
+{
+  guint64 n = 2 * radius + 1;
+
+  return (G_GUINT64_CONSTANT (1) << 32) / n + 1;
+}
+
+/* bytes of scratch memory a slice needs to blur lines of up to @line
+ * samples with @kernel */
+static gsize
+kernel_scratch_size (const GaussBlurKernel * kernel, gint line)
+{
+  gint i, n_lines;
+  gsize size;
+
+  if (kernel->box_radius[0] == 0) {
+    n_lines = 2 * kernel->radius + 1;
+    size = GST_ROUND_UP_16 (line + 8 * kernel->radius) + 4 * line;
+  } else {
+    n_lines = 1;
+    for (i = 0; i < 3; i++)
+      n_lines += 2 * kernel->box_radius[i] + 2;
+    size = 2 * 2 * line + 3 * 4 * line;
+  }
+
+  return size + n_lines * (2 * line + sizeof (gpointer));
+}
+
+/* lays out the scratch memory of the slice for blurring with @kernel and
+ * empties the rings */
+static void
+gauss_blur_slice_setup (GaussBlurSlice * slice,
+    const GaussBlurKernel * kernel, gint line)
+{
+  guint8 *mem = slice->scratch;
+  gint n_rings, n_lines[4];
+  gpointer *ptrs;
+  gint i, j;
+
+  if (kernel->box_radius[0] == 0) {
+    slice->padded = mem;
+    mem += GST_ROUND_UP_16 (line + 8 * kernel->radius);
+    slice->acc = (gint32 *) mem;
+    mem += 4 * line;
+    /* all the rows the vertical taps of an output row read */
+    n_rings = 1;
+    n_lines[0] = 2 * kernel->radius + 1;
+  } else {
+    for (i = 0; i < 2; i++, mem += 2 * line)
+      slice->hlines[i] = (guint16 *) mem;
+    for (i = 0; i < 3; i++, mem += 4 * line)
+      slice->sums[i] = (guint32 *) mem;
+    /* each ring holds the rows the next vertical pass sums over, plus the
+     * one that is subtracted from the running sum, so the rows the passes
+     * ask for are always still in it */
+    n_rings = 4;
+    for (i = 0; i < 3; i++)
+      n_lines[i] = 2 * kernel->box_radius[i] + 2;
+    n_lines[3] = 1;
+  }
+
+  /* the lines of all rings, followed by the line pointers */
+  for (i = 0, j = 0; i < n_rings; i++)
+    j += n_lines[i];
+  ptrs = (gpointer *) (mem + j * 2 * line);
+
+  for (i = 0; i < n_rings; i++) {
+    GaussBlurRing *ring = &slice->rings[i];
+
+    ring->lines = ptrs;
+    ring->n_lines = n_lines[i];
+    ring->last = -1;
+    for (j = 0; j < n_lines[i]; j++, mem += 2 * line)
+      *ptrs++ = mem;
+  }
+}
+
+/* blurs row @y of the plane horizontally with the exact gaussian */
+static void
+gauss_blur_row_h (GaussBlurSlice * slice, const GaussBlurKernel * kernel,
+    const GaussBlurPlane * plane, gint y, gint16 * dest)
+{
+  const guint8 *src = slice->input + plane->offset + y * plane->stride;
+  gint ch = plane->channels;
+  gint n = plane->width * ch;
+  guint8 *row = slice->padded + 4 * kernel->radius;
+  gint k;
+
+  /* replicate the edge pixels so that all taps read valid samples */
+  memcpy (row, src, n);
+  for (k = 1; k <= kernel->radius; k++) {
+    memcpy (row - k * ch, src, ch);
+    memcpy (row + n + (k - 1) * ch, src + n - ch, ch);
+  }
+
+  gaussblur_orc_h_init (slice->acc, row, kernel->weights[0], n);
+  for (k = 1; k <= kernel->radius; k++)
+    gaussblur_orc_h_mac2 (slice->acc, row - k * ch, row + k * ch,
+        kernel->weights[k], n);
+  gaussblur_orc_h_finish (dest, slice->acc, n);
+}
+
+static const gint16 *
+gauss_blur_get_row_h (GaussBlurSlice * slice, const GaussBlurKernel * kernel,
+    const GaussBlurPlane * plane, gint y)
+{
+  GaussBlurRing *ring = &slice->rings[0];
+
+  y = CLAMP (y, 0, plane->height - 1);
+  if (ring->last < 0)
+    ring->last = y - 1;
+  while (ring->last < y) {
+    ring->last++;
+    gauss_blur_row_h (slice, kernel, plane, ring->last,
+        ring->lines[ring->last % ring->n_lines]);
+  }
+
+  return ring->lines[y % ring->n_lines];
+}
+
+static void
+gauss_blur_plane_gaussian (GaussBlurSlice * slice,
+    const GaussBlurKernel * kernel, const GaussBlurPlane * plane,
+    gint start, gint end)
+{
+  gint n = plane->width * plane->channels;
+  gint y, k;
+
+  /* the ring is filled from the first row the slice needs */
+  gauss_blur_get_row_h (slice, kernel, plane, start - kernel->radius);
+
+  for (y = start; y < end; y++) {
+    guint8 *out_row = slice->output + plane->offset + y * plane->stride;
+
+    gauss_blur_get_row_h (slice, kernel, plane, y + kernel->radius);
+
+    gaussblur_orc_v_init (slice->acc,
+        gauss_blur_get_row_h (slice, kernel, plane, y),
+        kernel->weights[0], n);
+    for (k = 1; k <= kernel->radius; k++)
+      gaussblur_orc_v_mac2 (slice->acc,
+          gauss_blur_get_row_h (slice, kernel, plane, y - k),
+          gauss_blur_get_row_h (slice, kernel, plane, y + k),
+          kernel->weights[k], n);
+    gaussblur_orc_v_finish (out_row, slice->acc, n);
+  }
+}
+
+/* one box blur of a line of 16 bit samples with replicated edges */
+static void
+box_blur_line (guint16 * dest, const guint16 * src, gint width,
+    gint channels, gint radius)
+{
+  guint32 inv = box_inverse (radius);
+  guint32 sums[4];
+  gint x, c;
+
+  for (c = 0; c < channels; c++) {
+    sums[c] = (radius + 1) * src[c];
+    for (x = 1; x <= radius; x++)
+      sums[c] += src[MIN (x, width - 1) * channels + c];
+  }
+
+  for (x = 0; x < width; x++) {
+    const guint16 *add = src + MIN (x + radius + 1, width - 1) * channels;
+    const guint16 *sub = src + MAX (x - radius, 0) * channels;
+
+    for (c = 0; c < channels; c++) {
+      dest[x * channels + c] = ((guint64) (sums[c] + radius) * inv) >> 32;
+      sums[c] += add[c] - sub[c];
+    }
+  }
+}
+
+/* blurs row @y of the plane horizontally with the three box blurs */
+static void
+gauss_blur_box_row_h (GaussBlurSlice * slice, const GaussBlurKernel * kernel,
+    const GaussBlurPlane * plane, gint y, guint16 * dest)
+{
+  const guint8 *src = slice->input + plane->offset + y * plane->stride;
+  guint16 *a = slice->hlines[0], *b = slice->hlines[1];
+  gint ch = plane->channels;
+
+  gaussblur_orc_box_load (a, src, plane->width * ch);
+  box_blur_line (b, a, plane->width, ch, kernel->box_radius[0]);
+  box_blur_line (a, b, plane->width, ch, kernel->box_radius[1]);
+  box_blur_line (dest, a, plane->width, ch, kernel->box_radius[2]);
+}
+
+/* returns row @y after @pass vertical box blurs, producing the rows that
+ * are not in the ring yet from the rows of the previous pass */
+static const guint16 *
+gauss_blur_box_get_row (GaussBlurSlice * slice,
+    const GaussBlurKernel * kernel, const GaussBlurPlane * plane, gint pass,
+    gint y)
+{
+  GaussBlurRing *ring = &slice->rings[pass];
+  gint n = plane->width * plane->channels;
+
+  y = CLAMP (y, 0, plane->height - 1);
+  while (ring->last < y) {
+    gint row = ring->last < 0 ? y : ring->last + 1;
+    guint16 *line = ring->lines[row % ring->n_lines];
+
+    if (pass == 0) {
+      gauss_blur_box_row_h (slice, kernel, plane, row, line);
+    } else {
+      gint radius = kernel->box_radius[pass - 1];
+      guint32 *sum = slice->sums[pass - 1];
+      gint inv = box_inverse (radius);
+
+      if (ring->last < 0) {
+        gint j;
+
+        gaussblur_orc_box_sum_init (sum, gauss_blur_box_get_row (slice,
+                kernel, plane, pass - 1, row - radius), n);
+        for (j = row - radius + 1; j <= row + radius; j++)
+          gaussblur_orc_box_sum_add (sum, gauss_blur_box_get_row (slice,
+                  kernel, plane, pass - 1, j), n);
+        gaussblur_orc_box_normalize (line, sum, inv, radius, n);
+      } else {
+        const guint16 *add, *sub;
+
+        add = gauss_blur_box_get_row (slice, kernel, plane, pass - 1,
+            row + radius);
+        sub = gauss_blur_box_get_row (slice, kernel, plane, pass - 1,
+            row - radius - 1);
+        gaussblur_orc_box_step (line, sum, add, sub, inv, radius, n);
+      }
+    }
+    ring->last = row;
+  }
+
+  return ring->lines[y % ring->n_lines];
+}
+
+static void
+gauss_blur_plane_box (GaussBlurSlice * slice, const GaussBlurKernel * kernel,
+    const GaussBlurPlane * plane, gint start, gint end)
+{
+  gint n = plane->width * plane->channels;
+  gint y;
+
+  for (y = start; y < end; y++) {
+    guint8 *out_row = slice->output + plane->offset + y * plane->stride;
+
+    gaussblur_orc_box_store (out_row,
+        gauss_blur_box_get_row (slice, kernel, plane, 3, y), n);
+  }
+}
+
+/* largest number of samples in a row of any plane */
+static gint
+gauss_blur_get_line_size (GaussBlur * gb)
+{
+  gint i, line = 0;
+
+  for (i = 0; i < gb->n_planes; i++)
+    line = MAX (line, gb->planes[i].width * gb->planes[i].channels);
+
+  return GST_ROUND_UP_16 (line);
+}
+
+/* blurs the rows of every plane that belong to the slice */
+static void
+gauss_blur_process_slice (GaussBlur * gb, GaussBlurSlice * slice)
+{
+  gint line = gauss_blur_get_line_size (gb);
+  gint i;
+
+  for (i = 0; i < gb->n_planes; i++) {
+    const GaussBlurPlane *plane = &gb->planes[i];
+    const GaussBlurKernel *kernel = &gb->kernels[plane->kernel];
+    gint start = plane->height * slice->index / slice->n_slices;
+    gint end = plane->height * (slice->index + 1) / slice->n_slices;
+
+    if (start >= end)
+      continue;
+
+    gauss_blur_slice_setup (slice, kernel, line);
+    if (kernel->box_radius[0] == 0)
+      gauss_blur_plane_gaussian (slice, kernel, plane, start, end);
+    else
+      gauss_blur_plane_box (slice, kernel, plane, start, end);
+  }
+}
+
+static void
+gauss_blur_slice_func (gpointer data, gpointer user_data)
+{
+  gauss_blur_process_slice (user_data, data);
+}
+
+/* three box blurs approximating a gaussian, with box sizes chosen so that
+ * their combined variance is as close as possible to sigma^2 */
+static void
+make_box_kernel (GaussBlurKernel * kernel, float sigma)
+{
+  gint wl, m, i;
+
+  wl = floor (sqrt (4.0 * sigma * sigma + 1.0));
+  if (wl % 2 == 0)
+    wl--;
+  m = floor ((12.0 * sigma * sigma - 3 * wl * wl - 12 * wl - 9) /
+      (-4.0 * wl - 4) + 0.5);
+  m = CLAMP (m, 0, 3);
+
+  for (i = 0; i < 3; i++)
+    kernel->box_radius[i] = ((i < m ? wl : wl + 2) - 1) / 2;
+  kernel->radius = kernel->box_radius[0] + kernel->box_radius[1] +
+      kernel->box_radius[2];
+}
+
+static gboolean
+make_kernel (GaussBlurKernel * kernel, float sigma, guint radius)
+{
+  free_kernel (kernel);
+
+  if (radius == 0 && sigma >= BOX_BLUR_MIN_SIGMA) {
+    make_box_kernel (kernel, sigma);
+    return TRUE;
+  }
+
+  return make_gaussian_kernel (kernel, sigma, radius);
+}
+
 static GstFlowReturn
 gauss_blur_process_frame (GstBaseTransform * btrans,
     GstBuffer * in_buf, GstBuffer * out_buf)
@@ -163,6 +611,9 @@ gauss_blur_process_frame (GstBaseTransform * btrans,
   GstClockTime timestamp;
   gint64 stream_time;
   gfloat sigma;
+  guint radius, threads, i, n_slices;
+  gsize scratch_size;
+  gint line;
 
   /* GstController: update the properties */
   timestamp = GST_BUFFER_TIMESTAMP (in_buf);
@@ -173,192 +624,125 @@ gauss_blur_process_frame (GstBaseTransform * btrans,
 
   GST_OBJECT_LOCK (gb);
   sigma = gb->sigma;
+  radius = gb->radius;
+  threads = gb->threads;
   GST_OBJECT_UNLOCK (gb);
 
-  if (gb->cur_sigma != sigma) {
-    g_free (gb->kernel);
-    gb->kernel = NULL;
-    g_free (gb->kernel_sum);
-    gb->kernel_sum = NULL;
+  if (gb->cur_sigma != sigma || gb->cur_radius != radius) {
+    free_kernel (&gb->kernels[0]);
+    free_kernel (&gb->kernels[1]);
     gb->cur_sigma = sigma;
+    gb->cur_radius = radius;
   }
-  if (gb->kernel == NULL && !make_gaussian_kernel (gb, gb->cur_sigma)) {
-    GST_ELEMENT_ERROR (btrans, RESOURCE, NO_SPACE_LEFT, ("Out of memory"),
-        ("Failed to allocation gaussian kernel"));
-    return GST_FLOW_ERROR;
+  if (gb->kernels[0].weights == NULL && gb->kernels[0].box_radius[0] == 0) {
+    if (!make_kernel (&gb->kernels[0], gb->cur_sigma, gb->cur_radius) ||
+        !make_kernel (&gb->kernels[1], gb->cur_sigma / 2,
+            (gb->cur_radius + 1) / 2)) {
+      GST_ELEMENT_ERROR (btrans, RESOURCE, NO_SPACE_LEFT, ("Out of memory"),
+          ("Failed to allocation gaussian kernel"));
+      return GST_FLOW_ERROR;
+    }
+    GST_DEBUG_OBJECT (gb, "sigma %f: radius %d, boxes %d %d %d", sigma,
+        gb->kernels[0].radius, gb->kernels[0].box_radius[0],
+        gb->kernels[0].box_radius[1], gb->kernels[0].box_radius[2]);
   }
 
+  if (gb->slice_pool == NULL)
+    gb->slice_pool = gst_base_video_slices_new (gauss_blur_slice_func, gb);
+  n_slices = gst_base_video_slices_prepare (gb->slice_pool, threads,
+      gb->height, MIN_SLICE_ROWS);
+
+  line = gauss_blur_get_line_size (gb);
+  scratch_size = kernel_scratch_size (&gb->kernels[0], line);
+  if (gb->n_planes > 1)
+    scratch_size = MAX (scratch_size,
+        kernel_scratch_size (&gb->kernels[1], line));
+
   /*
    * Perform gaussian smoothing on the image using the input standard
    * deviation.
    */
-  memcpy (GST_BUFFER_DATA (out_buf), GST_BUFFER_DATA (in_buf),
-      gb->height * gb->stride);
-  gaussian_smooth (gb, GST_BUFFER_DATA (in_buf), GST_BUFFER_DATA (out_buf));
+  for (i = 0; i < n_slices; i++) {
+    GaussBlurSlice *slice = &gb->slices[i];
 
-  return GST_FLOW_OK;
-}
-
-static void
-blur_row_x (GaussBlur * gb, guint8 * in_row, gfloat * out_row)
-{
-  int c, cc, center;
-  float dot[4], sum;
-  int k, kmin, kmax;
-
-  center = gb->windowsize / 2;
-
-  for (c = 0; c < gb->width; c++) {
-    /* Calculate min */
-    cc = center - c;
-    kmin = MAX (0, cc);
-    cc = kmin - cc;
-    /* Calc max */
-    kmax = MIN (gb->windowsize, gb->width - cc);
-    cc *= 4;
-
-    dot[0] = dot[1] = dot[2] = dot[3] = 0.0;
-    /* Calculate sum for range */
-    sum = gb->kernel_sum[kmax - 1];
-    sum -= kmin ? gb->kernel_sum[kmin - 1] : 0.0;
-
-    for (k = kmin; k < kmax; k++) {
-      float coeff = gb->kernel[k];
-      dot[0] += (float) in_row[cc++] * coeff;
-      dot[1] += (float) in_row[cc++] * coeff;
-      dot[2] += (float) in_row[cc++] * coeff;
-      dot[3] += (float) in_row[cc++] * coeff;
+    if (slice->scratch_size < scratch_size) {
+      g_free (slice->scratch);
+      slice->scratch = g_malloc (scratch_size);
+      slice->scratch_size = scratch_size;
     }
-
-    out_row[c * 4] = dot[0] / sum;
-    out_row[c * 4 + 1] = dot[1] / sum;
-    out_row[c * 4 + 2] = dot[2] / sum;
-    out_row[c * 4 + 3] = dot[3] / sum;
+    slice->index = i;
+    slice->n_slices = n_slices;
+    slice->input = GST_BUFFER_DATA (in_buf);
+    slice->output = GST_BUFFER_DATA (out_buf);
   }
-}
-
-static void
-gaussian_smooth (GaussBlur * gb, guint8 * image, guint8 * out_image)
-{
-  int r, c, rr, center;
-  float dot[4], sum;
-  int k, kmin, kmax;
-  guint8 *in_row = image;
-  float *tmp_out_row = gb->tempim;
-  float *tmp_in_pos;
-  gint y_avail = 0;
-  guint8 *out_row;
-
-  /* Apply the gaussian kernel */
-  center = gb->windowsize / 2;
-
-  /* Blur in the y - direction. */
-  for (r = 0; r < gb->height; r++) {
-    /* Calculate input row range */
-    rr = center - r;
-    kmin = MAX (0, rr);
-    rr = kmin - rr;
-    /* Calc max */
-    kmax = MIN (gb->windowsize, gb->height - rr);
-
-    /* Precalculate sum for range */
-    sum = gb->kernel_sum[kmax - 1];
-    sum -= kmin ? gb->kernel_sum[kmin - 1] : 0.0;
-
-    /* Blur more input rows (x direction blur) */
-    while (y_avail <= (r + center) && y_avail < gb->height) {
-      blur_row_x (gb, in_row, tmp_out_row);
-      in_row += gb->stride;
-      tmp_out_row += gb->stride;
-      y_avail++;
-    }
-
-    tmp_in_pos = gb->tempim + (rr * gb->stride);
-    out_row = out_image + r * gb->stride;
 
-    for (c = 0; c < gb->width; c++) {
-      float *tmp = tmp_in_pos;
-
-      dot[0] = dot[1] = dot[2] = dot[3] = 0.0;
-      for (k = kmin; k < kmax; k++, tmp += gb->stride) {
-        float kern = gb->kernel[k];
-        dot[0] += tmp[0] * kern;
-        dot[1] += tmp[1] * kern;
-        dot[2] += tmp[2] * kern;
-        dot[3] += tmp[3] * kern;
-      }
+  gst_base_video_slices_run (gb->slice_pool, gb->slices,
+      sizeof (GaussBlurSlice), n_slices);
 
-      *out_row++ = (guint8) CLAMP ((dot[0] / sum + 0.5), 0, 255);
-      *out_row++ = (guint8) CLAMP ((dot[1] / sum + 0.5), 0, 255);
-      *out_row++ = (guint8) CLAMP ((dot[2] / sum + 0.5), 0, 255);
-      *out_row++ = (guint8) CLAMP ((dot[3] / sum + 0.5), 0, 255);
-
-      tmp_in_pos += 4;
-    }
-  }
+  return GST_FLOW_OK;
 }
 
 /*
  * Create a one dimensional gaussian kernel.
  */
 static gboolean
-make_gaussian_kernel (GaussBlur * gb, float sigma)
+make_gaussian_kernel (GaussBlurKernel * kernel, float sigma, guint radius)
 {
-  int i, center, left, right;
-  float sum, sum2;
-  const float fe = -0.5 / (sigma * sigma);
-  const float dx = 1.0 / (sigma * sqrt (2 * G_PI));
+  gdouble *coeffs;
+  gdouble sum;
+  gint i, total;
 
-  center = ceil (2.5 * fabs (sigma));
-  gb->windowsize = (int) (1 + 2 * center);
+  if (radius == 0)
+    radius = ceil (2.5 * fabs (sigma));
 
-  gb->kernel = g_new (float, gb->windowsize);
-  gb->kernel_sum = g_new (float, gb->windowsize);
-  if (gb->kernel == NULL || gb->kernel_sum == NULL)
+  kernel->weights = g_new (gint16, radius + 1);
+  if (kernel->weights == NULL)
     return FALSE;
 
-  if (gb->windowsize == 1) {
-    gb->kernel[0] = 1.0;
-    gb->kernel_sum[0] = 1.0;
+  if (radius == 0) {
+    kernel->radius = 0;
+    kernel->weights[0] = 1 << WEIGHT_SHIFT;
     return TRUE;
   }
 
-  /* Center co-efficient */
-  sum = gb->kernel[center] = dx;
+  coeffs = g_new (gdouble, radius + 1);
 
-  /* Other coefficients */
-  left = center - 1;
-  right = center + 1;
-  for (i = 1; i <= center; i++, left--, right++) {
-    float fx = dx * pow (G_E, fe * i * i);
-    gb->kernel[right] = gb->kernel[left] = fx;
-    sum += 2 * fx;
+  sum = coeffs[0] = 1.0;
+  for (i = 1; i <= radius; i++) {
+    coeffs[i] = exp (-0.5 * i * i / (sigma * sigma));
+    sum += 2 * coeffs[i];
   }
+  for (i = 0; i <= radius; i++)
+    coeffs[i] /= sum;
 
+  /* sharpening subtracts the blur from twice the image */
   if (sigma < 0) {
-    sum = -sum;
-    gb->kernel[center] += 2.0 * sum;
+    for (i = 0; i <= radius; i++)
+      coeffs[i] = -coeffs[i];
+    coeffs[0] += 2.0;
   }
 
-  for (i = 0; i < gb->windowsize; i++)
-    gb->kernel[i] /= sum;
-
-  sum2 = 0.0;
-  for (i = 0; i < gb->windowsize; i++) {
-    sum2 += gb->kernel[i];
-    gb->kernel_sum[i] = sum2;
+  /* convert to fixed point, dropping the outer taps that round to zero and
+   * putting the rounding error into the centre so that the weights still
+   * add up to one */
+  kernel->radius = 0;
+  total = 0;
+  for (i = 1; i <= radius; i++) {
+    kernel->weights[i] = floor (coeffs[i] * (1 << WEIGHT_SHIFT) + 0.5);
+    if (kernel->weights[i] != 0)
+      kernel->radius = i;
   }
+  for (i = 1; i <= kernel->radius; i++)
+    total += 2 * kernel->weights[i];
+  kernel->weights[0] = (1 << WEIGHT_SHIFT) - total;
+
+  g_free (coeffs);
 
 #if 0
   g_print ("Sigma %f: ", sigma);
-  for (i = 0; i < gb->windowsize; i++)
-    g_print ("%f ", gb->kernel[i]);
-  g_print ("\n");
-  g_print ("sums: ");
-  for (i = 0; i < gb->windowsize; i++)
-    g_print ("%f ", gb->kernel_sum[i]);
+  for (i = 0; i <= kernel->radius; i++)
+    g_print ("%d ", kernel->weights[i]);
   g_print ("\n");
-  g_print ("sum %f sum2 %f\n", sum, sum2);
 #endif
 
   return TRUE;
@@ -375,6 +759,16 @@ gauss_blur_set_property (GObject * object,
       gb->sigma = g_value_get_double (value);
       GST_OBJECT_UNLOCK (object);
       break;
+    case PROP_RADIUS:
+      GST_OBJECT_LOCK (object);
+      gb->radius = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    case PROP_THREADS:
+      GST_OBJECT_LOCK (object);
+      gb->threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -392,6 +786,16 @@ gauss_blur_get_property (GObject * object,
       g_value_set_double (value, gb->sigma);
       GST_OBJECT_UNLOCK (gb);
       break;
+    case PROP_RADIUS:
+      GST_OBJECT_LOCK (gb);
+      g_value_set_uint (value, gb->radius);
+      GST_OBJECT_UNLOCK (gb);
+      break;
+    case PROP_THREADS:
+      GST_OBJECT_LOCK (gb);
+      g_value_set_uint (value, gb->threads);
+      GST_OBJECT_UNLOCK (gb);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
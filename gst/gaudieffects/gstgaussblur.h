@@ -4,6 +4,7 @@
 #include <gst/gst.h>
 #include <gst/video/video.h>
 #include <gst/video/gstvideofilter.h>
+#include <gst/video/gstbasevideoslices.h>
 
 G_BEGIN_DECLS
 
@@ -13,19 +14,49 @@ G_BEGIN_DECLS
 
 typedef struct GaussBlur GaussBlur;
 typedef struct GaussBlurClass GaussBlurClass;
+typedef struct GaussBlurSlice GaussBlurSlice;
+
+/* a one dimensional blur, applied horizontally and vertically. Either an
+ * exact gaussian with fixed point weights, or three box blurs */
+typedef struct
+{
+  /* weights[0] is the centre tap, weights[k] the taps at +-k */
+  gint radius;
+  gint16 *weights;
+
+  /* radii of the box blurs, all 0 for the exact gaussian */
+  gint box_radius[3];
+} GaussBlurKernel;
+
+typedef struct
+{
+  gint offset, stride;
+  gint width, height;
+  /* number of interleaved components */
+  gint channels;
+  /* index of the kernel the plane is blurred with */
+  gint kernel;
+} GaussBlurPlane;
 
 struct GaussBlur
 {
   GstVideoFilter videofilter;
   gint width, height, stride;
 
+  GstVideoFormat format;
+  GaussBlurPlane planes[3];
+  gint n_planes;
+
   float cur_sigma, sigma;
-  int windowsize;
+  guint cur_radius, radius;
+  guint threads;
+
+  /* for full resolution and for subsampled chroma planes */
+  GaussBlurKernel kernels[2];
 
-  float *kernel;
-  float *kernel_sum;
-  float *tempim;
-  gint16 *smoothedim;
+  /* slice threading, one slice per thread at most */
+  GaussBlurSlice *slices;
+  GstBaseVideoSlices *slice_pool;
 };
 
 struct GaussBlurClass
@@ -51,6 +51,7 @@
 #include <gst/controller/gstcontroller.h>
 
 #include "gstplugin.h"
+#include "gstgaudieffectsorc.h"
 
 /* PACKAGE: this is usually set by autotools depending on some _INIT macro
  * in configure.ac and then written into and defined in config.h, but we can
@@ -67,6 +68,7 @@ plugin_init (GstPlugin * plugin)
   gboolean ret = TRUE;
 
   gst_controller_init (NULL, NULL);
+  gst_gaudieffects_orc_init ();
 
   ret &= gst_burn_plugin_init (plugin);
   ret &= gst_chromium_plugin_init (plugin);
@@ -100,6 +100,13 @@ struct _GstInterlace
   int src_fps_n;
   int src_fps_d;
 
+  /* layout of the planes of a frame, packed formats have a single plane and
+   * the interleaved chroma of NV12/NV21 counts as one plane */
+  int n_planes;
+  int plane_offset[3];
+  int plane_stride[3];
+  int plane_height[3];
+
   GstBuffer *stored_frame;
   gint stored_fields;
   gint phase_index;
@@ -107,6 +114,10 @@ struct _GstInterlace
   GstClockTime timebase;
   int fields_since_timebase;
   guint pattern_offset;         /* initial offset into the pattern */
+
+  /* statistics */
+  guint64 bytes_copied;
+  guint64 frames_out;
 };
 
 struct _GstInterlaceClass
@@ -274,6 +285,8 @@ gst_interlace_reset (GstInterlace * interlace)
   interlace->phase_index = interlace->pattern_offset;
   interlace->timebase = GST_CLOCK_TIME_NONE;
   interlace->field_index = 0;
+  interlace->bytes_copied = 0;
+  interlace->frames_out = 0;
 }
 
 static void
@@ -338,6 +351,11 @@ gst_interlace_decorate_buffer (GstInterlace * interlace, GstBuffer * buf,
   /* increment the buffer timestamp by duration for the next buffer */
   gst_buffer_set_caps (buf, interlace->srccaps);
 
+  /* the buffer may be a reused upstream buffer still carrying its flags */
+  GST_BUFFER_FLAG_UNSET (buf, GST_VIDEO_BUFFER_TFF);
+  GST_BUFFER_FLAG_UNSET (buf, GST_VIDEO_BUFFER_RFF);
+  GST_BUFFER_FLAG_UNSET (buf, GST_VIDEO_BUFFER_ONEFIELD);
+
   if (interlace->field_index == 0) {
     GST_BUFFER_FLAG_SET (buf, GST_VIDEO_BUFFER_TFF);
   }
@@ -372,6 +390,9 @@ gst_interlace_sink_event (GstPad * pad, GstEvent * event)
       ret = gst_pad_push_event (interlace->srcpad, event);
       break;
     case GST_EVENT_EOS:
+      GST_INFO_OBJECT (interlace, "copied %" G_GUINT64_FORMAT " bytes for %"
+          G_GUINT64_FORMAT " output frames", interlace->bytes_copied,
+          interlace->frames_out);
 #if 0
       /* FIXME revive this when we output ONEFIELD and RFF buffers */
     {
@@ -460,6 +481,44 @@ gst_interlace_getcaps (GstPad * pad)
   return icaps;
 }
 
+static void
+gst_interlace_update_planes (GstInterlace * interlace)
+{
+  GstVideoFormat format = interlace->format;
+  int width = interlace->width;
+  int height = interlace->height;
+  int i;
+
+  switch (format) {
+    case GST_VIDEO_FORMAT_AYUV:
+    case GST_VIDEO_FORMAT_YUY2:
+    case GST_VIDEO_FORMAT_UYVY:
+      interlace->n_planes = 1;
+      break;
+    case GST_VIDEO_FORMAT_NV12:
+    case GST_VIDEO_FORMAT_NV21:
+      interlace->n_planes = 2;
+      break;
+    default:
+      interlace->n_planes = 3;
+      break;
+  }
+
+  for (i = 0; i < interlace->n_planes; i++) {
+    interlace->plane_offset[i] =
+        gst_video_format_get_component_offset (format, i, width, height);
+    interlace->plane_stride[i] =
+        gst_video_format_get_row_stride (format, i, width);
+    interlace->plane_height[i] =
+        gst_video_format_get_component_height (format, i, height);
+  }
+
+  /* V comes first in the interleaved chroma plane of NV21 */
+  if (format == GST_VIDEO_FORMAT_NV21)
+    interlace->plane_offset[1] =
+        gst_video_format_get_component_offset (format, 2, width, height);
+}
+
 static gboolean
 gst_interlace_setcaps (GstPad * pad, GstCaps * caps)
 {
@@ -505,6 +564,7 @@ gst_interlace_setcaps (GstPad * pad, GstCaps * caps)
   interlace->format = format;
   interlace->width = width;
   interlace->height = height;
+  gst_interlace_update_planes (interlace);
 
   interlace->phase_index = interlace->pattern_offset;
 
@@ -524,109 +584,32 @@ error:
   return ret;
 }
 
-static void
+/* copies every second line of each plane, starting at line field_index,
+ * and returns the number of bytes copied */
+static guint
 copy_field (GstInterlace * interlace, GstBuffer * d, GstBuffer * s,
     int field_index)
 {
-  int j;
-  guint8 *dest;
-  guint8 *src;
-  int width = interlace->width;
-  int height = interlace->height;
-
-  if (interlace->format == GST_VIDEO_FORMAT_I420 ||
-      interlace->format == GST_VIDEO_FORMAT_YV12) {
-    /* planar 4:2:0 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width;
-      src = GST_BUFFER_DATA (s) + j * width;
-      memcpy (dest, src, width);
+  int i, j;
+  guint copied = 0;
+
+  for (i = 0; i < interlace->n_planes; i++) {
+    int stride = interlace->plane_stride[i];
+    guint8 *dest = GST_BUFFER_DATA (d) + interlace->plane_offset[i];
+    guint8 *src = GST_BUFFER_DATA (s) + interlace->plane_offset[i];
+
+    dest += field_index * stride;
+    src += field_index * stride;
+    for (j = field_index; j < interlace->plane_height[i]; j += 2) {
+      memcpy (dest, src, stride);
+      dest += 2 * stride;
+      src += 2 * stride;
+      copied += stride;
     }
-    for (j = field_index; j < height / 2; j += 2) {
-      dest = GST_BUFFER_DATA (d) + width * height + j * width / 2;
-      src = GST_BUFFER_DATA (s) + width * height + j * width / 2;
-      memcpy (dest, src, width / 2);
-    }
-    for (j = field_index; j < height / 2; j += 2) {
-      dest =
-          GST_BUFFER_DATA (d) + width * height + width / 2 * height / 2 +
-          j * width / 2;
-      src =
-          GST_BUFFER_DATA (s) + width * height + width / 2 * height / 2 +
-          j * width / 2;
-      memcpy (dest, src, width / 2);
-    }
-  } else if (interlace->format == GST_VIDEO_FORMAT_UYVY ||
-      interlace->format == GST_VIDEO_FORMAT_YUY2) {
-    /* packed 4:2:2 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width * 2;
-      src = GST_BUFFER_DATA (s) + j * width * 2;
-      memcpy (dest, src, width * 2);
-    }
-  } else if (interlace->format == GST_VIDEO_FORMAT_AYUV) {
-    /* packed 4:4:4 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width * 4;
-      src = GST_BUFFER_DATA (s) + j * width * 4;
-      memcpy (dest, src, width * 4);
-    }
-  } else if (interlace->format == GST_VIDEO_FORMAT_Y42B) {
-    /* planar 4:2:2 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width;
-      src = GST_BUFFER_DATA (s) + j * width;
-      memcpy (dest, src, width);
-    }
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + width * height + j * width / 2;
-      src = GST_BUFFER_DATA (s) + width * height + j * width / 2;
-      memcpy (dest, src, width / 2);
-    }
-    for (j = field_index; j < height; j += 2) {
-      dest =
-          GST_BUFFER_DATA (d) + width * height + width / 2 * height +
-          j * width / 2;
-      src =
-          GST_BUFFER_DATA (s) + width * height + width / 2 * height +
-          j * width / 2;
-      memcpy (dest, src, width / 2);
-    }
-  } else if (interlace->format == GST_VIDEO_FORMAT_Y444) {
-    /* planar 4:4:4 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width;
-      src = GST_BUFFER_DATA (s) + j * width;
-      memcpy (dest, src, width);
-    }
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + width * height + j * width;
-      src = GST_BUFFER_DATA (s) + width * height + j * width;
-      memcpy (dest, src, width);
-    }
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + width * height + width * height + j * width;
-      src = GST_BUFFER_DATA (s) + width * height + width * height + j * width;
-      memcpy (dest, src, width);
-    }
-  } else if (interlace->format == GST_VIDEO_FORMAT_NV12 ||
-      interlace->format == GST_VIDEO_FORMAT_NV21) {
-    /* planar/packed 4:2:0 */
-    for (j = field_index; j < height; j += 2) {
-      dest = GST_BUFFER_DATA (d) + j * width;
-      src = GST_BUFFER_DATA (s) + j * width;
-      memcpy (dest, src, width);
-    }
-    for (j = field_index; j < height / 2; j += 2) {
-      dest = GST_BUFFER_DATA (d) + width * height + j * width;
-      src = GST_BUFFER_DATA (s) + width * height + j * width;
-      memcpy (dest, src, width);
-    }
-  } else {
-    g_assert_not_reached ();
   }
-}
 
+  return copied;
+}
 
 static GstFlowReturn
 gst_interlace_chain (GstPad * pad, GstBuffer * buffer)
@@ -694,6 +677,7 @@ gst_interlace_chain (GstPad * pad, GstBuffer * buffer)
   while (num_fields >= 2) {
     GstBuffer *output_buffer;
     int n_output_fields;
+    guint copied = 0;
 
     GST_DEBUG ("have %d fields, %d current, %d stored",
         num_fields, current_fields, interlace->stored_fields);
@@ -701,14 +685,32 @@ gst_interlace_chain (GstPad * pad, GstBuffer * buffer)
     if (interlace->stored_fields > 0) {
       GST_DEBUG ("1 field from stored, 1 from current");
 
-      output_buffer = gst_buffer_new_and_alloc (GST_BUFFER_SIZE (buffer));
-      /* take the first field from the stored frame */
-      copy_field (interlace, output_buffer, interlace->stored_frame,
-          interlace->field_index);
       interlace->stored_fields--;
-      /* take the second field from the incoming buffer */
-      copy_field (interlace, output_buffer, buffer, interlace->field_index ^ 1);
       current_fields--;
+
+      if (current_fields == 0 && gst_buffer_is_writable (buffer)) {
+        /* the incoming frame is not needed anymore, weave the first field
+         * from the stored frame into it */
+        output_buffer = buffer;
+        buffer = NULL;
+        copied = copy_field (interlace, output_buffer,
+            interlace->stored_frame, interlace->field_index);
+      } else if (gst_buffer_is_writable (interlace->stored_frame)) {
+        /* the stored frame has no fields left after this one, weave the
+         * second field from the incoming buffer into it */
+        output_buffer = interlace->stored_frame;
+        interlace->stored_frame = NULL;
+        copied = copy_field (interlace, output_buffer, buffer,
+            interlace->field_index ^ 1);
+      } else {
+        output_buffer = gst_buffer_new_and_alloc (GST_BUFFER_SIZE (buffer));
+        /* take the first field from the stored frame */
+        copied = copy_field (interlace, output_buffer, interlace->stored_frame,
+            interlace->field_index);
+        /* take the second field from the incoming buffer */
+        copied += copy_field (interlace, output_buffer, buffer,
+            interlace->field_index ^ 1);
+      }
       n_output_fields = 2;
     } else {
       output_buffer =
@@ -727,6 +729,10 @@ gst_interlace_chain (GstPad * pad, GstBuffer * buffer)
     }
     num_fields -= n_output_fields;
 
+    GST_LOG_OBJECT (interlace, "copied %u bytes for output frame", copied);
+    interlace->bytes_copied += copied;
+    interlace->frames_out++;
+
     gst_interlace_decorate_buffer (interlace, output_buffer, n_output_fields);
     interlace->fields_since_timebase += n_output_fields;
     interlace->field_index ^= (n_output_fields & 1);
@@ -759,7 +765,7 @@ gst_interlace_chain (GstPad * pad, GstBuffer * buffer)
   if (current_fields > 0) {
     interlace->stored_frame = buffer;
     interlace->stored_fields = current_fields;
-  } else {
+  } else if (buffer) {
     gst_buffer_unref (buffer);
   }
 
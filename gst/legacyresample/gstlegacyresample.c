@@ -52,13 +52,56 @@ GST_DEBUG_CATEGORY_STATIC (legacyresample_debug);
 #define GST_CAT_DEFAULT legacyresample_debug
 
 #define DEFAULT_FILTERLEN       16
+#define DEFAULT_PRESET          GST_LEGACYRESAMPLE_PRESET_REFERENCE
 
 enum
 {
   PROP_0,
-  PROP_FILTERLEN
+  PROP_FILTERLEN,
+  PROP_PRESET
 };
 
+/* indexed by GstLegacyresamplePreset, a filter length of 0 means the one
+ * of the filter-length property */
+static const struct
+{
+  ResampleMethod method;
+  gint filter_length;
+  gboolean antialias;
+} presets[] = {
+  {
+  RESAMPLE_METHOD_REF, 0, FALSE}, {
+  RESAMPLE_METHOD_POLYPHASE, 8, FALSE}, {
+  RESAMPLE_METHOD_POLYPHASE, 16, FALSE}, {
+  RESAMPLE_METHOD_POLYPHASE, 32, TRUE}, {
+  RESAMPLE_METHOD_POLYPHASE, 64, TRUE}
+};
+
+#define GST_TYPE_LEGACYRESAMPLE_PRESET (gst_legacyresample_preset_get_type ())
+static GType
+gst_legacyresample_preset_get_type (void)
+{
+  static GType preset_type = 0;
+  static const GEnumValue preset_values[] = {
+    {GST_LEGACYRESAMPLE_PRESET_REFERENCE,
+        "Reference filter of filter-length taps", "reference"},
+    {GST_LEGACYRESAMPLE_PRESET_FAST, "Fast, 8 taps filter bank", "fast"},
+    {GST_LEGACYRESAMPLE_PRESET_MEDIUM, "Medium, 16 taps filter bank",
+        "medium"},
+    {GST_LEGACYRESAMPLE_PRESET_HIGH,
+        "High, 32 taps band limited filter bank", "high"},
+    {GST_LEGACYRESAMPLE_PRESET_BEST,
+        "Best, 64 taps band limited filter bank", "best"},
+    {0, NULL, NULL},
+  };
+
+  if (!preset_type) {
+    preset_type =
+        g_enum_register_static ("GstLegacyresamplePreset", preset_values);
+  }
+  return preset_type;
+}
+
 #define SUPPORTED_CAPS \
 GST_STATIC_CAPS ( \
     "audio/x-raw-int, " \
@@ -100,6 +143,25 @@ static void gst_legacyresample_set_property (GObject * object,
 static void gst_legacyresample_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec);
 
+static gint
+legacyresample_get_filter_length (GstLegacyresample * legacyresample)
+{
+  if (presets[legacyresample->preset].filter_length)
+    return presets[legacyresample->preset].filter_length;
+
+  return legacyresample->filter_length;
+}
+
+static void
+legacyresample_configure_state (GstLegacyresample * legacyresample,
+    ResampleState * state)
+{
+  resample_set_filter_length (state,
+      legacyresample_get_filter_length (legacyresample));
+  resample_set_method (state, presets[legacyresample->preset].method);
+  resample_set_antialias (state, presets[legacyresample->preset].antialias);
+}
+
 /* vmethods */
 static gboolean legacyresample_get_unit_size (GstBaseTransform * base,
     GstCaps * caps, guint * size);
@@ -160,6 +222,23 @@ gst_legacyresample_class_init (GstLegacyresampleClass * klass)
           "Length of the resample filter", 0, G_MAXINT, DEFAULT_FILTERLEN,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstLegacyresample:preset
+   *
+   * Quality and speed of the resampler.  All the presets except the
+   * reference one precompute the filter for every phase of a rational
+   * resampling ratio and ignore the filter-length property.  Ratios of
+   * more than 4096 phases and 32 bit integer or 64 bit float samples always
+   * use the reference filter.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_PRESET,
+      g_param_spec_enum ("preset", "Preset",
+          "Quality and speed trade-off of the resampler",
+          GST_TYPE_LEGACYRESAMPLE_PRESET, DEFAULT_PRESET,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   GST_BASE_TRANSFORM_CLASS (klass)->start =
       GST_DEBUG_FUNCPTR (legacyresample_start);
   GST_BASE_TRANSFORM_CLASS (klass)->stop =
@@ -195,6 +274,7 @@ gst_legacyresample_init (GstLegacyresample * legacyresample,
   gst_pad_set_bufferalloc_function (trans->sinkpad, NULL);
 
   legacyresample->filter_length = DEFAULT_FILTERLEN;
+  legacyresample->preset = DEFAULT_PRESET;
 
   legacyresample->need_discont = FALSE;
 
@@ -213,8 +293,7 @@ legacyresample_start (GstBaseTransform * base)
   legacyresample->offset = -1;
   legacyresample->next_ts = -1;
 
-  resample_set_filter_length (legacyresample->resample,
-      legacyresample->filter_length);
+  legacyresample_configure_state (legacyresample, legacyresample->resample);
 
   return TRUE;
 }
@@ -433,7 +512,7 @@ legacyresample_transform_size (GstBaseTransform * base,
     GST_DEBUG_OBJECT (legacyresample,
         "caps are not the set caps, creating state");
     state = resample_new ();
-    resample_set_filter_length (state, legacyresample->filter_length);
+    legacyresample_configure_state (legacyresample, state);
     resample_set_state_from_caps (state, sinkcaps, srccaps, NULL, NULL, NULL);
   }
 
@@ -758,7 +837,8 @@ legacyresample_query (GstPad * pad, GstQuery * query)
       guint64 latency;
       GstPad *peer;
       gint rate = legacyresample->i_rate;
-      gint resampler_latency = legacyresample->filter_length / 2;
+      gint resampler_latency =
+          legacyresample_get_filter_length (legacyresample) / 2;
 
       if (gst_base_transform_is_passthrough (trans))
         resampler_latency = 0;
@@ -827,8 +907,19 @@ gst_legacyresample_set_property (GObject * object, guint prop_id,
       GST_DEBUG_OBJECT (GST_ELEMENT (legacyresample), "new filter length %d",
           legacyresample->filter_length);
       if (legacyresample->resample) {
-        resample_set_filter_length (legacyresample->resample,
-            legacyresample->filter_length);
+        legacyresample_configure_state (legacyresample,
+            legacyresample->resample);
+        gst_element_post_message (GST_ELEMENT (legacyresample),
+            gst_message_new_latency (GST_OBJECT (legacyresample)));
+      }
+      break;
+    case PROP_PRESET:
+      legacyresample->preset = g_value_get_enum (value);
+      GST_DEBUG_OBJECT (GST_ELEMENT (legacyresample), "new preset %d",
+          legacyresample->preset);
+      if (legacyresample->resample) {
+        legacyresample_configure_state (legacyresample,
+            legacyresample->resample);
         gst_element_post_message (GST_ELEMENT (legacyresample),
             gst_message_new_latency (GST_OBJECT (legacyresample)));
       }
@@ -851,6 +942,9 @@ gst_legacyresample_get_property (GObject * object, guint prop_id,
     case PROP_FILTERLEN:
       g_value_set_int (value, legacyresample->filter_length);
       break;
+    case PROP_PRESET:
+      g_value_set_enum (value, legacyresample->preset);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -39,6 +39,29 @@ G_BEGIN_DECLS
 #define GST_IS_LEGACYRESAMPLE_CLASS(klass) \
   (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_LEGACYRESAMPLE))
 
+/**
+ * GstLegacyresamplePreset:
+ * @GST_LEGACYRESAMPLE_PRESET_REFERENCE: evaluate the filter for every output
+ *   sample, the length is set with the filter-length property
+ * @GST_LEGACYRESAMPLE_PRESET_FAST: 8 taps polyphase filter bank
+ * @GST_LEGACYRESAMPLE_PRESET_MEDIUM: 16 taps polyphase filter bank
+ * @GST_LEGACYRESAMPLE_PRESET_HIGH: 32 taps polyphase filter bank, band
+ *   limited to the output rate when downsampling
+ * @GST_LEGACYRESAMPLE_PRESET_BEST: 64 taps polyphase filter bank, band
+ *   limited to the output rate when downsampling
+ *
+ * Quality and speed trade-off of the resampler.
+ *
+ * Since: 0.10.22
+ */
+typedef enum {
+  GST_LEGACYRESAMPLE_PRESET_REFERENCE,
+  GST_LEGACYRESAMPLE_PRESET_FAST,
+  GST_LEGACYRESAMPLE_PRESET_MEDIUM,
+  GST_LEGACYRESAMPLE_PRESET_HIGH,
+  GST_LEGACYRESAMPLE_PRESET_BEST
+} GstLegacyresamplePreset;
+
 typedef struct _GstLegacyresample GstLegacyresample;
 typedef struct _GstLegacyresampleClass GstLegacyresampleClass;
 
@@ -64,6 +87,7 @@ struct _GstLegacyresample {
   int i_rate;
   int o_rate;
   int filter_length;
+  GstLegacyresamplePreset preset;
 
   ResampleState * resample;
 };
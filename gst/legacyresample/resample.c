@@ -87,6 +87,12 @@ resample_free (ResampleState * r)
   if (r->out_tmp) {
     free (r->out_tmp);
   }
+  if (r->taps) {
+    free (r->taps);
+  }
+  if (r->hist) {
+    free (r->hist);
+  }
 
   free (r);
 }
@@ -245,6 +251,9 @@ resample_get_output_data (ResampleState * r, void *data, int size)
     case 1:
       resample_scale_functable (r);
       break;
+    case 2:
+      resample_scale_polyphase (r);
+      break;
     default:
       break;
   }
@@ -296,6 +305,13 @@ resample_set_method (ResampleState * r, int method)
   r->need_reinit = 1;
 }
 
+void
+resample_set_antialias (ResampleState * r, int antialias)
+{
+  r->antialias = antialias;
+  r->need_reinit = 1;
+}
+
 int
 resample_format_size (ResampleFormat format)
 {
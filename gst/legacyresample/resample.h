@@ -39,6 +39,12 @@ typedef enum {
         RESAMPLE_FORMAT_F64
 } ResampleFormat;
 
+typedef enum {
+        RESAMPLE_METHOD_REF = 0,
+        RESAMPLE_METHOD_FUNCTABLE,
+        RESAMPLE_METHOD_POLYPHASE
+} ResampleMethod;
+
 typedef void (*ResampleCallback) (void *);
 
 typedef struct _ResampleState ResampleState;
@@ -56,6 +62,8 @@ struct _ResampleState {
 
         int method;
 
+        int antialias;
+
         /* internal parameters */
 
         int need_reinit;
@@ -96,6 +104,21 @@ struct _ResampleState {
         Functable *ft;
 
         double *out_tmp;
+
+        /* polyphase filter bank */
+
+        int i_num;
+        int o_num;
+
+        int n_phases;
+        int phase_len;
+        int phase_pos;
+        float *taps;
+
+        float *hist;
+        int hist_len;
+        int hist_start;
+        int hist_end;
 };
 
 void resample_init (void);
@@ -122,10 +145,12 @@ void resample_set_output_rate (ResampleState *r, double rate);
 void resample_set_n_channels (ResampleState *r, int n_channels);
 void resample_set_format (ResampleState *r, ResampleFormat format);
 void resample_set_method (ResampleState *r, int method);
+void resample_set_antialias (ResampleState *r, int antialias);
 int resample_format_size (ResampleFormat format);
 
 void resample_scale_ref (ResampleState * r);
 void resample_scale_functable (ResampleState * r);
+void resample_scale_polyphase (ResampleState * r);
 
 #endif /* __RESAMPLE_H__ */
 
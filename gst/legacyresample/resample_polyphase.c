@@ -0,0 +1,355 @@
+/* Resampling library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Polyphase version of resample_scale_ref().
+ *
+ * With i_rate / o_rate reduced to i_num / o_num, the position of the filter
+ * relative to the input samples only takes o_num different values.  The
+ * filter taps for each of them are computed once when the rates change, and
+ * producing an output sample becomes a plain dot product between one phase
+ * of the bank and the input history.  The history is kept de-interleaved and
+ * converted to float so that the dot product runs on contiguous memory.
+ *
+ * The filter position is tracked exactly with integers:
+ *   phase_pos = i_start * i_num
+ * which moves by -i_num for every output and by +o_num for every input
+ * sample, and the taps are the same as the ones resample_scale_ref()
+ * evaluates at (i_start + j * i_inc) * o_inc = phase_pos / o_num + j.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include <gst/math-compat.h>
+#include "_stdint.h"
+
+#include "resample.h"
+#include "buffer.h"
+#include "debug.h"
+
+/* larger ratios fall back to resample_scale_ref() */
+#define RESAMPLE_MAX_PHASES     4096
+/* frames of history converted at once before it has to be moved */
+#define RESAMPLE_HIST_CHUNK     1024
+/* the dot product runs 4 taps at a time, phases and history are padded */
+#define RESAMPLE_PAD            4
+
+static double
+resample_polyphase_window (double x, double halfwidth, double scale)
+{
+  double y;
+
+  if (x < -halfwidth || x > halfwidth)
+    return 0.0;
+  if (x == 0)
+    return scale;
+
+  y = sin (x * M_PI * scale) / (x * M_PI);
+
+  x /= halfwidth;
+  y *= (1 - x * x) * (1 - x * x);
+
+  return y;
+}
+
+static int
+resample_gcd (int a, int b)
+{
+  while (b != 0) {
+    int t = a % b;
+
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+static int
+resample_polyphase_setup (ResampleState * r)
+{
+  int i_rate, o_rate, g;
+  int p, j, u;
+  int size;
+  double scale;
+
+  if (r->format != RESAMPLE_FORMAT_S16 && r->format != RESAMPLE_FORMAT_F32)
+    return 0;
+
+  i_rate = (int) r->i_rate;
+  o_rate = (int) r->o_rate;
+  if (i_rate <= 0 || o_rate <= 0 || i_rate != r->i_rate || o_rate != r->o_rate)
+    return 0;
+
+  g = resample_gcd (i_rate, o_rate);
+  r->i_num = i_rate / g;
+  r->o_num = o_rate / g;
+  if (r->o_num > RESAMPLE_MAX_PHASES)
+    return 0;
+
+  r->n_phases = r->o_num;
+  r->phase_len = (r->filter_length + RESAMPLE_PAD - 1) & ~(RESAMPLE_PAD - 1);
+
+  /* the reference resampler only ever used a scale of 1; cut off at the
+   * output Nyquist frequency when downsampling if asked to */
+  if (r->antialias && o_rate < i_rate)
+    scale = r->o_rate / r->i_rate;
+  else
+    scale = 1.0;
+
+  free (r->taps);
+  size = r->n_phases * r->phase_len;
+  r->taps = malloc (size * sizeof (float));
+  memset (r->taps, 0, size * sizeof (float));
+
+  /* 2 * phase_pos + filter_length * o_num is in [0, 2 * o_num) when a
+   * sample is produced, and always has the parity of filter_length * o_num */
+  for (p = 0; p < r->n_phases; p++) {
+    u = 2 * p + ((r->filter_length * r->o_num) & 1);
+    for (j = 0; j < r->filter_length; j++) {
+      double x = (double) (u - r->filter_length * r->o_num) /
+          (2.0 * r->o_num) + j;
+
+      r->taps[p * r->phase_len + j] =
+          resample_polyphase_window (x, r->filter_length * 0.5, scale);
+    }
+  }
+
+  /* start with filter_length frames of silence, like resample_scale_ref() */
+  free (r->hist);
+  r->hist_len = r->phase_len + RESAMPLE_HIST_CHUNK;
+  size = r->n_channels * (r->hist_len + RESAMPLE_PAD);
+  r->hist = malloc (size * sizeof (float));
+  memset (r->hist, 0, size * sizeof (float));
+  r->hist_start = 0;
+  r->hist_end = r->filter_length;
+
+  r->phase_pos = -r->o_num * r->filter_length;
+  r->buffer_filled = 0;
+
+  RESAMPLE_DEBUG ("%d phases of %d taps, scale %g", r->n_phases,
+      r->phase_len, scale);
+
+  return 1;
+}
+
+/* number of input frames to pull before n_out frames can be produced */
+static int
+resample_polyphase_frames_needed (ResampleState * r, int n_out)
+{
+  int twice_offset = r->filter_length * r->o_num;
+  int pos = r->phase_pos;
+  int needed = 0;
+  int i;
+
+  for (i = 0; i < n_out; i++) {
+    while (2 * pos + twice_offset < 0) {
+      pos += r->o_num;
+      needed++;
+    }
+    pos -= r->i_num;
+  }
+
+  return needed;
+}
+
+static void
+resample_polyphase_append (ResampleState * r, const unsigned char *data,
+    int frames)
+{
+  int stride = r->hist_len + RESAMPLE_PAD;
+  int c, i;
+  float *h;
+
+  if (r->hist_end + frames > r->hist_len) {
+    int valid = r->hist_end - r->hist_start;
+
+    if (valid + frames <= r->hist_len) {
+      /* slide the current window to the start */
+      for (c = 0; c < r->n_channels; c++) {
+        h = r->hist + c * stride;
+        memmove (h, h + r->hist_start, valid * sizeof (float));
+      }
+    } else {
+      float *hist;
+      int new_len = valid + frames + RESAMPLE_HIST_CHUNK;
+      int new_stride = new_len + RESAMPLE_PAD;
+
+      hist = malloc (r->n_channels * new_stride * sizeof (float));
+      memset (hist, 0, r->n_channels * new_stride * sizeof (float));
+      for (c = 0; c < r->n_channels; c++) {
+        memcpy (hist + c * new_stride, r->hist + c * stride + r->hist_start,
+            valid * sizeof (float));
+      }
+      free (r->hist);
+      r->hist = hist;
+      r->hist_len = new_len;
+      stride = new_stride;
+    }
+    r->hist_start = 0;
+    r->hist_end = valid;
+  }
+
+  switch (r->format) {
+    case RESAMPLE_FORMAT_S16:
+      for (c = 0; c < r->n_channels; c++) {
+        const int16_t *src = (const int16_t *) data + c;
+
+        h = r->hist + c * stride + r->hist_end;
+        for (i = 0; i < frames; i++)
+          h[i] = src[i * r->n_channels];
+      }
+      break;
+    case RESAMPLE_FORMAT_F32:
+      for (c = 0; c < r->n_channels; c++) {
+        const float *src = (const float *) data + c;
+
+        h = r->hist + c * stride + r->hist_end;
+        for (i = 0; i < frames; i++)
+          h[i] = src[i * r->n_channels];
+      }
+      break;
+    default:
+      break;
+  }
+
+  r->hist_end += frames;
+  r->buffer_filled = MIN (r->buffer_filled + frames * r->sample_size,
+      r->filter_length * r->sample_size);
+}
+
+/* One phase against the history.  The rows are padded to a multiple of 4
+ * taps so the sum is split in four that do not depend on each other, which
+ * shortens the chain of additions of the longer filters.  This is plain
+ * scalar code, only recent compilers (GCC 12 at -O2) vectorise it. */
+static inline float
+resample_polyphase_dot (const float *taps, const float *x, int n)
+{
+  float a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+  int i;
+
+  for (i = 0; i < n; i += 4) {
+    a0 += taps[i + 0] * x[i + 0];
+    a1 += taps[i + 1] * x[i + 1];
+    a2 += taps[i + 2] * x[i + 2];
+    a3 += taps[i + 3] * x[i + 3];
+  }
+
+  return (a0 + a1) + (a2 + a3);
+}
+
+void
+resample_scale_polyphase (ResampleState * r)
+{
+  int twice_offset;
+  int stride;
+  int pending;
+  int avail;
+
+  if (r->need_reinit) {
+    if (!resample_polyphase_setup (r)) {
+      RESAMPLE_DEBUG ("no filter bank for this ratio, using the reference");
+      r->n_phases = 0;
+    } else {
+      r->need_reinit = 0;
+    }
+  }
+  if (r->n_phases == 0) {
+    resample_scale_ref (r);
+    return;
+  }
+
+  RESAMPLE_DEBUG ("asked to resample %d bytes", r->o_size);
+
+  /* pull all the input this call needs in one go */
+  pending = resample_polyphase_frames_needed (r, r->o_size / r->sample_size);
+  avail = audioresample_buffer_queue_get_depth (r->queue) / r->sample_size;
+  if (pending > avail)
+    pending = avail;
+  if (pending > 0) {
+    AudioresampleBuffer *buffer;
+
+    buffer = audioresample_buffer_queue_pull (r->queue,
+        pending * r->sample_size);
+    resample_polyphase_append (r, buffer->data, pending);
+    audioresample_buffer_unref (buffer);
+    /* the window moves forward as the samples are consumed below */
+    r->hist_end -= pending;
+  }
+
+  twice_offset = r->filter_length * r->o_num;
+  stride = r->hist_len + RESAMPLE_PAD;
+
+  while (r->o_size >= r->sample_size) {
+    const float *taps;
+    int i;
+
+    while (2 * r->phase_pos + twice_offset < 0) {
+      if (pending == 0) {
+        RESAMPLE_ERROR ("not enough input to produce %d bytes", r->o_size);
+        return;
+      }
+      pending--;
+      r->hist_start++;
+      r->hist_end++;
+      r->phase_pos += r->o_num;
+    }
+
+    taps = r->taps + ((2 * r->phase_pos + twice_offset) >> 1) * r->phase_len;
+
+    switch (r->format) {
+      case RESAMPLE_FORMAT_S16:
+        for (i = 0; i < r->n_channels; i++) {
+          float acc = resample_polyphase_dot (taps,
+              r->hist + i * stride + r->hist_start, r->phase_len);
+
+          if (acc < -32768.0f)
+            acc = -32768.0f;
+          if (acc > 32767.0f)
+            acc = 32767.0f;
+
+          *(int16_t *) (r->o_buf + i * sizeof (int16_t)) = rint (acc);
+        }
+        break;
+      case RESAMPLE_FORMAT_F32:
+        for (i = 0; i < r->n_channels; i++) {
+          *(float *) (r->o_buf + i * sizeof (float)) =
+              resample_polyphase_dot (taps,
+              r->hist + i * stride + r->hist_start, r->phase_len);
+        }
+        break;
+      default:
+        break;
+    }
+
+    r->phase_pos -= r->i_num;
+    r->o_buf += r->sample_size;
+    r->o_size -= r->sample_size;
+  }
+
+  /* keep what was pulled but not consumed yet in the window's future */
+  r->hist_end += pending;
+}
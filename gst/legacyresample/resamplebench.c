@@ -0,0 +1,251 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Measures the speed and the quality of the legacyresample presets:
+ *
+ *   resamplebench [-c channels] [-s seconds of input] [-i]
+ *
+ * A 997 Hz sine is resampled for every preset and rate pair, the speed is
+ * reported in input frames per second of CPU time and the quality as the
+ * ratio between the sine fitted to the output and what is left of the
+ * output after removing it.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "resample.h"
+
+#define CHUNK_FRAMES    4096
+#define TONE_FREQ       997.0
+
+static const struct
+{
+  const gchar *name;
+  ResampleMethod method;
+  gint filter_length;
+  gboolean antialias;
+} presets[] = {
+  {
+  "reference", RESAMPLE_METHOD_REF, 16, FALSE}, {
+  "fast", RESAMPLE_METHOD_POLYPHASE, 8, FALSE}, {
+  "medium", RESAMPLE_METHOD_POLYPHASE, 16, FALSE}, {
+  "high", RESAMPLE_METHOD_POLYPHASE, 32, TRUE}, {
+  "best", RESAMPLE_METHOD_POLYPHASE, 64, TRUE}
+};
+
+static const gint rates[][2] = {
+  {44100, 48000},
+  {48000, 44100},
+  {8000, 48000},
+  {48000, 8000},
+  {44100, 22050},
+  {32000, 44100}
+};
+
+/* the amplitude of the best fitting a * sin + b * cos + c is compared with
+ * the residual, the first and last filter lengths are skipped */
+static gdouble
+measure_snr (const gdouble * x, gint n, gdouble w)
+{
+  gdouble m[3][4] = { {0,}, };
+  gdouble coef[3], signal, noise;
+  gint i, j, k;
+
+  for (i = 0; i < n; i++) {
+    gdouble v[3] = { sin (w * i), cos (w * i), 1.0 };
+
+    for (j = 0; j < 3; j++) {
+      for (k = 0; k < 3; k++)
+        m[j][k] += v[j] * v[k];
+      m[j][3] += v[j] * x[i];
+    }
+  }
+
+  /* solve the normal equations */
+  for (j = 0; j < 3; j++) {
+    for (k = j + 1; k < 3; k++) {
+      gdouble f = m[k][j] / m[j][j];
+      gint l;
+
+      for (l = j; l < 4; l++)
+        m[k][l] -= f * m[j][l];
+    }
+  }
+  for (j = 2; j >= 0; j--) {
+    coef[j] = m[j][3];
+    for (k = j + 1; k < 3; k++)
+      coef[j] -= m[j][k] * coef[k];
+    coef[j] /= m[j][j];
+  }
+
+  signal = noise = 0;
+  for (i = 0; i < n; i++) {
+    gdouble fit = coef[0] * sin (w * i) + coef[1] * cos (w * i) + coef[2];
+
+    signal += fit * fit;
+    noise += (x[i] - fit) * (x[i] - fit);
+  }
+
+  if (noise == 0)
+    return INFINITY;
+
+  return 10 * log10 (signal / noise);
+}
+
+static void
+run (gint p, gint in_rate, gint out_rate, gint channels, gint seconds,
+    gboolean use_int, gdouble * speed, gdouble * snr)
+{
+  ResampleState *r;
+  ResampleFormat format;
+  gint sample_size, in_frames, out_frames, out_max, chunk, skip;
+  guint8 *in, *out;
+  gdouble *mono;
+  clock_t start, elapsed = 0;
+  gint i, c, pos, done;
+
+  format = use_int ? RESAMPLE_FORMAT_S16 : RESAMPLE_FORMAT_F32;
+  sample_size = channels * resample_format_size (format);
+  in_frames = seconds * in_rate;
+  out_max = (gint) ((gint64) in_frames * out_rate / in_rate) + CHUNK_FRAMES;
+
+  in = g_malloc (in_frames * sample_size);
+  out = g_malloc (out_max * sample_size);
+
+  for (i = 0; i < in_frames; i++) {
+    gdouble v = 0.5 * sin (2 * M_PI * TONE_FREQ * i / in_rate);
+
+    for (c = 0; c < channels; c++) {
+      if (use_int)
+        ((gint16 *) in)[i * channels + c] = rint (v * 32767);
+      else
+        ((gfloat *) in)[i * channels + c] = v;
+    }
+  }
+
+  r = resample_new ();
+  resample_set_filter_length (r, presets[p].filter_length);
+  resample_set_method (r, presets[p].method);
+  resample_set_antialias (r, presets[p].antialias);
+  resample_set_format (r, format);
+  resample_set_n_channels (r, channels);
+  resample_set_input_rate (r, in_rate);
+  resample_set_output_rate (r, out_rate);
+
+  out_frames = 0;
+  for (pos = 0; pos < in_frames; pos += chunk) {
+    gint size;
+
+    chunk = MIN (CHUNK_FRAMES, in_frames - pos);
+    resample_add_input_data (r, in + pos * sample_size, chunk * sample_size,
+        NULL, NULL);
+    size = resample_get_output_size (r);
+    size = MIN (size, (out_max - out_frames) * sample_size);
+
+    start = clock ();
+    done = resample_get_output_data (r, out + out_frames * sample_size, size);
+    elapsed += clock () - start;
+
+    out_frames += done / sample_size;
+  }
+  resample_free (r);
+
+  *speed = elapsed ? (gdouble) in_frames * CLOCKS_PER_SEC / elapsed : 0;
+
+  /* the quality of the first channel, away from the start and the end */
+  skip = presets[p].filter_length * MAX (out_rate / in_rate, 1) + 1;
+  mono = g_new (gdouble, out_frames);
+  for (i = 0; i < out_frames; i++) {
+    if (use_int)
+      mono[i] = ((gint16 *) out)[i * channels] / 32768.0;
+    else
+      mono[i] = ((gfloat *) out)[i * channels];
+  }
+  if (out_frames > 2 * skip)
+    *snr = measure_snr (mono + skip, out_frames - 2 * skip,
+        2 * M_PI * TONE_FREQ / out_rate);
+  else
+    *snr = 0;
+
+  g_free (mono);
+  g_free (in);
+  g_free (out);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gint channels = 2;
+  gint seconds = 10;
+  gboolean use_int = FALSE;
+  GOptionContext *ctx;
+  GError *err = NULL;
+  guint i, p;
+
+  const GOptionEntry entries[] = {
+    {"channels", 'c', 0, G_OPTION_ARG_INT, &channels,
+        "Number of channels (default: 2)", "N"},
+    {"seconds", 's', 0, G_OPTION_ARG_INT, &seconds,
+        "Seconds of input per run (default: 10)", "S"},
+    {"int", 'i', 0, G_OPTION_ARG_NONE, &use_int,
+        "Use 16 bit integer instead of float samples", NULL},
+    {NULL,}
+  };
+
+  ctx = g_option_context_new ("- benchmark the legacyresample presets");
+  g_option_context_add_main_entries (ctx, entries, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    exit (1);
+  }
+  g_option_context_free (ctx);
+
+  if (channels < 1 || seconds < 1) {
+    g_print ("channels and seconds must be positive\n");
+    exit (1);
+  }
+
+  resample_init ();
+
+  g_print ("%d channels %s, %d s of input per run\n", channels,
+      use_int ? "s16" : "float", seconds);
+  g_print ("rates          preset       Mframes/s    SNR dB\n");
+
+  for (i = 0; i < G_N_ELEMENTS (rates); i++) {
+    for (p = 0; p < G_N_ELEMENTS (presets); p++) {
+      gdouble speed, snr;
+
+      run (p, rates[i][0], rates[i][1], channels, seconds, use_int,
+          &speed, &snr);
+      g_print ("%5d > %-5d  %-10s %11.2f %9.1f\n", rates[i][0], rates[i][1],
+          presets[p].name, speed / 1e6, snr);
+    }
+  }
+
+  return 0;
+}
@@ -48,9 +48,14 @@ enum
   ARG_INCREMENTAL,
   ARG_USE_COPYRECT,
   ARG_SHARED,
-  ARG_VIEWONLY
+  ARG_VIEWONLY,
+  ARG_REPEAT_INTERVAL,
+  ARG_DAMAGE_EVENTS
 };
 
+#define DEFAULT_REPEAT_INTERVAL 0
+#define DEFAULT_DAMAGE_EVENTS   FALSE
+
 GST_DEBUG_CATEGORY_STATIC (rfbsrc_debug);
 GST_DEBUG_CATEGORY (rfbdecoder_debug);
 #define GST_CAT_DEFAULT rfbsrc_debug
@@ -78,6 +83,8 @@ static void gst_rfb_src_get_property (GObject * object, guint prop_id,
 
 static gboolean gst_rfb_src_start (GstBaseSrc * bsrc);
 static gboolean gst_rfb_src_stop (GstBaseSrc * bsrc);
+static gboolean gst_rfb_src_unlock (GstBaseSrc * bsrc);
+static gboolean gst_rfb_src_unlock_stop (GstBaseSrc * bsrc);
 static gboolean gst_rfb_src_event (GstBaseSrc * bsrc, GstEvent * event);
 static GstFlowReturn gst_rfb_src_create (GstPushSrc * psrc,
     GstBuffer ** outbuf);
@@ -162,9 +169,22 @@ gst_rfb_src_class_init (GstRfbSrcClass * klass)
       g_param_spec_boolean ("view-only", "Only view the desktop",
           "only view the desktop", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, ARG_REPEAT_INTERVAL,
+      g_param_spec_uint ("repeat-interval", "Repeat interval",
+          "Push the last frame again when the screen did not change for this "
+          "many milliseconds (0 = only push frames when the screen changed)",
+          0, G_MAXUINT, DEFAULT_REPEAT_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, ARG_DAMAGE_EVENTS,
+      g_param_spec_boolean ("damage-events", "Damage events",
+          "Send a rfb-damage event with the changed rectangles before "
+          "every frame", DEFAULT_DAMAGE_EVENTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   gstbasesrc_class->start = GST_DEBUG_FUNCPTR (gst_rfb_src_start);
   gstbasesrc_class->stop = GST_DEBUG_FUNCPTR (gst_rfb_src_stop);
   gstbasesrc_class->event = GST_DEBUG_FUNCPTR (gst_rfb_src_event);
+  gstbasesrc_class->unlock = GST_DEBUG_FUNCPTR (gst_rfb_src_unlock);
+  gstbasesrc_class->unlock_stop = GST_DEBUG_FUNCPTR (gst_rfb_src_unlock_stop);
   gstpushsrc_class->create = GST_DEBUG_FUNCPTR (gst_rfb_src_create);
 }
 
@@ -186,6 +206,9 @@ gst_rfb_src_init (GstRfbSrc * src, GstRfbSrcClass * klass)
 
   src->view_only = FALSE;
 
+  src->repeat_interval = DEFAULT_REPEAT_INTERVAL;
+  src->damage_events = DEFAULT_DAMAGE_EVENTS;
+
   src->decoder = rfb_decoder_new ();
 
 }
@@ -284,6 +307,14 @@ gst_rfb_src_set_property (GObject * object, guint prop_id,
     case ARG_VIEWONLY:
       src->view_only = g_value_get_boolean (value);
       break;
+    case ARG_REPEAT_INTERVAL:
+      src->repeat_interval = g_value_get_uint (value);
+      src->decoder->timeout = src->repeat_interval ?
+          src->repeat_interval * GST_MSECOND : GST_CLOCK_TIME_NONE;
+      break;
+    case ARG_DAMAGE_EVENTS:
+      src->damage_events = g_value_get_boolean (value);
+      break;
     default:
       break;
   }
@@ -332,6 +363,12 @@ gst_rfb_src_get_property (GObject * object, guint prop_id,
     case ARG_VIEWONLY:
       g_value_set_boolean (value, src->view_only);
       break;
+    case ARG_REPEAT_INTERVAL:
+      g_value_set_uint (value, src->repeat_interval);
+      break;
+    case ARG_DAMAGE_EVENTS:
+      g_value_set_boolean (value, src->damage_events);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -353,12 +390,17 @@ gst_rfb_src_start (GstBaseSrc * bsrc)
   if (!rfb_decoder_connect_tcp (decoder, src->host, src->port)) {
     GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
         ("Could not connect to host %s on port %d", src->host, src->port));
-    rfb_decoder_free (decoder);
     return FALSE;
   }
 
   while (!decoder->inited) {
-    rfb_decoder_iterate (decoder);
+    if (!rfb_decoder_iterate (decoder)) {
+      GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+          ("Could not initialise the connection to host %s on port %d",
+              src->host, src->port));
+      rfb_decoder_disconnect (decoder);
+      return FALSE;
+    }
   }
 
   decoder->rect_width =
@@ -369,11 +411,9 @@ gst_rfb_src_start (GstBaseSrc * bsrc)
   g_object_set (bsrc, "blocksize",
       src->decoder->width * src->decoder->height * (decoder->bpp / 8), NULL);
 
-  decoder->frame = g_malloc (bsrc->blocksize);
-  if (decoder->use_copyrect) {
-    decoder->prev_frame = g_malloc (bsrc->blocksize);
-  }
+  decoder->frame = g_malloc0 (bsrc->blocksize);
   decoder->decoder_private = src;
+  decoder->pipeline_updates = src->incremental_update;
 
   /* calculate some many used values */
   decoder->bytespp = decoder->bpp / 8;
@@ -409,21 +449,106 @@ gst_rfb_src_stop (GstBaseSrc * bsrc)
 {
   GstRfbSrc *src = GST_RFB_SRC (bsrc);
 
-  src->decoder->fd = -1;
+  rfb_decoder_disconnect (src->decoder);
 
   if (src->decoder->frame) {
     g_free (src->decoder->frame);
     src->decoder->frame = NULL;
   }
 
-  if (src->decoder->prev_frame) {
-    g_free (src->decoder->prev_frame);
-    src->decoder->prev_frame = NULL;
-  }
+  gst_buffer_replace (&src->last_buffer, NULL);
+
+  return TRUE;
+}
+
+static gboolean
+gst_rfb_src_unlock (GstBaseSrc * bsrc)
+{
+  GstRfbSrc *src = GST_RFB_SRC (bsrc);
+
+  GST_DEBUG_OBJECT (src, "unlocking");
+  rfb_decoder_set_flushing (src->decoder, TRUE);
+
+  return TRUE;
+}
+
+static gboolean
+gst_rfb_src_unlock_stop (GstBaseSrc * bsrc)
+{
+  GstRfbSrc *src = GST_RFB_SRC (bsrc);
+
+  GST_DEBUG_OBJECT (src, "stop unlocking");
+  rfb_decoder_set_flushing (src->decoder, FALSE);
 
   return TRUE;
 }
 
+/* copies the rectangles updated by the last framebuffer update into a buffer
+ * that already holds the previous frame */
+static void
+gst_rfb_src_copy_damage (GstRfbSrc * src, guint8 * data)
+{
+  RfbDecoder *decoder = src->decoder;
+  guint i;
+  gint y;
+
+  for (i = 0; i < decoder->damage->len; i++) {
+    RfbRectangle *rect = &g_array_index (decoder->damage, RfbRectangle, i);
+    gsize offset = rect->y * decoder->line_size + rect->x * decoder->bytespp;
+    gsize size = rect->width * decoder->bytespp;
+
+    for (y = 0; y < rect->height; y++) {
+      memcpy (data + offset, decoder->frame + offset, size);
+      offset += decoder->line_size;
+    }
+  }
+}
+
+/* sends the rectangles that differ from the previous frame downstream, in
+ * front of the frame, as
+ *   rfb-damage, timestamp=(guint64)ts, rectangles=<<x, y, w, h>, ...>
+ * a repeated frame has an empty list */
+static void
+gst_rfb_src_push_damage (GstRfbSrc * src, GstClockTime timestamp,
+    gboolean repeat)
+{
+  RfbDecoder *decoder = src->decoder;
+  GstStructure *s;
+  GValue rects = { 0, };
+  guint i;
+
+  g_value_init (&rects, GST_TYPE_ARRAY);
+
+  for (i = 0; !repeat && i < decoder->damage->len; i++) {
+    RfbRectangle *rect = &g_array_index (decoder->damage, RfbRectangle, i);
+    GValue rv = { 0, };
+    GValue v = { 0, };
+
+    g_value_init (&rv, GST_TYPE_ARRAY);
+    g_value_init (&v, G_TYPE_INT);
+    g_value_set_int (&v, rect->x);
+    gst_value_array_append_value (&rv, &v);
+    g_value_set_int (&v, rect->y);
+    gst_value_array_append_value (&rv, &v);
+    g_value_set_int (&v, rect->width);
+    gst_value_array_append_value (&rv, &v);
+    g_value_set_int (&v, rect->height);
+    gst_value_array_append_value (&rv, &v);
+    g_value_unset (&v);
+
+    gst_value_array_append_value (&rects, &rv);
+    g_value_unset (&rv);
+  }
+
+  s = gst_structure_new ("rfb-damage", "timestamp", G_TYPE_UINT64, timestamp,
+      NULL);
+  gst_structure_set_value (s, "rectangles", &rects);
+  g_value_unset (&rects);
+
+  gst_pad_push_event (GST_BASE_SRC_PAD (src),
+      gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM, s));
+}
+
 static GstFlowReturn
 gst_rfb_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
 {
@@ -431,33 +556,84 @@ gst_rfb_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
   RfbDecoder *decoder = src->decoder;
   gulong newsize;
   GstFlowReturn ret;
+  GstClockTime timestamp;
+  gboolean repeat = FALSE;
+
+  /* wait for an update that changed something, or for the repeat interval
+   * to expire */
+  do {
+    /* with pipelined updates the next request went out as soon as the
+     * previous update started to arrive, the first one has to cover the whole
+     * screen */
+    if (!decoder->update_pending) {
+      rfb_decoder_send_update_request (decoder,
+          src->incremental_update && src->last_buffer != NULL,
+          decoder->offset_x, decoder->offset_y, decoder->rect_width,
+          decoder->rect_height);
+    }
+
+    if (!rfb_decoder_read_update (decoder)) {
+      if (decoder->disconnected)
+        goto disconnected;
+      if (!decoder->timed_out) {
+        GST_DEBUG_OBJECT (src, "flushing");
+        return GST_FLOW_WRONG_STATE;
+      }
+      if (src->last_buffer == NULL)
+        continue;
+      GST_LOG_OBJECT (src, "nothing changed for %u ms, repeating the last "
+          "frame", src->repeat_interval);
+      repeat = TRUE;
+      break;
+    }
 
-  rfb_decoder_send_update_request (decoder, src->incremental_update,
-      decoder->offset_x, decoder->offset_y, decoder->rect_width,
-      decoder->rect_height);
-
-  while (decoder->state != NULL) {
-    rfb_decoder_iterate (decoder);
-  }
+    if (decoder->damage->len == 0)
+      GST_LOG_OBJECT (src, "update without changes, waiting for the next");
+  } while (decoder->damage->len == 0);
 
   newsize = GST_BASE_SRC (psrc)->blocksize;
 
-  /* Create the buffer. */
-  ret = gst_pad_alloc_buffer (GST_BASE_SRC_PAD (GST_BASE_SRC (psrc)),
-      GST_BUFFER_OFFSET_NONE, newsize,
-      GST_PAD_CAPS (GST_BASE_SRC_PAD (GST_BASE_SRC (psrc))), outbuf);
-
-  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
-    return GST_FLOW_ERROR;
+  if (repeat) {
+    /* shares the memory of the last frame, which keeps it from being reused
+     * until downstream is done with it */
+    *outbuf = gst_buffer_create_sub (src->last_buffer, 0,
+        GST_BUFFER_SIZE (src->last_buffer));
+    gst_buffer_set_caps (*outbuf, GST_BUFFER_CAPS (src->last_buffer));
+  } else if (src->last_buffer && gst_buffer_is_writable (src->last_buffer)) {
+    /* downstream is done with the previous frame, only the damaged parts
+     * differ from the current one */
+    *outbuf = gst_buffer_ref (src->last_buffer);
+    gst_rfb_src_copy_damage (src, GST_BUFFER_DATA (*outbuf));
+    GST_BUFFER_FLAG_UNSET (*outbuf, GST_BUFFER_FLAG_DISCONT);
+  } else {
+    ret = gst_pad_alloc_buffer (GST_BASE_SRC_PAD (GST_BASE_SRC (psrc)),
+        GST_BUFFER_OFFSET_NONE, newsize,
+        GST_PAD_CAPS (GST_BASE_SRC_PAD (GST_BASE_SRC (psrc))), outbuf);
+
+    if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+      return ret;
+    }
+
+    memcpy (GST_BUFFER_DATA (*outbuf), decoder->frame, newsize);
+    GST_BUFFER_SIZE (*outbuf) = newsize;
+    gst_buffer_replace (&src->last_buffer, *outbuf);
   }
 
-  memcpy (GST_BUFFER_DATA (*outbuf), decoder->frame, newsize);
-  GST_BUFFER_SIZE (*outbuf) = newsize;
-  GST_BUFFER_TIMESTAMP (*outbuf) =
-      gst_clock_get_time (GST_ELEMENT_CLOCK (src)) -
+  timestamp = gst_clock_get_time (GST_ELEMENT_CLOCK (src)) -
       GST_ELEMENT_CAST (src)->base_time;
+  GST_BUFFER_TIMESTAMP (*outbuf) = timestamp;
+
+  if (src->damage_events)
+    gst_rfb_src_push_damage (src, timestamp, repeat);
 
   return GST_FLOW_OK;
+
+disconnected:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+        ("Lost the connection to host %s on port %d", src->host, src->port));
+    return GST_FLOW_ERROR;
+  }
 }
 
 static gboolean
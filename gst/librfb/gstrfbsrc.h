@@ -56,9 +56,15 @@ struct _GstRfbSrc
   gboolean go;
   gboolean incremental_update;
   gboolean view_only;
+  guint repeat_interval;
+  gboolean damage_events;
 
   guint button_mask;
 
+  /* the last buffer pushed, reused when downstream released it so that only
+   * the damaged parts of the frame have to be copied */
+  GstBuffer *last_buffer;
+
   /* protocol version */
   guint version_major;
   guint version_minor;
@@ -17,6 +17,10 @@
 #endif
 #include <errno.h>
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 #include "vncauth.h"
 
 #define RFB_GET_UINT32(ptr) GST_READ_UINT32_BE(ptr)
@@ -27,6 +31,27 @@
 #define RFB_SET_UINT16(ptr, val) GST_WRITE_UINT16_BE((ptr),(val))
 #define RFB_SET_UINT8(ptr, val) GST_WRITE_UINT8((ptr),(val))
 
+#define RFB_FRAME_PTR(decoder, x, y) ((decoder)->frame + \
+    (((y) * (decoder)->rect_width) + (x)) * (decoder)->bytespp)
+
+/* the receive buffer is filled in chunks of at least this size */
+#define RFB_RECV_SIZE (256 * 1024)
+/* initial size of the buffer compressed data is inflated to */
+#define RFB_ZBUF_SIZE (64 * 1024)
+/* longest reason, desktop name or cut text accepted from the server */
+#define RFB_MAX_TEXT_SIZE (1024 * 1024)
+
+#define ZRLE_TILE_SIZE 64
+
+#define TIGHT_FILL                  0x08
+#define TIGHT_JPEG                  0x09
+#define TIGHT_MAX_SUBENCODING       0x07
+#define TIGHT_EXPLICIT_FILTER       0x04
+#define TIGHT_FILTER_COPY           0
+#define TIGHT_FILTER_PALETTE        1
+#define TIGHT_FILTER_GRADIENT       2
+#define TIGHT_MIN_TO_COMPRESS       12
+
 GST_DEBUG_CATEGORY_EXTERN (rfbdecoder_debug);
 #define GST_CAT_DEFAULT rfbdecoder_debug
 
@@ -52,16 +77,22 @@ static gboolean rfb_decoder_state_framebuffer_update_rectangle (RfbDecoder *
     decoder);
 static gboolean rfb_decoder_state_set_colour_map_entries (RfbDecoder * decoder);
 static gboolean rfb_decoder_state_server_cut_text (RfbDecoder * decoder);
-static void rfb_decoder_raw_encoding (RfbDecoder * decoder, gint start_x,
+static gboolean rfb_decoder_raw_encoding (RfbDecoder * decoder, gint start_x,
     gint start_y, gint rect_w, gint rect_h);
-static void rfb_decoder_copyrect_encoding (RfbDecoder * decoder, gint start_x,
-    gint start_y, gint rect_w, gint rect_h);
-static void rfb_decoder_rre_encoding (RfbDecoder * decoder, gint start_x,
-    gint start_y, gint rect_w, gint rect_h);
-static void rfb_decoder_corre_encoding (RfbDecoder * decoder, gint start_x,
-    gint start_y, gint rect_w, gint rect_h);
-static void rfb_decoder_hextile_encoding (RfbDecoder * decoder, gint start_x,
+static gboolean rfb_decoder_copyrect_encoding (RfbDecoder * decoder,
+    gint start_x, gint start_y, gint rect_w, gint rect_h);
+static gboolean rfb_decoder_rre_encoding (RfbDecoder * decoder, gint start_x,
     gint start_y, gint rect_w, gint rect_h);
+static gboolean rfb_decoder_corre_encoding (RfbDecoder * decoder,
+    gint start_x, gint start_y, gint rect_w, gint rect_h);
+static gboolean rfb_decoder_hextile_encoding (RfbDecoder * decoder,
+    gint start_x, gint start_y, gint rect_w, gint rect_h);
+#ifdef HAVE_ZLIB
+static gboolean rfb_decoder_zrle_encoding (RfbDecoder * decoder,
+    gint start_x, gint start_y, gint rect_w, gint rect_h);
+static gboolean rfb_decoder_tight_encoding (RfbDecoder * decoder,
+    gint start_x, gint start_y, gint rect_w, gint rect_h);
+#endif
 
 RfbDecoder *
 rfb_decoder_new (void)
@@ -69,6 +100,8 @@ rfb_decoder_new (void)
   RfbDecoder *decoder = g_new0 (RfbDecoder, 1);
 
   decoder->fd = -1;
+  decoder->poll = gst_poll_new (TRUE);
+  gst_poll_fd_init (&decoder->pollfd);
 
   decoder->password = NULL;
 
@@ -81,7 +114,9 @@ rfb_decoder_new (void)
   decoder->shared_flag = TRUE;
   decoder->disconnected = FALSE;
   decoder->data = NULL;
-  decoder->data_len = 0;
+  decoder->timeout = GST_CLOCK_TIME_NONE;
+
+  decoder->damage = g_array_new (FALSE, FALSE, sizeof (RfbRectangle));
 
   return decoder;
 }
@@ -91,11 +126,23 @@ rfb_decoder_free (RfbDecoder * decoder)
 {
   g_return_if_fail (decoder != NULL);
 
-  if (decoder->fd >= 0)
-    close (decoder->fd);
+  rfb_decoder_disconnect (decoder);
 
-  if (decoder->data)
-    g_free (decoder->data);
+  g_free (decoder->recv_buf);
+  decoder->recv_buf = NULL;
+  g_free (decoder->zbuf);
+  decoder->zbuf = NULL;
+  g_free (decoder->password);
+  decoder->password = NULL;
+
+  if (decoder->damage) {
+    g_array_free (decoder->damage, TRUE);
+    decoder->damage = NULL;
+  }
+  if (decoder->poll) {
+    gst_poll_free (decoder->poll);
+    decoder->poll = NULL;
+  }
 }
 
 gboolean
@@ -129,13 +176,112 @@ rfb_decoder_connect_tcp (RfbDecoder * decoder, gchar * addr, guint port)
     GST_WARNING ("connection failed");
     return FALSE;
   }
-  //rfb_decoder_use_file_descriptor (decoder, fd);
 
-  decoder->disconnected = FALSE;
+  rfb_decoder_use_file_descriptor (decoder, decoder->fd);
 
   return TRUE;
 }
 
+/**
+ * rfb_decoder_use_file_descriptor:
+ * @decoder: The rfb context
+ * @fd: a connected stream socket
+ *
+ * Makes the decoder talk to the server over @fd, which it closes on
+ * disconnection.
+ */
+void
+rfb_decoder_use_file_descriptor (RfbDecoder * decoder, gint fd)
+{
+  g_return_if_fail (decoder != NULL);
+  g_return_if_fail (fd >= 0);
+
+  decoder->fd = fd;
+
+  /* the socket is only read when the poll says there is data, so reads
+   * never block and can be interrupted with rfb_decoder_set_flushing() */
+  gst_poll_fd_init (&decoder->pollfd);
+  decoder->pollfd.fd = decoder->fd;
+  gst_poll_add_fd (decoder->poll, &decoder->pollfd);
+  gst_poll_fd_ctl_read (decoder->poll, &decoder->pollfd, TRUE);
+  rfb_decoder_set_flushing (decoder, FALSE);
+
+  decoder->recv_start = decoder->recv_end = 0;
+  decoder->disconnected = FALSE;
+}
+
+#ifdef HAVE_ZLIB
+static void
+rfb_decoder_free_stream (gpointer * stream_p)
+{
+  z_stream *stream = *stream_p;
+
+  if (stream) {
+    inflateEnd (stream);
+    g_free (stream);
+    *stream_p = NULL;
+  }
+}
+#endif
+
+/**
+ * rfb_decoder_disconnect:
+ * @decoder: The rfb context
+ *
+ * Closes the connection with the rfb server and forgets about its state, a
+ * new connection can be made afterwards.
+ */
+void
+rfb_decoder_disconnect (RfbDecoder * decoder)
+{
+#ifdef HAVE_ZLIB
+  gint i;
+#endif
+
+  g_return_if_fail (decoder != NULL);
+
+  if (decoder->fd >= 0) {
+    gst_poll_remove_fd (decoder->poll, &decoder->pollfd);
+    close (decoder->fd);
+    decoder->fd = -1;
+  }
+
+  decoder->state = NULL;
+  decoder->inited = FALSE;
+  decoder->update_pending = FALSE;
+  decoder->recv_start = decoder->recv_end = 0;
+  decoder->data = NULL;
+  if (decoder->damage)
+    g_array_set_size (decoder->damage, 0);
+
+#ifdef HAVE_ZLIB
+  rfb_decoder_free_stream (&decoder->zrle_stream);
+  for (i = 0; i < G_N_ELEMENTS (decoder->tight_streams); i++)
+    rfb_decoder_free_stream (&decoder->tight_streams[i]);
+#endif
+
+  g_free (decoder->name);
+  decoder->name = NULL;
+}
+
+/**
+ * rfb_decoder_set_flushing:
+ * @decoder: The rfb context
+ * @flushing: whether to interrupt reading
+ *
+ * Makes a read from the server that is waiting for data return at once.
+ * When that happens between two messages rfb_decoder_read_update() can be
+ * called again later, otherwise the connection is considered lost.
+ */
+void
+rfb_decoder_set_flushing (RfbDecoder * decoder, gboolean flushing)
+{
+  g_return_if_fail (decoder != NULL);
+
+  decoder->flushing = flushing;
+  gst_poll_set_flushing (decoder->poll, flushing);
+}
+
 /**
  * rfb_decoder_iterate:
  * @decoder: The rfb context
@@ -159,35 +305,130 @@ rfb_decoder_iterate (RfbDecoder * decoder)
   return decoder->state (decoder);
 }
 
-static guint8 *
-rfb_decoder_read (RfbDecoder * decoder, guint32 len)
+/**
+ * rfb_decoder_read_update:
+ * @decoder: The rfb context
+ *
+ * Handles the messages of the server until a framebuffer update has been
+ * decoded in decoder->frame. The rectangles it changed are in
+ * decoder->damage.
+ *
+ * Returns: TRUE if an update was decoded, FALSE when the connection is lost
+ * (decoder->disconnected is set), when no message arrived within
+ * decoder->timeout (decoder->timed_out is set) or when flushing.
+ */
+gboolean
+rfb_decoder_read_update (RfbDecoder * decoder)
 {
-  guint32 total = 0;
-  guint32 now = 0;
+  g_return_val_if_fail (decoder != NULL, FALSE);
+  g_return_val_if_fail (decoder->fd != -1, FALSE);
 
-  g_return_val_if_fail (decoder->fd > 0, NULL);
-  g_return_val_if_fail (len > 0, NULL);
+  g_array_set_size (decoder->damage, 0);
+  decoder->state = rfb_decoder_state_normal;
+  decoder->timed_out = FALSE;
 
-  if (G_UNLIKELY (len > decoder->data_len)) {
-    if (decoder->data)
-      g_free (decoder->data);
-    decoder->data = g_malloc (len);
-    decoder->data_len = len;
+  while (decoder->state != NULL) {
+    if (!decoder->state (decoder)) {
+      if (!decoder->flushing && !decoder->timed_out)
+        decoder->disconnected = TRUE;
+      decoder->state = NULL;
+      return FALSE;
+    }
   }
 
-  while (total < len) {
+  return !decoder->disconnected;
+}
+
+/* Receives at least @len bytes, reading as much as fits in the receive
+ * buffer each time the socket becomes readable */
+static gboolean
+rfb_decoder_fill (RfbDecoder * decoder, guint32 len)
+{
+  guint avail = decoder->recv_end - decoder->recv_start;
+
+  if (decoder->recv_start > 0) {
+    memmove (decoder->recv_buf, decoder->recv_buf + decoder->recv_start,
+        avail);
+    decoder->recv_start = 0;
+    decoder->recv_end = avail;
+  }
+
+  /* a buffer that grew for a large message goes back to the usual size
+   * once the data in it fits */
+  if (len > decoder->recv_size || decoder->recv_buf == NULL ||
+      (decoder->recv_size > RFB_RECV_SIZE && len <= RFB_RECV_SIZE &&
+          avail <= RFB_RECV_SIZE)) {
+    decoder->recv_size = MAX (len, RFB_RECV_SIZE);
+    decoder->recv_buf = g_realloc (decoder->recv_buf, decoder->recv_size);
+  }
+
+  while (decoder->recv_end < len) {
+    GstClockTime timeout = GST_CLOCK_TIME_NONE;
+    gssize now;
+    gint res;
+
+    /* only the start of a message can be waited for with a timeout, after
+     * that the rest of the message has to follow */
+    if (decoder->state == rfb_decoder_state_normal)
+      timeout = decoder->timeout;
+
+    res = gst_poll_wait (decoder->poll, timeout);
+    if (res == 0) {
+      GST_LOG ("no message from the server within %" GST_TIME_FORMAT,
+          GST_TIME_ARGS (timeout));
+      decoder->timed_out = TRUE;
+      return FALSE;
+    }
+    if (res < 0) {
+      if (errno == EBUSY) {
+        GST_DEBUG ("flushing");
+        return FALSE;
+      }
+      if (errno == EINTR || errno == EAGAIN)
+        continue;
+      GST_WARNING ("waiting for the socket failed: %s", g_strerror (errno));
+      decoder->disconnected = TRUE;
+      return FALSE;
+    }
+
 #ifndef G_OS_WIN32
-    now = recv (decoder->fd, decoder->data + total, len - total, 0);
+    now = recv (decoder->fd, decoder->recv_buf + decoder->recv_end,
+        decoder->recv_size - decoder->recv_end, 0);
 #else
-    now = recv (decoder->fd, (char *) decoder->data + total, len - total, 0);
+    now = recv (decoder->fd, (char *) decoder->recv_buf + decoder->recv_end,
+        decoder->recv_size - decoder->recv_end, 0);
 #endif
     if (now <= 0) {
       decoder->disconnected = TRUE;
       GST_WARNING ("rfb read error on socket");
+      return FALSE;
+    }
+    decoder->recv_end += now;
+  }
+
+  return TRUE;
+}
+
+/* Returns the next @len bytes of the stream, they stay valid until the next
+ * read */
+static guint8 *
+rfb_decoder_read (RfbDecoder * decoder, guint32 len)
+{
+  g_return_val_if_fail (decoder->fd > 0, NULL);
+
+  if (G_UNLIKELY (decoder->recv_end - decoder->recv_start < len ||
+          decoder->recv_buf == NULL)) {
+    if (!rfb_decoder_fill (decoder, len)) {
+      /* a message that was partly read can't be resumed */
+      if (decoder->state != rfb_decoder_state_normal)
+        decoder->disconnected = TRUE;
       return NULL;
     }
-    total += now;
   }
+
+  decoder->data = decoder->recv_buf + decoder->recv_start;
+  decoder->recv_start += len;
+
   return decoder->data;
 }
 
@@ -219,13 +460,7 @@ rfb_decoder_send_update_request (RfbDecoder * decoder,
 
   rfb_decoder_send (decoder, data, 10);
 
-  /* create a backup of the prev frame for copyrect encoding */
-  if (decoder->use_copyrect) {
-    memcpy (decoder->prev_frame, decoder->frame,
-        decoder->rect_width * decoder->rect_height * decoder->bpp / 8);
-  }
-
-  decoder->state = rfb_decoder_state_normal;
+  decoder->update_pending = TRUE;
 }
 
 void
@@ -271,7 +506,8 @@ rfb_decoder_send_pointer_event (RfbDecoder * decoder,
 static gboolean
 rfb_decoder_state_wait_for_protocol_version (RfbDecoder * decoder)
 {
-  rfb_decoder_read (decoder, 12);
+  if (!rfb_decoder_read (decoder, 12))
+    return FALSE;
 
   g_return_val_if_fail (memcmp (decoder->data, "RFB 003.00", 10) == 0, FALSE);
   g_return_val_if_fail (*(decoder->data + 11) == 0x0a, FALSE);
@@ -311,13 +547,20 @@ rfb_decoder_state_wait_for_protocol_version (RfbDecoder * decoder)
 static gboolean
 rfb_decoder_state_reason (RfbDecoder * decoder)
 {
-  gint reason_length;
+  guint32 reason_length;
 
-  rfb_decoder_read (decoder, 4);
+  if (!rfb_decoder_read (decoder, 4))
+    return FALSE;
 
   reason_length = RFB_GET_UINT32 (decoder->data);
-  rfb_decoder_read (decoder, reason_length);
-  GST_WARNING ("Reason by server: %s", decoder->data);
+  if (reason_length > RFB_MAX_TEXT_SIZE) {
+    GST_WARNING ("Reason of %u bytes is too long", reason_length);
+    return FALSE;
+  }
+  if (!rfb_decoder_read (decoder, reason_length))
+    return FALSE;
+  GST_WARNING ("Reason by server: %.*s", (gint) reason_length,
+      decoder->data);
 
   return FALSE;
 }
@@ -333,7 +576,8 @@ rfb_decoder_state_wait_for_security (RfbDecoder * decoder)
    * above.
    */
   if (IS_VERSION_3_3 (decoder)) {
-    rfb_decoder_read (decoder, 4);
+    if (!rfb_decoder_read (decoder, 4))
+      return FALSE;
 
     decoder->security_type = RFB_GET_UINT32 (decoder->data);
     GST_DEBUG ("security = %d", decoder->security_type);
@@ -368,7 +612,8 @@ rfb_decoder_state_wait_for_security (RfbDecoder * decoder)
         return FALSE;
       }
 
-      rfb_decoder_read (decoder, 16);
+      if (!rfb_decoder_read (decoder, 16))
+        return FALSE;
       vncEncryptBytes ((unsigned char *) decoder->data, decoder->password);
       rfb_decoder_send (decoder, decoder->data, 16);
 
@@ -391,7 +636,8 @@ rfb_decoder_state_wait_for_security (RfbDecoder * decoder)
 static gboolean
 rfb_decoder_state_security_result (RfbDecoder * decoder)
 {
-  rfb_decoder_read (decoder, 4);
+  if (!rfb_decoder_read (decoder, 4))
+    return FALSE;
   if (RFB_GET_UINT32 (decoder->data) != 0) {
     GST_WARNING ("Security handshaking failed");
     if (IS_VERSION_3_8 (decoder)) {
@@ -445,6 +691,13 @@ rfb_decoder_state_set_encodings (RfbDecoder * decoder)
 
   GST_DEBUG ("entered set encodings");
 
+#ifdef HAVE_ZLIB
+  /* no JPEG quality level is sent, so Tight is only used lossless */
+  encoder_list =
+      g_slist_append (encoder_list, GUINT_TO_POINTER (ENCODING_TYPE_TIGHT));
+  encoder_list =
+      g_slist_append (encoder_list, GUINT_TO_POINTER (ENCODING_TYPE_ZRLE));
+#endif
   encoder_list =
       g_slist_append (encoder_list, GUINT_TO_POINTER (ENCODING_TYPE_HEXTILE));
   encoder_list =
@@ -464,6 +717,7 @@ rfb_decoder_state_set_encodings (RfbDecoder * decoder)
   rfb_decoder_send (decoder, message, 4 + 4 * g_slist_length (encoder_list));
 
   g_free (message);
+  g_slist_free (encoder_list);
 
   decoder->state = rfb_decoder_state_normal;
   decoder->inited = TRUE;
@@ -489,7 +743,8 @@ rfb_decoder_state_wait_for_server_initialisation (RfbDecoder * decoder)
 {
   guint32 name_length;
 
-  rfb_decoder_read (decoder, 24);
+  if (!rfb_decoder_read (decoder, 24))
+    return FALSE;
 
   decoder->width = RFB_GET_UINT16 (decoder->data + 0);
   decoder->height = RFB_GET_UINT16 (decoder->data + 2);
@@ -519,12 +774,39 @@ rfb_decoder_state_wait_for_server_initialisation (RfbDecoder * decoder)
   GST_DEBUG ("blue_shift = %d", decoder->blue_shift);
 
   name_length = RFB_GET_UINT32 (decoder->data + 20);
+  if (name_length > RFB_MAX_TEXT_SIZE) {
+    GST_WARNING ("Desktop name of %u bytes is too long", name_length);
+    return FALSE;
+  }
 
-  rfb_decoder_read (decoder, name_length);
+  if (!rfb_decoder_read (decoder, name_length))
+    return FALSE;
 
   decoder->name = g_strndup ((gchar *) (decoder->data), name_length);
   GST_DEBUG ("name       = %s", decoder->name);
 
+  /* ZRLE sends 3 bytes for 32 bit pixels when the colours fit in 3 of
+   * them, Tight sends them as RGB when they are 24 bit colours */
+  decoder->cpixel_size = decoder->bpp / 8;
+  decoder->cpixel_offset = 0;
+  decoder->tight_rgb = FALSE;
+  if (decoder->true_colour && decoder->bpp == 32 && decoder->depth <= 24) {
+    guint32 mask = (decoder->red_max << decoder->red_shift) |
+        (decoder->green_max << decoder->green_shift) |
+        (decoder->blue_max << decoder->blue_shift);
+
+    if (mask <= 0xffffff) {
+      decoder->cpixel_size = 3;
+      decoder->cpixel_offset = decoder->big_endian ? 1 : 0;
+    } else if ((mask & 0xff) == 0) {
+      decoder->cpixel_size = 3;
+      decoder->cpixel_offset = decoder->big_endian ? 0 : 1;
+    }
+
+    decoder->tight_rgb = decoder->depth == 24 && decoder->red_max == 255 &&
+        decoder->green_max == 255 && decoder->blue_max == 255;
+  }
+
   /* check if we need cropping */
 
   if (decoder->offset_x > 0) {
@@ -567,7 +849,8 @@ rfb_decoder_state_normal (RfbDecoder * decoder)
 
   GST_DEBUG ("decoder_state_normal");
 
-  rfb_decoder_read (decoder, 1);
+  if (!rfb_decoder_read (decoder, 1))
+    return FALSE;
   message_type = RFB_GET_UINT8 (decoder->data);
 
   switch (message_type) {
@@ -586,7 +869,8 @@ rfb_decoder_state_normal (RfbDecoder * decoder)
       decoder->state = rfb_decoder_state_server_cut_text;
       break;
     default:
-      g_critical ("unknown message type %d", message_type);
+      GST_WARNING ("unknown message type %d", message_type);
+      return FALSE;
   }
 
   return TRUE;
@@ -596,12 +880,22 @@ static gboolean
 rfb_decoder_state_framebuffer_update (RfbDecoder * decoder)
 {
 
-  rfb_decoder_read (decoder, 3);
+  if (!rfb_decoder_read (decoder, 3))
+    return FALSE;
 
   decoder->n_rects = RFB_GET_UINT16 (decoder->data + 1);
   GST_DEBUG ("Number of rectangles : %d", decoder->n_rects);
 
-  decoder->state = rfb_decoder_state_framebuffer_update_rectangle;
+  /* let the server prepare the next update while this one is decoded */
+  decoder->update_pending = FALSE;
+  if (decoder->pipeline_updates)
+    rfb_decoder_send_update_request (decoder, TRUE, decoder->offset_x,
+        decoder->offset_y, decoder->rect_width, decoder->rect_height);
+
+  if (decoder->n_rects == 0)
+    decoder->state = NULL;
+  else
+    decoder->state = rfb_decoder_state_framebuffer_update_rectangle;
 
   return TRUE;
 }
@@ -611,8 +905,10 @@ rfb_decoder_state_framebuffer_update_rectangle (RfbDecoder * decoder)
 {
   gint x, y, w, h;
   gint encoding;
+  gboolean ret;
 
-  rfb_decoder_read (decoder, 12);
+  if (!rfb_decoder_read (decoder, 12))
+    return FALSE;
 
   x = RFB_GET_UINT16 (decoder->data + 0) - decoder->offset_x;
   y = RFB_GET_UINT16 (decoder->data + 2) - decoder->offset_y;
@@ -625,8 +921,10 @@ rfb_decoder_state_framebuffer_update_rectangle (RfbDecoder * decoder)
   GST_DEBUG ("w:%d h:%d", w, h);
   GST_DEBUG ("encoding: %d", encoding);
 
-  if (((w * h) + (x * y)) > (decoder->width * decoder->height)) {
-    GST_ERROR ("Desktop resize is unsupported.");
+  if (x < 0 || y < 0 || x + w > (gint) decoder->rect_width ||
+      y + h > (gint) decoder->rect_height) {
+    GST_ERROR ("Rectangle outside of the frame, desktop resize is "
+        "unsupported.");
     decoder->state = NULL;
     decoder->disconnected = TRUE;
     return TRUE;
@@ -634,24 +932,42 @@ rfb_decoder_state_framebuffer_update_rectangle (RfbDecoder * decoder)
 
   switch (encoding) {
     case ENCODING_TYPE_RAW:
-      rfb_decoder_raw_encoding (decoder, x, y, w, h);
+      ret = rfb_decoder_raw_encoding (decoder, x, y, w, h);
       break;
     case ENCODING_TYPE_COPYRECT:
-      rfb_decoder_copyrect_encoding (decoder, x, y, w, h);
+      ret = rfb_decoder_copyrect_encoding (decoder, x, y, w, h);
       break;
     case ENCODING_TYPE_RRE:
-      rfb_decoder_rre_encoding (decoder, x, y, w, h);
+      ret = rfb_decoder_rre_encoding (decoder, x, y, w, h);
       break;
     case ENCODING_TYPE_CORRE:
-      rfb_decoder_corre_encoding (decoder, x, y, w, h);
+      ret = rfb_decoder_corre_encoding (decoder, x, y, w, h);
       break;
     case ENCODING_TYPE_HEXTILE:
-      rfb_decoder_hextile_encoding (decoder, x, y, w, h);
+      ret = rfb_decoder_hextile_encoding (decoder, x, y, w, h);
+      break;
+#ifdef HAVE_ZLIB
+    case ENCODING_TYPE_ZRLE:
+      ret = rfb_decoder_zrle_encoding (decoder, x, y, w, h);
       break;
+    case ENCODING_TYPE_TIGHT:
+      ret = rfb_decoder_tight_encoding (decoder, x, y, w, h);
+      break;
+#endif
     default:
-      g_critical ("unimplemented encoding\n");
+      GST_WARNING ("unimplemented encoding %d", encoding);
+      ret = FALSE;
       break;
   }
+  if (!ret)
+    return FALSE;
+
+  if (w > 0 && h > 0) {
+    RfbRectangle rect = { x, y, w, h };
+
+    g_array_append_val (decoder->damage, rect);
+  }
+
   decoder->n_rects--;
   if (decoder->n_rects == 0 || decoder->disconnected == TRUE) {
     decoder->state = NULL;
@@ -661,7 +977,7 @@ rfb_decoder_state_framebuffer_update_rectangle (RfbDecoder * decoder)
   return TRUE;
 }
 
-static void
+static gboolean
 rfb_decoder_raw_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
     gint rect_w, gint rect_h)
 {
@@ -672,11 +988,10 @@ rfb_decoder_raw_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
   raw_line_size = rect_w * decoder->bytespp;
   size = rect_h * raw_line_size;
   GST_DEBUG ("Reading %d bytes (%dx%d)", size, rect_w, rect_h);
-  rfb_decoder_read (decoder, size);
+  if (!rfb_decoder_read (decoder, size))
+    return FALSE;
 
-  frame =
-      decoder->frame + (((start_y * decoder->rect_width) +
-          start_x) * decoder->bytespp);
+  frame = RFB_FRAME_PTR (decoder, start_x, start_y);
   p = decoder->data;
 
   while (rect_h--) {
@@ -684,66 +999,108 @@ rfb_decoder_raw_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
     p += raw_line_size;
     frame += decoder->line_size;
   }
+
+  return TRUE;
 }
 
-static void
+static gboolean
 rfb_decoder_copyrect_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
     gint rect_w, gint rect_h)
 {
-  guint16 src_x, src_y;
+  gint src_x, src_y;
   gint line_width, copyrect_width;
   guint8 *src, *dst;
 
-  rfb_decoder_read (decoder, 4);
+  if (!rfb_decoder_read (decoder, 4))
+    return FALSE;
 
   /* don't forget the offset */
   src_x = RFB_GET_UINT16 (decoder->data) - decoder->offset_x;
   src_y = RFB_GET_UINT16 (decoder->data + 2) - decoder->offset_y;
   GST_DEBUG ("Copyrect from %d %d", src_x, src_y);
 
+  if (src_x < 0 || src_y < 0 || src_x + rect_w > (gint) decoder->rect_width ||
+      src_y + rect_h > (gint) decoder->rect_height) {
+    GST_WARNING ("Copyrect source outside of the frame");
+    return FALSE;
+  }
+
   copyrect_width = rect_w * decoder->bytespp;
   line_width = decoder->line_size;
-  src =
-      decoder->prev_frame + ((src_y * decoder->rect_width) +
-      src_x) * decoder->bytespp;
-  dst =
-      decoder->frame + ((start_y * decoder->rect_width) +
-      start_x) * decoder->bytespp;
+
+  /* the rectangles can overlap, copy from the bottom up when moving down so
+   * that lines are read before they are overwritten */
+  if (src_y < start_y) {
+    src = RFB_FRAME_PTR (decoder, src_x, src_y + rect_h - 1);
+    dst = RFB_FRAME_PTR (decoder, start_x, start_y + rect_h - 1);
+    line_width = -line_width;
+  } else {
+    src = RFB_FRAME_PTR (decoder, src_x, src_y);
+    dst = RFB_FRAME_PTR (decoder, start_x, start_y);
+  }
 
   while (rect_h--) {
-    memcpy (dst, src, copyrect_width);
+    memmove (dst, src, copyrect_width);
     src += line_width;
     dst += line_width;
   }
+
+  return TRUE;
 }
 
+/* fills a rectangle with a pixel in the server format, any bpp */
 static void
-rfb_decoder_fill_rectangle (RfbDecoder * decoder, gint x, gint y, gint w,
-    gint h, guint32 color)
+rfb_decoder_fill_pixel (RfbDecoder * decoder, gint x, gint y, gint w, gint h,
+    const guint8 * pixel)
 {
-  /* fill the whole region with the same color */
-
-  guint32 *offset;
+  guint8 *dst;
   gint i, j;
 
-  for (i = 0; i < h; i++) {
-    offset =
-        (guint32 *) (decoder->frame + ((x + (y +
-                    i) * decoder->rect_width)) * decoder->bytespp);
-    for (j = 0; j < w; j++) {
-      *(offset++) = color;
+  for (j = 0; j < h; j++) {
+    dst = RFB_FRAME_PTR (decoder, x, y + j);
+    for (i = 0; i < w; i++) {
+      memcpy (dst, pixel, decoder->bytespp);
+      dst += decoder->bytespp;
     }
   }
 }
 
+/* fills a rectangle with a colour read as a little endian 32 bit value,
+ * whose first bytes are the pixel as it was received */
 static void
+rfb_decoder_fill_rectangle (RfbDecoder * decoder, gint x, gint y, gint w,
+    gint h, guint32 color)
+{
+  guint8 pixel[4];
+
+  GST_WRITE_UINT32_LE (pixel, color);
+  rfb_decoder_fill_pixel (decoder, x, y, w, h, pixel);
+}
+
+/* sub-rectangles of RRE, CoRRE and hextile must stay inside the rectangle
+ * or tile they are part of */
+static gboolean
+rfb_decoder_check_subrect (gint x, gint y, gint w, gint h, gint rect_w,
+    gint rect_h)
+{
+  if (x + w > rect_w || y + h > rect_h) {
+    GST_WARNING ("Sub-rectangle %dx%d at %d,%d outside of %dx%d", w, h, x, y,
+        rect_w, rect_h);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static gboolean
 rfb_decoder_rre_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
     gint rect_w, gint rect_h)
 {
   guint32 number_of_rectangles, color;
   guint16 x, y, w, h;
 
-  rfb_decoder_read (decoder, 4 + decoder->bytespp);
+  if (!rfb_decoder_read (decoder, 4 + decoder->bytespp))
+    return FALSE;
   number_of_rectangles = RFB_GET_UINT32 (decoder->data);
   color = GUINT32_SWAP_LE_BE ((RFB_GET_UINT32 (decoder->data + 4)));
 
@@ -754,29 +1111,34 @@ rfb_decoder_rre_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
 
   while (number_of_rectangles--) {
 
-    rfb_decoder_read (decoder, decoder->bytespp + 8);
+    if (!rfb_decoder_read (decoder, decoder->bytespp + 8))
+      return FALSE;
     color = GUINT32_SWAP_LE_BE ((RFB_GET_UINT32 (decoder->data)));
     x = RFB_GET_UINT16 (decoder->data + decoder->bytespp);
     y = RFB_GET_UINT16 (decoder->data + decoder->bytespp + 2);
     w = RFB_GET_UINT16 (decoder->data + decoder->bytespp + 4);
     h = RFB_GET_UINT16 (decoder->data + decoder->bytespp + 6);
+    if (!rfb_decoder_check_subrect (x, y, w, h, rect_w, rect_h))
+      return FALSE;
 
     /* draw the rectangle in the foreground */
     rfb_decoder_fill_rectangle (decoder, start_x + x, start_y + y, w, h, color);
   }
+
+  return TRUE;
 }
 
-static void
+static gboolean
 rfb_decoder_corre_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
     gint rect_w, gint rect_h)
 {
   guint32 number_of_rectangles, color;
   guint8 x, y, w, h;
 
-  rfb_decoder_read (decoder, 4 + decoder->bytespp);
+  if (!rfb_decoder_read (decoder, 4 + decoder->bytespp))
+    return FALSE;
   number_of_rectangles = RFB_GET_UINT32 (decoder->data);
   color = GUINT32_SWAP_LE_BE ((RFB_GET_UINT32 (decoder->data + 4)));
-  g_free (decoder->data);
 
   GST_DEBUG ("number of rectangles :%d", number_of_rectangles);
 
@@ -785,26 +1147,30 @@ rfb_decoder_corre_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
 
   while (number_of_rectangles--) {
 
-    rfb_decoder_read (decoder, decoder->bytespp + 4);
+    if (!rfb_decoder_read (decoder, decoder->bytespp + 4))
+      return FALSE;
     color = GUINT32_SWAP_LE_BE ((RFB_GET_UINT32 (decoder->data)));
     x = RFB_GET_UINT8 (decoder->data + decoder->bytespp);
     y = RFB_GET_UINT8 (decoder->data + decoder->bytespp + 1);
     w = RFB_GET_UINT8 (decoder->data + decoder->bytespp + 2);
     h = RFB_GET_UINT8 (decoder->data + decoder->bytespp + 3);
+    if (!rfb_decoder_check_subrect (x, y, w, h, rect_w, rect_h))
+      return FALSE;
 
     /* draw the rectangle in the foreground */
     rfb_decoder_fill_rectangle (decoder, start_x + x, start_y + y, w, h, color);
-
-    g_free (decoder->data);
   }
+
+  return TRUE;
 }
 
-static void
+static gboolean
 rfb_decoder_hextile_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
     gint rect_w, gint rect_h)
 {
   gint32 x, x_count, x_end, x_max, x_max_16;
   gint32 y, y_count, y_end, y_max, y_max_16;
+  gint32 tile_w, tile_h;
   guint8 subencoding, nr_subrect, xy, wh;
   guint32 background, foreground;
 
@@ -821,30 +1187,35 @@ rfb_decoder_hextile_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
   for (y = start_y; y < y_max; y += 16) {
     for (x = start_x; x < x_max; x += 16) {
 
-      rfb_decoder_read (decoder, 1);
+      tile_w = x <= x_max_16 ? 16 : x_end;
+      tile_h = y <= y_max_16 ? 16 : y_end;
+
+      if (!rfb_decoder_read (decoder, 1))
+        return FALSE;
       subencoding = RFB_GET_UINT8 (decoder->data);
 
       if (subencoding & SUBENCODING_RAW) {
-        rfb_decoder_raw_encoding (decoder, x, y,
-            (x <= x_max_16 ? 16 : x_end), (y <= y_max_16 ? 16 : y_end));
+        if (!rfb_decoder_raw_encoding (decoder, x, y, tile_w, tile_h))
+          return FALSE;
         continue;
       }
 
       if (subencoding & SUBENCODING_BACKGROUND) {
-        rfb_decoder_read (decoder, decoder->bytespp);
+        if (!rfb_decoder_read (decoder, decoder->bytespp))
+          return FALSE;
         background = GUINT32_SWAP_LE_BE ((RFB_GET_UINT32 (decoder->data)));
       }
-      rfb_decoder_fill_rectangle (decoder, x, y,
-          (x <= x_max_16 ? 16 : x_end), (y <= y_max_16 ? 16 : y_end),
-          background);
+      rfb_decoder_fill_rectangle (decoder, x, y, tile_w, tile_h, background);
 
       if (subencoding & SUBENCODING_FOREGROUND) {
-        rfb_decoder_read (decoder, decoder->bytespp);
+        if (!rfb_decoder_read (decoder, decoder->bytespp))
+          return FALSE;
         foreground = GUINT32_SWAP_LE_BE ((RFB_GET_UINT32 (decoder->data)));
       }
 
       if (subencoding & SUBENCODING_ANYSUBRECTS) {
-        rfb_decoder_read (decoder, 1);
+        if (!rfb_decoder_read (decoder, 1))
+          return FALSE;
         nr_subrect = RFB_GET_UINT8 (decoder->data);
       } else {
         continue;
@@ -853,7 +1224,8 @@ rfb_decoder_hextile_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
       if (subencoding & SUBENCODING_SUBRECTSCOLORED) {
         guint offset = 0;
 
-        rfb_decoder_read (decoder, nr_subrect * (2 + decoder->bytespp));
+        if (!rfb_decoder_read (decoder, nr_subrect * (2 + decoder->bytespp)))
+          return FALSE;
 
         while (nr_subrect--) {
           foreground =
@@ -861,25 +1233,553 @@ rfb_decoder_hextile_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
           offset += decoder->bytespp;
           xy = RFB_GET_UINT8 (decoder->data + offset++);
           wh = RFB_GET_UINT8 (decoder->data + offset++);
+          if (!rfb_decoder_check_subrect (xy >> 4, xy & 0xF, 1 + (wh >> 4),
+                  1 + (wh & 0xF), tile_w, tile_h))
+            return FALSE;
           rfb_decoder_fill_rectangle (decoder, x + (xy >> 4), y + (xy & 0xF),
               1 + (wh >> 4), 1 + (wh & 0xF), foreground);
         }
       } else {
         guint offset = 0;
 
-        rfb_decoder_read (decoder, 2 * nr_subrect);
+        if (!rfb_decoder_read (decoder, 2 * nr_subrect))
+          return FALSE;
 
         while (nr_subrect--) {
           xy = RFB_GET_UINT8 (decoder->data + offset++);
           wh = RFB_GET_UINT8 (decoder->data + offset++);
+          if (!rfb_decoder_check_subrect (xy >> 4, xy & 0xF, 1 + (wh >> 4),
+                  1 + (wh & 0xF), tile_w, tile_h))
+            return FALSE;
           rfb_decoder_fill_rectangle (decoder, x + (xy >> 4), y + (xy & 0xF),
               1 + (wh >> 4), 1 + (wh & 0xF), foreground);
         }
       }
     }
   }
+
+  return TRUE;
+}
+
+#ifdef HAVE_ZLIB
+static z_stream *
+rfb_decoder_get_stream (gpointer * stream_p)
+{
+  z_stream *stream = *stream_p;
+
+  if (stream == NULL) {
+    stream = g_new0 (z_stream, 1);
+    if (inflateInit (stream) != Z_OK) {
+      GST_WARNING ("could not initialize zlib");
+      g_free (stream);
+      return NULL;
+    }
+    *stream_p = stream;
+  }
+
+  return stream;
 }
 
+/* Largest compressed size of @size bytes of rectangle data, with the sync
+ * flush that ends every rectangle */
+static guint
+rfb_decoder_zlib_bound (guint size)
+{
+  return compressBound (size) + 5;
+}
+
+/* Inflates @len bytes of @data into decoder->zbuf, which grows as more
+ * output comes but never beyond what @max_size needs. The streams are never
+ * finished, the server flushes them at the end of every rectangle. */
+static gboolean
+rfb_decoder_inflate (RfbDecoder * decoder, gpointer * stream_p, guint8 * data,
+    guint len, guint max_size, guint * out_size)
+{
+  z_stream *stream;
+  guint total = 0;
+  gint ret;
+
+  stream = rfb_decoder_get_stream (stream_p);
+  if (stream == NULL)
+    return FALSE;
+
+  stream->next_in = data;
+  stream->avail_in = len;
+
+  do {
+    /* room for one byte more than allowed tells when there is too much */
+    if (total == decoder->zbuf_size) {
+      decoder->zbuf_size = MIN (MAX (2 * decoder->zbuf_size, RFB_ZBUF_SIZE),
+          max_size + 1);
+      decoder->zbuf = g_realloc (decoder->zbuf, decoder->zbuf_size);
+    }
+    stream->next_out = decoder->zbuf + total;
+    stream->avail_out = decoder->zbuf_size - total;
+
+    ret = inflate (stream, Z_SYNC_FLUSH);
+    total = decoder->zbuf_size - stream->avail_out;
+    if (total > max_size) {
+      GST_WARNING ("inflated data larger than the %u bytes of the rectangle",
+          max_size);
+      return FALSE;
+    }
+
+    /* no more output without more input */
+    if (ret == Z_BUF_ERROR || ret == Z_STREAM_END)
+      break;
+    if (ret != Z_OK) {
+      GST_WARNING ("inflate failed: %s", stream->msg ? stream->msg : "");
+      return FALSE;
+    }
+  } while (stream->avail_in > 0 || stream->avail_out == 0);
+
+  *out_size = total;
+
+  return TRUE;
+}
+
+/* expands a ZRLE CPIXEL to a pixel in the server format */
+static inline void
+rfb_decoder_cpixel (RfbDecoder * decoder, guint8 * pixel, const guint8 * data)
+{
+  if (decoder->cpixel_size == decoder->bytespp) {
+    memcpy (pixel, data, decoder->bytespp);
+  } else {
+    memset (pixel, 0, decoder->bytespp);
+    memcpy (pixel + decoder->cpixel_offset, data, 3);
+  }
+}
+
+/* writes @len pixels of a run that starts at pixel @pos of a tile */
+static void
+rfb_decoder_put_run (RfbDecoder * decoder, gint x, gint y, gint w, gint pos,
+    gint len, const guint8 * pixel)
+{
+  gint px = pos % w, py = pos / w;
+  guint8 *dst = RFB_FRAME_PTR (decoder, x + px, y + py);
+
+  while (len--) {
+    memcpy (dst, pixel, decoder->bytespp);
+    dst += decoder->bytespp;
+    if (++px == w) {
+      px = 0;
+      py++;
+      dst = RFB_FRAME_PTR (decoder, x, y + py);
+    }
+  }
+}
+
+#define ZRLE_NEED(n) G_STMT_START {                 \
+  if (G_UNLIKELY ((guint) (end - data) < (guint) (n)))  \
+    goto corrupt;                                   \
+} G_STMT_END
+
+/* reads a ZRLE run length, returns 0 when the data ends first */
+static gint
+rfb_decoder_zrle_run (guint8 ** data_p, guint8 * end)
+{
+  guint8 *data = *data_p;
+  gint len = 1;
+  guint8 b;
+
+  do {
+    if (data == end)
+      return 0;
+    b = *data++;
+    len += b;
+  } while (b == 255);
+
+  *data_p = data;
+  return len;
+}
+
+static guint8 *
+rfb_decoder_zrle_tile (RfbDecoder * decoder, guint8 * data, guint8 * end,
+    gint x, gint y, gint w, gint h)
+{
+  guint cps = decoder->cpixel_size;
+  guint bpp = decoder->bytespp;
+  guint8 palette[128][4];
+  guint8 pixel[4];
+  guint8 *dst;
+  gint subencoding, i, j, n, pos, len, idx;
+
+  ZRLE_NEED (1);
+  subencoding = *data++;
+
+  if (subencoding == 0) {
+    /* raw */
+    ZRLE_NEED (w * h * cps);
+    for (j = 0; j < h; j++) {
+      dst = RFB_FRAME_PTR (decoder, x, y + j);
+      if (cps == bpp) {
+        memcpy (dst, data, w * bpp);
+        data += w * bpp;
+      } else {
+        for (i = 0; i < w; i++) {
+          rfb_decoder_cpixel (decoder, dst, data);
+          dst += bpp;
+          data += cps;
+        }
+      }
+    }
+  } else if (subencoding == 1) {
+    /* solid */
+    ZRLE_NEED (cps);
+    rfb_decoder_cpixel (decoder, pixel, data);
+    data += cps;
+    rfb_decoder_fill_pixel (decoder, x, y, w, h, pixel);
+  } else if (subencoding <= 16) {
+    /* packed palette */
+    gint bits = subencoding == 2 ? 1 : subencoding <= 4 ? 2 : 4;
+    gint row_bytes = (w * bits + 7) / 8;
+
+    ZRLE_NEED (subencoding * cps + row_bytes * h);
+    for (i = 0; i < subencoding; i++) {
+      rfb_decoder_cpixel (decoder, palette[i], data);
+      data += cps;
+    }
+    for (j = 0; j < h; j++) {
+      dst = RFB_FRAME_PTR (decoder, x, y + j);
+      for (i = 0; i < w; i++) {
+        idx = (data[(i * bits) / 8] >> (8 - bits - (i * bits) % 8)) &
+            ((1 << bits) - 1);
+        if (idx >= subencoding)
+          goto corrupt;
+        memcpy (dst, palette[idx], bpp);
+        dst += bpp;
+      }
+      data += row_bytes;
+    }
+  } else if (subencoding == 128) {
+    /* plain RLE */
+    n = w * h;
+    for (pos = 0; pos < n; pos += len) {
+      ZRLE_NEED (cps);
+      rfb_decoder_cpixel (decoder, pixel, data);
+      data += cps;
+      len = rfb_decoder_zrle_run (&data, end);
+      if (len == 0 || len > n - pos)
+        goto corrupt;
+      rfb_decoder_put_run (decoder, x, y, w, pos, len, pixel);
+    }
+  } else if (subencoding >= 130) {
+    /* palette RLE */
+    gint n_colors = subencoding - 128;
+
+    ZRLE_NEED (n_colors * cps);
+    for (i = 0; i < n_colors; i++) {
+      rfb_decoder_cpixel (decoder, palette[i], data);
+      data += cps;
+    }
+    n = w * h;
+    for (pos = 0; pos < n; pos += len) {
+      ZRLE_NEED (1);
+      idx = *data++;
+      len = 1;
+      if (idx & 128) {
+        idx &= 127;
+        len = rfb_decoder_zrle_run (&data, end);
+        if (len == 0)
+          goto corrupt;
+      }
+      if (idx >= n_colors || len > n - pos)
+        goto corrupt;
+      rfb_decoder_put_run (decoder, x, y, w, pos, len, palette[idx]);
+    }
+  } else {
+    goto corrupt;
+  }
+
+  return data;
+
+corrupt:
+  GST_WARNING ("corrupt ZRLE tile at %d,%d", x, y);
+  return NULL;
+}
+
+#undef ZRLE_NEED
+
+static gboolean
+rfb_decoder_zrle_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
+    gint rect_w, gint rect_h)
+{
+  guint64 max_size;
+  guint32 length;
+  guint size, n_tiles;
+  guint8 *data, *end;
+  gint x, y;
+
+  /* the largest tiles are plain RLE with runs of one pixel, or palette RLE
+   * with a 127 colour palette */
+  n_tiles = ((rect_w + ZRLE_TILE_SIZE - 1) / ZRLE_TILE_SIZE) *
+      ((rect_h + ZRLE_TILE_SIZE - 1) / ZRLE_TILE_SIZE);
+  max_size = (guint64) rect_w * rect_h * (decoder->cpixel_size + 1) +
+      (guint64) n_tiles * (1 + 127 * decoder->cpixel_size);
+  if (max_size > G_MAXINT / 2) {
+    GST_WARNING ("ZRLE rectangle %dx%d is too large", rect_w, rect_h);
+    return FALSE;
+  }
+
+  if (!rfb_decoder_read (decoder, 4))
+    return FALSE;
+  length = RFB_GET_UINT32 (decoder->data);
+  GST_DEBUG ("Reading %u bytes of zlib data (%dx%d)", length, rect_w, rect_h);
+  if (length > rfb_decoder_zlib_bound (max_size)) {
+    GST_WARNING ("%u bytes of ZRLE data for a %dx%d rectangle", length,
+        rect_w, rect_h);
+    return FALSE;
+  }
+  if (!rfb_decoder_read (decoder, length))
+    return FALSE;
+
+  if (!rfb_decoder_inflate (decoder, &decoder->zrle_stream, decoder->data,
+          length, max_size, &size))
+    return FALSE;
+
+  data = decoder->zbuf;
+  end = data + size;
+
+  for (y = start_y; y < start_y + rect_h; y += ZRLE_TILE_SIZE) {
+    for (x = start_x; x < start_x + rect_w; x += ZRLE_TILE_SIZE) {
+      data = rfb_decoder_zrle_tile (decoder, data, end, x, y,
+          MIN (ZRLE_TILE_SIZE, start_x + rect_w - x),
+          MIN (ZRLE_TILE_SIZE, start_y + rect_h - y));
+      if (data == NULL)
+        return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/* converts a Tight TPIXEL to a pixel in the server format */
+static inline void
+rfb_decoder_tight_pixel (RfbDecoder * decoder, guint8 * pixel,
+    const guint8 * data)
+{
+  if (decoder->tight_rgb) {
+    guint32 p = (data[0] << decoder->red_shift) |
+        (data[1] << decoder->green_shift) | (data[2] << decoder->blue_shift);
+
+    if (decoder->big_endian)
+      GST_WRITE_UINT32_BE (pixel, p);
+    else
+      GST_WRITE_UINT32_LE (pixel, p);
+  } else {
+    memcpy (pixel, data, decoder->bytespp);
+  }
+}
+
+static gboolean
+rfb_decoder_tight_length (RfbDecoder * decoder, guint32 * length)
+{
+  guint8 b;
+
+  if (!rfb_decoder_read (decoder, 1))
+    return FALSE;
+  b = RFB_GET_UINT8 (decoder->data);
+  *length = b & 0x7f;
+  if (b & 0x80) {
+    if (!rfb_decoder_read (decoder, 1))
+      return FALSE;
+    b = RFB_GET_UINT8 (decoder->data);
+    *length |= (b & 0x7f) << 7;
+    if (b & 0x80) {
+      if (!rfb_decoder_read (decoder, 1))
+        return FALSE;
+      *length |= RFB_GET_UINT8 (decoder->data) << 14;
+    }
+  }
+
+  return TRUE;
+}
+
+/* each colour component is predicted from the pixels left, above and above
+ * left of it, the data holds the differences with the predictions */
+static void
+rfb_decoder_tight_gradient (RfbDecoder * decoder, const guint8 * data,
+    gint start_x, gint start_y, gint rect_w, gint rect_h)
+{
+  guint8 *prev_row, *this_row, *tmp;
+  guint8 *dst;
+  gint x, y, c, est;
+
+  prev_row = g_malloc0 (rect_w * 3);
+  this_row = g_malloc (rect_w * 3);
+
+  for (y = 0; y < rect_h; y++) {
+    dst = RFB_FRAME_PTR (decoder, start_x, start_y + y);
+    for (x = 0; x < rect_w; x++) {
+      for (c = 0; c < 3; c++) {
+        if (x == 0) {
+          est = prev_row[c];
+        } else {
+          est = prev_row[x * 3 + c] + this_row[(x - 1) * 3 + c] -
+              prev_row[(x - 1) * 3 + c];
+          est = CLAMP (est, 0, 255);
+        }
+        this_row[x * 3 + c] = est + *data++;
+      }
+      rfb_decoder_tight_pixel (decoder, dst, this_row + x * 3);
+      dst += decoder->bytespp;
+    }
+    tmp = prev_row;
+    prev_row = this_row;
+    this_row = tmp;
+  }
+
+  g_free (prev_row);
+  g_free (this_row);
+}
+
+static gboolean
+rfb_decoder_tight_encoding (RfbDecoder * decoder, gint start_x, gint start_y,
+    gint rect_w, gint rect_h)
+{
+  guint tps = decoder->tight_rgb ? 3 : decoder->bytespp;
+  guint8 palette[256][4];
+  guint8 pixel[4];
+  guint comp_ctl, filter, n_colors = 0;
+  guint row_size, data_size;
+  guint8 *data, *dst;
+  gint i, j, idx;
+
+  if (!rfb_decoder_read (decoder, 1))
+    return FALSE;
+  comp_ctl = RFB_GET_UINT8 (decoder->data);
+
+  /* the low bits ask to reset the zlib streams */
+  for (i = 0; i < 4; i++) {
+    if ((comp_ctl & (1 << i)) && decoder->tight_streams[i])
+      inflateReset (decoder->tight_streams[i]);
+  }
+  comp_ctl >>= 4;
+
+  if (comp_ctl == TIGHT_FILL) {
+    if (!rfb_decoder_read (decoder, tps))
+      return FALSE;
+    rfb_decoder_tight_pixel (decoder, pixel, decoder->data);
+    rfb_decoder_fill_pixel (decoder, start_x, start_y, rect_w, rect_h, pixel);
+    return TRUE;
+  }
+  if (comp_ctl == TIGHT_JPEG) {
+    GST_WARNING ("Tight JPEG compression is not supported");
+    return FALSE;
+  }
+  if (comp_ctl > TIGHT_MAX_SUBENCODING) {
+    GST_WARNING ("invalid Tight compression control %u", comp_ctl);
+    return FALSE;
+  }
+
+  filter = TIGHT_FILTER_COPY;
+  if (comp_ctl & TIGHT_EXPLICIT_FILTER) {
+    if (!rfb_decoder_read (decoder, 1))
+      return FALSE;
+    filter = RFB_GET_UINT8 (decoder->data);
+  }
+
+  switch (filter) {
+    case TIGHT_FILTER_COPY:
+      row_size = rect_w * tps;
+      break;
+    case TIGHT_FILTER_PALETTE:
+      if (!rfb_decoder_read (decoder, 1))
+        return FALSE;
+      n_colors = RFB_GET_UINT8 (decoder->data) + 1;
+      if (!rfb_decoder_read (decoder, n_colors * tps))
+        return FALSE;
+      for (i = 0; i < n_colors; i++)
+        rfb_decoder_tight_pixel (decoder, palette[i], decoder->data + i * tps);
+      row_size = n_colors == 2 ? (rect_w + 7) / 8 : rect_w;
+      break;
+    case TIGHT_FILTER_GRADIENT:
+      if (!decoder->tight_rgb) {
+        GST_WARNING ("Tight gradient filter is only supported for RGB");
+        return FALSE;
+      }
+      row_size = rect_w * 3;
+      break;
+    default:
+      GST_WARNING ("unknown Tight filter %u", filter);
+      return FALSE;
+  }
+
+  if ((guint64) rect_h * row_size > G_MAXINT / 2) {
+    GST_WARNING ("Tight rectangle %dx%d is too large", rect_w, rect_h);
+    return FALSE;
+  }
+  data_size = rect_h * row_size;
+  if (data_size < TIGHT_MIN_TO_COMPRESS) {
+    if (!rfb_decoder_read (decoder, data_size))
+      return FALSE;
+    data = decoder->data;
+  } else {
+    guint32 length;
+    guint size;
+
+    if (!rfb_decoder_tight_length (decoder, &length))
+      return FALSE;
+    if (length > rfb_decoder_zlib_bound (data_size)) {
+      GST_WARNING ("%u bytes of Tight data for %u bytes", length, data_size);
+      return FALSE;
+    }
+    if (!rfb_decoder_read (decoder, length))
+      return FALSE;
+    if (!rfb_decoder_inflate (decoder,
+            &decoder->tight_streams[comp_ctl & 0x03], decoder->data, length,
+            data_size, &size))
+      return FALSE;
+    if (size < data_size) {
+      GST_WARNING ("Tight data too short, %u < %u", size, data_size);
+      return FALSE;
+    }
+    data = decoder->zbuf;
+  }
+
+  switch (filter) {
+    case TIGHT_FILTER_COPY:
+      for (j = 0; j < rect_h; j++) {
+        dst = RFB_FRAME_PTR (decoder, start_x, start_y + j);
+        if (tps == decoder->bytespp) {
+          memcpy (dst, data, row_size);
+        } else {
+          for (i = 0; i < rect_w; i++) {
+            rfb_decoder_tight_pixel (decoder, dst, data + i * tps);
+            dst += decoder->bytespp;
+          }
+        }
+        data += row_size;
+      }
+      break;
+    case TIGHT_FILTER_PALETTE:
+      for (j = 0; j < rect_h; j++) {
+        dst = RFB_FRAME_PTR (decoder, start_x, start_y + j);
+        for (i = 0; i < rect_w; i++) {
+          if (n_colors == 2)
+            idx = (data[i / 8] >> (7 - i % 8)) & 1;
+          else
+            idx = data[i];
+          if (idx >= n_colors) {
+            GST_WARNING ("Tight palette index %d out of range", idx);
+            return FALSE;
+          }
+          memcpy (dst, palette[idx], decoder->bytespp);
+          dst += decoder->bytespp;
+        }
+        data += row_size;
+      }
+      break;
+    case TIGHT_FILTER_GRADIENT:
+      rfb_decoder_tight_gradient (decoder, data, start_x, start_y, rect_w,
+          rect_h);
+      break;
+  }
+
+  return TRUE;
+}
+#endif
+
 static gboolean
 rfb_decoder_state_set_colour_map_entries (RfbDecoder * decoder)
 {
@@ -891,15 +1791,21 @@ rfb_decoder_state_set_colour_map_entries (RfbDecoder * decoder)
 static gboolean
 rfb_decoder_state_server_cut_text (RfbDecoder * decoder)
 {
-  gint cut_text_length;
+  guint32 cut_text_length;
 
   /* 3 bytes padding, 4 bytes cut_text_length */
-  rfb_decoder_read (decoder, 7);
+  if (!rfb_decoder_read (decoder, 7))
+    return FALSE;
   cut_text_length = RFB_GET_UINT32 (decoder->data + 3);
+  if (cut_text_length > RFB_MAX_TEXT_SIZE) {
+    GST_WARNING ("Cut text of %u bytes is too long", cut_text_length);
+    return FALSE;
+  }
 
-  rfb_decoder_read (decoder, cut_text_length);
-  GST_DEBUG ("rfb_decoder_state_server_cut_text: throw away '%s'",
-      decoder->data);
+  if (!rfb_decoder_read (decoder, cut_text_length))
+    return FALSE;
+  GST_DEBUG ("rfb_decoder_state_server_cut_text: throw away '%.*s'",
+      (gint) cut_text_length, decoder->data);
 
   decoder->state = rfb_decoder_state_normal;
   return TRUE;
@@ -2,6 +2,7 @@
 #define _LIBRFB_DECODER_H_
 
 #include <glib.h>
+#include <gst/gst.h>
 
 G_BEGIN_DECLS enum
 {
@@ -22,6 +23,8 @@ G_BEGIN_DECLS enum
 #define ENCODING_TYPE_RRE                   2
 #define ENCODING_TYPE_CORRE                 4
 #define ENCODING_TYPE_HEXTILE               5
+#define ENCODING_TYPE_TIGHT                 7
+#define ENCODING_TYPE_ZRLE                  16
 
 #define SUBENCODING_RAW                     1
 #define SUBENCODING_BACKGROUND              2
@@ -31,6 +34,14 @@ G_BEGIN_DECLS enum
 
 typedef struct _RfbDecoder RfbDecoder;
 
+typedef struct
+{
+  gint x;
+  gint y;
+  gint width;
+  gint height;
+} RfbRectangle;
+
 struct _RfbDecoder
 {
   /* callbacks */
@@ -39,12 +50,39 @@ struct _RfbDecoder
   gpointer buffer_handler_data;
 
   gint fd;
-
+  GstPoll *poll;
+  GstPollFD pollfd;
+  gboolean flushing;
+  /* how long to wait for the next server message, the wait ends with
+   * timed_out set when it expires */
+  GstClockTime timeout;
+  gboolean timed_out;
+
+  /* received data, data points to the bytes returned by the last read and
+   * stays valid until the next one */
+  guint8 *recv_buf;
+  guint recv_size;
+  guint recv_start;
+  guint recv_end;
   guint8 *data;
-  guint32 data_len;
+
   gpointer decoder_private;
   guint8 *frame;
-  guint8 *prev_frame;
+
+  /* the parts of frame changed by the last framebuffer update */
+  GArray *damage;
+
+  /* an update request was sent and its update was not received yet */
+  gboolean update_pending;
+  /* ask for the next incremental update as soon as one starts arriving */
+  gboolean pipeline_updates;
+
+  /* zlib streams of the ZRLE and Tight encodings and the buffer they are
+   * inflated to */
+  gpointer zrle_stream;
+  gpointer tight_streams[4];
+  guint8 *zbuf;
+  guint zbuf_size;
 
   /* settable properties */
   gboolean shared_flag;
@@ -86,6 +124,11 @@ struct _RfbDecoder
   /* some many used values */
   guint bytespp;
   guint line_size;
+
+  /* compressed pixel sizes of the ZRLE and Tight encodings */
+  guint cpixel_size;
+  guint cpixel_offset;
+  gboolean tight_rgb;
 };
 
 #if 0
@@ -108,7 +151,10 @@ void rfb_decoder_free (RfbDecoder * decoder);
 void rfb_decoder_use_file_descriptor (RfbDecoder * decoder, gint fd);
 gboolean rfb_decoder_connect_tcp (RfbDecoder * decoder,
     gchar * addr, guint port);
+void rfb_decoder_disconnect (RfbDecoder * decoder);
+void rfb_decoder_set_flushing (RfbDecoder * decoder, gboolean flushing);
 gboolean rfb_decoder_iterate (RfbDecoder * decoder);
+gboolean rfb_decoder_read_update (RfbDecoder * decoder);
 void rfb_decoder_send_update_request (RfbDecoder * decoder,
     gboolean incremental, gint x, gint y, gint width, gint height);
 void rfb_decoder_send_key_event (RfbDecoder * decoder,
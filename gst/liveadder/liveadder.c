@@ -35,6 +35,9 @@
  * Unlike the adder, the liveadder mixes the streams according the their
  * timestamps and waits for some milli-seconds before trying doing the mixing.
  *
+ * The volume of each stream can be changed with the "volume" and "mute"
+ * properties of its sink pad.
+ *
  * Last reviewed on 2008-02-10 (0.10.11)
  */
 
@@ -43,6 +46,7 @@
 #endif
 
 #include "liveadder.h"
+#include "gstliveadderorc.h"
 
 #include <gst/audio/audio.h>
 
@@ -50,6 +54,14 @@
 
 #define DEFAULT_LATENCY_MS 60
 
+#define DEFAULT_PAD_VOLUME 1.0
+#define DEFAULT_PAD_MUTE FALSE
+
+/* The ring starts with this many blocks of 10ms and grows up to the maximum
+ * when buffers arrive further ahead */
+#define INITIAL_RING_BLOCKS 16
+#define MAX_RING_BLOCKS 1024
+
 GST_DEBUG_CATEGORY_STATIC (live_adder_debug);
 #define GST_CAT_DEFAULT (live_adder_debug)
 
@@ -82,6 +94,13 @@ enum
   PROP_LATENCY,
 };
 
+enum
+{
+  PROP_PAD_0,
+  PROP_PAD_VOLUME,
+  PROP_PAD_MUTE
+};
+
 typedef struct _GstLiveAdderPadPrivate
 {
   GstSegment segment;
@@ -125,33 +144,120 @@ static gboolean gst_live_adder_sink_event (GstPad * pad, GstEvent * event);
 
 static void reset_pad_private (GstPad * pad);
 
-/* clipping versions */
-#define MAKE_FUNC(name,type,ttype,min,max)                      \
-static void name (type *out, type *in, gint bytes) {            \
-  gint i;                                                       \
-  for (i = 0; i < bytes / sizeof (type); i++)                   \
-    out[i] = CLAMP ((ttype)out[i] + (ttype)in[i], min, max);    \
+/* The clipping versions are in gstliveadderorc.orc, the volume versions
+ * convert the volume to the fixed point format of the Orc functions */
+#define MAKE_VOLUME_FUNC(name,type,shift)                               \
+static void name (type *out, type *in, gdouble volume, guint samples) { \
+  live_adder_orc_##name (out, in, (gint) (volume * (1 << shift) + 0.5), \
+      samples);                                                         \
+}
+
+/* non-clipping versions (for double) */
+#define MAKE_FUNC_NC(name,type)                                         \
+static void name (type *out, type *in, guint samples) {                \
+  guint i;                                                              \
+  for (i = 0; i < samples; i++)                                         \
+    out[i] += in[i];                                                    \
 }
 
-/* non-clipping versions (for float) */
-#define MAKE_FUNC_NC(name,type,ttype)                           \
-static void name (type *out, type *in, gint bytes) {            \
-  gint i;                                                       \
-  for (i = 0; i < bytes / sizeof (type); i++)                   \
-    out[i] = (ttype)out[i] + (ttype)in[i];                      \
+#define MAKE_VOLUME_FUNC_NC(name,type)                                  \
+static void name (type *out, type *in, gdouble volume, guint samples) { \
+  guint i;                                                              \
+  for (i = 0; i < samples; i++)                                         \
+    out[i] += in[i] * volume;                                           \
 }
 
 /* *INDENT-OFF* */
-MAKE_FUNC (add_int32, gint32, gint64, G_MININT32, G_MAXINT32)
-MAKE_FUNC (add_int16, gint16, gint32, G_MININT16, G_MAXINT16)
-MAKE_FUNC (add_int8, gint8, gint16, G_MININT8, G_MAXINT8)
-MAKE_FUNC (add_uint32, guint32, guint64, 0, G_MAXUINT32)
-MAKE_FUNC (add_uint16, guint16, guint32, 0, G_MAXUINT16)
-MAKE_FUNC (add_uint8, guint8, guint16, 0, G_MAXUINT8)
-MAKE_FUNC_NC (add_float64, gdouble, gdouble)
-MAKE_FUNC_NC (add_float32, gfloat, gfloat)
+MAKE_VOLUME_FUNC (add_volume_int32, gint32, 27)
+MAKE_VOLUME_FUNC (add_volume_int16, gint16, 11)
+MAKE_VOLUME_FUNC (add_volume_int8, gint8, 3)
+MAKE_VOLUME_FUNC (add_volume_uint32, guint32, 27)
+MAKE_VOLUME_FUNC (add_volume_uint16, guint16, 11)
+MAKE_VOLUME_FUNC (add_volume_uint8, guint8, 3)
+MAKE_FUNC_NC (add_float64, gdouble)
+MAKE_VOLUME_FUNC_NC (add_volume_float64, gdouble)
 /* *INDENT-ON* */
 
+static void
+add_volume_float32 (gfloat * out, gfloat * in, gdouble volume, guint samples)
+{
+  live_adder_orc_add_volume_float32 (out, in, volume, samples);
+}
+
+
+G_DEFINE_TYPE (GstLiveAdderPad, gst_live_adder_pad, GST_TYPE_PAD);
+
+static void
+gst_live_adder_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstLiveAdderPad *pad = GST_LIVE_ADDER_PAD (object);
+
+  switch (prop_id) {
+    case PROP_PAD_VOLUME:
+      GST_OBJECT_LOCK (pad);
+      pad->volume = g_value_get_double (value);
+      GST_OBJECT_UNLOCK (pad);
+      break;
+    case PROP_PAD_MUTE:
+      GST_OBJECT_LOCK (pad);
+      pad->mute = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (pad);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_live_adder_pad_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstLiveAdderPad *pad = GST_LIVE_ADDER_PAD (object);
+
+  switch (prop_id) {
+    case PROP_PAD_VOLUME:
+      GST_OBJECT_LOCK (pad);
+      g_value_set_double (value, pad->volume);
+      GST_OBJECT_UNLOCK (pad);
+      break;
+    case PROP_PAD_MUTE:
+      GST_OBJECT_LOCK (pad);
+      g_value_set_boolean (value, pad->mute);
+      GST_OBJECT_UNLOCK (pad);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_live_adder_pad_class_init (GstLiveAdderPadClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->set_property = gst_live_adder_pad_set_property;
+  gobject_class->get_property = gst_live_adder_pad_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_PAD_VOLUME,
+      g_param_spec_double ("volume", "Volume",
+          "Volume of this stream in the mix", 0.0, 10.0, DEFAULT_PAD_VOLUME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_PAD_MUTE,
+      g_param_spec_boolean ("mute", "Mute",
+          "Leave this stream out of the mix", DEFAULT_PAD_MUTE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void
+gst_live_adder_pad_init (GstLiveAdderPad * pad)
+{
+  pad->volume = DEFAULT_PAD_VOLUME;
+  pad->mute = DEFAULT_PAD_MUTE;
+}
+
 
 static void
 gst_live_adder_base_init (gpointer klass)
@@ -211,10 +317,9 @@ gst_live_adder_init (GstLiveAdder * adder, GstLiveAdderClass * klass)
   adder->not_empty_cond = g_cond_new ();
 
   adder->next_timestamp = GST_CLOCK_TIME_NONE;
+  adder->wait_sample = G_MAXUINT64;
 
   adder->latency_ms = DEFAULT_LATENCY_MS;
-
-  adder->buffers = g_queue_new ();
 }
 
 
@@ -225,10 +330,8 @@ gst_live_adder_finalize (GObject * object)
 
   g_cond_free (adder->not_empty_cond);
 
-  g_queue_foreach (adder->buffers, (GFunc) gst_mini_object_unref, NULL);
-  while (g_queue_pop_head (adder->buffers)) {
-  }
-  g_queue_free (adder->buffers);
+  g_free (adder->ring);
+  g_free (adder->blocks);
 
   g_list_free (adder->sinkpads);
 
@@ -291,6 +394,64 @@ gst_live_adder_get_property (GObject * object,
 }
 
 
+static void
+gst_live_adder_alloc_ring (GstLiveAdder * adder, guint n_blocks)
+{
+  g_free (adder->ring);
+  g_free (adder->blocks);
+
+  adder->ring = g_malloc0 (n_blocks * adder->block_samples * adder->bps);
+  adder->blocks = g_new0 (GstLiveAdderBlock, n_blocks);
+  adder->ring_blocks = n_blocks;
+  adder->read_block = 0;
+  adder->n_filled = 0;
+}
+
+/* Grows the ring to @n_blocks keeping the blocks that have not been pushed
+ * yet, the free blocks of the ring must always be filled with zeroes */
+static void
+gst_live_adder_grow_ring (GstLiveAdder * adder, guint n_blocks)
+{
+  guint block_size = adder->block_samples * adder->bps;
+  guint8 *ring = g_malloc0 (n_blocks * block_size);
+  GstLiveAdderBlock *blocks = g_new0 (GstLiveAdderBlock, n_blocks);
+  guint64 block;
+
+  GST_DEBUG_OBJECT (adder, "growing the ring from %u to %u blocks",
+      adder->ring_blocks, n_blocks);
+
+  for (block = adder->read_block;
+      block < adder->read_block + adder->ring_blocks; block++) {
+    guint old_slot = block & (adder->ring_blocks - 1);
+    guint new_slot = block & (n_blocks - 1);
+
+    if (adder->blocks[old_slot].end) {
+      memcpy (ring + new_slot * block_size, adder->ring + old_slot * block_size,
+          block_size);
+      blocks[new_slot] = adder->blocks[old_slot];
+    }
+  }
+
+  g_free (adder->ring);
+  g_free (adder->blocks);
+  adder->ring = ring;
+  adder->blocks = blocks;
+  adder->ring_blocks = n_blocks;
+}
+
+static void
+gst_live_adder_clear_ring (GstLiveAdder * adder)
+{
+  if (!adder->ring)
+    return;
+
+  memset (adder->ring, 0,
+      adder->ring_blocks * adder->block_samples * adder->bps);
+  memset (adder->blocks, 0, adder->ring_blocks * sizeof (GstLiveAdderBlock));
+  adder->read_block = 0;
+  adder->n_filled = 0;
+}
+
 /* we can only accept caps that we and downstream can handle. */
 static GstCaps *
 gst_live_adder_sink_getcaps (GstPad * pad)
@@ -331,6 +492,7 @@ gst_live_adder_setcaps (GstPad * pad, GstCaps * caps)
   GList *pads;
   GstStructure *structure;
   const char *media_type;
+  gint old_rate, old_bps;
 
   adder = GST_LIVE_ADDER (GST_PAD_PARENT (pad));
 
@@ -340,6 +502,8 @@ gst_live_adder_setcaps (GstPad * pad, GstCaps * caps)
   /* FIXME, see if the other pads can accept the format. Also lock the
    * format on the other pads to this new format. */
   GST_OBJECT_LOCK (adder);
+  old_rate = adder->rate;
+  old_bps = adder->bps;
   pads = GST_ELEMENT (adder)->pads;
   while (pads) {
     GstPad *otherpad = GST_PAD (pads->data);
@@ -366,18 +530,31 @@ gst_live_adder_setcaps (GstPad * pad, GstCaps * caps)
 
     switch (adder->width) {
       case 8:
-        adder->func = (adder->is_signed ?
-            (GstLiveAdderFunction) add_int8 : (GstLiveAdderFunction) add_uint8);
+        if (adder->is_signed) {
+          adder->func = (GstLiveAdderFunction) live_adder_orc_add_int8;
+          adder->volume_func = (GstLiveAdderVolumeFunction) add_volume_int8;
+        } else {
+          adder->func = (GstLiveAdderFunction) live_adder_orc_add_uint8;
+          adder->volume_func = (GstLiveAdderVolumeFunction) add_volume_uint8;
+        }
         break;
       case 16:
-        adder->func = (adder->is_signed ?
-            (GstLiveAdderFunction) add_int16 : (GstLiveAdderFunction)
-            add_uint16);
+        if (adder->is_signed) {
+          adder->func = (GstLiveAdderFunction) live_adder_orc_add_int16;
+          adder->volume_func = (GstLiveAdderVolumeFunction) add_volume_int16;
+        } else {
+          adder->func = (GstLiveAdderFunction) live_adder_orc_add_uint16;
+          adder->volume_func = (GstLiveAdderVolumeFunction) add_volume_uint16;
+        }
         break;
       case 32:
-        adder->func = (adder->is_signed ?
-            (GstLiveAdderFunction) add_int32 : (GstLiveAdderFunction)
-            add_uint32);
+        if (adder->is_signed) {
+          adder->func = (GstLiveAdderFunction) live_adder_orc_add_int32;
+          adder->volume_func = (GstLiveAdderVolumeFunction) add_volume_int32;
+        } else {
+          adder->func = (GstLiveAdderFunction) live_adder_orc_add_uint32;
+          adder->volume_func = (GstLiveAdderVolumeFunction) add_volume_uint32;
+        }
         break;
       default:
         goto not_supported;
@@ -389,10 +566,12 @@ gst_live_adder_setcaps (GstPad * pad, GstCaps * caps)
 
     switch (adder->width) {
       case 32:
-        adder->func = (GstLiveAdderFunction) add_float32;
+        adder->func = (GstLiveAdderFunction) live_adder_orc_add_float32;
+        adder->volume_func = (GstLiveAdderVolumeFunction) add_volume_float32;
         break;
       case 64:
         adder->func = (GstLiveAdderFunction) add_float64;
+        adder->volume_func = (GstLiveAdderVolumeFunction) add_volume_float64;
         break;
       default:
         goto not_supported;
@@ -406,6 +585,12 @@ gst_live_adder_setcaps (GstPad * pad, GstCaps * caps)
   /* precalc bps */
   adder->bps = (adder->width / 8) * adder->channels;
 
+  /* the data mixed with different caps is dropped */
+  if (!adder->ring || adder->rate != old_rate || adder->bps != old_bps) {
+    adder->block_samples = MAX (adder->rate / 100, 1);
+    gst_live_adder_alloc_ring (adder, INITIAL_RING_BLOCKS);
+  }
+
   GST_OBJECT_UNLOCK (adder);
   return TRUE;
 
@@ -427,9 +612,8 @@ gst_live_adder_flush_start (GstLiveAdder * adder)
   /* mark ourselves as flushing */
   adder->srcresult = GST_FLOW_WRONG_STATE;
 
-  /* Empty the queue */
-  g_queue_foreach (adder->buffers, (GFunc) gst_mini_object_unref, NULL);
-  while (g_queue_pop_head (adder->buffers));
+  /* Empty the ring */
+  gst_live_adder_clear_ring (adder);
 
   /* unlock clock, we just unschedule, the entry will be released by the
    * locking streaming thread. */
@@ -871,13 +1055,10 @@ gst_live_adder_src_event (GstPad * pad, GstEvent * event)
   return result;
 }
 
-static guint
-gst_live_adder_length_from_duration (GstLiveAdder * adder,
-    GstClockTime duration)
+static GstClockTime
+gst_live_adder_sample_to_time (GstLiveAdder * adder, guint64 sample)
 {
-  guint64 ret = (duration * adder->rate / GST_SECOND) * adder->bps;
-
-  return (guint) ret;
+  return gst_util_uint64_scale_int (sample, GST_SECOND, adder->rate);
 }
 
 static GstFlowReturn
@@ -886,8 +1067,11 @@ gst_live_live_adder_chain (GstPad * pad, GstBuffer * buffer)
   GstLiveAdder *adder = GST_LIVE_ADDER (gst_pad_get_parent_element (pad));
   GstLiveAdderPadPrivate *padprivate = NULL;
   GstFlowReturn ret = GST_FLOW_OK;
-  GList *item = NULL;
-  GstClockTime skip = 0;
+  guint64 start, last_block;
+  guint samples;
+  guint8 *data;
+  gdouble volume;
+  gboolean mute;
   gint64 drift = 0;             /* Positive if new buffer after old buffer */
 
   GST_OBJECT_LOCK (adder);
@@ -920,6 +1104,9 @@ gst_live_live_adder_chain (GstPad * pad, GstBuffer * buffer)
     goto out;
   }
 
+  if (!adder->ring)
+    goto not_negotiated;
+
   if (!GST_BUFFER_TIMESTAMP_IS_VALID (buffer))
     goto invalid_timestamp;
 
@@ -992,118 +1179,111 @@ gst_live_live_adder_chain (GstPad * pad, GstBuffer * buffer)
       padprivate->segment.format, GST_BUFFER_TIMESTAMP (buffer));
 
 
-  if (GST_CLOCK_TIME_IS_VALID (adder->next_timestamp) &&
-      GST_BUFFER_TIMESTAMP (buffer) < adder->next_timestamp) {
-    if (GST_BUFFER_TIMESTAMP (buffer) + GST_BUFFER_DURATION (buffer) <
-        adder->next_timestamp) {
+  start = gst_util_uint64_scale_int_round (GST_BUFFER_TIMESTAMP (buffer),
+      adder->rate, GST_SECOND);
+  samples = GST_BUFFER_SIZE (buffer) / adder->bps;
+  data = GST_BUFFER_DATA (buffer);
+
+  if (samples == 0) {
+    gst_buffer_unref (buffer);
+    goto out;
+  }
+
+  /* An empty ring can be moved to the new data, backwards only if nothing
+   * has been pushed yet */
+  if (adder->n_filled == 0 &&
+      (!GST_CLOCK_TIME_IS_VALID (adder->next_timestamp) ||
+          start / adder->block_samples > adder->read_block))
+    adder->read_block = start / adder->block_samples;
+
+  if (start < adder->read_block * adder->block_samples) {
+    guint64 skip = adder->read_block * adder->block_samples - start;
+
+    if (skip >= samples) {
       GST_DEBUG_OBJECT (adder, "Buffer is late, dropping (ts: %" GST_TIME_FORMAT
           " duration: %" GST_TIME_FORMAT ")",
           GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buffer)),
           GST_TIME_ARGS (GST_BUFFER_DURATION (buffer)));
       gst_buffer_unref (buffer);
       goto out;
-    } else {
-      skip = adder->next_timestamp - GST_BUFFER_TIMESTAMP (buffer);
-      GST_DEBUG_OBJECT (adder, "Buffer is partially late, skipping %"
-          GST_TIME_FORMAT, GST_TIME_ARGS (skip));
     }
-  }
-
-  /* If our new buffer's head is higher than the queue's head, lets wake up,
-   * we may not have to wait for as long
-   */
-  if (adder->clock_id &&
-      g_queue_peek_head (adder->buffers) != NULL &&
-      GST_BUFFER_TIMESTAMP (buffer) + skip <
-      GST_BUFFER_TIMESTAMP (g_queue_peek_head (adder->buffers)))
-    gst_clock_id_unschedule (adder->clock_id);
 
-  for (item = g_queue_peek_head_link (adder->buffers);
-      item; item = g_list_next (item)) {
-    GstBuffer *oldbuffer = item->data;
-    GstClockTime old_skip = 0;
-    GstClockTime mix_duration = 0;
-    GstClockTime mix_start = 0;
-    GstClockTime mix_end = 0;
-
-    /* We haven't reached our place yet */
-    if (GST_BUFFER_TIMESTAMP (buffer) + skip >=
-        GST_BUFFER_TIMESTAMP (oldbuffer) + GST_BUFFER_DURATION (oldbuffer))
-      continue;
-
-    /* We're past our place, lets insert ouselves here */
-    if (GST_BUFFER_TIMESTAMP (buffer) + GST_BUFFER_DURATION (buffer) <=
-        GST_BUFFER_TIMESTAMP (oldbuffer))
-      break;
-
-    /* if we reach this spot, we have overlap, so we must mix */
-
-    /* First make a subbuffer with the non-overlapping part */
-    if (GST_BUFFER_TIMESTAMP (buffer) + skip < GST_BUFFER_TIMESTAMP (oldbuffer)) {
-      GstBuffer *subbuffer = NULL;
-      GstClockTime subbuffer_duration = GST_BUFFER_TIMESTAMP (oldbuffer) -
-          (GST_BUFFER_TIMESTAMP (buffer) + skip);
-
-      subbuffer = gst_buffer_create_sub (buffer,
-          gst_live_adder_length_from_duration (adder, skip),
-          gst_live_adder_length_from_duration (adder, subbuffer_duration));
-
-      GST_BUFFER_TIMESTAMP (subbuffer) = GST_BUFFER_TIMESTAMP (buffer) + skip;
-      GST_BUFFER_DURATION (subbuffer) = subbuffer_duration;
+    GST_DEBUG_OBJECT (adder, "Buffer is partially late, skipping %"
+        G_GUINT64_FORMAT " samples", skip);
+    start += skip;
+    samples -= skip;
+    data += skip * adder->bps;
+  }
 
-      skip += subbuffer_duration;
+  /* Make room for the whole buffer */
+  last_block = (start + samples - 1) / adder->block_samples;
+  if (last_block >= adder->read_block + adder->ring_blocks) {
+    guint n_blocks = adder->ring_blocks;
+
+    while (n_blocks < MAX_RING_BLOCKS &&
+        last_block >= adder->read_block + n_blocks)
+      n_blocks *= 2;
+    if (n_blocks != adder->ring_blocks)
+      gst_live_adder_grow_ring (adder, n_blocks);
+
+    if (last_block >= adder->read_block + adder->ring_blocks) {
+      guint64 ring_end = (adder->read_block + adder->ring_blocks) *
+          adder->block_samples;
+
+      if (start >= ring_end) {
+        GST_WARNING_OBJECT (adder, "Buffer is too far ahead, dropping it");
+        gst_buffer_unref (buffer);
+        goto out;
+      }
 
-      g_queue_insert_before (adder->buffers, item, subbuffer);
+      GST_WARNING_OBJECT (adder, "Buffer is too far ahead, dropping its end");
+      samples = ring_end - start;
     }
+  }
 
-    /* Now we are on the overlapping part */
-    oldbuffer = gst_buffer_make_writable (oldbuffer);
-    item->data = oldbuffer;
-
-    old_skip = GST_BUFFER_TIMESTAMP (buffer) + skip -
-        GST_BUFFER_TIMESTAMP (oldbuffer);
-
-    mix_start = GST_BUFFER_TIMESTAMP (oldbuffer) + old_skip;
-
-    if (GST_BUFFER_TIMESTAMP (buffer) + GST_BUFFER_DURATION (buffer) <
-        GST_BUFFER_TIMESTAMP (oldbuffer) + GST_BUFFER_DURATION (oldbuffer))
-      mix_end = GST_BUFFER_TIMESTAMP (buffer) + GST_BUFFER_DURATION (buffer);
-    else
-      mix_end = GST_BUFFER_TIMESTAMP (oldbuffer) +
-          GST_BUFFER_DURATION (oldbuffer);
+  /* If our new buffer is before the one the src task waits for, lets wake it
+   * up, we may not have to wait for as long */
+  if (adder->clock_id && start < adder->wait_sample)
+    gst_clock_id_unschedule (adder->clock_id);
 
-    mix_duration = mix_end - mix_start;
+  GST_OBJECT_LOCK (pad);
+  volume = GST_LIVE_ADDER_PAD (pad)->volume;
+  mute = GST_LIVE_ADDER_PAD (pad)->mute;
+  GST_OBJECT_UNLOCK (pad);
+
+  /* Mix block by block, a muted stream still marks its part of the blocks as
+   * filled so that silence is pushed */
+  while (samples > 0) {
+    guint offset = start % adder->block_samples;
+    guint n = MIN (samples, adder->block_samples - offset);
+    guint slot = (start / adder->block_samples) & (adder->ring_blocks - 1);
+    GstLiveAdderBlock *block = &adder->blocks[slot];
+    guint8 *out = adder->ring + (slot * adder->block_samples + offset) *
+        adder->bps;
+
+    if (!mute) {
+      if (volume == 1.0)
+        adder->func (out, data, n * adder->channels);
+      else
+        adder->volume_func (out, data, volume, n * adder->channels);
+    }
 
-    adder->func (GST_BUFFER_DATA (oldbuffer) +
-        gst_live_adder_length_from_duration (adder, old_skip),
-        GST_BUFFER_DATA (buffer) +
-        gst_live_adder_length_from_duration (adder, skip),
-        gst_live_adder_length_from_duration (adder, mix_duration));
+    if (block->end == 0) {
+      block->start = offset;
+      block->end = offset + n;
+      adder->n_filled++;
+    } else {
+      block->start = MIN (block->start, offset);
+      block->end = MAX (block->end, offset + n);
+    }
 
-    skip += mix_duration;
+    start += n;
+    samples -= n;
+    data += n * adder->bps;
   }
 
   g_cond_broadcast (adder->not_empty_cond);
-
-  if (skip == GST_BUFFER_DURATION (buffer)) {
-    gst_buffer_unref (buffer);
-  } else {
-    if (skip) {
-      GstClockTime subbuffer_duration = GST_BUFFER_DURATION (buffer) - skip;
-      GstClockTime subbuffer_ts = GST_BUFFER_TIMESTAMP (buffer) + skip;
-
-      buffer = gst_buffer_create_sub (buffer,
-          gst_live_adder_length_from_duration (adder, skip),
-          gst_live_adder_length_from_duration (adder, subbuffer_duration));
-      GST_BUFFER_TIMESTAMP (buffer) = subbuffer_ts;
-      GST_BUFFER_DURATION (buffer) = subbuffer_duration;
-    }
-
-    if (item)
-      g_queue_insert_before (adder->buffers, item, buffer);
-    else
-      g_queue_push_tail (adder->buffers, buffer);
-  }
+  gst_buffer_unref (buffer);
 
 out:
 
@@ -1112,6 +1292,15 @@ out:
 
   return ret;
 
+not_negotiated:
+
+  GST_OBJECT_UNLOCK (adder);
+  gst_buffer_unref (buffer);
+  GST_DEBUG_OBJECT (adder, "Received buffer before caps");
+  gst_object_unref (adder);
+
+  return GST_FLOW_NOT_NEGOTIATED;
+
 invalid_timestamp:
 
   GST_OBJECT_UNLOCK (adder);
@@ -1173,6 +1362,10 @@ gst_live_adder_loop (gpointer data)
   GstBuffer *buffer = NULL;
   GstFlowReturn result;
   GstEvent *newseg_event = NULL;
+  GstLiveAdderBlock *block;
+  guint64 block_index;
+  guint8 *block_data;
+  guint slot, size;
 
   GST_OBJECT_LOCK (adder);
 
@@ -1181,14 +1374,24 @@ again:
   for (;;) {
     if (adder->srcresult != GST_FLOW_OK)
       goto flushing;
-    if (!g_queue_is_empty (adder->buffers))
+    if (adder->n_filled)
       break;
     if (check_eos_locked (adder))
       goto eos;
     g_cond_wait (adder->not_empty_cond, GST_OBJECT_GET_LOCK (adder));
   }
 
-  buffer_timestamp = GST_BUFFER_TIMESTAMP (g_queue_peek_head (adder->buffers));
+  /* The first block with data, the empty ones before it can still be filled
+   * while we wait */
+  for (block_index = adder->read_block;; block_index++) {
+    slot = block_index & (adder->ring_blocks - 1);
+    if (adder->blocks[slot].end)
+      break;
+  }
+
+  adder->wait_sample = block_index * adder->block_samples +
+      adder->blocks[slot].start;
+  buffer_timestamp = gst_live_adder_sample_to_time (adder, adder->wait_sample);
 
   clock = GST_ELEMENT_CLOCK (adder);
 
@@ -1238,10 +1441,35 @@ again:
 
 push_buffer:
 
-  buffer = g_queue_pop_head (adder->buffers);
-
-  if (!buffer)
+  /* The ring may have been flushed or reallocated while we waited */
+  if (!adder->n_filled)
     goto again;
+  for (block_index = adder->read_block;; block_index++) {
+    slot = block_index & (adder->ring_blocks - 1);
+    if (adder->blocks[slot].end)
+      break;
+  }
+
+  block = &adder->blocks[slot];
+  block_data = adder->ring + (slot * adder->block_samples + block->start) *
+      adder->bps;
+  size = (block->end - block->start) * adder->bps;
+
+  buffer = gst_buffer_new_and_alloc (size);
+  memcpy (GST_BUFFER_DATA (buffer), block_data, size);
+  memset (block_data, 0, size);
+  gst_buffer_set_caps (buffer, GST_PAD_CAPS (adder->srcpad));
+
+  GST_BUFFER_TIMESTAMP (buffer) = gst_live_adder_sample_to_time (adder,
+      block_index * adder->block_samples + block->start);
+  GST_BUFFER_DURATION (buffer) = gst_live_adder_sample_to_time (adder,
+      block_index * adder->block_samples + block->end) -
+      GST_BUFFER_TIMESTAMP (buffer);
+
+  block->start = block->end = 0;
+  adder->n_filled--;
+  adder->read_block = block_index + 1;
+  adder->wait_sample = G_MAXUINT64;
 
   /*
    * We make sure the timestamps are exactly contiguous
@@ -1380,7 +1608,8 @@ gst_live_adder_request_new_pad (GstElement * element, GstPadTemplate * templ,
   padcount = g_atomic_int_exchange_and_add (&adder->padcount, 1);
 
   name = g_strdup_printf ("sink%d", padcount);
-  newpad = gst_pad_new_from_template (templ, name);
+  newpad = g_object_new (GST_TYPE_LIVE_ADDER_PAD, "name", name, "direction",
+      templ->direction, "template", templ, NULL);
   GST_DEBUG_OBJECT (adder, "request new pad %s", name);
   g_free (name);
 
@@ -1519,6 +1748,8 @@ gst_live_adder_change_state (GstElement * element, GstStateChange transition)
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
+  gst_liveadder_orc_init ();
+
   if (!gst_element_register (plugin, "liveadder", GST_RANK_NONE,
           GST_TYPE_LIVE_ADDER)) {
     return FALSE;
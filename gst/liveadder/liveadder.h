@@ -39,6 +39,12 @@ G_BEGIN_DECLS
 typedef struct _GstLiveAdder GstLiveAdder;
 typedef struct _GstLiveAdderClass GstLiveAdderClass;
 
+#define GST_TYPE_LIVE_ADDER_PAD        (gst_live_adder_pad_get_type())
+#define GST_LIVE_ADDER_PAD(obj)        (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_LIVE_ADDER_PAD,GstLiveAdderPad))
+#define GST_IS_LIVE_ADDER_PAD(obj)     (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_LIVE_ADDER_PAD))
+typedef struct _GstLiveAdderPad GstLiveAdderPad;
+typedef struct _GstLiveAdderPadClass GstLiveAdderPadClass;
+
 typedef enum
 {
   GST_LIVE_ADDER_FORMAT_UNSET,
@@ -46,7 +52,16 @@ typedef enum
   GST_LIVE_ADDER_FORMAT_FLOAT
 } GstLiveAdderFormat;
 
-typedef void (*GstLiveAdderFunction) (gpointer out, gpointer in, guint size);
+typedef void (*GstLiveAdderFunction) (gpointer out, gpointer in, guint samples);
+typedef void (*GstLiveAdderVolumeFunction) (gpointer out, gpointer in,
+    gdouble volume, guint samples);
+
+/* the part of a block of the ring that contains data, empty if end is 0 */
+typedef struct
+{
+  guint start;
+  guint end;
+} GstLiveAdderBlock;
 
 /**
  * GstLiveAdder:
@@ -66,8 +81,17 @@ struct _GstLiveAdder
   GstFlowReturn srcresult;
   GstClockID clock_id;
 
-  /* the queue is ordered head to tail */
-  GQueue *buffers;
+  /* the output timeline: a ring of blocks of samples in which the inputs
+   * are mixed at the place of their timestamp */
+  guint8 *ring;
+  GstLiveAdderBlock *blocks;
+  guint ring_blocks;
+  guint block_samples;
+  /* the first block that has not been pushed yet */
+  guint64 read_block;
+  guint n_filled;
+  /* the sample the src task waits for */
+  guint64 wait_sample;
   GCond *not_empty_cond;
 
   GstClockTime next_timestamp;
@@ -86,8 +110,9 @@ struct _GstLiveAdder
   /* number of bytes per sample, actually width/8 * channels */
   gint bps;
 
-  /* function to add samples */
+  /* functions to add samples */
   GstLiveAdderFunction func;
+  GstLiveAdderVolumeFunction volume_func;
 
   GstClockTime latency_ms;
   GstClockTime peer_latency;
@@ -102,7 +127,27 @@ struct _GstLiveAdderClass
   GstElementClass parent_class;
 };
 
+/**
+ * GstLiveAdderPad:
+ *
+ * The sink pads of the adder, with the volume applied to their stream.
+ */
+struct _GstLiveAdderPad
+{
+  /*< private >*/
+  GstPad pad;
+
+  gdouble volume;
+  gboolean mute;
+};
+
+struct _GstLiveAdderPadClass
+{
+  GstPadClass parent_class;
+};
+
 GType gst_live_adder_get_type (void);
+GType gst_live_adder_pad_get_type (void);
 
 G_END_DECLS
 #endif /* __GST_LIVE_ADDER_H__ */
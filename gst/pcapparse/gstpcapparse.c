@@ -17,13 +17,34 @@
  * Boston, MA 02111-1307, USA.
  */
 
+
 /**
  * SECTION:element-pcapparse
  *
  * Extracts payloads from Ethernet-encapsulated IP packets, currently limited
- * to UDP. Use #GstPcapParse:src-ip, #GstPcapParse:dst-ip,
- * #GstPcapParse:src-port and #GstPcapParse:dst-port to restrict which packets
- * should be included.
+ * to UDP over IPv4 and IPv6, optionally VLAN tagged. Both the libpcap and
+ * the pcapng file formats are understood. Use #GstPcapParse:src-ip,
+ * #GstPcapParse:dst-ip, #GstPcapParse:src-port and #GstPcapParse:dst-port to
+ * restrict which packets should be included.
+ *
+ * With #GstPcapParse:multi-flow the packets of every UDP flow, identified by
+ * its addresses and ports, are pushed on a src_%u pad of their own, so that
+ * a single pass over a capture feeds all of them.  The restrictions above
+ * still apply.  A "pcapparse-flow" element message with the addresses and
+ * the ports is posted whenever a new pad is added.
+ *
+ * Payloads are sub-buffers of the input, which is read in large chunks when
+ * upstream supports pull mode.
+ *
+ * With #GstPcapParse:replay the packets are sent with the timing they were
+ * captured with, scaled by #GstPcapParse:speed, on the system clock.  The
+ * packets of #GstPcapParse:batch-time are pushed together as one buffer
+ * list, one group per packet, so that high packet rates do not cost a wakeup
+ * each.  The timestamps are then running times starting at 0, and with
+ * #GstPcapParse:loop the capture is played again and again when upstream
+ * supports pull mode.  #GstPcapParse:target-rate,
+ * #GstPcapParse:achieved-rate and #GstPcapParse:mean-lateness tell how well
+ * the timing is kept.
  *
  * <refsect2>
  * <title>Example pipelines</title>
@@ -32,6 +53,15 @@
  * ! ffdec_h264 ! fakesink
  * ]| Read from a pcap dump file using filesrc, extract the raw UDP packets,
  * depayload and decode them.
+ * |[
+ * gst-launch-0.10 filesrc location=call.pcapng ! pcapparse multi-flow=true
+ * name=p p.src_0 ! queue ! fakesink p.src_1 ! queue ! fakesink
+ * ]| Split the first two UDP flows of a pcapng capture.
+ * |[
+ * gst-launch-0.10 filesrc location=rtp.pcap ! pcapparse replay=true speed=2.0
+ * loop=true ! udpsink host=127.0.0.1 port=5004 sync=false
+ * ]| Send the RTP packets of a capture to a receiver, twice as fast as they
+ * were captured, for ever.
  * </refsect2>
  */
 
@@ -48,14 +78,6 @@
 
 #include <string.h>
 
-#ifndef G_OS_WIN32
-#include <arpa/inet.h>
-#include <netinet/in.h>
-#include <string.h>
-#else
-#include <winsock2.h>
-#endif
-
 enum
 {
   PROP_0,
@@ -64,9 +86,30 @@ enum
   PROP_SRC_PORT,
   PROP_DST_PORT,
   PROP_CAPS,
+  PROP_MULTI_FLOW,
+  PROP_REPLAY,
+  PROP_SPEED,
+  PROP_LOOP,
+  PROP_BATCH_TIME,
+  PROP_TARGET_RATE,
+  PROP_ACHIEVED_RATE,
+  PROP_MEAN_LATENESS,
   PROP_LAST
 };
 
+#define DEFAULT_MULTI_FLOW FALSE
+#define DEFAULT_REPLAY     FALSE
+#define DEFAULT_SPEED      1.0
+#define DEFAULT_LOOP       FALSE
+#define DEFAULT_BATCH_TIME GST_MSECOND
+
+/* bytes pulled at once in pull mode */
+#define PCAP_PARSE_CHUNK_SIZE (1024 * 1024)
+
+/* largest pcapng block or pcap record accepted, a bigger length means a
+ * corrupt file and waiting for it would grow the adapter without a limit */
+#define PCAP_PARSE_MAX_BLOCK_SIZE (16 * 1024 * 1024)
+
 GST_DEBUG_CATEGORY_STATIC (gst_pcap_parse_debug);
 #define GST_CAT_DEFAULT gst_pcap_parse_debug
 
@@ -80,16 +123,35 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+static GstStaticPadTemplate flow_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_SOMETIMES,
+    GST_STATIC_CAPS_ANY);
+
 static void gst_pcap_parse_finalize (GObject * object);
 static void gst_pcap_parse_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec);
 static void gst_pcap_parse_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
+static GstStateChangeReturn gst_pcap_parse_change_state (GstElement * element,
+    GstStateChange transition);
 
 static void gst_pcap_parse_reset (GstPcapParse * self);
+static void gst_pcap_parse_remove_flows (GstPcapParse * self);
+static void gst_pcap_parse_replay_clear (GstPcapParse * self);
+static void gst_pcap_parse_replay_unschedule (GstPcapParse * self);
+static GstFlowReturn gst_pcap_parse_replay_flush (GstPcapParse * self);
 
 static GstFlowReturn gst_pcap_parse_chain (GstPad * pad, GstBuffer * buffer);
 static gboolean gst_pcap_sink_event (GstPad * pad, GstEvent * event);
+static gboolean gst_pcap_parse_sink_activate (GstPad * sinkpad);
+static gboolean gst_pcap_parse_sink_activate_pull (GstPad * sinkpad,
+    gboolean active);
+static void gst_pcap_parse_loop (GstPad * sinkpad);
+
+static guint gst_pcap_parse_flow_key_hash (gconstpointer key);
+static gboolean gst_pcap_parse_flow_key_equal (gconstpointer a,
+    gconstpointer b);
 
 GST_BOILERPLATE (GstPcapParse, gst_pcap_parse, GstElement, GST_TYPE_ELEMENT);
 
@@ -102,6 +164,8 @@ gst_pcap_parse_base_init (gpointer gclass)
       gst_static_pad_template_get (&sink_template));
   gst_element_class_add_pad_template (element_class,
       gst_static_pad_template_get (&src_template));
+  gst_element_class_add_pad_template (element_class,
+      gst_static_pad_template_get (&flow_template));
 
   gst_element_class_set_details_simple (element_class, "PCapParse",
       "Raw/Parser",
@@ -113,6 +177,7 @@ static void
 gst_pcap_parse_class_init (GstPcapParseClass * klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
 
   gobject_class->finalize = gst_pcap_parse_finalize;
   gobject_class->get_property = gst_pcap_parse_get_property;
@@ -143,6 +208,111 @@ gst_pcap_parse_class_init (GstPcapParseClass * klass)
           "The caps of the source pad", GST_TYPE_CAPS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstPcapParse:multi-flow
+   *
+   * Push the packets of every flow on a src_%u pad of its own.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MULTI_FLOW,
+      g_param_spec_boolean ("multi-flow", "Multi flow",
+          "Add a source pad for every flow instead of using the src pad",
+          DEFAULT_MULTI_FLOW, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPcapParse:replay
+   *
+   * Send the packets with the timing they were captured with.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_REPLAY,
+      g_param_spec_boolean ("replay", "Replay",
+          "Pace the packets by their capture time", DEFAULT_REPLAY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPcapParse:speed
+   *
+   * How much faster than captured the packets are replayed.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_SPEED,
+      g_param_spec_double ("speed", "Speed",
+          "Replay speed, 2.0 sends the packets twice as fast as captured",
+          0.001, 1000.0, DEFAULT_SPEED,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPcapParse:loop
+   *
+   * Start over at the end of the capture in replay mode.  Upstream has to
+   * support pull mode.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_LOOP,
+      g_param_spec_boolean ("loop", "Loop",
+          "Replay the capture again at its end", DEFAULT_LOOP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPcapParse:batch-time
+   *
+   * The packets replayed within this time of the first one are pushed
+   * together as one buffer list.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_TIME,
+      g_param_spec_uint64 ("batch-time", "Batch time",
+          "Time window of the packets pushed as one buffer list in replay "
+          "mode (in nanoseconds)", 0, G_MAXUINT64, DEFAULT_BATCH_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPcapParse:target-rate
+   *
+   * The packet rate of the capture at the replay speed, measured up to the
+   * start of the last batch that was pushed.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_TARGET_RATE,
+      g_param_spec_double ("target-rate", "Target rate",
+          "Packets per second that the replay should reach", 0.0, G_MAXDOUBLE,
+          0.0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPcapParse:achieved-rate
+   *
+   * The packet rate that the replay reached, measured like
+   * #GstPcapParse:target-rate.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_ACHIEVED_RATE,
+      g_param_spec_double ("achieved-rate", "Achieved rate",
+          "Packets per second that the replay reached", 0.0, G_MAXDOUBLE,
+          0.0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPcapParse:mean-lateness
+   *
+   * How late the batches were pushed after their deadline on average.  This
+   * is not the variation of the packet spacing.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_MEAN_LATENESS,
+      g_param_spec_uint64 ("mean-lateness", "Mean lateness",
+          "Average lateness of the replayed batches (in nanoseconds)", 0,
+          G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  element_class->change_state = GST_DEBUG_FUNCPTR (gst_pcap_parse_change_state);
+
   GST_DEBUG_CATEGORY_INIT (gst_pcap_parse_debug, "pcapparse", 0, "pcap parser");
 }
 
@@ -152,6 +322,10 @@ gst_pcap_parse_init (GstPcapParse * self, GstPcapParseClass * gclass)
   self->sink_pad = gst_pad_new_from_static_template (&sink_template, "sink");
   gst_pad_set_chain_function (self->sink_pad,
       GST_DEBUG_FUNCPTR (gst_pcap_parse_chain));
+  gst_pad_set_activate_function (self->sink_pad,
+      GST_DEBUG_FUNCPTR (gst_pcap_parse_sink_activate));
+  gst_pad_set_activatepull_function (self->sink_pad,
+      GST_DEBUG_FUNCPTR (gst_pcap_parse_sink_activate_pull));
   gst_pad_use_fixed_caps (self->sink_pad);
   gst_pad_set_event_function (self->sink_pad,
       GST_DEBUG_FUNCPTR (gst_pcap_sink_event));
@@ -161,12 +335,23 @@ gst_pcap_parse_init (GstPcapParse * self, GstPcapParseClass * gclass)
   gst_pad_use_fixed_caps (self->src_pad);
   gst_element_add_pad (GST_ELEMENT (self), self->src_pad);
 
-  self->src_ip = -1;
-  self->dst_ip = -1;
+  self->src_ip = NULL;
+  self->dst_ip = NULL;
   self->src_port = -1;
   self->dst_port = -1;
+  self->multi_flow = DEFAULT_MULTI_FLOW;
+  self->replay = DEFAULT_REPLAY;
+  self->speed = DEFAULT_SPEED;
+  self->loop = DEFAULT_LOOP;
+  self->batch_time = DEFAULT_BATCH_TIME;
+
+  self->replay_clock = gst_system_clock_obtain ();
 
   self->adapter = gst_adapter_new ();
+  self->interfaces = g_array_new (FALSE, FALSE,
+      sizeof (GstPcapParseInterface));
+  self->flows = g_hash_table_new_full (gst_pcap_parse_flow_key_hash,
+      gst_pcap_parse_flow_key_equal, NULL, g_free);
 
   gst_pcap_parse_reset (self);
 }
@@ -176,34 +361,44 @@ gst_pcap_parse_finalize (GObject * object)
 {
   GstPcapParse *self = GST_PCAP_PARSE (object);
 
+  gst_pcap_parse_replay_clear (self);
+  gst_object_unref (self->replay_clock);
   g_object_unref (self->adapter);
+  g_array_free (self->interfaces, TRUE);
+  g_hash_table_destroy (self->flows);
   if (self->caps)
     gst_caps_unref (self->caps);
+  if (self->src_ip)
+    g_object_unref (self->src_ip);
+  if (self->dst_ip)
+    g_object_unref (self->dst_ip);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
-static const gchar *
-get_ip_address_as_string (gint64 ip_addr)
+static gchar *
+get_ip_address_as_string (GInetAddress * ip_addr)
 {
-  if (ip_addr >= 0) {
-    struct in_addr addr;
-    addr.s_addr = ip_addr;
-    return inet_ntoa (addr);
+  if (ip_addr) {
+    return g_inet_address_to_string (ip_addr);
   } else {
-    return "";
+    return g_strdup ("");
   }
 }
 
 static void
-set_ip_address_from_string (gint64 * ip_addr, const gchar * ip_str)
+set_ip_address_from_string (GInetAddress ** ip_addr, const gchar * ip_str)
 {
-  if (ip_str[0] != '\0') {
-    gulong addr = inet_addr (ip_str);
-    if (addr != INADDR_NONE)
+  if (ip_str && ip_str[0] != '\0') {
+    GInetAddress *addr = g_inet_address_new_from_string (ip_str);
+    if (addr) {
+      if (*ip_addr)
+        g_object_unref (*ip_addr);
       *ip_addr = addr;
-  } else {
-    *ip_addr = -1;
+    }
+  } else if (*ip_addr) {
+    g_object_unref (*ip_addr);
+    *ip_addr = NULL;
   }
 }
 
@@ -215,11 +410,11 @@ gst_pcap_parse_get_property (GObject * object, guint prop_id,
 
   switch (prop_id) {
     case PROP_SRC_IP:
-      g_value_set_string (value, get_ip_address_as_string (self->src_ip));
+      g_value_take_string (value, get_ip_address_as_string (self->src_ip));
       break;
 
     case PROP_DST_IP:
-      g_value_set_string (value, get_ip_address_as_string (self->dst_ip));
+      g_value_take_string (value, get_ip_address_as_string (self->dst_ip));
       break;
 
     case PROP_SRC_PORT:
@@ -234,6 +429,55 @@ gst_pcap_parse_get_property (GObject * object, guint prop_id,
       gst_value_set_caps (value, self->caps);
       break;
 
+    case PROP_MULTI_FLOW:
+      g_value_set_boolean (value, self->multi_flow);
+      break;
+
+    case PROP_REPLAY:
+      g_value_set_boolean (value, self->replay);
+      break;
+
+    case PROP_SPEED:
+      g_value_set_double (value, self->speed);
+      break;
+
+    case PROP_LOOP:
+      g_value_set_boolean (value, self->loop);
+      break;
+
+    case PROP_BATCH_TIME:
+      g_value_set_uint64 (value, self->batch_time);
+      break;
+
+    case PROP_TARGET_RATE:
+      GST_OBJECT_LOCK (self);
+      if (self->replay_span > 0)
+        g_value_set_double (value, (gdouble) self->replay_span_packets *
+            GST_SECOND / self->replay_span);
+      else
+        g_value_set_double (value, 0.0);
+      GST_OBJECT_UNLOCK (self);
+      break;
+
+    case PROP_ACHIEVED_RATE:
+      GST_OBJECT_LOCK (self);
+      if (self->replay_elapsed > 0)
+        g_value_set_double (value, (gdouble) self->replay_span_packets *
+            GST_SECOND / self->replay_elapsed);
+      else
+        g_value_set_double (value, 0.0);
+      GST_OBJECT_UNLOCK (self);
+      break;
+
+    case PROP_MEAN_LATENESS:
+      GST_OBJECT_LOCK (self);
+      if (self->replay_batches > 0)
+        g_value_set_uint64 (value, self->lateness_sum / self->replay_batches);
+      else
+        g_value_set_uint64 (value, 0);
+      GST_OBJECT_UNLOCK (self);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -283,6 +527,27 @@ gst_pcap_parse_set_property (GObject * object, guint prop_id,
       gst_pad_set_caps (self->src_pad, new_caps);
       break;
     }
+
+    case PROP_MULTI_FLOW:
+      self->multi_flow = g_value_get_boolean (value);
+      break;
+
+    case PROP_REPLAY:
+      self->replay = g_value_get_boolean (value);
+      break;
+
+    case PROP_SPEED:
+      self->speed = g_value_get_double (value);
+      break;
+
+    case PROP_LOOP:
+      self->loop = g_value_get_boolean (value);
+      break;
+
+    case PROP_BATCH_TIME:
+      self->batch_time = g_value_get_uint64 (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -298,8 +563,60 @@ gst_pcap_parse_reset (GstPcapParse * self)
   self->buffer_offset = 0;
   self->cur_ts = GST_CLOCK_TIME_NONE;
   self->newsegment_sent = FALSE;
+  self->format = PCAP_PARSE_FORMAT_PCAP;
+  self->offset = 0;
 
+  g_array_set_size (self->interfaces, 0);
   gst_adapter_clear (self->adapter);
+
+  gst_pcap_parse_replay_clear (self);
+  self->first_ts = GST_CLOCK_TIME_NONE;
+  self->loop_offset = 0;
+  self->last_running_time = 0;
+  self->replay_start = GST_CLOCK_TIME_NONE;
+
+  GST_OBJECT_LOCK (self);
+  self->replay_packets = 0;
+  self->replay_span_packets = 0;
+  self->replay_batches = 0;
+  self->replay_span = 0;
+  self->replay_elapsed = 0;
+  self->lateness_sum = 0;
+  GST_OBJECT_UNLOCK (self);
+}
+
+static GstStateChangeReturn
+gst_pcap_parse_change_state (GstElement * element, GstStateChange transition)
+{
+  GstPcapParse *self = GST_PCAP_PARSE (element);
+  GstStateChangeReturn ret;
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      GST_OBJECT_LOCK (self);
+      self->flushing = FALSE;
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      /* wake up a replay wait */
+      gst_pcap_parse_replay_unschedule (self);
+      break;
+    default:
+      break;
+  }
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_pcap_parse_reset (self);
+      gst_pcap_parse_remove_flows (self);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
 }
 
 static guint32
@@ -318,86 +635,338 @@ gst_pcap_parse_read_uint32 (GstPcapParse * self, const guint8 * p)
   }
 }
 
+static guint16
+gst_pcap_parse_read_uint16 (GstPcapParse * self, const guint8 * p)
+{
+  guint16 val = *((guint16 *) p);
+
+  if (self->swap_endian) {
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+    return GUINT16_FROM_BE (val);
+#else
+    return GUINT16_FROM_LE (val);
+#endif
+  } else {
+    return val;
+  }
+}
+
+/* FNV-1a over the whole key */
+static guint
+gst_pcap_parse_flow_key_hash (gconstpointer key)
+{
+  const guint8 *p = key;
+  guint32 h = 2166136261u;
+  guint i;
+
+  for (i = 0; i < sizeof (GstPcapParseFlowKey); i++) {
+    h ^= p[i];
+    h *= 16777619u;
+  }
+
+  return h;
+}
+
+static gboolean
+gst_pcap_parse_flow_key_equal (gconstpointer a, gconstpointer b)
+{
+  return memcmp (a, b, sizeof (GstPcapParseFlowKey)) == 0;
+}
+
+static void
+gst_pcap_parse_remove_flows (GstPcapParse * self)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  g_hash_table_iter_init (&iter, self->flows);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    GstPcapParseFlow *flow = value;
+
+    gst_pad_set_active (flow->pad, FALSE);
+    gst_element_remove_pad (GST_ELEMENT_CAST (self), flow->pad);
+  }
+  g_hash_table_remove_all (self->flows);
+  self->n_flows = 0;
+}
+
+static GInetAddress *
+gst_pcap_parse_flow_key_address (const GstPcapParseFlowKey * key,
+    const guint8 * addr)
+{
+  if (key->version == 4)
+    return g_inet_address_new_from_bytes (addr + 12, G_SOCKET_FAMILY_IPV4);
+  else
+    return g_inet_address_new_from_bytes (addr, G_SOCKET_FAMILY_IPV6);
+}
+
+static GstPcapParseFlow *
+gst_pcap_parse_get_flow (GstPcapParse * self, const GstPcapParseFlowKey * key)
+{
+  GstPcapParseFlow *flow;
+  GInetAddress *src, *dst;
+  gchar *name, *src_str, *dst_str;
+  GstStructure *s;
+
+  flow = g_hash_table_lookup (self->flows, key);
+  if (G_LIKELY (flow))
+    return flow;
+
+  flow = g_new0 (GstPcapParseFlow, 1);
+  flow->key = *key;
+  flow->last_ret = GST_FLOW_OK;
+
+  name = g_strdup_printf ("src_%u", self->n_flows++);
+  flow->pad = gst_pad_new_from_static_template (&flow_template, name);
+  g_free (name);
+  gst_pad_use_fixed_caps (flow->pad);
+  if (self->caps)
+    gst_pad_set_caps (flow->pad, self->caps);
+  gst_pad_set_active (flow->pad, TRUE);
+
+  g_hash_table_insert (self->flows, &flow->key, flow);
+
+  src = gst_pcap_parse_flow_key_address (key, key->src_addr);
+  dst = gst_pcap_parse_flow_key_address (key, key->dst_addr);
+  src_str = g_inet_address_to_string (src);
+  dst_str = g_inet_address_to_string (dst);
+  g_object_unref (src);
+  g_object_unref (dst);
+
+  GST_DEBUG_OBJECT (self, "new flow %s:%u -> %s:%u on %s", src_str,
+      key->src_port, dst_str, key->dst_port, GST_PAD_NAME (flow->pad));
+
+  gst_element_add_pad (GST_ELEMENT_CAST (self), flow->pad);
+
+  s = gst_structure_new ("pcapparse-flow",
+      "pad", G_TYPE_STRING, GST_PAD_NAME (flow->pad),
+      "src-ip", G_TYPE_STRING, src_str,
+      "dst-ip", G_TYPE_STRING, dst_str,
+      "src-port", G_TYPE_INT, (gint) key->src_port,
+      "dst-port", G_TYPE_INT, (gint) key->dst_port, NULL);
+  gst_element_post_message (GST_ELEMENT_CAST (self),
+      gst_message_new_element (GST_OBJECT_CAST (self), s));
+
+  g_free (src_str);
+  g_free (dst_str);
+
+  return flow;
+}
+
+/* only NOT_LINKED when no flow is linked */
+static GstFlowReturn
+gst_pcap_parse_combine_flows (GstPcapParse * self, GstPcapParseFlow * flow,
+    GstFlowReturn ret)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  flow->last_ret = ret;
+  if (ret != GST_FLOW_NOT_LINKED)
+    return ret;
+
+  g_hash_table_iter_init (&iter, self->flows);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    if (((GstPcapParseFlow *) value)->last_ret != GST_FLOW_NOT_LINKED)
+      return GST_FLOW_OK;
+  }
+
+  return GST_FLOW_NOT_LINKED;
+}
+
+/* TRUE when one of the pads took the event */
+static gboolean
+gst_pcap_parse_push_event (GstPcapParse * self, GstEvent * event)
+{
+  GHashTableIter iter;
+  gpointer value;
+  gboolean ret = FALSE;
+
+  g_hash_table_iter_init (&iter, self->flows);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    GstPcapParseFlow *flow = value;
+
+    ret |= gst_pad_push_event (flow->pad, gst_event_ref (event));
+  }
+  ret |= gst_pad_push_event (self->src_pad, event);
+
+  return ret;
+}
+
 #define ETH_HEADER_LEN    14
 #define SLL_HEADER_LEN    16
+#define VLAN_HEADER_LEN    4
 #define IP_HEADER_MIN_LEN 20
+#define IP6_HEADER_LEN    40
 #define UDP_HEADER_LEN     8
 
+#define ETH_TYPE_IP       0x0800
+#define ETH_TYPE_IP6      0x86dd
+#define ETH_TYPE_VLAN     0x8100
+#define ETH_TYPE_QINQ     0x88a8
+
+#define IP_PROTO_HOPOPTS   0
 #define IP_PROTO_UDP      17
+#define IP_PROTO_ROUTING  43
+#define IP_PROTO_FRAGMENT 44
+#define IP_PROTO_DSTOPTS  60
+
+static gboolean
+gst_pcap_parse_match_ip (GInetAddress * filter, const guint8 * addr,
+    guint8 version)
+{
+  if (filter == NULL)
+    return TRUE;
+
+  if (version == 4)
+    return g_inet_address_get_family (filter) == G_SOCKET_FAMILY_IPV4 &&
+        memcmp (g_inet_address_to_bytes (filter), addr + 12, 4) == 0;
+  else
+    return g_inet_address_get_family (filter) == G_SOCKET_FAMILY_IPV6 &&
+        memcmp (g_inet_address_to_bytes (filter), addr, 16) == 0;
+}
 
+/* fills in @key for the UDP packet in @buf and points @payload to its
+ * payload, FALSE when the frame is something else or does not match the
+ * restrictions */
 static gboolean
-gst_pcap_parse_scan_frame (GstPcapParse * self,
-    const guint8 * buf,
-    gint buf_size, const guint8 ** payload, gint * payload_size)
+gst_pcap_parse_scan_frame (GstPcapParse * self, GstPcapParseLinktype linktype,
+    const guint8 * buf, gint buf_size, GstPcapParseFlowKey * key,
+    const guint8 ** payload, gint * payload_size)
 {
+  const guint8 *end = buf + buf_size;
   const guint8 *buf_ip = 0;
   const guint8 *buf_udp;
   guint16 eth_type;
   guint8 b;
   guint8 ip_header_size;
   guint8 ip_protocol;
-  guint32 ip_src_addr;
-  guint32 ip_dst_addr;
-  guint16 udp_src_port;
-  guint16 udp_dst_port;
   guint16 udp_len;
 
-  switch (self->linktype) {
+  switch (linktype) {
     case DLT_ETHER:
-      if (buf_size < ETH_HEADER_LEN + IP_HEADER_MIN_LEN + UDP_HEADER_LEN)
-        return FALSE;
-
-      eth_type = GUINT16_FROM_BE (*((guint16 *) (buf + 12)));
-      if (eth_type != 0x800)
+      if (buf_size < ETH_HEADER_LEN)
         return FALSE;
 
+      eth_type = GST_READ_UINT16_BE (buf + 12);
       buf_ip = buf + ETH_HEADER_LEN;
       break;
     case DLT_SLL:
-      if (buf_size < SLL_HEADER_LEN + IP_HEADER_MIN_LEN + UDP_HEADER_LEN)
+      if (buf_size < SLL_HEADER_LEN)
         return FALSE;
 
-      eth_type = GUINT16_FROM_BE (*((guint16 *) (buf + 2)));
-
-      if (eth_type != 1)
+      /* only ethernet devices */
+      if (GST_READ_UINT16_BE (buf + 2) != 1)
         return FALSE;
 
+      eth_type = GST_READ_UINT16_BE (buf + 14);
       buf_ip = buf + SLL_HEADER_LEN;
       break;
+    case DLT_RAW:
+      if (buf_size < 1)
+        return FALSE;
+
+      eth_type = (buf[0] >> 4) == 6 ? ETH_TYPE_IP6 : ETH_TYPE_IP;
+      buf_ip = buf;
+      break;
+    default:
+      return FALSE;
   }
 
-  b = *buf_ip;
-  if (((b >> 4) & 0x0f) != 4)
-    return FALSE;
+  /* skip 802.1Q and 802.1ad tags */
+  while (eth_type == ETH_TYPE_VLAN || eth_type == ETH_TYPE_QINQ) {
+    if (buf_ip + VLAN_HEADER_LEN > end)
+      return FALSE;
+    eth_type = GST_READ_UINT16_BE (buf_ip + 2);
+    buf_ip += VLAN_HEADER_LEN;
+  }
 
-  ip_header_size = (b & 0x0f) * 4;
-  if (buf_ip + ip_header_size > buf + buf_size)
-    return FALSE;
+  memset (key, 0, sizeof (GstPcapParseFlowKey));
 
-  ip_protocol = *(buf_ip + 9);
-  if (ip_protocol != IP_PROTO_UDP)
-    return FALSE;
+  switch (eth_type) {
+    case ETH_TYPE_IP:
+      if (buf_ip + IP_HEADER_MIN_LEN > end)
+        return FALSE;
+
+      b = *buf_ip;
+      if (((b >> 4) & 0x0f) != 4)
+        return FALSE;
+
+      ip_header_size = (b & 0x0f) * 4;
+      if (ip_header_size < IP_HEADER_MIN_LEN || buf_ip + ip_header_size > end)
+        return FALSE;
+
+      /* only the first fragment has the UDP header */
+      if (GST_READ_UINT16_BE (buf_ip + 6) & 0x1fff)
+        return FALSE;
+
+      ip_protocol = *(buf_ip + 9);
+
+      key->version = 4;
+      key->src_addr[10] = key->src_addr[11] = 0xff;
+      key->dst_addr[10] = key->dst_addr[11] = 0xff;
+      memcpy (key->src_addr + 12, buf_ip + 12, 4);
+      memcpy (key->dst_addr + 12, buf_ip + 16, 4);
+
+      buf_udp = buf_ip + ip_header_size;
+      break;
+    case ETH_TYPE_IP6:
+      if (buf_ip + IP6_HEADER_LEN > end)
+        return FALSE;
 
-  ip_src_addr = *((guint32 *) (buf_ip + 12));
-  if (self->src_ip >= 0 && ip_src_addr != self->src_ip)
+      if (((*buf_ip >> 4) & 0x0f) != 6)
+        return FALSE;
+
+      key->version = 6;
+      memcpy (key->src_addr, buf_ip + 8, 16);
+      memcpy (key->dst_addr, buf_ip + 24, 16);
+
+      ip_protocol = *(buf_ip + 6);
+      buf_udp = buf_ip + IP6_HEADER_LEN;
+
+      /* walk the extension headers */
+      while (ip_protocol == IP_PROTO_HOPOPTS ||
+          ip_protocol == IP_PROTO_ROUTING || ip_protocol == IP_PROTO_DSTOPTS ||
+          ip_protocol == IP_PROTO_FRAGMENT) {
+        if (buf_udp + 8 > end)
+          return FALSE;
+
+        if (ip_protocol == IP_PROTO_FRAGMENT) {
+          if (GST_READ_UINT16_BE (buf_udp + 2) & 0xfff8)
+            return FALSE;
+          ip_protocol = buf_udp[0];
+          buf_udp += 8;
+        } else {
+          ip_protocol = buf_udp[0];
+          buf_udp += (buf_udp[1] + 1) * 8;
+        }
+      }
+      break;
+    default:
+      return FALSE;
+  }
+
+  if (ip_protocol != IP_PROTO_UDP)
     return FALSE;
 
-  ip_dst_addr = *((guint32 *) (buf_ip + 16));
-  if (self->dst_ip >= 0 && ip_dst_addr != self->dst_ip)
+  if (buf_udp + UDP_HEADER_LEN > end)
     return FALSE;
 
-  buf_udp = buf_ip + ip_header_size;
+  key->protocol = ip_protocol;
+  key->src_port = GST_READ_UINT16_BE (buf_udp + 0);
+  key->dst_port = GST_READ_UINT16_BE (buf_udp + 2);
 
-  udp_src_port = GUINT16_FROM_BE (*((guint16 *) (buf_udp + 0)));
-  if (self->src_port >= 0 && udp_src_port != self->src_port)
+  if (!gst_pcap_parse_match_ip (self->src_ip, key->src_addr, key->version))
     return FALSE;
-
-  udp_dst_port = GUINT16_FROM_BE (*((guint16 *) (buf_udp + 2)));
-  if (self->dst_port >= 0 && udp_dst_port != self->dst_port)
+  if (!gst_pcap_parse_match_ip (self->dst_ip, key->dst_addr, key->version))
+    return FALSE;
+  if (self->src_port >= 0 && key->src_port != self->src_port)
+    return FALSE;
+  if (self->dst_port >= 0 && key->dst_port != self->dst_port)
     return FALSE;
 
-  udp_len = GUINT16_FROM_BE (*((guint16 *) (buf_udp + 4)));
-  if (udp_len < UDP_HEADER_LEN || buf_udp + udp_len > buf + buf_size)
+  udp_len = GST_READ_UINT16_BE (buf_udp + 4);
+  if (udp_len < UDP_HEADER_LEN || buf_udp + udp_len > end)
     return FALSE;
 
   *payload = buf_udp + UDP_HEADER_LEN;
@@ -406,129 +975,530 @@ gst_pcap_parse_scan_frame (GstPcapParse * self,
   return TRUE;
 }
 
+static void
+gst_pcap_parse_free_list (GstBufferList ** list, GstBufferListIterator ** it)
+{
+  if (*list) {
+    gst_buffer_list_iterator_free (*it);
+    gst_buffer_list_unref (*list);
+    *it = NULL;
+    *list = NULL;
+  }
+}
+
+/* drops the batch that was not pushed yet */
+static void
+gst_pcap_parse_replay_clear (GstPcapParse * self)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  gst_pcap_parse_free_list (&self->src_list, &self->src_list_it);
+
+  g_hash_table_iter_init (&iter, self->flows);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    GstPcapParseFlow *flow = value;
+
+    gst_pcap_parse_free_list (&flow->list, &flow->list_it);
+  }
+
+  self->batch_start = GST_CLOCK_TIME_NONE;
+}
+
+static void
+gst_pcap_parse_replay_unschedule (GstPcapParse * self)
+{
+  GST_OBJECT_LOCK (self);
+  self->flushing = TRUE;
+  if (self->clock_id)
+    gst_clock_id_unschedule (self->clock_id);
+  GST_OBJECT_UNLOCK (self);
+}
+
+/* the capture time of the current packet relative to the first one, scaled
+ * by the speed, it never goes back as captures are not always ordered */
+static GstClockTime
+gst_pcap_parse_replay_running_time (GstPcapParse * self)
+{
+  GstClockTime running_time;
+
+  if (!GST_CLOCK_TIME_IS_VALID (self->cur_ts))
+    return self->last_running_time;
+
+  if (!GST_CLOCK_TIME_IS_VALID (self->first_ts))
+    self->first_ts = self->cur_ts;
+
+  running_time = self->loop_offset;
+  if (self->cur_ts > self->first_ts)
+    running_time += (GstClockTime) ((self->cur_ts - self->first_ts) /
+        self->speed);
+
+  self->last_running_time = MAX (running_time, self->last_running_time);
+
+  return self->last_running_time;
+}
+
+static void
+gst_pcap_parse_replay_add (GstBufferList ** list, GstBufferListIterator ** it,
+    GstBuffer * buf)
+{
+  if (*list == NULL) {
+    *list = gst_buffer_list_new ();
+    *it = gst_buffer_list_iterate (*list);
+  }
+
+  gst_buffer_list_iterator_add_group (*it);
+  gst_buffer_list_iterator_add (*it, buf);
+}
+
 static GstFlowReturn
-gst_pcap_parse_chain (GstPad * pad, GstBuffer * buffer)
+gst_pcap_parse_replay_push (GstPcapParse * self, GstPad * pad,
+    GstBufferList ** list, GstBufferListIterator ** it, guint * packets)
 {
-  GstPcapParse *self = GST_PCAP_PARSE (GST_PAD_PARENT (pad));
-  GstFlowReturn ret = GST_FLOW_OK;
+  GstBufferList *l = *list;
 
-  gst_adapter_push (self->adapter, buffer);
+  if (l == NULL)
+    return GST_FLOW_OK;
 
-  while (ret == GST_FLOW_OK) {
-    gint avail;
-    const guint8 *data;
+  gst_buffer_list_iterator_free (*it);
+  *it = NULL;
+  *list = NULL;
 
-    avail = gst_adapter_available (self->adapter);
+  *packets += gst_buffer_list_n_groups (l);
+
+  return gst_pad_push_list (pad, l);
+}
+
+/* waits until the current batch is due on the system clock and pushes it */
+static GstFlowReturn
+gst_pcap_parse_replay_flush (GstPcapParse * self)
+{
+  GstClockTime deadline, now;
+  GHashTableIter iter;
+  gpointer value;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint packets = 0;
+
+  if (!GST_CLOCK_TIME_IS_VALID (self->batch_start))
+    return GST_FLOW_OK;
 
-    if (self->initialized) {
-      if (self->cur_packet_size >= 0) {
-        if (avail < self->cur_packet_size)
-          break;
+  now = gst_clock_get_time (self->replay_clock);
 
-        if (self->cur_packet_size > 0) {
-          const guint8 *payload_data;
-          gint payload_size;
+  /* the first batch is due right away */
+  if (!GST_CLOCK_TIME_IS_VALID (self->replay_start))
+    self->replay_start = now - MIN (now, self->batch_start);
+  deadline = self->replay_start + self->batch_start;
 
-          data = gst_adapter_peek (self->adapter, self->cur_packet_size);
+  if (deadline > now) {
+    GstClockID id;
+    GstClockReturn cret;
 
-          if (gst_pcap_parse_scan_frame (self, data, self->cur_packet_size,
-                  &payload_data, &payload_size)) {
-            GstBuffer *out_buf;
+    GST_OBJECT_LOCK (self);
+    if (self->flushing) {
+      GST_OBJECT_UNLOCK (self);
+      return GST_FLOW_WRONG_STATE;
+    }
+    id = self->clock_id = gst_clock_new_single_shot_id (self->replay_clock,
+        deadline);
+    GST_OBJECT_UNLOCK (self);
 
-            ret = gst_pad_alloc_buffer_and_set_caps (self->src_pad,
-                self->buffer_offset, payload_size, self->caps, &out_buf);
+    GST_LOG_OBJECT (self, "waiting for batch at %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (self->batch_start));
+    cret = gst_clock_id_wait (id, NULL);
 
-            if (ret == GST_FLOW_OK) {
+    GST_OBJECT_LOCK (self);
+    gst_clock_id_unref (id);
+    self->clock_id = NULL;
+    GST_OBJECT_UNLOCK (self);
 
-              memcpy (GST_BUFFER_DATA (out_buf), payload_data, payload_size);
-              GST_BUFFER_TIMESTAMP (out_buf) = self->cur_ts;
+    if (cret == GST_CLOCK_UNSCHEDULED)
+      return GST_FLOW_WRONG_STATE;
 
-              if (!self->newsegment_sent &&
-                  GST_CLOCK_TIME_IS_VALID (self->cur_ts)) {
-                GstEvent *newsegment =
-                    gst_event_new_new_segment (FALSE, 1, GST_FORMAT_TIME,
-                    self->cur_ts, -1, 0);
-                gst_pad_push_event (self->src_pad, newsegment);
-                self->newsegment_sent = TRUE;
-              }
+    now = gst_clock_get_time (self->replay_clock);
+  }
 
-              ret = gst_pad_push (self->src_pad, out_buf);
+  ret = gst_pcap_parse_replay_push (self, self->src_pad, &self->src_list,
+      &self->src_list_it, &packets);
 
-              self->buffer_offset += payload_size;
-            }
-          }
+  g_hash_table_iter_init (&iter, self->flows);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    GstPcapParseFlow *flow = value;
+    GstFlowReturn fret;
 
-          gst_adapter_flush (self->adapter, self->cur_packet_size);
-        }
+    if (flow->list == NULL)
+      continue;
 
-        self->cur_packet_size = -1;
-      } else {
-        guint32 ts_sec;
-        guint32 ts_usec;
-        guint32 incl_len;
-        guint32 orig_len;
+    fret = gst_pcap_parse_replay_push (self, flow->pad, &flow->list,
+        &flow->list_it, &packets);
+    fret = gst_pcap_parse_combine_flows (self, flow, fret);
+    if (ret == GST_FLOW_OK)
+      ret = fret;
+  }
 
-        if (avail < 16)
-          break;
+  /* the rates count the packets sent before this batch, over the time up to
+   * its start, counting the packets of the last batch as well would need the
+   * time at which the next one starts */
+  GST_OBJECT_LOCK (self);
+  self->replay_span_packets = self->replay_packets;
+  self->replay_packets += packets;
+  self->replay_batches++;
+  self->replay_span = self->batch_start;
+  self->replay_elapsed = now - self->replay_start;
+  self->lateness_sum += now - deadline;
+  GST_OBJECT_UNLOCK (self);
 
-        data = gst_adapter_peek (self->adapter, 16);
+  self->batch_start = GST_CLOCK_TIME_NONE;
 
-        ts_sec = gst_pcap_parse_read_uint32 (self, data + 0);
-        ts_usec = gst_pcap_parse_read_uint32 (self, data + 4);
-        incl_len = gst_pcap_parse_read_uint32 (self, data + 8);
-        orig_len = gst_pcap_parse_read_uint32 (self, data + 12);
+  return ret;
+}
 
-        gst_adapter_flush (self->adapter, 16);
+/* pushes the payload of the captured frame at @offset in @frame, which is
+ * not consumed */
+static GstFlowReturn
+gst_pcap_parse_handle_frame (GstPcapParse * self, GstBuffer * frame,
+    guint offset, guint size, GstPcapParseLinktype linktype)
+{
+  GstPcapParseFlowKey key;
+  GstPcapParseFlow *flow = NULL;
+  const guint8 *payload_data;
+  gint payload_size;
+  GstBuffer *out_buf;
+  GstPad *pad;
+  gboolean *newsegment_sent;
+  gint64 *buffer_offset;
+  GstBufferList **list;
+  GstBufferListIterator **list_it;
+  GstFlowReturn ret;
+
+  if (!gst_pcap_parse_scan_frame (self, linktype,
+          GST_BUFFER_DATA (frame) + offset, size, &key, &payload_data,
+          &payload_size))
+    return GST_FLOW_OK;
+
+  if (self->multi_flow) {
+    flow = gst_pcap_parse_get_flow (self, &key);
+    pad = flow->pad;
+    newsegment_sent = &flow->newsegment_sent;
+    buffer_offset = &flow->buffer_offset;
+    list = &flow->list;
+    list_it = &flow->list_it;
+  } else {
+    pad = self->src_pad;
+    newsegment_sent = &self->newsegment_sent;
+    buffer_offset = &self->buffer_offset;
+    list = &self->src_list;
+    list_it = &self->src_list_it;
+  }
 
-        self->cur_ts = ts_sec * GST_SECOND + ts_usec * GST_USECOND;
-        self->cur_packet_size = incl_len;
+  /* no copy, the payload keeps the input alive */
+  out_buf = gst_buffer_create_sub (frame,
+      payload_data - GST_BUFFER_DATA (frame), payload_size);
+  GST_BUFFER_TIMESTAMP (out_buf) = self->cur_ts;
+  GST_BUFFER_OFFSET (out_buf) = *buffer_offset;
+  gst_buffer_set_caps (out_buf, GST_PAD_CAPS (pad));
+
+  if (self->replay) {
+    GstClockTime running_time = gst_pcap_parse_replay_running_time (self);
+
+    /* push the previous batch when this packet is outside of its window */
+    if (GST_CLOCK_TIME_IS_VALID (self->batch_start) &&
+        running_time >= self->batch_start + self->batch_time) {
+      ret = gst_pcap_parse_replay_flush (self);
+      if (ret != GST_FLOW_OK) {
+        gst_buffer_unref (out_buf);
+        return ret;
       }
-    } else {
+    }
+    if (!GST_CLOCK_TIME_IS_VALID (self->batch_start))
+      self->batch_start = running_time;
+
+    if (!*newsegment_sent) {
+      gst_pad_push_event (pad, gst_event_new_new_segment (FALSE, 1,
+              GST_FORMAT_TIME, 0, -1, 0));
+      *newsegment_sent = TRUE;
+    }
+
+    GST_BUFFER_TIMESTAMP (out_buf) = running_time;
+    gst_pcap_parse_replay_add (list, list_it, out_buf);
+    *buffer_offset += payload_size;
+
+    return GST_FLOW_OK;
+  }
+
+  if (!*newsegment_sent && GST_CLOCK_TIME_IS_VALID (self->cur_ts)) {
+    GstEvent *newsegment =
+        gst_event_new_new_segment (FALSE, 1, GST_FORMAT_TIME,
+        self->cur_ts, -1, 0);
+    gst_pad_push_event (pad, newsegment);
+    *newsegment_sent = TRUE;
+  }
+
+  ret = gst_pad_push (pad, out_buf);
+
+  *buffer_offset += payload_size;
+
+  if (flow)
+    ret = gst_pcap_parse_combine_flows (self, flow, ret);
+
+  return ret;
+}
+
+static gboolean
+gst_pcap_parse_read_file_header (GstPcapParse * self, const guint8 * data)
+{
+  guint32 magic;
+  guint32 linktype;
+  guint16 major_version;
+
+  magic = *((guint32 *) data);
+  major_version = *((guint16 *) (data + 4));
+
+  if (magic == 0xa1b2c3d4) {
+    self->swap_endian = FALSE;
+  } else if (magic == 0xd4c3b2a1) {
+    self->swap_endian = TRUE;
+    major_version = major_version << 8 | major_version >> 8;
+  } else {
+    GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
+        ("File is not a libpcap file, magic is %X", magic));
+    return FALSE;
+  }
+
+  if (major_version != 2) {
+    GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
+        ("File is not a libpcap major version 2, but %u", major_version));
+    return FALSE;
+  }
+
+  linktype = gst_pcap_parse_read_uint32 (self, data + 20);
+
+  if (linktype != DLT_ETHER && linktype != DLT_SLL && linktype != DLT_RAW) {
+    GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
+        ("Only dumps of type Ethernet, raw IP or Linux Coooked (SLL) "
+            "understood, type %d unknown", linktype));
+    return FALSE;
+  }
+
+  self->linktype = linktype;
+
+  return TRUE;
+}
+
+#define PCAPNG_BLOCK_SHB            0x0a0d0d0a
+#define PCAPNG_BLOCK_IDB            0x00000001
+#define PCAPNG_BLOCK_PB             0x00000002
+#define PCAPNG_BLOCK_SPB            0x00000003
+#define PCAPNG_BLOCK_EPB            0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC     0x1a2b3c4d
+#define PCAPNG_OPT_IF_TSRESOL       9
+
+static void
+gst_pcap_parse_read_interface (GstPcapParse * self, const guint8 * data,
+    guint size)
+{
+  GstPcapParseInterface iface;
+  guint pos;
+
+  iface.linktype = gst_pcap_parse_read_uint16 (self, data + 8);
+  iface.ts_units = 1000000;
+
+  /* options until the trailing length */
+  pos = 16;
+  while (pos + 4 <= size - 4) {
+    guint16 code = gst_pcap_parse_read_uint16 (self, data + pos);
+    guint16 len = gst_pcap_parse_read_uint16 (self, data + pos + 2);
+
+    if (code == 0 || pos + 4 + len > size - 4)
+      break;
+
+    if (code == PCAPNG_OPT_IF_TSRESOL && len >= 1) {
+      guint8 res = data[pos + 4];
+      guint i;
+
+      /* a power of 10, or of 2 when the high bit is set */
+      iface.ts_units = 1;
+      for (i = 0; i < MIN (res & 0x7f, (res & 0x80) ? 63 : 19); i++)
+        iface.ts_units *= (res & 0x80) ? 2 : 10;
+    }
+    pos += 4 + GST_ROUND_UP_4 (len);
+  }
+
+  GST_DEBUG_OBJECT (self, "interface %u, linktype %d, %" G_GUINT64_FORMAT
+      " units per second", self->interfaces->len, iface.linktype,
+      iface.ts_units);
+
+  g_array_append_val (self->interfaces, iface);
+}
+
+/* handles one complete pcapng block, @block is not consumed */
+static GstFlowReturn
+gst_pcap_parse_handle_block (GstPcapParse * self, GstBuffer * block)
+{
+  const guint8 *data = GST_BUFFER_DATA (block);
+  guint size = GST_BUFFER_SIZE (block);
+  GstPcapParseInterface *iface;
+  guint32 type, if_id, caplen;
+  guint64 ts;
+
+  type = gst_pcap_parse_read_uint32 (self, data);
+
+  switch (type) {
+    case PCAPNG_BLOCK_IDB:
+      if (size < 20)
+        break;
+      gst_pcap_parse_read_interface (self, data, size);
+      break;
+    case PCAPNG_BLOCK_EPB:
+    case PCAPNG_BLOCK_PB:
+      if (size < 32)
+        break;
+      if (type == PCAPNG_BLOCK_EPB)
+        if_id = gst_pcap_parse_read_uint32 (self, data + 8);
+      else
+        if_id = gst_pcap_parse_read_uint16 (self, data + 8);
+      if (if_id >= self->interfaces->len)
+        break;
+      iface = &g_array_index (self->interfaces, GstPcapParseInterface, if_id);
+
+      ts = ((guint64) gst_pcap_parse_read_uint32 (self, data + 12)) << 32 |
+          gst_pcap_parse_read_uint32 (self, data + 16);
+      self->cur_ts = gst_util_uint64_scale (ts, GST_SECOND, iface->ts_units);
+
+      caplen = gst_pcap_parse_read_uint32 (self, data + 20);
+      if (caplen > size - 32)
+        break;
+      return gst_pcap_parse_handle_frame (self, block, 28, caplen,
+          iface->linktype);
+    case PCAPNG_BLOCK_SPB:
+      if (size < 16 || self->interfaces->len == 0)
+        break;
+      iface = &g_array_index (self->interfaces, GstPcapParseInterface, 0);
+
+      caplen = MIN (gst_pcap_parse_read_uint32 (self, data + 8), size - 16);
+      self->cur_ts = GST_CLOCK_TIME_NONE;
+      return gst_pcap_parse_handle_frame (self, block, 12, caplen,
+          iface->linktype);
+    default:
+      GST_LOG_OBJECT (self, "skipping block of type 0x%08x", type);
+      break;
+  }
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_pcap_parse_process (GstPcapParse * self)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  while (ret == GST_FLOW_OK) {
+    gint avail;
+    const guint8 *data;
+
+    avail = gst_adapter_available (self->adapter);
+
+    if (!self->initialized) {
       guint32 magic;
-      guint32 linktype;
-      guint16 major_version;
 
       if (avail < 24)
         break;
 
       data = gst_adapter_peek (self->adapter, 24);
-
       magic = *((guint32 *) data);
-      major_version = *((guint16 *) (data + 4));
 
-      if (magic == 0xa1b2c3d4) {
-        self->swap_endian = FALSE;
-      } else if (magic == 0xd4c3b2a1) {
-        self->swap_endian = TRUE;
-        major_version = major_version << 8 | major_version >> 8;
+      if (magic == PCAPNG_BLOCK_SHB) {
+        /* the section header block is handled like any other block */
+        self->format = PCAP_PARSE_FORMAT_PCAPNG;
       } else {
-        GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
-            ("File is not a libpcap file, magic is %X", magic));
-        ret = GST_FLOW_ERROR;
-        goto out;
+        if (!gst_pcap_parse_read_file_header (self, data)) {
+          ret = GST_FLOW_ERROR;
+          goto out;
+        }
+        self->format = PCAP_PARSE_FORMAT_PCAP;
+        gst_adapter_flush (self->adapter, 24);
+      }
+      self->initialized = TRUE;
+    } else if (self->format == PCAP_PARSE_FORMAT_PCAPNG) {
+      guint32 type, block_len;
+      GstBuffer *block;
+
+      if (avail < 12)
+        break;
+
+      data = gst_adapter_peek (self->adapter, 12);
+      type = *((guint32 *) data);
+
+      if (type == PCAPNG_BLOCK_SHB) {
+        /* a new section may have a different byte order */
+        guint32 bom = *((guint32 *) (data + 8));
+
+        if (bom == PCAPNG_BYTE_ORDER_MAGIC) {
+          self->swap_endian = FALSE;
+        } else if (bom == GUINT32_SWAP_LE_BE (PCAPNG_BYTE_ORDER_MAGIC)) {
+          self->swap_endian = TRUE;
+        } else {
+          GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
+              ("Invalid pcapng byte order magic %X", bom));
+          ret = GST_FLOW_ERROR;
+          goto out;
+        }
+        g_array_set_size (self->interfaces, 0);
       }
 
-      if (major_version != 2) {
-        GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
-            ("File is not a libpcap major version 2, but %u", major_version));
+      block_len = gst_pcap_parse_read_uint32 (self, data + 4);
+      if (block_len < 12 || block_len % 4 != 0 ||
+          block_len > PCAP_PARSE_MAX_BLOCK_SIZE) {
+        GST_ELEMENT_ERROR (self, STREAM, DECODE, (NULL),
+            ("Invalid pcapng block length %u", block_len));
         ret = GST_FLOW_ERROR;
         goto out;
       }
 
-      linktype = gst_pcap_parse_read_uint32 (self, data + 20);
+      if (avail < block_len)
+        break;
+
+      block = gst_adapter_take_buffer (self->adapter, block_len);
+      ret = gst_pcap_parse_handle_block (self, block);
+      gst_buffer_unref (block);
+    } else if (self->cur_packet_size >= 0) {
+      if (avail < self->cur_packet_size)
+        break;
+
+      if (self->cur_packet_size > 0) {
+        GstBuffer *frame;
+
+        frame = gst_adapter_take_buffer (self->adapter, self->cur_packet_size);
+        ret = gst_pcap_parse_handle_frame (self, frame, 0,
+            self->cur_packet_size, self->linktype);
+        gst_buffer_unref (frame);
+      }
+
+      self->cur_packet_size = -1;
+    } else {
+      guint32 ts_sec;
+      guint32 ts_usec;
+      guint32 incl_len;
+
+      if (avail < 16)
+        break;
+
+      data = gst_adapter_peek (self->adapter, 16);
+
+      ts_sec = gst_pcap_parse_read_uint32 (self, data + 0);
+      ts_usec = gst_pcap_parse_read_uint32 (self, data + 4);
+      incl_len = gst_pcap_parse_read_uint32 (self, data + 8);
+
+      gst_adapter_flush (self->adapter, 16);
 
-      if (linktype != DLT_ETHER && linktype != DLT_SLL) {
-        GST_ELEMENT_ERROR (self, STREAM, WRONG_TYPE, (NULL),
-            ("Only dumps of type Ethernet or Linux Coooked (SLL) understood,"
-                " type %d unknown", linktype));
+      if (incl_len > PCAP_PARSE_MAX_BLOCK_SIZE) {
+        GST_ELEMENT_ERROR (self, STREAM, DECODE, (NULL),
+            ("Invalid packet length %u", incl_len));
         ret = GST_FLOW_ERROR;
         goto out;
       }
 
-      self->linktype = linktype;
-
-      gst_adapter_flush (self->adapter, 24);
-      self->initialized = TRUE;
+      self->cur_ts = ts_sec * GST_SECOND + ts_usec * GST_USECOND;
+      self->cur_packet_size = incl_len;
     }
   }
 
@@ -539,6 +1509,116 @@ out:
   return ret;
 }
 
+static GstFlowReturn
+gst_pcap_parse_chain (GstPad * pad, GstBuffer * buffer)
+{
+  GstPcapParse *self = GST_PCAP_PARSE (GST_PAD_PARENT (pad));
+
+  gst_adapter_push (self->adapter, buffer);
+
+  return gst_pcap_parse_process (self);
+}
+
+static gboolean
+gst_pcap_parse_sink_activate (GstPad * sinkpad)
+{
+  if (gst_pad_check_pull_range (sinkpad)) {
+    GST_DEBUG_OBJECT (sinkpad, "activating pull mode");
+    return gst_pad_activate_pull (sinkpad, TRUE);
+  }
+
+  GST_DEBUG_OBJECT (sinkpad, "activating push mode");
+  return gst_pad_activate_push (sinkpad, TRUE);
+}
+
+static gboolean
+gst_pcap_parse_sink_activate_pull (GstPad * sinkpad, gboolean active)
+{
+  if (active) {
+    return gst_pad_start_task (sinkpad, (GstTaskFunction) gst_pcap_parse_loop,
+        sinkpad);
+  } else {
+    return gst_pad_stop_task (sinkpad);
+  }
+}
+
+/* starts over at the beginning of the file, the replay continues after the
+ * last packet */
+static void
+gst_pcap_parse_replay_rewind (GstPcapParse * self)
+{
+  GST_DEBUG_OBJECT (self, "looping at %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (self->last_running_time));
+
+  self->loop_offset = self->last_running_time + self->batch_time;
+  self->first_ts = GST_CLOCK_TIME_NONE;
+  self->initialized = FALSE;
+  self->cur_packet_size = -1;
+  self->offset = 0;
+
+  g_array_set_size (self->interfaces, 0);
+  gst_adapter_clear (self->adapter);
+}
+
+/* reads the file in large chunks, the payloads are sub-buffers of them */
+static void
+gst_pcap_parse_loop (GstPad * sinkpad)
+{
+  GstPcapParse *self = GST_PCAP_PARSE (GST_PAD_PARENT (sinkpad));
+  GstBuffer *buf = NULL;
+  GstFlowReturn ret;
+
+  ret = gst_pad_pull_range (sinkpad, self->offset, PCAP_PARSE_CHUNK_SIZE,
+      &buf);
+  if (ret == GST_FLOW_OK && GST_BUFFER_SIZE (buf) == 0) {
+    gst_buffer_unref (buf);
+    ret = GST_FLOW_UNEXPECTED;
+  }
+
+  /* only loop when the file had packets */
+  if (ret == GST_FLOW_UNEXPECTED && self->replay && self->loop &&
+      GST_CLOCK_TIME_IS_VALID (self->first_ts)) {
+    gst_pcap_parse_replay_rewind (self);
+    return;
+  }
+
+  if (ret != GST_FLOW_OK)
+    goto pause;
+
+  GST_LOG_OBJECT (self, "pulled %u bytes at offset %" G_GUINT64_FORMAT,
+      GST_BUFFER_SIZE (buf), self->offset);
+  self->offset += GST_BUFFER_SIZE (buf);
+
+  gst_adapter_push (self->adapter, buf);
+  ret = gst_pcap_parse_process (self);
+  if (ret != GST_FLOW_OK)
+    goto pause;
+
+  return;
+
+pause:
+  {
+    /* the last batch is still due */
+    if (ret == GST_FLOW_UNEXPECTED && self->replay &&
+        gst_pcap_parse_replay_flush (self) == GST_FLOW_WRONG_STATE)
+      ret = GST_FLOW_WRONG_STATE;
+
+    GST_DEBUG_OBJECT (self, "pausing task, reason %s",
+        gst_flow_get_name (ret));
+    gst_pad_pause_task (sinkpad);
+
+    if (ret == GST_FLOW_UNEXPECTED) {
+      gst_pcap_parse_push_event (self, gst_event_new_eos ());
+    } else if (ret == GST_FLOW_NOT_LINKED || GST_FLOW_IS_FATAL (ret)) {
+      GST_ELEMENT_ERROR (self, STREAM, FAILED,
+          ("Internal data stream error."),
+          ("streaming stopped, reason %s", gst_flow_get_name (ret)));
+      gst_pcap_parse_push_event (self, gst_event_new_eos ());
+    }
+    return;
+  }
+}
+
 static gboolean
 gst_pcap_sink_event (GstPad * pad, GstEvent * event)
 {
@@ -550,8 +1630,25 @@ gst_pcap_sink_event (GstPad * pad, GstEvent * event)
       /* Drop it, we'll replace it with our own */
       gst_event_unref (event);
       break;
+    case GST_EVENT_FLUSH_START:
+      gst_pcap_parse_replay_unschedule (self);
+      ret = gst_pcap_parse_push_event (self, event);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      GST_OBJECT_LOCK (self);
+      self->flushing = FALSE;
+      GST_OBJECT_UNLOCK (self);
+      gst_pcap_parse_replay_clear (self);
+      ret = gst_pcap_parse_push_event (self, event);
+      break;
+    case GST_EVENT_EOS:
+      /* the last batch goes out before the EOS */
+      if (self->replay)
+        gst_pcap_parse_replay_flush (self);
+      ret = gst_pcap_parse_push_event (self, event);
+      break;
     default:
-      ret = gst_pad_push_event (self->src_pad, event);
+      ret = gst_pcap_parse_push_event (self, event);
       break;
   }
 
@@ -560,7 +1657,6 @@ gst_pcap_sink_event (GstPad * pad, GstEvent * event)
   return ret;
 }
 
-
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
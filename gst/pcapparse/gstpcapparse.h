@@ -22,6 +22,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstadapter.h>
+#include <gio/gio.h>
 
 G_BEGIN_DECLS
 
@@ -48,9 +49,49 @@ typedef enum
 typedef enum
 {
   DLT_ETHER  = 1,
+  DLT_RAW = 101,
   DLT_SLL = 113
 } GstPcapParseLinktype;
 
+typedef enum
+{
+  PCAP_PARSE_FORMAT_PCAP,
+  PCAP_PARSE_FORMAT_PCAPNG
+} GstPcapParseFormat;
+
+/* the addresses are IPv4 mapped for version 4, the key is compared and
+ * hashed as raw memory and must be cleared before it is filled */
+typedef struct
+{
+  guint8 version;
+  guint8 protocol;
+  guint16 src_port;
+  guint16 dst_port;
+  guint8 src_addr[16];
+  guint8 dst_addr[16];
+} GstPcapParseFlowKey;
+
+typedef struct
+{
+  GstPcapParseFlowKey key;
+  GstPad * pad;
+
+  gboolean newsegment_sent;
+  gint64 buffer_offset;
+  GstFlowReturn last_ret;
+
+  /* replay mode, the packets of the current batch */
+  GstBufferList * list;
+  GstBufferListIterator * list_it;
+} GstPcapParseFlow;
+
+/* a pcapng interface description */
+typedef struct
+{
+  GstPcapParseLinktype linktype;
+  guint64 ts_units;
+} GstPcapParseInterface;
+
 /**
  * GstPcapParse:
  *
@@ -66,11 +107,16 @@ struct _GstPcapParse
   GstPad * src_pad;
 
   /* properties */
-  gint64 src_ip;
-  gint64 dst_ip;
+  GInetAddress * src_ip;
+  GInetAddress * dst_ip;
   gint32 src_port;
   gint32 dst_port;
   GstCaps *caps;
+  gboolean multi_flow;
+  gboolean replay;
+  gdouble speed;
+  gboolean loop;
+  GstClockTime batch_time;
 
   /* state */
   GstAdapter * adapter;
@@ -79,10 +125,40 @@ struct _GstPcapParse
   gint64 cur_packet_size;
   GstClockTime cur_ts;
   GstPcapParseLinktype linktype;
+  GstPcapParseFormat format;
+  GArray * interfaces;
 
   gboolean newsegment_sent;
 
   gint64 buffer_offset;
+
+  /* pull mode */
+  guint64 offset;
+
+  /* multi-flow mode, GstPcapParseFlowKey -> GstPcapParseFlow */
+  GHashTable * flows;
+  guint n_flows;
+
+  /* replay mode, the running times are the capture times scaled by the
+   * speed and start at 0 */
+  GstClock * replay_clock;
+  GstClockID clock_id;
+  gboolean flushing;
+  GstClockTime first_ts;
+  GstClockTime loop_offset;
+  GstClockTime last_running_time;
+  GstClockTime batch_start;
+  GstClockTime replay_start;
+  GstBufferList * src_list;
+  GstBufferListIterator * src_list_it;
+
+  /* replay statistics */
+  guint64 replay_packets;
+  guint64 replay_span_packets;
+  guint64 replay_batches;
+  GstClockTime replay_span;
+  GstClockTime replay_elapsed;
+  GstClockTime lateness_sum;
 };
 
 struct _GstPcapParseClass
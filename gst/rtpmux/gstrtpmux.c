@@ -47,6 +47,19 @@
  * so they can be sent on the same port.
  * </refsect2>
  *
+ * The sequence number, SSRC and timestamp are rewritten in place when the
+ * muxer holds the only reference to a packet. Otherwise only the RTP header
+ * is copied, and the packet is pushed as a buffer list group made of the new
+ * header and a sub-buffer with the untouched payload.
+ *
+ * Setting #GstRTPMux:max-list-size makes the muxer collect the outgoing
+ * packets and push them as buffer lists, so that sinks that can send many
+ * packets with one system call get them in batches. A list is pushed when it
+ * holds max-list-size packets, when a packet arrives more than
+ * #GstRTPMux:max-list-time after the first one in the list, and on EOS.
+ * Packets stay in the muxer until one of these happens, so this should only
+ * be used with streams that send packets regularly.
+ *
  * Last reviewed on 2010-09-30 (0.10.21)
  */
 
@@ -69,12 +82,16 @@ enum
   PROP_TIMESTAMP_OFFSET,
   PROP_SEQNUM_OFFSET,
   PROP_SEQNUM,
-  PROP_SSRC
+  PROP_SSRC,
+  PROP_MAX_LIST_SIZE,
+  PROP_MAX_LIST_TIME
 };
 
 #define DEFAULT_TIMESTAMP_OFFSET -1
 #define DEFAULT_SEQNUM_OFFSET    -1
 #define DEFAULT_SSRC             -1
+#define DEFAULT_MAX_LIST_SIZE    0
+#define DEFAULT_MAX_LIST_TIME    (10 * GST_MSECOND)
 
 static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
@@ -156,6 +173,33 @@ gst_rtp_mux_class_init (GstRTPMuxClass * klass)
           "The SSRC of the packets (-1 == random)",
           0, G_MAXUINT, DEFAULT_SSRC,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstRTPMux:max-list-size
+   *
+   * Push the outgoing packets as buffer lists of up to this many packets.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_MAX_LIST_SIZE,
+      g_param_spec_uint ("max-list-size", "Max list size",
+          "Collect this many outgoing packets in a buffer list before "
+          "pushing it (0 = push every packet as it arrives)",
+          0, G_MAXUINT, DEFAULT_MAX_LIST_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstRTPMux:max-list-time
+   *
+   * The largest running time difference between the first and the last
+   * packet of an outgoing buffer list.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_MAX_LIST_TIME,
+      g_param_spec_uint64 ("max-list-time", "Max list time",
+          "Push the collected packets when a packet arrives this much later "
+          "than the first one (in nanoseconds)",
+          0, G_MAXUINT64, DEFAULT_MAX_LIST_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_rtp_mux_request_new_pad);
@@ -163,11 +207,17 @@ gst_rtp_mux_class_init (GstRTPMuxClass * klass)
   gstelement_class->change_state = GST_DEBUG_FUNCPTR (gst_rtp_mux_change_state);
 }
 
+static void gst_rtp_mux_drop_list_locked (GstRTPMux * rtp_mux);
+
 static void
 gst_rtp_mux_dispose (GObject * object)
 {
   GList *item;
 
+  GST_OBJECT_LOCK (object);
+  gst_rtp_mux_drop_list_locked (GST_RTP_MUX (object));
+  GST_OBJECT_UNLOCK (object);
+
 restart:
   for (item = GST_ELEMENT_PADS (object); item; item = g_list_next (item)) {
     GstPad *pad = GST_PAD (item->data);
@@ -236,6 +286,10 @@ gst_rtp_mux_init (GstRTPMux * object, GstRTPMuxClass * g_class)
   object->seqnum_offset = DEFAULT_SEQNUM_OFFSET;
 
   object->segment_pending = TRUE;
+
+  object->max_list_size = DEFAULT_MAX_LIST_SIZE;
+  object->max_list_time = DEFAULT_MAX_LIST_TIME;
+  object->out_start = GST_CLOCK_TIME_NONE;
 }
 
 static void
@@ -352,6 +406,146 @@ process_buffer_locked (GstRTPMux * rtp_mux, GstRTPMuxPadPrivate * padpriv,
   return TRUE;
 }
 
+/* Returns a buffer holding the RTP header of @buffer that can be rewritten.
+ * That is @buffer itself if nobody else has a reference to it, else a copy
+ * of the header only, and the rest of the packet is returned in @payload
+ * as a sub-buffer of @buffer. The whole header is copied, including the
+ * CSRCs and the extension, as buffer lists are only valid RTP if the first
+ * buffer of each group has all of it. Takes ownership of @buffer. */
+static GstBuffer *
+gst_rtp_mux_writable_header (GstBuffer * buffer, GstBuffer ** payload)
+{
+  GstBuffer *header;
+  guint hlen, size;
+
+  *payload = NULL;
+
+  if (gst_buffer_is_writable (buffer))
+    return buffer;
+
+  hlen = gst_rtp_buffer_get_header_len (buffer);
+  size = GST_BUFFER_SIZE (buffer);
+
+  header = gst_buffer_new_and_alloc (hlen);
+  memcpy (GST_BUFFER_DATA (header), GST_BUFFER_DATA (buffer), hlen);
+  gst_buffer_copy_metadata (header, buffer, GST_BUFFER_COPY_ALL);
+
+  if (size > hlen)
+    *payload = gst_buffer_create_sub (buffer, hlen, size - hlen);
+  gst_buffer_unref (buffer);
+
+  return header;
+}
+
+static void
+gst_rtp_mux_drop_list_locked (GstRTPMux * rtp_mux)
+{
+  if (rtp_mux->out_it) {
+    gst_buffer_list_iterator_free (rtp_mux->out_it);
+    rtp_mux->out_it = NULL;
+  }
+  if (rtp_mux->out_list) {
+    gst_buffer_list_unref (rtp_mux->out_list);
+    rtp_mux->out_list = NULL;
+  }
+  rtp_mux->out_len = 0;
+  rtp_mux->out_start = GST_CLOCK_TIME_NONE;
+}
+
+/* Moves the collected packets to @ready, to be pushed once the lock is
+ * released */
+static GList *
+gst_rtp_mux_finish_list_locked (GstRTPMux * rtp_mux, GList * ready)
+{
+  if (rtp_mux->out_list == NULL)
+    return ready;
+
+  gst_buffer_list_iterator_free (rtp_mux->out_it);
+  ready = g_list_append (ready, rtp_mux->out_list);
+  rtp_mux->out_it = NULL;
+  rtp_mux->out_list = NULL;
+  rtp_mux->out_len = 0;
+  rtp_mux->out_start = GST_CLOCK_TIME_NONE;
+
+  return ready;
+}
+
+/* Starts a new group for a packet with running time @timestamp in the
+ * collected list, the caller then adds the buffers of the packet to
+ * rtp_mux->out_it. A list that is too old to take the packet is moved to
+ * @ready first. */
+static GList *
+gst_rtp_mux_start_group_locked (GstRTPMux * rtp_mux, GstClockTime timestamp,
+    GList * ready)
+{
+  if (rtp_mux->out_list && GST_CLOCK_TIME_IS_VALID (timestamp) &&
+      GST_CLOCK_TIME_IS_VALID (rtp_mux->out_start) &&
+      timestamp > rtp_mux->out_start + rtp_mux->max_list_time)
+    ready = gst_rtp_mux_finish_list_locked (rtp_mux, ready);
+
+  if (rtp_mux->out_list == NULL) {
+    rtp_mux->out_list = gst_buffer_list_new ();
+    rtp_mux->out_it = gst_buffer_list_iterate (rtp_mux->out_list);
+    rtp_mux->out_start = timestamp;
+  }
+
+  gst_buffer_list_iterator_add_group (rtp_mux->out_it);
+  rtp_mux->out_len++;
+
+  return ready;
+}
+
+/* Moves the packets of @bufferlist to the collected list, returns the lists
+ * that are ready to be pushed. Takes ownership of @bufferlist. */
+static GList *
+gst_rtp_mux_collect_list_locked (GstRTPMux * rtp_mux,
+    GstBufferList * bufferlist, GList * ready)
+{
+  GstBufferListIterator *it;
+  GstBuffer *buf;
+
+  it = gst_buffer_list_iterate (bufferlist);
+  while (gst_buffer_list_iterator_next_group (it)) {
+    buf = gst_buffer_list_iterator_next (it);
+    if (buf == NULL)
+      continue;
+
+    ready = gst_rtp_mux_start_group_locked (rtp_mux,
+        GST_BUFFER_TIMESTAMP (buf), ready);
+    do {
+      gst_buffer_list_iterator_add (rtp_mux->out_it, gst_buffer_ref (buf));
+    } while ((buf = gst_buffer_list_iterator_next (it)));
+
+    if (rtp_mux->out_len >= rtp_mux->max_list_size)
+      ready = gst_rtp_mux_finish_list_locked (rtp_mux, ready);
+  }
+  gst_buffer_list_iterator_free (it);
+  gst_buffer_list_unref (bufferlist);
+
+  return ready;
+}
+
+/* Pushes the lists in @ready and frees it. Returns the first flow return
+ * that is not OK, the later lists are still pushed so that the packets
+ * that were accepted are not lost. */
+static GstFlowReturn
+gst_rtp_mux_push_lists (GstRTPMux * rtp_mux, GList * ready)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  GList *walk;
+
+  for (walk = ready; walk; walk = g_list_next (walk)) {
+    GstFlowReturn res;
+
+    res = gst_pad_push_list (rtp_mux->srcpad, walk->data);
+    if (ret == GST_FLOW_OK)
+      ret = res;
+  }
+  g_list_free (ready);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_rtp_mux_chain_list (GstPad * pad, GstBufferList * bufferlist)
 {
@@ -360,6 +554,8 @@ gst_rtp_mux_chain_list (GstPad * pad, GstBufferList * bufferlist)
   GstBufferListIterator *it;
   GstRTPMuxPadPrivate *padpriv;
   GstEvent *newseg_event = NULL;
+  GList *ready = NULL;
+  gboolean collect = FALSE;
   gboolean drop = TRUE;
 
   rtp_mux = GST_RTP_MUX (gst_pad_get_parent (pad));
@@ -380,20 +576,33 @@ gst_rtp_mux_chain_list (GstPad * pad, GstBufferList * bufferlist)
     goto out;
   }
 
+  /* copying the list only refs the buffers, the headers of the packets we
+   * don't own are copied below */
   bufferlist = gst_buffer_list_make_writable (bufferlist);
   it = gst_buffer_list_iterate (bufferlist);
   while (gst_buffer_list_iterator_next_group (it)) {
-    GstBuffer *rtpbuf;
+    GstBuffer *rtpbuf, *payload;
 
     rtpbuf = gst_buffer_list_iterator_next (it);
-    rtpbuf = gst_buffer_make_writable (rtpbuf);
+    if (rtpbuf == NULL)
+      continue;
+
+    /* take the list's reference so that a packet we own is writable */
+    gst_buffer_list_iterator_steal (it);
+    rtpbuf = gst_rtp_mux_writable_header (rtpbuf, &payload);
 
     drop = !process_buffer_locked (rtp_mux, padpriv, rtpbuf);
 
-    if (drop)
+    if (drop) {
+      gst_buffer_unref (rtpbuf);
+      if (payload)
+        gst_buffer_unref (payload);
       break;
+    }
 
-    gst_buffer_list_iterator_take (it, rtpbuf);
+    gst_buffer_list_iterator_add (it, rtpbuf);
+    if (payload)
+      gst_buffer_list_iterator_add (it, payload);
   }
   gst_buffer_list_iterator_free (it);
 
@@ -407,6 +616,11 @@ gst_rtp_mux_chain_list (GstPad * pad, GstBufferList * bufferlist)
     rtp_mux->segment_pending = FALSE;
   }
 
+  if (!drop && rtp_mux->max_list_size > 0) {
+    ready = gst_rtp_mux_collect_list_locked (rtp_mux, bufferlist, NULL);
+    collect = TRUE;
+  }
+
   GST_OBJECT_UNLOCK (rtp_mux);
 
   if (newseg_event)
@@ -415,6 +629,8 @@ gst_rtp_mux_chain_list (GstPad * pad, GstBufferList * bufferlist)
   if (drop) {
     gst_buffer_list_unref (bufferlist);
     ret = GST_FLOW_OK;
+  } else if (collect) {
+    ret = gst_rtp_mux_push_lists (rtp_mux, ready);
   } else {
     ret = gst_pad_push_list (rtp_mux->srcpad, bufferlist);
   }
@@ -433,6 +649,9 @@ gst_rtp_mux_chain (GstPad * pad, GstBuffer * buffer)
   GstFlowReturn ret;
   GstRTPMuxPadPrivate *padpriv;
   GstEvent *newseg_event = NULL;
+  GstBuffer *payload;
+  GList *ready = NULL;
+  gboolean collect = FALSE;
   gboolean drop;
 
   rtp_mux = GST_RTP_MUX (GST_OBJECT_PARENT (pad));
@@ -452,7 +671,7 @@ gst_rtp_mux_chain (GstPad * pad, GstBuffer * buffer)
     return GST_FLOW_NOT_LINKED;
   }
 
-  buffer = gst_buffer_make_writable (buffer);
+  buffer = gst_rtp_mux_writable_header (buffer, &payload);
 
   drop = !process_buffer_locked (rtp_mux, padpriv, buffer);
 
@@ -465,6 +684,17 @@ gst_rtp_mux_chain (GstPad * pad, GstBuffer * buffer)
 
     rtp_mux->segment_pending = FALSE;
   }
+
+  if (!drop && rtp_mux->max_list_size > 0) {
+    ready = gst_rtp_mux_start_group_locked (rtp_mux,
+        GST_BUFFER_TIMESTAMP (buffer), NULL);
+    gst_buffer_list_iterator_add (rtp_mux->out_it, buffer);
+    if (payload)
+      gst_buffer_list_iterator_add (rtp_mux->out_it, payload);
+    if (rtp_mux->out_len >= rtp_mux->max_list_size)
+      ready = gst_rtp_mux_finish_list_locked (rtp_mux, ready);
+    collect = TRUE;
+  }
   GST_OBJECT_UNLOCK (rtp_mux);
 
   if (newseg_event)
@@ -472,7 +702,24 @@ gst_rtp_mux_chain (GstPad * pad, GstBuffer * buffer)
 
   if (drop) {
     gst_buffer_unref (buffer);
+    if (payload)
+      gst_buffer_unref (payload);
     ret = GST_FLOW_OK;
+  } else if (collect) {
+    ret = gst_rtp_mux_push_lists (rtp_mux, ready);
+  } else if (payload) {
+    GstBufferList *list;
+    GstBufferListIterator *it;
+
+    /* push the new header and the shared payload as one packet */
+    list = gst_buffer_list_new ();
+    it = gst_buffer_list_iterate (list);
+    gst_buffer_list_iterator_add_group (it);
+    gst_buffer_list_iterator_add (it, buffer);
+    gst_buffer_list_iterator_add (it, payload);
+    gst_buffer_list_iterator_free (it);
+
+    ret = gst_pad_push_list (rtp_mux->srcpad, list);
   } else {
     ret = gst_pad_push (rtp_mux->srcpad, buffer);
   }
@@ -663,6 +910,16 @@ gst_rtp_mux_get_property (GObject * object,
     case PROP_SSRC:
       g_value_set_uint (value, rtp_mux->ssrc);
       break;
+    case PROP_MAX_LIST_SIZE:
+      GST_OBJECT_LOCK (rtp_mux);
+      g_value_set_uint (value, rtp_mux->max_list_size);
+      GST_OBJECT_UNLOCK (rtp_mux);
+      break;
+    case PROP_MAX_LIST_TIME:
+      GST_OBJECT_LOCK (rtp_mux);
+      g_value_set_uint64 (value, rtp_mux->max_list_time);
+      GST_OBJECT_UNLOCK (rtp_mux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -687,6 +944,16 @@ gst_rtp_mux_set_property (GObject * object,
     case PROP_SSRC:
       rtp_mux->ssrc = g_value_get_uint (value);
       break;
+    case PROP_MAX_LIST_SIZE:
+      GST_OBJECT_LOCK (rtp_mux);
+      rtp_mux->max_list_size = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (rtp_mux);
+      break;
+    case PROP_MAX_LIST_TIME:
+      GST_OBJECT_LOCK (rtp_mux);
+      rtp_mux->max_list_time = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (rtp_mux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -710,6 +977,7 @@ gst_rtp_mux_sink_event (GstPad * pad, GstEvent * event)
 
       GST_OBJECT_LOCK (mux);
       mux->segment_pending = TRUE;
+      gst_rtp_mux_drop_list_locked (mux);
       padpriv = gst_pad_get_element_private (pad);
       if (padpriv)
         gst_segment_init (&padpriv->segment, GST_FORMAT_UNDEFINED);
@@ -743,6 +1011,17 @@ gst_rtp_mux_sink_event (GstPad * pad, GstEvent * event)
       ret = TRUE;
       break;
     }
+    case GST_EVENT_EOS:
+    {
+      GList *ready;
+
+      /* the collected packets go out before the EOS */
+      GST_OBJECT_LOCK (mux);
+      ready = gst_rtp_mux_finish_list_locked (mux, NULL);
+      GST_OBJECT_UNLOCK (mux);
+      gst_rtp_mux_push_lists (mux, ready);
+      break;
+    }
     default:
       break;
   }
@@ -810,6 +1089,7 @@ static GstStateChangeReturn
 gst_rtp_mux_change_state (GstElement * element, GstStateChange transition)
 {
   GstRTPMux *rtp_mux;
+  GstStateChangeReturn ret;
 
   rtp_mux = GST_RTP_MUX (element);
 
@@ -825,7 +1105,19 @@ gst_rtp_mux_change_state (GstElement * element, GstStateChange transition)
       break;
   }
 
-  return GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      GST_OBJECT_LOCK (rtp_mux);
+      gst_rtp_mux_drop_list_locked (rtp_mux);
+      GST_OBJECT_UNLOCK (rtp_mux);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
 }
 
 gboolean
@@ -74,6 +74,15 @@ struct _GstRTPMux
   guint current_ssrc;
 
   gboolean segment_pending;
+
+  /* outgoing packets waiting to be pushed as one list, protected by the
+   * object lock */
+  guint max_list_size;
+  GstClockTime max_list_time;
+  GstBufferList *out_list;
+  GstBufferListIterator *out_it;
+  guint out_len;
+  GstClockTime out_start;
 };
 
 struct _GstRTPMuxClass
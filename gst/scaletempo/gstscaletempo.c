@@ -70,6 +70,8 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbasetransform.h>
+#include <gst/fft/gstfft.h>
+#include <gst/fft/gstfftf32.h>
 #include <string.h>             /* for memset */
 
 #include "gstscaletempo.h"
@@ -90,8 +92,31 @@ enum
   PROP_STRIDE,
   PROP_OVERLAP,
   PROP_SEARCH,
+  PROP_SEARCH_METHOD,
 };
 
+#define DEFAULT_SEARCH_METHOD GST_SCALETEMPO_SEARCH_DIRECT
+
+#define GST_TYPE_SCALETEMPO_SEARCH_METHOD (gst_scaletempo_search_method_get_type ())
+static GType
+gst_scaletempo_search_method_get_type (void)
+{
+  static GType search_method_type = 0;
+  static const GEnumValue search_methods[] = {
+    {GST_SCALETEMPO_SEARCH_DIRECT,
+        "Dot product for every offset", "direct"},
+    {GST_SCALETEMPO_SEARCH_FFT,
+        "FFT cross correlation", "fft"},
+    {0, NULL, NULL},
+  };
+
+  if (!search_method_type) {
+    search_method_type =
+        g_enum_register_static ("GstScaletempoSearchMethod", search_methods);
+  }
+  return search_method_type;
+}
+
 #define SUPPORTED_CAPS \
 GST_STATIC_CAPS ( \
     "audio/x-raw-float, " \
@@ -130,6 +155,7 @@ typedef struct _GstScaletempoPrivate
   guint ms_stride;
   gdouble percent_overlap;
   guint ms_search;
+  GstScaletempoSearchMethod search_method;
   /* caps */
   gboolean use_int;
   guint samples_per_frame;      /* AKA number of channels */
@@ -158,7 +184,17 @@ typedef struct _GstScaletempoPrivate
   guint frames_search;
   gpointer buf_pre_corr;
   gpointer table_window;
+  gfloat *buf_search;
     guint (*best_overlap_offset) (GstScaletempo * scaletempo);
+    guint (*search_overlap) (struct _GstScaletempoPrivate * p,
+      const gfloat * pre_corr, const gfloat * search_start);
+  /* fft search */
+  guint fft_len;
+  GstFFTF32 *fft;
+  GstFFTF32 *ifft;
+  gfloat *fft_time;
+  GstFFTF32Complex *fft_freq_pre_corr;
+  GstFFTF32Complex *fft_freq_search;
   /* gstreamer */
   gint64 segment_start;
   /* threads */
@@ -167,14 +203,115 @@ typedef struct _GstScaletempoPrivate
 #define GST_SCALETEMPO_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), GST_TYPE_SCALETEMPO, GstScaletempoPrivate))
 
 
+/* Four offsets are correlated in each pass over the overlap, so every
+ * sample of the windowed overlap is loaded once for all of them and the four
+ * sums do not wait on each other.  Each sum still adds its products in
+ * order, which gives the same result as one offset at a time. */
+static guint
+search_overlap_direct (GstScaletempoPrivate * p, const gfloat * pre_corr,
+    const gfloat * search_start)
+{
+  guint samples_corr = p->samples_overlap - p->samples_per_frame;
+  guint stride = p->samples_per_frame;
+  gfloat corr[4];
+  gfloat best_corr = -G_MAXFLOAT;
+  guint best_off = 0;
+  guint off, n, i, k;
+
+  for (off = 0; off < p->frames_search; off += n) {
+    const gfloat *ps = search_start + off * stride;
+
+    n = MIN (4, p->frames_search - off);
+    if (n == 4) {
+      gfloat c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+
+      for (i = 0; i < samples_corr; i++) {
+        gfloat v = pre_corr[i];
+
+        c0 += v * ps[i];
+        c1 += v * ps[i + stride];
+        c2 += v * ps[i + 2 * stride];
+        c3 += v * ps[i + 3 * stride];
+      }
+      corr[0] = c0;
+      corr[1] = c1;
+      corr[2] = c2;
+      corr[3] = c3;
+    } else {
+      for (k = 0; k < n; k++) {
+        gfloat c = 0;
+
+        for (i = 0; i < samples_corr; i++)
+          c += pre_corr[i] * ps[i + k * stride];
+        corr[k] = c;
+      }
+    }
+
+    for (k = 0; k < n; k++) {
+      if (corr[k] > best_corr) {
+        best_corr = corr[k];
+        best_off = off + k;
+      }
+    }
+  }
+
+  return best_off;
+}
+
+/* Cross correlation through the frequency domain: with A the spectrum of the
+ * windowed overlap and B the one of the search window, the inverse transform
+ * of conj(A) * B holds the dot product for every offset.  The transform is
+ * long enough for the circular correlation not to wrap. */
+static guint
+search_overlap_fft (GstScaletempoPrivate * p, const gfloat * pre_corr,
+    const gfloat * search_start)
+{
+  guint samples_corr = p->samples_overlap - p->samples_per_frame;
+  guint samples_search =
+      samples_corr + (p->frames_search - 1) * p->samples_per_frame;
+  guint bins = p->fft_len / 2 + 1;
+  GstFFTF32Complex *pa = p->fft_freq_pre_corr;
+  GstFFTF32Complex *pb = p->fft_freq_search;
+  gfloat *pt = p->fft_time;
+  gfloat best_corr = -G_MAXFLOAT;
+  guint best_off = 0;
+  guint i, off;
+
+  memcpy (pt, pre_corr, samples_corr * sizeof (gfloat));
+  memset (pt + samples_corr, 0, (p->fft_len - samples_corr) * sizeof (gfloat));
+  gst_fft_f32_fft (p->fft, pt, pa);
+
+  memcpy (pt, search_start, samples_search * sizeof (gfloat));
+  memset (pt + samples_search, 0,
+      (p->fft_len - samples_search) * sizeof (gfloat));
+  gst_fft_f32_fft (p->fft, pt, pb);
+
+  for (i = 0; i < bins; i++) {
+    gfloat r = pa[i].r * pb[i].r + pa[i].i * pb[i].i;
+    gfloat im = pa[i].r * pb[i].i - pa[i].i * pb[i].r;
+    pb[i].r = r;
+    pb[i].i = im;
+  }
+  gst_fft_f32_inverse_fft (p->ifft, pb, pt);
+
+  for (off = 0; off < p->frames_search; off++) {
+    gfloat corr = pt[off * p->samples_per_frame];
+    if (corr > best_corr) {
+      best_corr = corr;
+      best_off = off;
+    }
+  }
+
+  return best_off;
+}
+
 static guint
 best_overlap_offset_float (GstScaletempo * scaletempo)
 {
   GstScaletempoPrivate *p = GST_SCALETEMPO_GET_PRIVATE (scaletempo);
-  gfloat *pw, *po, *ppc, *search_start;
-  gfloat best_corr = G_MININT;
-  guint best_off = 0;
-  gint i, off;
+  gfloat *pw, *po, *ppc;
+  guint off;
+  gint i;
 
   pw = p->table_window;
   po = p->buf_overlap;
@@ -184,68 +321,42 @@ best_overlap_offset_float (GstScaletempo * scaletempo)
     *ppc++ = *pw++ * *po++;
   }
 
-  search_start = (gfloat *) p->buf_queue + p->samples_per_frame;
-  for (off = 0; off < p->frames_search; off++) {
-    gfloat corr = 0;
-    gfloat *ps = search_start;
-    ppc = p->buf_pre_corr;
-    for (i = p->samples_per_frame; i < p->samples_overlap; i++) {
-      corr += *ppc++ * *ps++;
-    }
-    if (corr > best_corr) {
-      best_corr = corr;
-      best_off = off;
-    }
-    search_start += p->samples_per_frame;
-  }
+  off = p->search_overlap (p, p->buf_pre_corr,
+      (gfloat *) p->buf_queue + p->samples_per_frame);
 
-  return best_off * p->bytes_per_frame;
+  return off * p->bytes_per_frame;
 }
 
-/* buffer padding for loop optimization: sizeof(gint32) * (loop_size - 1) */
-#define UNROLL_PADDING (4*3)
 static guint
 best_overlap_offset_s16 (GstScaletempo * scaletempo)
 {
   GstScaletempoPrivate *p = GST_SCALETEMPO_GET_PRIVATE (scaletempo);
-  gint32 *pw, *ppc;
-  gint16 *po, *search_start;
-  gint64 best_corr = G_MININT64;
-  guint best_off = 0;
-  guint off;
-  glong i;
+  gfloat *pw, *ppc, *psf;
+  gint16 *po, *ps;
+  guint samples_search, off;
+  gint i;
 
   pw = p->table_window;
   po = p->buf_overlap;
   po += p->samples_per_frame;
   ppc = p->buf_pre_corr;
   for (i = p->samples_per_frame; i < p->samples_overlap; i++) {
-    *ppc++ = (*pw++ * *po++) >> 15;
+    *ppc++ = *pw++ * *po++;
   }
 
-  search_start = (gint16 *) p->buf_queue + p->samples_per_frame;
-  for (off = 0; off < p->frames_search; off++) {
-    gint64 corr = 0;
-    gint16 *ps = search_start;
-    ppc = p->buf_pre_corr;
-    ppc += p->samples_overlap - p->samples_per_frame;
-    ps += p->samples_overlap - p->samples_per_frame;
-    i = -((glong) p->samples_overlap - (glong) p->samples_per_frame);
-    do {
-      corr += ppc[i + 0] * ps[i + 0];
-      corr += ppc[i + 1] * ps[i + 1];
-      corr += ppc[i + 2] * ps[i + 2];
-      corr += ppc[i + 3] * ps[i + 3];
-      i += 4;
-    } while (i < 0);
-    if (corr > best_corr) {
-      best_corr = corr;
-      best_off = off;
-    }
-    search_start += p->samples_per_frame;
+  /* convert the search window once so that every offset runs the same
+   * float kernel, instead of widening each product to 64 bits */
+  samples_search = p->samples_overlap - p->samples_per_frame +
+      (p->frames_search - 1) * p->samples_per_frame;
+  ps = (gint16 *) p->buf_queue + p->samples_per_frame;
+  psf = p->buf_search;
+  for (i = 0; i < samples_search; i++) {
+    *psf++ = *ps++;
   }
 
-  return best_off * p->bytes_per_frame;
+  off = p->search_overlap (p, p->buf_pre_corr, p->buf_search);
+
+  return off * p->bytes_per_frame;
 }
 
 static void
@@ -375,34 +486,53 @@ reinit_buffers (GstScaletempo * scaletempo)
   if (p->frames_search < 1) {   /* if no search */
     p->best_overlap_offset = NULL;
   } else {
-    guint bytes_pre_corr = (p->samples_overlap - p->samples_per_frame) * 4;     /* sizeof (gint32|gfloat) */
-    p->buf_pre_corr =
-        g_realloc (p->buf_pre_corr, bytes_pre_corr + UNROLL_PADDING);
+    guint samples_corr = p->samples_overlap - p->samples_per_frame;
+    guint samples_search =
+        samples_corr + (p->frames_search - 1) * p->samples_per_frame;
+    guint bytes_pre_corr = samples_corr * sizeof (gfloat);
+    gfloat *pw;
+
+    p->buf_pre_corr = g_realloc (p->buf_pre_corr, bytes_pre_corr);
     p->table_window = g_realloc (p->table_window, bytes_pre_corr);
-    if (p->use_int) {
-      gint64 t = frames_overlap;
-      gint32 n = 8589934588LL / (t * t);        /* 4 * (2^31 - 1) / t^2 */
-      gint32 *pw;
-
-      memset ((guint8 *) p->buf_pre_corr + bytes_pre_corr, 0, UNROLL_PADDING);
-      pw = p->table_window;
-      for (i = 1; i < frames_overlap; i++) {
-        gint32 v = (i * (t - i) * n) >> 15;
-        for (j = 0; j < p->samples_per_frame; j++) {
-          *pw++ = v;
-        }
+    pw = p->table_window;
+    for (i = 1; i < frames_overlap; i++) {
+      gfloat v = i * (frames_overlap - i);
+      for (j = 0; j < p->samples_per_frame; j++) {
+        *pw++ = v;
       }
+    }
+
+    if (p->use_int) {
+      guint bytes_search = samples_search * sizeof (gfloat);
+
+      p->buf_search = g_realloc (p->buf_search, bytes_search);
       p->best_overlap_offset = best_overlap_offset_s16;
     } else {
-      gfloat *pw = p->table_window;
-      for (i = 1; i < frames_overlap; i++) {
-        gfloat v = i * (frames_overlap - i);
-        for (j = 0; j < p->samples_per_frame; j++) {
-          *pw++ = v;
-        }
-      }
       p->best_overlap_offset = best_overlap_offset_float;
     }
+
+    if (p->search_method == GST_SCALETEMPO_SEARCH_FFT) {
+      /* real transforms need an even length */
+      guint fft_len = 2 * gst_fft_next_fast_length ((samples_search + 1) / 2);
+
+      if (fft_len != p->fft_len) {
+        if (p->fft)
+          gst_fft_f32_free (p->fft);
+        if (p->ifft)
+          gst_fft_f32_free (p->ifft);
+        p->fft = gst_fft_f32_new (fft_len, FALSE);
+        p->ifft = gst_fft_f32_new (fft_len, TRUE);
+        p->fft_len = fft_len;
+        p->fft_time = g_renew (gfloat, p->fft_time, fft_len);
+        p->fft_freq_pre_corr =
+            g_renew (GstFFTF32Complex, p->fft_freq_pre_corr, fft_len / 2 + 1);
+        p->fft_freq_search =
+            g_renew (GstFFTF32Complex, p->fft_freq_search, fft_len / 2 + 1);
+      }
+      p->search_overlap = search_overlap_fft;
+    } else {
+      p->search_overlap = search_overlap_direct;
+    }
   }
 
   new_size =
@@ -426,13 +556,14 @@ reinit_buffers (GstScaletempo * scaletempo)
   p->frames_stride_scaled = p->bytes_stride_scaled / p->bytes_per_frame;
 
   GST_DEBUG
-      ("%.3f scale, %.3f stride_in, %i stride_out, %i standing, %i overlap, %i search, %i queue, %s mode",
+      ("%.3f scale, %.3f stride_in, %i stride_out, %i standing, %i overlap, %i search, %i queue, %s mode, %s search",
       p->scale, p->frames_stride_scaled,
       (gint) (p->bytes_stride / p->bytes_per_frame),
       (gint) (p->bytes_standing / p->bytes_per_frame),
       (gint) (p->bytes_overlap / p->bytes_per_frame), p->frames_search,
       (gint) (p->bytes_queue_max / p->bytes_per_frame),
-      (p->use_int ? "s16" : "float"));
+      (p->use_int ? "s16" : "float"),
+      (p->search_method == GST_SCALETEMPO_SEARCH_FFT ? "fft" : "direct"));
 
   p->reinit_buffers = FALSE;
 }
@@ -634,6 +765,9 @@ gst_scaletempo_get_property (GObject * object,
     case PROP_SEARCH:
       g_value_set_uint (value, priv->ms_search);
       break;
+    case PROP_SEARCH_METHOD:
+      g_value_set_enum (value, priv->search_method);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -672,12 +806,43 @@ gst_scaletempo_set_property (GObject * object,
       }
       break;
     }
+    case PROP_SEARCH_METHOD:{
+      GstScaletempoSearchMethod new_value = g_value_get_enum (value);
+      if (priv->search_method != new_value) {
+        priv->search_method = new_value;
+        priv->reinit_buffers = TRUE;
+      }
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
 
+static void
+gst_scaletempo_finalize (GObject * object)
+{
+  GstScaletempo *scaletempo = GST_SCALETEMPO (object);
+  GstScaletempoPrivate *priv = GST_SCALETEMPO_GET_PRIVATE (scaletempo);
+
+  g_free (priv->buf_queue);
+  g_free (priv->buf_overlap);
+  g_free (priv->table_blend);
+  g_free (priv->buf_pre_corr);
+  g_free (priv->table_window);
+  g_free (priv->buf_search);
+  g_free (priv->fft_time);
+  g_free (priv->fft_freq_pre_corr);
+  g_free (priv->fft_freq_search);
+  if (priv->fft)
+    gst_fft_f32_free (priv->fft);
+  if (priv->ifft)
+    gst_fft_f32_free (priv->ifft);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static void
 gst_scaletempo_base_init (gpointer klass)
 {
@@ -702,6 +867,7 @@ gst_scaletempo_class_init (GstScaletempoClass * klass)
 
   g_type_class_add_private (klass, sizeof (GstScaletempoPrivate));
 
+  gobject_class->finalize = GST_DEBUG_FUNCPTR (gst_scaletempo_finalize);
   gobject_class->get_property = GST_DEBUG_FUNCPTR (gst_scaletempo_get_property);
   gobject_class->set_property = GST_DEBUG_FUNCPTR (gst_scaletempo_set_property);
 
@@ -724,6 +890,22 @@ gst_scaletempo_class_init (GstScaletempoClass * klass)
           "Length in milliseconds to search for best overlap position", 0, 500,
           14, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstScaletempo:search-method
+   *
+   * How to find the best overlap position.  The direct search costs
+   * search * overlap multiply-adds per stride, the FFT cross correlation
+   * grows with (search + overlap) * log (search + overlap) and pays off
+   * for long search windows and many channels.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_SEARCH_METHOD,
+      g_param_spec_enum ("search-method", "Search Method",
+          "Method to find the best overlap position",
+          GST_TYPE_SCALETEMPO_SEARCH_METHOD, DEFAULT_SEARCH_METHOD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   basetransform_class->event = GST_DEBUG_FUNCPTR (gst_scaletempo_sink_event);
   basetransform_class->set_caps = GST_DEBUG_FUNCPTR (gst_scaletempo_set_caps);
   basetransform_class->transform_size =
@@ -739,6 +921,7 @@ gst_scaletempo_init (GstScaletempo * scaletempo, GstScaletempoClass * klass)
   priv->ms_stride = 30;
   priv->percent_overlap = .2;
   priv->ms_search = 14;
+  priv->search_method = DEFAULT_SEARCH_METHOD;
 
   /* uninitialized */
   priv->scale = 0;
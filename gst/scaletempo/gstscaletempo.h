@@ -33,6 +33,12 @@ G_BEGIN_DECLS
 typedef struct _GstScaletempo GstScaletempo;
 typedef struct _GstScaletempoClass GstScaletempoClass;
 
+typedef enum
+{
+  GST_SCALETEMPO_SEARCH_DIRECT,
+  GST_SCALETEMPO_SEARCH_FFT
+} GstScaletempoSearchMethod;
+
 struct _GstScaletempo
 {
   GstBaseTransform element;
@@ -32,6 +32,11 @@
  * sdpdemux acts like a live element and will therefore only generate data in the 
  * PLAYING state.
  * 
+ * By default every stream is received by its own pair of udpsrc elements, each
+ * with its own thread. When #GstSDPDemux:shared-receiver is set, sdpdemux opens
+ * the sockets itself and receives all streams from a single thread that polls
+ * all their ports, which scales better to many streams.
+ * 
  * <refsect2>
  * <title>Example launch line</title>
  * |[
@@ -66,15 +71,21 @@
 #include <ws2tcpip.h>
 #else
 #include <sys/socket.h>
+#include <sys/ioctl.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #endif
 
+#ifdef HAVE_FIONREAD_IN_SYS_FILIO
+#include <sys/filio.h>
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <locale.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <errno.h>
 
 #include <gst/rtp/gstrtppayloads.h>
 #include <gst/sdp/gstsdpmessage.h>
@@ -84,6 +95,12 @@
 GST_DEBUG_CATEGORY_STATIC (sdpdemux_debug);
 #define GST_CAT_DEFAULT (sdpdemux_debug)
 
+#ifdef G_OS_WIN32
+#define CLOSE_SOCKET(sock) closesocket (sock)
+#else
+#define CLOSE_SOCKET(sock) close (sock)
+#endif
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -104,6 +121,7 @@ enum
 #define DEFAULT_TIMEOUT          10000000
 #define DEFAULT_LATENCY_MS       200
 #define DEFAULT_REDIRECT         TRUE
+#define DEFAULT_SHARED_RECEIVER  FALSE
 
 enum
 {
@@ -112,6 +130,7 @@ enum
   PROP_TIMEOUT,
   PROP_LATENCY,
   PROP_REDIRECT,
+  PROP_SHARED_RECEIVER,
   PROP_LAST
 };
 
@@ -132,6 +151,8 @@ static void gst_sdp_demux_handle_message (GstBin * bin, GstMessage * message);
 static void gst_sdp_demux_stream_push_event (GstSDPDemux * demux,
     GstSDPStream * stream, GstEvent * event);
 
+static void gst_sdp_demux_receiver_stop (GstSDPDemux * demux);
+
 static gboolean gst_sdp_demux_sink_event (GstPad * pad, GstEvent * event);
 static GstFlowReturn gst_sdp_demux_sink_chain (GstPad * pad,
     GstBuffer * buffer);
@@ -202,6 +223,21 @@ gst_sdp_demux_class_init (GstSDPDemuxClass * klass)
           DEFAULT_REDIRECT,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSDPDemux:shared-receiver
+   *
+   * Receive the RTP and RTCP packets of all streams from one thread polling
+   * all their sockets, instead of creating two udpsrc elements, each with
+   * its own thread, for every stream.
+   *
+   * Since: 0.10.22
+   */
+  g_object_class_install_property (gobject_class, PROP_SHARED_RECEIVER,
+      g_param_spec_boolean ("shared-receiver", "Shared receiver",
+          "Receive all streams from a single thread",
+          DEFAULT_SHARED_RECEIVER,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state = gst_sdp_demux_change_state;
 
   gstbin_class->handle_message = gst_sdp_demux_handle_message;
@@ -222,6 +258,11 @@ gst_sdp_demux_init (GstSDPDemux * demux, GstSDPDemuxClass * g_class)
   demux->stream_rec_lock = g_new (GStaticRecMutex, 1);
   g_static_rec_mutex_init (demux->stream_rec_lock);
 
+  /* protects the shared receiver task */
+  demux->task_rec_lock = g_new (GStaticRecMutex, 1);
+  g_static_rec_mutex_init (demux->task_rec_lock);
+  demux->fdset = gst_poll_new (TRUE);
+
   demux->adapter = gst_adapter_new ();
 }
 
@@ -235,6 +276,10 @@ gst_sdp_demux_finalize (GObject * object)
   /* free locks */
   g_static_rec_mutex_free (demux->stream_rec_lock);
   g_free (demux->stream_rec_lock);
+  g_static_rec_mutex_free (demux->task_rec_lock);
+  g_free (demux->task_rec_lock);
+
+  gst_poll_free (demux->fdset);
 
   g_object_unref (demux->adapter);
 
@@ -262,6 +307,9 @@ gst_sdp_demux_set_property (GObject * object, guint prop_id,
     case PROP_REDIRECT:
       demux->redirect = g_value_get_boolean (value);
       break;
+    case PROP_SHARED_RECEIVER:
+      demux->shared_receiver = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -289,6 +337,9 @@ gst_sdp_demux_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_REDIRECT:
       g_value_set_boolean (value, demux->redirect);
       break;
+    case PROP_SHARED_RECEIVER:
+      g_value_set_boolean (value, demux->shared_receiver);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -353,6 +404,13 @@ gst_sdp_demux_stream_free (GstSDPDemux * demux, GstSDPStream * stream)
   if (stream->caps)
     gst_caps_unref (stream->caps);
 
+  /* the udpsink sends on the RTCP socket, stop it before closing that */
+  if (stream->udpsink) {
+    gst_element_set_state (stream->udpsink, GST_STATE_NULL);
+    gst_bin_remove (GST_BIN_CAST (demux), stream->udpsink);
+    stream->udpsink = NULL;
+  }
+
   for (i = 0; i < 2; i++) {
     GstElement *udpsrc = stream->udpsrc[i];
 
@@ -361,11 +419,11 @@ gst_sdp_demux_stream_free (GstSDPDemux * demux, GstSDPStream * stream)
       gst_bin_remove (GST_BIN_CAST (demux), udpsrc);
       stream->udpsrc[i] = NULL;
     }
-  }
-  if (stream->udpsink) {
-    gst_element_set_state (stream->udpsink, GST_STATE_NULL);
-    gst_bin_remove (GST_BIN_CAST (demux), stream->udpsink);
-    stream->udpsink = NULL;
+    if (stream->sockfd[i].fd >= 0) {
+      gst_poll_remove_fd (demux->fdset, &stream->sockfd[i]);
+      CLOSE_SOCKET (stream->sockfd[i].fd);
+      stream->sockfd[i].fd = -1;
+    }
   }
   if (stream->srcpad) {
     gst_pad_set_active (stream->srcpad, FALSE);
@@ -425,6 +483,8 @@ gst_sdp_demux_create_stream (GstSDPDemux * demux, GstSDPMessage * sdp, gint idx)
 
   stream = g_new0 (GstSDPStream, 1);
   stream->parent = demux;
+  gst_poll_fd_init (&stream->sockfd[0]);
+  gst_poll_fd_init (&stream->sockfd[1]);
   /* we mark the pad as not linked, we will mark it as OK when we add the pad to
    * the element. */
   stream->last_ret = GST_FLOW_OK;
@@ -495,6 +555,9 @@ gst_sdp_demux_cleanup (GstSDPDemux * demux)
 
   GST_DEBUG_OBJECT (demux, "cleanup");
 
+  gst_sdp_demux_receiver_stop (demux);
+  demux->have_data = FALSE;
+
   for (walk = demux->streams; walk; walk = g_list_next (walk)) {
     GstSDPStream *stream = (GstSDPStream *) walk->data;
 
@@ -776,7 +839,8 @@ new_session_pad (GstElement * session, GstPad * pad, GstSDPDemux * demux)
     goto unknown_stream;
 
   /* no need for a timeout anymore now */
-  g_object_set (G_OBJECT (stream->udpsrc[0]), "timeout", (guint64) 0, NULL);
+  if (stream->udpsrc[0])
+    g_object_set (G_OBJECT (stream->udpsrc[0]), "timeout", (guint64) 0, NULL);
 
   /* create a new pad we will use to stream to */
   template = gst_static_pad_template_get (&rtptemplate);
@@ -1076,6 +1140,150 @@ no_element:
   }
 }
 
+/* open a socket receiving on port of the stream destination, joining the
+ * multicast group if needed. Returns -1 on error. */
+static gint
+gst_sdp_demux_open_socket (GstSDPDemux * demux, GstSDPStream * stream,
+    guint port)
+{
+  struct addrinfo hints;
+  struct addrinfo *res;
+  struct sockaddr_storage addr;
+  const gchar *destination;
+  gchar service[16];
+  gint fd = -1, reuse = 1;
+
+  /* if the destination is not a multicast address, we just want to listen on
+   * our local ports */
+  if (!stream->multicast)
+    destination = "0.0.0.0";
+  else
+    destination = stream->destination;
+
+  memset (&hints, 0, sizeof (hints));
+  hints.ai_socktype = SOCK_DGRAM;
+  g_snprintf (service, sizeof (service), "%u", port);
+
+  if (getaddrinfo (destination, service, &hints, &res) != 0)
+    goto resolve_failed;
+
+  if ((fd = socket (res->ai_family, SOCK_DGRAM, 0)) < 0)
+    goto socket_failed;
+
+  if (setsockopt (fd, SOL_SOCKET, SO_REUSEADDR, (void *) &reuse,
+          sizeof (reuse)) < 0)
+    goto socket_failed;
+
+  memcpy (&addr, res->ai_addr, res->ai_addrlen);
+#ifdef G_OS_WIN32
+  /* windows cannot bind to a multicast group address */
+  if (stream->multicast) {
+    if (res->ai_family == AF_INET)
+      ((struct sockaddr_in *) &addr)->sin_addr.s_addr = htonl (INADDR_ANY);
+    else
+      ((struct sockaddr_in6 *) &addr)->sin6_addr = in6addr_any;
+  }
+#endif
+  if (bind (fd, (struct sockaddr *) &addr, res->ai_addrlen) < 0)
+    goto socket_failed;
+
+  if (stream->multicast) {
+    if (res->ai_family == AF_INET) {
+      struct ip_mreq mreq;
+
+      mreq.imr_multiaddr = ((struct sockaddr_in *) res->ai_addr)->sin_addr;
+      mreq.imr_interface.s_addr = htonl (INADDR_ANY);
+      if (setsockopt (fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, (void *) &mreq,
+              sizeof (mreq)) < 0)
+        goto socket_failed;
+    } else {
+      struct ipv6_mreq mreq;
+
+      mreq.ipv6mr_multiaddr =
+          ((struct sockaddr_in6 *) res->ai_addr)->sin6_addr;
+      mreq.ipv6mr_interface = 0;
+      if (setsockopt (fd, IPPROTO_IPV6, IPV6_JOIN_GROUP, (void *) &mreq,
+              sizeof (mreq)) < 0)
+        goto socket_failed;
+    }
+  }
+  freeaddrinfo (res);
+
+  GST_DEBUG_OBJECT (demux, "receiving from %s:%u on socket %d", destination,
+      port, fd);
+
+  return fd;
+
+  /* ERRORS */
+resolve_failed:
+  {
+    GST_WARNING_OBJECT (demux, "could not resolve %s", destination);
+    return -1;
+  }
+socket_failed:
+  {
+    GST_WARNING_OBJECT (demux, "could not receive from %s:%u: %s",
+        destination, port, g_strerror (errno));
+    if (fd >= 0)
+      CLOSE_SOCKET (fd);
+    freeaddrinfo (res);
+    return -1;
+  }
+}
+
+/* open the sockets of the stream and add them to the set polled by the shared
+ * receiver, which pushes the packets into the session manager. */
+static gboolean
+gst_sdp_demux_stream_configure_shared (GstSDPDemux * demux,
+    GstSDPStream * stream)
+{
+  guint ports[2];
+  gchar *name;
+  gint i;
+
+  GST_DEBUG_OBJECT (demux, "configuring shared receiver");
+
+  ports[0] = stream->rtp_port;
+  ports[1] = stream->rtcp_port;
+
+  for (i = 0; i < 2; i++) {
+    if (ports[i] == -1)
+      continue;
+
+    stream->sockfd[i].fd = gst_sdp_demux_open_socket (demux, stream, ports[i]);
+    if (stream->sockfd[i].fd < 0)
+      goto no_socket;
+
+    gst_poll_add_fd (demux->fdset, &stream->sockfd[i]);
+    gst_poll_fd_ctl_read (demux->fdset, &stream->sockfd[i], TRUE);
+
+    if (i == 0)
+      name = g_strdup_printf ("recv_rtp_sink_%d", stream->id);
+    else
+      name = g_strdup_printf ("recv_rtcp_sink_%d", stream->id);
+    stream->channelpad[i] = gst_element_get_request_pad (demux->session, name);
+    g_free (name);
+    if (stream->channelpad[i] == NULL)
+      goto no_pad;
+  }
+  stream->need_segment = TRUE;
+
+  return TRUE;
+
+  /* ERRORS */
+no_socket:
+  {
+    GST_DEBUG_OBJECT (demux, "could not open socket for port %u", ports[i]);
+    return FALSE;
+  }
+no_pad:
+  {
+    GST_DEBUG_OBJECT (demux, "could not get session pad for port %u",
+        ports[i]);
+    return FALSE;
+  }
+}
+
 /* configure the UDP sink back to the server for status reports */
 static gboolean
 gst_sdp_demux_stream_configure_udp_sink (GstSDPDemux * demux,
@@ -1112,11 +1320,16 @@ gst_sdp_demux_stream_configure_udp_sink (GstSDPDemux * demux,
   g_object_set (G_OBJECT (stream->udpsink), "async", FALSE, NULL);
 
   if (stream->udpsrc[1]) {
+    g_object_get (G_OBJECT (stream->udpsrc[1]), "sock", &sockfd, NULL);
+    GST_DEBUG_OBJECT (demux, "UDP src has sock %d", sockfd);
+  } else {
+    sockfd = stream->sockfd[1].fd;
+  }
+
+  if (sockfd != -1) {
     /* configure socket, we give it the same UDP socket as the udpsrc for RTCP
      * because some servers check the port number of where it sends RTCP to identify
      * the RTCP packets it receives */
-    g_object_get (G_OBJECT (stream->udpsrc[1]), "sock", &sockfd, NULL);
-    GST_DEBUG_OBJECT (demux, "UDP src has sock %d", sockfd);
     /* configure socket and make sure udpsink does not close it when shutting
      * down, it belongs to udpsrc after all. */
     g_object_set (G_OBJECT (stream->udpsink), "sockfd", sockfd, NULL);
@@ -1211,6 +1424,232 @@ done:
   gst_event_unref (event);
 }
 
+/* we only act on the first UDP timeout, others are irrelevant and can be
+ * ignored. */
+static void
+gst_sdp_demux_udp_timeout (GstSDPDemux * demux)
+{
+  gboolean ignore_timeout;
+
+  GST_OBJECT_LOCK (demux);
+  ignore_timeout = demux->ignore_timeout;
+  demux->ignore_timeout = TRUE;
+  GST_OBJECT_UNLOCK (demux);
+
+  if (!ignore_timeout) {
+    GST_ELEMENT_ERROR (demux, RESOURCE, READ, (NULL),
+        ("Could not receive any UDP packets for %.4f seconds, maybe your "
+            "firewall is blocking it.",
+            gst_guint64_to_gdouble (demux->udp_timeout / 1000000.0)));
+  }
+}
+
+/* read one packet from a socket of the stream and push it into the session
+ * manager */
+static GstFlowReturn
+gst_sdp_demux_stream_receive (GstSDPDemux * demux, GstSDPStream * stream,
+    gint channel, GstClockTime timestamp)
+{
+  GstBuffer *buf;
+  GstFlowReturn ret;
+  gint fd, i;
+  gssize len;
+#ifndef G_OS_WIN32
+  gint readsize;
+#else
+  gulong readsize;
+#endif
+
+  fd = stream->sockfd[channel].fd;
+
+  /* ask how much is available for reading on the socket */
+#ifndef G_OS_WIN32
+  if (ioctl (fd, FIONREAD, &readsize) < 0)
+#else
+  if (ioctlsocket (fd, FIONREAD, &readsize) == SOCKET_ERROR)
+#endif
+    goto read_error;
+
+  buf = gst_buffer_new_and_alloc (MAX (readsize, 1));
+  len = recv (fd, (char *) GST_BUFFER_DATA (buf), GST_BUFFER_SIZE (buf), 0);
+  if (len < 0) {
+    gst_buffer_unref (buf);
+    if (errno == EAGAIN || errno == EINTR)
+      return GST_FLOW_OK;
+    goto read_error;
+  }
+  GST_BUFFER_SIZE (buf) = len;
+  GST_BUFFER_TIMESTAMP (buf) = timestamp;
+
+  if (stream->need_segment) {
+    GstEvent *event;
+
+    event = gst_event_new_new_segment (FALSE, 1.0, GST_FORMAT_TIME, 0, -1, 0);
+    for (i = 0; i < 2; i++) {
+      if (stream->channelpad[i])
+        gst_pad_send_event (stream->channelpad[i], gst_event_ref (event));
+    }
+    gst_event_unref (event);
+    stream->need_segment = FALSE;
+  }
+
+  ret = gst_pad_chain (stream->channelpad[channel], buf);
+
+  /* the RTCP flow does not matter */
+  if (channel == 1)
+    return GST_FLOW_OK;
+
+  return gst_sdp_demux_combine_flows (demux, stream, ret);
+
+  /* ERRORS */
+read_error:
+  {
+    GST_ELEMENT_ERROR (demux, RESOURCE, READ, (NULL),
+        ("Could not read from socket %d: %s", fd, g_strerror (errno)));
+    return GST_FLOW_ERROR;
+  }
+}
+
+/* the shared receiver, waits for packets on the sockets of all streams and
+ * pushes them into the session manager */
+static void
+gst_sdp_demux_receiver_loop (GstSDPDemux * demux)
+{
+  GstClockTime timeout = GST_CLOCK_TIME_NONE;
+  GstClockTime timestamp = GST_CLOCK_TIME_NONE;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstClock *clock;
+  GList *walk;
+  gint res, i;
+
+  /* the timeout only applies until we receive something */
+  if (!demux->have_data && demux->udp_timeout > 0)
+    timeout = demux->udp_timeout * GST_USECOND;
+
+  res = gst_poll_wait (demux->fdset, timeout);
+  if (res == -1) {
+    /* flushing, we are being paused or stopped */
+    if (errno == EBUSY)
+      return;
+    if (errno == EAGAIN || errno == EINTR)
+      return;
+    goto poll_error;
+  }
+  if (res == 0)
+    goto timeout;
+
+  /* we are live, timestamp with the running time */
+  GST_OBJECT_LOCK (demux);
+  if ((clock = GST_ELEMENT_CLOCK (demux))) {
+    timestamp = gst_clock_get_time (clock);
+    timestamp -= GST_ELEMENT_CAST (demux)->base_time;
+  }
+  GST_OBJECT_UNLOCK (demux);
+
+  demux->have_data = TRUE;
+
+  for (walk = demux->streams; walk; walk = g_list_next (walk)) {
+    GstSDPStream *stream = (GstSDPStream *) walk->data;
+
+    for (i = 0; i < 2; i++) {
+      if (stream->sockfd[i].fd < 0 ||
+          !gst_poll_fd_can_read (demux->fdset, &stream->sockfd[i]))
+        continue;
+
+      ret = gst_sdp_demux_stream_receive (demux, stream, i, timestamp);
+      if (ret == GST_FLOW_WRONG_STATE)
+        goto pause;
+      if (ret == GST_FLOW_NOT_LINKED || ret < GST_FLOW_UNEXPECTED)
+        goto error;
+    }
+  }
+  return;
+
+  /* ERRORS */
+poll_error:
+  {
+    GST_ELEMENT_ERROR (demux, RESOURCE, READ, (NULL),
+        ("Could not poll sockets: %s", g_strerror (errno)));
+    goto pause;
+  }
+timeout:
+  {
+    GST_DEBUG_OBJECT (demux, "timeout on UDP ports");
+    gst_sdp_demux_udp_timeout (demux);
+    goto pause;
+  }
+error:
+  {
+    /* an element returning an error posted a message already */
+    if (ret != GST_FLOW_ERROR) {
+      GST_ELEMENT_ERROR (demux, STREAM, FAILED,
+          ("Internal data flow error."),
+          ("streaming task paused, reason %s (%d)", gst_flow_get_name (ret),
+              ret));
+    }
+    goto pause;
+  }
+pause:
+  {
+    GST_DEBUG_OBJECT (demux, "pausing task, reason %s",
+        gst_flow_get_name (ret));
+    GST_OBJECT_LOCK (demux);
+    if (demux->task)
+      gst_task_pause (demux->task);
+    GST_OBJECT_UNLOCK (demux);
+    return;
+  }
+}
+
+static void
+gst_sdp_demux_receiver_start (GstSDPDemux * demux)
+{
+  GST_OBJECT_LOCK (demux);
+  if (demux->task) {
+    GST_DEBUG_OBJECT (demux, "starting receiver");
+    gst_poll_set_flushing (demux->fdset, FALSE);
+    gst_task_start (demux->task);
+  }
+  GST_OBJECT_UNLOCK (demux);
+}
+
+/* does not wait for the receiver, can be called with the stream lock */
+static void
+gst_sdp_demux_receiver_pause (GstSDPDemux * demux)
+{
+  GST_OBJECT_LOCK (demux);
+  if (demux->task) {
+    GST_DEBUG_OBJECT (demux, "pausing receiver");
+    gst_task_pause (demux->task);
+    gst_poll_set_flushing (demux->fdset, TRUE);
+  }
+  GST_OBJECT_UNLOCK (demux);
+}
+
+/* waits for the receiver to finish, pushing a packet might need the stream
+ * lock so this must not be called with the stream lock held while the
+ * receiver is running */
+static void
+gst_sdp_demux_receiver_stop (GstSDPDemux * demux)
+{
+  GstTask *task;
+
+  GST_OBJECT_LOCK (demux);
+  if ((task = demux->task)) {
+    GST_DEBUG_OBJECT (demux, "stopping receiver");
+    demux->task = NULL;
+    gst_task_stop (task);
+    gst_poll_set_flushing (demux->fdset, TRUE);
+  }
+  GST_OBJECT_UNLOCK (demux);
+
+  if (task) {
+    gst_task_join (task);
+    gst_object_unref (task);
+    gst_poll_set_flushing (demux->fdset, FALSE);
+  }
+}
+
 static void
 gst_sdp_demux_handle_message (GstBin * bin, GstMessage * message)
 {
@@ -1224,25 +1663,10 @@ gst_sdp_demux_handle_message (GstBin * bin, GstMessage * message)
       const GstStructure *s = gst_message_get_structure (message);
 
       if (gst_structure_has_name (s, "GstUDPSrcTimeout")) {
-        gboolean ignore_timeout;
-
         GST_DEBUG_OBJECT (bin, "timeout on UDP port");
 
-        GST_OBJECT_LOCK (demux);
-        ignore_timeout = demux->ignore_timeout;
-        demux->ignore_timeout = TRUE;
-        GST_OBJECT_UNLOCK (demux);
-
-        /* we only act on the first udp timeout message, others are irrelevant
-         * and can be ignored. */
-        if (ignore_timeout)
-          gst_message_unref (message);
-        else {
-          GST_ELEMENT_ERROR (demux, RESOURCE, READ, (NULL),
-              ("Could not receive any UDP packets for %.4f seconds, maybe your "
-                  "firewall is blocking it.",
-                  gst_guint64_to_gdouble (demux->udp_timeout / 1000000.0)));
-        }
+        gst_sdp_demux_udp_timeout (demux);
+        gst_message_unref (message);
         return;
       }
       GST_BIN_CLASS (parent_class)->handle_message (bin, message);
@@ -1393,14 +1817,31 @@ gst_sdp_demux_start (GstSDPDemux * demux)
 
       GST_DEBUG_OBJECT (demux, "configuring transport for stream %p", stream);
 
-      if (!gst_sdp_demux_stream_configure_udp (demux, stream))
-        goto transport_failed;
+      if (demux->shared_receiver) {
+        if (!gst_sdp_demux_stream_configure_shared (demux, stream))
+          goto transport_failed;
+      } else {
+        if (!gst_sdp_demux_stream_configure_udp (demux, stream))
+          goto transport_failed;
+      }
       if (!gst_sdp_demux_stream_configure_udp_sink (demux, stream))
         goto transport_failed;
     }
 
     if (!demux->streams)
       goto no_streams;
+
+    if (demux->shared_receiver) {
+      GstTask *task;
+
+      task = gst_task_create ((GstTaskFunction) gst_sdp_demux_receiver_loop,
+          demux);
+      gst_task_set_lock (task, demux->task_rec_lock);
+
+      GST_OBJECT_LOCK (demux);
+      demux->task = task;
+      GST_OBJECT_UNLOCK (demux);
+    }
   }
 
   /* set target state on session manager */
@@ -1422,9 +1863,15 @@ gst_sdp_demux_start (GstSDPDemux * demux)
       stream = (GstSDPStream *) walk->data;
 
       /* configure target state on udp sources */
-      gst_element_set_state (stream->udpsrc[0], demux->target);
-      gst_element_set_state (stream->udpsrc[1], demux->target);
+      if (stream->udpsrc[0])
+        gst_element_set_state (stream->udpsrc[0], demux->target);
+      if (stream->udpsrc[1])
+        gst_element_set_state (stream->udpsrc[1], demux->target);
     }
+
+    /* like the udp sources, the shared receiver only runs in PLAYING */
+    if (demux->target == GST_STATE_PLAYING)
+      gst_sdp_demux_receiver_start (demux);
   }
   GST_SDP_STREAM_UNLOCK (demux);
   gst_sdp_message_uninit (&sdp);
@@ -1527,6 +1974,11 @@ gst_sdp_demux_change_state (GstElement * element, GstStateChange transition)
 
   demux = GST_SDP_DEMUX (element);
 
+  /* stop the shared receiver before taking the stream lock, it might need the
+   * lock to finish pushing a packet */
+  if (transition == GST_STATE_CHANGE_PAUSED_TO_READY)
+    gst_sdp_demux_receiver_stop (demux);
+
   GST_SDP_STREAM_LOCK (demux);
 
   switch (transition) {
@@ -1541,6 +1993,9 @@ gst_sdp_demux_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
       demux->target = GST_STATE_PLAYING;
       break;
+    case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
+      gst_sdp_demux_receiver_pause (demux);
+      break;
     default:
       break;
   }
@@ -1553,6 +2008,9 @@ gst_sdp_demux_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       ret = GST_STATE_CHANGE_NO_PREROLL;
       break;
+    case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
+      gst_sdp_demux_receiver_start (demux);
+      break;
     case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
       ret = GST_STATE_CHANGE_NO_PREROLL;
       demux->target = GST_STATE_PAUSED;
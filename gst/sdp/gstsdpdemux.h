@@ -63,6 +63,10 @@ struct _GstSDPStream {
   /* our udp sources */
   GstElement   *udpsrc[2];
   GstPad       *channelpad[2];
+
+  /* sockets polled by the shared receiver instead of the udp sources */
+  GstPollFD     sockfd[2];
+  gboolean      need_segment;
   guint         rtp_port;
   guint         rtcp_port;
 
@@ -87,6 +91,10 @@ struct _GstSDPDemux {
   GstState         target;
 
   /* task for UDP loop */
+  GstTask         *task;
+  GStaticRecMutex *task_rec_lock;
+  GstPoll         *fdset;
+  gboolean         have_data;
   gboolean         ignore_timeout;
 
   gint             numstreams;
@@ -98,6 +106,7 @@ struct _GstSDPDemux {
   guint64           udp_timeout;
   guint             latency;
   gboolean          redirect;
+  gboolean          shared_receiver;
 
   /* session management */
   GstElement      *session;
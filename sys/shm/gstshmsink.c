@@ -45,7 +45,15 @@ enum
   PROP_SOCKET_PATH,
   PROP_PERMS,
   PROP_SHM_SIZE,
-  PROP_WAIT_FOR_CONNECTION
+  PROP_WAIT_FOR_CONNECTION,
+  PROP_RING_SIZE,
+  PROP_SHM_USED,
+  PROP_SHM_LARGEST_FREE,
+  PROP_SHM_FRAGMENTATION,
+  PROP_SHM_BLOCKS,
+  PROP_BUFFER_SIZE,
+  PROP_BYTES_ZERO_COPY,
+  PROP_BYTES_COPIED
 };
 
 struct GstShmClient
@@ -57,6 +65,8 @@ struct GstShmClient
 #define DEFAULT_SIZE ( 256 * 1024 )
 #define DEFAULT_WAIT_FOR_CONNECTION (TRUE)
 #define DEFAULT_PERMS (S_IRWXU | S_IRWXG)
+#define DEFAULT_RING_SIZE 0
+#define DEFAULT_BUFFER_SIZE 0
 
 
 GST_DEBUG_CATEGORY_STATIC (shmsink_debug);
@@ -80,6 +90,7 @@ static gboolean gst_shm_sink_stop (GstBaseSink * bsink);
 static GstFlowReturn gst_shm_sink_render (GstBaseSink * bsink, GstBuffer * buf);
 static GstFlowReturn gst_shm_sink_buffer_alloc (GstBaseSink * sink,
     guint64 offset, guint size, GstCaps * caps, GstBuffer ** out_buf);
+static void gst_shm_sink_free_buffer (gpointer data);
 
 static gboolean gst_shm_sink_event (GstBaseSink * bsink, GstEvent * event);
 static gboolean gst_shm_sink_unlock (GstBaseSink * bsink);
@@ -111,6 +122,8 @@ gst_shm_sink_init (GstShmSink * self, GstShmSinkClass * g_class)
   self->size = DEFAULT_SIZE;
   self->wait_for_connection = DEFAULT_WAIT_FOR_CONNECTION;
   self->perms = DEFAULT_PERMS;
+  self->ring_size = DEFAULT_RING_SIZE;
+  self->buffer_size = DEFAULT_BUFFER_SIZE;
 }
 
 static void
@@ -163,6 +176,62 @@ gst_shm_sink_class_init (GstShmSinkClass * klass)
           DEFAULT_WAIT_FOR_CONNECTION,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (gobject_class, PROP_RING_SIZE,
+      g_param_spec_uint ("ring-size",
+          "Size of the buffer ring",
+          "Number of buffer descriptors in the lock-free ring shared with the"
+          " clients, 0 to announce the buffers over the control socket"
+          " (takes effect when starting)",
+          0, 65536, DEFAULT_RING_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_BUFFER_SIZE,
+      g_param_spec_uint ("buffer-size",
+          "Size of the allocated buffers",
+          "Minimum size of the shared memory buffers handed to upstream"
+          " elements, so that producers whose output size varies can still"
+          " write into shared memory directly (0 = the requested size)",
+          0, G_MAXUINT, DEFAULT_BUFFER_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_BYTES_ZERO_COPY,
+      g_param_spec_uint64 ("bytes-zero-copy",
+          "Bytes sent without copy",
+          "Number of bytes sent from buffers that were already in shared memory",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_BYTES_COPIED,
+      g_param_spec_uint64 ("bytes-copied",
+          "Bytes copied",
+          "Number of bytes that had to be copied into shared memory",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_SHM_USED,
+      g_param_spec_uint ("shm-used",
+          "Used shared memory",
+          "Number of bytes of the shared memory area in use by buffers",
+          0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_SHM_LARGEST_FREE,
+      g_param_spec_uint ("shm-largest-free",
+          "Largest free block",
+          "Size of the largest buffer that can currently be allocated in the"
+          " shared memory area",
+          0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_SHM_FRAGMENTATION,
+      g_param_spec_double ("shm-fragmentation",
+          "Fragmentation of the shared memory",
+          "Part of the free shared memory that is not in the largest free block"
+          " (0 = not fragmented)",
+          0.0, 1.0, 0.0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_SHM_BLOCKS,
+      g_param_spec_uint ("shm-blocks",
+          "Allocated blocks",
+          "Number of buffers allocated in the shared memory area",
+          0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   signals[SIGNAL_CLIENT_CONNECTED] = g_signal_new ("client-connected",
       GST_TYPE_SHM_SINK, G_SIGNAL_RUN_LAST, 0, NULL, NULL,
       g_cclosure_marshal_VOID__INT, G_TYPE_NONE, 1, G_TYPE_INT);
@@ -230,6 +299,16 @@ gst_shm_sink_set_property (GObject * object, guint prop_id,
       GST_OBJECT_UNLOCK (object);
       g_cond_broadcast (self->cond);
       break;
+    case PROP_RING_SIZE:
+      GST_OBJECT_LOCK (object);
+      self->ring_size = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    case PROP_BUFFER_SIZE:
+      GST_OBJECT_LOCK (object);
+      self->buffer_size = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
     default:
       break;
   }
@@ -264,6 +343,42 @@ gst_shm_sink_get_property (GObject * object, guint prop_id,
     case PROP_WAIT_FOR_CONNECTION:
       g_value_set_boolean (value, self->wait_for_connection);
       break;
+    case PROP_RING_SIZE:
+      g_value_set_uint (value, self->ring_size);
+      break;
+    case PROP_BUFFER_SIZE:
+      g_value_set_uint (value, self->buffer_size);
+      break;
+    case PROP_BYTES_ZERO_COPY:
+      g_value_set_uint64 (value, self->bytes_zero_copy);
+      break;
+    case PROP_BYTES_COPIED:
+      g_value_set_uint64 (value, self->bytes_copied);
+      break;
+    case PROP_SHM_USED:
+    case PROP_SHM_LARGEST_FREE:
+    case PROP_SHM_FRAGMENTATION:
+    case PROP_SHM_BLOCKS:
+    {
+      ShmAllocStats stats;
+
+      memset (&stats, 0, sizeof (stats));
+      if (self->pipe)
+        sp_writer_get_alloc_stats (self->pipe, &stats);
+
+      if (prop_id == PROP_SHM_USED)
+        g_value_set_uint (value, stats.used);
+      else if (prop_id == PROP_SHM_LARGEST_FREE)
+        g_value_set_uint (value, stats.largest_free);
+      else if (prop_id == PROP_SHM_BLOCKS)
+        g_value_set_uint (value, stats.n_blocks);
+      else if (stats.size > stats.used)
+        g_value_set_double (value,
+            1.0 - (gdouble) stats.largest_free / (stats.size - stats.used));
+      else
+        g_value_set_double (value, 0.0);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -280,6 +395,8 @@ gst_shm_sink_start (GstBaseSink * bsink)
   GstShmSink *self = GST_SHM_SINK (bsink);
 
   self->stop = FALSE;
+  self->bytes_zero_copy = 0;
+  self->bytes_copied = 0;
 
   if (!self->socket_path) {
     GST_ELEMENT_ERROR (self, RESOURCE, OPEN_READ_WRITE,
@@ -298,6 +415,11 @@ gst_shm_sink_start (GstBaseSink * bsink)
     return FALSE;
   }
 
+  if (self->ring_size &&
+      sp_writer_enable_ring (self->pipe, self->ring_size) < 0)
+    GST_WARNING_OBJECT (self, "Could not create a ring of %u buffers, "
+        "announcing buffers over the socket", self->ring_size);
+
   sp_set_data (self->pipe, self);
   g_free (self->socket_path);
   self->socket_path = g_strdup (sp_writer_get_path (self->pipe));
@@ -310,6 +432,13 @@ gst_shm_sink_start (GstBaseSink * bsink)
   gst_poll_add_fd (self->poll, &self->serverpollfd);
   gst_poll_fd_ctl_read (self->poll, &self->serverpollfd, TRUE);
 
+  gst_poll_fd_init (&self->ringpollfd);
+  if (sp_get_ring_fd (self->pipe) >= 0) {
+    self->ringpollfd.fd = sp_get_ring_fd (self->pipe);
+    gst_poll_add_fd (self->poll, &self->ringpollfd);
+    gst_poll_fd_ctl_read (self->poll, &self->ringpollfd, TRUE);
+  }
+
   self->pollthread = g_thread_create (pollthread_func, self, TRUE, NULL);
 
   if (!self->pollthread)
@@ -359,6 +488,25 @@ gst_shm_sink_stop (GstBaseSink * bsink)
   return TRUE;
 }
 
+/* Called with the object lock, @block is the block @data was allocated from
+ * or NULL to look it up. Returns -2 if unlocked while waiting for the
+ * clients to release ring slots */
+static gint
+gst_shm_sink_send_buf (GstShmSink * self, ShmBlock * block, gchar * data,
+    gsize size)
+{
+  gint rv;
+
+  while ((rv = block ? sp_writer_send_block (self->pipe, block, data, size) :
+          sp_writer_send_buf (self->pipe, data, size)) == -2) {
+    g_cond_wait (self->cond, GST_OBJECT_GET_LOCK (self));
+    if (self->unlock)
+      break;
+  }
+
+  return rv;
+}
+
 static GstFlowReturn
 gst_shm_sink_render (GstBaseSink * bsink, GstBuffer * buf)
 {
@@ -374,8 +522,17 @@ gst_shm_sink_render (GstBaseSink * bsink, GstBuffer * buf)
     }
   }
 
-  rv = sp_writer_send_buf (self->pipe, (char *) GST_BUFFER_DATA (buf),
-      GST_BUFFER_SIZE (buf));
+  /* Buffers from our allocator are sent as they are, the others may still
+   * point into the shared memory, like subbuffers of ours */
+  if (GST_BUFFER_FREE_FUNC (buf) == gst_shm_sink_free_buffer)
+    rv = gst_shm_sink_send_buf (self, (ShmBlock *) GST_BUFFER_MALLOCDATA (buf),
+        (gchar *) GST_BUFFER_DATA (buf), GST_BUFFER_SIZE (buf));
+  else
+    rv = gst_shm_sink_send_buf (self, NULL, (gchar *) GST_BUFFER_DATA (buf),
+        GST_BUFFER_SIZE (buf));
+
+  if (rv > 0)
+    self->bytes_zero_copy += GST_BUFFER_SIZE (buf);
 
   if (rv == -1) {
     ShmBlock *block = NULL;
@@ -400,10 +557,18 @@ gst_shm_sink_render (GstBaseSink * bsink, GstBuffer * buf)
 
     shmbuf = sp_writer_block_get_buf (block);
     memcpy (shmbuf, GST_BUFFER_DATA (buf), GST_BUFFER_SIZE (buf));
-    sp_writer_send_buf (self->pipe, shmbuf, GST_BUFFER_SIZE (buf));
+    self->bytes_copied += GST_BUFFER_SIZE (buf);
+    GST_LOG_OBJECT (self, "Copied buffer of %u bytes into shared memory",
+        GST_BUFFER_SIZE (buf));
+    rv = gst_shm_sink_send_buf (self, block, shmbuf, GST_BUFFER_SIZE (buf));
     sp_writer_free_block (block);
   }
 
+  if (rv == -2) {
+    GST_OBJECT_UNLOCK (self);
+    return GST_FLOW_WRONG_STATE;
+  }
+
   GST_OBJECT_UNLOCK (self);
 
   return GST_FLOW_OK;
@@ -435,7 +600,8 @@ gst_shm_sink_buffer_alloc (GstBaseSink * sink, guint64 offset, guint size,
   gpointer buf = NULL;
 
   GST_OBJECT_LOCK (self);
-  block = sp_writer_alloc_block (self->pipe, size);
+  if (self->pipe)
+    block = sp_writer_alloc_block (self->pipe, MAX (size, self->buffer_size));
   if (block) {
     buf = sp_writer_block_get_buf (block);
     g_object_ref (self);
@@ -491,6 +657,13 @@ pollthread_func (gpointer data)
       return NULL;
     }
 
+    if (self->ringpollfd.fd >= 0 &&
+        gst_poll_fd_can_read (self->poll, &self->ringpollfd)) {
+      GST_OBJECT_LOCK (self);
+      sp_writer_ring_recv (self->pipe);
+      GST_OBJECT_UNLOCK (self);
+    }
+
     if (gst_poll_fd_can_read (self->poll, &self->serverpollfd)) {
       ShmClient *client;
       struct GstShmClient *gclient;
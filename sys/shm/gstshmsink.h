@@ -51,18 +51,24 @@ struct _GstShmSink
 
   guint perms;
   guint size;
+  guint ring_size;
+  guint buffer_size;
 
   GList *clients;
 
   GThread *pollthread;
   GstPoll *poll;
   GstPollFD serverpollfd;
+  GstPollFD ringpollfd;
 
   gboolean wait_for_connection;
   gboolean stop;
   gboolean unlock;
 
   GCond *cond;
+
+  guint64 bytes_zero_copy;
+  guint64 bytes_copied;
 };
 
 struct _GstShmSinkClass
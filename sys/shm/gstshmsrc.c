@@ -140,6 +140,7 @@ gst_shm_src_init (GstShmSrc * self, GstShmSrcClass * g_class)
 {
   self->poll = gst_poll_new (TRUE);
   gst_poll_fd_init (&self->pollfd);
+  gst_poll_fd_init (&self->ringpollfd);
 }
 
 static void
@@ -255,6 +256,11 @@ gst_shm_src_stop_reading (GstShmSrc * self)
   gst_poll_remove_fd (self->poll, &self->pollfd);
   gst_poll_fd_init (&self->pollfd);
 
+  if (self->ringpollfd.fd >= 0) {
+    gst_poll_remove_fd (self->poll, &self->ringpollfd);
+    gst_poll_fd_init (&self->ringpollfd);
+  }
+
   gst_poll_set_flushing (self->poll, TRUE);
 }
 
@@ -304,6 +310,18 @@ gst_shm_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
   struct GstShmBuffer *gsb;
 
   do {
+    /* With a ring, buffers are read without waking up if there is one */
+    GST_OBJECT_LOCK (self);
+    rv = sp_client_ring_recv (self->pipe->pipe, &buf);
+    GST_OBJECT_UNLOCK (self);
+    if (rv < 0) {
+      GST_ELEMENT_ERROR (self, RESOURCE, READ, ("Failed to read from shmsrc"),
+          ("Error reading from the ring: %d", rv));
+      return GST_FLOW_ERROR;
+    }
+    if (buf)
+      break;
+
     if (gst_poll_wait (self->poll, GST_CLOCK_TIME_NONE) < 0) {
       if (errno == EBUSY)
         return GST_FLOW_WRONG_STATE;
@@ -338,6 +356,13 @@ gst_shm_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
             ("Error reading control data: %d", rv));
         return GST_FLOW_ERROR;
       }
+
+      if (self->ringpollfd.fd < 0 && sp_get_ring_fd (self->pipe->pipe) >= 0) {
+        GST_DEBUG_OBJECT (self, "Receiving buffers through the ring");
+        self->ringpollfd.fd = sp_get_ring_fd (self->pipe->pipe);
+        gst_poll_add_fd (self->poll, &self->ringpollfd);
+        gst_poll_fd_ctl_read (self->poll, &self->ringpollfd, TRUE);
+      }
     }
   } while (buf == NULL);
 
@@ -33,14 +33,51 @@
 #include <string.h>
 #include <assert.h>
 
+/*
+ * This is a two level segregated fit allocator: the space is cut in blocks
+ * of granules, the free blocks are kept in lists by size class and bitmaps
+ * tell which lists are not empty, so finding a block big enough is a couple
+ * of bit scans. Freed blocks are merged with their free neighbours.
+ *
+ * The first level class is the power of 2 of the number of granules, the
+ * second level splits each power of 2 in SL_COUNT classes.
+ *
+ * An index with an entry per granule points to the allocated block covering
+ * it, so the block of any offset is found with a single lookup. Keeping it up
+ * to date costs a store per granule when a block is allocated or freed, which
+ * is small next to writing the data of the block.
+ */
+
+#define GRANULE_SHIFT 8
+#define GRANULE (1UL << GRANULE_SHIFT)
+
+#define SL_SHIFT 4
+#define SL_COUNT (1 << SL_SHIFT)
+#define FL_COUNT 32
+
 /* This is the allocated space to hold multiple blocks */
 struct _ShmAllocSpace
 {
   /* The total size of this space */
   size_t size;
 
-  /* chained list of the blocks contained in this space */
+  /* The number of granules that can be allocated */
+  unsigned long n_granules;
+
+  /* The first block of the space, it is never merged away */
   ShmAllocBlock *blocks;
+
+  /* The allocated block covering each granule, NULL for free space */
+  ShmAllocBlock **index;
+
+  /* Free lists by size class and bitmaps of the non-empty ones */
+  unsigned int fl_bitmap;
+  unsigned int sl_bitmap[FL_COUNT];
+  ShmAllocBlock *free_lists[FL_COUNT][SL_COUNT];
+
+  unsigned long used_granules;
+  unsigned int n_blocks;
+  unsigned int n_free_blocks;
 };
 
 /* A single block of data */
@@ -56,11 +93,172 @@ struct _ShmAllocBlock
   /* The size of the block */
   unsigned long size;
 
-  /* Pointer to the next block in the chain */
+  /* The number of granules covered by the block */
+  unsigned long n_granules;
+  int is_free;
+
+  /* Neighbours in the space */
+  ShmAllocBlock *prev;
   ShmAllocBlock *next;
+
+  /* Neighbours in the free list */
+  ShmAllocBlock *prev_free;
+  ShmAllocBlock *next_free;
 };
 
 
+static int
+find_msb (unsigned long value)
+{
+#ifdef __GNUC__
+  return sizeof (unsigned long) * 8 - 1 - __builtin_clzl (value);
+#else
+  int bit = 0;
+
+  while (value >>= 1)
+    bit++;
+
+  return bit;
+#endif
+}
+
+static int
+find_lsb (unsigned int value)
+{
+#ifdef __GNUC__
+  return __builtin_ctz (value);
+#else
+  int bit = 0;
+
+  while (!(value & 1)) {
+    value >>= 1;
+    bit++;
+  }
+
+  return bit;
+#endif
+}
+
+static void
+mapping (unsigned long n_granules, int *fl, int *sl)
+{
+  if (n_granules < SL_COUNT) {
+    *fl = 0;
+    *sl = n_granules;
+  } else {
+    int msb = find_msb (n_granules);
+
+    *fl = msb - SL_SHIFT + 1;
+    *sl = (n_granules >> (msb - SL_SHIFT)) - SL_COUNT;
+  }
+}
+
+static void
+free_list_insert (ShmAllocSpace * self, ShmAllocBlock * block)
+{
+  int fl, sl;
+
+  mapping (block->n_granules, &fl, &sl);
+
+  block->prev_free = NULL;
+  block->next_free = self->free_lists[fl][sl];
+  if (block->next_free)
+    block->next_free->prev_free = block;
+  self->free_lists[fl][sl] = block;
+
+  self->fl_bitmap |= 1U << fl;
+  self->sl_bitmap[fl] |= 1U << sl;
+  self->n_free_blocks++;
+}
+
+static void
+free_list_remove (ShmAllocSpace * self, ShmAllocBlock * block)
+{
+  int fl, sl;
+
+  mapping (block->n_granules, &fl, &sl);
+
+  if (block->prev_free)
+    block->prev_free->next_free = block->next_free;
+  else
+    self->free_lists[fl][sl] = block->next_free;
+  if (block->next_free)
+    block->next_free->prev_free = block->prev_free;
+
+  if (!self->free_lists[fl][sl]) {
+    self->sl_bitmap[fl] &= ~(1U << sl);
+    if (!self->sl_bitmap[fl])
+      self->fl_bitmap &= ~(1U << fl);
+  }
+  self->n_free_blocks--;
+}
+
+/* Returns a free block of at least n_granules */
+static ShmAllocBlock *
+find_free_block (ShmAllocSpace * self, unsigned long n_granules)
+{
+  ShmAllocBlock *block;
+  unsigned long rounded = n_granules;
+  unsigned int sl_map;
+  int fl, sl;
+
+  /* Round up to the next class, so that any block of the class we find
+   * is big enough */
+  if (n_granules >= SL_COUNT)
+    rounded += (1UL << (find_msb (n_granules) - SL_SHIFT)) - 1;
+  mapping (rounded, &fl, &sl);
+
+  if (fl < FL_COUNT) {
+    sl_map = self->sl_bitmap[fl] & (~0U << sl);
+    if (!sl_map && fl + 1 < FL_COUNT) {
+      unsigned int fl_map = self->fl_bitmap & (~0U << (fl + 1));
+
+      if (fl_map) {
+        fl = find_lsb (fl_map);
+        sl_map = self->sl_bitmap[fl];
+      }
+    }
+
+    if (sl_map)
+      return self->free_lists[fl][find_lsb (sl_map)];
+  }
+
+  /* There may still be a big enough block in the class of the request */
+  mapping (n_granules, &fl, &sl);
+  if (fl >= FL_COUNT)
+    return NULL;
+  for (block = self->free_lists[fl][sl]; block; block = block->next_free) {
+    if (block->n_granules >= n_granules)
+      return block;
+  }
+
+  return NULL;
+}
+
+static ShmAllocBlock *
+shm_alloc_block_new (ShmAllocSpace * self, unsigned long granule,
+    unsigned long n_granules)
+{
+  ShmAllocBlock *block = spalloc_new (ShmAllocBlock);
+
+  memset (block, 0, sizeof (ShmAllocBlock));
+  block->space = self;
+  block->offset = granule << GRANULE_SHIFT;
+  block->n_granules = n_granules;
+
+  return block;
+}
+
+static void
+index_set (ShmAllocSpace * self, ShmAllocBlock * block, ShmAllocBlock * value)
+{
+  unsigned long granule = block->offset >> GRANULE_SHIFT;
+  unsigned long i;
+
+  for (i = 0; i < block->n_granules; i++)
+    self->index[granule + i] = value;
+}
+
 ShmAllocSpace *
 shm_alloc_space_new (size_t size)
 {
@@ -69,6 +267,16 @@ shm_alloc_space_new (size_t size)
   memset (self, 0, sizeof (ShmAllocSpace));
 
   self->size = size;
+  self->n_granules = size >> GRANULE_SHIFT;
+
+  self->index = spalloc_alloc (sizeof (ShmAllocBlock *) * self->n_granules);
+  memset (self->index, 0, sizeof (ShmAllocBlock *) * self->n_granules);
+
+  if (self->n_granules) {
+    self->blocks = shm_alloc_block_new (self, 0, self->n_granules);
+    self->blocks->is_free = 1;
+    free_list_insert (self, self->blocks);
+  }
 
   return self;
 }
@@ -76,7 +284,16 @@ shm_alloc_space_new (size_t size)
 void
 shm_alloc_space_free (ShmAllocSpace * self)
 {
-  assert (self && self->blocks == NULL);
+  ShmAllocBlock *block, *next;
+
+  assert (self && self->n_blocks == 0);
+
+  for (block = self->blocks; block; block = next) {
+    next = block->next;
+    spalloc_free (ShmAllocBlock, block);
+  }
+
+  spalloc_free1 (sizeof (ShmAllocBlock *) * self->n_granules, self->index);
   spalloc_free (ShmAllocSpace, self);
 }
 
@@ -85,44 +302,41 @@ ShmAllocBlock *
 shm_alloc_space_alloc_block (ShmAllocSpace * self, unsigned long size)
 {
   ShmAllocBlock *block;
-  ShmAllocBlock *item = NULL;
-  ShmAllocBlock *prev_item = NULL;
-  unsigned long prev_end_offset = 0;
-
-
-  for (item = self->blocks; item; item = item->next) {
-    unsigned long max_size = 0;
-
-    max_size = item->offset - prev_end_offset;
-
-    if (max_size >= size)
-      break;
-
-    prev_end_offset = item->offset + item->size;
-    prev_item = item;
+  unsigned long n_granules;
+
+  n_granules = (size + GRANULE - 1) >> GRANULE_SHIFT;
+  if (n_granules == 0)
+    n_granules = 1;
+
+  block = find_free_block (self, n_granules);
+  if (!block)
+    return NULL;
+
+  free_list_remove (self, block);
+
+  /* Put the rest back in the free lists */
+  if (block->n_granules > n_granules) {
+    ShmAllocBlock *rest = shm_alloc_block_new (self,
+        (block->offset >> GRANULE_SHIFT) + n_granules,
+        block->n_granules - n_granules);
+
+    rest->is_free = 1;
+    rest->prev = block;
+    rest->next = block->next;
+    if (rest->next)
+      rest->next->prev = rest;
+    block->next = rest;
+    block->n_granules = n_granules;
+    free_list_insert (self, rest);
   }
 
-  /* Did not find space before an existing block */
-  if (self->blocks && !item) {
-    /* Return NULL if there is no big enough space, otherwise, there is space
-     * at the end */
-    if (self->size - prev_end_offset < size)
-      return NULL;
-  }
-
-  block = spalloc_new (ShmAllocBlock);
-  memset (block, 0, sizeof (ShmAllocBlock));
-  block->offset = prev_end_offset;
-  block->size = size;
+  block->is_free = 0;
   block->use_count = 1;
-  block->space = self;
-
-  if (prev_item)
-    prev_item->next = block;
-  else
-    self->blocks = block;
+  block->size = size;
+  index_set (self, block, block);
 
-  block->next = item;
+  self->used_granules += n_granules;
+  self->n_blocks++;
 
   return block;
 }
@@ -133,38 +347,90 @@ shm_alloc_space_alloc_block_get_offset (ShmAllocBlock * block)
   return block->offset;
 }
 
+unsigned long
+shm_alloc_space_alloc_block_get_size (ShmAllocBlock * block)
+{
+  return block->size;
+}
+
+/* Merges @block into @prev, which is the block before it */
+static void
+merge_blocks (ShmAllocBlock * prev, ShmAllocBlock * block)
+{
+  prev->n_granules += block->n_granules;
+  prev->next = block->next;
+  if (prev->next)
+    prev->next->prev = prev;
+
+  spalloc_free (ShmAllocBlock, block);
+}
+
 static void
 shm_alloc_space_free_block (ShmAllocBlock * block)
 {
-  ShmAllocBlock *item = NULL;
-  ShmAllocBlock *prev_item = NULL;
   ShmAllocSpace *self = block->space;
 
-  for (item = self->blocks; item; item = item->next) {
-    if (item == block) {
-      if (prev_item)
-        prev_item->next = item->next;
-      else
-        self->blocks = item->next;
-      break;
-    }
-    prev_item = item;
+  self->used_granules -= block->n_granules;
+  self->n_blocks--;
+  block->is_free = 1;
+  index_set (self, block, NULL);
+
+  if (block->next && block->next->is_free) {
+    free_list_remove (self, block->next);
+    merge_blocks (block, block->next);
   }
 
-  spalloc_free (ShmAllocBlock, block);
+  if (block->prev && block->prev->is_free) {
+    ShmAllocBlock *prev = block->prev;
+
+    free_list_remove (self, prev);
+    merge_blocks (prev, block);
+    block = prev;
+  }
+
+  free_list_insert (self, block);
 }
 
 ShmAllocBlock *
 shm_alloc_space_block_get (ShmAllocSpace * self, unsigned long offset)
 {
-  ShmAllocBlock *block = NULL;
+  ShmAllocBlock *block;
+  unsigned long granule = offset >> GRANULE_SHIFT;
 
-  for (block = self->blocks; block; block = block->next) {
-    if (block->offset <= offset && (block->offset + block->size) > offset)
-      return block;
-  }
+  if (granule >= self->n_granules)
+    return NULL;
 
-  return NULL;
+  /* The tail of the last granule of a block is not part of the block */
+  block = self->index[granule];
+  if (!block || (offset != block->offset &&
+          offset >= block->offset + block->size))
+    return NULL;
+
+  return block;
+}
+
+void
+shm_alloc_space_get_stats (ShmAllocSpace * self, ShmAllocStats * stats)
+{
+  ShmAllocBlock *block;
+
+  memset (stats, 0, sizeof (ShmAllocStats));
+
+  stats->size = self->n_granules << GRANULE_SHIFT;
+  stats->used = self->used_granules << GRANULE_SHIFT;
+  stats->n_blocks = self->n_blocks;
+  stats->n_free_blocks = self->n_free_blocks;
+
+  /* The largest free block is in the highest non-empty class */
+  if (self->fl_bitmap) {
+    int fl = find_msb (self->fl_bitmap);
+    int sl = find_msb (self->sl_bitmap[fl]);
+
+    for (block = self->free_lists[fl][sl]; block; block = block->next_free) {
+      if ((block->n_granules << GRANULE_SHIFT) > stats->largest_free)
+        stats->largest_free = block->n_granules << GRANULE_SHIFT;
+    }
+  }
 }
 
 
@@ -53,6 +53,18 @@ extern "C" {
 typedef struct _ShmAllocSpace ShmAllocSpace;
 typedef struct _ShmAllocBlock ShmAllocBlock;
 
+typedef struct
+{
+  /* The number of bytes that can be allocated */
+  size_t size;
+  /* The bytes in allocated blocks, rounded up to the allocation granule */
+  size_t used;
+  /* The size of the largest block that can currently be allocated */
+  size_t largest_free;
+  unsigned int n_blocks;
+  unsigned int n_free_blocks;
+} ShmAllocStats;
+
 ShmAllocSpace *shm_alloc_space_new (size_t size);
 void shm_alloc_space_free (ShmAllocSpace * self);
 
@@ -60,12 +72,15 @@ void shm_alloc_space_free (ShmAllocSpace * self);
 ShmAllocBlock *shm_alloc_space_alloc_block (ShmAllocSpace * self,
     unsigned long size);
 unsigned long shm_alloc_space_alloc_block_get_offset (ShmAllocBlock *block);
+unsigned long shm_alloc_space_alloc_block_get_size (ShmAllocBlock *block);
 
 void shm_alloc_space_block_inc (ShmAllocBlock * block);
 void shm_alloc_space_block_dec (ShmAllocBlock * block);
 ShmAllocBlock * shm_alloc_space_block_get (ShmAllocSpace * space,
     unsigned long offset);
 
+void shm_alloc_space_get_stats (ShmAllocSpace * self, ShmAllocStats * stats);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,406 @@
+/* GStreamer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * Measures the frame rate and the latency of the shm transport for an
+ * increasing number of client processes, over the socket or over the ring:
+ *
+ *   shmbench [-r ring slots, 0 for the socket] [-c max clients]
+ *       [-n frames] [-s frame size] [-f frames per second, 0 for unpaced]
+ *
+ * The latency is measured from the moment the writer fills the frame to the
+ * moment the client reads it, the percentiles are those of the slowest
+ * client.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "shmpipe.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#define MAX_CLIENTS 64
+
+typedef struct
+{
+  uint64_t timestamp;
+  uint32_t seq;
+  uint32_t last;
+} FrameHeader;
+
+typedef struct
+{
+  uint64_t frames;
+  uint64_t p50, p90, p99, max;
+} ClientStats;
+
+static uint64_t
+now_ns (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int
+compare_u64 (const void *a, const void *b)
+{
+  uint64_t va = *(const uint64_t *) a;
+  uint64_t vb = *(const uint64_t *) b;
+
+  return va < vb ? -1 : va > vb;
+}
+
+static int
+run_client (const char *path, int resultfd, unsigned int n_frames)
+{
+  ShmPipe *pipe;
+  uint64_t *latencies;
+  ClientStats stats;
+  unsigned int n;
+  int done = 0;
+
+  memset (&stats, 0, sizeof (stats));
+
+  pipe = sp_client_open (path);
+  if (!pipe) {
+    fprintf (stderr, "Could not connect to %s: %s\n", path, strerror (errno));
+    return 1;
+  }
+
+  latencies = malloc (sizeof (uint64_t) * n_frames);
+
+  while (!done) {
+    char *buf = NULL;
+    long int rv;
+
+    rv = sp_client_ring_recv (pipe, &buf);
+    if (rv < 0)
+      goto error;
+
+    if (!buf) {
+      struct pollfd fds[2];
+      int n_fds = 1;
+
+      fds[0].fd = sp_get_fd (pipe);
+      fds[0].events = POLLIN;
+      if (sp_get_ring_fd (pipe) >= 0) {
+        fds[1].fd = sp_get_ring_fd (pipe);
+        fds[1].events = POLLIN;
+        n_fds++;
+      }
+
+      if (poll (fds, n_fds, -1) < 0) {
+        if (errno == EINTR)
+          continue;
+        goto error;
+      }
+
+      if (fds[0].revents & POLLIN) {
+        rv = sp_client_recv (pipe, &buf);
+        if (rv < 0)
+          goto error;
+      } else if (fds[0].revents & (POLLERR | POLLHUP)) {
+        goto error;
+      }
+    }
+
+    if (buf) {
+      FrameHeader header;
+
+      memcpy (&header, buf, sizeof (header));
+      if (stats.frames < n_frames)
+        latencies[stats.frames] = now_ns () - header.timestamp;
+      stats.frames++;
+      done = header.last;
+      sp_client_recv_finish (pipe, buf);
+    }
+  }
+
+  n = stats.frames < n_frames ? stats.frames : n_frames;
+  qsort (latencies, n, sizeof (uint64_t), compare_u64);
+  stats.p50 = latencies[n / 2];
+  stats.p90 = latencies[n * 9 / 10];
+  stats.p99 = latencies[n * 99 / 100];
+  stats.max = latencies[n - 1];
+
+  if (write (resultfd, &stats, sizeof (stats)) != sizeof (stats))
+    goto error;
+
+  free (latencies);
+  sp_close (pipe);
+  return 0;
+
+error:
+  fprintf (stderr, "Client failed after %llu frames\n",
+      (unsigned long long) stats.frames);
+  free (latencies);
+  sp_close (pipe);
+  return 1;
+}
+
+/* Waits for the clients to release buffers, the clients that are gone are
+ * removed from @clients */
+static int
+service (ShmPipe * pipe, ShmClient ** clients, int *n_clients)
+{
+  struct pollfd fds[MAX_CLIENTS + 1];
+  int n_fds = *n_clients;
+  int i, c;
+
+  for (i = 0; i < *n_clients; i++) {
+    fds[i].fd = sp_writer_get_client_fd (clients[i]);
+    fds[i].events = POLLIN;
+  }
+  if (sp_get_ring_fd (pipe) >= 0) {
+    fds[n_fds].fd = sp_get_ring_fd (pipe);
+    fds[n_fds].events = POLLIN;
+    n_fds++;
+  }
+
+  if (n_fds == 0)
+    return -1;
+
+  if (poll (fds, n_fds, -1) < 0)
+    return errno == EINTR ? 0 : -1;
+
+  if (n_fds > *n_clients && (fds[*n_clients].revents & POLLIN))
+    sp_writer_ring_recv (pipe);
+
+  for (i = 0, c = 0; i < *n_clients; i++) {
+    if (fds[i].revents & POLLIN) {
+      if (sp_writer_recv (pipe, clients[i]) < 0)
+        goto close_client;
+    } else if (fds[i].revents & (POLLERR | POLLHUP)) {
+      goto close_client;
+    }
+    clients[c++] = clients[i];
+    continue;
+  close_client:
+    sp_writer_close_client (pipe, clients[i]);
+  }
+  *n_clients = c;
+
+  return 0;
+}
+
+static int
+run_bench (int n_clients, unsigned int slots, unsigned int n_frames,
+    size_t size, unsigned int fps)
+{
+  char path[64];
+  ShmPipe *pipe;
+  ShmClient *clients[MAX_CLIENTS];
+  ClientStats worst;
+  pid_t pids[MAX_CLIENTS];
+  int resultfds[2];
+  uint64_t start, elapsed;
+  unsigned int i;
+  int c, ret = 0;
+  int n_connected = 0;
+
+  snprintf (path, sizeof (path), "/tmp/shmbench.%d", getpid ());
+  pipe = sp_writer_create (path, size * 32, 0600);
+  if (!pipe)
+    return -1;
+
+  if (slots && sp_writer_enable_ring (pipe, slots) < 0) {
+    sp_close (pipe);
+    return -1;
+  }
+
+  if (socketpair (AF_UNIX, SOCK_STREAM, 0, resultfds) < 0) {
+    sp_close (pipe);
+    return -1;
+  }
+
+  for (c = 0; c < n_clients; c++) {
+    pids[c] = fork ();
+    if (pids[c] == 0) {
+      close (resultfds[0]);
+      _exit (run_client (sp_writer_get_path (pipe), resultfds[1], n_frames));
+    }
+  }
+  close (resultfds[1]);
+
+  while (n_connected < n_clients) {
+    struct pollfd fd;
+
+    fd.fd = sp_get_fd (pipe);
+    fd.events = POLLIN;
+    if (poll (&fd, 1, -1) < 0 && errno != EINTR)
+      goto error;
+    if (fd.revents & POLLIN) {
+      clients[n_connected] = sp_writer_accept_client (pipe);
+      if (!clients[n_connected])
+        goto error;
+      n_connected++;
+    }
+  }
+
+  start = now_ns ();
+  for (i = 0; i < n_frames; i++) {
+    ShmBlock *block;
+    FrameHeader header;
+    char *buf;
+    int rv;
+
+    if (fps) {
+      uint64_t next = start + (uint64_t) i * 1000000000 / fps;
+      struct timespec ts;
+
+      ts.tv_sec = next / 1000000000;
+      ts.tv_nsec = next % 1000000000;
+      clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    }
+
+    while (!(block = sp_writer_alloc_block (pipe, size))) {
+      if (service (pipe, clients, &n_connected) < 0)
+        goto error;
+    }
+
+    buf = sp_writer_block_get_buf (block);
+    header.timestamp = now_ns ();
+    header.seq = i;
+    header.last = (i == n_frames - 1);
+    memcpy (buf, &header, sizeof (header));
+
+    while ((rv = sp_writer_send_buf (pipe, buf, size)) == -2) {
+      if (service (pipe, clients, &n_connected) < 0)
+        goto error;
+    }
+    sp_writer_free_block (block);
+
+    if (rv != n_clients)
+      goto error;
+  }
+
+  while (sp_writer_pending_writes (pipe)) {
+    if (service (pipe, clients, &n_connected) < 0)
+      goto error;
+  }
+  elapsed = now_ns () - start;
+
+  memset (&worst, 0, sizeof (worst));
+  for (c = 0; c < n_clients; c++) {
+    ClientStats stats;
+
+    if (read (resultfds[0], &stats, sizeof (stats)) != sizeof (stats))
+      goto error;
+    if (stats.frames != n_frames)
+      goto error;
+    if (stats.p50 > worst.p50)
+      worst.p50 = stats.p50;
+    if (stats.p90 > worst.p90)
+      worst.p90 = stats.p90;
+    if (stats.p99 > worst.p99)
+      worst.p99 = stats.p99;
+    if (stats.max > worst.max)
+      worst.max = stats.max;
+  }
+
+  printf ("%7d %9s %12.0f %9.1f %9.1f %9.1f %9.1f\n", n_clients,
+      slots ? "ring" : "socket", n_frames * 1e9 / elapsed, worst.p50 / 1e3,
+      worst.p90 / 1e3, worst.p99 / 1e3, worst.max / 1e3);
+
+done:
+  close (resultfds[0]);
+  sp_close (pipe);
+  for (c = 0; c < n_clients; c++) {
+    int status;
+
+    waitpid (pids[c], &status, 0);
+    if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+      ret = -1;
+  }
+  return ret;
+
+error:
+  fprintf (stderr, "Benchmark with %d clients failed\n", n_clients);
+  ret = -1;
+  goto done;
+}
+
+int
+main (int argc, char **argv)
+{
+  unsigned int slots = 64;
+  unsigned int n_frames = 10000;
+  unsigned int fps = 0;
+  size_t size = 64 * 1024;
+  int max_clients = 8;
+  int n;
+  int opt;
+
+  while ((opt = getopt (argc, argv, "r:c:n:s:f:")) != -1) {
+    switch (opt) {
+      case 'r':
+        slots = atoi (optarg);
+        break;
+      case 'c':
+        max_clients = atoi (optarg);
+        break;
+      case 'n':
+        n_frames = atoi (optarg);
+        break;
+      case 's':
+        size = atoi (optarg);
+        break;
+      case 'f':
+        fps = atoi (optarg);
+        break;
+      default:
+        fprintf (stderr, "Usage: %s [-r ring slots] [-c max clients] "
+            "[-n frames] [-s frame size] [-f fps]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  if (max_clients < 1 || max_clients > MAX_CLIENTS || n_frames == 0 ||
+      size < sizeof (FrameHeader)) {
+    fprintf (stderr, "Invalid parameters\n");
+    return 1;
+  }
+
+  printf ("clients transport     frames/s   p50 (us)  p90 (us)  p99 (us)  "
+      "max (us)\n");
+
+  for (n = 1;; n = n * 2 < max_clients ? n * 2 : max_clients) {
+    if (run_bench (n, slots, n_frames, size, fps) < 0)
+      return 1;
+    if (n == max_clients)
+      break;
+  }
+
+  return 0;
+}
@@ -33,6 +33,7 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <string.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <errno.h>
 #include <unistd.h>
@@ -41,6 +42,10 @@
 #include <sys/mman.h>
 #include <assert.h>
 
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
+
 #include "shmalloc.h"
 
 /*
@@ -61,24 +66,50 @@
  * type 4: ack buffer
  * offset
  *
+ * type 5: ring
+ * Ring segment length
+ * Index of the client in the ring
+ * Comes with 3 fds: the ring segment, the fd the server uses to wake up the
+ * client and the fd the client uses to wake up the server
+ *
  * Type 4 goes from the client to the server
  * The rest are from the server to the client
- * The client should never write in the SHM
+ * The client should never write in the SHM, except in the ring
+ *
+ * When a client has a ring, types 3 and 4 are replaced by descriptors in the
+ * ring: the server fills a slot with the buffer and the bitmask of the
+ * clients that hold it and then bumps write_seq, each client reads the slots
+ * from its own read_seq and clears its bit when it is done with the buffer.
+ * The fds are only signalled if the other side said it was waiting, so no
+ * syscall is made as long as both sides keep up. Type 2 then carries the
+ * ring sequence from which on the area is no longer used, as the client may
+ * still have descriptors for it in the ring.
  */
 
 
 #define LISTEN_BACKLOG 10
 
+#define RING_MAX_CLIENTS 32
+#define RING_FDS 3
+
+#ifndef MSG_CMSG_CLOEXEC
+#define MSG_CMSG_CLOEXEC 0
+#endif
+
 enum
 {
   COMMAND_NEW_SHM_AREA = 1,
   COMMAND_CLOSE_SHM_AREA = 2,
   COMMAND_NEW_BUFFER = 3,
-  COMMAND_ACK_BUFFER = 4
+  COMMAND_ACK_BUFFER = 4,
+  COMMAND_NEW_RING = 5
 };
 
 typedef struct _ShmArea ShmArea;
 typedef struct _ShmBuffer ShmBuffer;
+typedef struct _ShmRing ShmRing;
+typedef struct _ShmRingSlot ShmRingSlot;
+typedef struct _ShmRingClient ShmRingClient;
 
 struct _ShmArea
 {
@@ -95,6 +126,10 @@ struct _ShmArea
 
   ShmAllocSpace *allocspace;
 
+  /* Client side, the area is closed once the ring is read up to close_seq */
+  int closing;
+  uint32_t close_seq;
+
   ShmArea *next;
 };
 
@@ -114,6 +149,37 @@ struct _ShmBuffer
   int clients[0];
 };
 
+/* The ring lives in shared memory and is written to by both sides, so it
+ * only uses fixed size types */
+struct _ShmRingSlot
+{
+  /* Bitmask of the clients that have not released the buffer yet */
+  volatile uint32_t holders;
+  uint32_t seq;
+  int32_t area_id;
+  uint32_t padding;
+  uint64_t offset;
+  uint64_t size;
+};
+
+/* Padded to a cache line so the clients don't share one */
+struct _ShmRingClient
+{
+  volatile uint32_t read_seq;
+  volatile uint32_t waiting;
+  uint32_t padding[14];
+};
+
+struct _ShmRing
+{
+  uint32_t n_slots;
+  volatile uint32_t write_seq;
+  volatile uint32_t writer_waiting;
+  uint32_t padding[13];
+
+  ShmRingClient clients[RING_MAX_CLIENTS];
+  ShmRingSlot slots[0];
+};
 
 struct _ShmPipe
 {
@@ -132,12 +198,36 @@ struct _ShmPipe
   ShmClient *clients;
 
   mode_t perms;
+
+  ShmRing *ring;
+  size_t ring_len;
+  int ring_fd;
+  /* The fd this side is woken up on, and for a client the one of the
+   * server */
+  int ring_wakefd;
+  int ring_peer_wakefd;
+
+  /* Client side */
+  int ring_index;
+  /* The slots read and not released yet, as slot index + 1, in an open
+   * addressing table hashed on their area and offset */
+  uint32_t *ring_held;
+  unsigned int ring_held_len;
+
+  /* Server side */
+  uint32_t ring_clients;
+  uint32_t ring_reap_seq;
+  ShmBuffer **ring_bufs;
 };
 
 struct _ShmClient
 {
   int fd;
 
+  /* -1 if the client does not use the ring */
+  int ring_index;
+  int ring_wakefd;
+
   ShmClient *next;
 };
 
@@ -170,6 +260,15 @@ struct CommandBuffer
     {
       unsigned long offset;
     } ack_buffer;
+    struct
+    {
+      uint32_t ring_seq;
+    } close_shm_area;
+    struct
+    {
+      size_t size;
+      int index;
+    } ring;
   } payload;
 };
 
@@ -178,6 +277,7 @@ static void sp_close_shm (ShmArea * area);
 static int sp_shmbuf_dec (ShmPipe * self, ShmBuffer * buf,
     ShmBuffer * prev_buf);
 static void sp_shm_area_dec (ShmPipe * self, ShmArea * area);
+static void sp_writer_ring_reap (ShmPipe * self);
 
 
 
@@ -199,6 +299,10 @@ sp_writer_create (const char *path, size_t size, mode_t perms)
 
   self->main_socket = socket (PF_UNIX, SOCK_STREAM, 0);
   self->use_count = 1;
+  self->ring_fd = -1;
+  self->ring_wakefd = -1;
+  self->ring_peer_wakefd = -1;
+  self->ring_index = -1;
 
   if (self->main_socket < 0)
     RETURN_ERROR ("Could not create socket (%d): %s\n", errno,
@@ -421,6 +525,19 @@ sp_close (ShmPipe * self)
   while (self->clients)
     sp_writer_close_client (self, self->clients);
 
+  if (self->ring_bufs)
+    spalloc_free1 (sizeof (ShmBuffer *) * self->ring->n_slots, self->ring_bufs);
+  if (self->ring_held)
+    spalloc_free1 (sizeof (uint32_t) * self->ring_held_len, self->ring_held);
+  if (self->ring)
+    munmap (self->ring, self->ring_len);
+  if (self->ring_fd >= 0)
+    close (self->ring_fd);
+  if (self->ring_wakefd >= 0)
+    close (self->ring_wakefd);
+  if (self->ring_peer_wakefd >= 0)
+    close (self->ring_peer_wakefd);
+
   sp_dec (self);
 }
 
@@ -451,6 +568,151 @@ send_command (int fd, struct CommandBuffer *cb, unsigned short int type,
   return 1;
 }
 
+static int
+send_command_with_fds (int fd, struct CommandBuffer *cb,
+    unsigned short int type, int area_id, int *fds, int n_fds)
+{
+  struct msghdr msg;
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  char control[CMSG_SPACE (sizeof (int) * RING_FDS)];
+
+  assert (n_fds <= RING_FDS);
+
+  cb->type = type;
+  cb->area_id = area_id;
+
+  memset (&msg, 0, sizeof (msg));
+  memset (control, 0, sizeof (control));
+  iov.iov_base = cb;
+  iov.iov_len = sizeof (struct CommandBuffer);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = CMSG_SPACE (sizeof (int) * n_fds);
+
+  cmsg = CMSG_FIRSTHDR (&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN (sizeof (int) * n_fds);
+  memcpy (CMSG_DATA (cmsg), fds, sizeof (int) * n_fds);
+
+  if (sendmsg (fd, &msg, MSG_NOSIGNAL) != sizeof (struct CommandBuffer))
+    return 0;
+
+  return 1;
+}
+
+static int
+sp_wakefd_new (void)
+{
+#ifdef HAVE_SYS_EVENTFD_H
+  return eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+static void
+sp_wakefd_signal (int fd)
+{
+  uint64_t one = 1;
+
+  /* Can only fail if the counter is full, the other side will wake up
+   * anyway then */
+  if (write (fd, &one, sizeof (one)) < 0)
+    return;
+}
+
+static void
+sp_wakefd_clear (int fd)
+{
+  uint64_t count;
+
+  if (read (fd, &count, sizeof (count)) < 0)
+    return;
+}
+
+/**
+ * sp_writer_enable_ring:
+ * @n_slots: Number of descriptors in the ring, rounded up to a power of 2
+ *
+ * Makes the clients that connect from now on receive the buffers through a
+ * ring in shared memory instead of the socket. Up to 32 clients can use the
+ * ring, the others still use the socket.
+ *
+ * Returns: 0 on success, -1 if the ring could not be created
+ */
+
+int
+sp_writer_enable_ring (ShmPipe * self, unsigned int n_slots)
+{
+  char tmppath[PATH_MAX];
+  ShmRing *ring;
+  unsigned int n = 1;
+  int i = 0;
+
+  if (self->ring || self->clients || n_slots == 0)
+    return -1;
+
+  while (n < n_slots)
+    n <<= 1;
+
+  self->ring_wakefd = sp_wakefd_new ();
+  if (self->ring_wakefd < 0)
+    goto error;
+
+  /* The segment is passed to the clients as a fd, so it does not need to
+   * keep its name */
+  do {
+    snprintf (tmppath, PATH_MAX, "/shmpipe.ring.%d.%5d", getpid (), i++);
+    self->ring_fd = shm_open (tmppath, O_RDWR | O_CREAT | O_EXCL, self->perms);
+  } while (self->ring_fd < 0 && errno == EEXIST);
+
+  if (self->ring_fd < 0)
+    goto error;
+
+  shm_unlink (tmppath);
+
+  self->ring_len = sizeof (ShmRing) + n * sizeof (ShmRingSlot);
+  if (ftruncate (self->ring_fd, self->ring_len))
+    goto error;
+
+  ring = mmap (NULL, self->ring_len, PROT_READ | PROT_WRITE, MAP_SHARED,
+      self->ring_fd, 0);
+  if (ring == MAP_FAILED)
+    goto error;
+
+  ring->n_slots = n;
+  self->ring = ring;
+  self->ring_bufs = spalloc_alloc (sizeof (ShmBuffer *) * n);
+  memset (self->ring_bufs, 0, sizeof (ShmBuffer *) * n);
+
+  return 0;
+
+error:
+  fprintf (stderr, "Could not create ring (%d): %s\n", errno,
+      strerror (errno));
+  if (self->ring_fd >= 0)
+    close (self->ring_fd);
+  if (self->ring_wakefd >= 0)
+    close (self->ring_wakefd);
+  self->ring_fd = -1;
+  self->ring_wakefd = -1;
+  return -1;
+}
+
+/* Asks the clients to wake up the writer when they release a buffer. Reaps
+ * again afterwards, a client may have released one before seeing the flag */
+static void
+sp_writer_ring_wait (ShmPipe * self)
+{
+  self->ring->writer_waiting = 1;
+  __sync_synchronize ();
+  sp_writer_ring_reap (self);
+}
+
 int
 sp_writer_resize (ShmPipe * self, size_t size)
 {
@@ -477,6 +739,8 @@ sp_writer_resize (ShmPipe * self, size_t size)
   for (client = self->clients; client; client = client->next) {
     struct CommandBuffer cb = { 0 };
 
+    if (self->ring)
+      cb.payload.close_shm_area.ring_seq = self->ring->write_seq;
     if (!send_command (client->fd, &cb, COMMAND_CLOSE_SHM_AREA,
             old_current->id))
       continue;
@@ -505,6 +769,13 @@ sp_writer_alloc_block (ShmPipe * self, size_t size)
   ShmAllocBlock *ablock =
       shm_alloc_space_alloc_block (self->shm_area->allocspace, size);
 
+  /* The space may be held by ring slots that have been released since the
+   * last reap */
+  if (!ablock && self->ring) {
+    sp_writer_ring_wait (self);
+    ablock = shm_alloc_space_alloc_block (self->shm_area->allocspace, size);
+  }
+
   if (!ablock)
     return NULL;
 
@@ -530,6 +801,12 @@ sp_writer_block_get_pipe (ShmBlock * block)
   return block->pipe;
 }
 
+void
+sp_writer_get_alloc_stats (ShmPipe * self, ShmAllocStats * stats)
+{
+  shm_alloc_space_get_stats (self->shm_area->allocspace, stats);
+}
+
 void
 sp_writer_free_block (ShmBlock * block)
 {
@@ -539,36 +816,113 @@ sp_writer_free_block (ShmBlock * block)
   spalloc_free (ShmBlock, block);
 }
 
-/* Returns the number of client this has successfully been sent to */
+/* Frees the buffers of the ring slots that all clients have released */
 
-int
-sp_writer_send_buf (ShmPipe * self, char *buf, size_t size)
+static void
+sp_writer_ring_reap (ShmPipe * self)
+{
+  ShmRing *ring = self->ring;
+  uint32_t seq;
+  int advance = 1;
+
+  for (seq = self->ring_reap_seq; seq != ring->write_seq; seq++) {
+    unsigned int index = seq & (ring->n_slots - 1);
+    ShmBuffer *sb = self->ring_bufs[index];
+
+    if (sb && ring->slots[index].holders == 0) {
+      self->ring_bufs[index] = NULL;
+      shm_alloc_space_block_dec (sb->ablock);
+      sp_shm_area_dec (self, sb->shm_area);
+      spalloc_free1 (sizeof (ShmBuffer), sb);
+      sb = NULL;
+    }
+
+    if (sb)
+      advance = 0;
+    else if (advance)
+      self->ring_reap_seq = seq + 1;
+  }
+
+  /* Don't let the slots be rewritten before the holders have been seen */
+  __sync_synchronize ();
+}
+
+/* Returns the number of ring clients, or -2 if the ring is full */
+
+static int
+sp_writer_ring_publish (ShmPipe * self, ShmArea * area, ShmAllocBlock * ablock,
+    unsigned long offset, size_t size)
+{
+  ShmRing *ring = self->ring;
+  uint32_t seq = ring->write_seq;
+  unsigned int index = seq & (ring->n_slots - 1);
+  ShmRingSlot *slot = &ring->slots[index];
+  ShmClient *client;
+  ShmBuffer *sb;
+  int c = 0;
+
+  sp_writer_ring_reap (self);
+  if (self->ring_bufs[index]) {
+    sp_writer_ring_wait (self);
+    if (self->ring_bufs[index])
+      return -2;
+  }
+
+  sb = spalloc_alloc (sizeof (ShmBuffer));
+  memset (sb, 0, sizeof (ShmBuffer));
+  sb->use_count = 1;
+  sb->shm_area = area;
+  sb->offset = offset;
+  sb->size = size;
+  sb->ablock = ablock;
+  sp_shm_area_inc (area);
+  shm_alloc_space_block_inc (ablock);
+  self->ring_bufs[index] = sb;
+
+  slot->seq = seq;
+  slot->area_id = area->id;
+  slot->offset = offset;
+  slot->size = size;
+  slot->holders = self->ring_clients;
+
+  /* The slot must be visible before the new write_seq, and write_seq before
+   * we look at which clients are waiting for it */
+  __sync_synchronize ();
+  ring->write_seq = seq + 1;
+  __sync_synchronize ();
+
+  for (client = self->clients; client; client = client->next) {
+    ShmRingClient *rclient;
+
+    if (client->ring_index < 0)
+      continue;
+
+    rclient = &ring->clients[client->ring_index];
+    if (rclient->waiting && __sync_lock_test_and_set (&rclient->waiting, 0))
+      sp_wakefd_signal (client->ring_wakefd);
+    c++;
+  }
+
+  return c;
+}
+
+static int
+sp_writer_send_area (ShmPipe * self, ShmArea * area, ShmAllocBlock * ablock,
+    unsigned long offset, size_t size)
 {
-  ShmArea *area = NULL;
-  unsigned long offset = 0;
   unsigned long bsize = size;
   ShmBuffer *sb;
   ShmClient *client = NULL;
-  ShmAllocBlock *ablock = NULL;
   int i = 0;
   int c = 0;
+  int ring_c = 0;
 
-  if (self->num_clients == 0)
-    return 0;
-
-  for (area = self->shm_area; area; area = area->next) {
-    if (buf >= area->shm_area_buf &&
-        buf < (area->shm_area_buf + area->shm_area_len)) {
-      offset = buf - area->shm_area_buf;
-      ablock = shm_alloc_space_block_get (area->allocspace, offset);
-      assert (ablock);
-      break;
-    }
+  if (self->ring_clients) {
+    ring_c = sp_writer_ring_publish (self, area, ablock, offset, size);
+    if (ring_c < 0 || ring_c == self->num_clients)
+      return ring_c;
   }
 
-  if (!ablock)
-    return -1;
-
   sb = spalloc_alloc (sizeof (ShmBuffer) + sizeof (int) * self->num_clients);
   memset (sb, 0, sizeof (ShmBuffer));
   memset (sb->clients, -1, sizeof (int) * self->num_clients);
@@ -580,9 +934,12 @@ sp_writer_send_buf (ShmPipe * self, char *buf, size_t size)
 
   for (client = self->clients; client; client = client->next) {
     struct CommandBuffer cb = { 0 };
+
+    if (client->ring_index >= 0)
+      continue;
     cb.payload.buffer.offset = offset;
     cb.payload.buffer.size = bsize;
-    if (!send_command (client->fd, &cb, COMMAND_NEW_BUFFER, self->shm_area->id))
+    if (!send_command (client->fd, &cb, COMMAND_NEW_BUFFER, area->id))
       continue;
     sb->clients[i++] = client->fd;
     c++;
@@ -590,7 +947,7 @@ sp_writer_send_buf (ShmPipe * self, char *buf, size_t size)
 
   if (c == 0) {
     spalloc_free1 (sizeof (ShmBuffer) + sizeof (int) * sb->num_clients, sb);
-    return 0;
+    return ring_c;
   }
 
   sp_shm_area_inc (area);
@@ -601,18 +958,115 @@ sp_writer_send_buf (ShmPipe * self, char *buf, size_t size)
   sb->next = self->buffers;
   self->buffers = sb;
 
-  return c;
+  return c + ring_c;
+}
+
+/* Returns the number of client this has successfully been sent to, -1 if
+ * the buffer is not in the shared memory and -2 if the ring is full */
+int
+sp_writer_send_buf (ShmPipe * self, char *buf, size_t size)
+{
+  ShmArea *area = NULL;
+  unsigned long offset = 0;
+  ShmAllocBlock *ablock = NULL;
+
+  if (self->num_clients == 0)
+    return 0;
+
+  for (area = self->shm_area; area; area = area->next) {
+    if (buf >= area->shm_area_buf &&
+        buf < (area->shm_area_buf + area->shm_area_len)) {
+      offset = buf - area->shm_area_buf;
+      ablock = shm_alloc_space_block_get (area->allocspace, offset);
+      assert (ablock);
+      break;
+    }
+  }
+
+  if (!ablock)
+    return -1;
+
+  return sp_writer_send_area (self, area, ablock, offset, size);
+}
+
+/* Same as sp_writer_send_buf() without looking the block up, @buf must be
+ * inside of @block */
+int
+sp_writer_send_block (ShmPipe * self, ShmBlock * block, char *buf,
+    size_t size)
+{
+  char *data = sp_writer_block_get_buf (block);
+
+  if (block->pipe != self || buf < data || buf + size > data +
+      shm_alloc_space_alloc_block_get_size (block->ablock))
+    return -1;
+
+  if (self->num_clients == 0)
+    return 0;
+
+  return sp_writer_send_area (self, block->area, block->ablock,
+      buf - block->area->shm_area_buf, size);
+}
+
+static void
+close_fds (int *fds, int n_fds)
+{
+  int i;
+
+  for (i = 0; i < n_fds; i++)
+    close (fds[i]);
 }
 
+/* Also receives up to RING_FDS fds sent with the command if @fds is not
+ * NULL, they are closed otherwise */
+
 static int
-recv_command (int fd, struct CommandBuffer *cb)
+recv_command (int fd, struct CommandBuffer *cb, int *fds, int *n_fds)
 {
+  struct msghdr msg;
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  char control[CMSG_SPACE (sizeof (int) * RING_FDS)];
   int retval;
+  int n = 0;
+
+  if (n_fds)
+    *n_fds = 0;
+
+  memset (&msg, 0, sizeof (msg));
+  iov.iov_base = cb;
+  iov.iov_len = sizeof (struct CommandBuffer);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof (control);
+
+  retval = recvmsg (fd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+  if (retval < 0)
+    return 0;
+
+  for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+    int *cfds = (int *) CMSG_DATA (cmsg);
+    int i, count;
+
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+
+    count = (cmsg->cmsg_len - CMSG_LEN (0)) / sizeof (int);
+    for (i = 0; i < count; i++) {
+      if (fds && n < RING_FDS)
+        fds[n++] = cfds[i];
+      else
+        close (cfds[i]);
+    }
+  }
 
-  retval = recv (fd, cb, sizeof (struct CommandBuffer), MSG_DONTWAIT);
   if (retval == sizeof (struct CommandBuffer)) {
+    if (n_fds)
+      *n_fds = n;
     return 1;
   } else {
+    close_fds (fds, n);
     return 0;
   }
 }
@@ -625,10 +1079,17 @@ sp_client_recv (ShmPipe * self, char **buf)
   ShmArea *area;
   struct CommandBuffer cb;
   int retval;
+  int fds[RING_FDS];
+  int n_fds;
 
-  if (!recv_command (self->main_socket, &cb))
+  if (!recv_command (self->main_socket, &cb, fds, &n_fds))
     return -1;
 
+  if (cb.type != COMMAND_NEW_RING) {
+    close_fds (fds, n_fds);
+    n_fds = 0;
+  }
+
   switch (cb.type) {
     case COMMAND_NEW_SHM_AREA:
       assert (cb.payload.new_shm_area.path_size > 0);
@@ -660,12 +1121,55 @@ sp_client_recv (ShmPipe * self, char **buf)
     case COMMAND_CLOSE_SHM_AREA:
       for (area = self->shm_area; area; area = area->next) {
         if (area->id == cb.area_id) {
-          sp_shm_area_dec (self, area);
+          /* Keep it until the descriptors before the close are read */
+          if (self->ring && (int32_t) (cb.payload.close_shm_area.ring_seq -
+                  self->ring->clients[self->ring_index].read_seq) > 0) {
+            area->closing = 1;
+            area->close_seq = cb.payload.close_shm_area.ring_seq;
+          } else {
+            sp_shm_area_dec (self, area);
+          }
           break;
         }
       }
       break;
 
+    case COMMAND_NEW_RING:
+      if (n_fds != RING_FDS || self->ring ||
+          cb.payload.ring.index < 0 ||
+          cb.payload.ring.index >= RING_MAX_CLIENTS ||
+          cb.payload.ring.size < sizeof (ShmRing)) {
+        close_fds (fds, n_fds);
+        return -5;
+      }
+
+      self->ring = mmap (NULL, cb.payload.ring.size, PROT_READ | PROT_WRITE,
+          MAP_SHARED, fds[0], 0);
+      close (fds[0]);
+      self->ring_wakefd = fds[1];
+      self->ring_peer_wakefd = fds[2];
+
+      if (self->ring == MAP_FAILED) {
+        self->ring = NULL;
+        return -6;
+      }
+
+      self->ring_len = cb.payload.ring.size;
+      self->ring_index = cb.payload.ring.index;
+
+      if (self->ring->n_slots == 0 ||
+          (self->ring->n_slots & (self->ring->n_slots - 1)) ||
+          sizeof (ShmRing) + self->ring->n_slots * sizeof (ShmRingSlot) >
+          self->ring_len)
+        return -7;
+
+      /* A client holds at most one buffer per slot, so the table is never
+       * more than half full */
+      self->ring_held_len = self->ring->n_slots * 2;
+      self->ring_held = spalloc_alloc (sizeof (uint32_t) * self->ring_held_len);
+      memset (self->ring_held, 0, sizeof (uint32_t) * self->ring_held_len);
+      break;
+
     case COMMAND_NEW_BUFFER:
       assert (buf);
       for (area = self->shm_area; area; area = area->next) {
@@ -690,7 +1194,7 @@ sp_writer_recv (ShmPipe * self, ShmClient * client)
   ShmBuffer *buf = NULL, *prev_buf = NULL;
   struct CommandBuffer cb;
 
-  if (!recv_command (client->fd, &cb))
+  if (!recv_command (client->fd, &cb, NULL, NULL))
     return -1;
 
   switch (cb.type) {
@@ -716,11 +1220,171 @@ sp_writer_recv (ShmPipe * self, ShmClient * client)
   return 0;
 }
 
+static unsigned int
+sp_client_ring_hash (ShmPipe * self, int area_id, unsigned long offset)
+{
+  uint32_t h = (uint32_t) (offset >> 6) * 2654435761U + area_id;
+
+  return (h ^ (h >> 16)) & (self->ring_held_len - 1);
+}
+
+static void
+sp_client_ring_hold (ShmPipe * self, unsigned int index)
+{
+  ShmRingSlot *slot = &self->ring->slots[index];
+  unsigned int i = sp_client_ring_hash (self, slot->area_id, slot->offset);
+
+  while (self->ring_held[i])
+    i = (i + 1) & (self->ring_held_len - 1);
+  self->ring_held[i] = index + 1;
+}
+
+/* Removes entry i, moving the following entries of the cluster back so
+ * that the lookups don't need tombstones */
+static void
+sp_client_ring_unhold (ShmPipe * self, unsigned int i)
+{
+  unsigned int mask = self->ring_held_len - 1;
+  unsigned int j = i;
+
+  for (;;) {
+    ShmRingSlot *slot;
+    unsigned int h;
+
+    j = (j + 1) & mask;
+    if (!self->ring_held[j])
+      break;
+
+    /* The entry can fill the hole if its home is not between the hole and
+     * itself */
+    slot = &self->ring->slots[self->ring_held[j] - 1];
+    h = sp_client_ring_hash (self, slot->area_id, slot->offset);
+    if (((j - h) & mask) >= ((j - i) & mask)) {
+      self->ring_held[i] = self->ring_held[j];
+      i = j;
+    }
+  }
+  self->ring_held[i] = 0;
+}
+
+static void
+sp_client_ring_close_areas (ShmPipe * self)
+{
+  uint32_t read_seq = self->ring->clients[self->ring_index].read_seq;
+  ShmArea *area, *next;
+
+  for (area = self->shm_area; area; area = next) {
+    next = area->next;
+    if (area->closing && (int32_t) (area->close_seq - read_seq) <= 0) {
+      area->closing = 0;
+      sp_shm_area_dec (self, area);
+    }
+  }
+}
+
+/**
+ * sp_client_ring_recv:
+ *
+ * Reads the next buffer from the ring without any syscall if there is one.
+ * Otherwise asks the server to signal the fd from sp_get_ring_fd(), which
+ * the client should then select() on with the socket.
+ *
+ * Returns: the size of the buffer, with @buf set, 0 if there is no buffer
+ *  (or no ring) and <0 on errors
+ */
+
+long int
+sp_client_ring_recv (ShmPipe * self, char **buf)
+{
+  ShmRing *ring = self->ring;
+  ShmRingClient *rclient;
+  ShmRingSlot *slot;
+  ShmArea *area;
+  uint32_t seq;
+
+  *buf = NULL;
+
+  if (!ring)
+    return 0;
+
+  rclient = &ring->clients[self->ring_index];
+  seq = rclient->read_seq;
+
+  if (ring->write_seq == seq) {
+    /* Clear the previous wakeup first or the fd would stay readable */
+    sp_wakefd_clear (self->ring_wakefd);
+    rclient->waiting = 1;
+    __sync_synchronize ();
+    if (ring->write_seq == seq)
+      return 0;
+    __sync_lock_test_and_set (&rclient->waiting, 0);
+  }
+
+  __sync_synchronize ();
+
+  slot = &ring->slots[seq & (ring->n_slots - 1)];
+  if (slot->seq != seq || !(slot->holders & (1U << self->ring_index)))
+    return -1;
+
+  for (area = self->shm_area; area; area = area->next) {
+    if (area->id == slot->area_id)
+      break;
+  }
+
+  /* The server announces new areas on the socket before using them, so it
+   * is already readable */
+  if (!area)
+    return 0;
+
+  if (slot->offset + slot->size > area->shm_area_len)
+    return -2;
+
+  rclient->read_seq = seq + 1;
+  sp_client_ring_hold (self, seq & (ring->n_slots - 1));
+  sp_shm_area_inc (area);
+  *buf = area->shm_area_buf + slot->offset;
+
+  sp_client_ring_close_areas (self);
+
+  return slot->size;
+}
+
+static int
+sp_client_ring_release (ShmPipe * self, int area_id, unsigned long offset)
+{
+  ShmRing *ring = self->ring;
+  uint32_t bit = 1U << self->ring_index;
+  unsigned int i;
+
+  /* The slots we hold are not rewritten, so they can be looked up by their
+   * area and offset. If the same buffer was sent again, any of its slots
+   * will do. */
+  for (i = sp_client_ring_hash (self, area_id, offset); self->ring_held[i];
+      i = (i + 1) & (self->ring_held_len - 1)) {
+    ShmRingSlot *slot = &ring->slots[self->ring_held[i] - 1];
+
+    if (slot->area_id != area_id || slot->offset != offset)
+      continue;
+
+    sp_client_ring_unhold (self, i);
+
+    if (__sync_and_and_fetch (&slot->holders, ~bit) == 0 &&
+        ring->writer_waiting &&
+        __sync_lock_test_and_set (&ring->writer_waiting, 0))
+      sp_wakefd_signal (self->ring_peer_wakefd);
+
+    return 1;
+  }
+
+  return 0;
+}
+
 int
 sp_client_recv_finish (ShmPipe * self, char *buf)
 {
   ShmArea *shm_area = NULL;
   unsigned long offset;
+  int area_id;
   struct CommandBuffer cb = { 0 };
 
   for (shm_area = self->shm_area; shm_area; shm_area = shm_area->next) {
@@ -732,9 +1396,13 @@ sp_client_recv_finish (ShmPipe * self, char *buf)
   assert (shm_area);
 
   offset = buf - shm_area->shm_area_buf;
+  area_id = shm_area->id;
 
   sp_shm_area_dec (self, shm_area);
 
+  if (self->ring)
+    return sp_client_ring_release (self, area_id, offset);
+
   cb.payload.ack_buffer.offset = offset;
   return send_command (self->main_socket, &cb, COMMAND_ACK_BUFFER,
       self->shm_area->id);
@@ -750,6 +1418,10 @@ sp_client_open (const char *path)
 
   self->main_socket = socket (PF_UNIX, SOCK_STREAM, 0);
   self->use_count = 1;
+  self->ring_fd = -1;
+  self->ring_wakefd = -1;
+  self->ring_peer_wakefd = -1;
+  self->ring_index = -1;
 
   if (self->main_socket < 0)
     goto error;
@@ -776,6 +1448,8 @@ sp_writer_accept_client (ShmPipe * self)
   int fd;
   struct CommandBuffer cb = { 0 };
   int pathlen = strlen (self->shm_area->shm_area_name) + 1;
+  int ring_index = -1;
+  int ring_wakefd = -1;
 
 
   fd = accept (self->main_socket, NULL, NULL);
@@ -798,8 +1472,42 @@ sp_writer_accept_client (ShmPipe * self)
     goto error;
   }
 
+  /* Once the ring is full, the other clients use the socket */
+  if (self->ring && ~self->ring_clients) {
+    struct CommandBuffer ringcb = { 0 };
+    int fds[RING_FDS];
+
+    for (ring_index = 0; ring_index < RING_MAX_CLIENTS; ring_index++)
+      if (!(self->ring_clients & (1U << ring_index)))
+        break;
+
+    ring_wakefd = sp_wakefd_new ();
+    if (ring_wakefd < 0) {
+      fprintf (stderr, "Creating wakeup fd failed: %s", strerror (errno));
+      goto error;
+    }
+
+    self->ring->clients[ring_index].read_seq = self->ring->write_seq;
+    self->ring->clients[ring_index].waiting = 0;
+
+    fds[0] = self->ring_fd;
+    fds[1] = ring_wakefd;
+    fds[2] = self->ring_wakefd;
+    ringcb.payload.ring.size = self->ring_len;
+    ringcb.payload.ring.index = ring_index;
+    if (!send_command_with_fds (fd, &ringcb, COMMAND_NEW_RING, 0, fds,
+            RING_FDS)) {
+      fprintf (stderr, "Sending ring failed: %s", strerror (errno));
+      goto error;
+    }
+
+    self->ring_clients |= 1U << ring_index;
+  }
+
   client = spalloc_new (ShmClient);
   client->fd = fd;
+  client->ring_index = ring_index;
+  client->ring_wakefd = ring_wakefd;
 
   /* Prepend ot linked list */
   client->next = self->clients;
@@ -809,6 +1517,8 @@ sp_writer_accept_client (ShmPipe * self)
   return client;
 
 error:
+  if (ring_wakefd >= 0)
+    close (ring_wakefd);
   close (fd);
   return NULL;
 }
@@ -842,7 +1552,19 @@ sp_writer_close_client (ShmPipe * self, ShmClient * client)
 
   close (client->fd);
 
+  if (client->ring_index >= 0) {
+    uint32_t bit = 1U << client->ring_index;
+    unsigned int i;
+
+    for (i = 0; i < self->ring->n_slots; i++)
+      __sync_fetch_and_and (&self->ring->slots[i].holders, ~bit);
+    self->ring_clients &= ~bit;
+    close (client->ring_wakefd);
+    sp_writer_ring_reap (self);
+  }
+
 again:
+  prev_buf = NULL;
   for (buffer = self->buffers; buffer; buffer = buffer->next) {
     int i;
 
@@ -853,8 +1575,8 @@ again:
           goto again;
         break;
       }
-      prev_buf = buffer;
     }
+    prev_buf = buffer;
   }
 
   for (item = self->clients; item; item = item->next) {
@@ -880,18 +1602,55 @@ sp_get_fd (ShmPipe * self)
   return self->main_socket;
 }
 
+/* The fd to select() on to be woken up by the other side of the ring, -1 if
+ * there is no ring */
+
+int
+sp_get_ring_fd (ShmPipe * self)
+{
+  return self->ring ? self->ring_wakefd : -1;
+}
+
 int
 sp_writer_get_client_fd (ShmClient * client)
 {
   return client->fd;
 }
 
+/* With a ring, this also asks the clients to signal the ring fd when they
+ * release a buffer */
+
 int
 sp_writer_pending_writes (ShmPipe * self)
 {
+  if (self->ring) {
+    sp_writer_ring_wait (self);
+    if (self->ring_reap_seq != self->ring->write_seq)
+      return 1;
+  }
+
   return (self->buffers != NULL);
 }
 
+/**
+ * sp_writer_ring_recv:
+ *
+ * To be called when the fd from sp_get_ring_fd() is readable, frees the
+ * buffers the clients have released.
+ */
+
+int
+sp_writer_ring_recv (ShmPipe * self)
+{
+  if (!self->ring)
+    return -1;
+
+  sp_wakefd_clear (self->ring_wakefd);
+  sp_writer_ring_reap (self);
+
+  return 0;
+}
+
 const char *
 sp_writer_get_path (ShmPipe * pipe)
 {
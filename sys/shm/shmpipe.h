@@ -52,6 +52,17 @@
  * message and <0 if there was an error. If there was an error, one must close
  * it with sp_close(). If was valid buffer was received, the client must release
  * it with sp_client_recv_finish() when it is done reading from it.
+ *
+ * The writer can call sp_writer_enable_ring() before any client connects,
+ * then the buffers are passed to the clients through a ring in shared memory
+ * instead of the socket, which needs no syscall as long as the clients keep
+ * up. sp_writer_send_buf() returns -2 if the ring is full.
+ * The writer then also selects() on the fd from sp_get_ring_fd() and calls
+ * sp_writer_ring_recv() when it is readable, the clients tell it when they
+ * release buffers it is waiting for.
+ * The clients call sp_client_ring_recv() before select()ing, and add the fd
+ * from sp_get_ring_fd() once it is valid. It is signalled when a buffer is
+ * available after sp_client_ring_recv() has returned no buffer.
  */
 
 
@@ -63,6 +74,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 
+#include "shmalloc.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -82,23 +94,31 @@ int sp_writer_setperms_shm (ShmPipe * self, mode_t perms);
 int sp_writer_resize (ShmPipe * self, size_t size);
 
 int sp_get_fd (ShmPipe * self);
+int sp_get_ring_fd (ShmPipe * self);
 int sp_writer_get_client_fd (ShmClient * client);
 
 ShmBlock *sp_writer_alloc_block (ShmPipe * self, size_t size);
 void sp_writer_free_block (ShmBlock *block);
 int sp_writer_send_buf (ShmPipe * self, char *buf, size_t size);
+int sp_writer_send_block (ShmPipe * self, ShmBlock * block, char *buf,
+    size_t size);
 char *sp_writer_block_get_buf (ShmBlock *block);
 ShmPipe *sp_writer_block_get_pipe (ShmBlock *block);
+void sp_writer_get_alloc_stats (ShmPipe * self, ShmAllocStats * stats);
 
 ShmClient * sp_writer_accept_client (ShmPipe * self);
 void sp_writer_close_client (ShmPipe *self, ShmClient * client);
 int sp_writer_recv (ShmPipe * self, ShmClient * client);
 
+int sp_writer_enable_ring (ShmPipe * self, unsigned int n_slots);
+int sp_writer_ring_recv (ShmPipe * self);
+
 int sp_writer_pending_writes (ShmPipe * self);
 
 ShmPipe *sp_client_open (const char *path);
 long int sp_client_recv (ShmPipe * self, char **buf);
 int sp_client_recv_finish (ShmPipe * self, char *buf);
+long int sp_client_ring_recv (ShmPipe * self, char **buf);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,322 @@
+/* GStreamer
+ *
+ * unit test for audioringbuffer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+/* For ease of programming we use globals to keep refs for our floating
+ * src and sink pads we create; otherwise we always have to do get_pad,
+ * get_peer, and then remove references in every test function */
+static GstPad *mysrcpad, *mysinkpad;
+
+/* at 1000 Hz a frame lasts a millisecond: the default buffer-time of 200ms
+ * is a ring of 200 frames, the default watermarks are at 20 and 180 frames
+ * and a segment is 10 frames */
+#define RATE 1000
+#define BPF 2
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/* the test pulls from the element, so that the deadline of every read is
+ * the moment it is made and an underrun does not depend on timing */
+static GstElement *
+setup_audioringbuffer (const gchar * overrun, const gchar * underrun,
+    gint low_percent)
+{
+  GstElement *ringbuffer;
+
+  GST_DEBUG ("setup_audioringbuffer");
+  ringbuffer = gst_check_setup_element ("audioringbuffer");
+  gst_util_set_object_arg (G_OBJECT (ringbuffer), "overrun-policy", overrun);
+  gst_util_set_object_arg (G_OBJECT (ringbuffer), "underrun-policy",
+      underrun);
+  g_object_set (ringbuffer, "low-percent", low_percent, NULL);
+
+  mysrcpad = gst_check_setup_src_pad (ringbuffer, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (ringbuffer, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+
+  fail_unless (gst_element_set_state (ringbuffer,
+          GST_STATE_PAUSED) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to paused");
+  fail_unless (gst_pad_activate_pull (mysinkpad, TRUE),
+      "could not activate in pull mode");
+
+  return ringbuffer;
+}
+
+static void
+cleanup_audioringbuffer (GstElement * ringbuffer)
+{
+  GST_DEBUG ("cleanup_audioringbuffer");
+
+  gst_pad_set_active (mysinkpad, FALSE);
+  fail_unless (gst_element_set_state (ringbuffer,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_check_teardown_src_pad (ringbuffer);
+  gst_check_teardown_sink_pad (ringbuffer);
+  gst_check_teardown_element (ringbuffer);
+}
+
+/* value of the sample at position @i of the input */
+static gint16
+ramp (guint i)
+{
+  return i * 10 - 500;
+}
+
+/* pushes frames @first to @first + @frames - 1 of the ramp */
+static void
+push_frames (guint first, guint frames)
+{
+  GstBuffer *buf;
+  GstCaps *caps;
+  gint16 *data;
+  guint i;
+
+  buf = gst_buffer_new_and_alloc (frames * BPF);
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < frames; i++)
+    data[i] = ramp (first + i);
+
+  caps = gst_caps_new_simple ("audio/x-raw-int",
+      "rate", G_TYPE_INT, RATE, "channels", G_TYPE_INT, 1,
+      "endianness", G_TYPE_INT, G_BYTE_ORDER, "width", G_TYPE_INT, 16,
+      "depth", G_TYPE_INT, 16, "signed", G_TYPE_BOOLEAN, TRUE, NULL);
+  gst_buffer_set_caps (buf, caps);
+  gst_caps_unref (caps);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+}
+
+static GstBuffer *
+pull_frames (guint frames)
+{
+  GstBuffer *buf = NULL;
+
+  fail_unless_equals_int (gst_pad_pull_range (mysinkpad, 0, frames * BPF,
+          &buf), GST_FLOW_OK);
+  fail_unless (buf != NULL);
+  fail_unless_equals_int (GST_BUFFER_SIZE (buf), frames * BPF);
+
+  return buf;
+}
+
+static void
+check_counters (GstElement * ringbuffer, guint level, guint overruns,
+    guint underruns)
+{
+  guint64 level_time;
+  guint count;
+
+  g_object_get (ringbuffer, "current-level-time", &level_time, NULL);
+  fail_unless_equals_uint64 (level_time, level * GST_MSECOND);
+  g_object_get (ringbuffer, "overruns", &count, NULL);
+  fail_unless_equals_int (count, overruns);
+  g_object_get (ringbuffer, "underruns", &count, NULL);
+  fail_unless_equals_int (count, underruns);
+}
+
+/* input above the high watermark is dropped and counted */
+GST_START_TEST (test_overrun_drop)
+{
+  GstElement *ringbuffer;
+  GstBuffer *buf;
+  gint16 *data;
+  guint i;
+
+  ringbuffer = setup_audioringbuffer ("drop", "wait", 10);
+
+  push_frames (0, 150);
+  check_counters (ringbuffer, 150, 0, 0);
+
+  /* 30 frames fit below the watermark, the rest of the buffer is dropped */
+  push_frames (150, 50);
+  check_counters (ringbuffer, 180, 1, 0);
+  push_frames (200, 10);
+  check_counters (ringbuffer, 180, 2, 0);
+
+  /* what was kept comes out unchanged */
+  buf = pull_frames (180);
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < 180; i++)
+    fail_unless_equals_int (data[i], ramp (i));
+  gst_buffer_unref (buf);
+  check_counters (ringbuffer, 0, 2, 0);
+
+  cleanup_audioringbuffer (ringbuffer);
+}
+
+GST_END_TEST;
+
+/* a late read is padded with silence */
+GST_START_TEST (test_underrun_silence)
+{
+  GstElement *ringbuffer;
+  GstBuffer *buf;
+  gint16 *data;
+  guint i;
+
+  ringbuffer = setup_audioringbuffer ("block", "silence", 10);
+
+  push_frames (0, 30);
+  buf = pull_frames (20);
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < 20; i++)
+    fail_unless_equals_int (data[i], ramp (i));
+  gst_buffer_unref (buf);
+  check_counters (ringbuffer, 10, 0, 0);
+
+  /* only 10 of the 20 frames are there */
+  buf = pull_frames (20);
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < 10; i++)
+    fail_unless_equals_int (data[i], ramp (20 + i));
+  for (; i < 20; i++)
+    fail_unless_equals_int (data[i], 0);
+  gst_buffer_unref (buf);
+  check_counters (ringbuffer, 0, 0, 1);
+
+  /* the late samples are played after the silence */
+  push_frames (30, 30);
+  buf = pull_frames (20);
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < 20; i++)
+    fail_unless_equals_int (data[i], ramp (30 + i));
+  gst_buffer_unref (buf);
+  check_counters (ringbuffer, 10, 0, 1);
+
+  cleanup_audioringbuffer (ringbuffer);
+}
+
+GST_END_TEST;
+
+/* above the high watermark a segment takes 1% more input, when the ring is
+ * full the input is dropped */
+GST_START_TEST (test_overrun_stretch)
+{
+  /* frames 0 to 10 stretched over 10 frames */
+  static const gint16 expected[] = {
+    -500, -489, -478, -467, -456, -444, -433, -422, -411, -400
+  };
+  GstElement *ringbuffer;
+  GstBuffer *buf;
+  gint16 *data;
+  guint i;
+
+  ringbuffer = setup_audioringbuffer ("stretch", "wait", 10);
+
+  push_frames (0, 190);
+  push_frames (190, 20);
+  check_counters (ringbuffer, 200, 1, 0);
+
+  buf = pull_frames (10);
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < 10; i++)
+    fail_unless_equals_int (data[i], expected[i]);
+  gst_buffer_unref (buf);
+  check_counters (ringbuffer, 189, 1, 0);
+
+  gst_buffer_unref (pull_frames (10));
+  check_counters (ringbuffer, 178, 1, 0);
+
+  /* below the high watermark the segments are not stretched */
+  buf = pull_frames (10);
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < 10; i++)
+    fail_unless_equals_int (data[i], ramp (22 + i));
+  gst_buffer_unref (buf);
+  check_counters (ringbuffer, 168, 1, 0);
+
+  cleanup_audioringbuffer (ringbuffer);
+}
+
+GST_END_TEST;
+
+/* below the low watermark a segment takes 1% less input, when the ring
+ * runs empty the rest is silence */
+GST_START_TEST (test_underrun_stretch)
+{
+  /* frames 20 to 28 stretched over 10 frames */
+  static const gint16 expected[] = {
+    -300, -291, -282, -273, -264, -256, -247, -238, -229, -220
+  };
+  GstElement *ringbuffer;
+  GstBuffer *buf;
+  gint16 *data;
+  guint i;
+
+  /* a low watermark of 50 frames */
+  ringbuffer = setup_audioringbuffer ("block", "stretch", 25);
+
+  push_frames (0, 60);
+  gst_buffer_unref (pull_frames (10));
+  gst_buffer_unref (pull_frames (10));
+  check_counters (ringbuffer, 40, 0, 0);
+
+  buf = pull_frames (10);
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < 10; i++)
+    fail_unless_equals_int (data[i], expected[i]);
+  gst_buffer_unref (buf);
+  check_counters (ringbuffer, 31, 0, 0);
+
+  /* three more segments take 27 of the 31 frames, the next one is late */
+  for (i = 0; i < 3; i++)
+    gst_buffer_unref (pull_frames (10));
+  check_counters (ringbuffer, 4, 0, 0);
+  buf = pull_frames (10);
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < 4; i++)
+    fail_unless_equals_int (data[i], ramp (56 + i));
+  for (; i < 10; i++)
+    fail_unless_equals_int (data[i], 0);
+  gst_buffer_unref (buf);
+  check_counters (ringbuffer, 0, 0, 1);
+
+  cleanup_audioringbuffer (ringbuffer);
+}
+
+GST_END_TEST;
+
+static Suite *
+audioringbuffer_suite (void)
+{
+  Suite *s = suite_create ("audioringbuffer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_overrun_drop);
+  tcase_add_test (tc_chain, test_underrun_silence);
+  tcase_add_test (tc_chain, test_overrun_stretch);
+  tcase_add_test (tc_chain, test_underrun_stretch);
+
+  return s;
+}
+
+GST_CHECK_MAIN (audioringbuffer);
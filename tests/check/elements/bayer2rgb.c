@@ -0,0 +1,427 @@
+/* GStreamer
+ *
+ * unit test for bayer2rgb
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+/* For ease of programming we use globals to keep refs for our floating
+ * src and sink pads we create; otherwise we always have to do get_pad,
+ * get_peer, and then remove references in every test function */
+static GstPad *mysrcpad, *mysinkpad;
+
+#define WIDTH 64
+#define HEIGHT 48
+
+/* in the order of the element's format enum */
+static const gchar *bayer_formats[] = { "bggr", "gbrg", "grbg", "rggb" };
+
+#define BGGR 0
+
+#define BAYER_CAPS "video/x-raw-bayer, format = (string) %s, " \
+    "width = (int) 64, height = (int) 48, framerate = (fraction) 30/1"
+#define BAYER16_CAPS BAYER_CAPS ", bpp = (int) 16, depth = (int) 12, " \
+    "endianness = (int) BYTE_ORDER"
+
+static GstStaticPadTemplate rgb_sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_RGBx)
+    );
+static GstStaticPadTemplate i420_sinktemplate =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("I420"))
+    );
+static GstStaticPadTemplate nv12_sinktemplate =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_YUV ("NV12"))
+    );
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw-bayer")
+    );
+
+static GstElement *
+setup_bayer2rgb (GstStaticPadTemplate * sinktemplate, const gchar * method,
+    guint threads, const gchar * caps_str)
+{
+  GstElement *bayer2rgb;
+  GstCaps *caps;
+
+  GST_DEBUG ("setup_bayer2rgb");
+  bayer2rgb = gst_check_setup_element ("bayer2rgb");
+  gst_util_set_object_arg (G_OBJECT (bayer2rgb), "method", method);
+  g_object_set (bayer2rgb, "threads", threads, NULL);
+
+  mysrcpad = gst_check_setup_src_pad (bayer2rgb, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (bayer2rgb, sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (bayer2rgb,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string (caps_str);
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+  gst_caps_unref (caps);
+
+  return bayer2rgb;
+}
+
+static void
+cleanup_bayer2rgb (GstElement * bayer2rgb)
+{
+  GST_DEBUG ("cleanup_bayer2rgb");
+
+  gst_check_drop_buffers ();
+  fail_unless (gst_element_set_state (bayer2rgb,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (bayer2rgb);
+  gst_check_teardown_sink_pad (bayer2rgb);
+  gst_check_teardown_element (bayer2rgb);
+}
+
+/* colour of the element at x,y, the same way the element computes it */
+static gboolean
+is_green (gint format, gint x, gint y)
+{
+  return ((x ^ format ^ y ^ (format >> 1)) & 1);
+}
+
+static gboolean
+is_red (gint format, gint x, gint y)
+{
+  return !is_green (format, x, y) && ((y ^ (format >> 1)) & 1);
+}
+
+/* value of the sample at x,y; flat colour frames have R 200, G 100 and
+ * B 30, otherwise the samples are pseudo-random */
+static guint8
+get_sample (gint format, gint x, gint y, gboolean flat)
+{
+  if (!flat)
+    return (x * 37 + y * 101 + ((x * y) >> 3) * 13) & 0xff;
+
+  if (is_green (format, x, y))
+    return 100;
+  return is_red (format, x, y) ? 200 : 30;
+}
+
+/* converts a single frame and returns a copy of the output */
+static GstBuffer *
+convert_frame (GstStaticPadTemplate * sinktemplate, const gchar * method,
+    guint threads, gint format, gboolean flat, gboolean sixteen)
+{
+  GstElement *bayer2rgb;
+  GstBuffer *buf, *outbuf;
+  gchar *caps_str;
+  gint x, y;
+
+  caps_str = g_strdup_printf (sixteen ? BAYER16_CAPS : BAYER_CAPS,
+      bayer_formats[format]);
+  bayer2rgb = setup_bayer2rgb (sinktemplate, method, threads, caps_str);
+  g_free (caps_str);
+
+  if (sixteen) {
+    guint16 *data;
+
+    buf = gst_buffer_new_and_alloc (WIDTH * HEIGHT * 2);
+    data = (guint16 *) GST_BUFFER_DATA (buf);
+    for (y = 0; y < HEIGHT; y++) {
+      for (x = 0; x < WIDTH; x++)
+        data[y * WIDTH + x] =
+            (get_sample (format, x, y, flat) << 4) | (x & 0xf);
+    }
+  } else {
+    buf = gst_buffer_new_and_alloc (WIDTH * HEIGHT);
+    for (y = 0; y < HEIGHT; y++) {
+      for (x = 0; x < WIDTH; x++)
+        GST_BUFFER_DATA (buf)[y * WIDTH + x] =
+            get_sample (format, x, y, flat);
+    }
+  }
+  GST_BUFFER_TIMESTAMP (buf) = 0;
+  GST_BUFFER_DURATION (buf) = GST_SECOND / 30;
+  gst_buffer_set_caps (buf, GST_PAD_CAPS (mysrcpad));
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+
+  outbuf = gst_buffer_copy (GST_BUFFER (buffers->data));
+  cleanup_bayer2rgb (bayer2rgb);
+
+  return outbuf;
+}
+
+static void
+check_equal (GstBuffer * a, GstBuffer * b)
+{
+  fail_unless_equals_int (GST_BUFFER_SIZE (a), GST_BUFFER_SIZE (b));
+  fail_unless (memcmp (GST_BUFFER_DATA (a), GST_BUFFER_DATA (b),
+          GST_BUFFER_SIZE (a)) == 0);
+}
+
+static void
+check_flat_rgb (const gchar * method)
+{
+  GstBuffer *buf;
+  guint8 *data;
+  gint format, i;
+
+  for (format = 0; format < G_N_ELEMENTS (bayer_formats); format++) {
+    GST_DEBUG ("format %s", bayer_formats[format]);
+    buf = convert_frame (&rgb_sinktemplate, method, 1, format, TRUE, FALSE);
+    fail_unless_equals_int (GST_BUFFER_SIZE (buf), WIDTH * HEIGHT * 4);
+    data = GST_BUFFER_DATA (buf);
+    for (i = 0; i < WIDTH * HEIGHT; i++) {
+      fail_unless_equals_int (data[i * 4 + 0], 200);
+      fail_unless_equals_int (data[i * 4 + 1], 100);
+      fail_unless_equals_int (data[i * 4 + 2], 30);
+    }
+    gst_buffer_unref (buf);
+  }
+}
+
+GST_START_TEST (test_flat_bilinear)
+{
+  check_flat_rgb ("bilinear");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_flat_edge_aware)
+{
+  check_flat_rgb ("edge-aware");
+}
+
+GST_END_TEST;
+
+/* BT.601 of R 200, G 100, B 30 is Y 121, U 83, V 177; NV12 keeps U and V
+ * interleaved in a single plane */
+static void
+check_flat_yuv (GstStaticPadTemplate * sinktemplate,
+    GstVideoFormat video_format)
+{
+  GstBuffer *buf;
+  guint8 *data, *u, *v;
+  gint format, i, step;
+
+  step = video_format == GST_VIDEO_FORMAT_NV12 ? 2 : 1;
+  for (format = 0; format < G_N_ELEMENTS (bayer_formats); format++) {
+    GST_DEBUG ("format %s", bayer_formats[format]);
+    buf = convert_frame (sinktemplate, "bilinear", 1, format, TRUE, FALSE);
+    fail_unless_equals_int (GST_BUFFER_SIZE (buf),
+        gst_video_format_get_size (video_format, WIDTH, HEIGHT));
+    data = GST_BUFFER_DATA (buf);
+    u = data + gst_video_format_get_component_offset (video_format, 1,
+        WIDTH, HEIGHT);
+    v = data + gst_video_format_get_component_offset (video_format, 2,
+        WIDTH, HEIGHT);
+
+    for (i = 0; i < WIDTH * HEIGHT; i++)
+      fail_unless_equals_int (data[i], 121);
+    for (i = 0; i < WIDTH * HEIGHT / 4; i++) {
+      fail_unless_equals_int (u[i * step], 83);
+      fail_unless_equals_int (v[i * step], 177);
+    }
+    gst_buffer_unref (buf);
+  }
+}
+
+GST_START_TEST (test_flat_i420)
+{
+  check_flat_yuv (&i420_sinktemplate, GST_VIDEO_FORMAT_I420);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_flat_nv12)
+{
+  check_flat_yuv (&nv12_sinktemplate, GST_VIDEO_FORMAT_NV12);
+}
+
+GST_END_TEST;
+
+/* The bilinear method as it was before the Orc rewrite, for the elements
+ * that are not on the border of the frame (the old code used averages of
+ * three neighbours there where the rewrite mirrors the frame).  Green on
+ * red and blue elements used to be the average of the vertical or of the
+ * horizontal neighbours, whichever differ less; both averages are returned
+ * in @g_v and @g_h. */
+static void
+reference_bilinear (gint format, gint x, gint y, guint8 * rgb, gint * g_v,
+    gint * g_h)
+{
+  gint c, v1, v2, h1, h2, a1, a2, diag;
+
+  c = get_sample (format, x, y, FALSE);
+  v1 = get_sample (format, x, y + 1, FALSE);
+  v2 = get_sample (format, x, y - 1, FALSE);
+  h1 = get_sample (format, x + 1, y, FALSE);
+  h2 = get_sample (format, x - 1, y, FALSE);
+  *g_v = (v1 + v2 + 1) / 2;
+  *g_h = (h1 + h2 + 1) / 2;
+
+  if (is_green (format, x, y)) {
+    rgb[1] = c;
+    if ((y ^ (format >> 1)) & 1) {
+      rgb[0] = *g_h;
+      rgb[2] = *g_v;
+    } else {
+      rgb[0] = *g_v;
+      rgb[2] = *g_h;
+    }
+    return;
+  }
+
+  diag = (get_sample (format, x - 1, y - 1, FALSE) +
+      get_sample (format, x + 1, y - 1, FALSE) +
+      get_sample (format, x - 1, y + 1, FALSE) +
+      get_sample (format, x + 1, y + 1, FALSE) + 2) / 4;
+  a1 = ABS (v1 - v2);
+  a2 = ABS (h1 - h2);
+  if (a1 < a2)
+    rgb[1] = *g_v;
+  else if (a1 > a2)
+    rgb[1] = *g_h;
+  else
+    rgb[1] = (v1 + h1 + v2 + h2 + 2) / 4;
+  if (is_red (format, x, y)) {
+    rgb[0] = c;
+    rgb[2] = diag;
+  } else {
+    rgb[0] = diag;
+    rgb[2] = c;
+  }
+}
+
+/* The rewrite averages in two steps, which may round the diagonal
+ * neighbours of red and blue elements one higher, and on red and blue
+ * elements it blends the vertical and horizontal green averages instead of
+ * picking one, so there green must lie between the two.  Everything else
+ * is the same as before. */
+GST_START_TEST (test_bilinear_reference)
+{
+  GstBuffer *buf;
+  guint8 *data, ref[3];
+  gint format, x, y, c, g_v, g_h;
+
+  for (format = 0; format < G_N_ELEMENTS (bayer_formats); format++) {
+    buf = convert_frame (&rgb_sinktemplate, "bilinear", 1, format, FALSE,
+        FALSE);
+    data = GST_BUFFER_DATA (buf);
+
+    for (y = 1; y < HEIGHT - 1; y++) {
+      for (x = 1; x < WIDTH - 1; x++) {
+        guint8 *pixel = data + (y * WIDTH + x) * 4;
+
+        reference_bilinear (format, x, y, ref, &g_v, &g_h);
+        if (is_green (format, x, y)) {
+          for (c = 0; c < 3; c++)
+            fail_unless (pixel[c] == ref[c], "%s %d,%d channel %d: %d != %d",
+                bayer_formats[format], x, y, c, pixel[c], ref[c]);
+          continue;
+        }
+
+        c = is_red (format, x, y) ? 0 : 2;
+        fail_unless (pixel[c] == ref[c], "%s %d,%d: %d != %d",
+            bayer_formats[format], x, y, pixel[c], ref[c]);
+        c = 2 - c;
+        fail_unless (pixel[c] == ref[c] || pixel[c] == ref[c] + 1,
+            "%s %d,%d diagonal: %d, expected %d", bayer_formats[format], x, y,
+            pixel[c], ref[c]);
+        fail_unless (pixel[1] >= MIN (g_v, g_h) && pixel[1] <= MAX (g_v, g_h),
+            "%s %d,%d green: %d not between %d and %d",
+            bayer_formats[format], x, y, pixel[1], g_v, g_h);
+      }
+    }
+    gst_buffer_unref (buf);
+  }
+}
+
+GST_END_TEST;
+
+static void
+check_threads (GstStaticPadTemplate * sinktemplate, const gchar * method)
+{
+  GstBuffer *single, *multi;
+
+  single = convert_frame (sinktemplate, method, 1, BGGR, FALSE, FALSE);
+  multi = convert_frame (sinktemplate, method, 4, BGGR, FALSE, FALSE);
+  check_equal (single, multi);
+  gst_buffer_unref (single);
+  gst_buffer_unref (multi);
+}
+
+GST_START_TEST (test_threads)
+{
+  /* splitting the frame into slices must not change the output */
+  check_threads (&rgb_sinktemplate, "bilinear");
+  check_threads (&rgb_sinktemplate, "edge-aware");
+  check_threads (&i420_sinktemplate, "bilinear");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_16bit)
+{
+  GstBuffer *eight, *sixteen;
+
+  /* the bits below the 8 most significant ones are dropped */
+  eight = convert_frame (&rgb_sinktemplate, "bilinear", 1, BGGR, FALSE,
+      FALSE);
+  sixteen = convert_frame (&rgb_sinktemplate, "bilinear", 1, BGGR, FALSE,
+      TRUE);
+  check_equal (eight, sixteen);
+  gst_buffer_unref (eight);
+  gst_buffer_unref (sixteen);
+}
+
+GST_END_TEST;
+
+static Suite *
+bayer2rgb_suite (void)
+{
+  Suite *s = suite_create ("bayer2rgb");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_flat_bilinear);
+  tcase_add_test (tc_chain, test_flat_edge_aware);
+  tcase_add_test (tc_chain, test_flat_i420);
+  tcase_add_test (tc_chain, test_flat_nv12);
+  tcase_add_test (tc_chain, test_bilinear_reference);
+  tcase_add_test (tc_chain, test_threads);
+  tcase_add_test (tc_chain, test_16bit);
+
+  return s;
+}
+
+GST_CHECK_MAIN (bayer2rgb);
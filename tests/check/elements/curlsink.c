@@ -0,0 +1,736 @@
+/* GStreamer
+ *
+ * unit test for curlsink
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#define BUFFER_SIZE 10000
+
+static GstPad *mysrcpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/* a local stand-in for a HTTP server taking uploads, the completed ones are
+ * recorded in the order in which their bodies were received */
+typedef struct
+{
+  gchar *file_name;
+  gchar *content_type;
+  gboolean chunked;
+  GByteArray *body;
+} Upload;
+
+typedef struct
+{
+  gint fd;
+  gchar buf[4096];
+  gsize have;
+} Connection;
+
+static gint server_fd = -1;
+static guint server_port;
+static GThread *server_thread;
+static GMutex *server_lock;
+static GCond *server_cond;
+static GList *conn_threads;
+static guint n_connections;
+static GList *uploads;
+/* the responses are held back while this is set */
+static gboolean hold_responses;
+/* requests whose body was received but not answered yet */
+static guint n_pending;
+static guint max_pending;
+
+static gboolean
+write_all (gint fd, const gchar * data, gsize len)
+{
+  while (len > 0) {
+    gssize ret = write (fd, data, len);
+
+    if (ret <= 0)
+      return FALSE;
+    data += ret;
+    len -= ret;
+  }
+  return TRUE;
+}
+
+static gboolean
+conn_fill (Connection * conn)
+{
+  gssize ret;
+
+  if (conn->have == sizeof (conn->buf))
+    return FALSE;
+  ret = read (conn->fd, conn->buf + conn->have, sizeof (conn->buf) -
+      conn->have);
+  if (ret <= 0)
+    return FALSE;
+  conn->have += ret;
+  return TRUE;
+}
+
+static void
+conn_consume (Connection * conn, gsize len)
+{
+  conn->have -= len;
+  memmove (conn->buf, conn->buf + len, conn->have);
+}
+
+/* reads up to and including @delim, returns it without @delim */
+static gchar *
+conn_read_until (Connection * conn, const gchar * delim)
+{
+  gchar *end, *ret;
+
+  while ((end = g_strstr_len (conn->buf, conn->have, delim)) == NULL) {
+    if (!conn_fill (conn))
+      return NULL;
+  }
+  ret = g_strndup (conn->buf, end - conn->buf);
+  conn_consume (conn, end - conn->buf + strlen (delim));
+  return ret;
+}
+
+static gboolean
+conn_read_body (Connection * conn, GByteArray * body, gsize len)
+{
+  while (len > 0) {
+    gsize n;
+
+    if (conn->have == 0 && !conn_fill (conn))
+      return FALSE;
+    n = MIN (len, conn->have);
+    g_byte_array_append (body, (guint8 *) conn->buf, n);
+    conn_consume (conn, n);
+    len -= n;
+  }
+  return TRUE;
+}
+
+static gboolean
+conn_read_chunked_body (Connection * conn, GByteArray * body)
+{
+  gchar *line;
+  gsize len;
+
+  do {
+    if ((line = conn_read_until (conn, "\r\n")) == NULL)
+      return FALSE;
+    len = strtoul (line, NULL, 16);
+    g_free (line);
+
+    if (len > 0 && !conn_read_body (conn, body, len))
+      return FALSE;
+
+    /* the end of the chunk, or of the body as there are no trailers */
+    if ((line = conn_read_until (conn, "\r\n")) == NULL)
+      return FALSE;
+    fail_unless_equals_string (line, "");
+    g_free (line);
+  } while (len > 0);
+
+  return TRUE;
+}
+
+static gchar *
+get_header (const gchar * headers, const gchar * name)
+{
+  gchar **lines, **line;
+  gchar *ret = NULL;
+
+  lines = g_strsplit (headers, "\r\n", -1);
+  for (line = lines; *line && ret == NULL; line++) {
+    if (g_ascii_strncasecmp (*line, name, strlen (name)) == 0 &&
+        (*line)[strlen (name)] == ':')
+      ret = g_strstrip (g_strdup (*line + strlen (name) + 1));
+  }
+  g_strfreev (lines);
+
+  return ret;
+}
+
+static gpointer
+connection_func (gpointer data)
+{
+  Connection conn = { GPOINTER_TO_INT (data), "", 0 };
+
+  while (TRUE) {
+    gchar *headers, *value, *name;
+    Upload *upload;
+    gboolean ok;
+
+    if ((headers = conn_read_until (&conn, "\r\n\r\n")) == NULL)
+      break;
+    fail_unless (g_str_has_prefix (headers, "POST "), "%s", headers);
+
+    upload = g_slice_new0 (Upload);
+    upload->body = g_byte_array_new ();
+    upload->content_type = get_header (headers, "Content-Type");
+
+    value = get_header (headers, "Content-Disposition");
+    fail_unless (value != NULL);
+    name = strstr (value, "filename=\"");
+    fail_unless (name != NULL, "%s", value);
+    name += strlen ("filename=\"");
+    upload->file_name = g_strndup (name, strcspn (name, "\""));
+    g_free (value);
+
+    value = get_header (headers, "Expect");
+    fail_unless_equals_string (value, "100-continue");
+    g_free (value);
+    if (!write_all (conn.fd, "HTTP/1.1 100 Continue\r\n\r\n",
+            strlen ("HTTP/1.1 100 Continue\r\n\r\n")))
+      break;
+
+    value = get_header (headers, "Transfer-Encoding");
+    upload->chunked = value != NULL;
+    if (upload->chunked) {
+      fail_unless_equals_string (value, "chunked");
+      ok = conn_read_chunked_body (&conn, upload->body);
+    } else {
+      gchar *length = get_header (headers, "Content-Length");
+
+      fail_unless (length != NULL, "%s", headers);
+      ok = conn_read_body (&conn, upload->body, atoi (length));
+      g_free (length);
+    }
+    g_free (value);
+    g_free (headers);
+
+    if (!ok) {
+      g_byte_array_free (upload->body, TRUE);
+      g_free (upload->file_name);
+      g_free (upload->content_type);
+      g_slice_free (Upload, upload);
+      break;
+    }
+
+    g_mutex_lock (server_lock);
+    uploads = g_list_append (uploads, upload);
+    n_pending++;
+    max_pending = MAX (max_pending, n_pending);
+    g_cond_broadcast (server_cond);
+    while (hold_responses)
+      g_cond_wait (server_cond, server_lock);
+    n_pending--;
+    g_mutex_unlock (server_lock);
+
+    if (!write_all (conn.fd, "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n",
+            strlen ("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n")))
+      break;
+  }
+
+  close (conn.fd);
+  return NULL;
+}
+
+static gpointer
+server_func (gpointer data)
+{
+  gint fd;
+
+  while ((fd = accept (server_fd, NULL, NULL)) >= 0) {
+    GThread *thread;
+
+    g_mutex_lock (server_lock);
+    n_connections++;
+    g_mutex_unlock (server_lock);
+
+    thread = g_thread_create (connection_func, GINT_TO_POINTER (fd), TRUE,
+        NULL);
+    conn_threads = g_list_prepend (conn_threads, thread);
+  }
+  return NULL;
+}
+
+static void
+start_server (void)
+{
+  struct sockaddr_in addr;
+  socklen_t len = sizeof (addr);
+
+  server_lock = g_mutex_new ();
+  server_cond = g_cond_new ();
+  hold_responses = FALSE;
+  n_connections = n_pending = max_pending = 0;
+
+  server_fd = socket (AF_INET, SOCK_STREAM, 0);
+  fail_unless (server_fd >= 0);
+
+  memset (&addr, 0, sizeof (addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+  fail_unless (bind (server_fd, (struct sockaddr *) &addr, sizeof (addr)) == 0);
+  fail_unless (listen (server_fd, 5) == 0);
+  fail_unless (getsockname (server_fd, (struct sockaddr *) &addr, &len) == 0);
+  server_port = ntohs (addr.sin_port);
+
+  server_thread = g_thread_create (server_func, NULL, TRUE, NULL);
+}
+
+static void
+stop_server (void)
+{
+  shutdown (server_fd, SHUT_RDWR);
+  close (server_fd);
+  g_thread_join (server_thread);
+
+  /* the connections were closed when the element was freed */
+  while (conn_threads) {
+    g_thread_join (conn_threads->data);
+    conn_threads = g_list_delete_link (conn_threads, conn_threads);
+  }
+
+  while (uploads) {
+    Upload *upload = uploads->data;
+
+    g_byte_array_free (upload->body, TRUE);
+    g_free (upload->file_name);
+    g_free (upload->content_type);
+    g_slice_free (Upload, upload);
+    uploads = g_list_delete_link (uploads, uploads);
+  }
+  g_cond_free (server_cond);
+  g_mutex_free (server_lock);
+}
+
+static void
+set_hold_responses (gboolean hold)
+{
+  g_mutex_lock (server_lock);
+  hold_responses = hold;
+  g_cond_broadcast (server_cond);
+  g_mutex_unlock (server_lock);
+}
+
+static void
+wait_for_pending (guint n)
+{
+  g_mutex_lock (server_lock);
+  while (n_pending < n)
+    g_cond_wait (server_cond, server_lock);
+  g_mutex_unlock (server_lock);
+}
+
+static guint8
+test_byte (guint index, guint pos)
+{
+  return (index * 31 + pos * 7 + pos / 251) & 0xff;
+}
+
+static GstBuffer *
+make_buffer (guint index)
+{
+  GstBuffer *buf;
+  guint i;
+
+  buf = gst_buffer_new_and_alloc (BUFFER_SIZE);
+  for (i = 0; i < BUFFER_SIZE; i++)
+    GST_BUFFER_DATA (buf)[i] = test_byte (index, i);
+
+  return buf;
+}
+
+/* checks that upload @n was @file_name, holding the buffers @first to
+ * @last */
+static void
+check_upload (guint n, const gchar * file_name, guint first, guint last,
+    gboolean chunked)
+{
+  Upload *upload;
+  guint i, j;
+
+  g_mutex_lock (server_lock);
+  upload = g_list_nth_data (uploads, n);
+  g_mutex_unlock (server_lock);
+
+  fail_unless (upload != NULL, "no upload %u", n);
+  fail_unless_equals_string (upload->file_name, file_name);
+  fail_unless_equals_string (upload->content_type, "application/x-test");
+  fail_unless_equals_int (upload->chunked, chunked);
+  fail_unless_equals_int (upload->body->len, (last - first + 1) * BUFFER_SIZE);
+  for (i = first; i <= last; i++) {
+    const guint8 *data = upload->body->data + (i - first) * BUFFER_SIZE;
+
+    for (j = 0; j < BUFFER_SIZE; j++)
+      fail_unless (data[j] == test_byte (i, j), "upload %u, buffer %u, "
+          "byte %u is wrong", n, i, j);
+  }
+}
+
+static GstElement *
+setup_curlsink (gboolean use_content_length, gint parallel_uploads,
+    guint max_queue_size)
+{
+  GstElement *curlsink;
+  gchar *location;
+
+  /* talk to the test server directly */
+  g_unsetenv ("http_proxy");
+
+  curlsink = gst_check_setup_element ("curlsink");
+  location = g_strdup_printf ("http://127.0.0.1:%u/upload", server_port);
+  g_object_set (curlsink, "location", location, "file-name", "file0",
+      "content-type", "application/x-test", "use-content-length",
+      use_content_length, "parallel-uploads", parallel_uploads,
+      "max-queue-size", max_queue_size, "sync", FALSE, NULL);
+  g_free (location);
+
+  mysrcpad = gst_check_setup_src_pad (curlsink, &srctemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+
+  return curlsink;
+}
+
+static void
+start_curlsink (GstElement * curlsink)
+{
+  gst_element_set_state (curlsink, GST_STATE_PLAYING);
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_new_segment (FALSE, 1.0, GST_FORMAT_TIME, 0, -1, 0)));
+}
+
+static void
+cleanup_curlsink (GstElement * curlsink)
+{
+  gst_element_set_state (curlsink, GST_STATE_NULL);
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_check_teardown_src_pad (curlsink);
+  gst_check_teardown_element (curlsink);
+}
+
+static void
+push_buffer (guint index)
+{
+  fail_unless_equals_int (gst_pad_push (mysrcpad, make_buffer (index)),
+      GST_FLOW_OK);
+}
+
+static void
+push_eos (void)
+{
+  /* returns after the transfer thread sent everything */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+}
+
+/* without the content length the buffers are streamed with chunked
+ * encoding, one request per file name */
+GST_START_TEST (test_chunked_upload)
+{
+  GstElement *curlsink;
+  guint i;
+
+  start_server ();
+  curlsink = setup_curlsink (FALSE, 1, 4 * BUFFER_SIZE);
+  start_curlsink (curlsink);
+
+  for (i = 0; i < 10; i++)
+    push_buffer (i);
+  g_object_set (curlsink, "file-name", "file1", NULL);
+  for (i = 10; i < 15; i++)
+    push_buffer (i);
+  push_eos ();
+
+  fail_unless_equals_int (g_list_length (uploads), 2);
+  check_upload (0, "file0", 0, 9, TRUE);
+  check_upload (1, "file1", 10, 14, TRUE);
+
+  cleanup_curlsink (curlsink);
+  stop_server ();
+}
+
+GST_END_TEST;
+
+/* with the content length every queued buffer is a request of its own, sent
+ * in order over the same connection */
+GST_START_TEST (test_content_length_queue)
+{
+  GstElement *curlsink;
+  guint i;
+
+  start_server ();
+  curlsink = setup_curlsink (TRUE, 1, 100 * BUFFER_SIZE);
+  start_curlsink (curlsink);
+
+  for (i = 0; i < 8; i++)
+    push_buffer (i);
+  push_eos ();
+
+  fail_unless_equals_int (g_list_length (uploads), 8);
+  for (i = 0; i < 8; i++)
+    check_upload (i, "file0", i, i, FALSE);
+  fail_unless_equals_int (n_connections, 1);
+
+  cleanup_curlsink (curlsink);
+  stop_server ();
+}
+
+GST_END_TEST;
+
+static gint pushed;
+
+static gpointer
+push_func (gpointer data)
+{
+  GstElement *curlsink = data;
+  guint i;
+
+  for (i = 0; i < 3; i++) {
+    gchar *name = g_strdup_printf ("file%u", i);
+
+    g_object_set (curlsink, "file-name", name, NULL);
+    g_free (name);
+    push_buffer (i);
+    g_atomic_int_inc (&pushed);
+  }
+
+  return NULL;
+}
+
+/* the streaming thread waits while more than max-queue-size bytes are not
+ * sent yet */
+GST_START_TEST (test_max_queue_size)
+{
+  GstElement *curlsink;
+  GThread *thread;
+
+  start_server ();
+  set_hold_responses (TRUE);
+  curlsink = setup_curlsink (TRUE, 4, 2 * BUFFER_SIZE);
+  start_curlsink (curlsink);
+
+  /* the parallel requests are only done when they were answered */
+  pushed = 0;
+  thread = g_thread_create (push_func, curlsink, TRUE, NULL);
+  wait_for_pending (3);
+  g_usleep (G_USEC_PER_SEC / 10);
+  fail_unless_equals_int (g_atomic_int_get (&pushed), 2);
+
+  set_hold_responses (FALSE);
+  g_thread_join (thread);
+  fail_unless_equals_int (pushed, 3);
+  push_eos ();
+
+  fail_unless_equals_int (g_list_length (uploads), 3);
+
+  cleanup_curlsink (curlsink);
+  stop_server ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parallel_uploads)
+{
+  GstElement *curlsink;
+  GList *walk;
+  guint i;
+
+  start_server ();
+  set_hold_responses (TRUE);
+  curlsink = setup_curlsink (TRUE, 4, 100 * BUFFER_SIZE);
+  start_curlsink (curlsink);
+
+  for (i = 0; i < 4; i++) {
+    gchar *name = g_strdup_printf ("file%u", i);
+
+    g_object_set (curlsink, "file-name", name, NULL);
+    g_free (name);
+    push_buffer (i);
+  }
+
+  /* all of them are sent at the same time over their own connections */
+  wait_for_pending (4);
+  fail_unless_equals_int (n_connections, 4);
+  set_hold_responses (FALSE);
+  push_eos ();
+
+  fail_unless_equals_int (g_list_length (uploads), 4);
+  for (walk = uploads; walk; walk = walk->next) {
+    Upload *upload = walk->data;
+
+    i = atoi (upload->file_name + strlen ("file"));
+    check_upload (g_list_position (uploads, walk), upload->file_name, i, i,
+        FALSE);
+  }
+
+  cleanup_curlsink (curlsink);
+  stop_server ();
+}
+
+GST_END_TEST;
+
+/* the uploads to the same file name are not sent in parallel, they could
+ * complete out of order */
+GST_START_TEST (test_parallel_same_file)
+{
+  GstElement *curlsink;
+  guint i;
+
+  start_server ();
+  curlsink = setup_curlsink (TRUE, 4, 100 * BUFFER_SIZE);
+  start_curlsink (curlsink);
+
+  for (i = 0; i < 6; i++)
+    push_buffer (i);
+  push_eos ();
+
+  fail_unless_equals_int (max_pending, 1);
+  fail_unless_equals_int (g_list_length (uploads), 6);
+  for (i = 0; i < 6; i++)
+    check_upload (i, "file0", i, i, FALSE);
+
+  cleanup_curlsink (curlsink);
+  stop_server ();
+}
+
+GST_END_TEST;
+
+/* keyframes at 0s, 1s, 1.5s, 3.5s and 4.5s of 12 buffers of 0.5s, cut in
+ * segments of at least 1s: the keyframe at 1.5s comes too early and the
+ * delta units after 2s can't start a segment */
+#define N_SEGMENT_BUFFERS 12
+
+static const gboolean segment_keyframes[N_SEGMENT_BUFFERS] = {
+  TRUE, FALSE, TRUE, TRUE, FALSE, FALSE, FALSE, TRUE, FALSE, TRUE, FALSE, FALSE
+};
+
+static const gchar *playlists[] = {
+  "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:1\n"
+      "#EXT-X-MEDIA-SEQUENCE:0\n"
+      "#EXTINF:1.000,\nseg000.ts\n",
+  "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:3\n"
+      "#EXT-X-MEDIA-SEQUENCE:0\n"
+      "#EXTINF:1.000,\nseg000.ts\n#EXTINF:2.500,\nseg001.ts\n",
+  /* only the last two segments are kept */
+  "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:3\n"
+      "#EXT-X-MEDIA-SEQUENCE:1\n"
+      "#EXTINF:2.500,\nseg001.ts\n#EXTINF:1.000,\nseg002.ts\n",
+  /* the end of the stream ends the last segment and the playlist */
+  "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:2\n"
+      "#EXT-X-MEDIA-SEQUENCE:2\n"
+      "#EXTINF:1.000,\nseg002.ts\n#EXTINF:1.500,\nseg003.ts\n"
+      "#EXT-X-ENDLIST\n"
+};
+
+/* the first and last buffer of every segment */
+static const guint segment_buffers[][2] = { {0, 1}, {2, 6}, {7, 8}, {9, 11} };
+
+static void
+check_playlist (guint n, const gchar * text, gboolean chunked)
+{
+  Upload *upload = g_list_nth_data (uploads, n);
+
+  fail_unless (upload != NULL, "no upload %u", n);
+  fail_unless_equals_string (upload->file_name, "live.m3u8");
+  fail_unless_equals_string (upload->content_type,
+      "application/vnd.apple.mpegurl");
+  fail_unless_equals_int (upload->chunked, chunked);
+  g_byte_array_append (upload->body, (guint8 *) "", 1);
+  fail_unless_equals_string ((gchar *) upload->body->data, text);
+}
+
+static void
+check_segments (gboolean use_content_length)
+{
+  GstElement *curlsink;
+  guint i;
+
+  start_server ();
+  curlsink = setup_curlsink (use_content_length, 1, 100 * BUFFER_SIZE);
+  g_object_set (curlsink, "segment-duration", GST_SECOND,
+      "segment-location", "seg%03u.ts", "playlist-location", "live.m3u8",
+      "playlist-length", 2, NULL);
+  start_curlsink (curlsink);
+
+  for (i = 0; i < N_SEGMENT_BUFFERS; i++) {
+    GstBuffer *buf = make_buffer (i);
+
+    GST_BUFFER_TIMESTAMP (buf) = i * GST_SECOND / 2;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 2;
+    if (!segment_keyframes[i])
+      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  }
+  push_eos ();
+
+  /* every segment is followed by the playlist listing it */
+  fail_unless_equals_int (g_list_length (uploads), 2 *
+      G_N_ELEMENTS (segment_buffers));
+  for (i = 0; i < G_N_ELEMENTS (segment_buffers); i++) {
+    gchar *name = g_strdup_printf ("seg%03u.ts", i);
+
+    check_upload (2 * i, name, segment_buffers[i][0], segment_buffers[i][1],
+        !use_content_length);
+    check_playlist (2 * i + 1, playlists[i], !use_content_length);
+    g_free (name);
+  }
+
+  cleanup_curlsink (curlsink);
+  stop_server ();
+}
+
+GST_START_TEST (test_segments_chunked)
+{
+  check_segments (FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_segments_content_length)
+{
+  check_segments (TRUE);
+}
+
+GST_END_TEST;
+
+static Suite *
+curlsink_suite (void)
+{
+  Suite *s = suite_create ("curlsink");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_set_timeout (tc_chain, 20);
+  tcase_add_test (tc_chain, test_chunked_upload);
+  tcase_add_test (tc_chain, test_content_length_queue);
+  tcase_add_test (tc_chain, test_max_queue_size);
+  tcase_add_test (tc_chain, test_parallel_uploads);
+  tcase_add_test (tc_chain, test_parallel_same_file);
+  tcase_add_test (tc_chain, test_segments_chunked);
+  tcase_add_test (tc_chain, test_segments_content_length);
+
+  return s;
+}
+
+GST_CHECK_MAIN (curlsink);
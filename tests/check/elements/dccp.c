@@ -0,0 +1,376 @@
+/* GStreamer
+ *
+ * unit test for the DCCP packet reading and writing helpers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include <gst/check/gstcheck.h>
+
+#include "gstdccp.h"
+
+#define PACKET_SIZE 1500
+
+/* The helpers only need a socket that keeps packet boundaries, so a local
+ * SOCK_SEQPACKET pair stands in for a DCCP connection. */
+static void
+setup_sockets (int sv[2])
+{
+  fail_unless (socketpair (AF_UNIX, SOCK_SEQPACKET, 0, sv) == 0);
+}
+
+static void
+cleanup_sockets (int sv[2])
+{
+  close (sv[0]);
+  close (sv[1]);
+}
+
+/* make a list of n_groups groups, each made of n_buffers buffers of size
+ * bytes, carrying a running byte counter */
+static GstBufferList *
+create_list (guint n_groups, guint n_buffers, guint size)
+{
+  GstBufferList *list;
+  GstBufferListIterator *it;
+  guint i, j, k, count = 0;
+
+  list = gst_buffer_list_new ();
+  it = gst_buffer_list_iterate (list);
+  for (i = 0; i < n_groups; i++) {
+    gst_buffer_list_iterator_add_group (it);
+    for (j = 0; j < n_buffers; j++) {
+      GstBuffer *buf = gst_buffer_new_and_alloc (size);
+
+      for (k = 0; k < size; k++)
+        GST_BUFFER_DATA (buf)[k] = count++;
+      gst_buffer_list_iterator_add (it, buf);
+    }
+  }
+  gst_buffer_list_iterator_free (it);
+
+  return list;
+}
+
+/* receive n_packets packets of the given sizes, continuing the byte
+ * counter of create_list(), and check that nothing else was sent */
+static void
+check_packets (int sock, const guint * sizes, guint n_packets)
+{
+  guint8 data[PACKET_SIZE * 2];
+  guint i, j, count = 0;
+  ssize_t len;
+
+  for (i = 0; i < n_packets; i++) {
+    len = recv (sock, data, sizeof (data), MSG_DONTWAIT);
+    fail_unless_equals_int (len, sizes[i]);
+    for (j = 0; j < len; j++)
+      fail_unless_equals_int (data[j], (guint8) count++);
+  }
+  fail_unless (recv (sock, data, sizeof (data), MSG_DONTWAIT) < 0);
+}
+
+GST_START_TEST (test_send_buffer)
+{
+  static const guint sizes[] = { PACKET_SIZE, PACKET_SIZE, 1000 };
+  GstElement *element;
+  GstDCCPStats stats;
+  GstBuffer *buf;
+  int sv[2];
+  guint i;
+
+  element = gst_element_factory_make ("fakesink", NULL);
+  setup_sockets (sv);
+  gst_dccp_stats_reset (&stats);
+
+  buf = gst_buffer_new_and_alloc (2 * PACKET_SIZE + 1000);
+  for (i = 0; i < GST_BUFFER_SIZE (buf); i++)
+    GST_BUFFER_DATA (buf)[i] = i;
+  fail_unless_equals_int (gst_dccp_send_buffer (element, buf, sv[0],
+          PACKET_SIZE, &stats), GST_FLOW_OK);
+  gst_buffer_unref (buf);
+
+  check_packets (sv[1], sizes, G_N_ELEMENTS (sizes));
+  fail_unless_equals_int (stats.packets, 3);
+  fail_unless_equals_int (stats.bytes, 2 * PACKET_SIZE + 1000);
+
+  cleanup_sockets (sv);
+  gst_object_unref (element);
+}
+
+GST_END_TEST;
+
+/* groups of 50 buffers: the third group crosses the end of the iovec array
+ * used for a batch, and must still go out as a single packet */
+GST_START_TEST (test_send_list_groups)
+{
+  guint sizes[8];
+  GstElement *element;
+  GstBufferList *list;
+  GstDCCPStats stats;
+  int sv[2];
+  guint i;
+
+  element = gst_element_factory_make ("fakesink", NULL);
+  setup_sockets (sv);
+  gst_dccp_stats_reset (&stats);
+
+  list = create_list (8, 50, 10);
+  fail_unless_equals_int (gst_dccp_send_buffer_list (element, list, sv[0],
+          PACKET_SIZE, &stats), GST_FLOW_OK);
+  gst_buffer_list_unref (list);
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++)
+    sizes[i] = 500;
+  check_packets (sv[1], sizes, G_N_ELEMENTS (sizes));
+  fail_unless_equals_int (stats.packets, 8);
+  fail_unless_equals_int (stats.bytes, 8 * 500);
+
+  cleanup_sockets (sv);
+  gst_object_unref (element);
+}
+
+GST_END_TEST;
+
+/* groups larger than the MTU are split, groups made of more buffers than
+ * fit in a batch are still sent */
+GST_START_TEST (test_send_list_large_groups)
+{
+  static const guint sizes[] = { PACKET_SIZE, 500, PACKET_SIZE, 500 };
+  GstElement *element;
+  GstBufferList *list;
+  int sv[2];
+
+  element = gst_element_factory_make ("fakesink", NULL);
+  setup_sockets (sv);
+
+  list = create_list (2, 200, 10);
+  fail_unless_equals_int (gst_dccp_send_buffer_list (element, list, sv[0],
+          PACKET_SIZE, NULL), GST_FLOW_OK);
+  gst_buffer_list_unref (list);
+
+  check_packets (sv[1], sizes, G_N_ELEMENTS (sizes));
+
+  cleanup_sockets (sv);
+  gst_object_unref (element);
+}
+
+GST_END_TEST;
+
+#ifdef HAVE_RECVMMSG
+/* send one packet per size, carrying the byte counter of create_list() */
+static void
+send_packets (int sock, const guint * sizes, guint n_packets)
+{
+  guint8 data[PACKET_SIZE * 2];
+  guint i, j, count = 0;
+
+  for (i = 0; i < n_packets; i++) {
+    for (j = 0; j < sizes[i]; j++)
+      data[j] = count++;
+    fail_unless_equals_int (send (sock, data, sizes[i], 0), sizes[i]);
+  }
+}
+
+/* read n_buffers buffers through the pool */
+static void
+read_buffers (GstElement * element, int sock, GstDCCPBufferPool * pool,
+    GstDCCPStats * stats, GstBuffer ** bufs, guint n_buffers)
+{
+  guint i;
+
+  for (i = 0; i < n_buffers; i++)
+    fail_unless_equals_int (gst_dccp_read_batch (element, sock, pool, stats,
+            &bufs[i]), GST_FLOW_OK);
+}
+
+static void
+unref_buffers (GstBuffer ** bufs, guint n_buffers)
+{
+  guint i;
+
+  for (i = 0; i < n_buffers; i++)
+    gst_buffer_unref (bufs[i]);
+}
+
+/* packets that are pending together are read with a single call, into
+ * consecutive slots of one slab */
+GST_START_TEST (test_read_batch)
+{
+  static const guint sizes[] = { 100, PACKET_SIZE, 1, 700, 1000 };
+  GstBuffer *bufs[G_N_ELEMENTS (sizes)];
+  GstDCCPBufferPool *pool;
+  GstElement *element;
+  GstDCCPStats stats;
+  int sv[2];
+  guint i, j, count = 0;
+
+  element = gst_element_factory_make ("fakesrc", NULL);
+  setup_sockets (sv);
+  gst_dccp_stats_reset (&stats);
+  pool = gst_dccp_buffer_pool_new (PACKET_SIZE);
+
+  send_packets (sv[0], sizes, G_N_ELEMENTS (sizes));
+  read_buffers (element, sv[1], pool, &stats, bufs, G_N_ELEMENTS (sizes));
+
+  fail_unless_equals_int (stats.syscalls, 1);
+  fail_unless_equals_int (stats.packets, G_N_ELEMENTS (sizes));
+  fail_unless_equals_int (stats.dropped, 0);
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    fail_unless_equals_int (GST_BUFFER_SIZE (bufs[i]), sizes[i]);
+    fail_unless (GST_BUFFER_DATA (bufs[i]) ==
+        GST_BUFFER_DATA (bufs[0]) + i * PACKET_SIZE,
+        "packet %u not in slot %u of the slab", i, i);
+    for (j = 0; j < sizes[i]; j++)
+      fail_unless_equals_int (GST_BUFFER_DATA (bufs[i])[j], (guint8) count++);
+  }
+  unref_buffers (bufs, G_N_ELEMENTS (sizes));
+
+  /* the peer going away ends the stream */
+  close (sv[0]);
+  fail_unless_equals_int (gst_dccp_read_batch (element, sv[1], pool, &stats,
+          &bufs[0]), GST_FLOW_UNEXPECTED);
+
+  gst_dccp_buffer_pool_free (pool);
+  close (sv[1]);
+  gst_object_unref (element);
+}
+
+GST_END_TEST;
+
+/* a slab is read into again once all of its packets are released, and is
+ * left to downstream while any of them is still held */
+GST_START_TEST (test_read_slab_reuse)
+{
+  static const guint sizes[] = { 500, 500 };
+  GstBuffer *bufs[DCCP_POOL_SLABS + 1][G_N_ELEMENTS (sizes)];
+  guint8 *slabs[DCCP_POOL_SLABS];
+  GstDCCPBufferPool *pool;
+  GstElement *element;
+  int sv[2];
+  guint i;
+
+  element = gst_element_factory_make ("fakesrc", NULL);
+  setup_sockets (sv);
+  pool = gst_dccp_buffer_pool_new (PACKET_SIZE);
+
+  /* fill all the slabs, holding on to their packets */
+  for (i = 0; i < DCCP_POOL_SLABS; i++) {
+    send_packets (sv[0], sizes, G_N_ELEMENTS (sizes));
+    read_buffers (element, sv[1], pool, NULL, bufs[i], G_N_ELEMENTS (sizes));
+    slabs[i] = GST_BUFFER_DATA (bufs[i][0]);
+  }
+
+  /* the first slab is released, the next batch goes into it */
+  unref_buffers (bufs[0], G_N_ELEMENTS (sizes));
+  send_packets (sv[0], sizes, G_N_ELEMENTS (sizes));
+  read_buffers (element, sv[1], pool, NULL, bufs[0], G_N_ELEMENTS (sizes));
+  fail_unless (GST_BUFFER_DATA (bufs[0][0]) == slabs[0],
+      "released slab not reused");
+
+  /* only one packet of the second slab is released, it can't be reused and
+   * the batch goes into a new slab */
+  gst_buffer_unref (bufs[1][0]);
+  send_packets (sv[0], sizes, G_N_ELEMENTS (sizes));
+  read_buffers (element, sv[1], pool, NULL, bufs[DCCP_POOL_SLABS],
+      G_N_ELEMENTS (sizes));
+  for (i = 0; i < DCCP_POOL_SLABS; i++)
+    fail_unless (GST_BUFFER_DATA (bufs[DCCP_POOL_SLABS][0]) != slabs[i],
+        "slab %u reused while its packets are held", i);
+
+  /* the packets left to downstream are still intact */
+  for (i = 0; i < GST_BUFFER_SIZE (bufs[1][1]); i++)
+    fail_unless_equals_int (GST_BUFFER_DATA (bufs[1][1])[i],
+        (guint8) (500 + i));
+
+  gst_buffer_unref (bufs[1][1]);
+  for (i = 0; i <= DCCP_POOL_SLABS; i++) {
+    if (i != 1)
+      unref_buffers (bufs[i], G_N_ELEMENTS (sizes));
+  }
+  gst_dccp_buffer_pool_free (pool);
+  cleanup_sockets (sv);
+  gst_object_unref (element);
+}
+
+GST_END_TEST;
+
+/* packets larger than the pool slots are dropped and counted, the others of
+ * the batch are still read */
+GST_START_TEST (test_read_truncated)
+{
+  static const guint sizes[] = { 100, PACKET_SIZE + 1, 200, 2 * PACKET_SIZE };
+  GstBuffer *bufs[2];
+  GstDCCPBufferPool *pool;
+  GstElement *element;
+  GstDCCPStats stats;
+  int sv[2];
+
+  element = gst_element_factory_make ("fakesrc", NULL);
+  setup_sockets (sv);
+  gst_dccp_stats_reset (&stats);
+  pool = gst_dccp_buffer_pool_new (PACKET_SIZE);
+
+  send_packets (sv[0], sizes, G_N_ELEMENTS (sizes));
+  read_buffers (element, sv[1], pool, &stats, bufs, G_N_ELEMENTS (bufs));
+
+  fail_unless_equals_int (stats.syscalls, 1);
+  fail_unless_equals_int (stats.packets, 2);
+  fail_unless_equals_int (stats.bytes, 300);
+  fail_unless_equals_int (stats.dropped, 2);
+  fail_unless_equals_int (GST_BUFFER_SIZE (bufs[0]), 100);
+  fail_unless_equals_int (GST_BUFFER_SIZE (bufs[1]), 200);
+  fail_unless_equals_int (GST_BUFFER_DATA (bufs[1])[0],
+      (guint8) (100 + PACKET_SIZE + 1));
+
+  unref_buffers (bufs, G_N_ELEMENTS (bufs));
+  gst_dccp_buffer_pool_free (pool);
+  cleanup_sockets (sv);
+  gst_object_unref (element);
+}
+
+GST_END_TEST;
+#endif
+
+static Suite *
+dccp_suite (void)
+{
+  Suite *s = suite_create ("dccp");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_send_buffer);
+  tcase_add_test (tc_chain, test_send_list_groups);
+  tcase_add_test (tc_chain, test_send_list_large_groups);
+#ifdef HAVE_RECVMMSG
+  tcase_add_test (tc_chain, test_read_batch);
+  tcase_add_test (tc_chain, test_read_slab_reuse);
+  tcase_add_test (tc_chain, test_read_truncated);
+#endif
+
+  return s;
+}
+
+GST_CHECK_MAIN (dccp);
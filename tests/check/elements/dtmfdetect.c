@@ -0,0 +1,252 @@
+/* GStreamer
+ *
+ * unit test for dtmfdetect
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <math.h>
+
+#include <gst/check/gstcheck.h>
+
+#define RATE 8000
+#define FRAMES (2 * RATE)
+
+#define CAPS_STR "audio/x-raw-int, rate = (int) 8000, channels = (int) 2, " \
+    "endianness = (int) BYTE_ORDER, width = (int) 16, depth = (int) 16, " \
+    "signed = (boolean) true"
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (CAPS_STR));
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (CAPS_STR));
+
+/* where the detector reports the tones of make_buffer(), the end of the
+ * 102 samples block that confirmed the digit */
+static const struct
+{
+  gint number;
+  gint channel;
+  gint frame;
+} expected[] = {
+  {5, 0, 1836},
+  {9, 0, 8262},
+  {11, 1, 4284}
+};
+
+static void
+add_tone (gint16 * data, gint channel, gint start, gdouble f1, gdouble f2)
+{
+  gint i;
+
+  for (i = 0; i < RATE / 10; i++) {
+    data[(start + i) * 2 + channel] =
+        6000 * sin (2 * G_PI * f1 * i / RATE) +
+        6000 * sin (2 * G_PI * f2 * i / RATE);
+  }
+}
+
+static GstBuffer *
+make_buffer (void)
+{
+  GstBuffer *buf;
+  GstCaps *caps;
+  gint16 *data;
+
+  buf = gst_buffer_new_and_alloc (FRAMES * 2 * sizeof (gint16));
+  data = (gint16 *) GST_BUFFER_DATA (buf);
+  memset (data, 0, GST_BUFFER_SIZE (buf));
+
+  /* '5' and '9' on the left channel, '#' on the right one */
+  add_tone (data, 0, RATE / 5, 770, 1336);
+  add_tone (data, 0, RATE, 852, 1477);
+  add_tone (data, 1, RATE / 2, 941, 1477);
+
+  GST_BUFFER_TIMESTAMP (buf) = GST_SECOND;
+  GST_BUFFER_DURATION (buf) = 2 * GST_SECOND;
+  caps = gst_caps_from_string (CAPS_STR);
+  gst_buffer_set_caps (buf, caps);
+  gst_caps_unref (caps);
+
+  return buf;
+}
+
+static GstElement *
+setup_dtmfdetect (GstBus * bus)
+{
+  GstElement *dtmfdetect;
+
+  dtmfdetect = gst_check_setup_element ("dtmfdetect");
+  mysrcpad = gst_check_setup_src_pad (dtmfdetect, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (dtmfdetect, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  gst_element_set_bus (dtmfdetect, bus);
+
+  fail_unless (gst_element_set_state (dtmfdetect,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  return dtmfdetect;
+}
+
+static void
+cleanup_dtmfdetect (GstElement * dtmfdetect, GstBus * bus)
+{
+  gst_bus_set_flushing (bus, TRUE);
+  gst_element_set_bus (dtmfdetect, NULL);
+  gst_object_unref (bus);
+
+  gst_check_drop_buffers ();
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (dtmfdetect);
+  gst_check_teardown_sink_pad (dtmfdetect);
+  gst_check_teardown_element (dtmfdetect);
+}
+
+GST_START_TEST (test_detect_per_channel)
+{
+  GstElement *dtmfdetect;
+  GstBus *bus;
+  GstMessage *msg;
+  const GstStructure *s;
+  GstClockTime timestamp;
+  gint i, value;
+
+  bus = gst_bus_new ();
+  dtmfdetect = setup_dtmfdetect (bus);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, make_buffer ()),
+      GST_FLOW_OK);
+
+  /* the left channel is processed first for each buffer */
+  for (i = 0; i < G_N_ELEMENTS (expected); i++) {
+    msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT);
+    fail_unless (msg != NULL);
+    s = gst_message_get_structure (msg);
+    fail_unless (gst_structure_has_name (s, "dtmf-event"));
+    fail_unless (gst_structure_get_int (s, "number", &value));
+    fail_unless_equals_int (value, expected[i].number);
+    fail_unless (gst_structure_get_int (s, "channel", &value));
+    fail_unless_equals_int (value, expected[i].channel);
+    fail_unless (gst_structure_get_uint64 (s, "timestamp", &timestamp));
+    fail_unless_equals_uint64 (timestamp, GST_SECOND +
+        gst_util_uint64_scale_int (expected[i].frame, GST_SECOND, RATE));
+    gst_message_unref (msg);
+  }
+  fail_unless (gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT) == NULL);
+
+  cleanup_dtmfdetect (dtmfdetect, bus);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_detect_batch)
+{
+  GstElement *dtmfdetect;
+  GstBus *bus;
+  GstMessage *msg;
+  const GstStructure *s;
+  const GValue *numbers, *channels, *timestamps;
+  gint i;
+
+  bus = gst_bus_new ();
+  dtmfdetect = setup_dtmfdetect (bus);
+  g_object_set (dtmfdetect, "batch-size", 100, NULL);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, make_buffer ()),
+      GST_FLOW_OK);
+  /* nothing until the batch is full or the stream ends */
+  fail_unless (gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT) == NULL);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT);
+  fail_unless (msg != NULL);
+  s = gst_message_get_structure (msg);
+  fail_unless (gst_structure_has_name (s, "dtmf-event-list"));
+  numbers = gst_structure_get_value (s, "number");
+  channels = gst_structure_get_value (s, "channel");
+  timestamps = gst_structure_get_value (s, "timestamp");
+  fail_unless (numbers != NULL && GST_VALUE_HOLDS_ARRAY (numbers));
+  fail_unless (channels != NULL && GST_VALUE_HOLDS_ARRAY (channels));
+  fail_unless (timestamps != NULL && GST_VALUE_HOLDS_ARRAY (timestamps));
+  fail_unless_equals_int (gst_value_array_get_size (numbers),
+      G_N_ELEMENTS (expected));
+  fail_unless_equals_int (gst_value_array_get_size (channels),
+      G_N_ELEMENTS (expected));
+  fail_unless_equals_int (gst_value_array_get_size (timestamps),
+      G_N_ELEMENTS (expected));
+
+  for (i = 0; i < G_N_ELEMENTS (expected); i++) {
+    fail_unless_equals_int (g_value_get_int (gst_value_array_get_value
+            (numbers, i)), expected[i].number);
+    fail_unless_equals_int (g_value_get_int (gst_value_array_get_value
+            (channels, i)), expected[i].channel);
+    fail_unless_equals_uint64 (g_value_get_uint64 (gst_value_array_get_value
+            (timestamps, i)), GST_SECOND +
+        gst_util_uint64_scale_int (expected[i].frame, GST_SECOND, RATE));
+  }
+  gst_message_unref (msg);
+  fail_unless (gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT) == NULL);
+
+  cleanup_dtmfdetect (dtmfdetect, bus);
+}
+
+GST_END_TEST;
+
+/* a buffer without caps must not reach the detector */
+GST_START_TEST (test_not_negotiated)
+{
+  GstElement *dtmfdetect;
+  GstBus *bus;
+  GstBuffer *buf;
+
+  bus = gst_bus_new ();
+  dtmfdetect = setup_dtmfdetect (bus);
+
+  buf = gst_buffer_new_and_alloc (RATE * 2 * sizeof (gint16));
+  memset (GST_BUFFER_DATA (buf), 0, GST_BUFFER_SIZE (buf));
+  fail_unless_equals_int (gst_pad_push (mysrcpad, buf),
+      GST_FLOW_NOT_NEGOTIATED);
+
+  cleanup_dtmfdetect (dtmfdetect, bus);
+}
+
+GST_END_TEST;
+
+static Suite *
+dtmfdetect_suite (void)
+{
+  Suite *s = suite_create ("dtmfdetect");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_detect_per_channel);
+  tcase_add_test (tc_chain, test_detect_batch);
+  tcase_add_test (tc_chain, test_not_negotiated);
+
+  return s;
+}
+
+GST_CHECK_MAIN (dtmfdetect);
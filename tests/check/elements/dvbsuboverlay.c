@@ -0,0 +1,401 @@
+/* GStreamer
+ *
+ * unit test for dvbsuboverlay
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+/* For ease of programming we use globals to keep refs for our floating
+ * src and sink pads we create; otherwise we always have to do get_pad,
+ * get_peer, and then remove references in every test function */
+static GstPad *myvideopad, *mytextpad, *mysinkpad;
+
+/* the page is defined for this display size, so it is not scaled */
+#define WIDTH 64
+#define HEIGHT 48
+
+#define CAPS_STR GST_VIDEO_CAPS_YUV ("{ I420, YV12, NV12, UYVY, AYUV }")
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (CAPS_STR)
+    );
+static GstStaticPadTemplate videotemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (CAPS_STR)
+    );
+static GstStaticPadTemplate texttemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("subpicture/x-dvb")
+    );
+
+/* a region of the test page, filled with one colour of its CLUT */
+typedef struct
+{
+  gint x, y, width, height;
+  guint8 clut_entry;
+} TestRegion;
+
+/* full range CLUT entries, in the order Y, Cr, Cb, transparency */
+static const guint8 test_clut[][4] = {
+  {0, 0, 0, 0},                 /* entry 0 keeps the default, transparent */
+  {180, 100, 60, 0x40},
+  {50, 200, 150, 0x00},
+  {235, 128, 128, 0xc0},
+};
+
+/* regions at odd positions and with odd sizes, that don't share chroma
+ * samples. The third one is transparent, the last one is clipped by the
+ * frame */
+static const TestRegion test_regions[] = {
+  {3, 5, 9, 7, 1},
+  {15, 14, 6, 5, 2},
+  {30, 20, 8, 8, 0},
+  {60, 43, 10, 10, 3},
+};
+
+static void
+put_segment_header (GString * page, guint8 type, guint16 length)
+{
+  g_string_append_c (page, 0x0f);
+  g_string_append_c (page, type);
+  /* page id */
+  g_string_append_c (page, 0);
+  g_string_append_c (page, 1);
+  g_string_append_c (page, length >> 8);
+  g_string_append_c (page, length & 0xff);
+}
+
+static void
+put_uint16 (GString * page, guint16 val)
+{
+  g_string_append_c (page, val >> 8);
+  g_string_append_c (page, val & 0xff);
+}
+
+/* the PES payload of a display set with the test regions */
+static GstBuffer *
+make_page (void)
+{
+  GstBuffer *buf;
+  GString *page;
+  guint i;
+
+  page = g_string_new (NULL);
+  g_string_append_c (page, 0x20);
+  g_string_append_c (page, 0x00);
+
+  /* display definition */
+  put_segment_header (page, 0x14, 5);
+  g_string_append_c (page, 0x00);
+  put_uint16 (page, WIDTH - 1);
+  put_uint16 (page, HEIGHT - 1);
+
+  /* page composition: 10 seconds timeout, acquisition point */
+  put_segment_header (page, 0x10, 2 + 6 * G_N_ELEMENTS (test_regions));
+  g_string_append_c (page, 10);
+  g_string_append_c (page, 1 << 2);
+  for (i = 0; i < G_N_ELEMENTS (test_regions); i++) {
+    g_string_append_c (page, i + 1);
+    g_string_append_c (page, 0);
+    put_uint16 (page, test_regions[i].x);
+    put_uint16 (page, test_regions[i].y);
+  }
+
+  /* CLUT 1, replacing entries of the 16 colour table */
+  put_segment_header (page, 0x12, 2 + 6 * (G_N_ELEMENTS (test_clut) - 1));
+  g_string_append_c (page, 1);
+  g_string_append_c (page, 0);
+  for (i = 1; i < G_N_ELEMENTS (test_clut); i++) {
+    g_string_append_c (page, i);
+    g_string_append_c (page, 0x40 | 0x01);
+    g_string_append_len (page, (const gchar *) test_clut[i], 4);
+  }
+
+  /* 4 bit regions without objects, filled with their background colour */
+  for (i = 0; i < G_N_ELEMENTS (test_regions); i++) {
+    put_segment_header (page, 0x11, 10);
+    g_string_append_c (page, i + 1);
+    g_string_append_c (page, 1 << 3);
+    put_uint16 (page, test_regions[i].width);
+    put_uint16 (page, test_regions[i].height);
+    g_string_append_c (page, 2 << 2);
+    g_string_append_c (page, 1);
+    g_string_append_c (page, 0);
+    g_string_append_c (page, test_regions[i].clut_entry << 4);
+  }
+
+  /* end of display set and end of PES data marker */
+  put_segment_header (page, 0x80, 0);
+  g_string_append_c (page, 0xff);
+
+  buf = gst_buffer_new_and_alloc (page->len);
+  memcpy (GST_BUFFER_DATA (buf), page->str, page->len);
+  g_string_free (page, TRUE);
+
+  return buf;
+}
+
+static GstPad *
+setup_src_pad (GstElement * element, GstStaticPadTemplate * template,
+    const gchar * sinkname)
+{
+  GstPad *srcpad, *sinkpad;
+
+  srcpad = gst_pad_new_from_static_template (template, "src");
+  fail_if (srcpad == NULL, "Could not create a srcpad");
+
+  sinkpad = gst_element_get_static_pad (element, sinkname);
+  fail_if (sinkpad == NULL, "Could not get pad %s", sinkname);
+  fail_unless (gst_pad_link (srcpad, sinkpad) == GST_PAD_LINK_OK,
+      "Could not link source and %s pads", sinkname);
+  gst_object_unref (sinkpad);
+  gst_pad_set_active (srcpad, TRUE);
+
+  return srcpad;
+}
+
+static void
+teardown_src_pad (GstElement * element, GstPad * srcpad,
+    const gchar * sinkname)
+{
+  GstPad *sinkpad;
+
+  gst_pad_set_active (srcpad, FALSE);
+  sinkpad = gst_element_get_static_pad (element, sinkname);
+  gst_pad_unlink (srcpad, sinkpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+}
+
+static GstElement *
+setup_dvbsuboverlay (GstVideoFormat format)
+{
+  GstElement *overlay;
+  GstCaps *caps;
+
+  GST_DEBUG ("setup_dvbsuboverlay");
+  overlay = gst_check_setup_element ("dvbsuboverlay");
+  myvideopad = setup_src_pad (overlay, &videotemplate, "video_sink");
+  mytextpad = setup_src_pad (overlay, &texttemplate, "text_sink");
+  mysinkpad = gst_check_setup_sink_pad (overlay, &sinktemplate, NULL);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (overlay,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_video_format_new_caps (format, WIDTH, HEIGHT, 25, 1, 1, 1);
+  fail_unless (gst_pad_set_caps (myvideopad, caps));
+  gst_caps_unref (caps);
+
+  return overlay;
+}
+
+static void
+cleanup_dvbsuboverlay (GstElement * overlay)
+{
+  GST_DEBUG ("cleanup_dvbsuboverlay");
+
+  gst_check_drop_buffers ();
+  fail_unless (gst_element_set_state (overlay,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+
+  gst_pad_set_active (mysinkpad, FALSE);
+  teardown_src_pad (overlay, myvideopad, "video_sink");
+  teardown_src_pad (overlay, mytextpad, "text_sink");
+  gst_check_teardown_sink_pad (overlay);
+  gst_check_teardown_element (overlay);
+}
+
+/* d * (255 - a) / 255 + s, rounded like the element does it */
+static guint8
+blend_sample (guint8 d, guint a, guint s)
+{
+  guint t = d * (255 - a) + 128;
+
+  t = (t + (t >> 8)) >> 8;
+
+  return MIN (t + s, 255);
+}
+
+/* blends @region onto @data one sample at a time. Subsampled chroma gets
+ * the average of the premultiplied pixels it covers, the pixels outside of
+ * the region counting as transparent */
+static void
+reference_blend (GstVideoFormat format, guint8 * data,
+    const TestRegion * region)
+{
+  const guint8 *entry = test_clut[region->clut_entry];
+  guint a = 255 - entry[3];
+  /* premultiplied Y, U, V and A */
+  guint values[4];
+  gint x0 = region->x, y0 = region->y;
+  gint x1 = MIN (region->x + region->width, WIDTH);
+  gint y1 = MIN (region->y + region->height, HEIGHT);
+  gint c;
+
+  if (region->clut_entry == 0)
+    return;
+
+  values[0] = (entry[0] * a + 127) / 255;
+  values[1] = (entry[2] * a + 127) / 255;
+  values[2] = (entry[1] * a + 127) / 255;
+  values[3] = a;
+
+  for (c = 0; c < (format == GST_VIDEO_FORMAT_AYUV ? 4 : 3); c++) {
+    gint cw = gst_video_format_get_component_width (format, c, WIDTH);
+    gint ch = gst_video_format_get_component_height (format, c, HEIGHT);
+    gint sx = WIDTH / cw, sy = HEIGHT / ch, n = sx * sy;
+    guint8 *comp = data + gst_video_format_get_component_offset (format, c,
+        WIDTH, HEIGHT);
+    gint stride = gst_video_format_get_row_stride (format, c, WIDTH);
+    gint pstride = gst_video_format_get_pixel_stride (format, c);
+    gint i, j;
+
+    for (j = 0; j < ch; j++) {
+      for (i = 0; i < cw; i++) {
+        gint k, w, h;
+        guint8 *d = comp + j * stride + i * pstride;
+
+        /* the number of covered pixels */
+        w = MIN ((i + 1) * sx, x1) - MAX (i * sx, x0);
+        h = MIN ((j + 1) * sy, y1) - MAX (j * sy, y0);
+        if (w <= 0 || h <= 0)
+          continue;
+        k = w * h;
+
+        *d = blend_sample (*d, (k * a + n / 2) / n,
+            (k * values[c] + n / 2) / n);
+      }
+    }
+  }
+}
+
+static GstBuffer *
+make_frame (GstVideoFormat format, guint frame)
+{
+  GstBuffer *buf;
+  guint size, i;
+
+  size = gst_video_format_get_size (format, WIDTH, HEIGHT);
+  buf = gst_buffer_new_and_alloc (size);
+  for (i = 0; i < size; i++)
+    GST_BUFFER_DATA (buf)[i] = i * 7 + (i >> 6) * 13 + frame * 29;
+  GST_BUFFER_TIMESTAMP (buf) = frame * GST_SECOND / 25;
+  GST_BUFFER_DURATION (buf) = GST_SECOND / 25;
+  gst_buffer_set_caps (buf, GST_PAD_CAPS (myvideopad));
+
+  return buf;
+}
+
+static void
+check_format (GstVideoFormat format)
+{
+  GstElement *overlay;
+  GstBuffer *page, *in, *expected, *out;
+  guint32 fourcc = gst_video_format_to_fourcc (format);
+  guint frame, i;
+
+  overlay = setup_dvbsuboverlay (format);
+
+  page = make_page ();
+  GST_BUFFER_TIMESTAMP (page) = 0;
+  fail_unless_equals_int (gst_pad_push (mytextpad, page), GST_FLOW_OK);
+
+  /* the second frame is blended from the page rendered for the first one */
+  for (frame = 0; frame < 2; frame++) {
+    in = make_frame (format, frame);
+    expected = gst_buffer_copy (in);
+    for (i = 0; i < G_N_ELEMENTS (test_regions); i++)
+      reference_blend (format, GST_BUFFER_DATA (expected), &test_regions[i]);
+
+    fail_unless_equals_int (gst_pad_push (myvideopad, in), GST_FLOW_OK);
+    fail_unless_equals_int (g_list_length (buffers), frame + 1);
+
+    out = GST_BUFFER (g_list_nth_data (buffers, frame));
+    fail_unless_equals_int (GST_BUFFER_SIZE (out), GST_BUFFER_SIZE (expected));
+    for (i = 0; i < GST_BUFFER_SIZE (out); i++)
+      fail_unless (GST_BUFFER_DATA (out)[i] == GST_BUFFER_DATA (expected)[i],
+          "%" GST_FOURCC_FORMAT " frame %u byte %u: %u != %u",
+          GST_FOURCC_ARGS (fourcc), frame, i, GST_BUFFER_DATA (out)[i],
+          GST_BUFFER_DATA (expected)[i]);
+    gst_buffer_unref (expected);
+  }
+
+  cleanup_dvbsuboverlay (overlay);
+}
+
+GST_START_TEST (test_blend_i420)
+{
+  check_format (GST_VIDEO_FORMAT_I420);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_blend_yv12)
+{
+  check_format (GST_VIDEO_FORMAT_YV12);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_blend_nv12)
+{
+  check_format (GST_VIDEO_FORMAT_NV12);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_blend_uyvy)
+{
+  check_format (GST_VIDEO_FORMAT_UYVY);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_blend_ayuv)
+{
+  check_format (GST_VIDEO_FORMAT_AYUV);
+}
+
+GST_END_TEST;
+
+static Suite *
+dvbsuboverlay_suite (void)
+{
+  Suite *s = suite_create ("dvbsuboverlay");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_blend_i420);
+  tcase_add_test (tc_chain, test_blend_yv12);
+  tcase_add_test (tc_chain, test_blend_nv12);
+  tcase_add_test (tc_chain, test_blend_uyvy);
+  tcase_add_test (tc_chain, test_blend_ayuv);
+
+  return s;
+}
+
+GST_CHECK_MAIN (dvbsuboverlay);
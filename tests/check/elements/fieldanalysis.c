@@ -0,0 +1,333 @@
+/* GStreamer
+ *
+ * unit test for fieldanalysis
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+/* For ease of programming we use globals to keep refs for our floating
+ * src and sink pads we create; otherwise we always have to do get_pad,
+ * get_peer, and then remove references in every test function */
+static GstPad *mysrcpad, *mysinkpad;
+
+#define VIDEO_CAPS_TEMPLATE_STRING \
+    "video/x-raw-yuv, format = (fourcc) I420"
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (VIDEO_CAPS_TEMPLATE_STRING)
+    );
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (VIDEO_CAPS_TEMPLATE_STRING)
+    );
+
+typedef enum
+{
+  MATERIAL_PROGRESSIVE,
+  MATERIAL_INTERLACED,
+  MATERIAL_TELECINE
+} Material;
+
+/* fields of the 3:2 pulldown cadence as (top, bottom) picture indices for
+ * four film frames */
+static const gint telecine_pattern[5][2] = {
+  {0, 0}, {1, 1}, {1, 2}, {2, 3}, {3, 3}
+};
+
+static GstCaps *
+make_caps (gint width, gint height)
+{
+  return gst_caps_new_simple ("video/x-raw-yuv",
+      "format", GST_TYPE_FOURCC, GST_MAKE_FOURCC ('I', '4', '2', '0'),
+      "width", G_TYPE_INT, width, "height", G_TYPE_INT, height,
+      "framerate", GST_TYPE_FRACTION, 30000, 1001, NULL);
+}
+
+static GstElement *
+setup_fieldanalysis (gint width, gint height, const gchar * frame_metric,
+    guint threads)
+{
+  GstElement *fieldanalysis;
+  GstCaps *caps;
+
+  GST_DEBUG ("setup_fieldanalysis");
+  fieldanalysis = gst_check_setup_element ("fieldanalysis");
+  gst_util_set_object_arg (G_OBJECT (fieldanalysis), "frame-metric",
+      frame_metric);
+  g_object_set (fieldanalysis, "threads", threads, NULL);
+
+  mysrcpad = gst_check_setup_src_pad (fieldanalysis, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (fieldanalysis, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (fieldanalysis,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = make_caps (width, height);
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+  gst_caps_unref (caps);
+
+  return fieldanalysis;
+}
+
+static void
+cleanup_fieldanalysis (GstElement * fieldanalysis)
+{
+  GST_DEBUG ("cleanup_fieldanalysis");
+
+  gst_check_drop_buffers ();
+  fail_unless (gst_element_set_state (fieldanalysis,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (fieldanalysis);
+  gst_check_teardown_sink_pad (fieldanalysis);
+  gst_check_teardown_element (fieldanalysis);
+}
+
+/* a smooth diagonal gradient with a bright bar moving to the right by 8
+ * samples per picture, so any two pictures woven together comb at the edges
+ * of the bar */
+static void
+fill_lines (guint8 * y, gint width, gint height, gint parity, gint picture)
+{
+  gint i, j;
+  gint bar_start = (picture * 8) % width;
+
+  for (j = parity; j < height; j += 2) {
+    guint8 *line = y + j * GST_ROUND_UP_4 (width);
+
+    for (i = 0; i < width; i++) {
+      gint d = (i - bar_start + width) % width;
+
+      line[i] = d < width / 8 ? 235 : 16 + ((i + j) * 128) / (width + height);
+    }
+  }
+}
+
+static GstBuffer *
+make_frame (gint width, gint height, gint top_picture, gint bottom_picture,
+    GstClockTime timestamp)
+{
+  GstBuffer *buf;
+  GstCaps *caps;
+  gint y_size = GST_ROUND_UP_4 (width) * GST_ROUND_UP_2 (height);
+  gint uv_size = GST_ROUND_UP_8 (width) / 2 * GST_ROUND_UP_2 (height) / 2;
+
+  buf = gst_buffer_new_and_alloc (y_size + 2 * uv_size);
+  fill_lines (GST_BUFFER_DATA (buf), width, height, 0, top_picture);
+  fill_lines (GST_BUFFER_DATA (buf), width, height, 1, bottom_picture);
+  memset (GST_BUFFER_DATA (buf) + y_size, 128, 2 * uv_size);
+
+  GST_BUFFER_TIMESTAMP (buf) = timestamp;
+  GST_BUFFER_DURATION (buf) = gst_util_uint64_scale (GST_SECOND, 1001, 30000);
+  if (top_picture <= bottom_picture)
+    GST_BUFFER_FLAG_SET (buf, GST_VIDEO_BUFFER_TFF);
+
+  caps = make_caps (width, height);
+  gst_buffer_set_caps (buf, caps);
+  gst_caps_unref (caps);
+
+  return buf;
+}
+
+static void
+push_material (Material material, gint width, gint height, gint n_frames)
+{
+  gint n;
+
+  for (n = 0; n < n_frames; n++) {
+    GstClockTime ts = gst_util_uint64_scale (n * GST_SECOND, 1001, 30000);
+    gint top, bottom;
+
+    switch (material) {
+      case MATERIAL_PROGRESSIVE:
+        top = bottom = n;
+        break;
+      case MATERIAL_INTERLACED:
+        top = 2 * n;
+        bottom = 2 * n + 1;
+        break;
+      case MATERIAL_TELECINE:
+      default:
+        top = 4 * (n / 5) + telecine_pattern[n % 5][0];
+        bottom = 4 * (n / 5) + telecine_pattern[n % 5][1];
+        break;
+    }
+
+    fail_unless_equals_int (gst_pad_push (mysrcpad, make_frame (width,
+                height, top, bottom, ts)), GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+}
+
+/* summarises the decision made for every output buffer as a character:
+ * p - progressive, i - interlaced, t - telecine */
+static gchar *
+get_decisions (void)
+{
+  GString *s = g_string_new (NULL);
+  GList *l;
+
+  for (l = buffers; l; l = l->next) {
+    GstBuffer *buf = GST_BUFFER (l->data);
+    GstStructure *st = gst_caps_get_structure (GST_BUFFER_CAPS (buf), 0);
+    gboolean interlaced = FALSE;
+    const gchar *method;
+
+    fail_unless (gst_structure_get_boolean (st, "interlaced", &interlaced));
+    method = gst_structure_get_string (st, "interlacing-method");
+    if (!interlaced)
+      g_string_append_c (s, 'p');
+    else if (method && !strcmp (method, "telecine"))
+      g_string_append_c (s, 't');
+    else
+      g_string_append_c (s, 'i');
+  }
+
+  return g_string_free (s, FALSE);
+}
+
+static gchar *
+analyse_material (Material material, const gchar * frame_metric,
+    guint threads)
+{
+  GstElement *fieldanalysis;
+  gchar *decisions;
+
+  fieldanalysis = setup_fieldanalysis (320, 240, frame_metric, threads);
+  push_material (material, 320, 240, 20);
+  fail_unless (g_list_length (buffers) > 0);
+  decisions = get_decisions ();
+  GST_INFO ("material %d, %s, %u threads: %s", material, frame_metric, threads,
+      decisions);
+  cleanup_fieldanalysis (fieldanalysis);
+
+  return decisions;
+}
+
+GST_START_TEST (test_progressive)
+{
+  gchar *decisions = analyse_material (MATERIAL_PROGRESSIVE, "5-tap", 1);
+
+  fail_unless (strchr (decisions, 'i') == NULL, "decisions: %s", decisions);
+  fail_unless (strchr (decisions, 't') == NULL, "decisions: %s", decisions);
+  g_free (decisions);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_interlaced)
+{
+  gchar *decisions = analyse_material (MATERIAL_INTERLACED, "5-tap", 1);
+
+  /* the first frame has no predecessor to be compared with */
+  fail_unless (strchr (decisions + 1, 'p') == NULL, "decisions: %s",
+      decisions);
+  fail_unless (strchr (decisions + 1, 'i') != NULL, "decisions: %s",
+      decisions);
+  g_free (decisions);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_telecine)
+{
+  gchar *decisions = analyse_material (MATERIAL_TELECINE, "5-tap", 1);
+
+  fail_unless (strchr (decisions, 't') != NULL, "decisions: %s", decisions);
+  g_free (decisions);
+}
+
+GST_END_TEST;
+
+/* the slice threaded analysis must reach the same decisions as the single
+ * threaded one for every metric and every kind of material */
+GST_START_TEST (test_threads)
+{
+  const gchar *metrics[] = { "5-tap", "windowed-comb" };
+  Material material;
+  gint m;
+
+  for (m = 0; m < G_N_ELEMENTS (metrics); m++) {
+    for (material = MATERIAL_PROGRESSIVE; material <= MATERIAL_TELECINE;
+        material++) {
+      gchar *single = analyse_material (material, metrics[m], 1);
+      gchar *multi = analyse_material (material, metrics[m], 4);
+
+      fail_unless_equals_string (single, multi);
+      g_free (single);
+      g_free (multi);
+    }
+  }
+}
+
+GST_END_TEST;
+
+/* not a pass/fail test, logs the analysis rate for 1080i material */
+GST_START_TEST (test_benchmark)
+{
+  guint threads[] = { 1, 0 };
+  gint t;
+
+  for (t = 0; t < G_N_ELEMENTS (threads); t++) {
+    GstElement *fieldanalysis;
+    GTimer *timer;
+    gdouble elapsed;
+
+    fieldanalysis = setup_fieldanalysis (1920, 1080, "windowed-comb",
+        threads[t]);
+    timer = g_timer_new ();
+    push_material (MATERIAL_TELECINE, 1920, 1080, 50);
+    elapsed = g_timer_elapsed (timer, NULL);
+    g_timer_destroy (timer);
+    GST_INFO ("%u threads: %.1f frames/s", threads[t], 50 / elapsed);
+    cleanup_fieldanalysis (fieldanalysis);
+  }
+}
+
+GST_END_TEST;
+
+static Suite *
+fieldanalysis_suite (void)
+{
+  Suite *s = suite_create ("fieldanalysis");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_set_timeout (tc_chain, 120);
+  tcase_add_test (tc_chain, test_progressive);
+  tcase_add_test (tc_chain, test_interlaced);
+  tcase_add_test (tc_chain, test_telecine);
+  tcase_add_test (tc_chain, test_threads);
+  tcase_add_test (tc_chain, test_benchmark);
+
+  return s;
+}
+
+GST_CHECK_MAIN (fieldanalysis);
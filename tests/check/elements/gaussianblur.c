@@ -0,0 +1,351 @@
+/* GStreamer
+ *
+ * unit test for gaussianblur
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+/* For ease of programming we use globals to keep refs for our floating
+ * src and sink pads we create; otherwise we always have to do get_pad,
+ * get_peer, and then remove references in every test function */
+static GstPad *mysrcpad, *mysinkpad;
+
+#define WIDTH 64
+#define HEIGHT 48
+
+#define CAPS_STR GST_VIDEO_CAPS_YUV ("{ AYUV, I420, NV12 }")
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (CAPS_STR)
+    );
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (CAPS_STR)
+    );
+
+static GstElement *
+setup_gaussianblur (GstVideoFormat format, gdouble sigma, guint threads)
+{
+  GstElement *gaussianblur;
+  GstCaps *caps;
+
+  GST_DEBUG ("setup_gaussianblur");
+  gaussianblur = gst_check_setup_element ("gaussianblur");
+  g_object_set (gaussianblur, "sigma", sigma, "threads", threads, NULL);
+
+  mysrcpad = gst_check_setup_src_pad (gaussianblur, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (gaussianblur, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (gaussianblur,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_video_format_new_caps (format, WIDTH, HEIGHT, 25, 1, 1, 1);
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+  gst_caps_unref (caps);
+
+  return gaussianblur;
+}
+
+static void
+cleanup_gaussianblur (GstElement * gaussianblur)
+{
+  GST_DEBUG ("cleanup_gaussianblur");
+
+  gst_check_drop_buffers ();
+  fail_unless (gst_element_set_state (gaussianblur,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (gaussianblur);
+  gst_check_teardown_sink_pad (gaussianblur);
+  gst_check_teardown_element (gaussianblur);
+}
+
+/* blurs @buf with a kernel of @sigma and @radius and returns a copy of the
+ * output */
+static GstBuffer *
+blur_buffer (GstVideoFormat format, gdouble sigma, guint radius,
+    guint threads, GstBuffer * buf)
+{
+  GstElement *gaussianblur;
+  GstBuffer *outbuf;
+  guint size = GST_BUFFER_SIZE (buf);
+
+  gaussianblur = setup_gaussianblur (format, sigma, threads);
+  g_object_set (gaussianblur, "radius", radius, NULL);
+
+  GST_BUFFER_TIMESTAMP (buf) = 0;
+  GST_BUFFER_DURATION (buf) = GST_SECOND / 25;
+  gst_buffer_set_caps (buf, GST_PAD_CAPS (mysrcpad));
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+
+  outbuf = gst_buffer_copy (GST_BUFFER (buffers->data));
+  fail_unless_equals_int (GST_BUFFER_SIZE (outbuf), size);
+  cleanup_gaussianblur (gaussianblur);
+
+  return outbuf;
+}
+
+/* blurs a single frame and returns a copy of the output. The frame is
+ * either filled with @value, or with a pattern if @value is negative */
+static GstBuffer *
+blur_frame (GstVideoFormat format, gdouble sigma, guint threads, gint value)
+{
+  GstBuffer *buf;
+  guint size, i;
+
+  size = gst_video_format_get_size (format, WIDTH, HEIGHT);
+  buf = gst_buffer_new_and_alloc (size);
+  for (i = 0; i < size; i++)
+    GST_BUFFER_DATA (buf)[i] = value >= 0 ? value : (i * 7 + (i >> 6) * 13);
+
+  return blur_buffer (format, sigma, 0, threads, buf);
+}
+
+/* checks that all samples of all components are @value */
+static void
+check_flat (GstVideoFormat format, GstBuffer * buf, gint value)
+{
+  gint c, x, y;
+
+  for (c = 0; c < (format == GST_VIDEO_FORMAT_AYUV ? 4 : 3); c++) {
+    guint8 *data = GST_BUFFER_DATA (buf) +
+        gst_video_format_get_component_offset (format, c, WIDTH, HEIGHT);
+    gint stride = gst_video_format_get_row_stride (format, c, WIDTH);
+    gint pixel_stride = gst_video_format_get_pixel_stride (format, c);
+
+    for (y = 0; y < gst_video_format_get_component_height (format, c, HEIGHT);
+        y++) {
+      for (x = 0; x < gst_video_format_get_component_width (format, c, WIDTH);
+          x++)
+        fail_unless_equals_int (data[y * stride + x * pixel_stride], value);
+    }
+  }
+}
+
+static void
+check_flat_sigmas (GstVideoFormat format)
+{
+  /* exact gaussian, box approximation and sharpening */
+  const gdouble sigmas[] = { 1.2, 10.0, -2.0 };
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (sigmas); i++) {
+    GstBuffer *buf = blur_frame (format, sigmas[i], 1, 100);
+
+    check_flat (format, buf, 100);
+    gst_buffer_unref (buf);
+  }
+}
+
+GST_START_TEST (test_flat_ayuv)
+{
+  check_flat_sigmas (GST_VIDEO_FORMAT_AYUV);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_flat_i420)
+{
+  check_flat_sigmas (GST_VIDEO_FORMAT_I420);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_flat_nv12)
+{
+  check_flat_sigmas (GST_VIDEO_FORMAT_NV12);
+}
+
+GST_END_TEST;
+
+static void
+check_threads (GstVideoFormat format, gdouble sigma)
+{
+  GstBuffer *single, *multi;
+
+  single = blur_frame (format, sigma, 1, -1);
+  multi = blur_frame (format, sigma, 4, -1);
+  fail_unless (memcmp (GST_BUFFER_DATA (single), GST_BUFFER_DATA (multi),
+          GST_BUFFER_SIZE (single)) == 0);
+  gst_buffer_unref (single);
+  gst_buffer_unref (multi);
+}
+
+GST_START_TEST (test_threads)
+{
+  /* splitting the frame into slices must not change the output */
+  check_threads (GST_VIDEO_FORMAT_AYUV, 1.2);
+  check_threads (GST_VIDEO_FORMAT_I420, 1.2);
+  check_threads (GST_VIDEO_FORMAT_I420, 10.0);
+  check_threads (GST_VIDEO_FORMAT_NV12, 10.0);
+}
+
+GST_END_TEST;
+
+typedef guint8 (*LumaFunc) (gint x, gint y);
+
+static guint8
+impulse (gint x, gint y)
+{
+  return (x == WIDTH / 2 && y == HEIGHT / 2) ? 255 : 0;
+}
+
+static guint8
+step_edge (gint x, gint y)
+{
+  return x < WIDTH / 2 ? 16 : 235;
+}
+
+/* the luma plane of @func blurred in double precision with a gaussian of
+ * @sigma cut at @radius, replicating the edge pixels */
+static gdouble *
+reference_blur (LumaFunc func, gdouble sigma, gint radius)
+{
+  gdouble *weights, *tmp, *ref, sum;
+  gint x, y, k;
+
+  weights = g_new (gdouble, radius + 1);
+  sum = 0;
+  for (k = 0; k <= radius; k++) {
+    weights[k] = exp (-0.5 * k * k / (sigma * sigma));
+    sum += k == 0 ? weights[k] : 2 * weights[k];
+  }
+  for (k = 0; k <= radius; k++)
+    weights[k] /= sum;
+
+  tmp = g_new0 (gdouble, WIDTH * HEIGHT);
+  ref = g_new0 (gdouble, WIDTH * HEIGHT);
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++) {
+      for (k = -radius; k <= radius; k++)
+        tmp[y * WIDTH + x] += weights[ABS (k)] *
+            func (CLAMP (x + k, 0, WIDTH - 1), y);
+    }
+  }
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++) {
+      for (k = -radius; k <= radius; k++)
+        ref[y * WIDTH + x] += weights[ABS (k)] *
+            tmp[CLAMP (y + k, 0, HEIGHT - 1) * WIDTH + x];
+    }
+  }
+
+  g_free (weights);
+  g_free (tmp);
+
+  return ref;
+}
+
+/* blurs an I420 frame with @func in the luma plane and compares the luma
+ * with a gaussian of @sigma cut at @ref_radius */
+static void
+check_luma_blur (LumaFunc func, gdouble sigma, guint radius, gint ref_radius,
+    gdouble tolerance)
+{
+  GstVideoFormat format = GST_VIDEO_FORMAT_I420;
+  GstBuffer *buf;
+  gdouble *ref;
+  gint stride, x, y;
+  guint8 *data;
+
+  buf = gst_buffer_new_and_alloc (gst_video_format_get_size (format, WIDTH,
+          HEIGHT));
+  memset (GST_BUFFER_DATA (buf), 128, GST_BUFFER_SIZE (buf));
+  stride = gst_video_format_get_row_stride (format, 0, WIDTH);
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++)
+      GST_BUFFER_DATA (buf)[y * stride + x] = func (x, y);
+  }
+
+  buf = blur_buffer (format, sigma, radius, 1, buf);
+  ref = reference_blur (func, sigma, ref_radius);
+
+  data = GST_BUFFER_DATA (buf);
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++) {
+      gdouble expected = ref[y * WIDTH + x];
+
+      fail_unless (fabs (data[y * stride + x] - expected) <= tolerance,
+          "sigma %f: %d at %d,%d, expected %f", sigma, data[y * stride + x],
+          x, y, expected);
+    }
+  }
+
+  g_free (ref);
+  gst_buffer_unref (buf);
+}
+
+GST_START_TEST (test_impulse)
+{
+  /* the default sigma, cut at 2.5 sigma */
+  check_luma_blur (impulse, 1.2, 0, 3, 1.0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_step_edge)
+{
+  check_luma_blur (step_edge, 2.0, 0, 5, 1.0);
+  /* an explicit radius uses the exact gaussian for large sigmas too */
+  check_luma_blur (step_edge, 10.0, 25, 25, 1.0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_box_approximation)
+{
+  /* the three box blurs stay within a few levels of the exact gaussian */
+  check_luma_blur (step_edge, 10.0, 0, 25, 3.0);
+  check_luma_blur (impulse, 5.0, 0, 13, 1.0);
+}
+
+GST_END_TEST;
+
+static Suite *
+gaussianblur_suite (void)
+{
+  Suite *s = suite_create ("gaussianblur");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_flat_ayuv);
+  tcase_add_test (tc_chain, test_flat_i420);
+  tcase_add_test (tc_chain, test_flat_nv12);
+  tcase_add_test (tc_chain, test_threads);
+  tcase_add_test (tc_chain, test_impulse);
+  tcase_add_test (tc_chain, test_step_edge);
+  tcase_add_test (tc_chain, test_box_approximation);
+
+  return s;
+}
+
+GST_CHECK_MAIN (gaussianblur);
@@ -0,0 +1,300 @@
+/* GStreamer
+ *
+ * unit test for interlace
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
+
+/* For ease of programming we use globals to keep refs for our floating
+ * src and sink pads we create; otherwise we always have to do get_pad,
+ * get_peer, and then remove references in every test function */
+static GstPad *mysrcpad, *mysinkpad;
+
+#define WIDTH 64
+#define HEIGHT 48
+#define FRAME_SIZE (WIDTH * HEIGHT * 3 / 2)
+#define N_FRAMES 40
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw-yuv, format = (fourcc) I420, "
+        "interlaced = (boolean) TRUE")
+    );
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw-yuv, format = (fourcc) I420, "
+        "interlaced = (boolean) FALSE")
+    );
+
+/* the input frames live in here, so that output buffers can be identified
+ * as reused input buffers by their data pointer */
+static guint8 arena[N_FRAMES][FRAME_SIZE];
+
+static GstElement *
+setup_interlace (const gchar * pattern, gboolean allow_rff)
+{
+  GstElement *interlace;
+  GstCaps *caps;
+
+  GST_DEBUG ("setup_interlace");
+  interlace = gst_check_setup_element ("interlace");
+  gst_util_set_object_arg (G_OBJECT (interlace), "field-pattern", pattern);
+  g_object_set (interlace, "top-field-first", TRUE, "allow-rff", allow_rff,
+      NULL);
+
+  mysrcpad = gst_check_setup_src_pad (interlace, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (interlace, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (interlace,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string ("video/x-raw-yuv, format = (fourcc) I420, "
+      "width = (int) 64, height = (int) 48, framerate = (fraction) 24/1, "
+      "interlaced = (boolean) FALSE");
+  fail_unless (gst_pad_set_caps (mysrcpad, caps));
+  gst_caps_unref (caps);
+
+  return interlace;
+}
+
+static void
+cleanup_interlace (GstElement * interlace)
+{
+  GST_DEBUG ("cleanup_interlace");
+
+  gst_check_drop_buffers ();
+  fail_unless (gst_element_set_state (interlace,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (interlace);
+  gst_check_teardown_sink_pad (interlace);
+  gst_check_teardown_element (interlace);
+}
+
+static void
+push_frames (void)
+{
+  gint n;
+
+  for (n = 0; n < N_FRAMES; n++) {
+    GstBuffer *buf = gst_buffer_new ();
+
+    /* every sample of frame n has the value n + 1 */
+    memset (arena[n], n + 1, FRAME_SIZE);
+    GST_BUFFER_DATA (buf) = arena[n];
+    GST_BUFFER_SIZE (buf) = FRAME_SIZE;
+    GST_BUFFER_TIMESTAMP (buf) = n * GST_SECOND / 24;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 24;
+    if (n == 0)
+      GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DISCONT);
+    gst_buffer_set_caps (buf, GST_PAD_CAPS (mysrcpad));
+
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+}
+
+/* returns the frame number the lines of the given parity were taken from */
+static gint
+get_field_source (const guint8 * data, gint parity)
+{
+  gint value = data[parity * WIDTH];
+  gint j, i;
+
+  for (j = parity; j < HEIGHT; j += 2) {
+    for (i = 0; i < WIDTH; i++)
+      fail_unless_equals_int (data[j * WIDTH + i], value);
+  }
+  /* the U and V planes together have HEIGHT lines of WIDTH / 2 */
+  data += WIDTH * HEIGHT;
+  for (j = parity; j < HEIGHT; j += 2) {
+    for (i = 0; i < WIDTH / 2; i++)
+      fail_unless_equals_int (data[j * WIDTH / 2 + i], value);
+  }
+
+  return value - 1;
+}
+
+/* checks that the output fields repeat the input frames according to the
+ * pattern, and returns the number of bytes that had to be copied */
+static guint64
+check_output (const gint * n_fields)
+{
+  GArray *fields = g_array_new (FALSE, FALSE, sizeof (gint));
+  guint64 copied = 0;
+  GList *l;
+  gint i, run, phase;
+
+  for (l = buffers; l; l = l->next) {
+    GstBuffer *buf = GST_BUFFER (l->data);
+    guint8 *data = GST_BUFFER_DATA (buf);
+    gint top, bottom, first, second;
+
+    fail_unless (GST_BUFFER_SIZE (buf) >= FRAME_SIZE);
+    top = get_field_source (data, 0);
+    bottom = get_field_source (data, 1);
+
+    if (GST_BUFFER_FLAG_IS_SET (buf, GST_VIDEO_BUFFER_TFF)) {
+      first = top;
+      second = bottom;
+    } else {
+      first = bottom;
+      second = top;
+    }
+    g_array_append_val (fields, first);
+    g_array_append_val (fields, second);
+    if (GST_BUFFER_FLAG_IS_SET (buf, GST_VIDEO_BUFFER_RFF))
+      g_array_append_val (fields, first);
+
+    if (data >= arena[0] && data < arena[N_FRAMES]) {
+      gint frame = (data - arena[0]) / FRAME_SIZE;
+
+      fail_unless ((data - arena[0]) % FRAME_SIZE == 0);
+      if (top != frame || bottom != frame)
+        copied += FRAME_SIZE / 2;
+    } else {
+      copied += FRAME_SIZE;
+    }
+  }
+
+  /* compare the length of every run of fields from the same frame with the
+   * pattern, except for the last one which may have been cut short */
+  phase = 0;
+  run = 1;
+  for (i = 1; i < fields->len; i++) {
+    gint prev = g_array_index (fields, gint, i - 1);
+    gint cur = g_array_index (fields, gint, i);
+
+    if (cur == prev) {
+      run++;
+      continue;
+    }
+    fail_unless_equals_int (cur, prev + 1);
+    fail_unless_equals_int (run, n_fields[phase]);
+    phase++;
+    if (!n_fields[phase])
+      phase = 0;
+    run = 1;
+  }
+  fail_unless (fields->len >= N_FRAMES);
+
+  g_array_free (fields, TRUE);
+
+  return copied;
+}
+
+static guint64
+run_pattern (const gchar * pattern, const gint * n_fields, gboolean allow_rff)
+{
+  GstElement *interlace;
+  guint64 copied;
+  guint n_out;
+
+  interlace = setup_interlace (pattern, allow_rff);
+  push_frames ();
+  n_out = g_list_length (buffers);
+  copied = check_output (n_fields);
+  GST_INFO ("pattern %s%s: %u output frames, %.1f bytes copied per frame "
+      "(frame size %d)", pattern, allow_rff ? " (rff)" : "", n_out,
+      (gdouble) copied / n_out, FRAME_SIZE);
+  cleanup_interlace (interlace);
+
+  return copied;
+}
+
+GST_START_TEST (test_pattern_1_1)
+{
+  const gint n_fields[] = { 1, 0 };
+
+  /* every output frame combines two input frames and one of them can be
+   * reused */
+  fail_unless_equals_int (run_pattern ("1:1", n_fields, FALSE),
+      N_FRAMES / 2 * FRAME_SIZE / 2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pattern_2_2)
+{
+  const gint n_fields[] = { 2, 0 };
+
+  fail_unless_equals_int (run_pattern ("2:2", n_fields, FALSE), 0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pattern_2_3)
+{
+  const gint n_fields[] = { 2, 3, 0 };
+  guint64 copied;
+
+  /* 5 output frames for every 4 input frames, of which at most one needs
+   * both fields copied and one only needs a single field copied */
+  copied = run_pattern ("2:3", n_fields, FALSE);
+  fail_unless (copied <= N_FRAMES / 4 * (FRAME_SIZE + FRAME_SIZE / 2));
+  run_pattern ("2:3", n_fields, TRUE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pattern_2_3_3_2)
+{
+  const gint n_fields[] = { 2, 3, 3, 2, 0 };
+
+  run_pattern ("2:3:3:2", n_fields, FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pattern_euro)
+{
+  const gint n_fields[] = { 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 0 };
+
+  run_pattern ("2-11:3", n_fields, FALSE);
+}
+
+GST_END_TEST;
+
+static Suite *
+interlace_suite (void)
+{
+  Suite *s = suite_create ("interlace");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_pattern_1_1);
+  tcase_add_test (tc_chain, test_pattern_2_2);
+  tcase_add_test (tc_chain, test_pattern_2_3);
+  tcase_add_test (tc_chain, test_pattern_2_3_3_2);
+  tcase_add_test (tc_chain, test_pattern_euro);
+
+  return s;
+}
+
+GST_CHECK_MAIN (interlace);
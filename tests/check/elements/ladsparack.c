@@ -0,0 +1,242 @@
+/* GStreamer
+ *
+ * unit test for ladsparack
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#define FRAMES 1000
+
+#define CAPS_TEMPLATE "audio/x-raw-float, rate = (int) 44100, " \
+    "channels = (int) %u, endianness = (int) BYTE_ORDER, width = (int) 32"
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/* the amp plugins of the LADSPA SDK, which most installations have */
+static gboolean
+have_amp_plugins (void)
+{
+  GstElementFactory *mono, *stereo;
+  gboolean ret;
+
+  mono = gst_element_factory_find ("ladspa-amp-mono");
+  stereo = gst_element_factory_find ("ladspa-amp-stereo");
+  ret = mono != NULL && stereo != NULL;
+  if (mono)
+    gst_object_unref (mono);
+  if (stereo)
+    gst_object_unref (stereo);
+
+  if (!ret)
+    GST_INFO ("amp_mono and amp_stereo are not installed, skipping");
+
+  return ret;
+}
+
+static GstElement *
+setup_rack (const gchar * name, const gchar * plugins, GstBus * bus)
+{
+  GstElement *rack;
+
+  rack = gst_check_setup_element (name);
+  g_object_set (rack, "plugins", plugins, NULL);
+  mysrcpad = gst_check_setup_src_pad (rack, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (rack, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  gst_element_set_bus (rack, bus);
+
+  fail_unless (gst_element_set_state (rack,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  return rack;
+}
+
+static void
+cleanup_rack (GstElement * rack, GstBus * bus)
+{
+  gst_bus_set_flushing (bus, TRUE);
+  gst_element_set_bus (rack, NULL);
+  gst_object_unref (bus);
+
+  gst_check_drop_buffers ();
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (rack);
+  gst_check_teardown_sink_pad (rack);
+  gst_check_teardown_element (rack);
+}
+
+/* interleaved samples that stay exact when scaled by the tested gains */
+static gfloat
+sample_value (gint i)
+{
+  return ((i * 7) % 128 - 64) / 64.0;
+}
+
+static GstBuffer *
+make_buffer (guint channels)
+{
+  GstBuffer *buf;
+  GstCaps *caps;
+  gchar *caps_str;
+  gfloat *data;
+  gint i;
+
+  buf = gst_buffer_new_and_alloc (FRAMES * channels * sizeof (gfloat));
+  data = (gfloat *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < FRAMES * channels; i++)
+    data[i] = sample_value (i);
+
+  caps_str = g_strdup_printf (CAPS_TEMPLATE, channels);
+  caps = gst_caps_from_string (caps_str);
+  g_free (caps_str);
+  gst_buffer_set_caps (buf, caps);
+  gst_caps_unref (caps);
+
+  return buf;
+}
+
+/* pushes one buffer through a rack and checks that it comes out scaled by
+ * @gain */
+static void
+check_chain (const gchar * name, guint channels, const gchar * plugins,
+    gfloat gain)
+{
+  GstElement *rack;
+  GstBus *bus;
+  GstBuffer *out;
+  const gfloat *data;
+  gchar *description;
+  gint i;
+
+  bus = gst_bus_new ();
+  rack = setup_rack (name, plugins, bus);
+  g_object_get (rack, "plugins", &description, NULL);
+  fail_unless (g_strcmp0 (description, plugins) == 0);
+  g_free (description);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, make_buffer (channels)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_unless (gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR) == NULL);
+
+  out = GST_BUFFER (buffers->data);
+  fail_unless_equals_int (GST_BUFFER_SIZE (out),
+      FRAMES * channels * sizeof (gfloat));
+  data = (const gfloat *) GST_BUFFER_DATA (out);
+  for (i = 0; i < FRAMES * channels; i++)
+    fail_unless (data[i] == sample_value (i) * gain,
+        "%s \"%s\" sample %d: %f != %f", name, plugins, i, data[i],
+        sample_value (i) * gain);
+
+  cleanup_rack (rack, bus);
+}
+
+/* a chain that fails to instantiate refuses the caps and posts an error */
+static void
+check_bad_chain (const gchar * name, guint channels, const gchar * plugins)
+{
+  GstElement *rack;
+  GstBus *bus;
+  GstMessage *msg;
+
+  bus = gst_bus_new ();
+  rack = setup_rack (name, plugins, bus);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, make_buffer (channels)),
+      GST_FLOW_NOT_NEGOTIATED);
+  fail_unless (buffers == NULL);
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL, "no error for \"%s\"", plugins);
+  gst_message_unref (msg);
+
+  cleanup_rack (rack, bus);
+}
+
+GST_START_TEST (test_empty_chain)
+{
+  check_chain ("ladsparack", 1, NULL, 1.0);
+  check_chain ("ladsparack", 1, " ! ", 1.0);
+  check_chain ("ladsparack-stereo", 2, NULL, 1.0);
+  check_chain ("ladsparack-stereo", 2, "", 1.0);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_chain)
+{
+  if (!have_amp_plugins ())
+    return;
+
+  check_chain ("ladsparack", 1, "amp_mono gain=0.5", 0.5);
+  /* port names are matched without case, white space is ignored */
+  check_chain ("ladsparack", 1, "  amp_mono gain=0.5 !amp_mono\tGain=3  ",
+      1.5);
+  check_chain ("ladsparack", 1, "amp_mono gain=2 ! amp_mono ! amp_mono "
+      "gain=0.25", 0.5);
+  /* amp_mono runs once per channel, amp_stereo once */
+  check_chain ("ladsparack-stereo", 2, "amp_mono gain=2 ! amp_stereo "
+      "gain=0.25", 0.5);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_bad_chain)
+{
+  check_bad_chain ("ladsparack", 1, "no-such-plugin");
+
+  if (!have_amp_plugins ())
+    return;
+
+  check_bad_chain ("ladsparack", 1, "amp_mono volume=2");
+  check_bad_chain ("ladsparack", 1, "amp_mono gain=loud");
+  check_bad_chain ("ladsparack", 1, "amp_mono gain");
+  check_bad_chain ("ladsparack", 1, "amp_mono gain=2 ! no-such-plugin");
+  /* two audio ports can't run on one channel */
+  check_bad_chain ("ladsparack", 1, "amp_stereo");
+}
+
+GST_END_TEST;
+
+static Suite *
+ladsparack_suite (void)
+{
+  Suite *s = suite_create ("ladsparack");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_empty_chain);
+  tcase_add_test (tc_chain, test_chain);
+  tcase_add_test (tc_chain, test_bad_chain);
+
+  return s;
+}
+
+GST_CHECK_MAIN (ladsparack);
@@ -22,6 +22,8 @@
  */
 
 #include <unistd.h>
+#include <math.h>
+#include <string.h>
 
 #include <gst/check/gstcheck.h>
 
@@ -224,6 +226,96 @@ GST_START_TEST (test_perfect_stream)
 
 GST_END_TEST;
 
+/* pushes a sine through legacyresample with the given preset and returns
+ * the first channel of what came out */
+static gint16 *
+resample_sine (const gchar * preset, int inrate, int outrate, int *n_out)
+{
+  GstElement *legacyresample;
+  GstBuffer *inbuffer;
+  GstCaps *caps;
+  GList *l;
+  gint16 *p, *out;
+  int i, j, n;
+
+  legacyresample = setup_legacyresample (2, inrate, outrate);
+  gst_util_set_object_arg (G_OBJECT (legacyresample), "preset", preset);
+  caps = gst_pad_get_negotiated_caps (mysrcpad);
+
+  fail_unless (gst_element_set_state (legacyresample,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  for (j = 0; j < 10; j++) {
+    inbuffer = gst_buffer_new_and_alloc (500 * 4);
+    GST_BUFFER_DURATION (inbuffer) = 500 * GST_SECOND / inrate;
+    GST_BUFFER_TIMESTAMP (inbuffer) = GST_BUFFER_DURATION (inbuffer) * j;
+    GST_BUFFER_OFFSET (inbuffer) = j * 500;
+    GST_BUFFER_OFFSET_END (inbuffer) = (j + 1) * 500;
+    gst_buffer_set_caps (inbuffer, caps);
+
+    p = (gint16 *) GST_BUFFER_DATA (inbuffer);
+    for (i = 0; i < 500; i++) {
+      p[2 * i] = p[2 * i + 1] = 16000 * sin (2 * G_PI * 440 * (j * 500 + i)
+          / inrate);
+    }
+    fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  }
+
+  n = 0;
+  for (l = buffers; l; l = l->next)
+    n += GST_BUFFER_SIZE (GST_BUFFER (l->data)) / 4;
+  out = g_new (gint16, n);
+  n = 0;
+  for (l = buffers; l; l = l->next) {
+    p = (gint16 *) GST_BUFFER_DATA (GST_BUFFER (l->data));
+    for (i = 0; i < GST_BUFFER_SIZE (GST_BUFFER (l->data)) / 4; i++)
+      out[n++] = p[2 * i];
+  }
+  fail_unless_perfect_stream ();
+
+  gst_caps_unref (caps);
+  cleanup_legacyresample (legacyresample);
+
+  *n_out = n;
+  return out;
+}
+
+/* the filter bank of the medium preset is the reference filter of the
+ * default length, evaluated ahead of time */
+GST_START_TEST (test_presets)
+{
+  static const int rates[][2] = {
+    {44100, 48000}, {48000, 44100}, {8000, 44100}, {48000, 8000}
+  };
+  static const gchar *presets[] = { "fast", "medium", "high", "best" };
+  gint16 *ref, *out;
+  int n_ref, n_out;
+  int i, j, k;
+
+  for (i = 0; i < G_N_ELEMENTS (rates); i++) {
+    ref = resample_sine ("reference", rates[i][0], rates[i][1], &n_ref);
+
+    for (j = 0; j < G_N_ELEMENTS (presets); j++) {
+      out = resample_sine (presets[j], rates[i][0], rates[i][1], &n_out);
+      /* the reference can come out one sample short because of the
+       * rounding of its filter position */
+      fail_unless (ABS (n_out - n_ref) <= 1, "%s: %d samples instead of %d",
+          presets[j], n_out, n_ref);
+
+      if (strcmp (presets[j], "medium") == 0) {
+        for (k = 0; k < MIN (n_out, n_ref); k++)
+          fail_unless (ABS (out[k] - ref[k]) <= 1, "sample %d: %d != %d", k,
+              out[k], ref[k]);
+      }
+      g_free (out);
+    }
+    g_free (ref);
+  }
+}
+
+GST_END_TEST;
+
 /* this tests that the output is a correct discontinuous stream
  * if the input is; ie input drops in time come out the same way */
 static void
@@ -562,6 +654,7 @@ legacyresample_suite (void)
   tcase_add_test (tc_chain, test_reuse);
   tcase_add_test (tc_chain, test_shutdown);
   tcase_add_test (tc_chain, test_live_switch);
+  tcase_add_test (tc_chain, test_presets);
 
   return s;
 }
@@ -0,0 +1,316 @@
+/* GStreamer
+ *
+ * unit test for liveadder
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#define RATE 8000
+/* one block of the liveadder ring */
+#define SAMPLES (RATE / 100)
+
+#define INT_CAPS "audio/x-raw-int, rate = (int) 8000, channels = (int) 1, " \
+    "endianness = (int) BYTE_ORDER, width = (int) %d, depth = (int) %d, " \
+    "signed = (boolean) %s"
+#define FLOAT_CAPS "audio/x-raw-float, rate = (int) 8000, " \
+    "channels = (int) 1, endianness = (int) BYTE_ORDER, width = (int) %d"
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/* Every format is mixed over three blocks: in the first one the second pad
+ * is at half volume, in the second one the sum clips (except for float) and
+ * in the third one the second pad is muted */
+typedef struct
+{
+  gint width;
+  gboolean is_signed;
+  gboolean is_float;
+  gdouble in1[3], in2[3], out[3];
+} FormatTest;
+
+static const FormatTest formats[] = {
+  {8, TRUE, FALSE, {10, 100, -12}, {30, 100, 50}, {25, 127, -12}},
+  {8, FALSE, FALSE, {10, 200, 77}, {168, 200, 50}, {158, 255, 77}},
+  {16, TRUE, FALSE, {1000, 30000, -1234}, {3000, 30000, 5000},
+      {2500, 32767, -1234}},
+  {16, FALSE, FALSE, {1000, 40000, 1234}, {34768, 40000, 5000},
+      {34768, 65535, 1234}},
+  {32, TRUE, FALSE, {100000, 2000000000, -1234}, {300000, 2000000000, 5000},
+      {250000, 2147483647, -1234}},
+  {32, FALSE, FALSE, {1000, 3000000000u, 1234},
+        {2147485648u, 3000000000u, 5000},
+      {2147485648u, 4294967295u, 1234}},
+  {32, TRUE, TRUE, {0.25, 0.75, -0.125}, {0.5, 0.75, 0.5},
+      {0.5, 1.5, -0.125}},
+  {64, TRUE, TRUE, {0.25, 0.75, -0.125}, {0.5, 0.75, 0.5},
+      {0.5, 1.5, -0.125}},
+};
+
+typedef struct
+{
+  GstElement *liveadder;
+  GstPad *reqpad1, *reqpad2;
+  GstPad *src1, *src2, *sink;
+  GstCaps *caps;
+} LiveAdderTest;
+
+static void
+setup_liveadder (LiveAdderTest * t, const FormatTest * format)
+{
+  GstClock *clock;
+  gchar *caps_str;
+
+  t->liveadder = gst_check_setup_element ("liveadder");
+  /* leave enough time to push all the input before the first output */
+  g_object_set (t->liveadder, "latency", 500, NULL);
+
+  t->reqpad1 = gst_element_get_request_pad (t->liveadder, "sink%d");
+  fail_unless (t->reqpad1 != NULL);
+  t->reqpad2 = gst_element_get_request_pad (t->liveadder, "sink%d");
+  fail_unless (t->reqpad2 != NULL);
+  t->sink = gst_check_setup_sink_pad_by_name (t->liveadder, &sinktemplate,
+      "src");
+
+  t->src1 = gst_pad_new_from_static_template (&srctemplate, "src");
+  t->src2 = gst_pad_new_from_static_template (&srctemplate, "src");
+  fail_unless (gst_pad_link (t->src1, t->reqpad1) == GST_PAD_LINK_OK);
+  fail_unless (gst_pad_link (t->src2, t->reqpad2) == GST_PAD_LINK_OK);
+
+  clock = gst_system_clock_obtain ();
+  gst_element_set_clock (t->liveadder, clock);
+  gst_element_set_base_time (t->liveadder, gst_clock_get_time (clock));
+  gst_object_unref (clock);
+
+  fail_unless (gst_element_set_state (t->liveadder,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+  gst_pad_set_active (t->sink, TRUE);
+  gst_pad_set_active (t->src1, TRUE);
+  gst_pad_set_active (t->src2, TRUE);
+
+  fail_unless (gst_pad_push_event (t->src1,
+          gst_event_new_new_segment (FALSE, 1.0, GST_FORMAT_TIME, 0, -1, 0)));
+  fail_unless (gst_pad_push_event (t->src2,
+          gst_event_new_new_segment (FALSE, 1.0, GST_FORMAT_TIME, 0, -1, 0)));
+
+  if (format->is_float)
+    caps_str = g_strdup_printf (FLOAT_CAPS, format->width);
+  else
+    caps_str = g_strdup_printf (INT_CAPS, format->width, format->width,
+        format->is_signed ? "true" : "false");
+  t->caps = gst_caps_from_string (caps_str);
+  g_free (caps_str);
+}
+
+static void
+cleanup_liveadder (LiveAdderTest * t)
+{
+  gst_check_drop_buffers ();
+  gst_caps_unref (t->caps);
+
+  gst_pad_set_active (t->sink, FALSE);
+  gst_pad_set_active (t->src1, FALSE);
+  gst_pad_set_active (t->src2, FALSE);
+  fail_unless (gst_element_set_state (t->liveadder,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+  gst_check_teardown_pad_by_name (t->liveadder, "src");
+  gst_check_teardown_pad_by_name (t->liveadder, "sink0");
+  gst_check_teardown_pad_by_name (t->liveadder, "sink1");
+  gst_element_release_request_pad (t->liveadder, t->reqpad1);
+  gst_element_release_request_pad (t->liveadder, t->reqpad2);
+  gst_object_unref (t->reqpad1);
+  gst_object_unref (t->reqpad2);
+
+  gst_check_teardown_element (t->liveadder);
+}
+
+static void
+set_sample (const FormatTest * format, guint8 * p, gdouble value)
+{
+  if (format->is_float) {
+    if (format->width == 32)
+      *(gfloat *) p = value;
+    else
+      *(gdouble *) p = value;
+    return;
+  }
+
+  switch (format->width) {
+    case 8:
+      if (format->is_signed)
+        *(gint8 *) p = value;
+      else
+        *p = value;
+      break;
+    case 16:
+      if (format->is_signed)
+        *(gint16 *) p = value;
+      else
+        *(guint16 *) p = value;
+      break;
+    case 32:
+      if (format->is_signed)
+        *(gint32 *) p = value;
+      else
+        *(guint32 *) p = value;
+      break;
+  }
+}
+
+static gdouble
+get_sample (const FormatTest * format, const guint8 * p)
+{
+  if (format->is_float)
+    return format->width == 32 ? *(gfloat *) p : *(gdouble *) p;
+
+  switch (format->width) {
+    case 8:
+      return format->is_signed ? *(gint8 *) p : *p;
+    case 16:
+      return format->is_signed ? *(gint16 *) p : *(guint16 *) p;
+    default:
+      return format->is_signed ? *(gint32 *) p : *(guint32 *) p;
+  }
+}
+
+static void
+push_block (LiveAdderTest * t, const FormatTest * format, GstPad * pad,
+    gint block, gdouble value)
+{
+  GstBuffer *buf;
+  gint bps = format->width / 8;
+  gint i;
+
+  buf = gst_buffer_new_and_alloc (SAMPLES * bps);
+  for (i = 0; i < SAMPLES; i++)
+    set_sample (format, GST_BUFFER_DATA (buf) + i * bps, value);
+  GST_BUFFER_TIMESTAMP (buf) = block * 10 * GST_MSECOND;
+  GST_BUFFER_DURATION (buf) = 10 * GST_MSECOND;
+  gst_buffer_set_caps (buf, t->caps);
+
+  fail_unless_equals_int (gst_pad_push (pad, buf), GST_FLOW_OK);
+}
+
+static void
+wait_for_buffers (guint n)
+{
+  g_mutex_lock (check_mutex);
+  while (g_list_length (buffers) < n)
+    g_cond_wait (check_cond, check_mutex);
+  g_mutex_unlock (check_mutex);
+}
+
+static void
+check_block (const FormatTest * format, gint index, gint block,
+    gdouble value)
+{
+  GstBuffer *buf = GST_BUFFER (g_list_nth_data (buffers, index));
+  gint bps = format->width / 8;
+  gint i;
+
+  fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (buf),
+      block * 10 * GST_MSECOND);
+  fail_unless_equals_int (GST_BUFFER_SIZE (buf), SAMPLES * bps);
+  for (i = 0; i < SAMPLES; i++) {
+    gdouble sample = get_sample (format, GST_BUFFER_DATA (buf) + i * bps);
+
+    fail_unless (sample == value, "%s%d block %d sample %d: %g != %g",
+        format->is_float ? "F" : format->is_signed ? "S" : "U",
+        format->width, block, i, sample, value);
+  }
+}
+
+GST_START_TEST (test_volume_mute)
+{
+  LiveAdderTest t;
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    const FormatTest *format = &formats[i];
+
+    setup_liveadder (&t, format);
+
+    /* scaled */
+    g_object_set (t.reqpad2, "volume", 0.5, NULL);
+    push_block (&t, format, t.src1, 0, format->in1[0]);
+    push_block (&t, format, t.src2, 0, format->in2[0]);
+    /* saturated */
+    g_object_set (t.reqpad2, "volume", 1.0, NULL);
+    push_block (&t, format, t.src1, 1, format->in1[1]);
+    push_block (&t, format, t.src2, 1, format->in2[1]);
+    /* muted */
+    g_object_set (t.reqpad2, "mute", TRUE, NULL);
+    push_block (&t, format, t.src1, 2, format->in1[2]);
+    push_block (&t, format, t.src2, 2, format->in2[2]);
+
+    wait_for_buffers (3);
+    check_block (format, 0, 0, format->out[0]);
+    check_block (format, 1, 1, format->out[1]);
+    check_block (format, 2, 2, format->out[2]);
+
+    cleanup_liveadder (&t);
+  }
+}
+
+GST_END_TEST;
+
+/* a buffer that starts beyond the largest ring is dropped without touching
+ * the blocks that are still waiting to be pushed */
+GST_START_TEST (test_far_ahead)
+{
+  const FormatTest *format = &formats[2];
+  LiveAdderTest t;
+
+  setup_liveadder (&t, format);
+
+  push_block (&t, format, t.src1, 0, 1000);
+  /* 30 seconds ahead, the ring holds 10 */
+  push_block (&t, format, t.src2, 3000, 3000);
+  push_block (&t, format, t.src1, 1, 2000);
+  push_block (&t, format, t.src2, 1, 500);
+
+  wait_for_buffers (2);
+  check_block (format, 0, 0, 1000);
+  check_block (format, 1, 1, 2500);
+
+  cleanup_liveadder (&t);
+}
+
+GST_END_TEST;
+
+static Suite *
+liveadder_suite (void)
+{
+  Suite *s = suite_create ("liveadder");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_volume_mute);
+  tcase_add_test (tc_chain, test_far_ahead);
+
+  return s;
+}
+
+GST_CHECK_MAIN (liveadder);
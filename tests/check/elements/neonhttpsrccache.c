@@ -0,0 +1,388 @@
+/* GStreamer unit tests for the block cache of neonhttpsrc
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+/* a local stand-in for a HTTP server with range and keep-alive support,
+ * serving a generated resource of TEST_SIZE bytes */
+#define TEST_SIZE (1024 * 1024 + 123)
+
+static gint server_fd = -1;
+static guint server_port;
+static GThread *server_thread;
+static GMutex *server_lock;
+static GList *conn_threads;
+static guint n_connections;
+static guint n_requests;
+static guint fail_request;
+static guint data_errors;
+static guint64 bytes_received;
+
+static guint8
+test_byte (guint64 pos)
+{
+  return (pos * 7 + pos / 251) & 0xff;
+}
+
+static gboolean
+write_all (gint fd, const gchar * data, gsize len)
+{
+  while (len > 0) {
+    gssize ret = write (fd, data, len);
+
+    if (ret <= 0)
+      return FALSE;
+    data += ret;
+    len -= ret;
+  }
+  return TRUE;
+}
+
+static gpointer
+connection_func (gpointer data)
+{
+  gint fd = GPOINTER_TO_INT (data);
+  gchar req[4096];
+  gsize have = 0;
+
+  while (TRUE) {
+    gchar *end, *range, *head;
+    guint64 start = 0, stop = TEST_SIZE - 1, pos;
+    gssize ret;
+    guint8 body[4096];
+
+    /* read the request headers */
+    while ((end = g_strstr_len (req, have, "\r\n\r\n")) == NULL) {
+      ret = read (fd, req + have, sizeof (req) - have - 1);
+      if (ret <= 0)
+        goto done;
+      have += ret;
+      req[have] = '\0';
+    }
+
+    g_mutex_lock (server_lock);
+    n_requests++;
+    /* drop the connection like a server closing an idle one */
+    if (n_requests == fail_request) {
+      g_mutex_unlock (server_lock);
+      goto done;
+    }
+    g_mutex_unlock (server_lock);
+
+    range = strstr (req, "Range: bytes=");
+    if (range && range < end) {
+      range += strlen ("Range: bytes=");
+      start = g_ascii_strtoull (range, &range, 10);
+      if (range[0] == '-' && g_ascii_isdigit (range[1]))
+        stop = MIN (g_ascii_strtoull (range + 1, NULL, 10), TEST_SIZE - 1);
+      head = g_strdup_printf ("HTTP/1.1 206 Partial Content\r\n"
+          "Content-Range: bytes %" G_GUINT64_FORMAT "-%" G_GUINT64_FORMAT
+          "/%u\r\nContent-Length: %" G_GUINT64_FORMAT "\r\n\r\n", start, stop,
+          TEST_SIZE, stop - start + 1);
+    } else {
+      head = g_strdup_printf ("HTTP/1.1 200 OK\r\n"
+          "Content-Length: %u\r\n\r\n", TEST_SIZE);
+    }
+
+    /* keep what was read of the next request */
+    end += 4;
+    have -= end - req;
+    memmove (req, end, have);
+    req[have] = '\0';
+
+    if (!write_all (fd, head, strlen (head))) {
+      g_free (head);
+      goto done;
+    }
+    g_free (head);
+
+    for (pos = start; pos <= stop;) {
+      guint i, len = MIN (sizeof (body), stop - pos + 1);
+
+      for (i = 0; i < len; i++)
+        body[i] = test_byte (pos + i);
+      if (!write_all (fd, (gchar *) body, len))
+        goto done;
+      pos += len;
+    }
+  }
+
+done:
+  close (fd);
+  return NULL;
+}
+
+static gpointer
+server_func (gpointer data)
+{
+  gint fd;
+
+  while ((fd = accept (server_fd, NULL, NULL)) >= 0) {
+    GThread *thread;
+
+    g_mutex_lock (server_lock);
+    n_connections++;
+    g_mutex_unlock (server_lock);
+
+    thread = g_thread_create (connection_func, GINT_TO_POINTER (fd), TRUE,
+        NULL);
+    conn_threads = g_list_prepend (conn_threads, thread);
+  }
+  return NULL;
+}
+
+static void
+start_server (void)
+{
+  struct sockaddr_in addr;
+  socklen_t len = sizeof (addr);
+
+  server_lock = g_mutex_new ();
+  n_connections = n_requests = data_errors = fail_request = 0;
+  bytes_received = 0;
+
+  server_fd = socket (AF_INET, SOCK_STREAM, 0);
+  fail_unless (server_fd >= 0);
+
+  memset (&addr, 0, sizeof (addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+  fail_unless (bind (server_fd, (struct sockaddr *) &addr, sizeof (addr)) == 0);
+  fail_unless (listen (server_fd, 5) == 0);
+  fail_unless (getsockname (server_fd, (struct sockaddr *) &addr, &len) == 0);
+  server_port = ntohs (addr.sin_port);
+
+  server_thread = g_thread_create (server_func, NULL, TRUE, NULL);
+}
+
+static void
+stop_server (void)
+{
+  shutdown (server_fd, SHUT_RDWR);
+  close (server_fd);
+  g_thread_join (server_thread);
+
+  /* the connections were closed by the element */
+  while (conn_threads) {
+    g_thread_join (conn_threads->data);
+    conn_threads = g_list_delete_link (conn_threads, conn_threads);
+  }
+  g_mutex_free (server_lock);
+}
+
+static void
+check_data_cb (GstElement * fakesink, GstBuffer * buf, GstPad * pad,
+    gpointer user_data)
+{
+  guint i;
+
+  for (i = 0; i < GST_BUFFER_SIZE (buf); i++) {
+    if (GST_BUFFER_DATA (buf)[i] != test_byte (GST_BUFFER_OFFSET (buf) + i)) {
+      data_errors++;
+      break;
+    }
+  }
+  bytes_received += GST_BUFFER_SIZE (buf);
+}
+
+static GstElement *
+setup_cache_pipeline (GstElement ** src, guint cache_size)
+{
+  GstElement *pipe, *sink;
+  gchar *location;
+
+  pipe = gst_pipeline_new (NULL);
+
+  *src = gst_element_factory_make ("neonhttpsrc", NULL);
+  fail_unless (*src != NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (sink != NULL);
+
+  gst_bin_add_many (GST_BIN (pipe), *src, sink, NULL);
+  fail_unless (gst_element_link (*src, sink));
+
+  location = g_strdup_printf ("http://127.0.0.1:%u/test", server_port);
+  g_object_set (*src, "location", location, "cache-size", cache_size,
+      "max-connections", 2, "proxy", "", NULL);
+  g_free (location);
+
+  g_object_set (sink, "signal-handoffs", TRUE, "sync", FALSE, NULL);
+  g_signal_connect (sink, "handoff", G_CALLBACK (check_data_cb), NULL);
+
+  return pipe;
+}
+
+static void
+run_to_eos (GstElement * pipe)
+{
+  GstMessage *msg;
+
+  msg = gst_bus_poll (GST_ELEMENT_BUS (pipe),
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR, -1);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+}
+
+GST_START_TEST (test_cache_read)
+{
+  GstElement *pipe, *src;
+  guint64 hits, misses;
+  guint n_blocks = (TEST_SIZE + 65535) / 65536;
+
+  start_server ();
+  pipe = setup_cache_pipeline (&src, 2 * TEST_SIZE);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+  run_to_eos (pipe);
+
+  fail_unless_equals_int (data_errors, 0);
+  fail_unless (bytes_received == TEST_SIZE);
+
+  /* every block was asked for once over the kept open connections */
+  fail_unless_equals_int (n_requests, n_blocks);
+  fail_unless (n_connections <= 2);
+
+  /* only the first buffer of a block can wait for it */
+  g_object_get (src, "cache-hits", &hits, "cache-misses", &misses, NULL);
+  fail_unless (misses <= n_blocks);
+  fail_unless (hits > misses);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (pipe);
+  stop_server ();
+}
+
+GST_END_TEST;
+
+/* a cache that only holds the prefetch window and the block being read */
+GST_START_TEST (test_cache_small)
+{
+  GstElement *pipe, *src;
+  guint n_blocks = (TEST_SIZE + 65535) / 65536;
+
+  start_server ();
+  pipe = setup_cache_pipeline (&src, 5 * 65536);
+  g_object_set (src, "prefetch-blocks", 4, NULL);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+  run_to_eos (pipe);
+
+  fail_unless_equals_int (data_errors, 0);
+  fail_unless (bytes_received == TEST_SIZE);
+
+  /* prefetched blocks were not dropped before being read */
+  fail_unless_equals_int (n_requests, n_blocks);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (pipe);
+  stop_server ();
+}
+
+GST_END_TEST;
+
+/* a prefetched block that fails once is fetched again on a new connection
+ * instead of failing the stream */
+GST_START_TEST (test_cache_retry)
+{
+  GstElement *pipe, *src;
+  guint n_blocks = (TEST_SIZE + 65535) / 65536;
+
+  start_server ();
+  fail_request = 3;
+  pipe = setup_cache_pipeline (&src, 2 * TEST_SIZE);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+  run_to_eos (pipe);
+
+  fail_unless_equals_int (data_errors, 0);
+  fail_unless (bytes_received == TEST_SIZE);
+  fail_unless_equals_int (n_requests, n_blocks + 1);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (pipe);
+  stop_server ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_cache_backwards_seek)
+{
+  GstElement *pipe, *src;
+  guint64 hits_before, hits_after;
+  guint requests;
+
+  start_server ();
+  pipe = setup_cache_pipeline (&src, 2 * TEST_SIZE);
+
+  gst_element_set_state (pipe, GST_STATE_PLAYING);
+  run_to_eos (pipe);
+
+  g_mutex_lock (server_lock);
+  requests = n_requests;
+  g_mutex_unlock (server_lock);
+  g_object_get (src, "cache-hits", &hits_before, NULL);
+
+  /* read everything again, like a demuxer looking for an index at the end
+   * and going back to the start */
+  bytes_received = 0;
+  fail_unless (gst_element_seek_simple (pipe, GST_FORMAT_BYTES,
+          GST_SEEK_FLAG_FLUSH, 0));
+  run_to_eos (pipe);
+
+  fail_unless_equals_int (data_errors, 0);
+  fail_unless (bytes_received == TEST_SIZE);
+
+  /* all of it came from the cache */
+  fail_unless_equals_int (n_requests, requests);
+  g_object_get (src, "cache-hits", &hits_after, NULL);
+  fail_unless (hits_after > hits_before);
+
+  gst_element_set_state (pipe, GST_STATE_NULL);
+  gst_object_unref (pipe);
+  stop_server ();
+}
+
+GST_END_TEST;
+
+static Suite *
+neonhttpsrccache_suite (void)
+{
+  Suite *s = suite_create ("neonhttpsrccache");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_set_timeout (tc_chain, 5);
+  tcase_add_test (tc_chain, test_cache_read);
+  tcase_add_test (tc_chain, test_cache_small);
+  tcase_add_test (tc_chain, test_cache_retry);
+  tcase_add_test (tc_chain, test_cache_backwards_seek);
+
+  return s;
+}
+
+GST_CHECK_MAIN (neonhttpsrccache);
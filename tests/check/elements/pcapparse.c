@@ -0,0 +1,836 @@
+/* GStreamer
+ *
+ * unit test for pcapparse
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+
+#include <gio/gio.h>
+#include <gst/check/gstcheck.h>
+
+/* For ease of programming we use globals to keep refs for our floating
+ * src and sink pads we create; otherwise we always have to do get_pad,
+ * get_peer, and then remove references in every test function */
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("raw/x-pcap"));
+
+#define IP_PROTO_HOPOPTS   0
+#define IP_PROTO_TCP       6
+#define IP_PROTO_UDP      17
+#define IP_PROTO_FRAGMENT 44
+
+#define PCAPNG_BLOCK_SHB  0x0a0d0d0a
+#define PCAPNG_BLOCK_IDB  0x00000001
+#define PCAPNG_BLOCK_SPB  0x00000003
+#define PCAPNG_BLOCK_EPB  0x00000006
+
+typedef struct
+{
+  const gchar *src;
+  const gchar *dst;
+  guint16 src_port;
+  guint16 dst_port;
+} Flow;
+
+static const Flow flow_a = { "10.0.0.1", "10.0.0.2", 5000, 6000 };
+static const Flow flow_b = { "10.0.0.1", "10.0.0.2", 5002, 6000 };
+static const Flow flow_c = { "2001:db8::1", "2001:db8::2", 7000, 8000 };
+static const Flow flow_d = { "2001:db8::1", "2001:db8::3", 7000, 8000 };
+
+/* the sink pads linked to the src_%u pads in multi-flow mode, in the order
+ * the pads were added */
+typedef struct
+{
+  GstPad *pad;
+  GList *buffers;
+} FlowSink;
+
+static GPtrArray *flow_sinks;
+
+/* replay mode, the buffer lists received on mysinkpad, and how many of them
+ * there were when the EOS came */
+static GList *lists;
+static gint lists_at_eos;
+
+/* pull mode, the capture that is read */
+static GByteArray *pull_capture;
+
+static GstElement *
+setup_pcapparse (gboolean multi_flow, GstBus ** bus)
+{
+  GstElement *pcapparse;
+
+  GST_DEBUG ("setup_pcapparse");
+  pcapparse = gst_check_setup_element ("pcapparse");
+  g_object_set (pcapparse, "multi-flow", multi_flow, NULL);
+
+  *bus = gst_bus_new ();
+  gst_element_set_bus (pcapparse, *bus);
+
+  mysrcpad = gst_check_setup_src_pad (pcapparse, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (pcapparse, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  flow_sinks = g_ptr_array_new ();
+  lists_at_eos = -1;
+
+  return pcapparse;
+}
+
+static void
+cleanup_pcapparse (GstElement * pcapparse, GstBus * bus)
+{
+  guint i;
+
+  GST_DEBUG ("cleanup_pcapparse");
+
+  gst_check_drop_buffers ();
+  fail_unless (gst_element_set_state (pcapparse,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+
+  for (i = 0; i < flow_sinks->len; i++) {
+    FlowSink *sink = g_ptr_array_index (flow_sinks, i);
+
+    gst_pad_set_active (sink->pad, FALSE);
+    gst_object_unref (sink->pad);
+    g_list_foreach (sink->buffers, (GFunc) gst_mini_object_unref, NULL);
+    g_list_free (sink->buffers);
+    g_free (sink);
+  }
+  g_ptr_array_free (flow_sinks, TRUE);
+
+  g_list_foreach (lists, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (lists);
+  lists = NULL;
+  if (pull_capture) {
+    g_byte_array_free (pull_capture, TRUE);
+    pull_capture = NULL;
+  }
+
+  gst_element_set_bus (pcapparse, NULL);
+  gst_object_unref (bus);
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (pcapparse);
+  gst_check_teardown_sink_pad (pcapparse);
+  gst_check_teardown_element (pcapparse);
+}
+
+static GstFlowReturn
+flow_sink_chain (GstPad * pad, GstBuffer * buffer)
+{
+  FlowSink *sink = gst_pad_get_element_private (pad);
+
+  sink->buffers = g_list_append (sink->buffers, buffer);
+
+  return GST_FLOW_OK;
+}
+
+static void
+pad_added_cb (GstElement * pcapparse, GstPad * pad, gpointer user_data)
+{
+  FlowSink *sink = g_new0 (FlowSink, 1);
+
+  sink->pad = gst_pad_new_from_static_template (&sinktemplate,
+      GST_PAD_NAME (pad));
+  gst_pad_set_chain_function (sink->pad, flow_sink_chain);
+  gst_pad_set_element_private (sink->pad, sink);
+  gst_pad_set_active (sink->pad, TRUE);
+  fail_unless_equals_int (gst_pad_link (pad, sink->pad), GST_PAD_LINK_OK);
+
+  g_ptr_array_add (flow_sinks, sink);
+}
+
+static GstFlowReturn
+push_capture (GstElement * pcapparse, GByteArray * capture)
+{
+  GstBuffer *buf;
+
+  fail_unless (gst_element_set_state (pcapparse,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  buf = gst_buffer_new_and_alloc (capture->len);
+  memcpy (GST_BUFFER_DATA (buf), capture->data, capture->len);
+  g_byte_array_free (capture, TRUE);
+
+  return gst_pad_push (mysrcpad, buf);
+}
+
+static void
+check_payloads (GList * list, const gchar ** payloads,
+    const GstClockTime * timestamps)
+{
+  guint i;
+
+  for (i = 0; payloads[i]; i++) {
+    GstBuffer *buf;
+
+    fail_unless (list != NULL, "missing payload %s", payloads[i]);
+    buf = list->data;
+    fail_unless_equals_int (GST_BUFFER_SIZE (buf), strlen (payloads[i]));
+    fail_unless (memcmp (GST_BUFFER_DATA (buf), payloads[i],
+            GST_BUFFER_SIZE (buf)) == 0, "expected payload %s", payloads[i]);
+    if (timestamps)
+      fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (buf), timestamps[i]);
+    list = list->next;
+  }
+  fail_unless (list == NULL, "unexpected payload");
+}
+
+static GstFlowReturn
+replay_chain_list (GstPad * pad, GstBufferList * list)
+{
+  g_mutex_lock (check_mutex);
+  lists = g_list_append (lists, list);
+  g_cond_signal (check_cond);
+  g_mutex_unlock (check_mutex);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+replay_sink_event (GstPad * pad, GstEvent * event)
+{
+  if (GST_EVENT_TYPE (event) == GST_EVENT_EOS) {
+    g_mutex_lock (check_mutex);
+    lists_at_eos = g_list_length (lists);
+    g_mutex_unlock (check_mutex);
+  }
+  gst_event_unref (event);
+
+  return TRUE;
+}
+
+static GstFlowReturn
+pull_getrange (GstPad * pad, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  if (offset >= pull_capture->len)
+    return GST_FLOW_UNEXPECTED;
+
+  length = MIN (length, pull_capture->len - offset);
+  *buffer = gst_buffer_new_and_alloc (length);
+  memcpy (GST_BUFFER_DATA (*buffer), pull_capture->data + offset, length);
+  GST_BUFFER_OFFSET (*buffer) = offset;
+
+  return GST_FLOW_OK;
+}
+
+static GstElement *
+setup_replay (gdouble speed, gboolean loop, GstBus ** bus)
+{
+  GstElement *pcapparse;
+
+  pcapparse = setup_pcapparse (FALSE, bus);
+  g_object_set (pcapparse, "replay", TRUE, "speed", speed, "loop", loop,
+      "batch-time", (guint64) GST_MSECOND, NULL);
+  gst_pad_set_chain_list_function (mysinkpad, replay_chain_list);
+  gst_pad_set_event_function (mysinkpad, replay_sink_event);
+
+  return pcapparse;
+}
+
+/* checks that @list has one group of one buffer per payload */
+static void
+check_list (GstBufferList * list, const gchar ** payloads,
+    const GstClockTime * timestamps)
+{
+  GstBufferListIterator *it;
+  guint i;
+
+  it = gst_buffer_list_iterate (list);
+  for (i = 0; payloads[i]; i++) {
+    GstBuffer *buf;
+
+    fail_unless (gst_buffer_list_iterator_next_group (it),
+        "missing group for %s", payloads[i]);
+    fail_unless_equals_int (gst_buffer_list_iterator_n_buffers (it), 1);
+    buf = gst_buffer_list_iterator_next (it);
+    fail_unless_equals_int (GST_BUFFER_SIZE (buf), strlen (payloads[i]));
+    fail_unless (memcmp (GST_BUFFER_DATA (buf), payloads[i],
+            GST_BUFFER_SIZE (buf)) == 0, "expected payload %s", payloads[i]);
+    fail_unless_equals_uint64 (GST_BUFFER_TIMESTAMP (buf), timestamps[i]);
+  }
+  fail_if (gst_buffer_list_iterator_next_group (it), "unexpected group");
+  gst_buffer_list_iterator_free (it);
+}
+
+static void
+put_u16 (GByteArray * array, guint16 val, gboolean be)
+{
+  guint8 b[2];
+
+  if (be)
+    GST_WRITE_UINT16_BE (b, val);
+  else
+    GST_WRITE_UINT16_LE (b, val);
+  g_byte_array_append (array, b, 2);
+}
+
+static void
+put_u32 (GByteArray * array, guint32 val, gboolean be)
+{
+  guint8 b[4];
+
+  if (be)
+    GST_WRITE_UINT32_BE (b, val);
+  else
+    GST_WRITE_UINT32_LE (b, val);
+  g_byte_array_append (array, b, 4);
+}
+
+static void
+put_zeros (GByteArray * array, guint len)
+{
+  static const guint8 zeros[16] = { 0, };
+
+  g_byte_array_append (array, zeros, len);
+}
+
+static void
+put_address (GByteArray * array, const gchar * str)
+{
+  GInetAddress *addr = g_inet_address_new_from_string (str);
+
+  fail_unless (addr != NULL);
+  g_byte_array_append (array, g_inet_address_to_bytes (addr),
+      g_inet_address_get_native_size (addr));
+  g_object_unref (addr);
+}
+
+/* an Ethernet frame with @n_tags VLAN tags, the outer ones 802.1ad, around
+ * an IP packet of @protocol.  For IPv6 @ext holds the extension headers
+ * between the IP and the UDP header. */
+static GByteArray *
+make_frame (const Flow * flow, guint n_tags, guint8 protocol,
+    const guint8 * ext, guint ext_len, const gchar * payload)
+{
+  GByteArray *frame = g_byte_array_new ();
+  guint len = strlen (payload);
+  gboolean ip6 = strchr (flow->src, ':') != NULL;
+  guint i;
+
+  /* destination and source MAC */
+  put_zeros (frame, 12);
+  for (i = 0; i < n_tags; i++) {
+    put_u16 (frame, i + 1 < n_tags ? 0x88a8 : 0x8100, TRUE);
+    put_u16 (frame, 100 + i, TRUE);
+  }
+
+  if (ip6) {
+    put_u16 (frame, 0x86dd, TRUE);
+    put_u32 (frame, 0x60000000, TRUE);
+    put_u16 (frame, ext_len + 8 + len, TRUE);
+    g_byte_array_append (frame, &protocol, 1);
+    put_zeros (frame, 1);
+    put_address (frame, flow->src);
+    put_address (frame, flow->dst);
+    if (ext_len)
+      g_byte_array_append (frame, ext, ext_len);
+  } else {
+    put_u16 (frame, 0x0800, TRUE);
+    put_u16 (frame, 0x4500, TRUE);
+    put_u16 (frame, 20 + 8 + len, TRUE);
+    /* identification, flags and fragment offset, ttl */
+    put_zeros (frame, 5);
+    g_byte_array_append (frame, &protocol, 1);
+    put_zeros (frame, 2);
+    put_address (frame, flow->src);
+    put_address (frame, flow->dst);
+  }
+
+  put_u16 (frame, flow->src_port, TRUE);
+  put_u16 (frame, flow->dst_port, TRUE);
+  put_u16 (frame, 8 + len, TRUE);
+  put_zeros (frame, 2);
+  g_byte_array_append (frame, (const guint8 *) payload, len);
+
+  return frame;
+}
+
+static GByteArray *
+make_udp_frame (const Flow * flow, guint n_tags, const gchar * payload)
+{
+  return make_frame (flow, n_tags, IP_PROTO_UDP, NULL, 0, payload);
+}
+
+/* a little endian libpcap file of Ethernet frames */
+static GByteArray *
+pcap_new (void)
+{
+  GByteArray *capture = g_byte_array_new ();
+
+  put_u32 (capture, 0xa1b2c3d4, FALSE);
+  put_u16 (capture, 2, FALSE);
+  put_u16 (capture, 4, FALSE);
+  put_zeros (capture, 8);
+  put_u32 (capture, 65535, FALSE);
+  put_u32 (capture, 1, FALSE);
+
+  return capture;
+}
+
+static void
+pcap_add (GByteArray * capture, guint32 sec, guint32 usec, GByteArray * frame)
+{
+  put_u32 (capture, sec, FALSE);
+  put_u32 (capture, usec, FALSE);
+  put_u32 (capture, frame->len, FALSE);
+  put_u32 (capture, frame->len, FALSE);
+  g_byte_array_append (capture, frame->data, frame->len);
+  g_byte_array_free (frame, TRUE);
+}
+
+/* appends a pcapng block made of @body and frees @body */
+static void
+pcapng_add_block (GByteArray * capture, guint32 type, GByteArray * body,
+    gboolean be)
+{
+  guint len = 12 + GST_ROUND_UP_4 (body->len);
+
+  put_u32 (capture, type, be);
+  put_u32 (capture, len, be);
+  g_byte_array_append (capture, body->data, body->len);
+  put_zeros (capture, GST_ROUND_UP_4 (body->len) - body->len);
+  put_u32 (capture, len, be);
+  g_byte_array_free (body, TRUE);
+}
+
+static void
+pcapng_add_shb (GByteArray * capture, gboolean be)
+{
+  GByteArray *body = g_byte_array_new ();
+
+  put_u32 (body, 0x1a2b3c4d, be);
+  put_u16 (body, 1, be);
+  put_u16 (body, 0, be);
+  /* unknown section length */
+  put_u32 (body, 0xffffffff, be);
+  put_u32 (body, 0xffffffff, be);
+  pcapng_add_block (capture, PCAPNG_BLOCK_SHB, body, be);
+}
+
+/* an Ethernet interface, with an if_tsresol option unless @tsresol is 0 */
+static void
+pcapng_add_idb (GByteArray * capture, guint8 tsresol, gboolean be)
+{
+  GByteArray *body = g_byte_array_new ();
+
+  put_u16 (body, 1, be);
+  put_u16 (body, 0, be);
+  put_u32 (body, 65535, be);
+  if (tsresol) {
+    put_u16 (body, 9, be);
+    put_u16 (body, 1, be);
+    g_byte_array_append (body, &tsresol, 1);
+    put_zeros (body, 3);
+  }
+  /* opt_endofopt */
+  put_u32 (body, 0, be);
+  pcapng_add_block (capture, PCAPNG_BLOCK_IDB, body, be);
+}
+
+static void
+pcapng_add_epb (GByteArray * capture, guint32 if_id, guint64 ts,
+    GByteArray * frame, gboolean be)
+{
+  GByteArray *body = g_byte_array_new ();
+
+  put_u32 (body, if_id, be);
+  put_u32 (body, ts >> 32, be);
+  put_u32 (body, ts & 0xffffffff, be);
+  put_u32 (body, frame->len, be);
+  put_u32 (body, frame->len, be);
+  g_byte_array_append (body, frame->data, frame->len);
+  g_byte_array_free (frame, TRUE);
+  pcapng_add_block (capture, PCAPNG_BLOCK_EPB, body, be);
+}
+
+static void
+pcapng_add_spb (GByteArray * capture, GByteArray * frame, gboolean be)
+{
+  GByteArray *body = g_byte_array_new ();
+
+  put_u32 (body, frame->len, be);
+  g_byte_array_append (body, frame->data, frame->len);
+  g_byte_array_free (frame, TRUE);
+  pcapng_add_block (capture, PCAPNG_BLOCK_SPB, body, be);
+}
+
+/* untagged, 802.1Q and 802.1ad + 802.1Q tagged frames, what is not UDP or
+ * not the first fragment is skipped */
+GST_START_TEST (test_vlan)
+{
+  static const gchar *payloads[] = { "plain", "vlan", "qinq", NULL };
+  static const GstClockTime timestamps[] = {
+    GST_SECOND, 2 * GST_SECOND + 500 * GST_MSECOND, 3 * GST_SECOND + 1000
+  };
+  GstElement *pcapparse;
+  GByteArray *capture, *frame;
+  GstBus *bus;
+
+  pcapparse = setup_pcapparse (FALSE, &bus);
+
+  capture = pcap_new ();
+  pcap_add (capture, 1, 0, make_udp_frame (&flow_a, 0, "plain"));
+  pcap_add (capture, 1, 1, make_frame (&flow_a, 0, IP_PROTO_TCP, NULL, 0,
+          "tcp"));
+  pcap_add (capture, 2, 500000, make_udp_frame (&flow_a, 1, "vlan"));
+  frame = make_udp_frame (&flow_a, 1, "fragment");
+  /* fragment offset of 8 bytes in the IP header behind the tag */
+  frame->data[18 + 7] = 1;
+  pcap_add (capture, 2, 600000, frame);
+  pcap_add (capture, 3, 1, make_udp_frame (&flow_a, 2, "qinq"));
+
+  fail_unless_equals_int (push_capture (pcapparse, capture), GST_FLOW_OK);
+  check_payloads (buffers, payloads, timestamps);
+
+  cleanup_pcapparse (pcapparse, bus);
+}
+
+GST_END_TEST;
+
+/* IPv6 with extension headers, and an IPv6 dst-ip restriction */
+GST_START_TEST (test_ipv6)
+{
+  static const gchar *payloads[] = { "plain", "hopopts", "fragment", NULL };
+  /* hop-by-hop options of 8 bytes, then UDP */
+  static const guint8 hopopts[] = { IP_PROTO_UDP, 0, 1, 4, 0, 0, 0, 0 };
+  /* the first fragment, then one at offset 8 */
+  static const guint8 first[] = { IP_PROTO_UDP, 0, 0, 1, 0, 0, 0, 42 };
+  static const guint8 second[] = { IP_PROTO_UDP, 0, 0, 8, 0, 0, 0, 42 };
+  GstElement *pcapparse;
+  GByteArray *capture;
+  GstBus *bus;
+
+  pcapparse = setup_pcapparse (FALSE, &bus);
+  g_object_set (pcapparse, "dst-ip", "2001:db8::2", NULL);
+
+  capture = pcap_new ();
+  pcap_add (capture, 1, 0, make_udp_frame (&flow_c, 0, "plain"));
+  pcap_add (capture, 1, 1, make_udp_frame (&flow_d, 0, "other"));
+  pcap_add (capture, 1, 2, make_frame (&flow_c, 1, IP_PROTO_HOPOPTS,
+          hopopts, sizeof (hopopts), "hopopts"));
+  pcap_add (capture, 1, 3, make_frame (&flow_c, 0, IP_PROTO_FRAGMENT,
+          first, sizeof (first), "fragment"));
+  pcap_add (capture, 1, 4, make_frame (&flow_c, 0, IP_PROTO_FRAGMENT,
+          second, sizeof (second), "second"));
+  pcap_add (capture, 1, 5, make_udp_frame (&flow_a, 0, "ipv4"));
+
+  fail_unless_equals_int (push_capture (pcapparse, capture), GST_FLOW_OK);
+  check_payloads (buffers, payloads, NULL);
+
+  cleanup_pcapparse (pcapparse, bus);
+}
+
+GST_END_TEST;
+
+/* interfaces with different timestamp resolutions, enhanced and simple
+ * packet blocks, and a second section in the other byte order */
+GST_START_TEST (test_pcapng)
+{
+  static const gchar *payloads[] = {
+    "nsec", "usec", "pow2", "simple", "swapped", NULL
+  };
+  static const GstClockTime timestamps[] = {
+    1234567891, 2 * GST_SECOND + 500 * GST_MSECOND,
+    3 * GST_SECOND + 500 * GST_MSECOND, GST_CLOCK_TIME_NONE, 4 * GST_SECOND
+  };
+  GstElement *pcapparse;
+  GByteArray *capture, *body;
+  GstBus *bus;
+
+  pcapparse = setup_pcapparse (FALSE, &bus);
+
+  capture = g_byte_array_new ();
+  pcapng_add_shb (capture, FALSE);
+  /* nanoseconds, microseconds and 1/1024 seconds */
+  pcapng_add_idb (capture, 9, FALSE);
+  pcapng_add_idb (capture, 0, FALSE);
+  pcapng_add_idb (capture, 0x80 | 10, FALSE);
+  pcapng_add_epb (capture, 0, G_GUINT64_CONSTANT (1234567891),
+      make_udp_frame (&flow_a, 0, "nsec"), FALSE);
+  /* an unknown block and a packet of an unknown interface are skipped */
+  body = g_byte_array_new ();
+  put_zeros (body, 6);
+  pcapng_add_block (capture, 0x00000bad, body, FALSE);
+  pcapng_add_epb (capture, 3, 0, make_udp_frame (&flow_a, 0, "noif"), FALSE);
+  pcapng_add_epb (capture, 1, 2500000, make_udp_frame (&flow_a, 0, "usec"),
+      FALSE);
+  pcapng_add_epb (capture, 2, 3 * 1024 + 512, make_udp_frame (&flow_c, 1,
+          "pow2"), FALSE);
+  pcapng_add_spb (capture, make_udp_frame (&flow_a, 0, "simple"), FALSE);
+
+  /* the interfaces are numbered again in the new section */
+  pcapng_add_shb (capture, TRUE);
+  pcapng_add_idb (capture, 0, TRUE);
+  pcapng_add_epb (capture, 0, 4000000, make_udp_frame (&flow_a, 0,
+          "swapped"), TRUE);
+
+  fail_unless_equals_int (push_capture (pcapparse, capture), GST_FLOW_OK);
+  check_payloads (buffers, payloads, timestamps);
+
+  cleanup_pcapparse (pcapparse, bus);
+}
+
+GST_END_TEST;
+
+/* a pad and an element message for each flow */
+GST_START_TEST (test_multi_flow)
+{
+  static const gchar *payloads_a[] = { "a1", "a2", "a3", NULL };
+  static const gchar *payloads_b[] = { "b1", "b2", NULL };
+  static const gchar *payloads_c[] = { "c1", NULL };
+  static const gchar *names[] = { "src_0", "src_1", "src_2" };
+  GstElement *pcapparse;
+  GByteArray *capture;
+  const GstStructure *s;
+  GstMessage *msg;
+  GstBus *bus;
+  FlowSink *sink;
+  gint port;
+  guint i;
+
+  pcapparse = setup_pcapparse (TRUE, &bus);
+  g_signal_connect (pcapparse, "pad-added", G_CALLBACK (pad_added_cb), NULL);
+
+  capture = pcap_new ();
+  pcap_add (capture, 1, 0, make_udp_frame (&flow_a, 0, "a1"));
+  pcap_add (capture, 1, 1, make_udp_frame (&flow_b, 1, "b1"));
+  pcap_add (capture, 1, 2, make_udp_frame (&flow_a, 0, "a2"));
+  pcap_add (capture, 1, 3, make_udp_frame (&flow_c, 0, "c1"));
+  pcap_add (capture, 1, 4, make_udp_frame (&flow_b, 1, "b2"));
+  pcap_add (capture, 1, 5, make_udp_frame (&flow_a, 0, "a3"));
+
+  fail_unless_equals_int (push_capture (pcapparse, capture), GST_FLOW_OK);
+
+  fail_unless (buffers == NULL, "payload on the src pad");
+  fail_unless_equals_int (flow_sinks->len, 3);
+  for (i = 0; i < flow_sinks->len; i++) {
+    sink = g_ptr_array_index (flow_sinks, i);
+    fail_unless_equals_string (GST_PAD_NAME (sink->pad), names[i]);
+  }
+  check_payloads (((FlowSink *) g_ptr_array_index (flow_sinks, 0))->buffers,
+      payloads_a, NULL);
+  check_payloads (((FlowSink *) g_ptr_array_index (flow_sinks, 1))->buffers,
+      payloads_b, NULL);
+  check_payloads (((FlowSink *) g_ptr_array_index (flow_sinks, 2))->buffers,
+      payloads_c, NULL);
+
+  for (i = 0; i < 3; i++) {
+    msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ELEMENT);
+    fail_unless (msg != NULL, "no message for %s", names[i]);
+    s = gst_message_get_structure (msg);
+    fail_unless (gst_structure_has_name (s, "pcapparse-flow"));
+    fail_unless_equals_string (gst_structure_get_string (s, "pad"), names[i]);
+    if (i == 2) {
+      fail_unless_equals_string (gst_structure_get_string (s, "src-ip"),
+          flow_c.src);
+      fail_unless_equals_string (gst_structure_get_string (s, "dst-ip"),
+          flow_c.dst);
+      fail_unless (gst_structure_get_int (s, "dst-port", &port));
+      fail_unless_equals_int (port, flow_c.dst_port);
+    } else {
+      fail_unless (gst_structure_get_int (s, "src-port", &port));
+      fail_unless_equals_int (port, i == 0 ? flow_a.src_port :
+          flow_b.src_port);
+    }
+    gst_message_unref (msg);
+  }
+
+  cleanup_pcapparse (pcapparse, bus);
+}
+
+GST_END_TEST;
+
+/* an absurd length is an error right away instead of data to wait for */
+GST_START_TEST (test_invalid_length)
+{
+  GstElement *pcapparse;
+  GByteArray *capture;
+  GstMessage *msg;
+  GstBus *bus;
+
+  pcapparse = setup_pcapparse (FALSE, &bus);
+  capture = g_byte_array_new ();
+  pcapng_add_shb (capture, FALSE);
+  put_u32 (capture, PCAPNG_BLOCK_EPB, FALSE);
+  put_u32 (capture, 0x40000000, FALSE);
+  put_zeros (capture, 16);
+  fail_unless_equals_int (push_capture (pcapparse, capture), GST_FLOW_ERROR);
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL);
+  gst_message_unref (msg);
+  cleanup_pcapparse (pcapparse, bus);
+
+  pcapparse = setup_pcapparse (FALSE, &bus);
+  capture = pcap_new ();
+  put_zeros (capture, 8);
+  put_u32 (capture, 0x7fffffff, FALSE);
+  put_u32 (capture, 0x7fffffff, FALSE);
+  put_zeros (capture, 16);
+  fail_unless_equals_int (push_capture (pcapparse, capture), GST_FLOW_ERROR);
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+  fail_unless (msg != NULL);
+  gst_message_unref (msg);
+  cleanup_pcapparse (pcapparse, bus);
+}
+
+GST_END_TEST;
+
+/* the packets within batch-time are pushed as one list, with the capture
+ * times scaled by the speed as timestamps, and the last batch goes out on
+ * EOS */
+GST_START_TEST (test_replay)
+{
+  static const gchar *payloads_1[] = { "p1", "p2", NULL };
+  static const gchar *payloads_2[] = { "p3", "p4", NULL };
+  static const gchar *payloads_3[] = { "p5", NULL };
+  static const GstClockTime timestamps_1[] = { 0, 250 * GST_USECOND };
+  static const GstClockTime timestamps_2[] = {
+    1500 * GST_USECOND, 1600 * GST_USECOND
+  };
+  static const GstClockTime timestamps_3[] = { 5 * GST_MSECOND };
+  GstElement *pcapparse;
+  GByteArray *capture;
+  GstClock *clock;
+  GstClockTime start;
+  GstBus *bus;
+  gdouble target_rate, achieved_rate;
+  guint64 lateness;
+
+  pcapparse = setup_replay (2.0, FALSE, &bus);
+
+  g_object_get (pcapparse, "target-rate", &target_rate, "achieved-rate",
+      &achieved_rate, "mean-lateness", &lateness, NULL);
+  fail_unless (target_rate == 0.0);
+  fail_unless (achieved_rate == 0.0);
+  fail_unless_equals_uint64 (lateness, 0);
+
+  capture = pcap_new ();
+  pcap_add (capture, 10, 0, make_udp_frame (&flow_a, 0, "p1"));
+  pcap_add (capture, 10, 500, make_udp_frame (&flow_a, 0, "p2"));
+  pcap_add (capture, 10, 3000, make_udp_frame (&flow_a, 0, "p3"));
+  pcap_add (capture, 10, 3200, make_udp_frame (&flow_a, 0, "p4"));
+  pcap_add (capture, 10, 10000, make_udp_frame (&flow_a, 0, "p5"));
+
+  clock = gst_system_clock_obtain ();
+  start = gst_clock_get_time (clock);
+
+  /* the last batch waits for a packet outside of its window */
+  fail_unless_equals_int (push_capture (pcapparse, capture), GST_FLOW_OK);
+  fail_unless (buffers == NULL, "buffer pushed outside of a list");
+  fail_unless_equals_int (g_list_length (lists), 2);
+  check_list (lists->data, payloads_1, timestamps_1);
+  check_list (lists->next->data, payloads_2, timestamps_2);
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  fail_unless_equals_int (g_list_length (lists), 3);
+  fail_unless_equals_int (lists_at_eos, 3);
+  check_list (lists->next->next->data, payloads_3, timestamps_3);
+
+  /* the first batch is due right away, the last one 5ms later */
+  fail_unless (gst_clock_get_time (clock) - start >= 5 * GST_MSECOND);
+  gst_object_unref (clock);
+
+  /* 4 packets before the last batch, which starts at 5ms */
+  g_object_get (pcapparse, "target-rate", &target_rate, "achieved-rate",
+      &achieved_rate, "mean-lateness", &lateness, NULL);
+  fail_unless (target_rate == 800.0, "target rate %f", target_rate);
+  fail_unless (achieved_rate > 0.0 && achieved_rate <= target_rate,
+      "achieved rate %f", achieved_rate);
+  fail_unless (lateness < GST_SECOND);
+
+  cleanup_pcapparse (pcapparse, bus);
+}
+
+GST_END_TEST;
+
+/* in pull mode the capture starts over, and the running time continues one
+ * batch-time after the last packet */
+GST_START_TEST (test_replay_loop)
+{
+  static const gchar *payloads_1[] = { "l1", NULL };
+  static const gchar *payloads_2[] = { "l2", NULL };
+  static const GstClockTime timestamps[] = {
+    0, 2 * GST_MSECOND, 3 * GST_MSECOND, 5 * GST_MSECOND, 6 * GST_MSECOND,
+    8 * GST_MSECOND
+  };
+  GstElement *pcapparse;
+  GList *l;
+  GstBus *bus;
+  guint i;
+
+  pcapparse = setup_replay (2.0, TRUE, &bus);
+
+  pull_capture = pcap_new ();
+  pcap_add (pull_capture, 10, 0, make_udp_frame (&flow_a, 0, "l1"));
+  pcap_add (pull_capture, 10, 4000, make_udp_frame (&flow_a, 0, "l2"));
+  gst_pad_set_getrange_function (mysrcpad, pull_getrange);
+
+  fail_unless (gst_element_set_state (pcapparse,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  g_mutex_lock (check_mutex);
+  while (g_list_length (lists) < G_N_ELEMENTS (timestamps))
+    g_cond_wait (check_cond, check_mutex);
+  g_mutex_unlock (check_mutex);
+
+  fail_unless (gst_element_set_state (pcapparse,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+  fail_unless_equals_int (lists_at_eos, -1);
+
+  for (i = 0, l = lists; i < G_N_ELEMENTS (timestamps); i++, l = l->next)
+    check_list (l->data, i % 2 ? payloads_2 : payloads_1, &timestamps[i]);
+
+  cleanup_pcapparse (pcapparse, bus);
+}
+
+GST_END_TEST;
+
+static Suite *
+pcapparse_suite (void)
+{
+  Suite *s = suite_create ("pcapparse");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_vlan);
+  tcase_add_test (tc_chain, test_ipv6);
+  tcase_add_test (tc_chain, test_pcapng);
+  tcase_add_test (tc_chain, test_multi_flow);
+  tcase_add_test (tc_chain, test_invalid_length);
+  tcase_add_test (tc_chain, test_replay);
+  tcase_add_test (tc_chain, test_replay_loop);
+
+  return s;
+}
+
+GST_CHECK_MAIN (pcapparse);
@@ -0,0 +1,624 @@
+/* GStreamer
+ *
+ * unit test for the rfb decoder
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <zlib.h>
+
+#include <gst/check/gstcheck.h>
+
+#include "rfbdecoder.h"
+
+/* belongs to rfbsrc, which is not linked in */
+GST_DEBUG_CATEGORY (rfbdecoder_debug);
+
+/* not a multiple of the 64 pixel ZRLE tiles */
+#define WIDTH 80
+#define HEIGHT 70
+
+/* The server side of the connection is played by the test: it writes the
+ * messages of a whole update to the socket before the decoder reads them.
+ * The pixel format is 32 bit little endian 0x00RRGGBB, for which ZRLE sends
+ * 3 byte pixels and Tight sends RGB triplets. */
+typedef struct
+{
+  RfbDecoder *decoder;
+  gint server;
+  GByteArray *msg;
+  z_stream zstream[5];
+} RfbTest;
+
+#define ZRLE_STREAM 4
+
+static void
+put_u8 (RfbTest * t, guint v)
+{
+  guint8 b = v;
+
+  g_byte_array_append (t->msg, &b, 1);
+}
+
+static void
+put_u16 (RfbTest * t, guint v)
+{
+  put_u8 (t, v >> 8);
+  put_u8 (t, v);
+}
+
+static void
+put_u32 (RfbTest * t, guint32 v)
+{
+  put_u16 (t, v >> 16);
+  put_u16 (t, v);
+}
+
+static void
+put_data (RfbTest * t, const guint8 * data, guint len)
+{
+  g_byte_array_append (t->msg, data, len);
+}
+
+static void
+send_msg (RfbTest * t)
+{
+  fail_unless_equals_int (write (t->server, t->msg->data, t->msg->len),
+      t->msg->len);
+  g_byte_array_set_size (t->msg, 0);
+}
+
+static void
+setup_rfb (RfbTest * t)
+{
+  static const guint8 pixel_format[16] = {
+    32, 24, 0, 1, 0, 255, 0, 255, 0, 255, 16, 8, 0, 0, 0, 0
+  };
+  RfbDecoder *decoder;
+  gint sv[2], i;
+
+  fail_unless (socketpair (AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+  t->server = sv[1];
+  t->msg = g_byte_array_new ();
+  for (i = 0; i < G_N_ELEMENTS (t->zstream); i++) {
+    memset (&t->zstream[i], 0, sizeof (z_stream));
+    fail_unless (deflateInit (&t->zstream[i], Z_DEFAULT_COMPRESSION) == Z_OK);
+  }
+
+  t->decoder = decoder = rfb_decoder_new ();
+  rfb_decoder_use_file_descriptor (decoder, sv[0]);
+
+  /* version 3.3 without security, then the server initialisation */
+  put_data (t, (const guint8 *) "RFB 003.003\n", 12);
+  put_u32 (t, SECURITY_NONE);
+  put_u16 (t, WIDTH);
+  put_u16 (t, HEIGHT);
+  put_data (t, pixel_format, sizeof (pixel_format));
+  put_u32 (t, 4);
+  put_data (t, (const guint8 *) "test", 4);
+  send_msg (t);
+
+  while (!decoder->inited)
+    fail_unless (rfb_decoder_iterate (decoder));
+  fail_unless_equals_string (decoder->name, "test");
+  fail_unless_equals_int (decoder->cpixel_size, 3);
+  fail_unless (decoder->tight_rgb);
+
+  /* what rfbsrc does once connected */
+  decoder->rect_width = decoder->width;
+  decoder->rect_height = decoder->height;
+  decoder->bytespp = decoder->bpp / 8;
+  decoder->line_size = decoder->rect_width * decoder->bytespp;
+  decoder->frame = g_malloc0 (decoder->line_size * decoder->rect_height);
+}
+
+static void
+cleanup_rfb (RfbTest * t)
+{
+  gint i;
+
+  g_free (t->decoder->frame);
+  rfb_decoder_free (t->decoder);
+  g_free (t->decoder);
+  close (t->server);
+  g_byte_array_free (t->msg, TRUE);
+  for (i = 0; i < G_N_ELEMENTS (t->zstream); i++)
+    deflateEnd (&t->zstream[i]);
+}
+
+/* the frame update header and the header of its rectangles */
+static void
+put_update (RfbTest * t, guint n_rects)
+{
+  put_u8 (t, MESSAGE_TYPE_FRAMEBUFFER_UPDATE);
+  put_u8 (t, 0);
+  put_u16 (t, n_rects);
+}
+
+static void
+put_rect (RfbTest * t, gint x, gint y, gint w, gint h, gint encoding)
+{
+  put_u16 (t, x);
+  put_u16 (t, y);
+  put_u16 (t, w);
+  put_u16 (t, h);
+  put_u32 (t, encoding);
+}
+
+/* compresses @data with stream @idx, flushed like the servers do at the end
+ * of every rectangle */
+static GByteArray *
+deflate_data (RfbTest * t, gint idx, const guint8 * data, guint len)
+{
+  z_stream *z = &t->zstream[idx];
+  GByteArray *out = g_byte_array_new ();
+  guint8 buf[4096];
+
+  z->next_in = (guint8 *) data;
+  z->avail_in = len;
+  do {
+    z->next_out = buf;
+    z->avail_out = sizeof (buf);
+    fail_unless (deflate (z, Z_SYNC_FLUSH) == Z_OK);
+    g_byte_array_append (out, buf, sizeof (buf) - z->avail_out);
+  } while (z->avail_out == 0);
+
+  return out;
+}
+
+/* colour of pixel x,y of the test image */
+static guint32
+image_pixel (gint x, gint y)
+{
+  return ((x * 3) << 16) | ((y * 3) << 8) | ((x + y) & 0xff);
+}
+
+static void
+put_rgb (GByteArray * a, guint32 pixel)
+{
+  guint8 rgb[3] = { pixel >> 16, pixel >> 8, pixel };
+
+  g_byte_array_append (a, rgb, 3);
+}
+
+/* ZRLE sends the 3 low bytes of the little endian pixels */
+static void
+put_cpixel (GByteArray * a, guint32 pixel)
+{
+  guint8 cpixel[3] = { pixel, pixel >> 8, pixel >> 16 };
+
+  g_byte_array_append (a, cpixel, 3);
+}
+
+static void
+put_run (GByteArray * a, guint len)
+{
+  guint8 b = 255;
+
+  for (len -= 1; len >= 255; len -= 255)
+    g_byte_array_append (a, &b, 1);
+  b = len;
+  g_byte_array_append (a, &b, 1);
+}
+
+static guint32
+frame_pixel (RfbTest * t, gint x, gint y)
+{
+  return GST_READ_UINT32_LE (t->decoder->frame +
+      (y * t->decoder->rect_width + x) * 4);
+}
+
+static void
+read_update (RfbTest * t, guint n_rects)
+{
+  send_msg (t);
+  fail_unless (rfb_decoder_read_update (t->decoder));
+  fail_unless_equals_int (t->decoder->damage->len, n_rects);
+}
+
+static void
+read_bad_update (RfbTest * t)
+{
+  send_msg (t);
+  fail_if (rfb_decoder_read_update (t->decoder));
+  fail_unless (t->decoder->disconnected);
+}
+
+/* the four 64x64, 16x64, 64x6 and 16x6 tiles of the frame are sent as raw,
+ * packed palette, plain RLE and palette RLE, and a solid rectangle follows
+ * in a second update that continues the zlib stream */
+GST_START_TEST (test_zrle)
+{
+  static const guint32 colors[3] = { 0x102030, 0xa0b0c0, 0xffeedd };
+  RfbTest t;
+  GByteArray *tiles, *z;
+  gint x, y, i;
+
+  setup_rfb (&t);
+  tiles = g_byte_array_new ();
+
+  /* raw */
+  g_byte_array_append (tiles, (const guint8 *) "\000", 1);
+  for (y = 0; y < 64; y++)
+    for (x = 0; x < 64; x++)
+      put_cpixel (tiles, image_pixel (x, y));
+
+  /* packed palette of 2 colours, one bit per pixel */
+  g_byte_array_append (tiles, (const guint8 *) "\002", 1);
+  put_cpixel (tiles, colors[0]);
+  put_cpixel (tiles, colors[1]);
+  for (y = 0; y < 64; y++) {
+    guint8 row[2] = { 0xf0 ^ (y & 1 ? 0xff : 0), 0x3c };
+
+    g_byte_array_append (tiles, row, 2);
+  }
+
+  /* plain RLE, the first run is longer than 255 pixels */
+  g_byte_array_append (tiles, (const guint8 *) "\200", 1);
+  put_cpixel (tiles, colors[1]);
+  put_run (tiles, 300);
+  put_cpixel (tiles, colors[2]);
+  put_run (tiles, 64 * 6 - 300);
+
+  /* palette RLE: a run of 10 then single pixels */
+  g_byte_array_append (tiles, (const guint8 *) "\203", 1);
+  for (i = 0; i < 3; i++)
+    put_cpixel (tiles, colors[i]);
+  g_byte_array_append (tiles, (const guint8 *) "\200", 1);
+  put_run (tiles, 10);
+  for (i = 10; i < 16 * 6; i++) {
+    guint8 idx = 1 + (i & 1);
+
+    g_byte_array_append (tiles, &idx, 1);
+  }
+
+  z = deflate_data (&t, ZRLE_STREAM, tiles->data, tiles->len);
+  put_update (&t, 1);
+  put_rect (&t, 0, 0, WIDTH, HEIGHT, ENCODING_TYPE_ZRLE);
+  put_u32 (&t, z->len);
+  put_data (&t, z->data, z->len);
+  read_update (&t, 1);
+  g_byte_array_free (z, TRUE);
+
+  for (y = 0; y < 64; y++)
+    for (x = 0; x < 64; x++)
+      fail_unless_equals_int (frame_pixel (&t, x, y), image_pixel (x, y));
+  for (y = 0; y < 64; y++) {
+    for (x = 0; x < 16; x++) {
+      guint8 bits = x < 8 ? 0xf0 ^ (y & 1 ? 0xff : 0) : 0x3c;
+      gint bit = (bits >> (7 - x % 8)) & 1;
+
+      fail_unless_equals_int (frame_pixel (&t, 64 + x, y), colors[bit]);
+    }
+  }
+  for (i = 0; i < 64 * 6; i++)
+    fail_unless_equals_int (frame_pixel (&t, i % 64, 64 + i / 64),
+        colors[i < 300 ? 1 : 2]);
+  for (i = 0; i < 16 * 6; i++)
+    fail_unless_equals_int (frame_pixel (&t, 64 + i % 16, 64 + i / 16),
+        colors[i < 10 ? 0 : 1 + (i & 1)]);
+
+  /* solid */
+  g_byte_array_set_size (tiles, 0);
+  g_byte_array_append (tiles, (const guint8 *) "\001", 1);
+  put_cpixel (tiles, colors[2]);
+  z = deflate_data (&t, ZRLE_STREAM, tiles->data, tiles->len);
+  put_update (&t, 1);
+  put_rect (&t, 8, 8, 10, 10, ENCODING_TYPE_ZRLE);
+  put_u32 (&t, z->len);
+  put_data (&t, z->data, z->len);
+  read_update (&t, 1);
+  g_byte_array_free (z, TRUE);
+
+  for (y = 0; y < 20; y++)
+    for (x = 0; x < 20; x++)
+      fail_unless_equals_int (frame_pixel (&t, x, y),
+          x >= 8 && x < 18 && y >= 8 && y < 18 ? colors[2] : image_pixel (x,
+              y));
+
+  g_byte_array_free (tiles, TRUE);
+  cleanup_rfb (&t);
+}
+
+GST_END_TEST;
+
+static void
+put_tight_length (RfbTest * t, guint len)
+{
+  put_u8 (t, (len & 0x7f) | (len > 0x7f ? 0x80 : 0));
+  if (len > 0x7f) {
+    put_u8 (t, ((len >> 7) & 0x7f) | (len > 0x3fff ? 0x80 : 0));
+    if (len > 0x3fff)
+      put_u8 (t, len >> 14);
+  }
+}
+
+static void
+put_tight_data (RfbTest * t, gint stream, GByteArray * data)
+{
+  GByteArray *z;
+
+  if (data->len < 12) {
+    put_data (t, data->data, data->len);
+    return;
+  }
+
+  z = deflate_data (t, stream, data->data, data->len);
+  put_tight_length (t, z->len);
+  put_data (t, z->data, z->len);
+  g_byte_array_free (z, TRUE);
+}
+
+/* encodes rows @y0 to @y0 + @h - 1 of the image with the gradient filter */
+static void
+put_gradient (GByteArray * a, gint y0, gint h)
+{
+  guint8 prev[WIDTH * 3], cur[WIDTH * 3];
+  gint x, y, c, est;
+
+  memset (prev, 0, sizeof (prev));
+  for (y = 0; y < h; y++) {
+    for (x = 0; x < WIDTH; x++) {
+      guint32 pixel = image_pixel (x, y0 + y);
+
+      for (c = 0; c < 3; c++) {
+        guint8 d;
+
+        cur[x * 3 + c] = pixel >> (16 - 8 * c);
+        if (x == 0) {
+          est = prev[c];
+        } else {
+          est = prev[x * 3 + c] + cur[(x - 1) * 3 + c] - prev[(x - 1) * 3 + c];
+          est = CLAMP (est, 0, 255);
+        }
+        d = cur[x * 3 + c] - est;
+        g_byte_array_append (a, &d, 1);
+      }
+    }
+    memcpy (prev, cur, sizeof (prev));
+  }
+}
+
+/* a fill, then bands with the copy, palette and gradient filters, each
+ * with its own zlib stream, and a rectangle too small to be compressed */
+GST_START_TEST (test_tight)
+{
+  static const guint32 colors[2] = { 0x405060, 0xc0d0e0 };
+  RfbTest t;
+  GByteArray *data;
+  gint x, y;
+
+  setup_rfb (&t);
+  data = g_byte_array_new ();
+
+  put_update (&t, 5);
+
+  put_rect (&t, 0, 0, WIDTH, HEIGHT, ENCODING_TYPE_TIGHT);
+  put_u8 (&t, 0x80);
+  put_rgb (t.msg, 0x123456);
+
+  /* copy filter, stream 0 */
+  put_rect (&t, 0, 0, WIDTH, 20, ENCODING_TYPE_TIGHT);
+  put_u8 (&t, 0x00);
+  for (y = 0; y < 20; y++)
+    for (x = 0; x < WIDTH; x++)
+      put_rgb (data, image_pixel (x, y));
+  put_tight_data (&t, 0, data);
+
+  /* palette of 2 colours, stream 1 */
+  put_rect (&t, 0, 20, WIDTH, 20, ENCODING_TYPE_TIGHT);
+  put_u8 (&t, 0x50);
+  put_u8 (&t, 1);
+  put_u8 (&t, 1);
+  put_rgb (t.msg, colors[0]);
+  put_rgb (t.msg, colors[1]);
+  g_byte_array_set_size (data, 0);
+  for (y = 0; y < 20; y++) {
+    for (x = 0; x < WIDTH / 8; x++) {
+      guint8 b = (x + y) & 1 ? 0x0f : 0xf0;
+
+      g_byte_array_append (data, &b, 1);
+    }
+  }
+  put_tight_data (&t, 1, data);
+
+  /* gradient, stream 2 */
+  put_rect (&t, 0, 40, WIDTH, 20, ENCODING_TYPE_TIGHT);
+  put_u8 (&t, 0x60);
+  put_u8 (&t, 2);
+  g_byte_array_set_size (data, 0);
+  put_gradient (data, 40, 20);
+  put_tight_data (&t, 2, data);
+
+  /* 6 bytes are sent uncompressed */
+  put_rect (&t, 10, 65, 2, 1, ENCODING_TYPE_TIGHT);
+  put_u8 (&t, 0x00);
+  g_byte_array_set_size (data, 0);
+  put_rgb (data, colors[0]);
+  put_rgb (data, colors[1]);
+  put_tight_data (&t, 0, data);
+
+  read_update (&t, 5);
+
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++) {
+      guint32 expected;
+
+      if (y < 20 || (y >= 40 && y < 60))
+        expected = image_pixel (x, y);
+      else if (y < 40)
+        expected = colors[(((x / 8) + y) & 1) ^ ((x % 8) < 4)];
+      else if (y == 65 && x == 10)
+        expected = colors[0];
+      else if (y == 65 && x == 11)
+        expected = colors[1];
+      else
+        expected = 0x123456;
+      fail_unless (frame_pixel (&t, x, y) == expected,
+          "%d,%d: %06x != %06x", x, y, frame_pixel (&t, x, y), expected);
+    }
+  }
+
+  /* resetting stream 0 starts a new zlib stream */
+  fail_unless (deflateReset (&t.zstream[0]) == Z_OK);
+  put_update (&t, 1);
+  put_rect (&t, 0, 0, WIDTH, 20, ENCODING_TYPE_TIGHT);
+  put_u8 (&t, 0x01);
+  g_byte_array_set_size (data, 0);
+  for (y = 0; y < 20; y++)
+    for (x = 0; x < WIDTH; x++)
+      put_rgb (data, colors[1]);
+  put_tight_data (&t, 0, data);
+  read_update (&t, 1);
+  for (y = 0; y < 20; y++)
+    for (x = 0; x < WIDTH; x++)
+      fail_unless_equals_int (frame_pixel (&t, x, y), colors[1]);
+
+  g_byte_array_free (data, TRUE);
+  cleanup_rfb (&t);
+}
+
+GST_END_TEST;
+
+/* a length that no rectangle can need is refused before it is read */
+GST_START_TEST (test_zrle_length)
+{
+  RfbTest t;
+
+  setup_rfb (&t);
+  put_update (&t, 1);
+  put_rect (&t, 0, 0, 8, 8, ENCODING_TYPE_ZRLE);
+  put_u32 (&t, 0xffffffff);
+  read_bad_update (&t);
+  fail_unless (t.decoder->recv_size < 1024 * 1024);
+  cleanup_rfb (&t);
+}
+
+GST_END_TEST;
+
+/* zeros compress well enough to pass the length check of an 8x8 rectangle
+ * but inflate to far more than it can need */
+GST_START_TEST (test_zrle_bomb)
+{
+  RfbTest t;
+  guint8 *zeros;
+  GByteArray *z;
+
+  setup_rfb (&t);
+  zeros = g_malloc0 (256 * 1024);
+  z = deflate_data (&t, ZRLE_STREAM, zeros, 256 * 1024);
+  g_free (zeros);
+
+  put_update (&t, 1);
+  put_rect (&t, 0, 0, 8, 8, ENCODING_TYPE_ZRLE);
+  put_u32 (&t, z->len);
+  put_data (&t, z->data, z->len);
+  read_bad_update (&t);
+  fail_unless (t.decoder->zbuf_size < 64 * 1024);
+
+  g_byte_array_free (z, TRUE);
+  cleanup_rfb (&t);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_cut_text_length)
+{
+  RfbTest t;
+
+  setup_rfb (&t);
+  put_u8 (&t, 3);
+  put_u8 (&t, 0);
+  put_u16 (&t, 0);
+  put_u32 (&t, 0x80000000);
+  read_bad_update (&t);
+  cleanup_rfb (&t);
+}
+
+GST_END_TEST;
+
+/* sub-rectangles reaching out of their rectangle or tile are refused */
+GST_START_TEST (test_subrect_outside)
+{
+  RfbTest t;
+
+  setup_rfb (&t);
+  put_update (&t, 1);
+  put_rect (&t, 0, 0, 16, 16, ENCODING_TYPE_RRE);
+  put_u32 (&t, 1);
+  put_u32 (&t, 0);
+  put_u32 (&t, 0xffffffff);
+  put_u16 (&t, 10);
+  put_u16 (&t, 10);
+  put_u16 (&t, 7);
+  put_u16 (&t, 2);
+  read_bad_update (&t);
+  cleanup_rfb (&t);
+
+  setup_rfb (&t);
+  put_update (&t, 1);
+  put_rect (&t, 0, 0, 16, 16, ENCODING_TYPE_CORRE);
+  put_u32 (&t, 1);
+  put_u32 (&t, 0);
+  put_u32 (&t, 0xffffffff);
+  put_u8 (&t, 200);
+  put_u8 (&t, 0);
+  put_u8 (&t, 1);
+  put_u8 (&t, 1);
+  read_bad_update (&t);
+  cleanup_rfb (&t);
+
+  /* the last tile of a 20 pixel wide rectangle is 4 pixels wide */
+  setup_rfb (&t);
+  put_update (&t, 1);
+  put_rect (&t, WIDTH - 20, HEIGHT - 16, 20, 16, ENCODING_TYPE_HEXTILE);
+  put_u8 (&t, SUBENCODING_BACKGROUND);
+  put_u32 (&t, 0);
+  put_u8 (&t, SUBENCODING_FOREGROUND | SUBENCODING_ANYSUBRECTS);
+  put_u32 (&t, 0xffffffff);
+  put_u8 (&t, 1);
+  put_u8 (&t, 0x30);
+  put_u8 (&t, 0x10);
+  read_bad_update (&t);
+  cleanup_rfb (&t);
+}
+
+GST_END_TEST;
+
+static Suite *
+rfbdecoder_suite (void)
+{
+  Suite *s = suite_create ("rfbdecoder");
+  TCase *tc_chain = tcase_create ("general");
+
+  GST_DEBUG_CATEGORY_INIT (rfbdecoder_debug, "rfbdecoder", 0, "rfb decoder");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_zrle);
+  tcase_add_test (tc_chain, test_tight);
+  tcase_add_test (tc_chain, test_zrle_length);
+  tcase_add_test (tc_chain, test_zrle_bomb);
+  tcase_add_test (tc_chain, test_cut_text_length);
+  tcase_add_test (tc_chain, test_subrect_outside);
+
+  return s;
+}
+
+GST_CHECK_MAIN (rfbdecoder);
@@ -0,0 +1,502 @@
+/* GStreamer
+ *
+ * unit test for rfbsrc
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define WIDTH 32
+#define HEIGHT 16
+#define BPP 4
+
+static GstPad *mysinkpad;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+typedef struct
+{
+  gint x, y, w, h;
+} Rect;
+
+/* a local stand-in for a VNC server: once rfbsrc connected it sends the
+ * handshake, then the messages queued by the test, in order.  The requests
+ * of the client are not read, they are small enough to stay in the socket
+ * buffers. */
+static gint server_fd = -1;
+static guint server_port;
+static GThread *server_thread;
+static GAsyncQueue *server_queue;
+
+/* what the screen of the server looks like after the updates sent so far,
+ * 32 bit little endian 0x00RRGGBB pixels */
+static guint8 screen[WIDTH * HEIGHT * BPP];
+
+/* the rfb-damage events received, one in front of each buffer */
+static GList *damage_events;
+
+/* rfbsrc may have closed the connection already */
+static gboolean
+write_all (gint fd, const guint8 * data, gsize len)
+{
+  while (len > 0) {
+    gssize ret = send (fd, data, len, MSG_NOSIGNAL);
+
+    if (ret <= 0)
+      return FALSE;
+    data += ret;
+    len -= ret;
+  }
+  return TRUE;
+}
+
+static void
+put_u8 (GByteArray * msg, guint v)
+{
+  guint8 b = v;
+
+  g_byte_array_append (msg, &b, 1);
+}
+
+static void
+put_u16 (GByteArray * msg, guint v)
+{
+  put_u8 (msg, v >> 8);
+  put_u8 (msg, v);
+}
+
+static void
+put_u32 (GByteArray * msg, guint32 v)
+{
+  put_u16 (msg, v >> 16);
+  put_u16 (msg, v);
+}
+
+static gpointer
+server_func (gpointer data)
+{
+  static const guint8 pixel_format[16] = {
+    32, 24, 0, 1, 0, 255, 0, 255, 0, 255, 16, 8, 0, 0, 0, 0
+  };
+  GByteArray *msg;
+  gint fd;
+
+  fd = accept (server_fd, NULL, NULL);
+  if (fd < 0)
+    return NULL;
+
+  /* version 3.3 without security, then the server initialisation */
+  msg = g_byte_array_new ();
+  g_byte_array_append (msg, (const guint8 *) "RFB 003.003\n", 12);
+  put_u32 (msg, 1);
+  put_u16 (msg, WIDTH);
+  put_u16 (msg, HEIGHT);
+  g_byte_array_append (msg, pixel_format, sizeof (pixel_format));
+  put_u32 (msg, 4);
+  g_byte_array_append (msg, (const guint8 *) "test", 4);
+
+  /* an empty message stops the server */
+  while (msg->len > 0) {
+    write_all (fd, msg->data, msg->len);
+    g_byte_array_free (msg, TRUE);
+    msg = g_async_queue_pop (server_queue);
+  }
+  g_byte_array_free (msg, TRUE);
+
+  close (fd);
+  return NULL;
+}
+
+static void
+start_server (void)
+{
+  struct sockaddr_in addr;
+  socklen_t len = sizeof (addr);
+
+  server_queue = g_async_queue_new ();
+
+  server_fd = socket (AF_INET, SOCK_STREAM, 0);
+  fail_unless (server_fd >= 0);
+
+  memset (&addr, 0, sizeof (addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+  fail_unless (bind (server_fd, (struct sockaddr *) &addr, sizeof (addr)) == 0);
+  fail_unless (listen (server_fd, 1) == 0);
+  fail_unless (getsockname (server_fd, (struct sockaddr *) &addr, &len) == 0);
+  server_port = ntohs (addr.sin_port);
+
+  server_thread = g_thread_create (server_func, NULL, TRUE, NULL);
+}
+
+static void
+stop_server (void)
+{
+  g_async_queue_push (server_queue, g_byte_array_new ());
+  shutdown (server_fd, SHUT_RDWR);
+  g_thread_join (server_thread);
+  close (server_fd);
+  g_async_queue_unref (server_queue);
+}
+
+/* colour of pixel x,y after update @gen */
+static guint32
+screen_pixel (gint x, gint y, guint gen)
+{
+  return ((x * 7 + gen * 50) << 16) | ((y * 13) << 8) | (gen & 0xff);
+}
+
+/* sends a framebuffer update with the raw encoded @rects, filled with the
+ * colours of update @gen */
+static void
+send_update (const Rect * rects, guint n_rects, guint gen)
+{
+  GByteArray *msg = g_byte_array_new ();
+  guint i;
+  gint x, y;
+
+  put_u8 (msg, 0);
+  put_u8 (msg, 0);
+  put_u16 (msg, n_rects);
+  for (i = 0; i < n_rects; i++) {
+    const Rect *r = &rects[i];
+
+    put_u16 (msg, r->x);
+    put_u16 (msg, r->y);
+    put_u16 (msg, r->w);
+    put_u16 (msg, r->h);
+    put_u32 (msg, 0);
+    for (y = r->y; y < r->y + r->h; y++) {
+      for (x = r->x; x < r->x + r->w; x++) {
+        guint8 *p = screen + (y * WIDTH + x) * BPP;
+
+        GST_WRITE_UINT32_LE (p, screen_pixel (x, y, gen));
+        g_byte_array_append (msg, p, BPP);
+      }
+    }
+  }
+
+  g_async_queue_push (server_queue, msg);
+}
+
+static gboolean
+sink_event (GstPad * pad, GstEvent * event)
+{
+  if (GST_EVENT_TYPE (event) == GST_EVENT_CUSTOM_DOWNSTREAM &&
+      gst_structure_has_name (gst_event_get_structure (event), "rfb-damage")) {
+    g_mutex_lock (check_mutex);
+    damage_events = g_list_append (damage_events, gst_event_ref (event));
+    g_mutex_unlock (check_mutex);
+  }
+  gst_event_unref (event);
+
+  return TRUE;
+}
+
+static GstElement *
+setup_rfbsrc (void)
+{
+  GstElement *rfbsrc;
+  GstClock *clock;
+
+  GST_DEBUG ("setup_rfbsrc");
+  memset (screen, 0, sizeof (screen));
+  start_server ();
+
+  rfbsrc = gst_check_setup_element ("rfbsrc");
+  g_object_set (rfbsrc, "host", "127.0.0.1", "port", server_port,
+      "damage-events", TRUE, NULL);
+
+  /* the buffers are timestamped with the running time of the clock */
+  clock = gst_system_clock_obtain ();
+  gst_element_set_clock (rfbsrc, clock);
+  gst_element_set_base_time (rfbsrc, gst_clock_get_time (clock));
+  gst_object_unref (clock);
+
+  mysinkpad = gst_check_setup_sink_pad (rfbsrc, &sinktemplate, NULL);
+  gst_pad_set_event_function (mysinkpad, sink_event);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  return rfbsrc;
+}
+
+static void
+start_rfbsrc (GstElement * rfbsrc)
+{
+  fail_unless (gst_element_set_state (rfbsrc,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE,
+      "could not set to playing");
+}
+
+static void
+cleanup_rfbsrc (GstElement * rfbsrc)
+{
+  GST_DEBUG ("cleanup_rfbsrc");
+
+  fail_unless (gst_element_set_state (rfbsrc,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+  gst_check_drop_buffers ();
+  g_list_foreach (damage_events, (GFunc) gst_mini_object_unref, NULL);
+  g_list_free (damage_events);
+  damage_events = NULL;
+
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_sink_pad (rfbsrc);
+  gst_check_teardown_element (rfbsrc);
+
+  stop_server ();
+}
+
+/* waits for the @n-th buffer, counting from 1, and returns it with the
+ * rfb-damage event that came in front of it */
+static GstBuffer *
+wait_for_buffer (guint n, GstEvent ** event)
+{
+  GstBuffer *buf;
+
+  g_mutex_lock (check_mutex);
+  while (g_list_length (buffers) < n)
+    g_cond_wait (check_cond, check_mutex);
+  buf = g_list_nth_data (buffers, n - 1);
+  fail_unless (g_list_length (damage_events) >= n, "no event for buffer %u",
+      n);
+  *event = g_list_nth_data (damage_events, n - 1);
+  g_mutex_unlock (check_mutex);
+
+  fail_unless_equals_int (GST_BUFFER_SIZE (buf), WIDTH * HEIGHT * BPP);
+
+  return buf;
+}
+
+/* checks that the @rect part of @data is the current screen */
+static void
+check_region (const guint8 * data, const Rect * rect)
+{
+  gint y;
+
+  for (y = rect->y; y < rect->y + rect->h; y++) {
+    gsize offset = (y * WIDTH + rect->x) * BPP;
+
+    fail_unless (memcmp (data + offset, screen + offset, rect->w * BPP) == 0,
+        "line %d of %d,%d %dx%d differs", y, rect->x, rect->y, rect->w,
+        rect->h);
+  }
+}
+
+static void
+check_frame (GstBuffer * buf)
+{
+  static const Rect all = { 0, 0, WIDTH, HEIGHT };
+
+  check_region (GST_BUFFER_DATA (buf), &all);
+}
+
+/* checks that @event is
+ *   rfb-damage, timestamp=(guint64)ts, rectangles=<<x, y, w, h>, ...>
+ * for @buf and @rects */
+static void
+check_damage (GstEvent * event, GstBuffer * buf, const Rect * rects,
+    guint n_rects)
+{
+  const GstStructure *s = gst_event_get_structure (event);
+  const GValue *list;
+  guint64 timestamp;
+  guint i;
+
+  fail_unless (gst_structure_get_uint64 (s, "timestamp", &timestamp));
+  fail_unless_equals_uint64 (timestamp, GST_BUFFER_TIMESTAMP (buf));
+
+  list = gst_structure_get_value (s, "rectangles");
+  fail_unless (list != NULL && GST_VALUE_HOLDS_ARRAY (list));
+  fail_unless_equals_int (gst_value_array_get_size (list), n_rects);
+  for (i = 0; i < n_rects; i++) {
+    const GValue *rect = gst_value_array_get_value (list, i);
+    const gint expected[4] = { rects[i].x, rects[i].y, rects[i].w,
+      rects[i].h
+    };
+    guint j;
+
+    fail_unless (GST_VALUE_HOLDS_ARRAY (rect));
+    fail_unless_equals_int (gst_value_array_get_size (rect), 4);
+    for (j = 0; j < 4; j++) {
+      const GValue *v = gst_value_array_get_value (rect, j);
+
+      fail_unless (G_VALUE_HOLDS_INT (v));
+      fail_unless_equals_int (g_value_get_int (v), expected[j]);
+    }
+  }
+}
+
+/* an update that changes nothing does not push a frame */
+GST_START_TEST (test_damage_only)
+{
+  static const Rect all = { 0, 0, WIDTH, HEIGHT };
+  static const Rect rects[] = { {4, 2, 8, 3}, {20, 10, 12, 6} };
+  GstElement *rfbsrc;
+  GstBuffer *buf;
+  GstEvent *event;
+
+  rfbsrc = setup_rfbsrc ();
+  start_rfbsrc (rfbsrc);
+
+  send_update (&all, 1, 1);
+  buf = wait_for_buffer (1, &event);
+  check_frame (buf);
+  check_damage (event, buf, &all, 1);
+
+  send_update (NULL, 0, 2);
+  send_update (rects, G_N_ELEMENTS (rects), 3);
+  buf = wait_for_buffer (2, &event);
+  check_frame (buf);
+  check_damage (event, buf, rects, G_N_ELEMENTS (rects));
+
+  g_mutex_lock (check_mutex);
+  fail_unless_equals_int (g_list_length (buffers), 2);
+  fail_unless_equals_int (g_list_length (damage_events), 2);
+  g_mutex_unlock (check_mutex);
+
+  cleanup_rfbsrc (rfbsrc);
+}
+
+GST_END_TEST;
+
+/* a frame that downstream released is reused for the next one, and only the
+ * damaged rectangles are copied into it */
+GST_START_TEST (test_reuse)
+{
+  static const Rect all = { 0, 0, WIDTH, HEIGHT };
+  static const Rect rect = { 8, 4, 10, 6 };
+  GstElement *rfbsrc;
+  GstBuffer *buf;
+  GstEvent *event;
+  guint8 *data, *last;
+
+  rfbsrc = setup_rfbsrc ();
+  start_rfbsrc (rfbsrc);
+
+  send_update (&all, 1, 1);
+  buf = wait_for_buffer (1, &event);
+  check_frame (buf);
+
+  /* outside of the next damage, it stays if the frame is not copied whole */
+  data = GST_BUFFER_DATA (buf);
+  last = data + (WIDTH * HEIGHT - 1) * BPP;
+  memset (last, 0xaa, BPP);
+
+  /* rfbsrc still holds the memory of the frame */
+  gst_check_drop_buffers ();
+
+  send_update (&rect, 1, 2);
+  buf = wait_for_buffer (1, &event);
+  check_damage (event, buf, &rect, 1);
+  fail_unless (GST_BUFFER_DATA (buf) == data, "frame not reused");
+  check_region (GST_BUFFER_DATA (buf), &rect);
+  fail_unless (last[0] == 0xaa && last[1] == 0xaa && last[2] == 0xaa &&
+      last[3] == 0xaa, "undamaged part of the frame copied");
+
+  /* while downstream holds the frame, the next one is a new buffer */
+  send_update (&rect, 1, 3);
+  buf = wait_for_buffer (2, &event);
+  fail_unless (GST_BUFFER_DATA (buf) != data, "frame in use reused");
+  check_frame (buf);
+
+  cleanup_rfbsrc (rfbsrc);
+}
+
+GST_END_TEST;
+
+/* without changes the last frame is pushed again after the repeat interval,
+ * sharing its memory, with an empty list of rectangles */
+GST_START_TEST (test_repeat)
+{
+  static const Rect all = { 0, 0, WIDTH, HEIGHT };
+  static const Rect rect = { 0, 0, 5, 5 };
+  GstElement *rfbsrc;
+  GstBuffer *first, *buf;
+  GstEvent *event;
+  guint n;
+
+  rfbsrc = setup_rfbsrc ();
+  g_object_set (rfbsrc, "repeat-interval", 50, NULL);
+  start_rfbsrc (rfbsrc);
+
+  send_update (&all, 1, 1);
+  first = wait_for_buffer (1, &event);
+  check_frame (first);
+
+  for (n = 2; n <= 3; n++) {
+    GstBuffer *prev = g_list_nth_data (buffers, n - 2);
+
+    buf = wait_for_buffer (n, &event);
+    fail_unless (buf != first);
+    fail_unless (GST_BUFFER_DATA (buf) == GST_BUFFER_DATA (first),
+        "repeated frame is not a sub-buffer of the last one");
+    check_damage (event, buf, NULL, 0);
+    fail_unless (GST_BUFFER_TIMESTAMP (buf) >=
+        GST_BUFFER_TIMESTAMP (prev) + 50 * GST_MSECOND);
+  }
+
+  /* a change ends the repeats, the frame in use is not written to */
+  send_update (&rect, 1, 2);
+  for (;; n++) {
+    buf = wait_for_buffer (n, &event);
+    if (gst_value_array_get_size (gst_structure_get_value
+            (gst_event_get_structure (event), "rectangles")) > 0)
+      break;
+    fail_unless (GST_BUFFER_DATA (buf) == GST_BUFFER_DATA (first));
+  }
+  check_damage (event, buf, &rect, 1);
+  fail_unless (GST_BUFFER_DATA (buf) != GST_BUFFER_DATA (first));
+  check_frame (buf);
+
+  cleanup_rfbsrc (rfbsrc);
+}
+
+GST_END_TEST;
+
+static Suite *
+rfbsrc_suite (void)
+{
+  Suite *s = suite_create ("rfbsrc");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_damage_only);
+  tcase_add_test (tc_chain, test_reuse);
+  tcase_add_test (tc_chain, test_repeat);
+
+  return s;
+}
+
+GST_CHECK_MAIN (rfbsrc);
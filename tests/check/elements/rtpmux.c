@@ -255,6 +255,116 @@ GST_START_TEST (test_rtpdtmfmux_lock)
 
 GST_END_TEST;
 
+static GList *lists = NULL;
+
+static GstFlowReturn
+chain_list_func (GstPad * pad, GstBufferList * list)
+{
+  lists = g_list_append (lists, list);
+
+  return GST_FLOW_OK;
+}
+
+static GstBuffer *
+create_rtp_buffer (guint16 seq)
+{
+  GstBuffer *buf;
+
+  buf = gst_rtp_buffer_new_allocate (10, 0, 0);
+  GST_BUFFER_TIMESTAMP (buf) = seq * GST_MSECOND;
+  gst_rtp_buffer_set_version (buf, 2);
+  gst_rtp_buffer_set_payload_type (buf, 98);
+  gst_rtp_buffer_set_ssrc (buf, 44);
+  gst_rtp_buffer_set_seq (buf, seq);
+
+  return buf;
+}
+
+GST_START_TEST (test_rtpmux_lists)
+{
+  GstElement *rtpmux;
+  GstPad *reqpad, *src, *sink;
+  GstBuffer *shared, *buf;
+  GstBufferList *list;
+  GstBufferListIterator *it;
+  guint i;
+
+  rtpmux = gst_check_setup_element ("rtpmux");
+  g_object_set (rtpmux, "seqnum-offset", 100, "ssrc", 55,
+      "max-list-size", 3, "max-list-time", 10 * GST_MSECOND, NULL);
+
+  reqpad = gst_element_get_request_pad (rtpmux, "sink_1");
+  fail_unless (reqpad != NULL);
+  sink = gst_check_setup_sink_pad_by_name (rtpmux, &sinktemplate, "src");
+  gst_pad_set_chain_list_function (sink, chain_list_func);
+  gst_pad_set_event_function (sink, event_func);
+  src = gst_pad_new_from_static_template (&srctemplate, "src");
+  fail_unless (gst_pad_link (src, reqpad) == GST_PAD_LINK_OK);
+
+  fail_unless (gst_element_set_state (rtpmux,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+  gst_pad_set_active (sink, TRUE);
+  gst_pad_set_active (src, TRUE);
+
+  /* the first packet is still used elsewhere, only its header is copied */
+  shared = create_rtp_buffer (1);
+  fail_unless (gst_pad_push (src, gst_buffer_ref (shared)) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (src, create_rtp_buffer (2)) == GST_FLOW_OK);
+  fail_unless (lists == NULL);
+  fail_unless (gst_pad_push (src, create_rtp_buffer (3)) == GST_FLOW_OK);
+  fail_unless (g_list_length (lists) == 1);
+
+  fail_unless (gst_rtp_buffer_get_seq (shared) == 1);
+  fail_unless (gst_rtp_buffer_get_ssrc (shared) == 44);
+
+  list = lists->data;
+  fail_unless (gst_buffer_list_n_groups (list) == 3);
+  it = gst_buffer_list_iterate (list);
+  for (i = 0; gst_buffer_list_iterator_next_group (it); i++) {
+    buf = gst_buffer_list_iterator_next (it);
+    fail_unless (gst_rtp_buffer_get_seq (buf) == 100 + 1 + i);
+    fail_unless (gst_rtp_buffer_get_ssrc (buf) == 55);
+    if (i == 0) {
+      fail_unless (GST_BUFFER_SIZE (buf) == 12);
+      buf = gst_buffer_list_iterator_next (it);
+      fail_unless (buf != NULL);
+      fail_unless (GST_BUFFER_SIZE (buf) == 10);
+      fail_unless (GST_BUFFER_DATA (buf) == GST_BUFFER_DATA (shared) + 12);
+    }
+    fail_unless (gst_buffer_list_iterator_next (it) == NULL);
+  }
+  gst_buffer_list_iterator_free (it);
+  gst_buffer_unref (shared);
+
+  /* a packet too late for the collected list starts a new one */
+  fail_unless (gst_pad_push (src, create_rtp_buffer (4)) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (src, create_rtp_buffer (20)) == GST_FLOW_OK);
+  fail_unless (g_list_length (lists) == 2);
+  fail_unless (gst_buffer_list_n_groups (lists->next->data) == 1);
+
+  /* EOS pushes what is left */
+  fail_unless (gst_pad_push_event (src, gst_event_new_eos ()));
+  fail_unless (g_list_length (lists) == 3);
+  fail_unless (gst_buffer_list_n_groups (lists->next->next->data) == 1);
+
+  g_list_foreach (lists, (GFunc) gst_buffer_list_unref, NULL);
+  g_list_free (lists);
+  lists = NULL;
+
+  gst_pad_set_active (sink, FALSE);
+  gst_pad_set_active (src, FALSE);
+  fail_unless (gst_element_set_state (rtpmux,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+  gst_check_teardown_pad_by_name (rtpmux, "src");
+  gst_object_unref (src);
+  gst_element_release_request_pad (rtpmux, reqpad);
+  gst_object_unref (reqpad);
+
+  gst_check_teardown_element (rtpmux);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtpmux_suite (void)
 {
@@ -265,6 +375,10 @@ rtpmux_suite (void)
   tcase_add_test (tc_chain, test_rtpmux_basic);
   suite_add_tcase (s, tc_chain);
 
+  tc_chain = tcase_create ("rtpmux_lists");
+  tcase_add_test (tc_chain, test_rtpmux_lists);
+  suite_add_tcase (s, tc_chain);
+
   tc_chain = tcase_create ("rtpdtmfmux_basic");
   tcase_add_test (tc_chain, test_rtpdtmfmux_basic);
   suite_add_tcase (s, tc_chain);
@@ -0,0 +1,200 @@
+/* GStreamer
+ *
+ * unit test for scaletempo
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+
+#include <gst/check/gstcheck.h>
+
+#define RATE 44100
+#define CHANNELS 2
+#define BUFFER_FRAMES 2205
+#define N_BUFFERS 20
+
+#define FLOAT_CAPS_STRING "audio/x-raw-float, rate = (int) 44100, " \
+    "channels = (int) 2, endianness = (int) BYTE_ORDER, width = (int) 32"
+#define INT_CAPS_STRING "audio/x-raw-int, rate = (int) 44100, " \
+    "channels = (int) 2, endianness = (int) BYTE_ORDER, width = (int) 16, " \
+    "depth = (int) 16, signed = (boolean) true"
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstElement *
+setup_scaletempo (const gchar * search_method, gdouble rate)
+{
+  GstElement *scaletempo;
+
+  scaletempo = gst_check_setup_element ("scaletempo");
+  gst_util_set_object_arg (G_OBJECT (scaletempo), "search-method",
+      search_method);
+  mysrcpad = gst_check_setup_src_pad (scaletempo, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (scaletempo, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (scaletempo,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_new_segment (FALSE, rate, GST_FORMAT_TIME, 0, -1, 0)));
+
+  return scaletempo;
+}
+
+static void
+cleanup_scaletempo (GstElement * scaletempo)
+{
+  gst_check_drop_buffers ();
+  fail_unless (gst_element_set_state (scaletempo,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (scaletempo);
+  gst_check_teardown_sink_pad (scaletempo);
+  gst_check_teardown_element (scaletempo);
+}
+
+/* noise has a single clear correlation peak, where a periodic signal would
+ * have several nearly equal ones */
+static GstBuffer *
+make_buffer (gboolean use_int, guint index)
+{
+  GstBuffer *buf;
+  GstCaps *caps;
+  guint32 seed = 1 + index;
+  guint i, n = BUFFER_FRAMES * CHANNELS;
+
+  buf = gst_buffer_new_and_alloc (n * (use_int ? 2 : 4));
+  for (i = 0; i < n; i++) {
+    gint v;
+
+    seed = seed * 1103515245 + 12345;
+    v = (gint) ((seed >> 16) & 0x7fff) - 0x4000;
+    if (use_int)
+      ((gint16 *) GST_BUFFER_DATA (buf))[i] = v;
+    else
+      ((gfloat *) GST_BUFFER_DATA (buf))[i] = v / 32768.0;
+  }
+
+  GST_BUFFER_TIMESTAMP (buf) =
+      gst_util_uint64_scale (index * BUFFER_FRAMES, GST_SECOND, RATE);
+  GST_BUFFER_DURATION (buf) =
+      gst_util_uint64_scale (BUFFER_FRAMES, GST_SECOND, RATE);
+
+  caps = gst_caps_from_string (use_int ? INT_CAPS_STRING : FLOAT_CAPS_STRING);
+  gst_buffer_set_caps (buf, caps);
+  gst_caps_unref (caps);
+
+  return buf;
+}
+
+/* stretches the test signal and returns all of the output in one buffer */
+static GstBuffer *
+stretch (const gchar * search_method, gboolean use_int, gdouble rate)
+{
+  GstElement *scaletempo;
+  GstBuffer *out;
+  GList *l;
+  guint i, size = 0;
+
+  scaletempo = setup_scaletempo (search_method, rate);
+
+  for (i = 0; i < N_BUFFERS; i++)
+    fail_unless_equals_int (gst_pad_push (mysrcpad, make_buffer (use_int, i)),
+        GST_FLOW_OK);
+
+  for (l = buffers; l; l = l->next)
+    size += GST_BUFFER_SIZE (l->data);
+  fail_unless (size > 0);
+
+  out = gst_buffer_new_and_alloc (size);
+  size = 0;
+  for (l = buffers; l; l = l->next) {
+    memcpy (GST_BUFFER_DATA (out) + size, GST_BUFFER_DATA (l->data),
+        GST_BUFFER_SIZE (l->data));
+    size += GST_BUFFER_SIZE (l->data);
+  }
+
+  cleanup_scaletempo (scaletempo);
+
+  return out;
+}
+
+/* both search methods have to pick the same overlap offsets, which gives
+ * the same output */
+static void
+check_search_methods_agree (gboolean use_int, gdouble rate)
+{
+  GstBuffer *direct, *fft;
+
+  direct = stretch ("direct", use_int, rate);
+  fft = stretch ("fft", use_int, rate);
+
+  fail_unless_equals_int (GST_BUFFER_SIZE (fft), GST_BUFFER_SIZE (direct));
+  fail_unless (memcmp (GST_BUFFER_DATA (fft), GST_BUFFER_DATA (direct),
+          GST_BUFFER_SIZE (direct)) == 0,
+      "%s output at rate %f differs between the search methods",
+      use_int ? "s16" : "float", rate);
+
+  gst_buffer_unref (direct);
+  gst_buffer_unref (fft);
+}
+
+GST_START_TEST (test_search_methods_float)
+{
+  check_search_methods_agree (FALSE, 0.75);
+  check_search_methods_agree (FALSE, 1.5);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_search_methods_s16)
+{
+  check_search_methods_agree (TRUE, 0.75);
+  check_search_methods_agree (TRUE, 1.5);
+}
+
+GST_END_TEST;
+
+static Suite *
+scaletempo_suite (void)
+{
+  Suite *s = suite_create ("scaletempo");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_search_methods_float);
+  tcase_add_test (tc_chain, test_search_methods_s16);
+
+  return s;
+}
+
+GST_CHECK_MAIN (scaletempo);
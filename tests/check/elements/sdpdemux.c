@@ -0,0 +1,235 @@
+/* GStreamer
+ *
+ * unit test for sdpdemux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#define N_STREAMS 2
+
+static GstPad *mysrcpad;
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/* the packets received on the src pad of each stream */
+static GMutex *count_lock;
+static guint counts[N_STREAMS];
+
+static void
+handoff_cb (GstElement * fakesink, GstBuffer * buf, GstPad * pad,
+    gpointer user_data)
+{
+  guint stream = GPOINTER_TO_UINT (user_data);
+
+  g_mutex_lock (count_lock);
+  counts[stream]++;
+  g_mutex_unlock (count_lock);
+}
+
+/* links a fakesink counting the packets to every stream pad */
+static void
+pad_added_cb (GstElement * sdpdemux, GstPad * pad, GstElement * pipeline)
+{
+  GstElement *sink;
+  GstPad *sinkpad;
+  gint id, ssrc, pt;
+
+  fail_unless (sscanf (GST_PAD_NAME (pad), "recv_rtp_src_%d_%d_%d", &id,
+          &ssrc, &pt) == 3, "unexpected pad %s", GST_PAD_NAME (pad));
+  fail_unless (id >= 0 && id < N_STREAMS);
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  fail_unless (sink != NULL);
+  g_object_set (sink, "signal-handoffs", TRUE, "sync", FALSE, "async", FALSE,
+      NULL);
+  g_signal_connect (sink, "handoff", G_CALLBACK (handoff_cb),
+      GUINT_TO_POINTER (id));
+
+  gst_bin_add (GST_BIN (pipeline), sink);
+  gst_element_sync_state_with_parent (sink);
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  fail_unless_equals_int (gst_pad_link (pad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+}
+
+/* an even port that is free along with the next one, for the RTCP */
+static guint
+find_port_pair (void)
+{
+  struct sockaddr_in addr;
+  socklen_t len = sizeof (addr);
+  guint port = 0;
+  gint i, fd;
+
+  for (i = 0; i < 100 && port == 0; i++) {
+    gint fd2;
+
+    fd = socket (AF_INET, SOCK_DGRAM, 0);
+    fail_unless (fd >= 0);
+    memset (&addr, 0, sizeof (addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+    fail_unless (bind (fd, (struct sockaddr *) &addr, sizeof (addr)) == 0);
+    fail_unless (getsockname (fd, (struct sockaddr *) &addr, &len) == 0);
+    port = ntohs (addr.sin_port) & ~1;
+
+    fd2 = socket (AF_INET, SOCK_DGRAM, 0);
+    fail_unless (fd2 >= 0);
+    /* the one that was not handed out has to be free */
+    addr.sin_port = htons (port == ntohs (addr.sin_port) ? port + 1 : port);
+    if (bind (fd2, (struct sockaddr *) &addr, sizeof (addr)) != 0)
+      port = 0;
+    close (fd2);
+    close (fd);
+  }
+  fail_unless (port != 0, "no free ports");
+
+  return port;
+}
+
+static void
+send_rtp (gint fd, guint port, guint8 pt, guint16 seq)
+{
+  struct sockaddr_in addr;
+  guint8 packet[12 + 160];
+
+  memset (packet, 0xff, sizeof (packet));
+  packet[0] = 0x80;
+  packet[1] = pt;
+  GST_WRITE_UINT16_BE (packet + 2, seq);
+  GST_WRITE_UINT32_BE (packet + 4, seq * 160);
+  GST_WRITE_UINT32_BE (packet + 8, 0x12345678 + pt);
+
+  memset (&addr, 0, sizeof (addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+  addr.sin_port = htons (port);
+  fail_unless (sendto (fd, packet, sizeof (packet), 0,
+          (struct sockaddr *) &addr, sizeof (addr)) == sizeof (packet));
+}
+
+/* two unicast streams on local ports, both received by the shared receiver
+ * thread */
+GST_START_TEST (test_shared_receiver)
+{
+  static const guint8 pts[N_STREAMS] = { 0, 8 };
+  GstElement *pipeline, *sdpdemux;
+  GstBuffer *buf;
+  guint ports[N_STREAMS];
+  gchar *sdp;
+  guint16 seq;
+  gint fd, i;
+  gboolean done = FALSE;
+
+  /* the session manager and the RTCP sink are in -good */
+  if (!gst_default_registry_check_feature_version ("gstrtpbin", 0, 10, 0) ||
+      !gst_default_registry_check_feature_version ("udpsink", 0, 10, 0)) {
+    GST_INFO ("skipping test, gstrtpbin or udpsink not available");
+    return;
+  }
+
+  count_lock = g_mutex_new ();
+  memset (counts, 0, sizeof (counts));
+
+  pipeline = gst_pipeline_new (NULL);
+  sdpdemux = gst_check_setup_element ("sdpdemux");
+  g_object_set (sdpdemux, "shared-receiver", TRUE, "latency", 0, NULL);
+  g_signal_connect (sdpdemux, "pad-added", G_CALLBACK (pad_added_cb),
+      pipeline);
+  gst_bin_add (GST_BIN (pipeline), sdpdemux);
+  mysrcpad = gst_check_setup_src_pad (sdpdemux, &srctemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE,
+      "could not set to playing");
+
+  ports[0] = find_port_pair ();
+  do {
+    ports[1] = find_port_pair ();
+  } while (ports[1] == ports[0]);
+
+  sdp = g_strdup_printf ("v=0\r\n"
+      "o=- 0 0 IN IP4 127.0.0.1\r\n"
+      "s=test\r\n"
+      "c=IN IP4 127.0.0.1\r\n"
+      "t=0 0\r\n"
+      "m=audio %u RTP/AVP 0\r\n"
+      "a=rtpmap:0 PCMU/8000\r\n"
+      "m=audio %u RTP/AVP 8\r\n"
+      "a=rtpmap:8 PCMA/8000\r\n", ports[0], ports[1]);
+  buf = gst_buffer_new ();
+  GST_BUFFER_DATA (buf) = GST_BUFFER_MALLOCDATA (buf) = (guint8 *) sdp;
+  GST_BUFFER_SIZE (buf) = strlen (sdp);
+  fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  /* sdpdemux opens the ports when the SDP is complete */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  fd = socket (AF_INET, SOCK_DGRAM, 0);
+  fail_unless (fd >= 0);
+  for (seq = 0; seq < 200 && !done; seq++) {
+    for (i = 0; i < N_STREAMS; i++)
+      send_rtp (fd, ports[i], pts[i], seq);
+    g_usleep (10 * G_USEC_PER_SEC / 1000);
+
+    g_mutex_lock (count_lock);
+    done = counts[0] > 0 && counts[1] > 0;
+    g_mutex_unlock (count_lock);
+  }
+  close (fd);
+
+  fail_unless (counts[0] > 0, "no data on the pad of the first stream");
+  fail_unless (counts[1] > 0, "no data on the pad of the second stream");
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_check_teardown_src_pad (sdpdemux);
+  gst_object_unref (pipeline);
+  g_mutex_free (count_lock);
+}
+
+GST_END_TEST;
+
+static Suite *
+sdpdemux_suite (void)
+{
+  Suite *s = suite_create ("sdpdemux");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_shared_receiver);
+
+  return s;
+}
+
+GST_CHECK_MAIN (sdpdemux);
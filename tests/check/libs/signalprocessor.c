@@ -0,0 +1,302 @@
+/* GStreamer
+ *
+ * unit test for the GstSignalProcessor base class
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+#include <gst/signalprocessor/gstsignalprocessor.h>
+
+#define CAPS_TEMPLATE "audio/x-raw-float, rate = (int) 44100, " \
+    "channels = (int) %u, endianness = (int) BYTE_ORDER, width = (int) 32"
+
+#define MAX_CHANNELS 8
+
+static GstPad *mysrcpad, *mysinkpad;
+
+static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS_ANY);
+
+/* A processor with one multichannel input and output that checks the
+ * de-interleaved input and negates it */
+typedef struct
+{
+  GstSignalProcessor parent;
+
+  guint64 offset;
+  guint errors;
+} TestProcessor;
+
+/* exact in float for the frame counts used here */
+static gfloat
+sample_value (guint64 frame, guint channel)
+{
+  return frame * MAX_CHANNELS + channel + 1;
+}
+
+static void
+test_processor_process (GstSignalProcessor * self, guint nframes)
+{
+  TestProcessor *test = (TestProcessor *) self;
+  GstSignalProcessorGroup *in = &self->group_in[0];
+  GstSignalProcessorGroup *out = &self->group_out[0];
+  guint i, j;
+
+  fail_unless_equals_int (in->nframes, nframes);
+  fail_unless_equals_int (out->nframes, nframes);
+
+  for (j = 0; j < in->channels; j++) {
+    for (i = 0; i < nframes; i++) {
+      if (in->buffer[j * nframes + i] != sample_value (test->offset + i, j))
+        test->errors++;
+      out->buffer[j * nframes + i] = -in->buffer[j * nframes + i];
+    }
+  }
+  test->offset += nframes;
+}
+
+static void
+test_processor_class_init (gpointer g_class, gpointer class_data)
+{
+  GstSignalProcessorClass *klass = g_class;
+  guint channels = GPOINTER_TO_UINT (class_data);
+
+  gst_element_class_set_details_simple (GST_ELEMENT_CLASS (klass),
+      "Test processor", "Filter/Effect/Audio", "Negates the samples",
+      "GStreamer");
+
+  gst_signal_processor_class_add_pad_template (klass, "sink", GST_PAD_SINK,
+      0, channels);
+  gst_signal_processor_class_add_pad_template (klass, "src", GST_PAD_SRC,
+      0, channels);
+  klass->num_group_in = 1;
+  klass->num_group_out = 1;
+  GST_SIGNAL_PROCESSOR_CLASS_SET_CAN_PROCESS_IN_PLACE (klass);
+
+  klass->process = test_processor_process;
+}
+
+/* registers a "testprocessor<channels>" element */
+static void
+register_test_processor (guint channels)
+{
+  GTypeInfo info = {
+    sizeof (GstSignalProcessorClass), NULL, NULL, test_processor_class_init,
+    NULL, NULL, sizeof (TestProcessor), 0, NULL
+  };
+  gchar *name;
+  GType type;
+
+  name = g_strdup_printf ("TestProcessor%u", channels);
+  if (g_type_from_name (name)) {
+    g_free (name);
+    return;
+  }
+
+  info.class_data = GUINT_TO_POINTER (channels);
+  type = g_type_register_static (GST_TYPE_SIGNAL_PROCESSOR, name, &info, 0);
+  g_free (name);
+
+  name = g_strdup_printf ("testprocessor%u", channels);
+  fail_unless (gst_element_register (NULL, name, GST_RANK_NONE, type));
+  g_free (name);
+}
+
+static GstElement *
+setup_processor (guint channels)
+{
+  GstElement *processor;
+  gchar *name;
+
+  register_test_processor (channels);
+  name = g_strdup_printf ("testprocessor%u", channels);
+  processor = gst_check_setup_element (name);
+  g_free (name);
+
+  mysrcpad = gst_check_setup_src_pad (processor, &srctemplate, NULL);
+  mysinkpad = gst_check_setup_sink_pad (processor, &sinktemplate, NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (processor,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  return processor;
+}
+
+static void
+cleanup_processor (GstElement * processor)
+{
+  gst_check_drop_buffers ();
+  fail_unless (gst_element_set_state (processor,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to NULL");
+
+  gst_pad_set_active (mysrcpad, FALSE);
+  gst_pad_set_active (mysinkpad, FALSE);
+  gst_check_teardown_src_pad (processor);
+  gst_check_teardown_sink_pad (processor);
+  gst_check_teardown_element (processor);
+}
+
+static GstBuffer *
+make_buffer (guint channels, guint64 offset, guint nframes)
+{
+  GstBuffer *buf;
+  GstCaps *caps;
+  gchar *caps_str;
+  gfloat *data;
+  guint i, j;
+
+  buf = gst_buffer_new_and_alloc (nframes * channels * sizeof (gfloat));
+  data = (gfloat *) GST_BUFFER_DATA (buf);
+  for (i = 0; i < nframes; i++)
+    for (j = 0; j < channels; j++)
+      data[i * channels + j] = sample_value (offset + i, j);
+
+  caps_str = g_strdup_printf (CAPS_TEMPLATE, channels);
+  caps = gst_caps_from_string (caps_str);
+  g_free (caps_str);
+  gst_buffer_set_caps (buf, caps);
+  gst_caps_unref (caps);
+
+  return buf;
+}
+
+/* checks that @buf holds the samples of @nframes from @offset, negated if
+ * @negated is set */
+static void
+check_buffer (GstBuffer * buf, guint channels, guint64 offset, guint nframes,
+    gboolean negated)
+{
+  const gfloat *data = (const gfloat *) GST_BUFFER_DATA (buf);
+  gfloat sign = negated ? -1.0 : 1.0;
+  guint i, j;
+
+  fail_unless_equals_int (GST_BUFFER_SIZE (buf),
+      nframes * channels * sizeof (gfloat));
+  for (i = 0; i < nframes; i++)
+    for (j = 0; j < channels; j++)
+      fail_unless (data[i * channels + j] ==
+          sign * sample_value (offset + i, j),
+          "%u channels, %u frames: frame %u channel %u is %f", channels,
+          nframes, i, j, data[i * channels + j]);
+}
+
+/* pushes buffers of @nframes through a processor with @channels and checks
+ * that the processor got them de-interleaved and that its output was
+ * interleaved again */
+static void
+check_round_trip (guint channels, guint nframes)
+{
+  GstElement *processor;
+  GstBuffer *in, *out;
+  guint64 offset = 0;
+
+  processor = setup_processor (channels);
+
+  /* a writable input buffer is reused for the output */
+  in = make_buffer (channels, offset, nframes);
+  fail_unless_equals_int (gst_pad_push (mysrcpad, in), GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  out = GST_BUFFER (buffers->data);
+  fail_unless (out == in, "%u channels, %u frames: buffer not reused",
+      channels, nframes);
+  check_buffer (out, channels, offset, nframes, TRUE);
+  offset += nframes;
+
+  /* one that is still used elsewhere is left alone */
+  in = make_buffer (channels, offset, nframes);
+  gst_buffer_ref (in);
+  fail_unless_equals_int (gst_pad_push (mysrcpad, in), GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 2);
+  out = GST_BUFFER (buffers->next->data);
+  fail_unless (out != in, "%u channels, %u frames: read-only buffer reused",
+      channels, nframes);
+  check_buffer (out, channels, offset, nframes, TRUE);
+  check_buffer (in, channels, offset, nframes, FALSE);
+  gst_buffer_unref (in);
+
+  fail_unless_equals_int (((TestProcessor *) processor)->errors, 0);
+
+  cleanup_processor (processor);
+}
+
+static const guint frame_counts[] = { 1, 63, 64, 65, 1000 };
+
+static void
+check_channels (guint channels)
+{
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (frame_counts); i++)
+    check_round_trip (channels, frame_counts[i]);
+}
+
+GST_START_TEST (test_stereo)
+{
+  check_channels (2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_5_1)
+{
+  check_channels (6);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_7_1)
+{
+  check_channels (8);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_odd_channels)
+{
+  check_channels (3);
+  check_channels (5);
+  check_channels (7);
+}
+
+GST_END_TEST;
+
+static Suite *
+signalprocessor_suite (void)
+{
+  Suite *s = suite_create ("signalprocessor");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_stereo);
+  tcase_add_test (tc_chain, test_5_1);
+  tcase_add_test (tc_chain, test_7_1);
+  tcase_add_test (tc_chain, test_odd_channels);
+
+  return s;
+}
+
+GST_CHECK_MAIN (signalprocessor);
@@ -0,0 +1,140 @@
+/* bench-main.c
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Measures the CPU time scaletempo spends per second of input audio for
+ * both overlap search methods at playback rates between 0.5 and 4.  The
+ * same pipeline with identity instead of scaletempo is run first and its
+ * time subtracted, so that only the work of scaletempo is reported. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const gdouble rates[] = { 0.5, 0.75, 1.25, 1.5, 2.0, 3.0, 4.0 };
+
+static gdouble
+run_pipeline (const gchar * filter, const gchar * format, gint channels,
+    gdouble rate, gint seconds)
+{
+  GstElement *pipeline;
+  GstBus *bus;
+  GstMessage *msg;
+  GError *err = NULL;
+  gchar *desc;
+  clock_t start;
+
+  desc = g_strdup_printf ("audiotestsrc wave=pink-noise ! "
+      "%s, rate=(int)44100, channels=(int)%d ! %s ! fakesink",
+      format, channels, filter);
+  pipeline = gst_parse_launch (desc, &err);
+  g_free (desc);
+  if (!pipeline) {
+    g_printerr ("could not create pipeline: %s\n", err->message);
+    g_error_free (err);
+    return -1;
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+  gst_element_seek (pipeline, rate, GST_FORMAT_TIME,
+      GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE,
+      GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_SET, seconds * GST_SECOND);
+  gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+  start = clock ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  start = clock () - start;
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    gst_message_parse_error (msg, &err, NULL);
+    g_printerr ("error: %s\n", err->message);
+    g_error_free (err);
+    start = -1;
+  }
+
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return start < 0 ? -1 : (gdouble) start / CLOCKS_PER_SEC;
+}
+
+int
+main (int argc, char *argv[])
+{
+  gint channels = 2;
+  gint seconds = 60;
+  gboolean use_int = FALSE;
+  const gchar *format, *filter;
+  GOptionContext *ctx;
+  GError *err = NULL;
+  guint i;
+
+  const GOptionEntry entries[] = {
+    {"channels", 'c', 0, G_OPTION_ARG_INT, &channels,
+        "Number of channels (default: 2)", "N"},
+    {"seconds", 's', 0, G_OPTION_ARG_INT, &seconds,
+        "Seconds of audio per run (default: 60)", "S"},
+    {"int", 'i', 0, G_OPTION_ARG_NONE, &use_int,
+        "Use 16 bit integer instead of float samples", NULL},
+    {NULL,}
+  };
+
+  ctx = g_option_context_new ("- benchmark the scaletempo overlap search");
+  g_option_context_add_main_entries (ctx, entries, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", err->message);
+    exit (1);
+  }
+  g_option_context_free (ctx);
+
+  format = use_int ?
+      "audio/x-raw-int, width=(int)16, depth=(int)16, signed=(boolean)true" :
+      "audio/x-raw-float, width=(int)32";
+
+  g_print ("%d channels %s, %d s of audio per run\n", channels,
+      use_int ? "s16" : "float", seconds);
+  g_print ("rate   direct ms/s   fft ms/s\n");
+
+  for (i = 0; i < G_N_ELEMENTS (rates); i++) {
+    gdouble base, direct, fft;
+
+    base = run_pipeline ("identity", format, channels, rates[i], seconds);
+    filter = "scaletempo search-method=direct";
+    direct = run_pipeline (filter, format, channels, rates[i], seconds);
+    filter = "scaletempo search-method=fft";
+    fft = run_pipeline (filter, format, channels, rates[i], seconds);
+    if (base < 0 || direct < 0 || fft < 0)
+      exit (1);
+
+    g_print ("%4.2f %13.2f %10.2f\n", rates[i],
+        MAX (direct - base, 0) * 1000 / seconds,
+        MAX (fft - base, 0) * 1000 / seconds);
+  }
+
+  return 0;
+}